@@ -0,0 +1,140 @@
+﻿//---------------------------------------------------------------------------
+//! @file   BenchMain.cpp
+//! @brief  ベンチマーク エントリーポイント
+//!
+//! 使用例:
+//! @code
+//!     Benchmark.exe --frames 600 --filter objects --out result.json
+//! @endcode
+//! テストとシナリオの検証に失敗した場合は終了コード1を返します。
+//---------------------------------------------------------------------------
+#include "Benchmark.h"
+#include "Check.h"
+#include "HeadlessRunner.h"
+
+#include <cstdio>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+//! 使用方法を表示
+//---------------------------------------------------------------------------
+void printUsage()
+{
+    std::printf("Benchmark [options]\n"
+                "  --frames <n>     measured frames per scenario (default 600)\n"
+                "  --warmup <n>     warmup frames per scenario (default 60)\n"
+                "  --dt <sec>       fixed delta time (default 1/60)\n"
+                "  --seed <n>       random seed (default 12345)\n"
+                "  --filter <name>  run tests/scenarios whose name contains <name>\n"
+                "  --zones          include profiler zone breakdown\n"
+                "  --out <path>     output JSON path (default benchmark.json)\n"
+                "  --list           list tests and scenarios\n");
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! エントリーポイント
+//---------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    bench::Config config;
+    bool          list = false;
+
+    //----------------------------------------------------------
+    // コマンドライン引数
+    //----------------------------------------------------------
+    for(int i = 1; i < argc; ++i) {
+        std::string_view arg   = argv[i];
+        const char*      value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if(arg == "--frames" && value) {
+            config.frames_ = static_cast<u32>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if(arg == "--warmup" && value) {
+            config.warmup_ = static_cast<u32>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if(arg == "--dt" && value) {
+            config.delta_ = std::strtof(value, nullptr);
+            ++i;
+        }
+        else if(arg == "--seed" && value) {
+            config.seed_ = static_cast<u32>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if(arg == "--filter" && value) {
+            config.filter_ = value;
+            ++i;
+        }
+        else if(arg == "--out" && value) {
+            config.output_ = value;
+            ++i;
+        }
+        else if(arg == "--zones") {
+            config.zones_ = true;
+        }
+        else if(arg == "--list") {
+            list = true;
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    bench::registerBuiltinScenarios();
+
+    if(list) {
+        for(auto& test : bench::tests())
+            std::printf("%s\n", test.name_.c_str());
+        for(auto& scenario : bench::scenarios())
+            std::printf("%s\n", scenario.name_.c_str());
+        return 0;
+    }
+
+    //----------------------------------------------------------
+    // 実行
+    //----------------------------------------------------------
+    bench::HeadlessRunner runner;
+    if(!runner.initialize()) {
+        std::fprintf(stderr, "failed to initialize headless runner\n");
+        return 1;
+    }
+
+    // DxLibを必要とするテストを含むため、初期化後に実行
+    bench::runTests(config.filter_);
+
+    std::vector<bench::Result> results;
+    for(auto& scenario : bench::scenarios()) {
+        if(!config.filter_.empty() && scenario.name_.find(config.filter_) == std::string::npos)
+            continue;
+
+        auto result = bench::run(runner, scenario, config);
+        std::printf("%-24s mean %8.3f ms  median %8.3f ms  p95 %8.3f ms  max %8.3f ms  (objects %u)\n",
+                    result.name_.c_str(),
+                    result.mean_ms_,
+                    result.median_ms_,
+                    result.p95_ms_,
+                    result.max_ms_,
+                    result.objects_);
+
+        results.emplace_back(std::move(result));
+    }
+
+    runner.finalize();
+
+    if(!bench::writeJson(config.output_, config, results)) {
+        std::fprintf(stderr, "failed to write %s\n", config.output_.c_str());
+        return 1;
+    }
+
+    if(u32 failed = bench::failedChecks()) {
+        std::fprintf(stderr, "%u checks failed\n", failed);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1569 @@
+﻿//---------------------------------------------------------------------------
+//! @file   BenchScenarios.cpp
+//! @brief  標準ベンチマークシナリオ
+//---------------------------------------------------------------------------
+#include "Benchmark.h"
+#include "Check.h"
+
+#include <System/Scene.h>
+#include <System/Component/ComponentCollisionSphere.h>
+#include <System/Component/ComponentCollisionCapsule.h>
+#include <System/Component/ComponentModel.h>
+#include <System/Physics/PhysicsEngine.h>
+#include <System/Physics/PhysicsLayer.h>
+#include <System/Physics/RigidBody.h>
+#include <System/Physics/Shape.h>
+#include <System/Physics/TriangleBVH.h>
+#include <System/Physics/CollisionBatch.h>
+#include <System/Physics/WaveField.h>
+#include <System/Graphics/ModelCache.h>
+#include <System/Graphics/Frustum.h>
+#include <System/Graphics/Animation.h>
+#include <System/Animation/Animator.h>
+#include <System/Graphics/AnimationLod.h>
+#include <System/Graphics/RenderQueue.h>
+#include <System/Graphics/StreamingManager.h>
+#include <System/VectorMathBatch.h>
+#include <System/EaseCurve.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <execution>
+#include <filesystem>
+
+namespace bench
+{
+namespace
+{
+
+//===========================================================================
+//! 所有オブジェクトを回転させる (Update負荷用)
+//===========================================================================
+class ComponentBenchSpin : public Component
+{
+public:
+    ComponentBenchSpin(ObjectPtr owner, const float3& axis, f32 speed)
+        : Component(owner)
+        , axis_(normalize(axis))
+        , speed_(speed)
+    {
+        // 1オブジェクトに複数個追加する
+        SetStatus(Component::StatusBit::SameType, true);
+    }
+
+    void Update(f32 delta) override
+    {
+        __super::Update(delta);
+
+        owner_->AddRotation(quaternion::rotation_axis(axis_, speed_ * delta));
+    }
+
+private:
+    float3 axis_;    //!< 回転軸
+    f32    speed_;   //!< 回転速度 (単位:rad/秒)
+};
+
+//===========================================================================
+//! 所有オブジェクトを箱の中で移動させる (衝突判定負荷用)
+//===========================================================================
+class ComponentBenchMover : public Component
+{
+public:
+    ComponentBenchMover(ObjectPtr owner, const float3& velocity, f32 extent)
+        : Component(owner)
+        , velocity_(velocity)
+        , extent_(extent)
+    {
+    }
+
+    void Update(f32 delta) override
+    {
+        __super::Update(delta);
+
+        float3 position = owner_->GetTranslate() + velocity_ * delta;
+
+        // 範囲外に出たら反射
+        f32 p[3];
+        f32 v[3];
+        store(position, p);
+        store(velocity_, v);
+        for(s32 i = 0; i < 3; ++i) {
+            if(std::abs(p[i]) > extent_) {
+                p[i] = std::clamp(p[i], -extent_, extent_);
+                v[i] = -v[i];
+            }
+        }
+        owner_->SetTranslate(float3(p[0], p[1], p[2]));
+        velocity_ = float3(v[0], v[1], v[2]);
+    }
+
+private:
+    float3 velocity_;   //!< 速度
+    f32    extent_;     //!< 移動範囲 (±extent)
+};
+
+//---------------------------------------------------------------------------
+//! 一様乱数
+//---------------------------------------------------------------------------
+f32 random(std::mt19937& rng, f32 min, f32 max)
+{
+    return std::uniform_real_distribution<f32>(min, max)(rng);
+}
+
+float3 randomFloat3(std::mt19937& rng, f32 extent)
+{
+    return float3(random(rng, -extent, extent), random(rng, -extent, extent), random(rng, -extent, extent));
+}
+
+//---------------------------------------------------------------------------
+//! 回転コンポーネントを持つオブジェクトを生成
+//---------------------------------------------------------------------------
+ObjectPtr createSpinObject(std::mt19937& rng, u32 component_count)
+{
+    auto obj = Scene::CreateObject<Object>()->SetTranslate(randomFloat3(rng, 50.0f));
+    for(u32 i = 0; i < component_count; ++i) {
+        obj->AddComponent<ComponentBenchSpin>(randomFloat3(rng, 1.0f) + float3(0.0f, 1.5f, 0.0f),
+                                              random(rng, 0.5f, 2.0f));
+    }
+    return obj;
+}
+
+//---------------------------------------------------------------------------
+//! オブジェクト数×コンポーネント数
+//---------------------------------------------------------------------------
+Scenario objectsScenario(u32 object_count, u32 component_count)
+{
+    Scenario s;
+    s.name_ = "objects_n" + std::to_string(object_count) + "_k" + std::to_string(component_count);
+    s.desc_ = u8"コンポーネント付きオブジェクトのシグナル処理負荷";
+    s.init_ = [=](std::mt19937& rng) {
+        for(u32 i = 0; i < object_count; ++i)
+            createSpinObject(rng, component_count);
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 衝突判定 (スフィア/カプセルの密集)
+//---------------------------------------------------------------------------
+Scenario collisionScenario(u32 object_count)
+{
+    Scenario s;
+    s.name_ = "collision_n" + std::to_string(object_count);
+    s.desc_ = u8"スフィア/カプセルが密集した状態の当たり判定負荷";
+    s.init_ = [=](std::mt19937& rng) {
+        constexpr f32 extent = 8.0f;
+
+        for(u32 i = 0; i < object_count; ++i) {
+            auto obj = Scene::CreateObject<Object>()->SetTranslate(randomFloat3(rng, extent));
+            obj->AddComponent<ComponentBenchMover>(randomFloat3(rng, 2.0f), extent);
+
+            if(i & 1)
+                obj->AddComponent<ComponentCollisionSphere>()->SetRadius(random(rng, 0.3f, 0.8f));
+            else
+                obj->AddComponent<ComponentCollisionCapsule>()->SetRadius(random(rng, 0.2f, 0.5f))->SetHeight(
+                    random(rng, 0.5f, 2.0f));
+        }
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 物理シミュレーション (剛体の積み重ね)
+//---------------------------------------------------------------------------
+Scenario physicsScenario(u32 body_count)
+{
+    // シナリオ終了まで剛体を保持する
+    auto bodies = std::make_shared<std::vector<std::shared_ptr<physics::RigidBody>>>();
+
+    Scenario s;
+    s.name_ = "physics_n" + std::to_string(body_count);
+    s.desc_ = u8"剛体が床へ落下して積み重なる物理シミュレーション負荷";
+    s.init_ = [=](std::mt19937& rng) {
+        auto floor = physics::createRigidBody(shape::Box{float3(63.0f, 1.0f, 63.0f)},
+                                              physics::ObjectLayers::NON_MOVING,
+                                              physics::MotionType::Static);
+        floor->setPosition(float3(0.0f, -1.0f, 0.0f));
+        bodies->emplace_back(std::move(floor));
+
+        constexpr u32 WIDTH = 20;
+        for(u32 i = 0; i < body_count; ++i) {
+            std::shared_ptr<physics::RigidBody> body;
+            if(i & 1)
+                body = physics::createRigidBody(shape::Box{float3(0.5f, 0.5f, 0.5f)}, physics::ObjectLayers::MOVING);
+            else
+                body = physics::createRigidBody(shape::Sphere{float3(0.0f, 0.0f, 0.0f), 0.5f},
+                                                physics::ObjectLayers::MOVING);
+
+            u32    x = i % WIDTH;
+            u32    z = (i / WIDTH) % WIDTH;
+            u32    y = i / (WIDTH * WIDTH);
+            float3 position((static_cast<f32>(x) - WIDTH / 2) * 1.5f,
+                            static_cast<f32>(y) * 1.5f + 2.0f,
+                            (static_cast<f32>(z) - WIDTH / 2) * 1.5f);
+            body->setPosition(position + randomFloat3(rng, 0.05f));
+            body->setRestitution(0.5f);
+            bodies->emplace_back(std::move(body));
+        }
+        physics::Engine::instance()->optimize();
+    };
+    s.exit_ = [=]() { bodies->clear(); };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 生成/破棄の繰り返し
+//---------------------------------------------------------------------------
+Scenario churnScenario(u32 object_count, u32 churn_per_frame)
+{
+    auto objects = std::make_shared<std::vector<ObjectWeakPtr>>();
+
+    Scenario s;
+    s.name_ = "churn_n" + std::to_string(object_count) + "_c" + std::to_string(churn_per_frame);
+    s.desc_ = u8"毎フレームのオブジェクト生成/破棄負荷";
+    s.init_ = [=](std::mt19937& rng) {
+        objects->clear();
+        for(u32 i = 0; i < object_count; ++i)
+            objects->emplace_back(createSpinObject(rng, 3));
+    };
+    s.update_ = [=](std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        for(u32 i = 0; i < churn_per_frame; ++i) {
+            // ランダムに選んだオブジェクトを破棄して新しく生成
+            auto index = std::uniform_int_distribution<size_t>(0, objects->size() - 1)(rng);
+            if(auto obj = (*objects)[index].lock())
+                Scene::ReleaseObject(obj);
+
+            (*objects)[index] = createSpinObject(rng, 3);
+        }
+    };
+    s.exit_ = [=]() { objects->clear(); };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 地形三角形BVHへの問い合わせ (並列)
+//---------------------------------------------------------------------------
+Scenario bvhScenario(u32 grid, u32 query_count)
+{
+    struct Query
+    {
+        float3 p0_;
+        float3 p1_;
+        f32    radius_;
+    };
+
+    auto bvh     = std::make_shared<physics::TriangleBVH>();
+    auto queries = std::make_shared<std::vector<Query>>(query_count);
+
+    Scenario s;
+    s.name_ = "bvh_t" + std::to_string(grid * grid * 2) + "_q" + std::to_string(query_count);
+    s.desc_ = u8"起伏のある地形メッシュに対するカプセル/線分判定負荷 (並列問い合わせ)";
+    s.init_ = [=](std::mt19937& rng) {
+        // grid×gridの起伏のある地形
+        constexpr f32       cell = 0.5f;
+        std::vector<float3> vertices;
+        std::vector<u32>    indices;
+        for(u32 z = 0; z <= grid; ++z) {
+            for(u32 x = 0; x <= grid; ++x) {
+                f32 px = (static_cast<f32>(x) - grid * 0.5f) * cell;
+                f32 pz = (static_cast<f32>(z) - grid * 0.5f) * cell;
+                vertices.emplace_back(px, std::sin(px * 0.3f) * std::cos(pz * 0.2f) * 2.0f + random(rng, 0.0f, 0.1f), pz);
+            }
+        }
+        for(u32 z = 0; z < grid; ++z) {
+            for(u32 x = 0; x < grid; ++x) {
+                u32 i = z * (grid + 1) + x;
+                indices.insert(indices.end(), {i, i + grid + 1, i + 1, i + 1, i + grid + 1, i + grid + 2});
+            }
+        }
+        bvh->build(vertices, indices);
+    };
+    s.update_ = [=](std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        f32 extent = grid * 0.5f * 0.5f;
+        for(auto& q : *queries) {
+            q.p0_     = float3(random(rng, -extent, extent), random(rng, -1.0f, 2.5f), random(rng, -extent, extent));
+            q.p1_     = q.p0_ + float3(0.0f, random(rng, 0.5f, 2.0f), 0.0f);
+            q.radius_ = random(rng, 0.2f, 0.6f);
+        }
+
+        // 問い合わせは読み取りのみのため並列に実行できる
+        std::atomic<u32> contact_total{0};
+        std::for_each(std::execution::par, queries->begin(), queries->end(), [&](const Query& q) {
+            physics::TriangleBVH::Contacts contacts;
+            physics::TriangleBVH::RayHit   hit;
+            u32 count = static_cast<u32>(bvh->overlapCapsule(q.p0_, q.p1_, q.radius_, contacts));
+            if(bvh->raycast(q.p1_, q.p0_ - float3(0.0f, 10.0f, 0.0f), hit))
+                ++count;
+            contact_total += count;
+        });
+    };
+    s.exit_ = [=]() { bvh->clear(); };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 球/カプセルのペア判定 (従来のIsHit() / SIMD一括)
+//---------------------------------------------------------------------------
+
+//! ヒット数を数える
+u32 countHits(u32 mask)
+{
+    u32 count = 0;
+    for(; mask; mask &= mask - 1)
+        ++count;
+    return count;
+}
+
+//! 一括判定の結果が従来のIsHit()と一致するかを確認
+//! @param  [in]    col_1   コリジョン (UpdateWorldShape()済み)
+//! @param  [in]    col_2   相手コリジョン (UpdateWorldShape()済み)
+//! @param  [inout] max_error   押し戻し量/当たった地点の最大誤差
+//! @retval true    ヒットの有無が一致
+bool compareWithIsHit(const ComponentCollisionPtr& col_1, const ComponentCollisionPtr& col_2, f32& max_error)
+{
+    auto& a = col_1->GetWorldShape();
+    auto& b = col_2->GetWorldShape();
+
+    physics::CollisionBatch         batch;
+    physics::CollisionBatch::Result results[physics::CollisionBatch::LANE_COUNT];
+    batch.add(a.p0_, a.p1_, a.radius_, b.p0_, b.p1_, b.radius_);
+    bool hit = (batch.test(results) & 1) != 0;
+
+    auto expected = col_1->IsHit(col_2);
+    if(hit != expected.hit_)
+        return false;
+
+    if(hit) {
+        max_error = std::max(max_error, (f32)length(results[0].push_ - expected.push_));
+        max_error = std::max(max_error, (f32)length(results[0].hit_position_ - expected.hit_position_));
+    }
+    return true;
+}
+
+//! @param  [in]    pair_count  1フレームで判定するペア数
+//! @param  [in]    simd        true:一括判定 false:従来の判定 (IsHit())
+Scenario pairScenario(u32 pair_count, bool simd)
+{
+    //! 判定に使用するコリジョン数 (ペアはこの中から選ぶ)
+    constexpr u32 COLLISION_COUNT = 256;
+
+    struct Pairs
+    {
+        std::vector<ComponentCollisionPtr>   collisions_;   //!< 球/カプセル (半数ずつ)
+        std::vector<std::pair<u32, u32>>     pairs_;        //!< 判定するペア
+    };
+    auto data = std::make_shared<Pairs>();
+
+    std::string name = std::string(simd ? "pairs_simd_n" : "pairs_scalar_n") + std::to_string(pair_count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = simd ? u8"球/カプセルのペア判定負荷 (float4で4ペアずつ一括判定)" : u8"球/カプセルのペア判定負荷 (IsHit()で1ペアずつ判定)";
+    s.init_ = [=](std::mt19937& rng) {
+        constexpr f32 extent = 4.0f;
+
+        // シーンの当たり判定には参加させず、ペアの判定だけをここで行う
+        data->collisions_.clear();
+        for(u32 i = 0; i < COLLISION_COUNT; ++i) {
+            auto obj = Scene::CreateObject<Object>()->SetTranslate(randomFloat3(rng, extent));
+            obj->SetRotationAxisXYZ(randomFloat3(rng, 180.0f));
+
+            ComponentCollisionPtr col;
+            if(i & 1)
+                col = obj->AddComponent<ComponentCollisionSphere>()->SetRadius(random(rng, 0.2f, 0.8f));
+            else
+                col = obj->AddComponent<ComponentCollisionCapsule>()->SetRadius(random(rng, 0.2f, 0.5f))->SetHeight(
+                    random(rng, 1.0f, 2.5f));
+            col->SetCollisionStatus(ComponentCollision::CollisionBit::DisableHit, true);
+            col->UpdateWorldShape();
+            data->collisions_.emplace_back(std::move(col));
+        }
+
+        data->pairs_.resize(pair_count);
+        std::uniform_int_distribution<u32> index(0, COLLISION_COUNT - 1);
+        for(auto& [a, b] : data->pairs_) {
+            a = index(rng);
+            do {
+                b = index(rng);
+            } while(a == b);
+        }
+
+        if(!simd)
+            return;
+
+        // 一括判定の結果が従来のIsHit()と一致するかを確認
+        u32 mismatch  = 0;
+        f32 max_error = 0.0f;
+        for(auto& [a, b] : data->pairs_) {
+            if(!compareWithIsHit(data->collisions_[a], data->collisions_[b], max_error))
+                ++mismatch;
+        }
+
+        // 全く同じ形状が重なった場合の押し出し方向 (カプセル同士/球同士、両方の順序)
+        auto capsule_1 = std::static_pointer_cast<ComponentCollisionCapsule>(data->collisions_[0]);
+        auto capsule_2 = std::static_pointer_cast<ComponentCollisionCapsule>(data->collisions_[2]);
+        auto sphere_1  = std::static_pointer_cast<ComponentCollisionSphere>(data->collisions_[1]);
+        auto sphere_2  = std::static_pointer_cast<ComponentCollisionSphere>(data->collisions_[3]);
+        capsule_2->SetRadius(capsule_1->GetRadius())->SetHeight(capsule_1->GetHeight());
+        sphere_2->SetRadius(sphere_1->GetRadius());
+
+        std::pair<ComponentCollisionPtr, ComponentCollisionPtr> overlaps[] = {{capsule_1, capsule_2}, {sphere_1, sphere_2}};
+        for(auto& [col_1, col_2] : overlaps) {
+            auto saved = col_2->GetOwner()->GetMatrix();
+            col_2->GetOwner()->SetMatrix(col_1->GetOwner()->GetMatrix());
+            col_2->UpdateWorldShape();
+            if(!compareWithIsHit(col_1, col_2, max_error) || !compareWithIsHit(col_2, col_1, max_error))
+                ++mismatch;
+            col_2->GetOwner()->SetMatrix(saved);
+            col_2->UpdateWorldShape();
+        }
+
+        std::printf("%-24s validation: mismatch %u  max error %g\n", name.c_str(), mismatch, max_error);
+        check(mismatch == 0 && max_error < 1e-3f, name, "result differs from IsHit()");
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        u32 hit_count = 0;
+        if(simd) {
+            // 判定パスと同じく、ワールド形状の更新も含めて計測する
+            ComponentCollision::UpdateWorldShapes(data->collisions_);
+
+            physics::CollisionBatch         batch;
+            physics::CollisionBatch::Result results[physics::CollisionBatch::LANE_COUNT];
+            for(auto& [a, b] : data->pairs_) {
+                auto& shape_1 = data->collisions_[a]->GetWorldShape();
+                auto& shape_2 = data->collisions_[b]->GetWorldShape();
+                if(batch.add(shape_1.p0_, shape_1.p1_, shape_1.radius_, shape_2.p0_, shape_2.p1_, shape_2.radius_)) {
+                    hit_count += countHits(batch.test(results));
+                    batch.clear();
+                }
+            }
+            hit_count += countHits(batch.test(results));
+        }
+        else {
+            for(auto& [a, b] : data->pairs_) {
+                if(data->collisions_[a]->IsHit(data->collisions_[b]).hit_)
+                    ++hit_count;
+            }
+        }
+    };
+    s.exit_ = [=]() { data->collisions_.clear(); };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 配列の一括変換 (命令セットごと)
+//! @details 初期化時にスカラー実装と比較し、誤差が大きい場合は検証失敗とします。
+//!          毎フレーム 座標変換 / AABB変換 / TRS→行列 / 行列の積 をそれぞれcount個ずつ処理します
+//---------------------------------------------------------------------------
+Scenario vectorMathScenario(simd::Isa isa, u32 count)
+{
+    struct Data
+    {
+        std::vector<float3>     points_;         //!< 座標
+        std::vector<float3>     world_points_;   //!< 変換後の座標
+        std::vector<simd::AABB> boxes_;          //!< AABB
+        std::vector<simd::AABB> world_boxes_;    //!< 変換後のAABB
+        std::vector<TRS>        transforms_;     //!< ローカル姿勢
+        std::vector<matrix>     locals_;         //!< ローカル行列
+        std::vector<matrix>     worlds_;         //!< ワールド行列
+    };
+    auto data = std::make_shared<Data>();
+
+    const matrix parent =
+        mul(matrix::rotateAxis(normalize(float3(1.0f, 2.0f, 3.0f)), 0.8f), matrix::translate(3.0f, -2.0f, 5.0f));
+
+    // 全処理を実行
+    auto run = [=]() {
+        simd::transformPoints(parent, data->points_.data(), data->world_points_.data(), count);
+        simd::transformAABBs(parent, data->boxes_.data(), data->world_boxes_.data(), count);
+        simd::toMatrices(data->transforms_.data(), data->locals_.data(), count);
+        simd::multiplyMatrices(data->locals_.data(), parent, data->worlds_.data(), count);
+    };
+
+    std::string name = std::string("vecmath_") + simd::isaName(isa) + "_n" + std::to_string(count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = u8"座標/AABB/行列の一括変換負荷 (VectorMathBatch)";
+    s.init_ = [=](std::mt19937& rng) {
+        data->points_.resize(count);
+        data->world_points_.resize(count);
+        data->boxes_.resize(count);
+        data->world_boxes_.resize(count);
+        data->transforms_.resize(count);
+        data->locals_.resize(count);
+        data->worlds_.resize(count);
+        for(u32 i = 0; i < count; ++i) {
+            data->points_[i]     = randomFloat3(rng, 10.0f);
+            data->boxes_[i].min_ = randomFloat3(rng, 10.0f);
+            data->boxes_[i].max_ = data->boxes_[i].min_ + abs(randomFloat3(rng, 2.0f));
+
+            auto& trs      = data->transforms_[i];
+            trs.translate_ = randomFloat3(rng, 10.0f);
+            trs.rotate_    = quaternion::rotation_euler_zxy(randomFloat3(rng, PI));
+            trs.scale_     = float3(random(rng, 0.5f, 2.0f), random(rng, 0.5f, 2.0f), random(rng, 0.5f, 2.0f));
+        }
+
+        // スカラー実装の結果と比較
+        simd::setIsa(simd::Isa::Scalar);
+        run();
+        Data expected = *data;
+        simd::setIsa(isa);
+        run();
+
+        auto error3   = [](const float3& a, const float3& b) { return static_cast<f32>(length(a - b)); };
+        auto error4x4 = [](const matrix& a, const matrix& b) {
+            f32 ea[16];
+            f32 eb[16];
+            store(a, ea);
+            store(b, eb);
+            f32 error = 0.0f;
+            for(u32 i = 0; i < 16; ++i)
+                error = std::max(error, std::abs(ea[i] - eb[i]));
+            return error;
+        };
+
+        f32 max_error = 0.0f;
+        for(u32 i = 0; i < count; ++i) {
+            max_error = std::max(max_error, error3(data->world_points_[i], expected.world_points_[i]));
+            max_error = std::max(max_error, error3(data->world_boxes_[i].min_, expected.world_boxes_[i].min_));
+            max_error = std::max(max_error, error3(data->world_boxes_[i].max_, expected.world_boxes_[i].max_));
+            max_error = std::max(max_error, error4x4(data->worlds_[i], expected.worlds_[i]));
+        }
+        check(max_error < 1e-4f,
+              name,
+              "differs from the scalar implementation: max error " + std::to_string(max_error));
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) { run(); };
+    s.exit_   = [=]() {
+        // 既定の命令セット (利用可能な最上位) に戻す
+        simd::setIsa(simd::Isa::AVX);
+        *data = {};
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! Easeカーブの評価 (1要素ずつ / 一括)
+//! @details 毎フレーム全種類のカーブをcount個ずつ評価します。
+//!          一括評価は初期化時に1要素ずつの評価との最大誤差を表示します
+//---------------------------------------------------------------------------
+Scenario easeScenario(u32 count, bool batch)
+{
+    auto values  = std::make_shared<std::vector<f32>>(count);
+    auto results = std::make_shared<std::vector<f32>>(count);
+
+    std::string name = std::string(batch ? "ease_batch_n" : "ease_scalar_n") + std::to_string(count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = batch ? u8"Easeカーブの評価負荷 (EaseEvaluateで4要素ずつ一括評価)" : u8"Easeカーブの評価負荷 (関数で1要素ずつ評価)";
+    s.init_ = [=](std::mt19937& rng) {
+        for(auto& t : *values)
+            t = random(rng, 0.0f, 1.0f);
+        if(!batch)
+            return;
+
+        // 一括評価の結果が1要素ずつの評価と一致するかを確認
+        f32 max_error = 0.0f;
+        for(u32 type = 0; type < GetEaseFunctionMaxCount(); ++type) {
+            EaseEvaluate(static_cast<EaseType>(type), values->data(), results->data(), count);
+
+            auto ease = GetEaseFunction(static_cast<EaseType>(type));
+            for(u32 i = 0; i < count; ++i)
+                max_error = std::max(max_error, std::abs((*results)[i] - ease((*values)[i])));
+        }
+        std::printf("%-24s validation: max error %g\n", name.c_str(), max_error);
+        check(max_error < 1e-4f, name, "batch evaluation differs from per-value evaluation");
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        for(u32 type = 0; type < GetEaseFunctionMaxCount(); ++type) {
+            if(batch) {
+                EaseEvaluate(static_cast<EaseType>(type), values->data(), results->data(), count);
+                continue;
+            }
+            auto ease = GetEaseFunction(static_cast<EaseType>(type));
+            for(u32 i = 0; i < count; ++i)
+                (*results)[i] = ease((*values)[i]);
+        }
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 水面の波動シミュレーション (描画なし)
+//! @details 初期化時に従来の計算 (float2の二重ループ) との最大誤差を表示します。
+//!          毎フレーム1ステップ進め、8フレームごとにランダムな位置へ波紋を加えます
+//---------------------------------------------------------------------------
+Scenario waveScenario(u32 size, bool parallel)
+{
+    auto field = std::make_shared<physics::WaveField>();
+
+    std::string name = "wave_" + std::to_string(size) + (parallel ? "_par" : "_seq");
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = parallel ? u8"ハイトフィールドの波動シミュレーション負荷 (帯ごとに並列)" : u8"ハイトフィールドの波動シミュレーション負荷 (1スレッド)";
+    s.init_ = [=](std::mt19937& rng) {
+        // 従来の計算 [現在の高さ, 1ステップ前の高さ] と比較
+        {
+            constexpr u32       n = 64;
+            physics::WaveField  validation(n, n);
+            std::vector<float2> current(n * n, float2(0.0f, 0.0f));
+            std::vector<float2> next(n * n, float2(0.0f, 0.0f));
+
+            validation.setParallel(parallel);
+            f32 max_error = 0.0f;
+            for(u32 frame = 0; frame < 256; ++frame) {
+                if(frame % 32 == 0) {
+                    u32 x = 1 + rng() % (n - 2);
+                    u32 y = 1 + rng() % (n - 2);
+                    validation.at(x, y) += 1.0f;
+                    current[y * n + x].x += 1.0f;
+                }
+                validation.step();
+
+                for(u32 y = 1; y < n - 1; ++y) {
+                    for(u32 x = 1; x < n - 1; ++x) {
+                        float2 center   = current[y * n + x];
+                        f32    neighbor = current[y * n + x + 1].x + current[y * n + x - 1].x;
+                        neighbor += current[(y + 1) * n + x].x + current[(y - 1) * n + x].x;
+
+                        f32 height      = 2.0f * center.x - center.y + 0.125f * (neighbor - 4.0f * center.x);
+                        next[y * n + x] = float2(height, center.x) * 0.994f;
+                    }
+                }
+                std::swap(current, next);
+
+                for(u32 i = 0; i < n * n; ++i)
+                    max_error = std::max(max_error, std::abs(validation.heights()[i] - current[i].x));
+            }
+            std::printf("%-24s validation: max error %g\n", name.c_str(), max_error);
+            check(max_error < 1e-4f, name, "wave field differs from the reference solver");
+        }
+
+        field->resize(size, size);
+        field->setParallel(parallel);
+    };
+    s.update_ = [=](std::mt19937& rng, u32 frame) {
+        if(frame % 8 == 0)
+            field->at(1 + rng() % (size - 2), 1 + rng() % (size - 2)) += 1.0f;
+        field->step();
+    };
+    s.exit_ = [=]() { *field = {}; };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャプールの共有/解放 (読み込みなし)
+//! @details 実ファイルを読まない読み込み関数で、プールの管理コストとヒット率を計測します。
+//!          管理方針の確認はテスト(texture_pool_*)で行います。
+//!          毎フレーム偏りのある乱数でパスを選んで取得し、直近の参照を一定数だけ保持します
+//---------------------------------------------------------------------------
+Scenario texturePoolScenario(u32 texture_count, u32 acquire_per_frame)
+{
+    constexpr u64 TEXTURE_BYTES = 4ull * 1024 * 1024;   // 1枚あたりのサイズ (2048x2048 BC3相当)
+    constexpr u32 HOLD_COUNT    = 64;                   // 保持する参照の数
+
+    // 実ファイルを読まない読み込み関数
+    auto fake_load   = [](const std::string&) { return std::make_shared<Texture>(); };
+    auto fake_size   = [](const Texture&) { return TEXTURE_BYTES; };
+    auto fake_status = [](const Texture&) { return TexturePool::Status::Loaded; };
+
+    auto pool  = std::make_shared<TexturePool>(fake_load, fake_size, fake_status);
+    auto paths = std::make_shared<std::vector<std::string>>();
+    auto held  = std::make_shared<std::vector<std::shared_ptr<Texture>>>(HOLD_COUNT);
+
+    std::string name = "texpool_n" + std::to_string(texture_count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = u8"テクスチャプールの共有と予算超過時の解放負荷 (" + std::to_string(texture_count) + u8"パス)";
+    s.init_ = [=]([[maybe_unused]] std::mt19937& rng) {
+        paths->clear();
+        for(u32 i = 0; i < texture_count; ++i)
+            paths->push_back("data/Texture/" + std::to_string(i) + ".dds");
+
+        // 全体の1/4だけ残せる予算
+        pool->clear();
+        pool->resetStats();
+        pool->setBudget(TEXTURE_BYTES * texture_count / 4);
+    };
+    s.update_ = [=](std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        for(u32 i = 0; i < acquire_per_frame; ++i) {
+            // 2乗で小さい番号に偏らせる (よく使うテクスチャほど共有される)
+            f32 r     = random(rng, 0.0f, 1.0f);
+            u32 index = std::min(static_cast<u32>(r * r * texture_count), texture_count - 1);
+
+            (*held)[rng() % HOLD_COUNT] = pool->acquire((*paths)[index]);
+        }
+        pool->update();
+    };
+    s.exit_ = [=]() {
+        auto stats    = pool->stats();
+        f64  requests = static_cast<f64>(std::max(stats.hits_ + stats.misses_, u64(1)));
+        std::printf("%-24s hit rate %.1f%% (%llu evictions)\n",
+                    name.c_str(),
+                    100.0 * static_cast<f64>(stats.hits_) / requests,
+                    stats.evictions_);
+
+        std::fill(held->begin(), held->end(), nullptr);
+        pool->clear();
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! アニメーションの生成 (クリップ共有 / 従来のMV1複製)
+//! @details 初期化時にinstance_count体分のメモリ使用量(DxLibの確保量)とMV1ハンドル数を従来方式と比較して表示します。
+//!          毎フレームinstance_count体分のアニメーションを作り直します
+//---------------------------------------------------------------------------
+Scenario animationScenario(u32 instance_count, bool shared)
+{
+    // {アニメーション名, ファイル名, ファイル内のアニメーション番号, 再生速度}
+    static const Animation::Desc desc[] = {
+        {  "idle",   "data/Sample/Player/Anim/Idle.mv1", 1, 1.0f},
+        {  "jump",   "data/Sample/Player/Anim/Jump.mv1", 1, 1.0f},
+        {  "walk",   "data/Sample/Player/Anim/Walk.mv1", 1, 1.0f},
+        { "walk2",  "data/Sample/Player/Anim/Walk2.mv1", 1, 1.0f},
+        {"dance1", "data/Sample/Player/Anim/Dance1.mv1", 0, 1.0f},
+        {"dance2", "data/Sample/Player/Anim/Dance2.mv1", 0, 1.0f},
+        {"dance3", "data/Sample/Player/Anim/Dance3.mv1", 0, 1.0f},
+        {"dance4", "data/Sample/Player/Anim/Dance4.mv1", 0, 1.0f},
+        {"dance5", "data/Sample/Player/Anim/Dance5.mv1", 0, 1.0f},
+    };
+    constexpr u32 CLIP_COUNT = static_cast<u32>(std::size(desc));
+
+    auto animations = std::make_shared<std::vector<std::unique_ptr<Animation>>>();
+    auto handles    = std::make_shared<std::vector<int>>();
+
+    // 従来の方式 (インスタンス×クリップ数のMV1複製)
+    auto duplicate = [=]() {
+        for(u32 i = 0; i < instance_count; ++i) {
+            for(u32 clip = 0; clip < CLIP_COUNT; ++clip)
+                handles->push_back(MV1DuplicateModel(*(*animations->front()->clipSet())[clip].resource_));
+        }
+    };
+    auto release_duplicates = [=]() {
+        for(int handle : *handles)
+            MV1DeleteModel(handle);
+        handles->clear();
+    };
+    // クリップを共有するアニメーションを作成 (先頭の1体は読み込み用に常に保持)
+    auto create = [=]() {
+        for(u32 i = 0; i < instance_count; ++i)
+            animations->push_back(std::make_unique<Animation>(desc, CLIP_COUNT));
+    };
+    auto release_animations = [=]() { animations->resize(1); };
+
+    std::string name = std::string(shared ? "anim_shared_n" : "anim_duplicate_n") + std::to_string(instance_count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = shared ? u8"アニメーションの生成負荷 (クリップを共有)" : u8"アニメーションの生成負荷 (従来のクリップごとのMV1複製)";
+    s.init_ = [=]([[maybe_unused]] std::mt19937& rng) {
+        // アニメーションMV1の読み込み完了を待つ
+        animations->clear();
+        animations->push_back(std::make_unique<Animation>(desc, CLIP_COUNT));
+        WaitHandleASyncLoadAll();
+
+        if(!shared)
+            return;
+
+        // 従来の方式とのメモリ使用量の比較
+        size_t base = DxGetAllocSize();
+        duplicate();
+        size_t duplicate_bytes = DxGetAllocSize() - base;
+        size_t duplicate_count = handles->size();
+        release_duplicates();
+
+        // 共有方式はインスタンス本体(C++ヒープ)も加算
+        base = DxGetAllocSize();
+        create();
+        size_t shared_bytes = DxGetAllocSize() - base + sizeof(Animation) * instance_count;
+        release_animations();
+
+        std::printf("%-24s memory: duplicate %.1f KB (%zu MV1 handles) / shared %.1f KB (%u MV1 handles)\n",
+                    name.c_str(),
+                    static_cast<f64>(duplicate_bytes) / 1024.0,
+                    duplicate_count,
+                    static_cast<f64>(shared_bytes) / 1024.0,
+                    CLIP_COUNT);
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        if(shared) {
+            release_animations();
+            create();
+        }
+        else {
+            release_duplicates();
+            duplicate();
+        }
+    };
+    s.exit_ = [=]() {
+        release_duplicates();
+        animations->clear();
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 手続き的なアニメーションのキーフレームを作成 (関節ごとに位相の異なる揺れ)
+//! @param  [in]    skeleton    スケルトン
+//! @param  [in]    frequency   揺れの周波数 (1秒あたり)
+//! @param  [in]    amplitude   揺れの角度 (単位:ラジアン)
+//! @param  [in]    seed        関節ごとの回転軸と位相の乱数シード
+//---------------------------------------------------------------------------
+std::vector<animation::Pose> makeAnimationFrames(const animation::Skeleton& skeleton, f32 frequency, f32 amplitude, u32 seed)
+{
+    constexpr u32 SAMPLE_RATE = 30;
+
+    std::mt19937        rng(seed);
+    std::vector<float3> axes(skeleton.jointCount());
+    std::vector<f32>    phases(skeleton.jointCount());
+    for(u32 joint = 0; joint < skeleton.jointCount(); ++joint) {
+        axes[joint]   = normalize(randomFloat3(rng, 1.0f) + float3(0.0f, 0.0f, 0.01f));
+        phases[joint] = random(rng, 0.0f, TAU);
+    }
+
+    std::vector<animation::Pose> frames(SAMPLE_RATE + 1, animation::Pose(skeleton.jointCount()));
+    for(u32 frame = 0; frame <= SAMPLE_RATE; ++frame) {
+        f32 t = static_cast<f32>(frame) / SAMPLE_RATE;
+        for(u32 joint = 0; joint < skeleton.jointCount(); ++joint) {
+            auto& trs = frames[frame][joint];
+
+            f32 angle      = amplitude * std::sin(TAU * frequency * t + phases[joint]);
+            trs.rotate_    = quaternion::rotation_axis(axes[joint], angle);
+            trs.translate_ = float3(0.0f, 0.1f, 0.0f);   // 骨の長さ (平行移動は定数トラック)
+        }
+        // ルートのみ移動
+        frames[frame][0].translate_ = float3(0.0f, 0.05f * std::sin(TAU * t), 0.0f);
+    }
+    return frames;
+}
+
+//---------------------------------------------------------------------------
+//! エンジン側のスケルタルアニメーション (群衆)
+//! @details 64関節のキャラクターごとに 3方向ブレンド(上書き) + 差分アニメーション(加算) を評価します。
+//!          初期化時にキー間の球面線形補間との誤差、差分の往復誤差、並列/逐次の結果の差の最大値を表示します
+//---------------------------------------------------------------------------
+Scenario skeletalScenario(u32 character_count, bool parallel)
+{
+    constexpr u32 JOINT_COUNT = 64;
+
+    struct State
+    {
+        std::vector<std::unique_ptr<animation::Animator>> animators_;
+        std::vector<animation::Animator*>                 pointers_;
+    };
+    auto state = std::make_shared<State>();
+
+    std::string name = "skeletal_n" + std::to_string(character_count) + (parallel ? "_par" : "_seq");
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = parallel ? u8"スケルタルアニメーションのブレンド負荷 (キャラクター単位で並列)" : u8"スケルタルアニメーションのブレンド負荷 (1スレッド)";
+    s.init_ = [=](std::mt19937& rng) {
+        //----------------------------------------------------------
+        // スケルトン (4本の枝を持つ木構造) とクリップ
+        //----------------------------------------------------------
+        std::vector<s32> parents(JOINT_COUNT);
+        for(u32 joint = 0; joint < JOINT_COUNT; ++joint)
+            parents[joint] = joint == 0 ? -1 : (joint <= 4 ? 0 : static_cast<s32>(joint - 4));
+        auto skeleton = std::make_shared<animation::Skeleton>(parents);
+
+        auto idle_frames = makeAnimationFrames(*skeleton, 1.0f, 0.1f, 1);
+        auto walk_frames = makeAnimationFrames(*skeleton, 2.0f, 0.6f, 2);
+        auto run_frames  = makeAnimationFrames(*skeleton, 3.0f, 1.2f, 3);
+        auto lean_frames = makeAnimationFrames(*skeleton, 1.0f, 0.3f, 4);
+
+        auto idle = std::make_shared<animation::Clip>(30.0f, idle_frames);
+        auto walk = std::make_shared<animation::Clip>(30.0f, walk_frames);
+        auto run  = std::make_shared<animation::Clip>(30.0f, run_frames);
+        auto lean = std::make_shared<animation::Clip>(30.0f, lean_frames);
+
+        animation::Pose reference;
+        lean->sample(0.0f, false, reference);
+        lean->makeAdditive(reference);
+
+        //----------------------------------------------------------
+        // 検証
+        //----------------------------------------------------------
+        {
+            auto rotation_error = [](const quaternion& a, const quaternion& b) {
+                // qと-qは同じ回転
+                return 1.0f - std::abs(static_cast<f32>(dot(a, b)));
+            };
+            f32 max_error = 0.0f;
+
+            // キー間の球面線形補間との比較
+            animation::Clip source(30.0f, run_frames);
+            animation::Pose pose;
+            for(u32 i = 0; i < 256; ++i) {
+                f32 time = random(rng, 0.0f, source.duration());
+                source.sample(time, false, pose);
+
+                f32 position = time * 30.0f;
+                u32 frame0   = std::min(static_cast<u32>(position), source.frameCount() - 2);
+                f32 ratio    = position - static_cast<f32>(frame0);
+                for(u32 joint = 0; joint < JOINT_COUNT; ++joint) {
+                    quaternion expected = slerp(run_frames[frame0][joint].rotate_, run_frames[frame0 + 1][joint].rotate_, ratio);
+                    max_error           = std::max(max_error, rotation_error(pose[joint].rotate_, expected));
+                }
+            }
+
+            // 差分の往復 (基準姿勢 + 差分 = 元の姿勢)
+            animation::Clip original(30.0f, lean_frames);
+            animation::Pose expected;
+            for(u32 i = 0; i < 64; ++i) {
+                f32 time = random(rng, 0.0f, original.duration());
+                original.sample(time, false, expected);
+
+                pose = reference;
+                lean->applyAdditive(time, false, 1.0f, pose);
+                for(u32 joint = 0; joint < JOINT_COUNT; ++joint) {
+                    max_error = std::max(max_error, rotation_error(pose[joint].rotate_, expected[joint].rotate_));
+                    max_error = std::max(max_error, static_cast<f32>(length(pose[joint].translate_ - expected[joint].translate_)));
+                }
+            }
+            std::printf("%-24s validation: max error %g (keyframes %.1f KB/clip, %u joints)\n",
+                        name.c_str(),
+                        max_error,
+                        static_cast<f64>(walk->byteSize()) / 1024.0,
+                        JOINT_COUNT);
+            check(max_error < 1e-3f, name, "sampled pose differs from the reference");
+        }
+
+        //----------------------------------------------------------
+        // キャラクター
+        //----------------------------------------------------------
+        state->animators_.clear();
+        state->pointers_.clear();
+        for(u32 i = 0; i < character_count; ++i) {
+            auto animator = std::make_unique<animation::Animator>(skeleton);
+
+            // 移動速度に応じた3方向ブレンド
+            f32   speed = random(rng, 0.0f, 1.0f);
+            auto& base  = animator->layer(0);
+            base.inputs_.push_back({idle, random(rng, 0.0f, 1.0f), 1.0f, std::max(0.0f, 1.0f - speed * 2.0f), true});
+            base.inputs_.push_back({walk, random(rng, 0.0f, 1.0f), 1.0f, 1.0f - std::abs(speed * 2.0f - 1.0f), true});
+            base.inputs_.push_back({run, random(rng, 0.0f, 1.0f), 1.0f, std::max(0.0f, speed * 2.0f - 1.0f), true});
+
+            // 上半身の傾き (加算)
+            auto& additive   = animator->layer(1);
+            additive.mode_   = animation::Animator::BlendMode::Additive;
+            additive.weight_ = 0.5f;
+            additive.inputs_.push_back({lean, random(rng, 0.0f, 1.0f), 1.0f, 1.0f, true});
+
+            state->pointers_.push_back(animator.get());
+            state->animators_.push_back(std::move(animator));
+        }
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        animation::update(state->pointers_.data(), state->pointers_.size(), 1.0f / 60.0f, parallel);
+    };
+    s.exit_ = [=]() { *state = {}; };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! アニメーションLOD (群衆)
+//! @details ComponentModel + Animation でキャラクターを半径600に散らばせ、旋回するカメラから見て
+//!          画面上の大きさで姿勢の反映頻度を間引きます。再生時間は全キャラクター毎フレーム進めます。
+//!          終了時にレベルごとの平均キャラクター数と、毎フレーム反映に対する反映回数の比を表示します
+//! @param  [in]    character_count キャラクター数
+//! @param  [in]    use_lod         true:アニメーションLODで間引く false:全キャラクターを毎フレーム反映 (比較用)
+//! @param  [in]    use_animator    true:エンジン側のアニメーターで姿勢を計算 false:DxLibのアタッチで再生
+//---------------------------------------------------------------------------
+Scenario animationLodScenario(u32 character_count, bool use_lod, bool use_animator)
+{
+    constexpr f32 RADIUS = 600.0f;   // キャラクターを配置する範囲 (0.08倍で身長およそ12)
+    constexpr u32 LEVELS = static_cast<u32>(AnimationLod::Level::NUM);
+
+    struct State
+    {
+        std::vector<ComponentModelPtr> models_;
+        f64                            counts_[LEVELS] = {};
+        f64                            sampled_        = 0.0;
+        f64                            throttled_      = 0.0;
+        u32                            frames_         = 0;
+    };
+    auto state = std::make_shared<State>();
+
+    std::string name = "animlod_n" + std::to_string(character_count) + (use_lod ? "" : "_full") +
+                       (use_animator ? "_animator" : "");
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = use_lod ? u8"アニメーションLODで姿勢の反映を間引いた群衆" : u8"全キャラクターを毎フレーム反映する群衆 (比較用)";
+    s.init_ = [=](std::mt19937& rng) {
+        *state = {};
+
+        GetAnimationLod().settings().enabled_ = use_lod;
+
+        for(u32 i = 0; i < character_count; ++i) {
+            f32  r     = RADIUS * std::sqrt(random(rng, 0.0f, 1.0f));
+            f32  theta = random(rng, 0.0f, TAU);
+            auto obj   = Scene::CreateObject<Object>()->SetTranslate(float3(std::cos(theta) * r, 0.0f, std::sin(theta) * r));
+
+            // 4人に1人は処理時間が無ければ更新しない群衆
+            auto model = obj->AddComponent<ComponentModel>("data/Game/Player/model.mv1");
+            model->SetScaleAxisXYZ({0.08f});
+            model->SetUseAnimator(use_animator);
+            model->SetAnimationPriority((i & 3) == 3 ? Priority::IFPOSSIBLE : Priority::NORMAL);
+            model->SetAnimation({
+                {"idle", "data/Game/Player/Anim/Idle.mv1", 0, 1.0f},
+                { "run",  "data/Game/Player/Anim/Run.mv1", 0, 1.0f},
+            });
+            state->models_.push_back(model);
+        }
+
+        // モデルとアニメーションの読み込み完了を待ってから再生
+        auto loaded = [=]() {
+            return std::all_of(state->models_.begin(), state->models_.end(), [](const ComponentModelPtr& model) {
+                return model->GetModelClass()->isActive();
+            });
+        };
+        for(u32 retry = 0; retry < 1000 && !loaded(); ++retry) {
+            WaitHandleASyncLoadAll();
+            GetStreamingManager().update();
+        }
+
+        for(auto& model : state->models_)
+            model->PlayAnimation("run", true, 0.2f, random(rng, 0.0f, 20.0f));
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, u32 frame) {
+        // 直前のフレームの統計を集計 (ComponentModel::Update()はシーンの更新の後に呼ばれる)
+        if(frame > 0) {
+            const auto& stats = GetAnimationLod().stats();
+            for(u32 level = 0; level < LEVELS; ++level)
+                state->counts_[level] += stats.counts_[level];
+            state->sampled_   += stats.sampled_;
+            state->throttled_ += stats.throttled_;
+            state->frames_++;
+        }
+
+        // カメラは原点の周りを旋回
+        f32     angle = static_cast<f32>(frame) * (TAU / 600.0f);
+        Frustum frustum;
+        frustum.setPosition(float3(std::sin(angle) * 60.0f, 12.0f, -std::cos(angle) * 60.0f));
+        frustum.setLookAt(float3(0.0f, 6.0f, 0.0f));
+        frustum.setFarZ(RADIUS * 2.0f);
+        frustum.update();
+        GetAnimationLod().beginFrame(frustum);
+
+        // 一定間隔で再生を切り替えてブレンドも計測
+        if(frame % 120 == 60) {
+            for(auto& model : state->models_)
+                model->PlayAnimation(frame % 240 == 60 ? "idle" : "run", true, 0.5f);
+        }
+    };
+    s.exit_ = [=]() {
+        f64 frames = static_cast<f64>(std::max(state->frames_, 1u));
+        f64 ratio  = state->sampled_ / (static_cast<f64>(character_count) * frames);
+        std::printf("%-24s avg full %.0f half %.0f quarter %.0f hidden %.0f throttled %.1f, applies %.1f%% of full rate\n",
+                    name.c_str(),
+                    state->counts_[0] / frames,
+                    state->counts_[1] / frames,
+                    state->counts_[2] / frames,
+                    state->counts_[3] / frames,
+                    state->throttled_ / frames,
+                    ratio * 100.0);
+        bench::check(state->sampled_ > 0.0, name, "no animation was applied");
+
+        GetAnimationLod().settings().enabled_ = true;
+
+        *state = {};
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! 描画キュー (ステート順の並べ替え)
+//! @details 32種類のモデル(8トライアングルリスト, 4シェーダー)を登録順がばらばらに配置し、
+//!          基数ソートして実行します。描画は切り替え回数を数えるだけの実行器で行います。
+//!          初期化時に std::stable_sort との並び順の一致と、登録順のまま実行した場合との切り替え回数を表示します。
+//!          まとめたグループも Model::Executor と同じく1インスタンス1回の描画呼び出しとして数えます
+//---------------------------------------------------------------------------
+Scenario renderQueueScenario(u32 instance_count)
+{
+    constexpr u32 MODEL_TYPES  = 32;   // モデルの種類
+    constexpr u32 TLIST_COUNT  = 8;    // モデルあたりのトライアングルリスト数
+    constexpr u32 SHADER_TYPES = 4;    // 頂点シェーダーのバリエーション数
+
+    //! 切り替え回数を数える実行器
+    struct CountExecutor : RenderQueue::Executor
+    {
+        void bindShader([[maybe_unused]] const RenderQueue::Packet& packet) override { shader_changes_++; }
+        void bindMaterial([[maybe_unused]] const RenderQueue::Packet& packet) override { material_changes_++; }
+        void draw(const RenderQueue::Packet& packet, [[maybe_unused]] bool object_changed) override
+        {
+            checksum_ += static_cast<u64>(packet.sub_mesh_);
+            draw_calls_++;
+            drawn_++;
+        }
+        void drawInstanced(const RenderQueue::Packet* const* packets, u32 count) override
+        {
+            for(u32 i = 0; i < count; ++i) {
+                // まとめたパケットはステートとインスタンスキーが一致していること
+                if(packets[i]->instance_key_ != packets[0]->instance_key_ ||
+                   packets[i]->shader_state_ != packets[0]->shader_state_ ||
+                   packets[i]->material_state_ != packets[0]->material_state_)
+                    mismatches_++;
+                checksum_ += static_cast<u64>(packets[i]->sub_mesh_);
+            }
+            // DxLibにはMV1のインスタンス描画がないため、Model::Executor と同じく1インスタンスずつ描画する
+            draw_calls_ += count;
+            drawn_ += count;
+        }
+
+        u64 shader_changes_   = 0;
+        u64 material_changes_ = 0;
+        u64 checksum_         = 0;
+        u64 draw_calls_       = 0;   // 描画呼び出し数
+        u64 drawn_            = 0;   // 描画したパケット数
+        u64 mismatches_       = 0;   // まとめてはいけないパケットをまとめた数
+    };
+
+    struct Instance
+    {
+        u32    model_;      //!< モデルの種類
+        float3 position_;   //!< 位置
+    };
+
+    struct State
+    {
+        std::vector<Instance> instances_;
+        RenderQueue           queue_;
+        CountExecutor         executor_;
+    };
+    auto state = std::make_shared<State>();
+
+    // 全インスタンスを登録
+    auto submit = [=](RenderQueue& queue) {
+        for(u32 i = 0; i < state->instances_.size(); ++i) {
+            const auto& instance = state->instances_[i];
+
+            RenderQueue::Packet packet;
+            packet.object_ = &instance;
+            packet.mesh_   = 0;
+            packet.depth_  = length(instance.position_).x;
+            packet.world_  = matrix::translate(instance.position_);
+            for(u32 t = 0; t < TLIST_COUNT; ++t) {
+                packet.sub_mesh_       = static_cast<s32>(t);
+                packet.material_       = static_cast<s32>(t);
+                packet.shader_state_   = (instance.model_ + t) % SHADER_TYPES;
+                packet.material_state_ = instance.model_ * TLIST_COUNT + t;
+                packet.instance_key_   = instance.model_ * TLIST_COUNT + t + 1;   // 同じモデルの同じトライアングルリスト
+                queue.submit(packet);
+            }
+        }
+    };
+
+    std::string name = "renderqueue_n" + std::to_string(instance_count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = u8"描画パケットの基数ソートとステート順の実行";
+    s.init_ = [=](std::mt19937& rng) {
+        state->instances_.clear();
+        for(u32 i = 0; i < instance_count; ++i) {
+            state->instances_.push_back({static_cast<u32>(rng() % MODEL_TYPES), randomFloat3(rng, 50.0f)});
+        }
+
+        //----------------------------------------------------------
+        // 検証
+        //----------------------------------------------------------
+        {
+            // 基数ソートと比較ソートの並び順の一致
+            std::vector<RenderQueue::SortItem> items, work;
+            for(u32 i = 0; i < 4096; ++i) {
+                u64 key = (static_cast<u64>(rng()) << 32) | rng();
+                items.push_back({key & ((i & 1) ? ~0ull : 0xffff00000000ffffull), i});   // 偶数番は同じキーが多い
+            }
+            auto expected = items;
+            std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.key_ < b.key_; });
+            RenderQueue::radixSort(items, work);
+
+            u32 mismatches = 0;
+            for(size_t i = 0; i < items.size(); ++i) {
+                if(items[i].key_ != expected[i].key_ || items[i].index_ != expected[i].index_)
+                    mismatches++;
+            }
+
+            // 登録順のまま実行した場合の切り替え回数
+            u64 unsorted_shader   = 0;
+            u64 unsorted_material = 0;
+            {
+                RenderQueue queue;
+                submit(queue);
+                u64 last_shader   = ~0ull;
+                u64 last_material = ~0ull;
+                for(u32 i = 0; i < instance_count; ++i) {
+                    for(u32 t = 0; t < TLIST_COUNT; ++t) {
+                        u64 shader   = (state->instances_[i].model_ + t) % SHADER_TYPES;
+                        u64 material = state->instances_[i].model_ * TLIST_COUNT + t;
+                        if(shader != last_shader)
+                            unsorted_shader++;
+                        if(material != last_material)
+                            unsorted_material++;
+                        last_shader   = shader;
+                        last_material = material;
+                    }
+                }
+
+                state->executor_ = {};
+                auto stats       = queue.execute(state->executor_);
+                bool ok          = mismatches == 0 && state->executor_.mismatches_ == 0 &&
+                          state->executor_.drawn_ == stats.packets_ && state->executor_.draw_calls_ == stats.packets_;
+                std::printf("%-24s validation: %s (sort mismatches %u, batch mismatches %llu), packets %u, "
+                            "shader changes %llu -> %u, material changes %llu -> %u, "
+                            "draw calls %llu (%u groups share state for %u packets)\n",
+                            name.c_str(),
+                            ok ? "ok" : "NG",
+                            mismatches,
+                            state->executor_.mismatches_,
+                            stats.packets_,
+                            unsorted_shader,
+                            stats.shader_changes_,
+                            unsorted_material,
+                            stats.material_changes_,
+                            state->executor_.draw_calls_,
+                            stats.instance_batches_,
+                            stats.instances_);
+                check(ok, name, "sort/batch result mismatch");
+            }
+        }
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        state->queue_.clear();
+        submit(state->queue_);
+        state->queue_.execute(state->executor_);
+    };
+    s.exit_ = [=]() { *state = {}; };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! アセットストリーミング (偽のI/Oバックエンド)
+//! @details I/O時間(フレーム数)と仕上げ時間(ミリ秒)を乱数で決めた偽の要求を、偽の時計で処理します。
+//!          同時読み込み数/仕上げ予算/取り消し/優先度/グループ集計の確認はテスト(streaming_*)で行います。
+//!          毎フレーム request_per_frame 件を要求し、一部を取り消しながら更新します
+//---------------------------------------------------------------------------
+Scenario streamingScenario(u32 request_count, u32 request_per_frame)
+{
+    constexpr u32 MAX_IN_FLIGHT = 8;      // 同時読み込み数の上限
+    constexpr f32 BUDGET_MS     = 2.0f;   // 仕上げ予算 (ミリ秒)
+    constexpr f32 MAX_COST_MS   = 1.5f;   // 1件の仕上げ時間の最大値 (ミリ秒)
+
+    //! 偽の読み込み対象
+    struct FakeAsset
+    {
+        u32  io_frames_ = 0;       //!< I/Oにかかるフレーム数
+        f32  cost_ms_   = 0.0f;    //!< 仕上げ時間 (ミリ秒)
+        bool fail_      = false;   //!< I/Oを失敗させるか
+        bool visible_   = false;   //!< 画面に映っているか
+        f32  distance_  = 0.0f;    //!< カメラからの距離
+        u32  started_   = 0;       //!< 開始したフレーム
+    };
+
+    struct State
+    {
+        f64                                      now_   = 0.0;   // 偽の時計 (ミリ秒)
+        u32                                      frame_ = 0;     // 現在のフレーム
+        std::deque<FakeAsset>                    assets_;
+        std::vector<StreamingManager::RequestId> ids_;
+        std::unique_ptr<StreamingManager>        manager_;
+    };
+    auto state = std::make_shared<State>();
+
+    // 偽のバックエンドで要求を作成
+    auto make_request = [=](std::mt19937& rng) {
+        auto& asset      = state->assets_.emplace_back();
+        asset.io_frames_ = 1 + rng() % 8;
+        asset.cost_ms_   = random(rng, 0.1f, MAX_COST_MS);
+        asset.fail_      = rng() % 32 == 0;
+        asset.visible_   = rng() % 4 == 0;
+        asset.distance_  = random(rng, 1.0f, 100.0f);
+
+        StreamingManager::Request request;
+        request.start_ = [=, &asset]() {
+            asset.started_ = state->frame_;
+            return true;
+        };
+        request.poll_ = [=, &asset]() {
+            if(state->frame_ - asset.started_ < asset.io_frames_)
+                return StreamingManager::Poll::Pending;
+            return asset.fail_ ? StreamingManager::Poll::Failed : StreamingManager::Poll::Done;
+        };
+        request.finalize_ = [=, &asset]() {
+            state->now_ += asset.cost_ms_;   // 仕上げ時間だけ時計を進める
+            return true;
+        };
+        request.distance_ = asset.distance_;
+
+        state->ids_.push_back(state->manager_->request(std::move(request)));
+    };
+
+    // 1フレーム分の更新 (画面に映っている要求を通知してから更新)
+    auto step = [=]() {
+        auto& manager = *state->manager_;
+        for(size_t i = 0; i < state->assets_.size(); ++i) {
+            if(state->assets_[i].visible_)
+                manager.touch(state->ids_[i], state->assets_[i].distance_);
+        }
+        manager.update();
+        state->frame_++;
+    };
+
+    auto reset = [=]() {
+        state->now_   = 0.0;
+        state->frame_ = 0;
+        state->assets_.clear();
+        state->ids_.clear();
+        state->manager_ = std::make_unique<StreamingManager>([=]() { return state->now_; });
+        state->manager_->setSettings({MAX_IN_FLIGHT, BUDGET_MS});
+    };
+
+    std::string name = "streaming_n" + std::to_string(request_count);
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = u8"アセットストリーミングの優先度/同時読み込み数/仕上げ予算 (偽のI/O)";
+    s.init_ = [=](std::mt19937& rng) {
+        // 読み込み待ちの要求を積んだ状態から開始
+        reset();
+        for(u32 i = 0; i < request_count; ++i) {
+            make_request(rng);
+        }
+    };
+    s.update_ = [=](std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        // 定常状態: 毎フレーム要求し、古い要求から一部を取り消す
+        for(u32 i = 0; i < request_per_frame; ++i) {
+            make_request(rng);
+        }
+        if(rng() % 2 == 0)
+            state->manager_->cancel(state->ids_[rng() % state->ids_.size()]);
+        step();
+    };
+    s.exit_ = [=]() { reset(); };
+    return s;
+}
+
+//! OSのファイルキャッシュから追い出す (初回読み込みの計測用)
+//! @details FILE_FLAG_NO_BUFFERINGで開くと、他にハンドルがなければキャッシュ済みのページが破棄されます
+bool purgeFileCache(const std::filesystem::path& path)
+{
+    HANDLE handle = CreateFileW(path.c_str(),
+                                GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_FLAG_NO_BUFFERING,
+                                nullptr);
+    if(handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    CloseHandle(handle);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! モデルキャッシュの読み込み (data/以下の全MV1モデル)
+//! @details 初期化時に指定形式でキャッシュを作り直し、ファイルサイズと初回読み込み時間を表示します。
+//!          毎フレーム全モデルのキャッシュを読み込み直すため、フレーム時間が2回目以降の読み込み時間になります
+//---------------------------------------------------------------------------
+Scenario modelCacheScenario(ModelCache::Codec codec)
+{
+    auto paths = std::make_shared<std::vector<std::string>>();
+
+    std::string name = codec == ModelCache::Codec::Meshopt ? "modelcache_meshopt" : "modelcache_raw";
+
+    Scenario s;
+    s.name_ = name;
+    s.desc_ = u8"モデルキャッシュの読み込み負荷とファイルサイズ (" + name + ")";
+    s.init_ = [=]([[maybe_unused]] std::mt19937& rng) {
+        paths->clear();
+
+        std::error_code error_code;
+        for(auto& entry : std::filesystem::recursive_directory_iterator("data", error_code)) {
+            if(entry.path().extension() == ".mv1")
+                paths->emplace_back(entry.path().generic_string());
+        }
+        std::sort(paths->begin(), paths->end());
+
+        // 指定形式でキャッシュを作り直す
+        for(auto& path : *paths) {
+            int mv1_handle = MV1LoadModel(path.c_str());
+            if(mv1_handle == -1)
+                continue;
+
+            ModelCache(path).save(mv1_handle, codec);
+            MV1DeleteModel(mv1_handle);
+        }
+
+        // 書き込み直後はOSのファイルキャッシュに載っているため、追い出してから初回読み込みを計測する
+        bool purged = true;
+        for(auto& path : *paths)
+            purged = purgeFileCache(ModelCache(path).cachePath()) && purged;
+
+        // ファイルサイズと初回読み込み時間
+        u64  file_size = 0;
+        u64  raw_size  = 0;
+        auto start     = std::chrono::high_resolution_clock::now();
+        for(auto& path : *paths) {
+            ModelCache cache(path);
+            if(!cache.load())
+                continue;
+
+            file_size += std::filesystem::file_size(cache.cachePath(), error_code);
+            raw_size += cache.vertices().size() * sizeof(VECTOR) + cache.indices().size() * sizeof(u32);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::printf("%-24s %zu models  file %8.2f MB  (raw geometry %8.2f MB)  first load %8.3f ms (%s)\n",
+                    name.c_str(),
+                    paths->size(),
+                    file_size / (1024.0 * 1024.0),
+                    raw_size / (1024.0 * 1024.0),
+                    std::chrono::duration<f64, std::milli>(end - start).count(),
+                    purged ? "file cache purged" : "file cache may be warm");
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, [[maybe_unused]] u32 frame) {
+        for(auto& path : *paths) {
+            ModelCache cache(path);
+            cache.load();
+        }
+    };
+    return s;
+}
+
+//---------------------------------------------------------------------------
+//! クラスターカリング (data/以下の全MV1モデル)
+//! @details モデルの周囲を周回するカメラで、毎フレーム全モデルのクラスターを視錐台/背面カリングします。
+//!          初期化時にクラスター数と可視率、ワイヤーフレーム用の辺インデックス数を表示します
+//---------------------------------------------------------------------------
+Scenario clusterCullScenario()
+{
+    auto caches = std::make_shared<std::vector<std::unique_ptr<ModelCache>>>();
+    auto ranges = std::make_shared<std::vector<MeshCluster::Range>>();
+
+    // モデルの周囲を周回するカメラ (ORBIT_FRAMESで1周)
+    constexpr u32 ORBIT_FRAMES = 128;
+
+    auto make_frustum = [](u32 frame) {
+        f32     angle = static_cast<f32>(frame % ORBIT_FRAMES) * (TAU / ORBIT_FRAMES);
+        Frustum frustum;
+        frustum.setPosition(float3(std::sinf(angle) * 30.0f, 10.0f, std::cosf(angle) * 30.0f))
+            .setLookAt(float3(0.0f, 0.0f, 0.0f));
+        frustum.update();
+        return frustum;
+    };
+
+    Scenario s;
+    s.name_ = "cluster_cull";
+    s.desc_ = u8"モデルキャッシュのクラスター単位の視錐台/背面カリング";
+    s.init_ = [=]([[maybe_unused]] std::mt19937& rng) {
+        caches->clear();
+
+        std::vector<std::string> paths;
+        std::error_code          error_code;
+        for(auto& entry : std::filesystem::recursive_directory_iterator("data", error_code)) {
+            if(entry.path().extension() == ".mv1")
+                paths.emplace_back(entry.path().generic_string());
+        }
+        std::sort(paths.begin(), paths.end());
+
+        for(auto& path : paths) {
+            auto cache = std::make_unique<ModelCache>(path);
+
+            // キャッシュが無い場合は作成する
+            if(!cache->isExist()) {
+                int mv1_handle = MV1LoadModel(path.c_str());
+                if(mv1_handle == -1)
+                    continue;
+                cache->save(mv1_handle);
+                MV1DeleteModel(mv1_handle);
+            }
+            if(cache->load())
+                caches->emplace_back(std::move(cache));
+        }
+
+        // ワイヤーフレーム用の辺インデックス数 (三角形ごとに3辺 / 重複しない辺のみ)
+        u64 triangle_edges = 0;
+        u64 unique_edges   = 0;
+        for(auto& cache : *caches) {
+            triangle_edges += cache->indices().size() * 2;
+            unique_edges += cache->edgeIndexCount();
+        }
+
+        // 1周分の平均可視率
+        u64 total   = 0;
+        u64 visible = 0;
+        for(u32 frame = 0; frame < ORBIT_FRAMES; ++frame) {
+            Frustum frustum = make_frustum(frame);
+            for(auto& cache : *caches) {
+                total += cache->clusters().clusters().size();
+                visible += cache->clusters().cull(frustum, matrix::identity(), *ranges);
+            }
+        }
+        std::printf("%-24s %zu models  %llu clusters  visible %6.2f %%  edge indices %llu -> %llu\n",
+                    "cluster_cull",
+                    caches->size(),
+                    total / ORBIT_FRAMES,
+                    total ? visible * 100.0 / total : 0.0,
+                    triangle_edges,
+                    unique_edges);
+    };
+    s.update_ = [=]([[maybe_unused]] std::mt19937& rng, u32 frame) {
+        Frustum frustum = make_frustum(frame);
+        for(auto& cache : *caches) {
+            cache->clusters().cull(frustum, matrix::identity(), *ranges);
+        }
+    };
+    s.exit_ = [=]() { caches->clear(); };
+    return s;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 標準シナリオを登録
+//---------------------------------------------------------------------------
+void registerBuiltinScenarios()
+{
+    registerScenario(objectsScenario(1000, 1));
+    registerScenario(objectsScenario(1000, 8));
+    registerScenario(objectsScenario(5000, 4));
+    registerScenario(collisionScenario(256));
+    registerScenario(physicsScenario(2000));
+    registerScenario(churnScenario(1000, 50));
+    registerScenario(bvhScenario(256, 4096));
+    registerScenario(pairScenario(65536, false));
+    registerScenario(pairScenario(65536, true));
+    for(auto isa : {simd::Isa::Scalar, simd::Isa::SSE, simd::Isa::AVX}) {
+        if(simd::isSupported(isa))
+            registerScenario(vectorMathScenario(isa, 65536));
+    }
+    registerScenario(easeScenario(65536, false));
+    registerScenario(easeScenario(65536, true));
+    registerScenario(waveScenario(1024, false));
+    registerScenario(waveScenario(1024, true));
+    registerScenario(texturePoolScenario(1024, 256));
+    registerScenario(animationScenario(20, false));
+    registerScenario(animationScenario(20, true));
+    registerScenario(skeletalScenario(512, false));
+    registerScenario(skeletalScenario(512, true));
+    registerScenario(animationLodScenario(256, false, false));
+    registerScenario(animationLodScenario(256, true, false));
+    registerScenario(animationLodScenario(256, true, true));
+    registerScenario(renderQueueScenario(2048));
+    registerScenario(streamingScenario(1024, 16));
+    registerScenario(clusterCullScenario());
+    registerScenario(modelCacheScenario(ModelCache::Codec::Raw));
+    registerScenario(modelCacheScenario(ModelCache::Codec::Meshopt));   // 既定の形式で終えるため最後に実行
+}
+
+}   // namespace bench
@@ -0,0 +1,904 @@
+﻿//---------------------------------------------------------------------------
+//! @file   BenchTests.cpp
+//! @brief  DxLibを必要とするテスト (ベンチマーク実行ファイルでのみ実行)
+//---------------------------------------------------------------------------
+#include "Check.h"
+#include "HeadlessRunner.h"
+
+#include <System/Physics/TriangleBVH.h>
+#include <System/Graphics/ModelCache.h>
+#include <System/Graphics/ResourceModel.h>
+#include <System/Graphics/Frustum.h>
+#include <System/Graphics/AnimationLod.h>
+#include <System/Animation/Animator.h>
+#include <System/Component/ComponentModel.h>
+#include <System/Component/ComponentCollisionModel.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+
+//! 比較に使用するサンプルメッシュ (ゲームで地形コリジョンとして読み込むもの)
+constexpr const char* SAMPLE_MESHES[] = {
+    "data/Sample/SwordBout/Stage/Stage00_c.mv1",
+    "data/Sample/SwordBout/Stage/Stage01_c.mv1",
+    "data/Sample/SwordBout/Stage/Stage_Obj001_c.mv1",
+};
+
+//! DxLibのモデルから作成した比較用メッシュ
+struct SampleMesh
+{
+    int                 handle_ = -1;     //!< [DxLib] MV1モデルハンドル
+    std::vector<float3> vertices_;        //!< 頂点 (ワールド空間)
+    std::vector<u32>    indices_;         //!< インデックス
+    std::vector<float3> centroids_;       //!< 三角形の重心 (DxLibの判定結果との対応付けに使用)
+    float3              min_ = float3(0.0f, 0.0f, 0.0f);   //!< AABB最小値
+    float3              max_ = float3(0.0f, 0.0f, 0.0f);   //!< AABB最大値
+
+    ~SampleMesh()
+    {
+        if(handle_ != -1)
+            MV1DeleteModel(handle_);
+    }
+};
+
+//! モデルを読み込み、参照用メッシュから三角形を取り出す
+bool loadSampleMesh(const char* path, SampleMesh& mesh)
+{
+    mesh.handle_ = MV1LoadModel(path);
+    if(mesh.handle_ == -1)
+        return false;
+
+    // コリジョン情報 (MV1CollCheck_*) と参照用メッシュ (三角形) を同じ姿勢で作成
+    MV1SetupCollInfo(mesh.handle_, -1, 8, 8, 8);
+    MV1SetupReferenceMesh(mesh.handle_, -1, TRUE);
+    MV1_REF_POLYGONLIST ref = MV1GetReferenceMesh(mesh.handle_, -1, TRUE);
+
+    mesh.vertices_.reserve(ref.VertexNum);
+    for(int i = 0; i < ref.VertexNum; ++i)
+        mesh.vertices_.push_back(cast(ref.Vertexs[i].Position));
+
+    mesh.indices_.reserve(static_cast<size_t>(ref.PolygonNum) * 3);
+    mesh.centroids_.reserve(ref.PolygonNum);
+    for(int i = 0; i < ref.PolygonNum; ++i) {
+        const auto& polygon = ref.Polygons[i];
+        float3      sum(0.0f, 0.0f, 0.0f);
+        for(u32 v = 0; v < 3; ++v) {
+            mesh.indices_.push_back(static_cast<u32>(polygon.VIndex[v]));
+            sum += mesh.vertices_[polygon.VIndex[v]];
+        }
+        mesh.centroids_.push_back(sum / 3.0f);
+    }
+    mesh.min_ = cast(ref.MinPosition);
+    mesh.max_ = cast(ref.MaxPosition);
+    return ref.PolygonNum > 0;
+}
+
+//! 比較用の三角形をモデルキャッシュの三角形に置き換える (実際の地形コリジョンと同じ三角形)
+//! @details 縮退三角形の除去と頂点の量子化を経た後の三角形で比較します
+bool useModelCacheTriangles(SampleMesh& mesh, ModelCache& cache)
+{
+    // キャッシュが無い(または古い)場合は作成する
+    if(!cache.read()) {
+        cache.save(mesh.handle_);
+        if(!cache.read())
+            return false;
+    }
+
+    mesh.vertices_.clear();
+    for(auto& v : cache.vertices())
+        mesh.vertices_.push_back(cast(v));
+
+    mesh.indices_ = cache.indices();
+    mesh.centroids_.clear();
+    for(size_t i = 0; i + 2 < mesh.indices_.size(); i += 3) {
+        mesh.centroids_.push_back(
+            (mesh.vertices_[mesh.indices_[i + 0]] + mesh.vertices_[mesh.indices_[i + 1]] + mesh.vertices_[mesh.indices_[i + 2]]) / 3.0f);
+    }
+    return !mesh.centroids_.empty();
+}
+
+//! AABB内の乱数座標
+float3 randomPoint(std::mt19937& rng, const float3& min, const float3& max)
+{
+    std::uniform_real_distribution<f32> t(0.0f, 1.0f);
+    return min + (max - min) * float3(t(rng), t(rng), t(rng));
+}
+
+//! DxLibの判定ポリゴンがBVHの接触点に含まれているか
+bool containsPolygon(const SampleMesh& mesh, const physics::TriangleBVH::Contacts& contacts, const MV1_COLL_RESULT_POLY& polygon, f32 tolerance)
+{
+    float3 centroid = (cast(polygon.Position[0]) + cast(polygon.Position[1]) + cast(polygon.Position[2])) / 3.0f;
+    for(auto& contact : contacts) {
+        if(static_cast<f32>(length(mesh.centroids_[contact.triangle_] - centroid)) < tolerance)
+            return true;
+    }
+    return false;
+}
+
+//! 球/カプセルの判定結果を比較
+//! @details DxLibの接触ポリゴンはすべてBVHにも含まれ、BVHの接触点のうち境界上(めり込みがほぼ0)でないものはDxLibにも含まれること
+bool sameContacts(const SampleMesh&                     mesh,
+                  const physics::TriangleBVH::Contacts& contacts,
+                  const MV1_COLL_RESULT_POLY_DIM&       result,
+                  f32                                   tolerance)
+{
+    u32 matched = 0;
+    for(int i = 0; i < result.HitNum; ++i) {
+        // 縮退三角形はモデルキャッシュから除去されている
+        const auto& p = result.Dim[i].Position;
+        if(mesh_cook::isDegenerate(&p[0].x, &p[1].x, &p[2].x))
+            continue;
+        if(!containsPolygon(mesh, contacts, result.Dim[i], tolerance))
+            return false;
+        ++matched;
+    }
+
+    u32 required = 0;
+    for(auto& contact : contacts) {
+        if(contact.penetration_ > tolerance)
+            ++required;
+    }
+    return matched >= required;
+}
+
+//! 上向き (+Y) の格子メッシュ
+//! @param  [in]    size    1辺の四角形の数 (原点中心に1.0間隔で並べる)
+mesh_cook::Mesh makeGridMesh(u32 size)
+{
+    mesh_cook::Mesh mesh;
+    f32             offset = static_cast<f32>(size) * 0.5f;
+    for(u32 z = 0; z <= size; ++z) {
+        for(u32 x = 0; x <= size; ++x) {
+            mesh.positions_.push_back(static_cast<f32>(x) - offset);
+            mesh.positions_.push_back(0.0f);
+            mesh.positions_.push_back(static_cast<f32>(z) - offset);
+        }
+    }
+    for(u32 z = 0; z < size; ++z) {
+        for(u32 x = 0; x < size; ++x) {
+            u32 a = z * (size + 1) + x;
+            u32 b = a + 1;
+            u32 c = a + size + 1;
+            u32 d = c + 1;
+
+            // DxLibの表面 (時計回り) の法線が +Y になる順
+            mesh.indices_.insert(mesh.indices_.end(), {a, c, b, b, c, d});
+        }
+    }
+    return mesh;
+}
+
+//! 点が視錐台の内側にあるか
+bool insideFrustum(const Frustum& frustum, const float3& position)
+{
+    for(const auto& plane : frustum.planes()) {
+        if(static_cast<f32>(dot(plane.xyz, position)) + static_cast<f32>(plane.w) <= 0.0f)
+            return false;
+    }
+    return true;
+}
+
+//! 見えている三角形がすべて可視範囲に含まれているか (カリングが見える三角形を除外していないか)
+//! @param  [out]   visible_triangles   可視範囲に含まれる三角形数
+bool cullIsConservative(const mesh_cook::Mesh&                 mesh,
+                        const std::vector<MeshCluster::Range>& ranges,
+                        const Frustum&                         frustum,
+                        const matrix&                          mat_world,
+                        u32&                                   visible_triangles)
+{
+    std::vector<bool> in_range(mesh.indices_.size() / 3, false);
+    visible_triangles = 0;
+    for(const auto& range : ranges) {
+        for(u32 t = range.index_offset_ / 3; t < (range.index_offset_ + range.index_count_) / 3; ++t) {
+            in_range[t] = true;
+            ++visible_triangles;
+        }
+    }
+
+    for(size_t t = 0; t < in_range.size(); ++t) {
+        float3 p[3];
+        for(u32 v = 0; v < 3; ++v) {
+            const f32* position = &mesh.positions_[mesh.indices_[t * 3 + v] * 3];
+            p[v]                = mul(float4(position[0], position[1], position[2], 1.0f), mat_world).xyz;
+        }
+
+        // 表面がカメラを向いていて、頂点のどれかが視錐台内にある三角形
+        float3 normal = cross(p[1] - p[0], p[2] - p[0]);
+        bool   front  = static_cast<f32>(dot(normal, frustum.position() - p[0])) > 0.0f;
+        bool   inside = insideFrustum(frustum, p[0]) || insideFrustum(frustum, p[1]) || insideFrustum(frustum, p[2]);
+        if(front && inside && !in_range[t])
+            return false;
+    }
+    return true;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! クラスターカリングは見える三角形を除外せず、視錐台外と背面のクラスターを除外する
+//---------------------------------------------------------------------------
+BENCH_TEST(cluster_cull_results)
+{
+    mesh_cook::Mesh mesh = makeGridMesh(64);
+
+    MeshCluster clusters;
+    clusters.build(mesh.positions_.data(), mesh.vertexCount(), sizeof(f32) * 3, mesh.indices_);
+    BENCH_CHECK(clusters.isValid());
+
+    u32 cluster_count = static_cast<u32>(clusters.clusters().size());
+
+    std::vector<MeshCluster::Range> ranges;
+    u32                             visible_triangles = 0;
+
+    // 格子の角を斜め上から近距離だけ見る (手前の一部のみ視錐台内)
+    Frustum above;
+    above.setPosition(float3(-32.0f, 8.0f, -40.0f)).setLookAt(float3(-24.0f, 0.0f, -24.0f)).setFarZ(30.0f);
+    above.update();
+
+    const matrix mat_worlds[] = {matrix::identity(), mul(matrix::scale(0.5f), matrix::translate(-8.0f, 0.0f, -8.0f))};
+    for(const auto& mat_world : mat_worlds) {
+        u32 visible = clusters.cull(above, mat_world, ranges);
+        BENCH_CHECK(visible > 0);
+        BENCH_CHECK(visible < cluster_count);
+        BENCH_CHECK(cullIsConservative(mesh, ranges, above, mat_world, visible_triangles));
+        BENCH_CHECK(visible_triangles < mesh.indices_.size() / 3);
+    }
+
+    // 真上から全体を見るとすべてのクラスターが可視
+    Frustum top;
+    top.setPosition(float3(0.0f, 200.0f, -1.0f)).setLookAt(float3(0.0f, 0.0f, 0.0f));
+    top.update();
+    BENCH_CHECK(clusters.cull(top, matrix::identity(), ranges) == cluster_count);
+    BENCH_CHECK(ranges.size() == 1 && ranges[0].index_count_ == mesh.indices_.size());
+
+    // 下から見ると視錐台内でもすべて背面
+    Frustum below;
+    below.setPosition(float3(0.0f, -200.0f, -1.0f)).setLookAt(float3(0.0f, 0.0f, 0.0f));
+    below.update();
+    BENCH_CHECK(clusters.cull(below, matrix::identity(), ranges) == 0);
+    BENCH_CHECK(ranges.empty());
+
+    // 不均一スケールでは背面カリングしない
+    BENCH_CHECK(clusters.cull(below, matrix::scale(1.0f, 2.0f, 1.0f), ranges) == cluster_count);
+
+    // カメラの後方へ移動するとすべて視錐台外
+    BENCH_CHECK(clusters.cull(top, matrix::translate(0.0f, 400.0f, 0.0f), ranges) == 0);
+}
+
+//---------------------------------------------------------------------------
+//! 描画のカリングに使うメッシュごとの境界球は、そのメッシュのすべての三角形を含む
+//---------------------------------------------------------------------------
+BENCH_TEST(model_mesh_bounds_contain_triangles)
+{
+    for(const char* path : SAMPLE_MESHES) {
+        ResourceModel resource(path);
+        resource.waitForReadFinish();
+        if(!bench::check(resource.isActive(), "model_mesh_bounds_contain_triangles", path))
+            continue;
+
+        int         handle = resource;
+        const auto& bounds = resource.meshBounds();
+        BENCH_CHECK(bounds.size() == static_cast<size_t>(MV1GetMeshNum(handle)));
+
+        MV1SetupReferenceMesh(handle, -1, TRUE);
+        MV1_REF_POLYGONLIST ref = MV1GetReferenceMesh(handle, -1, TRUE);
+
+        u32 outside = 0;
+        for(int i = 0; i < ref.PolygonNum; ++i) {
+            const auto& polygon = ref.Polygons[i];
+            if(polygon.MeshIndex >= bounds.size()) {
+                ++outside;
+                continue;
+            }
+            const auto& bound  = bounds[polygon.MeshIndex];
+            float3      center = float3(bound.center_[0], bound.center_[1], bound.center_[2]);
+            for(u32 v = 0; v < 3; ++v) {
+                f32 distance = length(cast(ref.Vertexs[polygon.VIndex[v]].Position) - center).x;
+                if(distance > bound.radius_ * 1.001f + 1e-3f)
+                    ++outside;
+            }
+        }
+        MV1TerminateReferenceMesh(handle, -1, TRUE);
+
+        bench::check(outside == 0, std::string("model_mesh_bounds_contain_triangles ") + path, "vertex outside of mesh bounds");
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 三角形BVHの線分/球/カプセル判定がDxLibのMV1CollCheck_*と一致する
+//! @details BVHはComponentCollisionModelと同じくモデルキャッシュの三角形から構築します
+//---------------------------------------------------------------------------
+BENCH_TEST(bvh_matches_dxlib)
+{
+    constexpr u32 QUERY_COUNT = 1024;
+
+    std::mt19937 rng(12345);
+    for(const char* path : SAMPLE_MESHES) {
+        SampleMesh mesh;
+        if(!bench::check(loadSampleMesh(path, mesh), "bvh_matches_dxlib", path))
+            continue;
+
+        ModelCache cache(path);
+        if(!bench::check(useModelCacheTriangles(mesh, cache), "bvh_matches_dxlib cache", path))
+            continue;
+
+        physics::TriangleBVH bvh;
+        ComponentCollisionModel::BuildTriangleBVH(cache, matrix::identity(), bvh);
+        BENCH_CHECK(bvh.triangleCount() == mesh.centroids_.size());
+
+        float3 extent    = mesh.max_ - mesh.min_;
+        f32    size      = std::max(std::max(static_cast<f32>(extent.x), static_cast<f32>(extent.y)), static_cast<f32>(extent.z));
+        f32    tolerance = size * 1e-4f;
+        float3 margin    = float3(0.0f, size * 0.1f, 0.0f);
+
+        std::uniform_real_distribution<f32> radius(size * 0.005f, size * 0.02f);
+
+        u32 ray_mismatch     = 0;
+        u32 sphere_mismatch  = 0;
+        u32 capsule_mismatch = 0;
+        for(u32 q = 0; q < QUERY_COUNT; ++q) {
+            //---- 線分 (上方から下方へ、始点に最も近い交差点を比較)
+            float3 from = randomPoint(rng, mesh.min_, mesh.max_) + margin;
+            float3 to   = randomPoint(rng, mesh.min_, mesh.max_) - margin;
+
+            physics::TriangleBVH::RayHit hit;
+            bool                         bvh_hit = bvh.raycast(from, to, hit);
+            MV1_COLL_RESULT_POLY         line    = MV1CollCheck_Line(mesh.handle_, -1, cast(from), cast(to));
+            if(bvh_hit != (line.HitFlag != 0) ||
+               (bvh_hit && static_cast<f32>(length(hit.position_ - cast(line.HitPosition))) > tolerance))
+                ++ray_mismatch;
+
+            //---- 球
+            float3                         center = randomPoint(rng, mesh.min_, mesh.max_);
+            f32                            r      = radius(rng);
+            physics::TriangleBVH::Contacts contacts;
+            bvh.overlapSphere(center, r, contacts);
+            MV1_COLL_RESULT_POLY_DIM sphere = MV1CollCheck_Sphere(mesh.handle_, -1, cast(center), r);
+            if(!sameContacts(mesh, contacts, sphere, tolerance))
+                ++sphere_mismatch;
+            MV1CollResultPolyDimTerminate(sphere);
+
+            //---- カプセル
+            float3 p0 = randomPoint(rng, mesh.min_, mesh.max_);
+            float3 p1 = p0 + (randomPoint(rng, mesh.min_, mesh.max_) - p0) * 0.05f;
+            contacts.clear();
+            bvh.overlapCapsule(p0, p1, r, contacts);
+            MV1_COLL_RESULT_POLY_DIM capsule = MV1CollCheck_Capsule(mesh.handle_, -1, cast(p0), cast(p1), r);
+            if(!sameContacts(mesh, contacts, capsule, tolerance))
+                ++capsule_mismatch;
+            MV1CollResultPolyDimTerminate(capsule);
+        }
+
+        std::string name = std::string("bvh_matches_dxlib ") + path;
+        bench::check(ray_mismatch == 0, name, "raycast differs from MV1CollCheck_Line");
+        bench::check(sphere_mismatch == 0, name, "overlapSphere differs from MV1CollCheck_Sphere");
+        bench::check(capsule_mismatch == 0, name, "overlapCapsule differs from MV1CollCheck_Capsule");
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 個数がファイルサイズに収まらない壊れたキャッシュは、領域を確保する前に破棄する
+//---------------------------------------------------------------------------
+BENCH_TEST(modelcache_rejects_oversized_counts)
+{
+    for(auto codec : {ModelCache::Codec::Raw, ModelCache::Codec::Meshopt}) {
+        ModelCache cache("bench/corrupt.mv1");
+
+        std::error_code error_code;
+        std::filesystem::create_directories(std::filesystem::path(cache.cachePath()).parent_path(), error_code);
+        {
+            // ヘッダーのみで、頂点数だけが極端に大きいファイル
+            std::ofstream stream(cache.cachePath(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            u32           version      = ModelCache::VERSION;
+            u32           vertex_count = 0x7fffffffu;
+            u32           index_count  = 3;
+            u32           data_size[2] = {16, 16};
+            u8            padding[32]  = {};
+            stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            stream.write(reinterpret_cast<const char*>(&codec), sizeof(codec));
+            stream.write(reinterpret_cast<const char*>(&vertex_count), sizeof(vertex_count));
+            stream.write(reinterpret_cast<const char*>(&index_count), sizeof(index_count));
+            if(codec == ModelCache::Codec::Meshopt)
+                stream.write(reinterpret_cast<const char*>(data_size), sizeof(data_size));
+            stream.write(reinterpret_cast<const char*>(padding), sizeof(padding));
+        }
+
+        BENCH_CHECK(!cache.read());
+        BENCH_CHECK(cache.vertices().empty());
+        BENCH_CHECK(!cache.isExist());   // 壊れたキャッシュは削除される
+    }
+}
+
+//---------------------------------------------------------------------------
+//! モデルキャッシュとアニメーションクリップのキャッシュは cooked/ 以下に data/ と同じ階層で置く
+//---------------------------------------------------------------------------
+BENCH_TEST(modelcache_path_cooked_layout)
+{
+    BENCH_CHECK(ModelCache("data/Sample/oil_barrels_pbr/barrel.mv1").cachePath() == "cooked/Sample/oil_barrels_pbr/barrel.mv1.cache");
+    BENCH_CHECK(ModelCache("bench/corrupt.mv1").cachePath() == "cooked/bench/corrupt.mv1.cache");
+    BENCH_CHECK(mesh_cook::cookedPath("data/Sample/a.mv1", ".0.clip") == "cooked/Sample/a.mv1.0.clip");
+}
+
+//---------------------------------------------------------------------------
+//! ワイヤーフレームの辺はクラスターごとに1本だけ格納する
+//! (クラスター境界の辺は、片方のクラスターがカリングされても欠けないよう両方に格納する)
+//---------------------------------------------------------------------------
+BENCH_TEST(modelcache_edges_per_cluster)
+{
+    for(const char* path : SAMPLE_MESHES) {
+        ModelCache cache(path);
+
+        // キャッシュが無い(または古い)場合は作成する
+        if(!cache.read()) {
+            int mv1_handle = MV1LoadModel(path);
+            if(!bench::check(mv1_handle != -1, "modelcache_edges_per_cluster", path))
+                continue;
+            cache.save(mv1_handle);
+            MV1DeleteModel(mv1_handle);
+        }
+        if(!bench::check(cache.read(), "modelcache_edges_per_cluster", path))
+            continue;
+
+        // クラスターごとの三角形の範囲 (クラスターが無い場合はモデル全体)
+        const auto&                            indices = cache.indices();
+        std::vector<std::pair<size_t, size_t>> ranges;
+        if(cache.clusters().isValid()) {
+            for(const auto& cluster : cache.clusters().clusters())
+                ranges.emplace_back(cluster.index_offset_, cluster.index_offset_ + cluster.index_count_);
+        }
+        else {
+            ranges.emplace_back(0, indices.size());
+        }
+
+        // 範囲ごとに三角形の辺から重複を除いた本数の合計
+        size_t edge_count = 0;
+        for(const auto& [begin, end] : ranges) {
+            std::vector<u64> edges;
+            for(size_t i = begin; i + 2 < end; i += 3) {
+                for(u32 e = 0; e < 3; ++e) {
+                    u32 a = indices[i + e];
+                    u32 b = indices[i + (e + 1) % 3];
+                    edges.push_back(a < b ? (static_cast<u64>(a) << 32) | b : (static_cast<u64>(b) << 32) | a);
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            edge_count += edges.size();
+        }
+
+        bench::check(cache.edgeIndexCount() == edge_count * 2,
+                     std::string("modelcache_edges_per_cluster ") + path,
+                     "edge missing from (or duplicated in) a cluster");
+    }
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャプールの共有とLRU順の解放 (参照中のテクスチャは解放しない)
+//---------------------------------------------------------------------------
+BENCH_TEST(texture_pool_lru_eviction)
+{
+    constexpr u64 TEXTURE_BYTES = 4ull * 1024 * 1024;
+
+    TexturePool pool([](const std::string&) { return std::make_shared<Texture>(); },
+                     [](const Texture&) { return TEXTURE_BYTES; },
+                     [](const Texture&) { return TexturePool::Status::Loaded; });
+    pool.setBudget(TEXTURE_BYTES * 3);   // 3枚分
+
+    {
+        auto a = pool.acquire("a");
+        BENCH_CHECK(a == pool.acquire("a"));   // 同じパスは共有
+    }
+    pool.acquire("b");
+    pool.acquire("c");
+    pool.acquire("a");   // aを最新に
+    pool.acquire("d");   // 最も古いbを解放
+    BENCH_CHECK(!pool.contains("b"));
+    BENCH_CHECK(pool.contains("a") && pool.contains("c") && pool.contains("d"));
+
+    auto keep = pool.acquire("c");   // 参照中
+    pool.setBudget(0);               // 未参照をすべて解放
+    BENCH_CHECK(pool.contains("c"));
+    BENCH_CHECK(!pool.contains("a") && !pool.contains("d"));
+
+    auto stats = pool.stats();
+    BENCH_CHECK(stats.hits_ == 3);
+    BENCH_CHECK(stats.misses_ == 4);
+    BENCH_CHECK(stats.evictions_ == 3);
+    BENCH_CHECK(stats.count_ == 1);
+    BENCH_CHECK(stats.referenced_ == 1);
+    BENCH_CHECK(stats.resident_bytes_ == TEXTURE_BYTES);
+}
+
+//---------------------------------------------------------------------------
+//! 非同期読み込みの完了でサイズを1度だけ確定し、失敗したテクスチャはプールから外す
+//---------------------------------------------------------------------------
+BENCH_TEST(texture_pool_async_results)
+{
+    constexpr u64 TEXTURE_BYTES = 1024;
+
+    // テクスチャごとの読み込み状況 (テストから変更する)
+    std::unordered_map<const Texture*, TexturePool::Status> status;
+    u32                                                     status_queries = 0;
+
+    TexturePool pool(
+        [&](const std::string&) {
+            auto texture          = std::make_shared<Texture>();
+            status[texture.get()] = TexturePool::Status::Loading;
+            return texture;
+        },
+        [](const Texture&) { return TEXTURE_BYTES; },
+        [&](const Texture& texture) {
+            status_queries++;
+            return status[&texture];
+        });
+
+    // 読み込み中はサイズ0
+    auto a = pool.acquire("a");
+    pool.update();
+    BENCH_CHECK(pool.stats().resident_bytes_ == 0);
+
+    // 完了後のupdate()でサイズを確定し、以降は問い合わせない
+    status[a.get()] = TexturePool::Status::Loaded;
+    pool.update();
+    BENCH_CHECK(pool.stats().resident_bytes_ == TEXTURE_BYTES);
+    u32 queries = status_queries;
+    pool.update();
+    pool.acquire("a");
+    BENCH_CHECK(status_queries == queries);
+
+    // 失敗したテクスチャはupdate()で外し、次の取得で読み込み直す
+    auto b          = pool.acquire("b");
+    status[b.get()] = TexturePool::Status::Failed;
+    pool.update();
+    BENCH_CHECK(!pool.contains("b"));
+    BENCH_CHECK(pool.stats().failures_ == 1);
+    BENCH_CHECK(pool.acquire("b") != b);
+
+    // update()の前に共有しようとした場合も読み込み直す
+    auto c          = pool.acquire("c");
+    status[c.get()] = TexturePool::Status::Failed;
+    BENCH_CHECK(pool.acquire("c") != c);
+    BENCH_CHECK(pool.stats().failures_ == 2);
+
+    auto stats = pool.stats();
+    BENCH_CHECK(stats.hits_ == 1);
+    BENCH_CHECK(stats.misses_ == 5);
+    BENCH_CHECK(stats.resident_bytes_ == TEXTURE_BYTES);
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み待ちで作成できたアニメーションも、読み込みが後から失敗すれば無効になる
+//---------------------------------------------------------------------------
+BENCH_TEST(animation_invalid_after_failed_load)
+{
+    Animation::Desc desc[] = {{"missing", "data/bench/missing_animation.mv1", 0, 1.0f}};
+    Animation       animation(desc, std::size(desc));
+
+    // 読み込みが終わるまで更新 (最大5秒)
+    auto& streaming = GetStreamingManager();
+    for(u32 i = 0; i < 5000 && !streaming.progress().isDone(); ++i) {
+        streaming.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BENCH_CHECK(streaming.progress().isDone());
+    BENCH_CHECK(!animation.isValid());
+}
+
+//---------------------------------------------------------------------------
+//! アニメーターの姿勢はクリップが無ければバインドポーズ、キーの時間ではDxLibのアタッチ再生と一致する
+//---------------------------------------------------------------------------
+BENCH_TEST(animator_matches_dxlib_pose)
+{
+    int model = MV1LoadModel("data/Game/Player/model.mv1");
+    int anim  = MV1LoadModel("data/Game/Player/Anim/Run.mv1");
+    if(bench::check(model != -1 && anim != -1, "animator_matches_dxlib_pose", "sample model not found")) {
+        // 平行移動の大きさに対する相対誤差
+        auto error = [](const matrix& actual, const matrix& expected) {
+            f32 a[16];
+            f32 e[16];
+            store(actual, a);
+            store(expected, e);
+
+            f32 result = 0.0f;
+            for(u32 i = 0; i < 16; ++i)
+                result = std::max(result, std::abs(a[i] - e[i]));
+            return result / std::max(1.0f, static_cast<f32>(length(TRS::fromMatrix(expected).translate_)));
+        };
+
+        auto skeleton = std::make_shared<const animation::Skeleton>(animation::Skeleton::fromModel(model));
+        auto clip     = std::make_shared<const animation::Clip>(animation::Clip::extract(model, anim, 0));
+        BENCH_CHECK(clip->jointCount() == skeleton->jointCount());
+        BENCH_CHECK(clip->frameCount() > 1);
+
+        //---- レイヤーが無い場合はバインドポーズ
+        animation::Animator animator(skeleton);
+        animator.evaluate();
+
+        f32 bind_error = 0.0f;
+        for(u32 joint = 0; joint < skeleton->jointCount(); ++joint) {
+            matrix expected = cast(MV1GetFrameBaseLocalMatrix(model, static_cast<int>(joint)));
+            bind_error      = std::max(bind_error, error(animator.localMatrices()[joint], expected));
+        }
+        BENCH_CHECK(bind_error < 1e-4f);
+
+        //---- キーの時間ではDxLibのアタッチ再生と一致
+        u32 key  = clip->frameCount() / 2;
+        f32 time = clip->duration() * static_cast<f32>(key) / static_cast<f32>(clip->frameCount() - 1);
+
+        auto& input  = animator.layer(0).inputs_.emplace_back();
+        input.clip_  = clip;
+        input.time_  = time;
+        input.speed_ = 0.0f;
+        animator.evaluate();
+
+        int attach_index = MV1AttachAnim(model, 0, anim, TRUE);
+        MV1SetAttachAnimTime(model, attach_index, time * animation::DXLIB_TIME_SCALE);
+
+        f32 pose_error = 0.0f;
+        for(u32 joint = 0; joint < skeleton->jointCount(); ++joint) {
+            matrix expected = cast(MV1GetAttachAnimFrameLocalMatrix(model, attach_index, static_cast<int>(joint)));
+            pose_error      = std::max(pose_error, error(animator.localMatrices()[joint], expected));
+        }
+        BENCH_CHECK(pose_error < 1e-4f);
+
+        MV1DetachAnim(model, attach_index);
+    }
+
+    if(model != -1)
+        MV1DeleteModel(model);
+    if(anim != -1)
+        MV1DeleteModel(anim);
+}
+
+namespace
+{
+
+//===========================================================================
+//! 描画順の確認用シーン
+//! @details モデルと、HpGaugeのように描画優先度を下げて後から描く表示を1つずつ配置します。
+//!          後から描く表示は、描画した時点で描画キューに残っているパケット数を記録します。
+//===========================================================================
+class SceneDrawOrder : public Scene::Base
+{
+public:
+    SceneDrawOrder(bool use_render_queue)
+        : use_render_queue_(use_render_queue)
+    {
+    }
+
+    std::string Name() override { return "Test_DrawOrder"; }
+
+    bool Init() override
+    {
+        model_ = Scene::CreateObject<Object>()->SetName("Model")->AddComponent<ComponentModel>("data/Game/Player/model.mv1");
+        model_->SetUseRenderQueue(use_render_queue_);
+
+        auto gauge = Scene::CreateObject<Object>()->SetName("Gauge");
+        gauge->SetProc(
+            "GaugeDraw",
+            [this]() {
+                pending_ = GetRenderQueue().size();
+                drawn_   = true;
+            },
+            ProcTiming::Draw,
+            Priority::LOWEST);
+        return true;
+    }
+
+    bool              use_render_queue_;   //!< モデルを描画キューで描画するかどうか
+    ComponentModelPtr model_;              //!< モデル
+    size_t            pending_ = 0;        //!< 後から描く表示の時点で描画キューに残っていたパケット数
+    bool              drawn_   = false;    //!< 後から描く表示が描画されたかどうか
+};
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! Priority::IFPOSSIBLE の予算は呼び出し順の後ろのモデルにも巡回して割り当てる
+//---------------------------------------------------------------------------
+BENCH_TEST(animation_lod_ifpossible_rotates)
+{
+    constexpr u32 MODEL_COUNT = 7;
+    constexpr u32 BUDGET      = 2;
+    constexpr u32 FRAMES      = 70;
+    constexpr u32 MAX_GAP     = (MODEL_COUNT + BUDGET - 1) / BUDGET;   // 全モデルを1巡するフレーム数
+
+    AnimationLod lod;
+    lod.settings().ifpossible_budget_ = BUDGET;
+
+    u32 sampled_frames[MODEL_COUNT] = {};
+    u32 last_sampled[MODEL_COUNT]   = {};
+    u32 counts[MODEL_COUNT]         = {};
+    u32 max_gap                     = 0;
+    for(u32 frame = 0; frame < FRAMES; ++frame) {
+        lod.beginFrame(Frustum());
+
+        for(u32 i = 0; i < MODEL_COUNT; ++i) {
+            if(!lod.shouldSample(AnimationLod::Level::Full, i, sampled_frames[i], Priority::IFPOSSIBLE))
+                continue;
+
+            // 最初の巡回が終わった後の更新間隔
+            if(counts[i]++ > 0)
+                max_gap = std::max(max_gap, frame - last_sampled[i]);
+            last_sampled[i] = frame;
+        }
+        BENCH_CHECK(lod.stats().sampled_ <= BUDGET);
+    }
+
+    // 全モデルが1巡するフレーム数に1回以上更新される (7体で予算2なら4フレームに1回以上)
+    for(u32 count : counts)
+        BENCH_CHECK(count >= FRAMES / MAX_GAP - 1);
+    BENCH_CHECK(max_gap <= MAX_GAP);
+}
+
+//---------------------------------------------------------------------------
+//! モデルは描画優先度の順にその場で描画され、後から描く表示より先に描画が終わっている。
+//! 描画キューを使うモデルだけがDraw処理の最後まで遅れ、キューはDraw処理の中で空になる
+//---------------------------------------------------------------------------
+BENCH_TEST(model_draw_follows_priority)
+{
+    auto* runner = bench::HeadlessRunner::current();
+    if(!bench::check(runner != nullptr, "model_draw_follows_priority", "headless runner is not initialized"))
+        return;
+
+    for(bool use_render_queue : {false, true}) {
+        auto scene = std::make_shared<SceneDrawOrder>(use_render_queue);
+        runner->changeScene(scene);
+        runner->step(1.0f / 60.0f);
+
+        // 読み込み中は代わりのモデルキャッシュをその場で描画するため、読み込み完了を待つ
+        for(u32 retry = 0; retry < 1000 && scene->model_ && !scene->model_->GetModelClass()->isActive(); ++retry) {
+            WaitHandleASyncLoadAll();
+            runner->step(0.0f);
+        }
+        BENCH_CHECK(scene->model_ && scene->model_->GetModelClass()->isActive());
+
+        runner->draw();
+        BENCH_CHECK(scene->drawn_);
+        BENCH_CHECK(use_render_queue ? scene->pending_ > 0 : scene->pending_ == 0);
+        BENCH_CHECK(GetRenderQueue().size() == 0);
+
+        runner->changeScene(nullptr);
+        runner->step(0.0f);
+    }
+}
+
+namespace
+{
+
+//===========================================================================
+//! 先行読み込みの確認用シーン
+//! @details カメラと、切り替え前のシーンと同じ名前のオブジェクトを作成します。
+//!          Preload()ではモデルを1つ先行読み込みします。
+//===========================================================================
+class ScenePreloadTarget : public Scene::Base
+{
+public:
+    std::string Name() override { return "Test_PreloadTarget"; }
+
+    void Preload() override { PreloadModel("data/Game/Player/model.mv1"); }
+
+    bool Init() override
+    {
+        init_count_++;
+
+        camera_ = Scene::CreateObject<Object>()->SetName("Camera")->AddComponent<ComponentCamera>();
+        Scene::CreateObject<Object>()->SetName("Player");
+        Scene::CreateObject<Object>()->SetName("Enemy");
+        return true;
+    }
+
+    void Exit() override { exit_count_++; }
+
+    ComponentCameraWeakPtr camera_;           //!< このシーンのカメラ
+    u32                    init_count_ = 0;   //!< Init()の呼び出し回数
+    u32                    exit_count_ = 0;   //!< Exit()の呼び出し回数
+};
+
+//===========================================================================
+//! 先行読み込み中に動いている側のシーン (同じ名前のオブジェクトとカレントカメラ)
+//===========================================================================
+class ScenePreloadSource : public Scene::Base
+{
+public:
+    std::string Name() override { return "Test_PreloadSource"; }
+
+    bool Init() override
+    {
+        camera_ = Scene::CreateObject<Object>()->SetName("Camera")->AddComponent<ComponentCamera>()->SetCurrentCamera();
+        Scene::CreateObject<Object>()->SetName("Player");
+        return true;
+    }
+
+    ComponentCameraWeakPtr camera_;   //!< このシーンのカメラ
+};
+
+//! 先行読み込み中のシーンのオブジェクト名 (作成されていなければ空)
+std::string preloadObjectName(ScenePreloadTarget& scene, std::string_view name)
+{
+    auto obj = scene.GetObjectPtr<Object>(name);
+    return obj ? std::string(obj->GetName()) : std::string();
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! オブジェクトを先行して作成しても、現在のシーンの名前とカレントカメラは変わらない。
+//! 取り消すと作成したオブジェクトは破棄され、再度の先行読み込みと切り替えでは同じ名前で作成し直される。
+//! 切り替え後は先行して作成したカメラがカレントカメラになる
+//---------------------------------------------------------------------------
+BENCH_TEST(scene_preload_cancel_and_switch)
+{
+    auto* runner = bench::HeadlessRunner::current();
+    if(!bench::check(runner != nullptr, "scene_preload_cancel_and_switch", "headless runner is not initialized"))
+        return;
+
+    auto source = std::make_shared<ScenePreloadSource>();
+    auto target = std::make_shared<ScenePreloadTarget>();
+    runner->changeScene(source);
+    runner->step(1.0f / 60.0f);
+    runner->step(1.0f / 60.0f);
+    BENCH_CHECK(Scene::GetCurrentScene() == source.get());
+    BENCH_CHECK(!source->camera_.expired() && Scene::GetCurrentCamera().lock() == source->camera_.lock());
+
+    //---- オブジェクトも先行して作成
+    Scene::Preload(target, true);
+    runner->step(1.0f / 60.0f);
+    BENCH_CHECK(Scene::GetPreloadScene() == target.get());
+    BENCH_CHECK(target->init_count_ == 1);
+    BENCH_CHECK(preloadObjectName(*target, "Camera") == "Camera");
+    BENCH_CHECK(preloadObjectName(*target, "Player") == "Player");
+    BENCH_CHECK(preloadObjectName(*target, "Enemy") == "Enemy");
+    BENCH_CHECK(Scene::GetCurrentCamera().lock() == source->camera_.lock());
+    BENCH_CHECK(Scene::GetObjectPtr<Object>("Enemy") == nullptr);
+
+    // 現在のシーンで作成するオブジェクトは先行読み込み中のシーンの名前と重ならない
+    auto extra = Scene::CreateObject<Object>()->SetName("Enemy");
+    BENCH_CHECK(extra->GetName() == "Enemy");
+    Scene::ReleaseObject(extra);
+    extra = nullptr;
+
+    //---- 取り消し
+    Scene::CancelPreload();
+    BENCH_CHECK(Scene::GetPreloadScene() == nullptr);
+    BENCH_CHECK(target->exit_count_ == 1);
+    BENCH_CHECK(target->camera_.expired());
+    BENCH_CHECK(preloadObjectName(*target, "Player").empty());
+    BENCH_CHECK(Scene::GetCurrentCamera().lock() == source->camera_.lock());
+    auto player = Scene::GetObjectPtr<Object>("Player");
+    BENCH_CHECK(player && player->GetName() == "Player");
+    player = nullptr;
+
+    //---- 再度先行読み込みして切り替え (モデルの読み込み完了まで待ってから切り替わる)
+    Scene::Preload(target, true);
+    BENCH_CHECK(target->init_count_ == 2);
+    BENCH_CHECK(preloadObjectName(*target, "Camera") == "Camera");
+    BENCH_CHECK(preloadObjectName(*target, "Player") == "Player");
+    BENCH_CHECK(preloadObjectName(*target, "Enemy") == "Enemy");
+
+    Scene::Change(target);
+    for(u32 retry = 0; retry < 1000 && Scene::GetCurrentScene() != target.get(); ++retry) {
+        WaitHandleASyncLoadAll();
+        runner->step(1.0f / 60.0f);
+    }
+    runner->step(1.0f / 60.0f);
+
+    BENCH_CHECK(Scene::GetCurrentScene() == target.get());
+    BENCH_CHECK(Scene::GetPreloadScene() == nullptr);
+    BENCH_CHECK(target->init_count_ == 2);   // 先行して作成したオブジェクトをそのまま使う
+    BENCH_CHECK(source->camera_.expired());
+    for(const char* name : {"Camera", "Player", "Enemy"}) {
+        auto obj = Scene::GetObjectPtr<Object>(name);
+        BENCH_CHECK(obj && obj->GetName() == name);
+    }
+    BENCH_CHECK(!target->camera_.expired() && Scene::GetCurrentCamera().lock() == target->camera_.lock());
+
+    runner->changeScene(nullptr);
+    runner->step(0.0f);
+}
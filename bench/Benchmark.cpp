@@ -0,0 +1,257 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Benchmark.cpp
+//! @brief  ベンチマーク (シナリオ登録・計測・JSON出力)
+//---------------------------------------------------------------------------
+#include "Benchmark.h"
+#include "HeadlessRunner.h"
+
+#include <System/Scene.h>
+#include <System/Profiler.h>
+
+#include <chrono>
+#include <ctime>
+#include <unordered_map>
+
+namespace bench
+{
+namespace
+{
+
+std::vector<Scenario> scenario_list;   //!< 登録済みシナリオ
+
+//===========================================================================
+//! シナリオ実行用シーン
+//===========================================================================
+class SceneBench : public Scene::Base
+{
+public:
+    SceneBench(const Scenario& scenario, u32 seed)
+        : scenario_(scenario)
+        , rng_(seed)
+    {
+    }
+
+    std::string Name() override { return "Bench_" + scenario_.name_; }
+
+    bool Init() override
+    {
+        if(scenario_.init_)
+            scenario_.init_(rng_);
+        return true;
+    }
+
+    void Update([[maybe_unused]] float delta) override
+    {
+        if(scenario_.update_)
+            scenario_.update_(rng_, frame_);
+        ++frame_;
+    }
+
+    void Exit() override
+    {
+        if(scenario_.exit_)
+            scenario_.exit_();
+    }
+
+private:
+    const Scenario& scenario_;    //!< シナリオ
+    std::mt19937    rng_;         //!< シナリオ専用の乱数 (シード固定)
+    u32             frame_ = 0;   //!< フレーム番号
+};
+
+//---------------------------------------------------------------------------
+//! 経過時間を計測 (単位:ms)
+//---------------------------------------------------------------------------
+template <class Func>
+f64 measure(Func func)
+{
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<f64, std::milli>(end - begin).count();
+}
+
+//---------------------------------------------------------------------------
+//! JSON文字列のエスケープ出力
+//---------------------------------------------------------------------------
+void writeJsonString(std::ofstream& file, std::string_view str)
+{
+    file << '"';
+    for(char c : str) {
+        if(c == '"' || c == '\\')
+            file << '\\' << c;
+        else if(static_cast<u8>(c) < 0x20)
+            file << ' ';
+        else
+            file << c;
+    }
+    file << '"';
+}
+
+//---------------------------------------------------------------------------
+//! ビルド構成名
+//---------------------------------------------------------------------------
+const char* buildConfigName()
+{
+#if defined(_DEBUG)
+    return "Debug";
+#elif defined(LTCG)
+    return "ReleaseLTCG";
+#else
+    return "Release";
+#endif
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! シナリオを登録
+//---------------------------------------------------------------------------
+void registerScenario(Scenario scenario)
+{
+    scenario_list.emplace_back(std::move(scenario));
+}
+
+//---------------------------------------------------------------------------
+//! 登録済みのシナリオ一覧を取得
+//---------------------------------------------------------------------------
+const std::vector<Scenario>& scenarios()
+{
+    return scenario_list;
+}
+
+//---------------------------------------------------------------------------
+//! シナリオを実行して計測
+//---------------------------------------------------------------------------
+Result run(HeadlessRunner& runner, const Scenario& scenario, const Config& config)
+{
+    Result result;
+    result.name_   = scenario.name_;
+    result.frames_ = config.frames_;
+
+#if defined(USE_PROFILER)
+    // 区間計測は計測時間に影響するため必要な場合のみ有効にする
+    profiler::setPause(!config.zones_);
+#endif
+
+    //----------------------------------------------------------
+    // 初期化 (シーンInitとオブジェクトの本登録まで)
+    //----------------------------------------------------------
+    runner.changeScene(std::make_shared<SceneBench>(scenario, config.seed_));
+    result.setup_ms_ = measure([&]() { runner.step(config.delta_); });
+
+    for(u32 i = 0; i < config.warmup_; ++i)
+        runner.step(config.delta_);
+
+    //----------------------------------------------------------
+    // 計測
+    //----------------------------------------------------------
+    struct ZoneSum
+    {
+        u64 total_ = 0;
+        u64 calls_ = 0;
+    };
+    std::unordered_map<std::string_view, ZoneSum> zone_sums;
+
+    std::vector<f64> times(config.frames_);
+    for(u32 i = 0; i < config.frames_; ++i) {
+        times[i] = measure([&]() { runner.step(config.delta_); });
+
+#if defined(USE_PROFILER)
+        if(config.zones_ && profiler::frameCount() > 0) {
+            for(auto& zone : profiler::frameZones(0)) {
+                auto& sum = zone_sums[zone.name_];
+                sum.total_ += zone.end_ - zone.begin_;
+                sum.calls_++;
+            }
+        }
+#endif
+    }
+
+    if(auto* scene = Scene::GetCurrentScene())
+        result.objects_ = static_cast<u32>(scene->GetObjectPtrVec().size());
+
+    // シナリオ終了
+    runner.changeScene(nullptr);
+    runner.step(0.0f);
+
+#if defined(USE_PROFILER)
+    profiler::setPause(false);
+#endif
+
+    //----------------------------------------------------------
+    // 集計
+    //----------------------------------------------------------
+    if(!times.empty()) {
+        f64 total = 0.0;
+        for(auto t : times)
+            total += t;
+        result.mean_ms_ = total / static_cast<f64>(times.size());
+
+        std::sort(times.begin(), times.end());
+        result.min_ms_    = times.front();
+        result.max_ms_    = times.back();
+        result.median_ms_ = times[times.size() / 2];
+        result.p95_ms_    = times[std::min(times.size() - 1, times.size() * 95 / 100)];
+    }
+
+    for(auto& [name, sum] : zone_sums) {
+        f64 frames = static_cast<f64>(std::max(config.frames_, 1u));
+        result.zones_.push_back(
+            {std::string(name), static_cast<f64>(sum.total_) / 1000000.0 / frames, static_cast<f64>(sum.calls_) / frames});
+    }
+    std::sort(result.zones_.begin(), result.zones_.end(), [](const ZoneResult& a, const ZoneResult& b) {
+        return a.mean_ms_ > b.mean_ms_;
+    });
+
+    return result;
+}
+
+//---------------------------------------------------------------------------
+//! 計測結果をJSONで出力
+//---------------------------------------------------------------------------
+bool writeJson(std::string_view path, const Config& config, const std::vector<Result>& results)
+{
+    std::ofstream file(std::string(path), std::ios::out | std::ios::trunc);
+    if(!file)
+        return false;
+
+    file << "{\n";
+    file << "  \"version\": 1,\n";
+    file << "  \"timestamp\": " << static_cast<u64>(std::time(nullptr)) << ",\n";
+    file << "  \"build\": \"" << buildConfigName() << "\",\n";
+    file << "  \"config\": { \"frames\": " << config.frames_ << ", \"warmup\": " << config.warmup_
+         << ", \"delta\": " << config.delta_ << ", \"seed\": " << config.seed_ << " },\n";
+    file << "  \"results\": [";
+
+    for(size_t i = 0; i < results.size(); ++i) {
+        auto& r = results[i];
+
+        file << (i ? ",\n" : "\n") << "    {\n";
+        file << "      \"name\": ";
+        writeJsonString(file, r.name_);
+        file << ",\n";
+        file << "      \"frames\": " << r.frames_ << ",\n";
+        file << "      \"objects\": " << r.objects_ << ",\n";
+        file << "      \"setup_ms\": " << r.setup_ms_ << ",\n";
+        file << "      \"mean_ms\": " << r.mean_ms_ << ",\n";
+        file << "      \"median_ms\": " << r.median_ms_ << ",\n";
+        file << "      \"p95_ms\": " << r.p95_ms_ << ",\n";
+        file << "      \"min_ms\": " << r.min_ms_ << ",\n";
+        file << "      \"max_ms\": " << r.max_ms_ << ",\n";
+        file << "      \"zones\": [";
+        for(size_t z = 0; z < r.zones_.size(); ++z) {
+            auto& zone = r.zones_[z];
+            file << (z ? ",\n" : "\n") << "        { \"name\": ";
+            writeJsonString(file, zone.name_);
+            file << ", \"mean_ms\": " << zone.mean_ms_ << ", \"calls\": " << zone.calls_ << " }";
+        }
+        file << (r.zones_.empty() ? "]\n" : "\n      ]\n");
+        file << "    }";
+    }
+    file << "\n  ]\n}\n";
+
+    return file.good();
+}
+
+}   // namespace bench
@@ -0,0 +1,107 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Benchmark.h
+//! @brief  ベンチマーク (シナリオ登録・計測・JSON出力)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench
+{
+
+class HeadlessRunner;
+
+//--------------------------------------------------------------
+//! 実行設定
+//--------------------------------------------------------------
+struct Config
+{
+    u32         frames_  = 600;                 //!< 計測フレーム数
+    u32         warmup_  = 60;                  //!< 計測前の空回しフレーム数
+    f32         delta_   = 1.0f / 60.0f;        //!< 固定⊿t (単位:秒)
+    u32         seed_    = 12345;               //!< 乱数シード
+    bool        zones_   = false;               //!< プロファイラーの区間集計を出力する
+    std::string filter_;                        //!< 実行するシナリオ名の部分一致フィルター
+    std::string output_  = "benchmark.json";    //!< 出力ファイルパス
+};
+
+//--------------------------------------------------------------
+//! シナリオ
+//! @details init_ はシーン初期化時、update_ は毎フレームのシーン更新時に呼ばれます
+//--------------------------------------------------------------
+struct Scenario
+{
+    std::string                                 name_;      //!< シナリオ名
+    std::string                                 desc_;      //!< 説明
+    std::function<void(std::mt19937& rng)>      init_;      //!< 初期化 (オブジェクト生成)
+    std::function<void(std::mt19937& rng, u32)> update_;    //!< 毎フレーム処理 (第2引数はフレーム番号)
+    std::function<void()>                       exit_;      //!< 終了 (シナリオが保持するリソースの解放)
+};
+
+//--------------------------------------------------------------
+//! 区間集計 (1フレームあたり)
+//--------------------------------------------------------------
+struct ZoneResult
+{
+    std::string name_;      //!< 区間名
+    f64         mean_ms_;   //!< 平均時間 (単位:ms)
+    f64         calls_;     //!< 平均呼び出し回数
+};
+
+//--------------------------------------------------------------
+//! 計測結果
+//--------------------------------------------------------------
+struct Result
+{
+    std::string             name_;              //!< シナリオ名
+    u32                     frames_    = 0;     //!< 計測フレーム数
+    u32                     objects_   = 0;     //!< 計測終了時のオブジェクト数
+    f64                     setup_ms_  = 0.0;   //!< 初期化時間 (単位:ms)
+    f64                     mean_ms_   = 0.0;   //!< 平均フレーム時間 (単位:ms)
+    f64                     median_ms_ = 0.0;   //!< 中央値 (単位:ms)
+    f64                     p95_ms_    = 0.0;   //!< 95パーセンタイル (単位:ms)
+    f64                     min_ms_    = 0.0;   //!< 最小 (単位:ms)
+    f64                     max_ms_    = 0.0;   //!< 最大 (単位:ms)
+    std::vector<ZoneResult> zones_;             //!< 区間集計 (Config::zones_ 有効時)
+};
+
+//--------------------------------------------------------------
+//! @name   シナリオ登録
+//--------------------------------------------------------------
+//@{
+
+// シナリオを登録
+void registerScenario(Scenario scenario);
+
+// 登録済みのシナリオ一覧を取得
+const std::vector<Scenario>& scenarios();
+
+// 標準シナリオを登録
+//! @details オブジェクト/コンポーネント数、衝突判定、物理、生成/破棄の各負荷シナリオ
+void registerBuiltinScenarios();
+
+//@}
+//--------------------------------------------------------------
+//! @name   実行
+//--------------------------------------------------------------
+//@{
+
+// シナリオを実行して計測
+//! @param  [in]    runner      ヘッドレス実行環境
+//! @param  [in]    scenario    シナリオ
+//! @param  [in]    config      実行設定
+Result run(HeadlessRunner& runner, const Scenario& scenario, const Config& config);
+
+// 計測結果をJSONで出力
+//! @param  [in]    path        出力ファイルパス
+//! @param  [in]    config      実行設定
+//! @param  [in]    results     計測結果
+bool writeJson(std::string_view path, const Config& config, const std::vector<Result>& results);
+
+//@}
+
+}   // namespace bench
@@ -0,0 +1,97 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Check.cpp
+//! @brief  検証とテスト (失敗を記録して終了コードへ反映)
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <atomic>
+#include <cstdio>
+
+namespace bench
+{
+namespace
+{
+
+std::atomic<u32> failed_checks = 0;   //!< 失敗した検証の数
+std::string      current_test;        //!< 実行中のテスト名
+
+//! 登録済みテスト (静的初期化の順序に依存しないよう関数内で生成)
+std::vector<Test>& testList()
+{
+    static std::vector<Test> list;
+    return list;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 検証結果を記録
+//---------------------------------------------------------------------------
+bool check(bool ok, std::string_view name, std::string_view message)
+{
+    if(ok)
+        return true;
+
+    failed_checks++;
+
+    std::fprintf(stderr,
+                 "FAILED %s%s%.*s%s%.*s\n",
+                 current_test.c_str(),
+                 current_test.empty() ? "" : ": ",
+                 static_cast<int>(name.size()),
+                 name.data(),
+                 message.empty() ? "" : " ",
+                 static_cast<int>(message.size()),
+                 message.data());
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//! 失敗した検証の数を取得
+//---------------------------------------------------------------------------
+u32 failedChecks()
+{
+    return failed_checks;
+}
+
+//---------------------------------------------------------------------------
+//! テストを登録
+//---------------------------------------------------------------------------
+bool registerTest(Test test)
+{
+    testList().emplace_back(std::move(test));
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 登録済みのテスト一覧を取得
+//---------------------------------------------------------------------------
+const std::vector<Test>& tests()
+{
+    return testList();
+}
+
+//---------------------------------------------------------------------------
+//! テストを実行
+//---------------------------------------------------------------------------
+u32 runTests(std::string_view filter)
+{
+    u32 failed_tests = 0;
+    for(auto& test : testList()) {
+        if(!filter.empty() && test.name_.find(filter) == std::string::npos)
+            continue;
+
+        u32 before   = failed_checks;
+        current_test = test.name_;
+        test.func_();
+        current_test.clear();
+
+        bool ok = failed_checks == before;
+        std::printf("%-32s %s\n", test.name_.c_str(), ok ? "ok" : "FAILED");
+        if(!ok)
+            failed_tests++;
+    }
+    return failed_tests;
+}
+
+}   // namespace bench
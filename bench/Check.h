@@ -0,0 +1,78 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Check.h
+//! @brief  検証とテスト (失敗を記録して終了コードへ反映)
+//! @details DxLib/Windowsに依存しないため、Linuxのテスト実行ファイル(Test)とベンチマークで共有します。
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench
+{
+
+//--------------------------------------------------------------
+//! テスト
+//--------------------------------------------------------------
+struct Test
+{
+    std::string           name_;   //!< テスト名
+    std::function<void()> func_;   //!< テスト本体 (check()で検証する)
+};
+
+//--------------------------------------------------------------
+//! @name   検証
+//--------------------------------------------------------------
+//@{
+
+// 検証結果を記録
+//! @param  [in]    ok          検証結果
+//! @param  [in]    name        検証名 (シナリオ名や式)
+//! @param  [in]    message     失敗時に表示する補足
+//! @return okをそのまま返します
+bool check(bool ok, std::string_view name, std::string_view message = {});
+
+// 失敗した検証の数を取得
+u32 failedChecks();
+
+//@}
+//--------------------------------------------------------------
+//! @name   テスト登録・実行
+//--------------------------------------------------------------
+//@{
+
+// テストを登録
+//! @return 静的変数の初期化で登録できるように常にtrueを返します
+bool registerTest(Test test);
+
+// 登録済みのテスト一覧を取得
+const std::vector<Test>& tests();
+
+// テストを実行
+//! @param  [in]    filter  実行するテスト名の部分一致フィルター (空なら全て)
+//! @return 失敗したテストの数
+u32 runTests(std::string_view filter = {});
+
+//@}
+
+}   // namespace bench
+
+//! テストを定義して登録
+//! @code
+//!     BENCH_TEST(vecmath_trs)
+//!     {
+//!         BENCH_CHECK(length(v) == 1.0f);
+//!     }
+//! @endcode
+#define BENCH_TEST(NAME)                                                                                               \
+    static void       NAME##_test();                                                                                   \
+    static const bool NAME##_registered = bench::registerTest({#NAME, &NAME##_test});                                  \
+    static void       NAME##_test()
+
+//! 式を検証 (失敗時は式とファイル名・行番号を表示)
+#define BENCH_CHECK(EXPR) bench::check(static_cast<bool>(EXPR), #EXPR, __FILE__ ":" BENCH_STRINGIZE(__LINE__))
+
+#define BENCH_STRINGIZE(X)  BENCH_STRINGIZE_(X)
+#define BENCH_STRINGIZE_(X) #X
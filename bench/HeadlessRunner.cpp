@@ -0,0 +1,134 @@
+﻿//---------------------------------------------------------------------------
+//! @file   HeadlessRunner.cpp
+//! @brief  ヘッドレス実行環境 (ウィンドウ/描画なしのフレーム駆動)
+//---------------------------------------------------------------------------
+#include "HeadlessRunner.h"
+
+#include <System/Profiler.h>
+
+namespace bench
+{
+namespace
+{
+
+HeadlessRunner* current_runner = nullptr;   //!< 初期化済みの実行環境
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+HeadlessRunner::~HeadlessRunner()
+{
+    finalize();
+}
+
+//---------------------------------------------------------------------------
+//! 初期化
+//---------------------------------------------------------------------------
+bool HeadlessRunner::initialize()
+{
+    SetOutApplicationLogValidFlag(FALSE);
+
+    // ウィンドウ・描画・サウンドを使用しない(DxLib_Init関数前)
+    SetNotWinFlag(TRUE);
+    SetNotDrawFlag(TRUE);
+    SetNotSoundFlag(TRUE);
+
+    if(DxLib_Init() == -1)
+        return false;
+    dxlib_initialized_ = true;
+
+    // 乱数を固定して決定的に実行する
+    srand(0);
+    SRand(0);
+
+    //----------------------------------------------------------
+    // 物理シミュレーションを初期化
+    //----------------------------------------------------------
+    physics_ = physics::createPhysics();
+    if(!physics_ || !physics_->isValid())
+        return false;
+
+    frame_index_   = 0;
+    current_runner = this;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 解放
+//---------------------------------------------------------------------------
+void HeadlessRunner::finalize()
+{
+    if(!dxlib_initialized_)
+        return;
+
+    // 現在のシーンを終了
+    if(Scene::GetCurrentScene()) {
+        changeScene(nullptr);
+        step(0.0f);
+    }
+
+    physics_.reset();
+    current_runner = nullptr;
+
+    DxLib_End();
+    dxlib_initialized_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! シーンを変更
+//---------------------------------------------------------------------------
+void HeadlessRunner::changeScene(Scene::BasePtr scene)
+{
+    Scene::Change(scene);
+}
+
+//---------------------------------------------------------------------------
+//! 1フレーム進める
+//---------------------------------------------------------------------------
+void HeadlessRunner::step(f32 dt)
+{
+#if defined(USE_PROFILER)
+    profiler::beginFrame();
+#endif
+
+    Scene::PreUpdate();
+    Scene::Update(dt);
+    Scene::PrePhysics();
+    if(dt > 0.0f) {
+        PROFILE_SCOPE("Physics");
+        physics_->update(dt);
+    }
+    Scene::PostUpdate();
+
+    // アセットのストリーミング
+    GetStreamingManager().update();
+
+    // 描画フェーズは実行せず、オブジェクトの解放処理のみ行う
+    Scene::Cleanup();
+
+#if defined(USE_PROFILER)
+    profiler::endFrame();
+#endif
+
+    ++frame_index_;
+}
+
+//---------------------------------------------------------------------------
+//! 描画フェーズを実行
+//---------------------------------------------------------------------------
+void HeadlessRunner::draw()
+{
+    Scene::Draw();
+}
+
+//---------------------------------------------------------------------------
+//! 初期化済みの実行環境を取得
+//---------------------------------------------------------------------------
+HeadlessRunner* HeadlessRunner::current()
+{
+    return current_runner;
+}
+
+}   // namespace bench
@@ -0,0 +1,66 @@
+﻿//---------------------------------------------------------------------------
+//! @file   HeadlessRunner.h
+//! @brief  ヘッドレス実行環境 (ウィンドウ/描画なしのフレーム駆動)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <System/Scene.h>
+#include <System/Physics/PhysicsEngine.h>
+
+namespace bench
+{
+
+//===========================================================================
+//! ヘッドレス実行環境
+//! @details DxLibをウィンドウ・描画・サウンド無効で初期化し、
+//!          シーンを固定⊿tで決定的に1フレームずつ進めます。
+//!          描画系の関数はDxLib内部で無効化されるため、描画フェーズは実行しません。
+//!          描画順を確認するテストでは draw() で描画フェーズのみ実行できます。
+//===========================================================================
+class HeadlessRunner
+{
+public:
+    // コンストラクタ
+    HeadlessRunner() = default;
+
+    // デストラクタ
+    ~HeadlessRunner();
+
+    // 初期化
+    //! @retval true    成功
+    //! @retval false   DxLibまたは物理シミュレーションの初期化に失敗
+    bool initialize();
+
+    // 解放
+    void finalize();
+
+    // シーンを変更
+    //! @param  [in]    scene   次のシーン (nullptrで現在のシーンを終了)
+    //! @note 次の step() で切り替わります
+    void changeScene(Scene::BasePtr scene);
+
+    // 1フレーム進める
+    //! @param  [in]    dt  経過時間⊿t (固定値を渡すことで決定的に実行できます)
+    void step(f32 dt);
+
+    // 描画フェーズを実行 (DxLibの描画は無効のため、描画順の確認に使用します)
+    void draw();
+
+    // 初期化済みの実行環境を取得 (テストからシーンを動かす場合に使用)
+    //! @return 実行環境 (初期化されていない場合はnullptr)
+    static HeadlessRunner* current();
+
+    // 実行したフレーム数を取得
+    u64 frameIndex() const { return frame_index_; }
+
+private:
+    HeadlessRunner(const HeadlessRunner&)            = delete;
+    HeadlessRunner& operator=(const HeadlessRunner&) = delete;
+
+private:
+    std::unique_ptr<physics::Engine> physics_;                    //!< 物理シミュレーション
+    bool                             dxlib_initialized_ = false;  //!< DxLib初期化済み
+    u64                              frame_index_       = 0;      //!< 実行フレーム数
+};
+
+}   // namespace bench
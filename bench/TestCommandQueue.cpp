@@ -0,0 +1,118 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestCommandQueue.cpp
+//! @brief  コマンドキューのテスト
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/CommandQueue.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+namespace
+{
+
+//! テスト用コマンド
+struct TestCommand
+{
+    u32                  producer_ = 0;   //!< 追加したスレッド番号
+    u32                  sequence_ = 0;   //!< スレッド内の追加順
+    std::shared_ptr<int> payload_;        //!< 破棄の確認用
+};
+
+//! ノード再利用の確認用コマンド (フリーリストは型ごとのため、他のテストと分ける)
+struct ReuseCommand
+{
+    u32 value_ = 0;
+};
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 複数スレッドから追加したコマンドを、処理と並行して漏れなくスレッドごとの追加順で受け取る
+//---------------------------------------------------------------------------
+BENCH_TEST(command_queue_multi_producer)
+{
+    constexpr u32 PRODUCERS = 4;
+    constexpr u32 COUNT     = 20000;
+
+    CommandQueue<TestCommand> queue;
+    std::atomic<u32>          started = 0;
+
+    std::vector<std::thread> producers;
+    for(u32 p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, &started, p]() {
+            started.fetch_add(1);
+            while(started.load() < PRODUCERS) {
+            }
+            for(u32 i = 0; i < COUNT; ++i) {
+                auto* command      = queue.Allocate();
+                command->producer_ = p;
+                command->sequence_ = i;
+                queue.Push(command);
+            }
+        });
+    }
+
+    // 追加と並行して処理する
+    std::vector<u32> next(PRODUCERS, 0);
+    u32              received = 0;
+    bool             ordered  = true;
+    while(received < PRODUCERS * COUNT) {
+        received += static_cast<u32>(queue.Drain([&](TestCommand& command) {
+            ordered = ordered && command.producer_ < PRODUCERS && command.sequence_ == next[command.producer_];
+            ++next[command.producer_ % PRODUCERS];
+        }));
+    }
+    for(auto& thread : producers)
+        thread.join();
+
+    BENCH_CHECK(ordered);
+    BENCH_CHECK(received == PRODUCERS * COUNT);
+    BENCH_CHECK(queue.IsEmpty());
+    for(u32 p = 0; p < PRODUCERS; ++p)
+        BENCH_CHECK(next[p] == COUNT);
+}
+
+//---------------------------------------------------------------------------
+//! 処理済みのノードは再利用され、追加ごとにヒープ確保しない
+//---------------------------------------------------------------------------
+BENCH_TEST(command_queue_reuse_nodes)
+{
+    CommandQueue<ReuseCommand> queue;
+
+    // 1件ずつ追加と処理を繰り返すと、同じノードが使い回される
+    std::set<const ReuseCommand*> addresses;
+    for(u32 i = 0; i < 100; ++i) {
+        auto* command = queue.Allocate();
+        addresses.insert(command);
+        queue.Push(command);
+        queue.Drain([](ReuseCommand&) {});
+    }
+    BENCH_CHECK(addresses.size() == 1);
+}
+
+//---------------------------------------------------------------------------
+//! 処理後とキューの破棄時にコマンドのデストラクタが呼ばれる
+//---------------------------------------------------------------------------
+BENCH_TEST(command_queue_destroy_commands)
+{
+    auto payload = std::make_shared<int>(0);
+    {
+        CommandQueue<TestCommand> queue;
+
+        auto* drained     = queue.Allocate();
+        drained->payload_ = payload;
+        queue.Push(drained);
+        queue.Drain([](TestCommand&) {});
+        BENCH_CHECK(payload.use_count() == 1);
+
+        // 未処理のまま破棄
+        auto* pending     = queue.Allocate();
+        pending->payload_ = payload;
+        queue.Push(pending);
+        BENCH_CHECK(payload.use_count() == 2);
+    }
+    BENCH_CHECK(payload.use_count() == 1);
+}
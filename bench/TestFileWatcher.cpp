@@ -0,0 +1,195 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestFileWatcher.cpp
+//! @brief  ファイル変更監視のテスト (偽のバックエンドで変更のまとめ方を検証)
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/FileWatcher.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+
+namespace
+{
+
+using Action = FileWatcherBackend::Action;
+
+//! 偽のバックエンド
+//! @details push()したイベントを監視スレッドのwait()へ渡します
+class FakeBackend final : public FileWatcherBackend
+{
+public:
+    bool open(const std::filesystem::path&) override { return true; }
+
+    bool wait(u32 timeout_ms, std::vector<Event>& events) override
+    {
+        std::unique_lock lock(mutex_);
+        condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return cancelled_ || !queue_.empty(); });
+        if(cancelled_)
+            return false;
+
+        events.insert(events.end(), queue_.begin(), queue_.end());
+        queue_.clear();
+        return true;
+    }
+
+    void cancel() override
+    {
+        std::lock_guard lock(mutex_);
+        cancelled_ = true;
+        condition_.notify_all();
+    }
+
+    //! 変更を通知
+    void push(const std::wstring& path, Action action)
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back({path, action});
+        condition_.notify_all();
+    }
+
+private:
+    std::mutex              mutex_;               //!< queue_ の排他制御
+    std::condition_variable condition_;           //!< 通知/中断の待機
+    std::vector<Event>      queue_;               //!< 未受信のイベント
+    bool                    cancelled_ = false;   //!< 中断されたか
+};
+
+//! 偽のバックエンドで監視を開始
+//! @param  [out]   watcher     ファイル変更監視
+//! @param  [out]   notified    通知されたパス (update()で追加)
+//! @return バックエンド (watcherが所有)
+FakeBackend* startFake(FileWatcher& watcher, std::vector<std::wstring>& notified)
+{
+    auto  backend = std::make_unique<FakeBackend>();
+    auto* fake    = backend.get();
+    watcher.initialize(L".", [&notified](const wchar_t* path) { notified.emplace_back(path); }, std::move(backend));
+    return fake;
+}
+
+//! 指定時間update()を呼び続ける
+//! @return 通知したファイル数
+size_t updateFor(FileWatcher& watcher, std::chrono::milliseconds duration)
+{
+    size_t count    = 0;
+    auto   deadline = std::chrono::steady_clock::now() + duration;
+    while(std::chrono::steady_clock::now() < deadline) {
+        count += watcher.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return count;
+}
+
+//! まとめ終わるまで十分な時間
+const auto SETTLE = std::chrono::milliseconds(FileWatcher::DEBOUNCE_MS * 4);
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 同じパスへの連続した変更は1回にまとめ、最初に受け取った順に通知する
+//---------------------------------------------------------------------------
+BENCH_TEST(filewatcher_coalesce)
+{
+    FileWatcher               watcher;
+    std::vector<std::wstring> notified;
+    auto*                     fake = startFake(watcher, notified);
+
+    fake->push(L"a.txt", Action::Modified);
+    fake->push(L"b.txt", Action::Added);
+    fake->push(L"a.txt", Action::Modified);
+    fake->push(L"b.txt", Action::Modified);
+    fake->push(L"a.txt", Action::Modified);
+    updateFor(watcher, SETTLE);
+
+    BENCH_CHECK(notified == std::vector<std::wstring>({L"a.txt", L"b.txt"}));
+}
+
+//---------------------------------------------------------------------------
+//! 最終的に削除されたファイル(一時ファイル経由の保存など)は通知しない
+//---------------------------------------------------------------------------
+BENCH_TEST(filewatcher_drop_removed)
+{
+    FileWatcher               watcher;
+    std::vector<std::wstring> notified;
+    auto*                     fake = startFake(watcher, notified);
+
+    // 一時ファイルへ書き込んでから本来の名前へ変更する保存
+    fake->push(L"shader.fx~", Action::Added);
+    fake->push(L"shader.fx~", Action::Modified);
+    fake->push(L"shader.fx~", Action::Removed);
+    fake->push(L"shader.fx", Action::Renamed);
+
+    // 作成してすぐに削除されたファイル
+    fake->push(L"lock", Action::Added);
+    fake->push(L"lock", Action::Removed);
+    updateFor(watcher, SETTLE);
+
+    BENCH_CHECK(notified == std::vector<std::wstring>({L"shader.fx"}));
+}
+
+//---------------------------------------------------------------------------
+//! 変更が続いている間は通知せず、DEBOUNCE_MSの間途切れてから1回だけ通知する
+//---------------------------------------------------------------------------
+BENCH_TEST(filewatcher_debounce)
+{
+    FileWatcher               watcher;
+    std::vector<std::wstring> notified;
+    auto*                     fake = startFake(watcher, notified);
+
+    // DEBOUNCE_MSより短い間隔で、DEBOUNCE_MSの数倍の時間変更し続ける
+    const auto interval = std::chrono::milliseconds(FileWatcher::DEBOUNCE_MS / 5);
+    size_t     early    = 0;
+    for(u32 i = 0; i < 15; ++i) {
+        fake->push(L"a.txt", Action::Modified);
+        early += updateFor(watcher, interval);
+    }
+    BENCH_CHECK(early == 0);
+
+    updateFor(watcher, SETTLE);
+    BENCH_CHECK(notified == std::vector<std::wstring>({L"a.txt"}));
+
+    // まとめ終わった後の変更は再び通知する
+    fake->push(L"a.txt", Action::Modified);
+    updateFor(watcher, SETTLE);
+    BENCH_CHECK(notified.size() == 2);
+}
+
+#if defined(__linux__)
+//---------------------------------------------------------------------------
+//! [inotify] ディレクトリの名前を変更した後の変更は新しいパスで通知する
+//---------------------------------------------------------------------------
+BENCH_TEST(filewatcher_inotify_directory_move)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code error_code;
+    fs::path        root    = fs::temp_directory_path() / "filewatcher_test";
+    fs::path        outside = fs::temp_directory_path() / "filewatcher_test_outside";
+    fs::remove_all(root, error_code);
+    fs::remove_all(outside, error_code);
+    fs::create_directories(root / "sub/deep");
+    fs::create_directories(root / "away");
+
+    FileWatcher               watcher;
+    std::vector<std::wstring> notified;
+    BENCH_CHECK(watcher.initialize(root.wstring().c_str(), [&notified](const wchar_t* path) { notified.emplace_back(path); }));
+
+    // 監視ルート内での名前変更と、監視ルートの外への移動
+    fs::rename(root / "sub", root / "moved");
+    fs::rename(root / "away", outside);
+    updateFor(watcher, SETTLE);
+    notified.clear();
+
+    std::ofstream(root / "moved/a.txt") << "a";
+    std::ofstream(root / "moved/deep/b.txt") << "b";
+    std::ofstream(outside / "c.txt") << "c";
+    updateFor(watcher, SETTLE);
+
+    BENCH_CHECK(notified == std::vector<std::wstring>({L"moved/a.txt", L"moved/deep/b.txt"}));
+
+    watcher.finalize();
+    fs::remove_all(root, error_code);
+    fs::remove_all(outside, error_code);
+}
+#endif
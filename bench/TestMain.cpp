@@ -0,0 +1,51 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestMain.cpp
+//! @brief  テスト エントリーポイント
+//!
+//! DxLibに依存しないモジュールのテストを実行します。
+//! 失敗した検証があれば終了コード1を返すため、ビルドファームでそのまま判定に使えます。
+//! @code
+//!     Test --filter streaming
+//! @endcode
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <cstdio>
+
+//---------------------------------------------------------------------------
+//! エントリーポイント
+//---------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    std::string_view filter;
+
+    //----------------------------------------------------------
+    // コマンドライン引数
+    //----------------------------------------------------------
+    for(int i = 1; i < argc; ++i) {
+        std::string_view arg   = argv[i];
+        const char*      value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if(arg == "--filter" && value) {
+            filter = value;
+            ++i;
+        }
+        else if(arg == "--list") {
+            for(auto& test : bench::tests())
+                std::printf("%s\n", test.name_.c_str());
+            return 0;
+        }
+        else {
+            std::printf("Test [options]\n"
+                        "  --filter <name>  run tests whose name contains <name>\n"
+                        "  --list           list tests\n");
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if(u32 failed = bench::runTests(filter)) {
+        std::fprintf(stderr, "%u tests failed (%u checks)\n", failed, bench::failedChecks());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestPrecompile.h
+//! @brief  テスト共通ヘッダー
+//! @details Linuxでもビルドするため、DxLib/Windowsに依存するヘッダーは含めません。
+//!          エンジン側のソースはDxLibに依存しないもの(VectorMath.cppなど)のみ共有します。
+//---------------------------------------------------------------------------
+#pragma once
+
+//===========================================================================
+// C++ STL
+//===========================================================================
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//===========================================================================
+// 外部ライブラリ
+//===========================================================================
+
+// hlslpp
+#include "hlslpp/include/hlsl++.h"
+using namespace hlslpp;
+
+//===========================================================================
+// 実装コード
+//===========================================================================
+
+#include "System/Typedef.h"
+#include "System/VectorMath.h"
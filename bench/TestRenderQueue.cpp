@@ -0,0 +1,199 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestRenderQueue.cpp
+//! @brief  描画キューのテスト (描画の代わりに呼び出しを記録する実行器を使用)
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/Graphics/RenderQueue.h>
+
+namespace
+{
+
+//! 記録用の実行器
+//! @details 設定中のステートと描画したパケットを記録し、描画時にパケットのステートが設定されているか確認します
+struct RecordExecutor final : RenderQueue::Executor
+{
+    void begin() override { begins_++; }
+
+    void bindShader(const RenderQueue::Packet& packet) override { shader_state_ = packet.shader_state_; }
+
+    void bindMaterial(const RenderQueue::Packet& packet) override { material_state_ = packet.material_state_; }
+
+    void draw(const RenderQueue::Packet& packet, [[maybe_unused]] bool object_changed) override { record(packet); }
+
+    void drawInstanced(const RenderQueue::Packet* const* packets, u32 count) override
+    {
+        batches_.push_back(count);
+        for(u32 i = 0; i < count; ++i) {
+            if(packets[i]->instance_key_ != packets[0]->instance_key_)
+                mixed_keys_++;
+            record(*packets[i]);
+        }
+    }
+
+    void end() override { ends_++; }
+
+    //! 描画したパケットを記録
+    void record(const RenderQueue::Packet& packet)
+    {
+        if(packet.shader_state_ != shader_state_ || packet.material_state_ != material_state_)
+            wrong_states_++;
+        drawn_.push_back(packet.mesh_);
+    }
+
+    u64              shader_state_   = 0;   //!< 設定中のシェーダーのステート値
+    u64              material_state_ = 0;   //!< 設定中のマテリアルのステート値
+    std::vector<s32> drawn_;                //!< 描画したパケットのメッシュ番号 (描画順)
+    std::vector<u32> batches_;              //!< まとめ描画のパケット数 (呼び出し順)
+    u32              wrong_states_ = 0;     //!< 異なるステートのまま描画したパケット数
+    u32              mixed_keys_   = 0;     //!< まとめ描画に混ざった異なるインスタンスキーのパケット数
+    u32              begins_       = 0;     //!< begin()の呼び出し回数
+    u32              ends_         = 0;     //!< end()の呼び出し回数
+};
+
+//! パケットを作成 (メッシュ番号を識別子として使用)
+RenderQueue::Packet makePacket(s32 id, u32 layer, u64 shader, u64 material, f32 depth, u64 instance_key = 0)
+{
+    RenderQueue::Packet packet;
+    packet.object_         = reinterpret_cast<const void*>(static_cast<uintptr_t>(id + 1));
+    packet.mesh_           = id;
+    packet.shader_state_   = shader;
+    packet.material_state_ = material;
+    packet.instance_key_   = instance_key;
+    packet.layer_          = layer;
+    packet.depth_          = depth;
+    return packet;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 描画レイヤー > シェーダー > マテリアル > 深度(手前から奥) の順に描画する
+//---------------------------------------------------------------------------
+BENCH_TEST(renderqueue_sort_order)
+{
+    // シェーダー/マテリアルの番号は初出順 (100→0, 200→1 / 10→0, 20→1)
+    RenderQueue queue;
+    queue.submit(makePacket(0, 1, 100, 10, 1.0f));
+    queue.submit(makePacket(1, 0, 200, 10, 5.0f));
+    queue.submit(makePacket(2, 0, 100, 20, 1.0f));
+    queue.submit(makePacket(3, 0, 100, 10, 9.0f));
+    queue.submit(makePacket(4, 0, 100, 10, 2.0f));
+    queue.submit(makePacket(5, 0, 100, 10, 0.0f));
+
+    RecordExecutor executor;
+    queue.execute(executor);
+
+    BENCH_CHECK(executor.drawn_ == std::vector<s32>({5, 4, 3, 2, 1, 0}));
+    BENCH_CHECK(executor.wrong_states_ == 0);
+    BENCH_CHECK(executor.begins_ == 1 && executor.ends_ == 1);
+
+    for(size_t i = 1; i < queue.size(); ++i)
+        BENCH_CHECK(queue.sortedKey(i - 1) <= queue.sortedKey(i));
+
+    // キーが同じパケットは登録順を保持
+    RenderQueue same;
+    for(s32 i = 0; i < 4; ++i)
+        same.submit(makePacket(i, 0, 100, 10, 3.0f));
+
+    RecordExecutor same_executor;
+    same.execute(same_executor);
+    BENCH_CHECK(same_executor.drawn_ == std::vector<s32>({0, 1, 2, 3}));
+}
+
+//---------------------------------------------------------------------------
+//! 番号がソートキーのビット数を超えて同じキーになっても、異なるステートはまとめない
+//---------------------------------------------------------------------------
+BENCH_TEST(renderqueue_distinct_states_not_merged)
+{
+    constexpr u32 SHADER_COUNT = (1u << RenderQueue::SHADER_BITS) + 2;
+
+    // シェーダー番号 0 と 65536 は同じキーになる
+    RenderQueue queue;
+    for(u32 i = 0; i < SHADER_COUNT; ++i)
+        queue.submit(makePacket(static_cast<s32>(i), 0, 1000 + i, 10, 1.0f, 77));
+
+    RecordExecutor executor;
+    auto           stats = queue.execute(executor);
+
+    BENCH_CHECK(executor.drawn_.size() == SHADER_COUNT);
+    BENCH_CHECK(executor.wrong_states_ == 0);
+    BENCH_CHECK(executor.batches_.empty());   // インスタンスキーが同じでもステートが異なればまとめない
+    BENCH_CHECK(stats.shader_changes_ == SHADER_COUNT);
+
+    // マテリアルのみ異なるパケットも同様
+    RenderQueue materials;
+    materials.submit(makePacket(0, 0, 100, 10, 1.0f, 5));
+    materials.submit(makePacket(1, 0, 100, 20, 1.0f, 5));
+    materials.submit(makePacket(2, 0, 100, 10, 2.0f, 5));
+
+    RecordExecutor material_executor;
+    auto           material_stats = materials.execute(material_executor);
+
+    BENCH_CHECK(material_executor.wrong_states_ == 0);
+    BENCH_CHECK(material_executor.batches_ == std::vector<u32>({2}));
+    BENCH_CHECK(material_executor.drawn_ == std::vector<s32>({0, 2, 1}));
+    BENCH_CHECK(material_stats.material_changes_ == 2);
+}
+
+//---------------------------------------------------------------------------
+//! 同じステート内でインスタンスキーが等しいパケットのみまとめ描画する
+//---------------------------------------------------------------------------
+BENCH_TEST(renderqueue_instance_grouping)
+{
+    RenderQueue queue;
+    queue.submit(makePacket(0, 0, 100, 10, 1.0f, 7));
+    queue.submit(makePacket(1, 0, 100, 10, 2.0f, 8));
+    queue.submit(makePacket(2, 0, 100, 10, 3.0f, 7));
+    queue.submit(makePacket(3, 0, 100, 10, 4.0f, 0));   // キー無し
+    queue.submit(makePacket(4, 0, 100, 10, 5.0f, 8));
+    queue.submit(makePacket(5, 0, 100, 10, 6.0f, 7));
+    queue.submit(makePacket(6, 0, 100, 10, 7.0f, 0));   // キー無し (1つずつ描画)
+    queue.submit(makePacket(7, 0, 100, 10, 8.0f, 9));   // 1つだけのキー
+
+    RecordExecutor executor;
+    queue.execute(executor);
+
+    // キーの無いパケットは並び順のまま先頭、以降はキーごとに深度順
+    BENCH_CHECK(executor.drawn_ == std::vector<s32>({3, 6, 0, 2, 5, 1, 4, 7}));
+    BENCH_CHECK(executor.batches_ == std::vector<u32>({3, 2}));
+    BENCH_CHECK(executor.mixed_keys_ == 0);
+    BENCH_CHECK(executor.wrong_states_ == 0);
+}
+
+//---------------------------------------------------------------------------
+//! 実行結果の統計
+//---------------------------------------------------------------------------
+BENCH_TEST(renderqueue_stats)
+{
+    RenderQueue queue;
+
+    // 空の場合は実行器を呼ばない
+    RecordExecutor empty_executor;
+    auto           empty = queue.execute(empty_executor);
+    BENCH_CHECK(empty.packets_ == 0 && empty_executor.begins_ == 0);
+
+    // シェーダー2種 × マテリアル2種、シェーダー100/マテリアル10 の3つをまとめ描画
+    queue.submit(makePacket(0, 0, 100, 10, 1.0f, 1));
+    queue.submit(makePacket(1, 0, 100, 10, 2.0f, 1));
+    queue.submit(makePacket(2, 0, 100, 10, 3.0f, 1));
+    queue.submit(makePacket(3, 0, 100, 20, 1.0f));
+    queue.submit(makePacket(4, 0, 200, 10, 1.0f));
+    queue.submit(makePacket(5, 0, 200, 20, 1.0f));
+
+    RecordExecutor executor;
+    auto           stats = queue.execute(executor);
+
+    BENCH_CHECK(stats.packets_ == 6);
+    BENCH_CHECK(stats.shader_changes_ == 2);
+    BENCH_CHECK(stats.material_changes_ == 4);
+    BENCH_CHECK(stats.object_changes_ == 6);
+    BENCH_CHECK(stats.instance_batches_ == 1);
+    BENCH_CHECK(stats.instances_ == 3);
+
+    // 登録済みのパケットは保持され、clear()で破棄される
+    BENCH_CHECK(queue.execute(executor).packets_ == 6);
+    queue.clear();
+    BENCH_CHECK(queue.size() == 0);
+    BENCH_CHECK(queue.execute(executor).packets_ == 0);
+}
@@ -0,0 +1,228 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestShaderCache.cpp
+//! @brief  シェーダーバイトコードキャッシュのテスト (D3DCompilerの代わりにスタブを使用)
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/Graphics/ShaderCache.h>
+
+#include <atomic>
+#include <map>
+
+namespace
+{
+
+constexpr u32 VARIANT_COUNT = 4;   //!< バリエーション数
+
+//! メモリ上のファイル
+using Files = std::map<std::filesystem::path, std::string>;
+
+//! バイト列へ変換
+ShaderCache::Bytes toBytes(std::string_view text)
+{
+    auto* p = reinterpret_cast<const std::byte*>(text.data());
+    return ShaderCache::Bytes(p, p + text.size());
+}
+
+//! テストごとの一時キャッシュディレクトリ (終了時に削除)
+struct TemporaryDirectory
+{
+    std::filesystem::path path_;
+
+    TemporaryDirectory(std::string_view name)
+    {
+        path_ = std::filesystem::temp_directory_path() / "BaseProjectTest" / name;
+
+        std::error_code error_code;
+        std::filesystem::remove_all(path_, error_code);
+    }
+
+    ~TemporaryDirectory()
+    {
+        std::error_code error_code;
+        std::filesystem::remove_all(path_, error_code);
+    }
+
+    //! キャッシュファイル数
+    size_t fileCount() const
+    {
+        std::error_code error_code;
+        size_t          count = 0;
+        for(auto it = std::filesystem::directory_iterator(path_, error_code);
+            !error_code && it != std::filesystem::directory_iterator();
+            it.increment(error_code)) {
+            ++count;
+        }
+        return count;
+    }
+};
+
+//! スタブコンパイラ (呼び出し回数を数え、ソースとバリエーション番号からバイトコードを作る)
+struct StubCompiler
+{
+    std::atomic<u32> calls_ = 0;
+    bool             fail_  = false;
+
+    ShaderCache::CompileFunc func()
+    {
+        return [this](const ShaderCache::Request& request, u32 variant, ShaderCache::Bytes& bytecode, std::string& errors) {
+            ++calls_;
+            if(fail_) {
+                errors = "error X0000: stub";
+                return false;
+            }
+            bytecode = request.source_;
+            bytecode.push_back(static_cast<std::byte>(variant));
+            return true;
+        };
+    }
+};
+
+//! メモリ上のファイルを読むキャッシュ
+ShaderCache makeCache(const TemporaryDirectory& directory, const Files& files)
+{
+    return ShaderCache(directory.path_, [&files](const std::filesystem::path& path, ShaderCache::Bytes& data) {
+        auto it = files.find(path);
+        if(it == files.end())
+            return false;
+        data = toBytes(it->second);
+        return true;
+    });
+}
+
+//! コンパイル要求
+ShaderCache::Request makeRequest(const Files& files)
+{
+    ShaderCache::Request request;
+    request.source_path_ = "shader/vs_model.fx";
+    request.source_      = toBytes(files.at(request.source_path_));
+    request.target_      = "vs_5_0";
+    return request;
+}
+
+//! すべての結果が成功し、キャッシュ利用の有無が期待通りか
+bool allSucceeded(const std::vector<ShaderCache::Result>& results, bool cache_hit)
+{
+    for(auto& result : results) {
+        if(!result.succeeded_ || result.cache_hit_ != cache_hit)
+            return false;
+    }
+    return results.size() == VARIANT_COUNT;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 2回目はコンパイラを呼ばずにキャッシュから同じバイトコードを読む
+//---------------------------------------------------------------------------
+BENCH_TEST(shader_cache_hit_and_miss)
+{
+    TemporaryDirectory directory("shader_cache_hit_and_miss");
+    Files              files = {
+        {"shader/vs_model.fx", "#include \"common.h\"\nfloat4 main() : SV_Position { return 0; }\n"},
+        {"shader/common.h", "#include <../lib/math.h>\n"},
+        {"lib/math.h", "// math\n"},
+    };
+
+    auto         cache   = makeCache(directory, files);
+    auto         request = makeRequest(files);
+    StubCompiler compiler;
+
+    std::vector<std::filesystem::path> dependencies;
+    auto                               first = cache.compile(request, VARIANT_COUNT, compiler.func(), &dependencies);
+    BENCH_CHECK(allSucceeded(first, false));
+    BENCH_CHECK(compiler.calls_ == VARIANT_COUNT);
+    BENCH_CHECK(directory.fileCount() == VARIANT_COUNT);
+
+    // 依存ファイルは dependencies() と同じ (ソース自身が先頭)
+    BENCH_CHECK(dependencies == cache.dependencies(request.source_path_, request.source_));
+    BENCH_CHECK(dependencies.size() == 3);
+    BENCH_CHECK(dependencies[2] == std::filesystem::path("lib/math.h"));
+
+    auto second = cache.compile(request, VARIANT_COUNT, compiler.func());
+    BENCH_CHECK(allSucceeded(second, true));
+    BENCH_CHECK(compiler.calls_ == VARIANT_COUNT);
+    for(u32 i = 0; i < VARIANT_COUNT; ++i) {
+        BENCH_CHECK(second[i].bytecode_ == first[i].bytecode_);
+        BENCH_CHECK(second[i].key_ == cache.key(request, i));
+    }
+}
+
+//---------------------------------------------------------------------------
+//! インクルードファイル/マクロ定義の変更で再コンパイルし、古いバイトコードを削除する
+//---------------------------------------------------------------------------
+BENCH_TEST(shader_cache_invalidation)
+{
+    TemporaryDirectory directory("shader_cache_invalidation");
+    Files              files = {
+        {"shader/vs_model.fx", "#include \"common.h\"\n"},
+        {"shader/common.h", "#define A 1\n"},
+        {"shader/ps_model.fx", "float4 main() : SV_Target { return 1; }\n"},
+    };
+
+    auto         cache   = makeCache(directory, files);
+    auto         request = makeRequest(files);
+    StubCompiler compiler;
+
+    // 別のシェーダーのキャッシュ (削除されないこと)
+    ShaderCache::Request other;
+    other.source_path_ = "shader/ps_model.fx";
+    other.source_      = toBytes(files.at(other.source_path_));
+    other.target_      = "ps_5_0";
+    BENCH_CHECK(cache.compile(other, 1, compiler.func())[0].succeeded_);
+
+    BENCH_CHECK(allSucceeded(cache.compile(request, VARIANT_COUNT, compiler.func()), false));
+    BENCH_CHECK(directory.fileCount() == VARIANT_COUNT + 1);
+
+    // インクルードファイルの変更
+    files["shader/common.h"] = "#define A 2\n";
+    compiler.calls_          = 0;
+    BENCH_CHECK(allSucceeded(cache.compile(request, VARIANT_COUNT, compiler.func()), false));
+    BENCH_CHECK(compiler.calls_ == VARIANT_COUNT);
+    BENCH_CHECK(directory.fileCount() == VARIANT_COUNT + 1);   // 変更前のバイトコードは削除
+
+    // 存在しなかったインクルードファイルが作られた場合
+    files["shader/common.h"] = "#include \"late.h\"\n";
+    BENCH_CHECK(allSucceeded(cache.compile(request, VARIANT_COUNT, compiler.func()), false));
+    files["shader/late.h"] = "// created\n";
+    compiler.calls_        = 0;
+    BENCH_CHECK(allSucceeded(cache.compile(request, VARIANT_COUNT, compiler.func()), false));
+    BENCH_CHECK(compiler.calls_ == VARIANT_COUNT);
+
+    // マクロ定義の変更は別のシェーダーとして扱う (どちらのキャッシュも残る)
+    auto defined = request;
+    defined.defines_.emplace_back("USE_SHADOW", "1");
+    BENCH_CHECK(allSucceeded(cache.compile(defined, VARIANT_COUNT, compiler.func()), false));
+    BENCH_CHECK(allSucceeded(cache.compile(request, VARIANT_COUNT, compiler.func()), true));
+    BENCH_CHECK(directory.fileCount() == VARIANT_COUNT * 2 + 1);
+
+    // 別のシェーダーのキャッシュは残っている
+    BENCH_CHECK(cache.compile(other, 1, compiler.func())[0].cache_hit_);
+}
+
+//---------------------------------------------------------------------------
+//! コンパイルに失敗したバリエーションはキャッシュに保存しない
+//---------------------------------------------------------------------------
+BENCH_TEST(shader_cache_failed_compile)
+{
+    TemporaryDirectory directory("shader_cache_failed_compile");
+    Files              files = {
+        {"shader/vs_model.fx", "float4 main() : SV_Position { return 0 }\n"},
+    };
+
+    auto         cache   = makeCache(directory, files);
+    auto         request = makeRequest(files);
+    StubCompiler compiler;
+
+    compiler.fail_ = true;
+    auto failed    = cache.compile(request, VARIANT_COUNT, compiler.func());
+    BENCH_CHECK(failed.size() == VARIANT_COUNT);
+    BENCH_CHECK(!failed[0].succeeded_ && !failed[0].errors_.empty());
+    BENCH_CHECK(directory.fileCount() == 0);
+
+    // 次回はキャッシュを使わずにコンパイルしなおす
+    compiler.fail_  = false;
+    compiler.calls_ = 0;
+    BENCH_CHECK(allSucceeded(cache.compile(request, VARIANT_COUNT, compiler.func()), false));
+    BENCH_CHECK(compiler.calls_ == VARIANT_COUNT);
+}
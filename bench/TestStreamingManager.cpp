@@ -0,0 +1,329 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestStreamingManager.cpp
+//! @brief  アセットストリーミングのテスト (偽のI/Oと偽の時計を使用)
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/Graphics/StreamingManager.h>
+
+#include <deque>
+#include <random>
+
+namespace
+{
+
+//! 偽の読み込み対象
+struct FakeAsset
+{
+    u32  io_frames_     = 1;         //!< I/Oにかかるフレーム数
+    f32  cost_ms_       = 0.0f;      //!< 仕上げ時間 (ミリ秒)
+    bool fail_start_    = false;     //!< 開始を失敗させるか
+    bool fail_io_       = false;     //!< I/Oを失敗させるか
+    bool fail_finalize_ = false;     //!< 仕上げを失敗させるか
+    bool visible_       = false;     //!< 画面に映っているか
+    f32  distance_      = FLT_MAX;   //!< カメラからの距離
+    u32  started_       = 0;         //!< 開始したフレーム
+    u32  order_         = 0;         //!< 開始した順番 (1から)
+    bool loading_       = false;     //!< 開始したか
+    bool io_finished_   = false;     //!< I/Oが終わったか
+    bool finalized_     = false;     //!< 仕上げたか
+    bool cleaned_up_    = false;     //!< 取り消し時の後始末が呼ばれたか
+};
+
+//! 偽のI/Oバックエンド
+//! @details 同時読み込み数と仕上げ予算は、マネージャーの統計とは別にコールバックの呼ばれ方から数えます
+class FakeIo
+{
+public:
+    FakeIo(const StreamingManager::Settings& settings)
+        : manager_([this]() { return now_; })
+    {
+        manager_.setSettings(settings);
+    }
+
+    //! 要求を追加
+    //! @return 対象の番号
+    size_t add(const FakeAsset& desc, u32 group = 0)
+    {
+        size_t index = assets_.size();
+        auto&  asset = assets_.emplace_back(desc);
+
+        StreamingManager::Request request;
+        request.start_ = [this, &asset]() {
+            if(asset.fail_start_)
+                return false;
+            asset.started_ = frame_;
+            asset.order_   = ++started_count_;
+            asset.loading_ = true;
+            in_flight_++;
+            max_in_flight_ = std::max(max_in_flight_, in_flight_);
+            return true;
+        };
+        request.poll_ = [this, &asset]() {
+            if(frame_ - asset.started_ < asset.io_frames_)
+                return StreamingManager::Poll::Pending;
+            if(asset.fail_io_) {
+                if(!asset.io_finished_)
+                    in_flight_--;
+                asset.io_finished_ = true;
+                return StreamingManager::Poll::Failed;
+            }
+            asset.io_finished_ = true;
+            return StreamingManager::Poll::Done;
+        };
+        request.finalize_ = [this, &asset]() {
+            // 予算を使い切った後に2件目以降の仕上げを開始していないか
+            if(frame_finalized_ > 0 && now_ - frame_begin_ >= manager_.settings().finalize_budget_ms_)
+                over_budget_++;
+            now_ += asset.cost_ms_;   // 仕上げ時間だけ時計を進める
+            frame_finalized_++;
+            asset.finalized_ = true;
+            in_flight_--;
+            return !asset.fail_finalize_;
+        };
+        request.cancel_ = [this, &asset]() {
+            asset.cleaned_up_ = true;
+            in_flight_--;
+        };
+        request.distance_ = asset.distance_;
+        request.group_    = group;
+
+        ids_.push_back(manager_.request(std::move(request)));
+        return index;
+    }
+
+    //! 1フレーム分の更新 (画面に映っている要求を通知してから更新)
+    void step()
+    {
+        for(size_t i = 0; i < assets_.size(); ++i) {
+            if(assets_[i].visible_)
+                manager_.touch(ids_[i], assets_[i].distance_);
+        }
+        frame_begin_     = now_;
+        frame_finalized_ = 0;
+        manager_.update();
+        frame_++;
+    }
+
+    //! 全ての要求が終わるまで更新
+    //! @return 上限のフレーム数以内に終わったかどうか
+    bool run(u32 max_frames = 10000)
+    {
+        for(u32 i = 0; i < max_frames && !manager_.progress().isDone(); ++i) {
+            step();
+        }
+        return manager_.progress().isDone();
+    }
+
+    StreamingManager                         manager_;
+    std::deque<FakeAsset>                    assets_;
+    std::vector<StreamingManager::RequestId> ids_;
+    f64                                      now_             = 0.0;   //!< 偽の時計 (ミリ秒)
+    u32                                      frame_           = 0;     //!< 現在のフレーム
+    u32                                      started_count_   = 0;     //!< 開始した数
+    u32                                      in_flight_       = 0;     //!< 開始してから終わっていない数
+    u32                                      max_in_flight_   = 0;     //!< in_flight_の最大値
+    u32                                      over_budget_     = 0;     //!< 予算を超えて仕上げを開始した数
+    f64                                      frame_begin_     = 0.0;   //!< フレームの更新開始時刻
+    u32                                      frame_finalized_ = 0;     //!< フレーム内で仕上げた数
+};
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 同時読み込み数は上限まで使い、上限を超えない (仕上げ待ちも含む)
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_in_flight_limit)
+{
+    constexpr u32 MAX_IN_FLIGHT = 4;
+    constexpr u32 COUNT         = 64;
+
+    FakeIo       io({MAX_IN_FLIGHT, 1000.0f});
+    std::mt19937 rng(1);
+    for(u32 i = 0; i < COUNT; ++i) {
+        FakeAsset asset;
+        asset.io_frames_ = 1 + rng() % 8;
+        io.add(asset);
+    }
+
+    BENCH_CHECK(io.run());
+    BENCH_CHECK(io.max_in_flight_ == MAX_IN_FLIGHT);
+    BENCH_CHECK(io.in_flight_ == 0);
+    BENCH_CHECK(io.manager_.progress().completed_ == COUNT);
+    BENCH_CHECK(std::all_of(io.assets_.begin(), io.assets_.end(), [](const FakeAsset& a) { return a.finalized_; }));
+}
+
+//---------------------------------------------------------------------------
+//! 仕上げ処理は1フレームの時間予算を使い切ったら次のフレームへ回す (最低1件は実行)
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_finalize_budget)
+{
+    // 同じフレームに全てI/Oが終わる要求 (0.75ms × 3件で予算2msに達する)
+    {
+        FakeIo io({64, 2.0f});
+        for(u32 i = 0; i < 32; ++i) {
+            FakeAsset asset;
+            asset.cost_ms_ = 0.75f;
+            io.add(asset);
+        }
+        io.step();   // 開始
+        io.step();   // I/O完了と仕上げ
+        BENCH_CHECK(io.manager_.stats().finalized_ == 3);
+        BENCH_CHECK(io.run());
+        BENCH_CHECK(io.over_budget_ == 0);
+    }
+
+    // 1件で予算を超える場合も毎フレーム1件ずつ進む
+    {
+        FakeIo io({64, 2.0f});
+        for(u32 i = 0; i < 4; ++i) {
+            FakeAsset asset;
+            asset.cost_ms_ = 5.0f;
+            io.add(asset);
+        }
+        io.step();
+        for(u32 i = 0; i < 4; ++i) {
+            io.step();
+            BENCH_CHECK(io.manager_.stats().finalized_ == 1);
+        }
+        BENCH_CHECK(io.manager_.progress().isDone());
+        BENCH_CHECK(io.over_budget_ == 0);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 画面に映っているもの → カメラに近いもの → 要求順に開始する
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_priority)
+{
+    FakeIo io({1, 1000.0f});
+
+    FakeAsset far_asset;
+    far_asset.distance_ = 50.0f;
+    FakeAsset near_asset;
+    near_asset.distance_ = 10.0f;
+    FakeAsset visible_asset;
+    visible_asset.distance_ = 90.0f;
+    visible_asset.visible_  = true;
+    FakeAsset late_asset;   // 距離が同じなら要求順
+    late_asset.distance_ = 50.0f;
+
+    size_t far_index     = io.add(far_asset);
+    size_t near_index    = io.add(near_asset);
+    size_t visible_index = io.add(visible_asset);
+    size_t late_index    = io.add(late_asset);
+
+    BENCH_CHECK(io.run());
+    BENCH_CHECK(io.assets_[visible_index].order_ == 1);
+    BENCH_CHECK(io.assets_[near_index].order_ == 2);
+    BENCH_CHECK(io.assets_[far_index].order_ == 3);
+    BENCH_CHECK(io.assets_[late_index].order_ == 4);
+}
+
+//---------------------------------------------------------------------------
+//! 取り消した要求は仕上げず、開始済みの場合のみ後始末を呼ぶ
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_cancel)
+{
+    FakeIo io({1, 1000.0f});
+
+    FakeAsset asset;
+    asset.io_frames_ = 2;
+    size_t loading   = io.add(asset);
+    size_t queued    = io.add(asset);
+
+    io.step();
+    BENCH_CHECK(io.manager_.state(io.ids_[loading]) == StreamingManager::State::Loading);
+    BENCH_CHECK(io.manager_.state(io.ids_[queued]) == StreamingManager::State::Queued);
+
+    BENCH_CHECK(io.manager_.cancel(io.ids_[loading]));
+    BENCH_CHECK(io.manager_.cancel(io.ids_[queued]));
+    BENCH_CHECK(!io.manager_.cancel(io.ids_[queued]));   // 二重の取り消し
+
+    BENCH_CHECK(io.run());
+    BENCH_CHECK(io.assets_[loading].cleaned_up_ && !io.assets_[loading].finalized_);
+    BENCH_CHECK(!io.assets_[queued].loading_ && !io.assets_[queued].cleaned_up_);
+    BENCH_CHECK(io.manager_.state(io.ids_[loading]) == StreamingManager::State::None);
+    BENCH_CHECK(io.manager_.progress().cancelled_ == 2);
+    BENCH_CHECK(io.in_flight_ == 0);
+}
+
+//---------------------------------------------------------------------------
+//! 開始/I/O/仕上げのどの段階の失敗も失敗数に数え、他の要求は完了する
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_failures)
+{
+    FakeIo io({8, 1000.0f});
+
+    FakeAsset fail_start;
+    fail_start.fail_start_ = true;
+    FakeAsset fail_io;
+    fail_io.fail_io_ = true;
+    FakeAsset fail_finalize;
+    fail_finalize.fail_finalize_ = true;
+
+    size_t start_index = io.add(fail_start);
+    size_t io_index    = io.add(fail_io);
+    io.add(fail_finalize);
+    io.add(FakeAsset{});
+
+    BENCH_CHECK(io.run());
+    BENCH_CHECK(!io.assets_[start_index].loading_);
+    BENCH_CHECK(!io.assets_[io_index].finalized_);
+
+    auto progress = io.manager_.progress();
+    BENCH_CHECK(progress.failed_ == 3);
+    BENCH_CHECK(progress.completed_ == 1);
+    BENCH_CHECK(io.in_flight_ == 0);
+}
+
+//---------------------------------------------------------------------------
+//! グループの進捗は Request::group_、GroupScope、join() で集計し、同じ要求を二重に数えない
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_groups)
+{
+    FakeIo io({8, 1000.0f});
+    u32    group       = io.manager_.createGroup();
+    u32    scene_group = io.manager_.createGroup();   // シーンの先行読み込み相当
+
+    size_t shared = io.add(FakeAsset{}, group);
+    {
+        StreamingManager::GroupScope scope(scene_group);
+        io.add(FakeAsset{});
+        io.add(FakeAsset{}, group);   // 明示したグループが優先
+
+        // 共有リソースの再利用
+        io.manager_.join(io.ids_[shared]);
+        io.manager_.join(io.ids_[shared]);
+    }
+    io.add(FakeAsset{});   // スコープ外はどのグループにも入らない
+
+    BENCH_CHECK(io.manager_.progress(group).requested_ == 2);
+    BENCH_CHECK(io.manager_.progress(scene_group).requested_ == 2);
+    BENCH_CHECK(!io.manager_.progress(scene_group).isDone());
+    BENCH_CHECK(io.manager_.progress().requested_ == 4);
+
+    BENCH_CHECK(io.run());
+    BENCH_CHECK(io.manager_.progress(group).completed_ == 2);
+    BENCH_CHECK(io.manager_.progress(scene_group).completed_ == 2);
+
+    // 完了済みの要求はjoin()しても数えない
+    {
+        StreamingManager::GroupScope scope(scene_group);
+        io.manager_.join(io.ids_[shared]);
+    }
+    BENCH_CHECK(io.manager_.progress(scene_group).requested_ == 2);
+
+    io.manager_.releaseGroup(group);
+    BENCH_CHECK(io.manager_.progress(group).requested_ == 0);
+}
+
+//---------------------------------------------------------------------------
+//! CheckHandleASyncLoad() の戻り値の変換
+//---------------------------------------------------------------------------
+BENCH_TEST(streaming_poll_conversion)
+{
+    BENCH_CHECK(StreamingManager::toPoll(1) == StreamingManager::Poll::Pending);
+    BENCH_CHECK(StreamingManager::toPoll(0) == StreamingManager::Poll::Done);
+    BENCH_CHECK(StreamingManager::toPoll(-1) == StreamingManager::Poll::Failed);
+}
@@ -0,0 +1,126 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestSweep.cpp
+//! @brief  連続的な当たり判定 (衝突時刻) のテスト
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/Physics/Sweep.h>
+
+namespace
+{
+
+//! 移動する球
+physics::SweptShape movingSphere(const float3& from, const float3& to, f32 radius)
+{
+    physics::SweptShape shape;
+    shape.from_p0_ = from;
+    shape.from_p1_ = from;
+    shape.to_p0_   = to;
+    shape.to_p1_   = to;
+    shape.radius_  = radius;
+    return shape;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 1フレームで相手を通り抜ける球の衝突時刻と法線
+//---------------------------------------------------------------------------
+BENCH_TEST(sweep_sphere_tunneling)
+{
+    // 前後のフレームでは重ならないが、移動中に接触する
+    auto a = movingSphere(float3(-10.0f, 0.0f, 0.0f), float3(10.0f, 0.0f, 0.0f), 0.5f);
+    auto b = movingSphere(float3(0.0f, 0.0f, 0.0f), float3(0.0f, 0.0f, 0.0f), 0.5f);
+
+    physics::SweepHit hit;
+    BENCH_CHECK(physics::sweep(a, b, hit));
+
+    // 中心間の距離が半径の和(1.0)になる時刻 = (10 - 1) / 20
+    BENCH_CHECK(std::abs(hit.time_ - 0.45f) < 1e-3f);
+    BENCH_CHECK(static_cast<f32>(length(hit.normal_ - float3(-1.0f, 0.0f, 0.0f))) < 1e-3f);
+    BENCH_CHECK(static_cast<f32>(length(hit.position_ - float3(-0.5f, 0.0f, 0.0f))) < 1e-2f);
+}
+
+//---------------------------------------------------------------------------
+//! 両方が移動するカプセルと球の衝突時刻
+//---------------------------------------------------------------------------
+BENCH_TEST(sweep_capsule_moving_pair)
+{
+    // 縦のカプセル(x=-4→4)と球(x=4→-4)が正面から近づく
+    physics::SweptShape capsule;
+    capsule.from_p0_ = float3(-4.0f, 0.0f, 0.0f);
+    capsule.from_p1_ = float3(-4.0f, 2.0f, 0.0f);
+    capsule.to_p0_   = float3(4.0f, 0.0f, 0.0f);
+    capsule.to_p1_   = float3(4.0f, 2.0f, 0.0f);
+    capsule.radius_  = 0.25f;
+
+    auto sphere = movingSphere(float3(4.0f, 1.0f, 0.0f), float3(-4.0f, 1.0f, 0.0f), 0.25f);
+
+    physics::SweepHit hit;
+    BENCH_CHECK(physics::sweep(capsule, sphere, hit));
+
+    // 相対速度16で距離8から半径の和0.5まで近づく時刻 = 7.5 / 16
+    BENCH_CHECK(std::abs(hit.time_ - 7.5f / 16.0f) < 1e-3f);
+    BENCH_CHECK(static_cast<f32>(length(hit.normal_ - float3(-1.0f, 0.0f, 0.0f))) < 1e-3f);
+}
+
+//---------------------------------------------------------------------------
+//! 接触しない移動と、移動前から重なっている場合は連続判定しない
+//---------------------------------------------------------------------------
+BENCH_TEST(sweep_miss_and_initial_overlap)
+{
+    physics::SweepHit hit;
+
+    auto pass = movingSphere(float3(-10.0f, 2.0f, 0.0f), float3(10.0f, 2.0f, 0.0f), 0.5f);
+    auto wall = movingSphere(float3(0.0f, 0.0f, 0.0f), float3(0.0f, 0.0f, 0.0f), 0.5f);
+    BENCH_CHECK(!physics::sweep(pass, wall, hit));
+
+    auto overlap = movingSphere(float3(0.2f, 0.0f, 0.0f), float3(10.0f, 0.0f, 0.0f), 0.5f);
+    BENCH_CHECK(!physics::sweep(overlap, wall, hit));
+
+    auto still = movingSphere(float3(-10.0f, 0.0f, 0.0f), float3(-10.0f, 0.0f, 0.0f), 0.5f);
+    BENCH_CHECK(!physics::sweep(still, wall, hit));
+}
+
+//---------------------------------------------------------------------------
+//! 反復回数の上限に達した場合は、隙間が残っている可能性があるため接触とはみなさない
+//---------------------------------------------------------------------------
+BENCH_TEST(sweep_advance_exhausted)
+{
+    // 実際の接近速度(2.0)に対してmax_motionが過大なため、隙間が少しずつしか縮まない
+    constexpr f32 radius     = 1.0f;
+    constexpr f32 max_motion = 100.0f;
+
+    auto distance = [](f32 t, float3& on_a, float3& on_b) {
+        f32 gap = std::max(1.0f - t * 2.0f, 0.0f);
+        on_a    = float3(radius + gap, 0.0f, 0.0f);
+        on_b    = float3(0.0f, 0.0f, 0.0f);
+        return radius + gap;
+    };
+
+    physics::SweepHit hit;
+    BENCH_CHECK(!physics::conservativeAdvance(radius, max_motion, distance, hit));
+    BENCH_CHECK(hit.time_ == 1.0f);   // 結果は変更しない
+}
+
+//---------------------------------------------------------------------------
+//! 高速な移動体が形状のすぐ近くを通過しても接触とはみなさない
+//---------------------------------------------------------------------------
+BENCH_TEST(sweep_advance_near_miss)
+{
+    // 1フレームに10移動する点が、半径1の球の表面から0.3離れたところを通過する
+    // max_motionは回転なども含めた上限のため、実際の移動量より大きく見積もられている
+    constexpr f32 radius     = 1.0f;
+    constexpr f32 clearance  = 0.3f;
+    constexpr f32 speed      = 10.0f;
+    constexpr f32 max_motion = 100.0f;
+
+    auto distance = [](f32 t, float3& on_a, float3& on_b) {
+        on_a = float3(-5.0f + t * speed, radius + clearance, 0.0f);
+        on_b = float3(0.0f, 0.0f, 0.0f);
+        return static_cast<f32>(length(on_a - on_b));
+    };
+
+    physics::SweepHit hit;
+    BENCH_CHECK(!physics::conservativeAdvance(radius, max_motion, distance, hit));
+}
@@ -0,0 +1,106 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestVectorMath.cpp
+//! @brief  ベクトル算術演算のテスト
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+namespace
+{
+
+//! 行列の要素ごとの最大誤差
+f32 maxError(const matrix& a, const matrix& b)
+{
+    f32 ea[16];
+    f32 eb[16];
+    store(a, ea);
+    store(b, eb);
+
+    f32 error = 0.0f;
+    for(u32 i = 0; i < 16; ++i)
+        error = std::max(error, std::abs(ea[i] - eb[i]));
+    return error;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 軸回転と任意軸回転が一致する
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_rotate_axis)
+{
+    for(f32 radian : {-2.5f, -0.3f, 0.0f, 0.7f, 3.0f}) {
+        BENCH_CHECK(maxError(matrix::rotateX(radian), matrix::rotateAxis(float3(1.0f, 0.0f, 0.0f), radian)) < 1e-6f);
+        BENCH_CHECK(maxError(matrix::rotateY(radian), matrix::rotateAxis(float3(0.0f, 1.0f, 0.0f), radian)) < 1e-6f);
+        BENCH_CHECK(maxError(matrix::rotateZ(radian), matrix::rotateAxis(float3(0.0f, 0.0f, 1.0f), radian)) < 1e-6f);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 行列は行ベクトル(v * M)で適用する。Y軸+90度でX軸はZ軸の負方向へ向く (左手座標系)
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_row_vector)
+{
+    matrix m = mul(matrix::rotateY(1.5707963f), matrix::translate(1.0f, 2.0f, 3.0f));
+
+    float4 p = mul(float4(1.0f, 0.0f, 0.0f, 1.0f), m);
+    BENCH_CHECK(std::abs(p.x - 1.0f) < 1e-6f);
+    BENCH_CHECK(std::abs(p.y - 2.0f) < 1e-6f);
+    BENCH_CHECK(std::abs(p.z - 2.0f) < 1e-6f);
+    BENCH_CHECK(all(m.translate() == float3(1.0f, 2.0f, 3.0f)));
+}
+
+//---------------------------------------------------------------------------
+//! TRSの分解・合成の往復
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_trs_roundtrip)
+{
+    matrix m = mul(mul(matrix::scale(0.5f, 2.0f, 1.5f), matrix::rotateAxis(float3(1.0f, 2.0f, 3.0f), 0.8f)),
+                   matrix::translate(-3.0f, 4.0f, 5.0f));
+
+    TRS trs = TRS::fromMatrix(m);
+    BENCH_CHECK(std::abs(trs.scale_.x - 0.5f) < 1e-5f);
+    BENCH_CHECK(std::abs(trs.scale_.y - 2.0f) < 1e-5f);
+    BENCH_CHECK(std::abs(trs.scale_.z - 1.5f) < 1e-5f);
+    BENCH_CHECK(maxError(trs.toMatrix(), m) < 1e-5f);
+}
+
+//---------------------------------------------------------------------------
+//! オイラー角はImGuizmoと同じ X→Y→Z の回転順 (Rx * Ry * Rz)
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_euler_convention)
+{
+    const float3 angles[] = {
+        { 30.0f,   0.0f,   0.0f},
+        {  0.0f,  45.0f,   0.0f},
+        {  0.0f,   0.0f, -60.0f},
+        { 10.0f,  20.0f,  30.0f},
+        {-75.0f,  60.0f, 150.0f},
+        {170.0f, -80.0f, -20.0f},
+    };
+
+    for(auto& xyz : angles) {
+        matrix expected = mul(mul(matrix::rotateX(D2R(xyz.x)), matrix::rotateY(D2R(xyz.y))), matrix::rotateZ(D2R(xyz.z)));
+
+        TRS trs;
+        trs.rotate_ = EulerAxisXYZToQuaternion(xyz);
+        BENCH_CHECK(maxError(trs.toMatrix(), expected) < 1e-5f);
+
+        // 分解した角度は同じ回転を表す
+        float3 result = QuaternionToEulerAxisXYZ(trs.rotate_);
+        trs.rotate_   = EulerAxisXYZToQuaternion(result);
+        BENCH_CHECK(maxError(trs.toMatrix(), expected) < 1e-5f);
+    }
+
+    // 3軸の絶対値の和が240度以下であれば同じ角度に戻る
+    // それを超える場合はImGuizmoの分解に合わせて (x+180, 180-y, z+180) の表現になる
+    float3 small = QuaternionToEulerAxisXYZ(EulerAxisXYZToQuaternion(float3(10.0f, 20.0f, 30.0f)));
+    BENCH_CHECK(static_cast<f32>(length(small - float3(10.0f, 20.0f, 30.0f))) < 1e-2f);
+
+    float3 flipped = QuaternionToEulerAxisXYZ(EulerAxisXYZToQuaternion(float3(-75.0f, 60.0f, 150.0f)));
+    BENCH_CHECK(static_cast<f32>(length(flipped - float3(105.0f, 120.0f, -30.0f))) < 1e-2f);
+
+    // 分解結果は各軸 -180～180度
+    float3 wrapped = QuaternionToEulerAxisXYZ(EulerAxisXYZToQuaternion(float3(0.0f, 0.0f, 270.0f)));
+    BENCH_CHECK(static_cast<f32>(length(wrapped - float3(0.0f, 0.0f, -90.0f))) < 1e-2f);
+}
+
@@ -0,0 +1,264 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestVectorMathBatch.cpp
+//! @brief  ベクトル算術演算 (配列の一括処理) のテスト
+//!
+//! 各命令セットの結果をスカラー実装と比較します。
+//! SIMD幅で割り切れない端数を含むよう、要素数は奇数も使用します
+//---------------------------------------------------------------------------
+#include "Check.h"
+
+#include <System/VectorMathBatch.h>
+#include <random>
+
+namespace
+{
+
+constexpr f32    TOLERANCE   = 1e-4f;                                //!< スカラー実装との許容誤差
+constexpr size_t COUNTS[]    = {0, 1, 2, 3, 7, 8, 9, 17};            //!< 検証する要素数
+constexpr size_t MAX_COUNT   = 17;                                   //!< 最大要素数
+const simd::Isa  SIMD_ISAS[] = {simd::Isa::SSE, simd::Isa::AVX};   //!< スカラー実装と比較する命令セット
+
+f32 random(std::mt19937& rng, f32 min_value, f32 max_value)
+{
+    return std::uniform_real_distribution<f32>(min_value, max_value)(rng);
+}
+
+float3 randomFloat3(std::mt19937& rng, f32 range)
+{
+    return float3(random(rng, -range, range), random(rng, -range, range), random(rng, -range, range));
+}
+
+f32 error3(const float3& a, const float3& b)
+{
+    return static_cast<f32>(length(a - b));
+}
+
+f32 error4x4(const matrix& a, const matrix& b)
+{
+    f32 ea[16];
+    f32 eb[16];
+    store(a, ea);
+    store(b, eb);
+
+    f32 error = 0.0f;
+    for(u32 i = 0; i < 16; ++i)
+        error = std::max(error, std::abs(ea[i] - eb[i]));
+    return error;
+}
+
+//! 平行移動・回転・非一様スケールを含む行列
+matrix randomMatrix(std::mt19937& rng)
+{
+    TRS trs;
+    trs.translate_ = randomFloat3(rng, 10.0f);
+    trs.rotate_    = quaternion::rotation_euler_zxy(randomFloat3(rng, 3.0f));
+    trs.scale_     = float3(random(rng, 0.5f, 2.0f), random(rng, 0.5f, 2.0f), random(rng, 0.5f, 2.0f));
+    return trs.toMatrix();
+}
+
+//! 命令セットごとに処理を実行し、終了後に既定の命令セットへ戻す
+template <class Func>
+void forEachIsa(Func&& func)
+{
+    for(simd::Isa isa : SIMD_ISAS) {
+        if(!simd::isSupported(isa))
+            continue;
+        func(isa);
+    }
+    simd::setIsa(simd::Isa::AVX);
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 命令セットの切り替え (利用できない命令セットは利用可能な最上位に制限)
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_batch_set_isa)
+{
+    BENCH_CHECK(simd::isSupported(simd::Isa::Scalar));
+    BENCH_CHECK(simd::isSupported(simd::Isa::SSE));
+
+    BENCH_CHECK(simd::setIsa(simd::Isa::Scalar) == simd::Isa::Scalar);
+    BENCH_CHECK(simd::activeIsa() == simd::Isa::Scalar);
+
+    simd::Isa best = simd::setIsa(simd::Isa::AVX);
+    BENCH_CHECK(best == (simd::isSupported(simd::Isa::AVX) ? simd::Isa::AVX : simd::Isa::SSE));
+    BENCH_CHECK(simd::activeIsa() == best);
+}
+
+//---------------------------------------------------------------------------
+//! 座標/AABBの一括変換がスカラー実装と一致する (入出力が同じ配列でもよい)
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_batch_transform)
+{
+    std::mt19937 rng(38);
+
+    const matrix m = randomMatrix(rng);
+
+    std::vector<float3>     points(MAX_COUNT);
+    std::vector<simd::AABB> boxes(MAX_COUNT);
+    std::vector<matrix>     pair_matrices(MAX_COUNT);
+    for(size_t i = 0; i < MAX_COUNT; ++i) {
+        points[i]        = randomFloat3(rng, 10.0f);
+        boxes[i].min_    = randomFloat3(rng, 10.0f);
+        boxes[i].max_    = boxes[i].min_ + abs(randomFloat3(rng, 2.0f));
+        pair_matrices[i] = randomMatrix(rng);
+    }
+    std::vector<float3> pair_points(MAX_COUNT * 2);
+    for(auto& p : pair_points)
+        p = randomFloat3(rng, 10.0f);
+
+    for(size_t count : COUNTS) {
+        // スカラー実装の結果
+        simd::setIsa(simd::Isa::Scalar);
+        std::vector<float3>     expected_points(count);
+        std::vector<simd::AABB> expected_boxes(count);
+        std::vector<float3>     expected_pairs(count * 2);
+        simd::transformPoints(m, points.data(), expected_points.data(), count);
+        simd::transformAABBs(m, boxes.data(), expected_boxes.data(), count);
+        simd::transformPointPairs(pair_matrices.data(), pair_points.data(), expected_pairs.data(), count);
+
+        forEachIsa([&](simd::Isa isa) {
+            simd::setIsa(isa);
+
+            // float3の配列 (入出力が同じ配列)
+            std::vector<float3> world_points(points.begin(), points.begin() + count);
+            simd::transformPoints(m, world_points.data(), world_points.data(), count);
+
+            // xyzを詰めた配列
+            std::vector<f32> packed(count * 3);
+            for(size_t i = 0; i < count; ++i)
+                store(points[i], packed.data() + i * 3);
+            simd::transformPoints(m, packed.data(), packed.data(), count);
+
+            std::vector<simd::AABB> world_boxes(count);
+            simd::transformAABBs(m, boxes.data(), world_boxes.data(), count);
+
+            std::vector<float3> world_pairs(pair_points.begin(), pair_points.begin() + count * 2);
+            simd::transformPointPairs(pair_matrices.data(), world_pairs.data(), world_pairs.data(), count);
+
+            f32 max_error = 0.0f;
+            for(size_t i = 0; i < count; ++i) {
+                float3 p(packed[i * 3 + 0], packed[i * 3 + 1], packed[i * 3 + 2]);
+                max_error = std::max(max_error, error3(world_points[i], expected_points[i]));
+                max_error = std::max(max_error, error3(p, expected_points[i]));
+                max_error = std::max(max_error, error3(world_boxes[i].min_, expected_boxes[i].min_));
+                max_error = std::max(max_error, error3(world_boxes[i].max_, expected_boxes[i].max_));
+                max_error = std::max(max_error, error3(world_pairs[i * 2 + 0], expected_pairs[i * 2 + 0]));
+                max_error = std::max(max_error, error3(world_pairs[i * 2 + 1], expected_pairs[i * 2 + 1]));
+            }
+            bench::check(max_error < TOLERANCE,
+                         std::string(simd::isaName(isa)) + " n" + std::to_string(count),
+                         "max error " + std::to_string(max_error));
+        });
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 行列の積/TRS→行列の一括計算がスカラー実装と一致する
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_batch_matrices)
+{
+    std::mt19937 rng(380);
+
+    const matrix parent = randomMatrix(rng);
+
+    std::vector<TRS>        transforms(MAX_COUNT);
+    std::vector<quaternion> rotations(MAX_COUNT);
+    std::vector<matrix>     lefts(MAX_COUNT);
+    std::vector<matrix>     rights(MAX_COUNT);
+    for(size_t i = 0; i < MAX_COUNT; ++i) {
+        transforms[i].translate_ = randomFloat3(rng, 10.0f);
+        transforms[i].rotate_    = quaternion::rotation_euler_zxy(randomFloat3(rng, 3.0f));
+        transforms[i].scale_     = float3(random(rng, 0.5f, 2.0f), random(rng, 0.5f, 2.0f), random(rng, 0.5f, 2.0f));
+        rotations[i]             = transforms[i].rotate_;
+        lefts[i]                 = randomMatrix(rng);
+        rights[i]                = randomMatrix(rng);
+    }
+
+    for(size_t count : COUNTS) {
+        simd::setIsa(simd::Isa::Scalar);
+        std::vector<matrix> expected_trs(count);
+        std::vector<matrix> expected_rotations(count);
+        std::vector<matrix> expected_products(count);
+        std::vector<matrix> expected_parented(count);
+        simd::toMatrices(transforms.data(), expected_trs.data(), count);
+        simd::toMatrices(rotations.data(), expected_rotations.data(), count);
+        simd::multiplyMatrices(lefts.data(), rights.data(), expected_products.data(), count);
+        simd::multiplyMatrices(lefts.data(), parent, expected_parented.data(), count);
+
+        // TRS::toMatrix()とも一致する
+        f32 trs_error = 0.0f;
+        for(size_t i = 0; i < count; ++i)
+            trs_error = std::max(trs_error, error4x4(expected_trs[i], transforms[i].toMatrix()));
+        bench::check(trs_error < TOLERANCE, "scalar n" + std::to_string(count), "differs from TRS::toMatrix()");
+
+        forEachIsa([&](simd::Isa isa) {
+            simd::setIsa(isa);
+
+            std::vector<matrix> trs(count);
+            std::vector<matrix> rotation(count);
+            simd::toMatrices(transforms.data(), trs.data(), count);
+            simd::toMatrices(rotations.data(), rotation.data(), count);
+
+            // 入出力が同じ配列
+            std::vector<matrix> products(lefts.begin(), lefts.begin() + count);
+            std::vector<matrix> parented(lefts.begin(), lefts.begin() + count);
+            simd::multiplyMatrices(products.data(), rights.data(), products.data(), count);
+            simd::multiplyMatrices(parented.data(), parent, parented.data(), count);
+
+            f32 max_error = 0.0f;
+            for(size_t i = 0; i < count; ++i) {
+                max_error = std::max(max_error, error4x4(trs[i], expected_trs[i]));
+                max_error = std::max(max_error, error4x4(rotation[i], expected_rotations[i]));
+                max_error = std::max(max_error, error4x4(products[i], expected_products[i]));
+                max_error = std::max(max_error, error4x4(parented[i], expected_parented[i]));
+            }
+            bench::check(max_error < TOLERANCE,
+                         std::string(simd::isaName(isa)) + " n" + std::to_string(count),
+                         "max error " + std::to_string(max_error));
+        });
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 三角形の外積の長さの2乗 (縮退三角形は0)
+//---------------------------------------------------------------------------
+BENCH_TEST(vecmath_batch_triangle_cross)
+{
+    std::mt19937 rng(3800);
+
+    // 頂点配列の末尾の頂点も参照する (12byteを超えて読み込まない)
+    std::vector<f32> positions(MAX_COUNT * 3 * 3);
+    for(auto& p : positions)
+        p = random(rng, -5.0f, 5.0f);
+    u32 vertex_count = static_cast<u32>(positions.size() / 3);
+
+    std::vector<u32> indices(MAX_COUNT * 3);
+    for(size_t i = 0; i < indices.size(); ++i)
+        indices[i] = static_cast<u32>(vertex_count - 1 - i);
+    // 同じ頂点を2回参照する縮退三角形
+    indices[4] = indices[3];
+
+    for(size_t count : COUNTS) {
+        simd::setIsa(simd::Isa::Scalar);
+        std::vector<f32> expected(count);
+        simd::triangleCrossLengthsSq(positions.data(), indices.data(), expected.data(), count);
+        if(count > 1)
+            BENCH_CHECK(expected[1] == 0.0f);
+
+        forEachIsa([&](simd::Isa isa) {
+            simd::setIsa(isa);
+
+            std::vector<f32> result(count);
+            simd::triangleCrossLengthsSq(positions.data(), indices.data(), result.data(), count);
+
+            f32 max_error = 0.0f;
+            for(size_t i = 0; i < count; ++i)
+                max_error = std::max(max_error, std::abs(result[i] - expected[i]) / std::max(1.0f, expected[i]));
+            bench::check(max_error < TOLERANCE,
+                         std::string(simd::isaName(isa)) + " n" + std::to_string(count),
+                         "max error " + std::to_string(max_error));
+        });
+    }
+}
@@ -28,9 +28,14 @@ function config_solution(name)
 
 
 	filter "platforms:x64"
-	    system "Windows"
 	    architecture "x64"
 
+	-- テスト(Test)はLinuxでもビルドするため、Linux向け生成時はWindowsに固定しない
+	if not os.istarget("linux") then
+		filter "platforms:x64"
+		    system "Windows"
+	end
+
 	filter {}	-- 元に戻す
 end
 
@@ -74,18 +79,22 @@ function config_project(name, kind_type)
  	}
 
 	-- リンカーの追加オプション
-	linkoptions {
-		"/IGNORE:4099"
-	}
+	filter "system:windows"
+		linkoptions {
+			"/IGNORE:4099"
+		}
+	filter {}
   
 	-- プリプロセッサ #define
-    defines {
-	--	"_CRT_SECURE_NO_WARNINGS",
-		"WIN64",
-		"WIN32",
-		"_WIN32",
-		"_WINDOWS"
-	}
+	filter "system:windows"
+	    defines {
+		--	"_CRT_SECURE_NO_WARNINGS",
+			"WIN64",
+			"WIN32",
+			"_WIN32",
+			"_WINDOWS"
+		}
+	filter {}
 	filter { "kind:StaticLib" }
 		defines { "_LIB" }
 	filter { "kind:SharedLib" }
@@ -108,7 +117,6 @@ function config_project(name, kind_type)
 	    defines {
 			"_DEBUG",
 			"DEBUG",
-			"_WINDOWS"
 		}
 
 	    optimize             "Off"
@@ -117,6 +125,10 @@ function config_project(name, kind_type)
 		functionlevellinking "On"
 		editandcontinue      "Off"
 
+	filter { "configurations:Debug", "system:windows" }
+	    defines {
+			"_WINDOWS"
+		}
 		buildoptions {
 			"/Zo",	-- 最適化されたデバッグ機能の強化
 		}
@@ -128,6 +140,7 @@ function config_project(name, kind_type)
 	    defines {
 			"NDEBUG",
 		}
+	filter { "configurations:Release*", "system:windows" }
 		buildoptions {
 			"/GT",	-- ファイバー保護の最適化
 		}
@@ -142,6 +155,7 @@ function config_project(name, kind_type)
 	    defines {
 			"PROFILE",
 		}
+	filter { "configurations:Release", "system:windows" }
 		buildoptions {
 			"/Zo",	-- 最適化されたデバッグ機能の強化
 		}
@@ -12,9 +12,11 @@ config_solution("BaseProject")
 	--	"_ITERATOR_DEBUG_LEVEL=0",	-- イテレーターのデバッグを高速化(他のライブラリと干渉する場合は削除)
 	}
 
-	buildoptions {
-		"/permissive-",
-	}
+	filter "system:windows"
+		buildoptions {
+			"/permissive-",
+		}
+	filter {}
 	
 	-- リンカー警告抑制
 	linkoptions {
@@ -22,9 +24,14 @@ config_solution("BaseProject")
 
 	filter "configurations:Debug"
 	   	defines {
+			"USE_PROFILER",			-- CPUプロファイラー有効
+			"JPH_EXTERNAL_PROFILE",	-- JoltPhysicsの計測区間をプロファイラーへ統合
 		}
+	-- Releaseはプロファイル用の構成(PROFILE)。出荷用のReleaseLTCGではプロファイラーを除去する
 	filter "configurations:Release"
 	   	defines {
+			"USE_PROFILER",			-- CPUプロファイラー有効
+			"JPH_EXTERNAL_PROFILE",	-- JoltPhysicsの計測区間をプロファイラーへ統合
 		}
 
 	filter ""
@@ -423,3 +430,162 @@ config_project("BaseProject", "WindowedApp")
 		"JoltPhysics",
 		"meshoptimizer",
 	}
+
+-----------------------------------------------------------------
+-- ベンチマーク (ヘッドレス実行)
+-- ウィンドウ/描画なしでシーン・オブジェクト・コリジョン・物理を計測します
+-----------------------------------------------------------------
+config_project("Benchmark", "ConsoleApp")
+
+	local SOURCE_PATH = "src"
+	local BENCH_PATH  = "bench"
+	local DXLIB_PATH  = "dxlib"
+	local SAMPLE_PATH = "src/Sample"
+
+	entrypoint "mainCRTStartup"
+	debugdir  "."		-- 実行開始時のカレントディレクトリ
+
+    nuget {
+		'AssimpCpp:5.0.1.6',	-- Assimp
+	}
+
+	-- 追加するソースコード
+	-- WinMain.cppを除いたエンジン本体とベンチマーク
+    	files {
+		path.join(SOURCE_PATH, "**.h"),
+		path.join(SOURCE_PATH, "**.inl"),
+		path.join(SOURCE_PATH, "**.cpp"),
+
+		path.join(BENCH_PATH, "**.h"),
+		path.join(BENCH_PATH, "**.cpp"),
+	}
+	removefiles {
+		path.join(SOURCE_PATH, "WinMain.cpp"),
+		path.join(BENCH_PATH, "TestMain.cpp"),
+		path.join(BENCH_PATH, "TestPrecompile.h"),
+	}
+
+	-- "" インクルードパス
+	includedirs {
+		SOURCE_PATH,
+		BENCH_PATH,
+		DXLIB_PATH,				-- DXライブラリ Effekseer
+		IMGUI_PATH,				-- ImGui
+		"opensource",			-- オープンソース
+		"opensource/cereal/include",
+		"opensource/JoltPhysics",
+		SAMPLE_PATH,
+	}
+
+	-- ライブラリディレクトリ
+	libdirs {
+		DXLIB_PATH,					-- DXライブラリ Effekseer
+	}
+
+	-- プリプロセッサ #define
+   	defines {
+	"_DISABLE_EXTENDED_ALIGNED_STORAGE",
+	}
+
+	-- プリコンパイル済ヘッダー
+	pchheader "Precompile.h"
+	pchsource (path.join(SOURCE_PATH, "Precompile.cpp"))
+	forceincludes "Precompile.h"
+
+	-- フォルダ分け
+	vpaths {
+		["ベンチマーク/*"] = {
+			path.join(BENCH_PATH, "**.h"),
+			path.join(BENCH_PATH, "**.cpp"),
+		},
+		["ヘッダー ファイル/*"] = {
+			path.join(SOURCE_PATH, "**.h"),
+			path.join(SOURCE_PATH, "**.hxx"),
+			path.join(SOURCE_PATH, "**.hpp"),
+			path.join(SOURCE_PATH, "**.inl")
+		},
+		["ソース ファイル/*"] = {
+			path.join(SOURCE_PATH, "**.c"),
+			path.join(SOURCE_PATH, "**.cxx"),
+			path.join(SOURCE_PATH, "**.cpp")
+		},
+	}
+
+	links {
+		"ImGui",
+		"ImGuizmo",
+		"implot",
+		"JoltPhysics",
+		"meshoptimizer",
+	}
+
+-----------------------------------------------------------------
+-- テスト (DxLibに依存しないモジュールの単体テスト)
+-- 失敗した検証があれば終了コード1を返します。Linuxでもビルド・実行できます
+--   premake5 --os=linux gmake2 && make -C .build Test config=release_x64
+-----------------------------------------------------------------
+config_project("Test", "ConsoleApp")
+
+	local SOURCE_PATH = "src"
+	local BENCH_PATH  = "bench"
+
+	entrypoint "mainCRTStartup"
+	debugdir  "."		-- 実行開始時のカレントディレクトリ
+
+	-- 追加するソースコード
+	-- エンジン本体からはDxLibに依存しないソースのみ共有する
+    	files {
+		path.join(BENCH_PATH, "Check.h"),
+		path.join(BENCH_PATH, "Check.cpp"),
+		path.join(BENCH_PATH, "TestPrecompile.h"),
+		path.join(BENCH_PATH, "Test*.cpp"),
+
+		path.join(SOURCE_PATH, "System/Typedef.h"),
+		path.join(SOURCE_PATH, "System/VectorMath.h"),
+		path.join(SOURCE_PATH, "System/VectorMath.cpp"),
+		path.join(SOURCE_PATH, "System/VectorMathBatch.h"),
+		path.join(SOURCE_PATH, "System/VectorMathBatch.cpp"),
+		path.join(SOURCE_PATH, "System/CommandQueue.h"),
+		path.join(SOURCE_PATH, "System/Physics/Sweep.h"),
+		path.join(SOURCE_PATH, "System/Physics/Sweep.cpp"),
+		path.join(SOURCE_PATH, "System/Graphics/ShaderCache.h"),
+		path.join(SOURCE_PATH, "System/Graphics/ShaderCache.cpp"),
+		path.join(SOURCE_PATH, "System/Graphics/StreamingManager.h"),
+		path.join(SOURCE_PATH, "System/Graphics/StreamingManager.cpp"),
+		path.join(SOURCE_PATH, "System/Graphics/RenderQueue.h"),
+		path.join(SOURCE_PATH, "System/Graphics/RenderQueue.cpp"),
+		path.join(SOURCE_PATH, "System/FileWatcher.h"),
+		path.join(SOURCE_PATH, "System/FileWatcher.cpp"),
+	}
+
+	-- "" インクルードパス
+	includedirs {
+		SOURCE_PATH,
+		BENCH_PATH,
+		"opensource",			-- オープンソース
+	}
+
+	-- 共通ヘッダー
+	forceincludes "TestPrecompile.h"
+
+	-- フォルダ分け
+	vpaths {
+		["テスト/*"] = {
+			path.join(BENCH_PATH, "**.h"),
+			path.join(BENCH_PATH, "**.cpp"),
+		},
+		["ヘッダー ファイル/*"] = {
+			path.join(SOURCE_PATH, "**.h"),
+		},
+		["ソース ファイル/*"] = {
+			path.join(SOURCE_PATH, "**.cpp"),
+		},
+	}
+
+	-- libstdc++の並列アルゴリズム(std::execution::par。ShaderCacheなど)はTBBで実装されているためリンクが必要
+	filter "system:linux"
+		links {
+			"pthread",
+			"tbb",
+		}
+	filter {}
@@ -77,33 +77,12 @@ using namespace hlslpp;
 #include "System/Input/InputMouse.h"
 #include "System/Graphics/Render.h"
 #include "System/Graphics/Shader.h"
+#include "System/Graphics/StreamingManager.h"
 #include "System/Graphics/Texture.h"
+#include "System/Graphics/TexturePool.h"
+#include "System/Graphics/RenderQueue.h"
 #include "System/Graphics/Model.h"
 
-//--------------------------------------------------------------
-// 数学定数
-//--------------------------------------------------------------
-static constexpr f32 PI       = 3.141592653589793f;   //!< 円周率 π
-static constexpr f32 TAU      = 2.0f * PI;            //!< 円周率の2倍 τ
-static constexpr f32 RadToDeg = 57.29577951f;         //!< Radian→Degree 変換係数
-static constexpr f32 DegToRad = 0.017453293f;         //!< Degree→Radian 変換係数
-
-//! Radian→Degree 単位変換
-//! @param  [in]    radian  ラジアン値 (弧度法)
-//! @return degree値 (度数法)
-inline f32 R2D(f32 radian)
-{
-    return radian * RadToDeg;
-}
-
-//! Degree→Radian 単位変換
-//! @param  [in]    degree  角度 (度数法)
-//! @return radian値 (弧度法)
-inline f32 D2R(f32 degree)
-{
-    return degree * DegToRad;
-}
-
 #define BLACK   GetColor(0, 0, 0)
 #define WHITE   GetColor(255, 255, 255)
 #define RED     GetColor(255, 0, 0)
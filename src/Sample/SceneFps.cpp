@@ -59,7 +59,7 @@ bool SceneFps::Init()
     //-------------------------------------------------------
     // 照準
     //-------------------------------------------------------
-    tex_crosschairs_ = std::make_shared<Texture>("data/Sample/FPS_Crosschairs/crosshairs64.png");
+    tex_crosschairs_ = LoadTexture("data/Sample/FPS_Crosschairs/crosshairs64.png");
 
     //-------------------------------------------------------
     // モデル
@@ -69,11 +69,11 @@ bool SceneFps::Init()
         model_ = std::make_shared<Model>("data/Sample/FPS_Hands/FPS_Hands_v2.9x.mv1");
 
         // テクスチャ
-        tex_diffuse_  = std::make_shared<Texture>("data/Sample/FPS_Hands/Textures_V2/Diffuse_V2.dds");
-        tex_specular_ = std::make_shared<Texture>("data/Sample/FPS_Hands/Textures_V2/Specular_V2.dds");
-        tex_albedo_   = std::make_shared<Texture>("data/Sample/FPS_Hands/Textures_V2/Albedo_V2.dds");
-        tex_normal_   = std::make_shared<Texture>("data/Sample/FPS_Hands/Textures_V2/Normal_map_V2.dds");
-        tex_ao_       = std::make_shared<Texture>("data/Sample/FPS_Hands/Textures_V2/AO.dds");
+        tex_diffuse_  = LoadTexture("data/Sample/FPS_Hands/Textures_V2/Diffuse_V2.dds");
+        tex_specular_ = LoadTexture("data/Sample/FPS_Hands/Textures_V2/Specular_V2.dds");
+        tex_albedo_   = LoadTexture("data/Sample/FPS_Hands/Textures_V2/Albedo_V2.dds");
+        tex_normal_   = LoadTexture("data/Sample/FPS_Hands/Textures_V2/Normal_map_V2.dds");
+        tex_ao_       = LoadTexture("data/Sample/FPS_Hands/Textures_V2/AO.dds");
 
         // モデルに設定されているテクスチャを上書き
         model_->overrideTexture(Model::TextureType::Diffuse, tex_diffuse_);
@@ -87,15 +87,15 @@ bool SceneFps::Init()
         model_knife_ = std::make_shared<Model>("data/Sample/FPS_Knife/Knife_low.mv1");
 
         // テクスチャ
-        tex_kn0_albedo_    = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Iron.001_BaseColor.png");
-        tex_kn0_normal_    = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Iron.001_NormalOpenGLl.png");
-        tex_kn0_roughness_ = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Iron.001_Roughness.png");
-        tex_kn0_metalness_ = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Iron.001_Metallic.png");
-
-        tex_kn1_albedo_    = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Lever.001_BaseColor.png");
-        tex_kn1_normal_    = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Lever.001_NormalOpenGLl.png");
-        tex_kn1_roughness_ = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Lever.001_Roughness.png");
-        tex_kn1_metalness_ = std::make_shared<Texture>("data/Sample/FPS_Knife/Knife_low_Lever.001_Metallic.png");
+        tex_kn0_albedo_    = LoadTexture("data/Sample/FPS_Knife/Knife_low_Iron.001_BaseColor.png");
+        tex_kn0_normal_    = LoadTexture("data/Sample/FPS_Knife/Knife_low_Iron.001_NormalOpenGLl.png");
+        tex_kn0_roughness_ = LoadTexture("data/Sample/FPS_Knife/Knife_low_Iron.001_Roughness.png");
+        tex_kn0_metalness_ = LoadTexture("data/Sample/FPS_Knife/Knife_low_Iron.001_Metallic.png");
+
+        tex_kn1_albedo_    = LoadTexture("data/Sample/FPS_Knife/Knife_low_Lever.001_BaseColor.png");
+        tex_kn1_normal_    = LoadTexture("data/Sample/FPS_Knife/Knife_low_Lever.001_NormalOpenGLl.png");
+        tex_kn1_roughness_ = LoadTexture("data/Sample/FPS_Knife/Knife_low_Lever.001_Roughness.png");
+        tex_kn1_metalness_ = LoadTexture("data/Sample/FPS_Knife/Knife_low_Lever.001_Metallic.png");
     }
 
     // 背景
@@ -138,8 +138,9 @@ void SceneFps::Update([[maybe_unused]] float delta)
 
     {
         // マウスカーソル座標(ウインドウのクライアント領域の座標)を取得
-        s32 x, y;
-        GetMousePoint(&x, &y);
+        // 入力の記録/再生に対応するため、InputMouseUpdate()で取得済みの座標を使う
+        s32 x = GetMouseX();
+        s32 y = GetMouseY();
 
         static s32 mouse_x = x;
         static s32 mouse_y = y;
@@ -158,10 +159,13 @@ void SceneFps::Update([[maybe_unused]] float delta)
 
             // マウスカーソル位置を画面中央に戻す
             SetMousePoint(WINDOW_W / 2, WINDOW_H / 2);
+            x = WINDOW_W / 2;
+            y = WINDOW_H / 2;
         }
 
         // 値を次のフレームのために保存
-        GetMousePoint(&mouse_x, &mouse_y);
+        mouse_x = x;
+        mouse_y = y;
     }
 
     //----------------------------------------------------------
@@ -103,28 +103,32 @@ void ScenePhysics::Update([[maybe_unused]] float delta)
 //---------------------------------------------------------------------------
 void ScenePhysics::Draw()
 {
-    // モデル
+    // モデル (フレームの描画キューへ登録してステート順にまとめて描画)
     for(u32 i = 0; i < rigid_bodies_.size(); ++i) {
         auto* rigid_body = rigid_bodies_[i].get();
 
         switch(rigid_body->data()) {
         case 0:
-            model_boxes1_[i]->render();
+            model_boxes1_[i]->submit(GetRenderQueue());
             break;
         case 1:
-            model_boxes2_[i]->render();
+            model_boxes2_[i]->submit(GetRenderQueue());
             break;
         case 2:
-            model_barrel_[i]->render();
+            model_barrel_[i]->submit(GetRenderQueue());
             break;
         case 3:
-            model_cone_[i]->render();
+            model_cone_[i]->submit(GetRenderQueue());
             break;
         default:
             break;
         }
     }
 
+    // 文字より先に描画するためここで実行する
+    GetRenderQueue().execute(Model::executor());
+    GetRenderQueue().clear();
+
     DrawFormatString(100, 50, GetColor(255, 255, 255), "Physics Demo");
 
     {
@@ -184,11 +188,11 @@ void ScenePhysics::ResetPhysics()
         std::string path = "data/Sample/Sci-fi_Box/Textures/";
 
         // PBRテクスチャで上書き
-        auto tex_albedo_    = std::make_shared<Texture>(path + "DefaultMaterial_Base_color.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "DefaultMaterial_Normal_DirectX.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "DefaultMaterial_Roughness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "DefaultMaterial_Metallic.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "DefaultMaterial_Mixed_AO.png");
+        auto tex_albedo_    = LoadTexture(path + "DefaultMaterial_Base_color.png");
+        auto tex_normal_    = LoadTexture(path + "DefaultMaterial_Normal_DirectX.png");
+        auto tex_roughness_ = LoadTexture(path + "DefaultMaterial_Roughness.png");
+        auto tex_metalness_ = LoadTexture(path + "DefaultMaterial_Metallic.png");
+        auto tex_ao_        = LoadTexture(path + "DefaultMaterial_Mixed_AO.png");
 
         for(s32 y = 0; y < HEIGHT; ++y) {
             for(s32 x = 0; x < WIDTH; ++x) {
@@ -210,11 +214,11 @@ void ScenePhysics::ResetPhysics()
     {
         std::string path = "data/Sample/Sci-fi_Container/Textures/";
 
-        auto tex_albedo_    = std::make_shared<Texture>(path + "Sci-fi_Box_AlbedoTransparency.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "Sci-fi_Box_Normal_DirectX.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "Sci-fi_Box_MetallicSmoothness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "Sci-fi_Box_MetallicSmoothness.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "Sci-fi_Box_AO.png");
+        auto tex_albedo_    = LoadTexture(path + "Sci-fi_Box_AlbedoTransparency.png");
+        auto tex_normal_    = LoadTexture(path + "Sci-fi_Box_Normal_DirectX.png");
+        auto tex_roughness_ = LoadTexture(path + "Sci-fi_Box_MetallicSmoothness.png");
+        auto tex_metalness_ = LoadTexture(path + "Sci-fi_Box_MetallicSmoothness.png");
+        auto tex_ao_        = LoadTexture(path + "Sci-fi_Box_AO.png");
 
         for(s32 y = 0; y < HEIGHT; ++y) {
             for(s32 x = 0; x < WIDTH; ++x) {
@@ -236,11 +240,11 @@ void ScenePhysics::ResetPhysics()
     {
         std::string path = "data/Sample/oil_barrels_pbr/textures/";
 
-        auto tex_albedo_    = std::make_shared<Texture>(path + "drum2_base_color.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "drum2_normal.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "drum2_roughness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "drum2_metallic.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "drum2_ambient.png");
+        auto tex_albedo_    = LoadTexture(path + "drum2_base_color.png");
+        auto tex_normal_    = LoadTexture(path + "drum2_normal.png");
+        auto tex_roughness_ = LoadTexture(path + "drum2_roughness.png");
+        auto tex_metalness_ = LoadTexture(path + "drum2_metallic.png");
+        auto tex_ao_        = LoadTexture(path + "drum2_ambient.png");
 
         for(s32 y = 0; y < HEIGHT; ++y) {
             for(s32 x = 0; x < WIDTH; ++x) {
@@ -262,11 +266,11 @@ void ScenePhysics::ResetPhysics()
     {
         std::string path = "data/Sample/Traffic_Cone/";
 
-        auto tex_albedo_    = std::make_shared<Texture>(path + "Red_Dirty_Traffic Cone_Base_Color.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "Dirty_Traffic Cone_Normal_DirectX.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "Dirty_Traffic Cone_Roughness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "Dirty_Traffic Cone_Metallic.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "Dirty_Traffic Cone_AO.png");
+        auto tex_albedo_    = LoadTexture(path + "Red_Dirty_Traffic Cone_Base_Color.png");
+        auto tex_normal_    = LoadTexture(path + "Dirty_Traffic Cone_Normal_DirectX.png");
+        auto tex_roughness_ = LoadTexture(path + "Dirty_Traffic Cone_Roughness.png");
+        auto tex_metalness_ = LoadTexture(path + "Dirty_Traffic Cone_Metallic.png");
+        auto tex_ao_        = LoadTexture(path + "Dirty_Traffic Cone_AO.png");
 
         for(s32 y = 0; y < HEIGHT; ++y) {
             for(s32 x = 0; x < WIDTH; ++x) {
@@ -385,11 +385,11 @@ void ScenePhysicsLayer::ResetPhysics()
         std::string path = "data/Sample/Sci-fi_Box/Textures/";
 
         // PBRテクスチャで上書き
-        auto tex_albedo_    = std::make_shared<Texture>(path + "DefaultMaterial_Base_color.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "DefaultMaterial_Normal_DirectX.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "DefaultMaterial_Roughness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "DefaultMaterial_Metallic.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "DefaultMaterial_Mixed_AO.png");
+        auto tex_albedo_    = LoadTexture(path + "DefaultMaterial_Base_color.png");
+        auto tex_normal_    = LoadTexture(path + "DefaultMaterial_Normal_DirectX.png");
+        auto tex_roughness_ = LoadTexture(path + "DefaultMaterial_Roughness.png");
+        auto tex_metalness_ = LoadTexture(path + "DefaultMaterial_Metallic.png");
+        auto tex_ao_        = LoadTexture(path + "DefaultMaterial_Mixed_AO.png");
 
         auto model = std::make_shared<Model>("data/Sample/Sci-fi_Box/Sci-fi Box.mv1");
 
@@ -407,11 +407,11 @@ void ScenePhysicsLayer::ResetPhysics()
     {
         std::string path = "data/Sample/Sci-fi_Container/Textures/";
 
-        auto tex_albedo_    = std::make_shared<Texture>(path + "Sci-fi_Box_AlbedoTransparency.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "Sci-fi_Box_Normal_DirectX.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "Sci-fi_Box_MetallicSmoothness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "Sci-fi_Box_MetallicSmoothness.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "Sci-fi_Box_AO.png");
+        auto tex_albedo_    = LoadTexture(path + "Sci-fi_Box_AlbedoTransparency.png");
+        auto tex_normal_    = LoadTexture(path + "Sci-fi_Box_Normal_DirectX.png");
+        auto tex_roughness_ = LoadTexture(path + "Sci-fi_Box_MetallicSmoothness.png");
+        auto tex_metalness_ = LoadTexture(path + "Sci-fi_Box_MetallicSmoothness.png");
+        auto tex_ao_        = LoadTexture(path + "Sci-fi_Box_AO.png");
 
         auto model = std::make_shared<Model>("data/Sample/Sci-fi_Container/Sci-fi Container.mv1");
 
@@ -429,11 +429,11 @@ void ScenePhysicsLayer::ResetPhysics()
     {
         std::string path = "data/Sample/oil_barrels_pbr/textures/";
 
-        auto tex_albedo_    = std::make_shared<Texture>(path + "drum2_base_color.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "drum2_normal.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "drum2_roughness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "drum2_metallic.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "drum2_ambient.png");
+        auto tex_albedo_    = LoadTexture(path + "drum2_base_color.png");
+        auto tex_normal_    = LoadTexture(path + "drum2_normal.png");
+        auto tex_roughness_ = LoadTexture(path + "drum2_roughness.png");
+        auto tex_metalness_ = LoadTexture(path + "drum2_metallic.png");
+        auto tex_ao_        = LoadTexture(path + "drum2_ambient.png");
 
         auto model = std::make_shared<Model>("data/Sample/oil_barrels_pbr/barrel.mv1");
 
@@ -451,11 +451,11 @@ void ScenePhysicsLayer::ResetPhysics()
     {
         std::string path = "data/Sample/Traffic_Cone/";
 
-        auto tex_albedo_    = std::make_shared<Texture>(path + "Red_Dirty_Traffic Cone_Base_Color.png");
-        auto tex_normal_    = std::make_shared<Texture>(path + "Dirty_Traffic Cone_Normal_DirectX.png");
-        auto tex_roughness_ = std::make_shared<Texture>(path + "Dirty_Traffic Cone_Roughness.png");
-        auto tex_metalness_ = std::make_shared<Texture>(path + "Dirty_Traffic Cone_Metallic.png");
-        auto tex_ao_        = std::make_shared<Texture>(path + "Dirty_Traffic Cone_AO.png");
+        auto tex_albedo_    = LoadTexture(path + "Red_Dirty_Traffic Cone_Base_Color.png");
+        auto tex_normal_    = LoadTexture(path + "Dirty_Traffic Cone_Normal_DirectX.png");
+        auto tex_roughness_ = LoadTexture(path + "Dirty_Traffic Cone_Roughness.png");
+        auto tex_metalness_ = LoadTexture(path + "Dirty_Traffic Cone_Metallic.png");
+        auto tex_ao_        = LoadTexture(path + "Dirty_Traffic Cone_AO.png");
 
         auto model = std::make_shared<Model>("data/Sample/Traffic_Cone/Traffic Cone.mv1");
 
@@ -29,7 +29,7 @@ bool SceneShader::Init()
     filter_fade_ = obj->AddComponent<ComponentFilterFade>();
 
     // 画像の読み込み
-    texture_ = std::make_shared<Texture>("data/Shader/seafloor.dds");
+    texture_ = LoadTexture("data/Shader/seafloor.dds");
 
     // 頂点シェーダー
     shader_vs_ = std::make_shared<ShaderVs>("data/Shader/vs_3d");
@@ -79,6 +79,11 @@ bool SceneTestChangeScene::Init()
     return true;
 }
 
+void SceneTestChangeScene::Preload()
+{
+    PreloadModel("data/Sample/Player/model.mv1");
+}
+
 void SceneTestChangeScene::Update([[maybe_unused]] float delta)
 {
     if(WaitFadeIn())
@@ -97,11 +102,13 @@ void SceneTestChangeScene::Update([[maybe_unused]] float delta)
 
     // スペースを押すとシーンを切り替える
     if(IsKeyOn(KEY_INPUT_SPACE)) {
+        // フェードアウト中に次のシーンを読み込んでおきます (オブジェクトも先に作成します)
+        Scene::Preload(Scene::GetScene<SceneTestChangeScene2>(), true);
         FadeOut();
     }
 
     if(!WaitFadeOut()) {
-        // シーンを切り替えます
+        // シーンを切り替えます (読み込みが終わっていない場合は終わってから切り替わります)
         Scene::Change(Scene::GetScene<SceneTestChangeScene2>());
     }
 }
@@ -137,6 +144,11 @@ bool SceneTestChangeScene2::Init()
     return true;
 }
 
+void SceneTestChangeScene2::Preload()
+{
+    PreloadModel("data/Sample/Player/model.mv1");
+}
+
 void SceneTestChangeScene2::Update([[maybe_unused]] float delta)
 {
     if(WaitFadeIn())
@@ -154,8 +166,11 @@ void SceneTestChangeScene2::Update([[maybe_unused]] float delta)
     }
 
     // スペースを押すとシーンを切り替える
-    if(IsKeyOn(KEY_INPUT_SPACE))
+    if(IsKeyOn(KEY_INPUT_SPACE)) {
+        // フェードアウト中に次のシーンを読み込んでおきます
+        Scene::Preload(Scene::GetScene<SceneTestChangeScene>());
         FadeOut();
+    }
 
     // フェードアウトを待ちます
     if(!WaitFadeOut()) {
@@ -20,6 +20,10 @@ public:
     //! @return シーン初期化が終わったらtrueを返します
     bool Init() override;
 
+    //! @brief 先行読み込みするアセットを登録します
+    //! @detail Scene::Preload()で前のシーンの実行中に読み込んでおくことで、切り替え時の停止を防ぎます
+    void Preload() override;
+
     //! @brief シーン更新関数。ディスプレイリフレッシュレートに合わせて実行されます
     //! @param delta 1秒をベースとした1フレームの数値
     //! @detial deltaは、リフレッシュレートが違うと速度が変わってしまう部分を吸収するためにある
@@ -45,6 +49,10 @@ public:
     //! @return シーン初期化が終わったらtrueを返します
     bool Init() override;
 
+    //! @brief 先行読み込みするアセットを登録します
+    //! @detail Scene::Preload()で前のシーンの実行中に読み込んでおくことで、切り替え時の停止を防ぎます
+    void Preload() override;
+
     //! @brief シーン更新関数。ディスプレイリフレッシュレートに合わせて実行されます
     //! @param delta 1秒をベースとした1フレームの数値
     //! @detial deltaは、リフレッシュレートが違うと速度が変わってしまう部分を吸収するためにある
@@ -5,6 +5,7 @@
 #include "SceneWater.h"
 #include <System/Graphics/Model.h>
 #include <System/Component/ComponentCamera.h>
+#include <System/Physics/WaveField.h>
 
 #include "System/SystemMain.h"   // ShowGrid
 
@@ -25,79 +26,39 @@ public:
     //! @param  [in]    position    配置座標
     //! @param  [in]    scale       描画スケール(default:1.0f)
     Water(u32 width, u32 height, const float3& position, f32 scale = 1.0f)
-        : width_(width)
-        , height_(height)
+        : field_(width, height)
         , position_(position)
         , scale_(scale)
     {
-        water_height_.resize(width_ * height_);
-        water_height2_.resize(width_ * height_);
-
-        reset();
+        createBuffers();
 
         // TEST:水面中央を高くする
         if constexpr(true) {
-            water(width_ / 2, height_ / 2) = 1.0f;
+            water(width / 2, height / 2) = 1.0f;
         }
     }
 
-    //! 波をリセット
-    void reset()
+    //! デストラクタ
+    ~Water()
     {
-        // 高さを初期化
-        for(auto& x : water_height_) {
-            x = float2(0.0f, 0.0f);
+        if(handle_vb_ != -1) {
+            DeleteVertexBuffer(handle_vb_);
+        }
+        if(handle_ib_ != -1) {
+            DeleteIndexBuffer(handle_ib_);
         }
     }
 
-    //! 更新
-    void update([[maybe_unused]] f32 dt)
-    {
-        constexpr f32 attenuation = 0.994f;   // 減衰係数
-
-        // 波動方程式 有限差分法
-        // 波の高さの変化の加速度に定数を掛けたもの = 現在の波の高さに「ラプラシアンフィルタ」を掛けたものと等価
-        // +---+---+---+
-        // | 0 | 1 | 0 |
-        // +---+---+---+
-        // | 1 |-4 | 1 |
-        // +---+---+---+
-        // | 0 | 1 | 0 |
-        // +---+---+---+
-
-        // 二次元配列アクセスのための短縮表記
-        auto w = [&](s32 x, s32 y) { return water_height_[y * width_ + x]; };
-
-        f32 velocity2 = std::clamp(0.125f, 0.0f, 0.5f);   // 速度の2乗 [0.0f-0.5f]
-
-        for(s32 y = 1; y < height_ - 1; ++y) {
-            for(s32 x = 1; x < width_ - 1; ++x) {
-                // 中心の情報 [現在の高さ, 1フレーム前の高さ]
-                float2 center = w(x, y);
-
-                f32 neighbor = w(x + 1, y).x + w(x - 1, y).x + w(x, y + 1).x + w(x, y - 1).x;
-
-                float height = 2.0f * center.x - center.g + velocity2 * (neighbor - 4.0f * center.x);
-                center.y     = center.x;
-                center.x     = height;
-
-                // 波が立たないように少しづつ減衰させる
-                center.xy *= attenuation;
-
-                water_height2_[y * width_ + x] = center;
-            }
-        }
+    //! 波をリセット
+    void reset() { field_.reset(); }
 
-        // ダブルバッファを交換
-        std::swap(water_height_, water_height2_);
-    }
+    //! 更新
+    //! @param  [in]    dt  経過時間 (固定ステップで進めます)
+    void update(f32 dt) { field_.update(dt); }
 
     //! 描画
     void render()
     {
-        // 二次元配列アクセスのための短縮表記
-        auto w = [&](s32 x, s32 y) { return water_height_[y * width_ + x].x; };
-
         // 色を計算
         auto color = [](f32 y) {
             auto r = 0;
@@ -111,43 +72,28 @@ public:
             return GetColorU8(r, g, b, 255);
         };
 
-        std::vector<VERTEX3D> v;
+        // 頂点の高さと色のみ更新して転送
+        const f32* heights = field_.heights();
+        for(size_t i = 0; i < vertices_.size(); ++i) {
+            vertices_[i].pos.y = position_.y + heights[i];
+            vertices_[i].dif   = color(heights[i]);
+        }
+        SetVertexBufferData(0, vertices_.data(), static_cast<s32>(vertices_.size()), handle_vb_);
 
         // ライティング無効化
         SetUseLighting(false);
 
         // 水面ワイヤーフレームを描画
-        v.resize(width_);
-        for(s32 iy = 0; iy < height_; ++iy) {
-            for(s32 ix = 0; ix < width_; ++ix) {
-                f32 x = static_cast<f32>(ix) * scale_;
-                f32 z = static_cast<f32>(iy) * scale_;
-
-                float3 p = float3(x, w(ix, iy), z);
-
-                v[ix].pos = cast(position_ + p);
-                v[ix].dif = color(p.y);
-                v[ix].spc = GetColorU8(0, 0, 0, 0);
-            }
-            // LineStripで描画
-            DrawPrimitive3D(v.data(), width_, DX_PRIMTYPE_LINESTRIP, DX_NONE_GRAPH, false);
-        }
-
-        v.resize(height_);
-        for(s32 ix = 0; ix < width_; ++ix) {
-            for(s32 iy = 0; iy < height_; ++iy) {
-                f32 x = static_cast<f32>(ix) * scale_;
-                f32 z = static_cast<f32>(iy) * scale_;
-
-                float3 p = float3(x, w(ix, iy), z);
-
-                v[iy].pos = cast(position_ + p);
-                v[iy].dif = color(p.y);
-                v[iy].spc = GetColorU8(0, 0, 0, 0);
-            }
-            // LineStripで描画
-            DrawPrimitive3D(v.data(), height_, DX_PRIMTYPE_LINESTRIP, DX_NONE_GRAPH, false);
-        }
+        DrawPrimitiveIndexed3D_UseVertexBuffer2(handle_vb_,
+                                                handle_ib_,
+                                                DX_PRIMTYPE_LINELIST,
+                                                0,
+                                                0,
+                                                static_cast<s32>(vertices_.size()),
+                                                0,
+                                                static_cast<s32>(index_count_),
+                                                DX_NONE_GRAPH,
+                                                false);
 
         // 元に戻す
         SetUseLighting(true);
@@ -174,10 +120,10 @@ public:
         if(any(index.xz < 1)) {
             return false;
         }
-        if(width_ - 1 <= index.x) {
+        if(width() - 1 <= index.x) {
             return false;
         }
-        if(height_ - 1 <= index.z) {
+        if(height() - 1 <= index.z) {
             return false;
         }
 
@@ -188,26 +134,69 @@ public:
     }
 
     //! 水面の高さを参照
-    f32& water(s32 x, s32 y) { return water_height_[y * width_ + x].f32[0]; };
+    f32& water(s32 x, s32 y) { return field_.at(x, y); };
 
     //! 配列幅を取得
-    s32 width() const { return width_; }
+    s32 width() const { return static_cast<s32>(field_.width()); }
 
     //! 配列たかさを取得
-    s32 height() const { return height_; }
+    s32 height() const { return static_cast<s32>(field_.height()); }
 
     //! 位置を取得
     float3 position() const { return position_; }
 
 private:
-    s32    width_    = 0;                          //!< 配列幅
-    s32    height_   = 0;                          //!< 配列高さ
-    float3 position_ = float3(0.0f, 0.0f, 0.0f);   //!< 位置
-    f32    scale_    = 1.0f;                       //!< 全体スケール
-    f32    speed_    = 8.0f;                       //!< 速度スケール
-
-    std::vector<float2> water_height_;    //!< 水面ハイトマップ配列
-    std::vector<float2> water_height2_;   //!< 水面ハイトマップ配列
+    //! 頂点バッファとインデックスバッファを作成
+    //! @details XZ座標と接続は変化しないため、以降は頂点の高さと色のみ更新します
+    void createBuffers()
+    {
+        u32 w = field_.width();
+        u32 h = field_.height();
+
+        vertices_.resize(w * h);
+        for(u32 iy = 0; iy < h; ++iy) {
+            for(u32 ix = 0; ix < w; ++ix) {
+                f32 x = static_cast<f32>(ix) * scale_;
+                f32 z = static_cast<f32>(iy) * scale_;
+
+                auto& v = vertices_[iy * w + ix];
+                v       = {};
+                v.pos   = cast(position_ + float3(x, 0.0f, z));
+                v.norm  = VGet(0.0f, 1.0f, 0.0f);
+                v.spc   = GetColorU8(0, 0, 0, 0);
+            }
+        }
+
+        // 横方向と縦方向の線分
+        std::vector<u32> indices;
+        indices.reserve(((w - 1) * h + w * (h - 1)) * 2);
+        for(u32 iy = 0; iy < h; ++iy) {
+            for(u32 ix = 0; ix + 1 < w; ++ix) {
+                indices.push_back(iy * w + ix);
+                indices.push_back(iy * w + ix + 1);
+            }
+        }
+        for(u32 ix = 0; ix < w; ++ix) {
+            for(u32 iy = 0; iy + 1 < h; ++iy) {
+                indices.push_back(iy * w + ix);
+                indices.push_back((iy + 1) * w + ix);
+            }
+        }
+        index_count_ = static_cast<u32>(indices.size());
+
+        handle_vb_ = CreateVertexBuffer(static_cast<s32>(vertices_.size()), DX_VERTEX_TYPE_NORMAL_3D);
+        handle_ib_ = CreateIndexBuffer(static_cast<s32>(indices.size()), DX_INDEX_TYPE_32BIT);
+        SetIndexBufferData(0, indices.data(), static_cast<s32>(indices.size()), handle_ib_);
+    }
+
+private:
+    physics::WaveField    field_;                                    //!< 波動シミュレーション
+    float3                position_    = float3(0.0f, 0.0f, 0.0f);   //!< 位置
+    f32                   scale_       = 1.0f;                       //!< 全体スケール
+    std::vector<VERTEX3D> vertices_;                                 //!< 頂点 (高さと色を毎フレーム更新)
+    u32                   index_count_ = 0;                          //!< インデックス数
+    int                   handle_vb_   = -1;                         //!< [DxLib] 頂点バッファハンドル
+    int                   handle_ib_   = -1;                         //!< [DxLib] インデックスバッファハンドル
 };
 
 DEBUG_OPTIMIZE_OFF
@@ -301,8 +290,8 @@ void SceneWater::Update([[maybe_unused]] float delta)
     //---- マウスクリックした場所に波紋を起こす
     if(IsMouseRepeat(MOUSE_INPUT_LEFT)) {   // 左クリックしている間
         // マウス座標を取得
-        s32 x, y;
-        GetMousePoint(&x, &y);
+        s32 x = GetMouseX();
+        s32 y = GetMouseY();
 
         // マウス座標から画面のスクリーン座標を計算
         float2 uv              = float2(static_cast<f32>(x) / WINDOW_W, static_cast<f32>(y) / WINDOW_H);
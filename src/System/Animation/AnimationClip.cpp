@@ -0,0 +1,523 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AnimationClip.cpp
+//! @brief  スケルトンとアニメーションクリップ (エンジン側のサンプリング)
+//---------------------------------------------------------------------------
+#include "AnimationClip.h"
+
+#include <fstream>
+
+//---------------------------------------------------------------------------
+// [ファイル形式]
+//     u32 バージョン / f32 1秒あたりのキー数 / u32 キー数 / u32 差分アニメーションかどうか
+//     u32 関節数     / Track[関節数]
+//     u32 回転キー数       / f32[回転キー数×4]       (x, y, z, w)
+//     u32 平行移動キー数   / f32[平行移動キー数×3]
+//     u32 スケールキー数   / f32[スケールキー数×3]
+//---------------------------------------------------------------------------
+
+namespace animation
+{
+namespace
+{
+
+//---------------------------------------------------------------------------
+//! クォータニオンをrefと同じ半球にそろえる (内積が負の場合に符号を反転)
+//! @note   qと-qは同じ回転のため、補間や加算の前に向きをそろえる
+//---------------------------------------------------------------------------
+quaternion alignHemisphere(const quaternion& q, const quaternion& ref)
+{
+    n128 d    = _hlslpp_perm_xxxx_ps(_hlslpp_dot4_ps(q.vec, ref.vec));
+    n128 mask = _hlslpp_cmplt_ps(d, _hlslpp_setzero_ps());
+    return quaternion(_hlslpp_sel_ps(q.vec, _hlslpp_neg_ps(q.vec), mask));
+}
+
+//---------------------------------------------------------------------------
+//! 全キーが先頭と同じ値かどうか
+//---------------------------------------------------------------------------
+bool isConstantRotation(const std::vector<Pose>& frames, u32 joint)
+{
+    const auto& first = frames[0][joint].rotate_;
+    for(const auto& pose : frames) {
+        // qと-qは同じ回転
+        if(std::abs(static_cast<f32>(dot(pose[joint].rotate_, first))) < 1.0f - Clip::CONSTANT_TOLERANCE)
+            return false;
+    }
+    return true;
+}
+
+bool isConstantTranslation(const std::vector<Pose>& frames, u32 joint)
+{
+    const auto& first = frames[0][joint].translate_;
+    for(const auto& pose : frames) {
+        if(static_cast<f32>(length(pose[joint].translate_ - first)) > Clip::CONSTANT_TOLERANCE)
+            return false;
+    }
+    return true;
+}
+
+bool isConstantScale(const std::vector<Pose>& frames, u32 joint)
+{
+    const auto& first = frames[0][joint].scale_;
+    for(const auto& pose : frames) {
+        if(static_cast<f32>(length(pose[joint].scale_ - first)) > Clip::CONSTANT_TOLERANCE)
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! バイナリ書き込み/読み込み
+//---------------------------------------------------------------------------
+template <class T>
+void write(std::ofstream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool read(std::ifstream& stream, T& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream.good();
+}
+
+}   // namespace
+
+//===========================================================================
+//  Skeleton
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+Skeleton::Skeleton(std::vector<s32> parents, Pose bind_pose)
+    : parents_(std::move(parents))
+    , bind_pose_(std::move(bind_pose))
+{
+    assert(bind_pose_.empty() || bind_pose_.size() == parents_.size());
+    bind_pose_.resize(parents_.size());
+
+    // 親が先になるように深さ順で並べる
+    std::vector<u32> depth(parents_.size(), 0);
+    for(u32 joint = 0; joint < jointCount(); ++joint) {
+        for(s32 p = parents_[joint]; p >= 0; p = parents_[p])
+            depth[joint]++;
+    }
+
+    order_.resize(parents_.size());
+    for(u32 joint = 0; joint < jointCount(); ++joint)
+        order_[joint] = joint;
+
+    std::stable_sort(order_.begin(), order_.end(), [&](u32 a, u32 b) { return depth[a] < depth[b]; });
+}
+
+//---------------------------------------------------------------------------
+//! [DxLib] MV1モデルのフレーム階層から作成
+//---------------------------------------------------------------------------
+Skeleton Skeleton::fromModel(int mv1_handle)
+{
+    s32 frame_count = std::max(MV1GetFrameNum(mv1_handle), 0);
+
+    std::vector<s32> parents(frame_count);
+    Pose             bind_pose(frame_count);
+    for(s32 frame = 0; frame < frame_count; ++frame) {
+        // 親がいない場合は-2が返る
+        parents[frame]   = std::max(MV1GetFrameParent(mv1_handle, frame), -1);
+        bind_pose[frame] = TRS::fromMatrix(cast(MV1GetFrameBaseLocalMatrix(mv1_handle, frame)));
+    }
+    return Skeleton(std::move(parents), std::move(bind_pose));
+}
+
+//===========================================================================
+//  Clip
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! キーフレームの姿勢から作成
+//---------------------------------------------------------------------------
+Clip::Clip(f32 sample_rate, const std::vector<Pose>& frames)
+    : sample_rate_(sample_rate)
+    , frame_count_(static_cast<u32>(frames.size()))
+{
+    if(frames.empty())
+        return;
+
+    u32 joint_count = static_cast<u32>(frames[0].size());
+    tracks_.resize(joint_count);
+
+    for(u32 joint = 0; joint < joint_count; ++joint) {
+        auto& track = tracks_[joint];
+
+        track.rotation_    = static_cast<u32>(rotations_.size());
+        track.translation_ = static_cast<u32>(translations_.size());
+        track.scale_       = static_cast<u32>(scales_.size());
+        track.animated_    = 0;
+
+        //----------------------------------------------------------
+        // 回転
+        // 隣接キーを同じ半球にそろえておき、サンプリング時の符号判定を省く
+        //----------------------------------------------------------
+        if(isConstantRotation(frames, joint)) {
+            rotations_.push_back(frames[0][joint].rotate_);
+        }
+        else {
+            track.animated_ |= ANIMATED_ROTATION;
+
+            quaternion previous = frames[0][joint].rotate_;
+            for(const auto& pose : frames) {
+                previous = alignHemisphere(pose[joint].rotate_, previous);
+                rotations_.push_back(previous);
+            }
+        }
+
+        //----------------------------------------------------------
+        // 平行移動
+        //----------------------------------------------------------
+        if(isConstantTranslation(frames, joint)) {
+            translations_.push_back(frames[0][joint].translate_);
+        }
+        else {
+            track.animated_ |= ANIMATED_TRANSLATION;
+            for(const auto& pose : frames)
+                translations_.push_back(pose[joint].translate_);
+        }
+
+        //----------------------------------------------------------
+        // スケール
+        //----------------------------------------------------------
+        if(isConstantScale(frames, joint)) {
+            scales_.push_back(frames[0][joint].scale_);
+        }
+        else {
+            track.animated_ |= ANIMATED_SCALE;
+            for(const auto& pose : frames)
+                scales_.push_back(pose[joint].scale_);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//! [DxLib] MV1のアニメーションをサンプリングして作成
+//---------------------------------------------------------------------------
+Clip Clip::extract(int mv1_model, int mv1_anim, u32 anim_index, f32 sample_rate)
+{
+    int attach_index = MV1AttachAnim(mv1_model, static_cast<int>(anim_index), mv1_anim, true);
+    if(attach_index == -1)
+        return {};
+
+    // 総再生時間を等間隔に分割 (最後のキーが終端に一致するようにキー間隔を調整)
+    f32 total_time  = MV1GetAttachAnimTotalTime(mv1_model, attach_index) / DXLIB_TIME_SCALE;
+    u32 frame_count = static_cast<u32>(std::ceil(total_time * sample_rate)) + 1;
+    if(frame_count > 1)
+        sample_rate = static_cast<f32>(frame_count - 1) / total_time;
+
+    u32               joint_count = static_cast<u32>(std::max(MV1GetFrameNum(mv1_model), 0));
+    std::vector<Pose> frames(frame_count, Pose(joint_count));
+
+    for(u32 frame = 0; frame < frame_count; ++frame) {
+        f32 time = std::min(static_cast<f32>(frame) / sample_rate, total_time);
+        MV1SetAttachAnimTime(mv1_model, attach_index, time * DXLIB_TIME_SCALE);
+
+        for(u32 joint = 0; joint < joint_count; ++joint) {
+            matrix local         = cast(MV1GetAttachAnimFrameLocalMatrix(mv1_model, attach_index, static_cast<int>(joint)));
+            frames[frame][joint] = TRS::fromMatrix(local);
+        }
+    }
+    MV1DetachAnim(mv1_model, attach_index);
+
+    return Clip(sample_rate, frames);
+}
+
+//---------------------------------------------------------------------------
+//! 差分アニメーションに変換
+//---------------------------------------------------------------------------
+void Clip::makeAdditive(const Pose& reference)
+{
+    assert(!is_additive_ && reference.size() == tracks_.size());
+
+    for(u32 joint = 0; joint < jointCount(); ++joint) {
+        const auto& track = tracks_[joint];
+        const auto& base  = reference[joint];
+
+        u32 count = frame_count_;
+
+        // apply時に mul(姿勢, 差分) となるよう基準の逆回転を左から掛ける
+        // (単位クォータニオンの左乗算は内積を保つため、隣接キーの半球はそろったまま)
+        quaternion inverse_rotation = inverse(base.rotate_);
+        u32        rotation_count   = (track.animated_ & ANIMATED_ROTATION) ? count : 1;
+        for(u32 i = 0; i < rotation_count; ++i) {
+            auto& q = rotations_[track.rotation_ + i];
+            q       = normalize(mul(inverse_rotation, q));
+        }
+
+        u32 translation_count = (track.animated_ & ANIMATED_TRANSLATION) ? count : 1;
+        for(u32 i = 0; i < translation_count; ++i)
+            translations_[track.translation_ + i] -= base.translate_;
+
+        // スケールは比率 (基準が0の軸は1倍)
+        auto   inverse       = [](f32 v) { return std::abs(v) > FLT_EPSILON ? 1.0f / v : 1.0f; };
+        float3 inverse_scale = float3(inverse(static_cast<f32>(base.scale_.x)),
+                                      inverse(static_cast<f32>(base.scale_.y)),
+                                      inverse(static_cast<f32>(base.scale_.z)));
+        u32    scale_count   = (track.animated_ & ANIMATED_SCALE) ? count : 1;
+        for(u32 i = 0; i < scale_count; ++i)
+            scales_[track.scale_ + i] *= inverse_scale;
+    }
+    is_additive_ = true;
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルへ保存
+//---------------------------------------------------------------------------
+bool Clip::save(const std::string& path) const
+{
+    std::ofstream stream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if(!stream)
+        return false;
+
+    write(stream, VERSION);
+    write(stream, sample_rate_);
+    write(stream, frame_count_);
+    write(stream, static_cast<u32>(is_additive_));
+
+    write(stream, jointCount());
+    stream.write(reinterpret_cast<const char*>(tracks_.data()), tracks_.size() * sizeof(Track));
+
+    // SIMDレジスタ幅ではなく要素数分だけ詰めて書き出す
+    write(stream, static_cast<u32>(rotations_.size()));
+    for(const auto& q : rotations_) {
+        f32 v[4];
+        store(float4(q.vec), v);
+        write(stream, v);
+    }
+    for(const auto* keys : {&translations_, &scales_}) {
+        write(stream, static_cast<u32>(keys->size()));
+        for(const auto& key : *keys) {
+            f32 v[3];
+            store(key, v);
+            write(stream, v);
+        }
+    }
+    return stream.good();
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルから読み込み
+//---------------------------------------------------------------------------
+bool Clip::load(const std::string& path)
+{
+    *this = {};
+
+    std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+    if(!stream)
+        return false;
+
+    u32 version     = 0;
+    u32 is_additive = 0;
+    u32 joint_count = 0;
+    if(!read(stream, version) || version != VERSION || !read(stream, sample_rate_) || !read(stream, frame_count_) ||
+       !read(stream, is_additive) || !read(stream, joint_count)) {
+        *this = {};
+        return false;
+    }
+    is_additive_ = is_additive != 0;
+
+    tracks_.resize(joint_count);
+    stream.read(reinterpret_cast<char*>(tracks_.data()), tracks_.size() * sizeof(Track));
+
+    u32 count = 0;
+    read(stream, count);
+    rotations_.resize(count);
+    for(auto& q : rotations_) {
+        f32 v[4] = {};
+        read(stream, v);
+        q = quaternion(v[0], v[1], v[2], v[3]);
+    }
+    for(auto* keys : {&translations_, &scales_}) {
+        count = 0;
+        read(stream, count);
+        keys->resize(count);
+        for(auto& key : *keys) {
+            f32 v[3] = {};
+            read(stream, v);
+            key = float3(v[0], v[1], v[2]);
+        }
+    }
+
+    if(!stream) {
+        *this = {};
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 時間から補間する2キーを求めて関節ごとに処理
+//---------------------------------------------------------------------------
+template <class Func>
+void Clip::sampleJoints(f32 time, bool loop, Func&& func) const
+{
+    if(frame_count_ == 0)
+        return;
+
+    //----------------------------------------------------------
+    // 補間する2キーと比率
+    //----------------------------------------------------------
+    f32 last     = static_cast<f32>(frame_count_ - 1);
+    f32 position = time * sample_rate_;
+    if(loop && last > 0.0f) {
+        position = std::fmod(position, last);
+        if(position < 0.0f)
+            position += last;
+    }
+    position = std::clamp(position, 0.0f, last);
+
+    u32    frame0 = static_cast<u32>(position);
+    u32    frame1 = std::min(frame0 + 1, frame_count_ - 1);
+    float1 ratio  = position - static_cast<f32>(frame0);
+
+    //----------------------------------------------------------
+    // 関節ごとに補間 (定数トラックは補間しない)
+    //----------------------------------------------------------
+    for(u32 joint = 0; joint < jointCount(); ++joint) {
+        const auto& track = tracks_[joint];
+
+        TRS trs;
+        if(track.animated_ & ANIMATED_ROTATION) {
+            const auto* keys = &rotations_[track.rotation_];
+            trs.rotate_      = normalize(lerp(keys[frame0], keys[frame1], ratio));   // キーは半球をそろえ済み
+        }
+        else {
+            trs.rotate_ = rotations_[track.rotation_];
+        }
+
+        if(track.animated_ & ANIMATED_TRANSLATION) {
+            const auto* keys = &translations_[track.translation_];
+            trs.translate_   = keys[frame0] + (keys[frame1] - keys[frame0]) * ratio;
+        }
+        else {
+            trs.translate_ = translations_[track.translation_];
+        }
+
+        if(track.animated_ & ANIMATED_SCALE) {
+            const auto* keys = &scales_[track.scale_];
+            trs.scale_       = keys[frame0] + (keys[frame1] - keys[frame0]) * ratio;
+        }
+        else {
+            trs.scale_ = scales_[track.scale_];
+        }
+
+        func(joint, trs);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 姿勢を取得
+//---------------------------------------------------------------------------
+void Clip::sample(f32 time, bool loop, Pose& pose) const
+{
+    pose.resize(jointCount());
+    sampleJoints(time, loop, [&](u32 joint, const TRS& trs) { pose[joint] = trs; });
+}
+
+//---------------------------------------------------------------------------
+//! 重み付きで姿勢を加算
+//---------------------------------------------------------------------------
+void Clip::accumulate(f32 time, bool loop, f32 weight, Pose& sum) const
+{
+    assert(sum.size() == jointCount());
+
+    float1 w = weight;
+    sampleJoints(time, loop, [&](u32 joint, const TRS& trs) {
+        auto& dst = sum[joint];
+        dst.rotate_    += alignHemisphere(trs.rotate_, dst.rotate_) * w;
+        dst.translate_ += trs.translate_ * w;
+        dst.scale_     += trs.scale_ * w;
+    });
+}
+
+//---------------------------------------------------------------------------
+//! 差分を重み付きで適用
+//---------------------------------------------------------------------------
+void Clip::applyAdditive(f32 time, bool loop, f32 weight, Pose& pose) const
+{
+    assert(is_additive_ && pose.size() == jointCount());
+
+    float1 w = weight;
+    sampleJoints(time, loop, [&](u32 joint, const TRS& trs) {
+        auto& dst = pose[joint];
+        dst.rotate_    = normalize(mul(dst.rotate_, nlerp(quaternion::identity(), trs.rotate_, weight)));
+        dst.translate_ = dst.translate_ + trs.translate_ * w;
+        dst.scale_     = dst.scale_ * (float3(1.0f, 1.0f, 1.0f) + (trs.scale_ - float3(1.0f, 1.0f, 1.0f)) * w);
+    });
+}
+
+//---------------------------------------------------------------------------
+//! キーフレームのメモリ使用量を取得
+//---------------------------------------------------------------------------
+size_t Clip::byteSize() const
+{
+    return tracks_.size() * sizeof(Track) + rotations_.size() * sizeof(quaternion) +
+           (translations_.size() + scales_.size()) * sizeof(float3);
+}
+
+//===========================================================================
+//  ブレンド
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! N方向ブレンドの加算先を初期化
+//---------------------------------------------------------------------------
+void clearBlend(Pose& sum, u32 joint_count)
+{
+    TRS zero;
+    zero.translate_ = float3(0.0f, 0.0f, 0.0f);
+    zero.rotate_    = quaternion(0.0f, 0.0f, 0.0f, 0.0f);
+    zero.scale_     = float3(0.0f, 0.0f, 0.0f);
+
+    sum.assign(joint_count, zero);
+}
+
+//---------------------------------------------------------------------------
+//! N方向ブレンドの加算結果を正規化
+//---------------------------------------------------------------------------
+void normalizeBlend(Pose& sum, f32 weight)
+{
+    // 重みが無い場合は単位姿勢
+    if(weight <= FLT_EPSILON) {
+        std::fill(sum.begin(), sum.end(), TRS{});
+        return;
+    }
+
+    float1 inverse_weight = 1.0f / weight;
+    for(auto& trs : sum) {
+        trs.rotate_    = normalize(trs.rotate_);
+        trs.translate_ = trs.translate_ * inverse_weight;
+        trs.scale_     = trs.scale_ * inverse_weight;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 2つの姿勢を補間
+//---------------------------------------------------------------------------
+void blendPose(Pose& pose, const Pose& target, f32 ratio)
+{
+    assert(pose.size() == target.size());
+
+    float1 t = ratio;
+    for(size_t i = 0; i < pose.size(); ++i) {
+        pose[i].rotate_    = nlerp(pose[i].rotate_, target[i].rotate_, ratio);
+        pose[i].translate_ = pose[i].translate_ + (target[i].translate_ - pose[i].translate_) * t;
+        pose[i].scale_     = pose[i].scale_ + (target[i].scale_ - pose[i].scale_) * t;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 正規化線形補間
+//---------------------------------------------------------------------------
+quaternion nlerp(const quaternion& q0, const quaternion& q1, f32 t)
+{
+    return normalize(lerp(q0, alignHemisphere(q1, q0), float1(t)));
+}
+
+}   // namespace animation
@@ -0,0 +1,203 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AnimationClip.h
+//! @brief  スケルトンとアニメーションクリップ (エンジン側のサンプリング)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+
+namespace animation
+{
+
+//! DxLibのアニメーション時間の単位 (1秒あたりのDxLib時間)
+static constexpr f32 DXLIB_TIME_SCALE = 30.0f;
+
+//! ポーズ (関節ごとの親空間でのTRS)
+using Pose = std::vector<TRS>;
+
+//===========================================================================
+//! スケルトン
+//! @details 関節の親子関係とバインドポーズを持ちます。関節番号はDxLibのフレーム番号と同じです。
+//===========================================================================
+class Skeleton
+{
+public:
+    //! デフォルトコンストラクタ
+    Skeleton() = default;
+
+    //  コンストラクタ
+    //! @param  [in]    parents     関節ごとの親の関節番号 (-1:ルート)
+    //! @param  [in]    bind_pose   関節ごとのバインドポーズ (省略時は単位姿勢)
+    Skeleton(std::vector<s32> parents, Pose bind_pose = {});
+
+    //  [DxLib] MV1モデルのフレーム階層から作成
+    //! @param  [in]    mv1_handle  MV1モデルハンドル
+    static Skeleton fromModel(int mv1_handle);
+
+    //! 関節数を取得
+    u32 jointCount() const { return static_cast<u32>(parents_.size()); }
+
+    //! 親の関節番号を取得 (-1:ルート)
+    s32 parent(u32 joint) const { return parents_[joint]; }
+
+    //! 親が先になるように並べた関節番号を取得
+    const std::vector<u32>& order() const { return order_; }
+
+    //! バインドポーズを取得 (クリップが動かさない関節の姿勢)
+    const Pose& bindPose() const { return bind_pose_; }
+
+private:
+    std::vector<s32> parents_;     //!< 親の関節番号
+    std::vector<u32> order_;       //!< 親が先になる評価順
+    Pose             bind_pose_;   //!< バインドポーズ (親空間のTRS)
+};
+
+//===========================================================================
+//! アニメーションクリップ
+//! @details 一定間隔でサンプリングしたキーフレームを関節ごとのトラックとして保持します。
+//!          全フレームで値が変わらないトラックは1キーだけ保存するため、回転のみのボーンが多いほど小さくなります。
+//!          サンプリングは隣接する2キーの線形補間(回転は正規化線形補間)で、キーの探索は不要です。
+//!          構築後は読み取りのみのため、複数スレッドから同時にサンプリングできます。
+//===========================================================================
+class Clip
+{
+public:
+    //! キャッシュファイルのバージョン (形式を変えたら更新)
+    static constexpr u32 VERSION = 1;
+
+    //! 定数トラックとみなす誤差
+    static constexpr f32 CONSTANT_TOLERANCE = 1e-5f;
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //! デフォルトコンストラクタ
+    Clip() = default;
+
+    //  キーフレームの姿勢から作成
+    //! @param  [in]    sample_rate 1秒あたりのキー数
+    //! @param  [in]    frames      キーごとの姿勢 (全キーで関節数が同じであること)
+    Clip(f32 sample_rate, const std::vector<Pose>& frames);
+
+    //  [DxLib] MV1のアニメーションをサンプリングして作成
+    //! @param  [in]    mv1_model   アニメーションを適用するモデル (関節の並びの基準)
+    //! @param  [in]    mv1_anim    アニメーションを含むMV1
+    //! @param  [in]    anim_index  mv1_anim内のアニメーション番号
+    //! @param  [in]    sample_rate 1秒あたりのキー数
+    static Clip extract(int mv1_model, int mv1_anim, u32 anim_index, f32 sample_rate = 30.0f);
+
+    //  差分アニメーションに変換 (加算レイヤー用)
+    //! @param  [in]    reference   基準の姿勢 (この姿勢からの差分になります)
+    void makeAdditive(const Pose& reference);
+
+    //  キャッシュファイルへ保存
+    //! @param  [in]    path    ファイルパス
+    bool save(const std::string& path) const;
+
+    //  キャッシュファイルから読み込み
+    //! @param  [in]    path    ファイルパス
+    bool load(const std::string& path);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   サンプリング (スレッドセーフ)
+    //----------------------------------------------------------
+    //@{
+
+    //  姿勢を取得
+    //! @param  [in]    time    時間 (単位:秒)
+    //! @param  [in]    loop    ループするかどうか (falseの場合は末尾で停止)
+    //! @param  [out]   pose    姿勢 (関節数に合わせてリサイズされます)
+    void sample(f32 time, bool loop, Pose& pose) const;
+
+    //  重み付きで姿勢を加算 (N方向ブレンド用)
+    //! @param  [in]    time    時間 (単位:秒)
+    //! @param  [in]    loop    ループするかどうか
+    //! @param  [in]    weight  重み
+    //! @param  [inout] sum     加算先 (回転は同じ半球にそろえて加算。使用後にnormalizeBlend()で正規化)
+    void accumulate(f32 time, bool loop, f32 weight, Pose& sum) const;
+
+    //  差分を重み付きで適用 (makeAdditive()したクリップのみ)
+    //! @param  [in]    time    時間 (単位:秒)
+    //! @param  [in]    loop    ループするかどうか
+    //! @param  [in]    weight  重み
+    //! @param  [inout] pose    適用先の姿勢
+    void applyAdditive(f32 time, bool loop, f32 weight, Pose& pose) const;
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //! 長さを取得 (単位:秒)
+    f32 duration() const { return frame_count_ > 1 ? static_cast<f32>(frame_count_ - 1) / sample_rate_ : 0.0f; }
+
+    //! 関節数を取得
+    u32 jointCount() const { return static_cast<u32>(tracks_.size()); }
+
+    //! キー数を取得
+    u32 frameCount() const { return frame_count_; }
+
+    //! 差分アニメーションかどうか
+    bool isAdditive() const { return is_additive_; }
+
+    //  キーフレームのメモリ使用量を取得 (単位:byte)
+    size_t byteSize() const;
+
+    //@}
+
+private:
+    //! 関節ごとのトラック (キー配列の先頭位置。定数トラックは1キーのみ)
+    struct Track
+    {
+        u32 rotation_;      //!< 回転キーの先頭
+        u32 translation_;   //!< 平行移動キーの先頭
+        u32 scale_;         //!< スケールキーの先頭
+        u32 animated_;      //!< 値が変化する要素 (ANIMATED_ROTATIONなどの組み合わせ)
+    };
+
+    static constexpr u32 ANIMATED_ROTATION    = 1 << 0;   //!< 回転が変化する
+    static constexpr u32 ANIMATED_TRANSLATION = 1 << 1;   //!< 平行移動が変化する
+    static constexpr u32 ANIMATED_SCALE       = 1 << 2;   //!< スケールが変化する
+
+    //! 時間から補間する2キーを求めて関節ごとに処理
+    //! @param  [in]    func    関節ごとの処理 func(関節番号, 補間したTRS)
+    template <class Func>
+    void sampleJoints(f32 time, bool loop, Func&& func) const;
+
+private:
+    f32                     sample_rate_ = 30.0f;   //!< 1秒あたりのキー数
+    u32                     frame_count_ = 0;       //!< キー数
+    bool                    is_additive_ = false;   //!< 差分アニメーションかどうか
+    std::vector<Track>      tracks_;                //!< 関節ごとのトラック
+    std::vector<quaternion> rotations_;             //!< 回転キー
+    std::vector<float3>     translations_;          //!< 平行移動キー
+    std::vector<float3>     scales_;                //!< スケールキー
+};
+
+//  N方向ブレンドの加算先を初期化 (全要素0)
+//! @param  [out]   sum             加算先
+//! @param  [in]    joint_count     関節数
+void clearBlend(Pose& sum, u32 joint_count);
+
+//  N方向ブレンドの加算結果を正規化
+//! @param  [inout] sum     Clip::accumulate()で加算した姿勢
+//! @param  [in]    weight  加算した重みの合計
+void normalizeBlend(Pose& sum, f32 weight);
+
+//  2つの姿勢を補間
+//! @param  [inout] pose    補間元 (結果を上書き)
+//! @param  [in]    target  補間先
+//! @param  [in]    ratio   補間比率 (0.0f:pose ～ 1.0f:target)
+void blendPose(Pose& pose, const Pose& target, f32 ratio);
+
+//  正規化線形補間 (回転は同じ半球にそろえて補間)
+//! @param  [in]    q0  補間元
+//! @param  [in]    q1  補間先
+//! @param  [in]    t   補間比率
+quaternion nlerp(const quaternion& q0, const quaternion& q1, f32 t);
+
+}   // namespace animation
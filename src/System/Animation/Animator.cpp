@@ -0,0 +1,173 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Animator.cpp
+//! @brief  アニメーター (ブレンドツリーの評価)
+//---------------------------------------------------------------------------
+#include "Animator.h"
+
+#include <System/VectorMathBatch.h>
+
+#include <execution>
+
+namespace animation
+{
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+Animator::Animator(std::shared_ptr<const Skeleton> skeleton)
+    : skeleton_(std::move(skeleton))
+{
+}
+
+//---------------------------------------------------------------------------
+//! レイヤーを取得
+//---------------------------------------------------------------------------
+Animator::Layer& Animator::layer(u32 index)
+{
+    if(index >= layers_.size())
+        layers_.resize(index + 1);
+
+    return layers_[index];
+}
+
+//---------------------------------------------------------------------------
+//! 再生時間を進める
+//---------------------------------------------------------------------------
+void Animator::advance(f32 dt)
+{
+    for(auto& layer : layers_) {
+        for(auto& input : layer.inputs_) {
+            if(!input.clip_)
+                continue;
+
+            f32 duration = input.clip_->duration();
+            input.time_ += dt * input.speed_;
+
+            if(input.loop_ && duration > 0.0f) {
+                // ループさせる (逆再生にも対応)
+                input.time_ = std::fmod(input.time_, duration);
+                if(input.time_ < 0.0f)
+                    input.time_ += duration;
+            }
+            else {
+                // 末尾で停止
+                input.time_ = std::clamp(input.time_, 0.0f, duration);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 姿勢と行列を計算
+//---------------------------------------------------------------------------
+void Animator::evaluate()
+{
+    if(!skeleton_)
+        return;
+
+    u32 joint_count = skeleton_->jointCount();
+
+    // どのレイヤーも動かさない関節はバインドポーズのまま
+    pose_ = skeleton_->bindPose();
+
+    //----------------------------------------------------------
+    // レイヤーを下から合成
+    //----------------------------------------------------------
+    for(auto& layer : layers_) {
+        if(layer.weight_ <= 0.0f)
+            continue;
+
+        // 差分アニメーションを加算
+        if(layer.mode_ == BlendMode::Additive) {
+            for(auto& input : layer.inputs_) {
+                if(!input.clip_ || input.weight_ <= 0.0f)
+                    continue;
+                assert(input.clip_->jointCount() == joint_count);
+
+                input.clip_->applyAdditive(input.time_, input.loop_, input.weight_ * layer.weight_, pose_);
+            }
+            continue;
+        }
+
+        // N方向ブレンド
+        u32 active_count = 0;
+        f32 total_weight = 0.0f;
+        for(auto& input : layer.inputs_) {
+            if(!input.clip_ || input.weight_ <= 0.0f)
+                continue;
+            assert(input.clip_->jointCount() == joint_count);
+
+            if(active_count == 0)
+                clearBlend(work_, joint_count);
+
+            input.clip_->accumulate(input.time_, input.loop_, input.weight_, work_);
+            total_weight += input.weight_;
+            active_count++;
+        }
+        if(active_count == 0)
+            continue;
+        normalizeBlend(work_, total_weight);
+
+        // 下のレイヤーへ上書き
+        if(layer.weight_ >= 1.0f)
+            pose_.swap(work_);
+        else
+            blendPose(pose_, work_, layer.weight_);
+    }
+
+    //----------------------------------------------------------
+    // 行列へ変換
+    //----------------------------------------------------------
+    local_matrices_.resize(joint_count);
+    model_matrices_.resize(joint_count);
+
+    simd::toMatrices(pose_.data(), local_matrices_.data(), joint_count);
+
+    // 親が先に計算されている順に、親のモデル空間行列を掛ける
+    for(u32 joint : skeleton_->order()) {
+        s32 parent = skeleton_->parent(joint);
+
+        if(parent < 0)
+            model_matrices_[joint] = local_matrices_[joint];
+        else
+            model_matrices_[joint] = mul(local_matrices_[joint], model_matrices_[parent]);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! [DxLib] ローカル行列をモデルのフレームへ設定
+//---------------------------------------------------------------------------
+void Animator::apply(int mv1_handle) const
+{
+    for(u32 joint = 0; joint < local_matrices_.size(); ++joint) {
+        MV1SetFrameUserLocalMatrix(mv1_handle, static_cast<int>(joint), cast(local_matrices_[joint]));
+    }
+}
+
+//---------------------------------------------------------------------------
+//! [DxLib] モデルのフレームをアニメーション前の行列へ戻す
+//---------------------------------------------------------------------------
+void Animator::restore(int mv1_handle) const
+{
+    for(u32 joint = 0; joint < local_matrices_.size(); ++joint) {
+        MV1ResetFrameUserLocalMatrix(mv1_handle, static_cast<int>(joint));
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 複数のアニメーターを更新
+//---------------------------------------------------------------------------
+void update(Animator* const* animators, size_t count, f32 dt, bool parallel)
+{
+    // アニメーターごとに独立しているため、1体単位で並列に計算できる
+    auto job = [dt](Animator* animator) {
+        animator->advance(dt);
+        animator->evaluate();
+    };
+    if(parallel)
+        std::for_each(std::execution::par, animators, animators + count, job);
+    else
+        std::for_each(animators, animators + count, job);
+}
+
+}   // namespace animation
@@ -0,0 +1,121 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Animator.h
+//! @brief  アニメーター (ブレンドツリーの評価)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include "AnimationClip.h"
+
+#include <memory>
+
+namespace animation
+{
+
+//===========================================================================
+//! アニメーター (キャラクター1体分の再生状態)
+//! @details レイヤーごとにN個のクリップを重み付きでブレンドし、下のレイヤーへ上書き/加算します。
+//!          evaluate()は他のアニメーターと並列に実行でき、結果のローカル行列はapply()でモデルへ渡します。
+//===========================================================================
+class Animator
+{
+public:
+    //! レイヤーの合成方法
+    enum class BlendMode : u32
+    {
+        Override,   //!< 下のレイヤーの姿勢をレイヤーの重みで補間して上書き
+        Additive,   //!< 差分アニメーション(Clip::makeAdditive())を加算
+    };
+
+    //! ブレンドの入力 (クリップ1つ分の再生状態)
+    struct Input
+    {
+        std::shared_ptr<const Clip> clip_;            //!< クリップ
+        f32                         time_   = 0.0f;   //!< 再生時間 (単位:秒)
+        f32                         speed_  = 1.0f;   //!< 再生速度
+        f32                         weight_ = 1.0f;   //!< ブレンドの重み (レイヤー内で正規化)
+        bool                        loop_   = true;   //!< ループ再生かどうか
+    };
+
+    //! レイヤー
+    struct Layer
+    {
+        BlendMode          mode_   = BlendMode::Override;   //!< 合成方法
+        f32                weight_ = 1.0f;                  //!< 下のレイヤーに対する重み (0.0f～1.0f)
+        std::vector<Input> inputs_;                         //!< ブレンドする入力 (N方向)
+    };
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //! デフォルトコンストラクタ
+    Animator() = default;
+
+    //  コンストラクタ
+    //! @param  [in]    skeleton    スケルトン (複数のアニメーターで共有可能)
+    Animator(std::shared_ptr<const Skeleton> skeleton);
+
+    //  レイヤーを取得 (存在しない場合は追加)
+    //! @param  [in]    index   レイヤー番号 (0が最下層)
+    Layer& layer(u32 index);
+
+    //! レイヤー数を取得
+    u32 layerCount() const { return static_cast<u32>(layers_.size()); }
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   更新
+    //----------------------------------------------------------
+    //@{
+
+    //  再生時間を進める
+    //! @param  [in]    dt  経過時間(単位:秒)
+    void advance(f32 dt);
+
+    //  姿勢と行列を計算
+    //! @note   自身のデータのみ書き換えるため、他のアニメーターと並列に実行できます
+    void evaluate();
+
+    //  [DxLib] ローカル行列をモデルのフレームへ設定 (メインスレッドで呼び出し)
+    //! @param  [in]    mv1_handle  MV1モデルハンドル (スケルトンの作成元と同じ階層であること)
+    void apply(int mv1_handle) const;
+
+    //  [DxLib] モデルのフレームをアニメーション前の行列へ戻す
+    //! @param  [in]    mv1_handle  MV1モデルハンドル
+    void restore(int mv1_handle) const;
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //! 姿勢を取得 (親空間のTRS)
+    const Pose& pose() const { return pose_; }
+
+    //! ローカル行列を取得 (親空間)
+    const std::vector<matrix>& localMatrices() const { return local_matrices_; }
+
+    //! モデル空間の行列を取得
+    const std::vector<matrix>& modelMatrices() const { return model_matrices_; }
+
+    //@}
+
+private:
+    std::shared_ptr<const Skeleton> skeleton_;         //!< スケルトン
+    std::vector<Layer>              layers_;           //!< レイヤー (0が最下層)
+    Pose                            pose_;             //!< 合成した姿勢
+    Pose                            work_;             //!< レイヤー内のブレンド結果 (作業領域)
+    std::vector<matrix>             local_matrices_;   //!< ローカル行列
+    std::vector<matrix>             model_matrices_;   //!< モデル空間の行列
+};
+
+//  複数のアニメーターを更新 (再生時間を進めて姿勢を計算)
+//! @param  [in]    animators   アニメーターの配列
+//! @param  [in]    count       アニメーター数
+//! @param  [in]    dt          経過時間(単位:秒)
+//! @param  [in]    parallel    true:ワーカースレッドで並列に計算 false:呼び出しスレッドのみ
+void update(Animator* const* animators, size_t count, f32 dt, bool parallel = true);
+
+}   // namespace animation
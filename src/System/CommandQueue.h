@@ -0,0 +1,199 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CommandQueue.h
+//! @brief  複数スレッドから追加できるコマンドキュー (ロックフリー/ノード再利用)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+//===========================================================================
+//! コマンドキュー
+//! @details 複数スレッドから Push() し、1つのスレッドのみが Drain() するロックフリーキューです。
+//!          Push() は先頭ポインタへのCASのみで、ミューテックスを使用しません。
+//!          Drain() はリストを一括で取り出し、Push()した順に処理します。
+//!          処理済みのノードは型ごとのフリーリストに戻して再利用するため、
+//!          定常状態では Allocate() でヒープ確保を行いません。
+//! @tparam T コマンドの型 (デフォルト構築可能であること)
+//===========================================================================
+template <class T>
+class CommandQueue
+{
+public:
+    CommandQueue() = default;
+    ~CommandQueue();
+
+    //! コマンドを確保 (任意のスレッドから呼び出し可能)
+    //! @return デフォルト構築済みのコマンド。内容を設定してから Push() してください
+    T* Allocate();
+
+    //! コマンドを追加 (任意のスレッドから呼び出し可能)
+    //! @param [in] command Allocate()で確保したコマンド
+    void Push(T* command);
+
+    //! 追加されたコマンドをすべて取り出して処理 (1つのスレッドのみ)
+    //! @param [in] func コマンド処理
+    //! @return 処理したコマンド数
+    template <class Func>
+    size_t Drain(Func&& func);
+
+    //! 未処理のコマンドがあるか
+    bool IsEmpty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    CommandQueue(const CommandQueue&)            = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    //! ノード (コマンド本体を先頭に配置し、T* と相互に変換する)
+    struct Node
+    {
+        alignas(T) std::byte value_[sizeof(T)];   //!< コマンド本体
+        Node* next_ = nullptr;                    //!< リスト内の次のノード
+
+        T* get() { return std::launder(reinterpret_cast<T*>(value_)); }
+    };
+
+    //! 再利用待ちノード (型ごとに共有)
+    //! @details Drain()側はCASで戻し、確保側は一括exchangeでのみ取り出すため、ABA問題は発生しない
+    struct FreeList
+    {
+        std::atomic<Node*> head_ = nullptr;
+
+        ~FreeList() { deleteNodes(head_.exchange(nullptr)); }
+    };
+
+    //! スレッドごとの確保用キャッシュ
+    struct LocalCache
+    {
+        Node* head_ = nullptr;
+
+        ~LocalCache() { deleteNodes(head_); }
+    };
+
+    static FreeList& freeList()
+    {
+        static FreeList list;
+        return list;
+    }
+
+    static Node*& localCache()
+    {
+        thread_local LocalCache cache;
+        return cache.head_;
+    }
+
+    static void deleteNodes(Node* node)
+    {
+        while(node) {
+            Node* next = node->next_;
+            delete node;
+            node = next;
+        }
+    }
+
+    //! リストを一括で取り出しPush()した順に並べ替える
+    Node* takeAll();
+
+    std::atomic<Node*> head_ = nullptr;   //!< 最後に追加されたノード
+};
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+template <class T>
+CommandQueue<T>::~CommandQueue()
+{
+    // 未処理のコマンドを破棄
+    // 静的変数の破棄順に依存しないよう、フリーリストへは戻さずに解放する
+    Node* node = takeAll();
+    while(node) {
+        Node* next = node->next_;
+        node->get()->~T();
+        delete node;
+        node = next;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! コマンドを確保
+//---------------------------------------------------------------------------
+template <class T>
+T* CommandQueue<T>::Allocate()
+{
+    // キャッシュが空のときだけフリーリストを丸ごと受け取る
+    Node*& cache = localCache();
+    if(cache == nullptr)
+        cache = freeList().head_.exchange(nullptr, std::memory_order_acquire);
+
+    Node* node = cache;
+    if(node)
+        cache = node->next_;
+    else
+        node = new Node;
+
+    return new(node->value_) T();
+}
+
+//---------------------------------------------------------------------------
+//! コマンドを追加
+//---------------------------------------------------------------------------
+template <class T>
+void CommandQueue<T>::Push(T* command)
+{
+    Node* node  = reinterpret_cast<Node*>(command);
+    node->next_ = head_.load(std::memory_order_relaxed);
+
+    // 取り出し側は一括exchangeのみのため、ABA問題は発生しない
+    while(!head_.compare_exchange_weak(node->next_, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 追加されたコマンドをすべて取り出して処理
+//---------------------------------------------------------------------------
+template <class T>
+template <class Func>
+size_t CommandQueue<T>::Drain(Func&& func)
+{
+    size_t count = 0;
+
+    // 処理中に追加されたコマンドは次回のDrain()で処理する
+    Node* first = takeAll();
+    Node* last  = nullptr;
+    for(Node* node = first; node; node = node->next_) {
+        T* command = node->get();
+        func(*command);
+        command->~T();
+        last = node;
+        ++count;
+    }
+
+    // 処理済みのノードをまとめてフリーリストへ戻す
+    if(first) {
+        auto& free_head = freeList().head_;
+        last->next_     = free_head.load(std::memory_order_relaxed);
+        while(!free_head.compare_exchange_weak(last->next_, first, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    return count;
+}
+
+//---------------------------------------------------------------------------
+//! リストを一括で取り出しPush()した順に並べ替える
+//---------------------------------------------------------------------------
+template <class T>
+typename CommandQueue<T>::Node* CommandQueue<T>::takeAll()
+{
+    Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+
+    // 後入れ先出しのリストを反転
+    Node* fifo = nullptr;
+    while(node) {
+        Node* next  = node->next_;
+        node->next_ = fifo;
+        fifo        = node;
+        node        = next;
+    }
+    return fifo;
+}
@@ -2,6 +2,7 @@
 #include <System/Component/ComponentTransform.h>
 #include <System/Object.h>
 #include <System/Scene.h>
+#include <System/VectorMathBatch.h>
 
 #include <System/Debug/DebugCamera.h>
 #include <System/ImGui.h>
@@ -100,8 +101,13 @@ void ComponentCamera::SetCameraTransform()
     //	if( !camera_status_.is( CameraBit::Current ) || ( DebugCamera::IsUse() && !camera_status_.is( CameraBit::DebugCameara ) ) )
     //		return;
 
-    auto position = GetPosition();
-    auto target   = GetTarget();
+    // カメラ位置と注視点をまとめて変換 (GetPosition()/GetTarget()と同じ)
+    float3 points[2] = {position_, look_at_};
+    if(auto transform = GetOwner()->GetComponent<ComponentTransform>())
+        simd::transformPoints(transform->GetMatrix(), points, points, 2);
+
+    const float3& position = points[0];
+    const float3& target   = points[1];
 
     if(!ImGuizmo::IsUsing()) {
         mat_view_ = matrix::lookAtLH(position, target);
@@ -11,6 +11,7 @@
 #include <System/Component/ComponentModel.h>
 
 #include <System/Object.h>
+#include <System/VectorMathBatch.h>
 
 ComponentCollision::ComponentCollision(ObjectPtr owner)
     : Component(owner)
@@ -65,6 +66,7 @@ void ComponentCollision::GUICollsionData(bool use_attach)
     //  ImGui::CheckboxFlags(u8"初期化済み", &collision_status_.get(), 1 << (u32)CollisionBit::Initialized);
     ImGui::CheckboxFlags(u8"ヒットしない", &collision_status_.get(), 1 << (u32)CollisionBit::DisableHit);
     ImGui::CheckboxFlags(u8"ゲーム中表示", &collision_status_.get(), 1 << (u32)CollisionBit::ShowInGame);
+    ImGui::CheckboxFlags(u8"連続判定(すり抜け防止)", &collision_status_.get(), 1 << (u32)CollisionBit::UseCCD);
     ImGui::Separator();
     ImGui::Text(u8"Hitするグループ");
     ImGui::CheckboxFlags("WALL", (u32*)&collision_hit_, (u32)CollisionGroup::WALL);
@@ -149,6 +151,147 @@ void ComponentCollision::AttachToModel(int node)
     }
 }
 
+//! @brief ワールド空間の形状を更新します
+void ComponentCollision::UpdateWorldShape()
+{
+    ShapePoints points;
+    bool        has_shape = GetShapePoints(points);
+    if(has_shape)
+        simd::transformPoints(points.matrix_, points.points_, points.points_, 2);
+
+    ApplyWorldShape(has_shape ? &points : nullptr);
+}
+
+//! @brief 複数のコリジョンのワールド空間の形状をまとめて更新します
+//! @param collisions コリジョン
+void ComponentCollision::UpdateWorldShapes(const std::vector<ComponentCollisionPtr>& collisions)
+{
+    std::vector<ShapePoints> shapes(collisions.size());
+    std::vector<bool>        has_shape(collisions.size());
+    std::vector<matrix>      matrices;
+    std::vector<float3>      points;
+    matrices.reserve(collisions.size());
+    points.reserve(collisions.size() * 2);
+
+    // 形状を持つコリジョンの座標と行列を並べて一括変換
+    for(size_t i = 0; i < collisions.size(); ++i) {
+        has_shape[i] = collisions[i]->GetShapePoints(shapes[i]);
+        if(has_shape[i]) {
+            matrices.emplace_back(shapes[i].matrix_);
+            points.emplace_back(shapes[i].points_[0]);
+            points.emplace_back(shapes[i].points_[1]);
+        }
+    }
+    simd::transformPointPairs(matrices.data(), points.data(), points.data(), matrices.size());
+
+    size_t pair = 0;
+    for(size_t i = 0; i < collisions.size(); ++i) {
+        if(!has_shape[i]) {
+            collisions[i]->ApplyWorldShape(nullptr);
+            continue;
+        }
+        shapes[i].points_[0] = points[pair * 2 + 0];
+        shapes[i].points_[1] = points[pair * 2 + 1];
+        pair++;
+        collisions[i]->ApplyWorldShape(&shapes[i]);
+    }
+}
+
+//! @brief 計算したワールド空間の形状を反映します
+//! @param points ワールド座標へ変換済みの座標 (形状を持たない場合はnullptr)
+void ComponentCollision::ApplyWorldShape(const ShapePoints* points)
+{
+    old_world_shape_ = world_shape_;
+    if(points)
+        CalcWorldShape(*points, world_shape_);
+
+    // 初回と瞬間移動した直後は移動していないものとする
+    if(!old_world_shape_.valid_ || teleported_)
+        old_world_shape_ = world_shape_;
+    teleported_ = false;
+}
+
+//! @brief 1フレーム前から現在までの移動を取得します
+//! @return 移動する形状
+physics::SweptShape ComponentCollision::GetSweptShape() const
+{
+    physics::SweptShape shape;
+    shape.from_p0_ = old_world_shape_.p0_;
+    shape.from_p1_ = old_world_shape_.p1_;
+    shape.to_p0_   = world_shape_.p0_;
+    shape.to_p1_   = world_shape_.p1_;
+    shape.radius_  = world_shape_.radius_;
+    return shape;
+}
+
+//! @brief 連続判定が必要な速さで移動しているか
+bool ComponentCollision::IsFastMoving() const
+{
+    if(!collision_status_.is(CollisionBit::UseCCD) || !world_shape_.valid_)
+        return false;
+
+    // 半径以下の移動であれば通常の判定ですり抜けることはない
+    return GetSweptShape().maxMotion() > world_shape_.radius_;
+}
+
+//! @brief 1フレーム前の位置から現在までの移動中に当たったかをチェックします
+//! @param collision 相手コリジョン
+//! @return 当たり情報
+ComponentCollision::HitInfo ComponentCollision::IsSweepHit(ComponentCollisionPtr collision)
+{
+    ComponentCollision::HitInfo info{};
+
+    // Model VS 球/カプセル は反対から調べる
+    if(collision_type_ == CollisionType::MODEL) {
+        if(collision->collision_type_ == CollisionType::MODEL)
+            return info;
+
+        auto hit  = collision->IsSweepHit(std::dynamic_pointer_cast<ComponentCollision>(shared_from_this()));
+        hit.push_ = -hit.push_;   // push方向を反対にする
+        return hit;
+    }
+
+    // 線分中央の移動量
+    auto motion = [](const ComponentCollision* col) {
+        float3 from = (col->old_world_shape_.p0_ + col->old_world_shape_.p1_) * 0.5f;
+        float3 to   = (col->world_shape_.p0_ + col->world_shape_.p1_) * 0.5f;
+        return to - from;
+    };
+
+    physics::SweepHit hit;
+    float3            relative_motion;   //!< 相手から見た自分の移動量
+
+    if(collision->collision_type_ == CollisionType::MODEL) {
+        // モデルは動かないため、自分が高速移動しているときのみ調べる
+        auto& bvh = std::static_pointer_cast<ComponentCollisionModel>(collision)->GetTriangleBVH();
+        if(!IsFastMoving() || !bvh.isValid() || !bvh.sweep(GetSweptShape(), hit))
+            return info;
+
+        relative_motion = motion(this);
+    }
+    else {
+        if(!world_shape_.valid_ || !collision->world_shape_.valid_)
+            return info;
+        if(!IsFastMoving() && !collision->IsFastMoving())
+            return info;
+        if(!physics::sweep(GetSweptShape(), collision->GetSweptShape(), hit))
+            return info;
+
+        relative_motion = motion(this) - motion(collision.get());
+    }
+
+    // 衝突時刻以降の移動のうち、相手へ押し込む方向の分だけ戻す (接線方向は滑らせる)
+    float3 remain = relative_motion * (1.0f - hit.time_);
+    float  depth  = std::max(-static_cast<f32>(dot(remain, hit.normal_)), 0.0f);
+
+    // このpush_は、調べたほうの押し戻し方向100%で作成する
+    info.hit_            = true;
+    info.push_           = hit.normal_ * depth;
+    info.hit_position_   = hit.position_;
+    info.time_of_impact_ = hit.time_;
+    return info;
+}
+
 //! @brief Capsule VS Sphere
 //! @param col1 Capsuleコリジョン
 //! @param col2 Sphere コリジョン
@@ -224,12 +367,11 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
         float3 vec = e0 - c0;   // 調べたほうの跳ね返りの方向(100%)
         float  len = length(vec);
         if(abs(len) <= abs(len) * FLT_EPSILON) {
-            // 全く同じ位置にいる場合はz移動する形にしておく
+            // 全く同じ位置にいる場合はz移動する形にしておく (相手が+z側にいるとみなし-z方向へ押し戻す)
             vec = {0, 0, 1};
         }
 
-        float3 vs = normalize(vec) * (cr + er);
-        vec -= vs;
+        vec = normalize(vec) * (len - (cr + er));
 
         // このpush_は、調べたほうの押し戻し方向100%で作成する
         info.push_         = vec;
@@ -341,11 +483,10 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
         float len = length(vec);
         if(abs(len) <= abs(len) * FLT_EPSILON) {
-            // 全く同じ位置にいる場合はz移動する形にしておく
+            // 全く同じ位置にいる場合はz移動する形にしておく (相手が+z側にいるとみなし-z方向へ押し戻す)
             vec = {0, 0, 1};
         }
-        float3 vs = normalize(vec) * (cr + er);
-        vec -= vs;
+        vec = normalize(vec) * (len - (cr + er));
 
         // このpush_は、調べたほうの押し戻し方向100%で作成する
         info.push_         = vec;
@@ -443,9 +584,9 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
 
     const float no_clumb = 0.5f;   // これ以下の傾きは上らない
 
-    // モデルが存在していない
-    auto mdl = col2->GetOwner()->GetComponent<ComponentModel>();
-    if(mdl == nullptr)
+    // 地形の三角形BVHが構築されていない
+    const auto& bvh = col2->GetTriangleBVH();
+    if(!bvh.isValid())
         return info;
 
     float3 opos{};
@@ -493,18 +634,17 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
 
     float3 pos = cpos;
 
-    MV1_COLL_RESULT_POLY hit_poly{};
-    float3               bottom = cpos;    //-float3{ 0, col1->GetRadius() * scale, 0 };
-    float3               top    = cpos1;   //bottom + float3{ 0, col1->GetRadius() * scale * 2, 0 };
-    hit_poly                    = MV1CollCheck_Line(mdl->GetModel(), -1, cast(top), cast(bottom));
+    physics::TriangleBVH::RayHit hit_poly{};
+    float3                       bottom = cpos;    //-float3{ 0, col1->GetRadius() * scale, 0 };
+    float3                       top    = cpos1;   //bottom + float3{ 0, col1->GetRadius() * scale * 2, 0 };
     //DrawLine3D( cast( top ), cast( bottom ), GetColor( 255, 0, 255 ) );
 
-    if(hit_poly.HitFlag != 0) {
-        float d = dot(cast(hit_poly.Normal), float3(0, 1, 0));
+    if(bvh.raycast(top, bottom, hit_poly)) {
+        float d = dot(hit_poly.normal_, float3(0, 1, 0));
         //float e = 1.0f;
         if(abs(d) > no_clumb)   //< 傾き過ぎているとかなり上るので抑える
         {
-            pos = cast(hit_poly.HitPosition);
+            pos = hit_poly.position_;
 
             // 上下に球にめり込む分を移動させる
             // ※傾きが大きいと移動も大きいため許容するほうが楽
@@ -524,7 +664,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
 
     {
         // 次は壁当たり球の当たりをチェックする
-        MV1_COLL_RESULT_POLY_DIM hit_poly_dim{};
+        physics::TriangleBVH::Contacts contacts;
 
         float3 vec_up = normalize(cpos1 - cpos);
         //float  vec_h  = length( cpos1 - cpos );
@@ -533,24 +673,14 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
         float3 pos1 = cpos1 - vec_up * col1->GetRadius() * scale;
 
         // Capsuleの処理を使っているため面倒なのでこれで代用しておく
-        hit_poly_dim = MV1CollCheck_Capsule(mdl->GetModel(), -1, cast(pos1), cast(pos2), col1->GetRadius() * scale);
-        float3 vh    = 0;
-        for(int i = 0; i < hit_poly_dim.HitNum; i++) {
-            if(dot(cast(hit_poly_dim.Dim[i].Normal), float3(0, 1, 0)).x > 0.5f)
+        bvh.overlapCapsule(pos1, pos2, col1->GetRadius() * scale, contacts);
+        float3 vh = 0;
+        for(auto& contact : contacts) {
+            if(dot(contact.normal_, float3(0, 1, 0)).x > 0.5f)
                 continue;
 
-            SEGMENT_TRIANGLE_RESULT result{};
-
-            VECTOR v1 = cast(pos1);
-            VECTOR v2 = cast(pos2);
-            Segment_Triangle_Analyse(&v1,
-                                     &v2,
-                                     &hit_poly_dim.Dim[i].Position[0],
-                                     &hit_poly_dim.Dim[i].Position[1],
-                                     &hit_poly_dim.Dim[i].Position[2],
-                                     &result);
-
-            float3 add = cast(result.Tri_MinDist_Pos);
+            // 三角形上の最近接点
+            float3 add = contact.position_;
 
             add.y = pos.y;
             //result.Seg_MinDist_Pos.y;
@@ -595,9 +725,9 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     const float no_clumb = 0.5f;   // これ以下の傾きは上らない
 
-    // モデルが存在していない
-    auto mdl = col2->GetOwner()->GetComponent<ComponentModel>();
-    if(mdl == nullptr)
+    // 地形の三角形BVHが構築されていない
+    const auto& bvh = col2->GetTriangleBVH();
+    if(!bvh.isValid())
         return info;
 
     float3 opos{};
@@ -650,18 +780,17 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     float3 pos = cpos;
 
-    MV1_COLL_RESULT_POLY hit_poly{};
-    float3               bottom = cpos;    //-float3{ 0, col1->GetRadius() * scale, 0 };
-    float3               top    = cpos1;   //bottom + float3{ 0, col1->GetRadius() * scale * 2, 0 };
-    hit_poly                    = MV1CollCheck_Line(mdl->GetModel(), -1, cast(top), cast(bottom));
+    physics::TriangleBVH::RayHit hit_poly{};
+    float3                       bottom = cpos;    //-float3{ 0, col1->GetRadius() * scale, 0 };
+    float3                       top    = cpos1;   //bottom + float3{ 0, col1->GetRadius() * scale * 2, 0 };
     //DrawLine3D( cast( top ), cast( bottom ), GetColor( 255, 0, 255 ) );
 
-    if(hit_poly.HitFlag != 0) {
-        float d = dot(cast(hit_poly.Normal), float3(0, 1, 0));
+    if(bvh.raycast(top, bottom, hit_poly)) {
+        float d = dot(hit_poly.normal_, float3(0, 1, 0));
         //float e = 1.0f;
         if(abs(d) > no_clumb)   //< 傾き過ぎているとかなり上るので抑える
         {
-            pos = cast(hit_poly.HitPosition);
+            pos = hit_poly.position_;
 
             // 上下に球にめり込む分を移動させる
             // ※傾きが大きいと移動も大きいため許容するほうが楽
@@ -682,7 +811,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     {
         // 次は壁当たり球の当たりをチェックする
-        MV1_COLL_RESULT_POLY_DIM hit_poly_dim{};
+        physics::TriangleBVH::Contacts contacts;
 
         float3 vec_up = normalize(cpos1 - cpos);
         //float  vec_h  = length( cpos1 - cpos );
@@ -690,24 +819,14 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
         float3 pos2 = pos + vec_up * col1->GetRadius() * scale;
         float3 pos1 = cpos1 - vec_up * col1->GetRadius() * scale;
 
-        hit_poly_dim = MV1CollCheck_Capsule(mdl->GetModel(), -1, cast(pos1), cast(pos2), col1->GetRadius() * scale);
-        float3 vh    = 0;
-        for(int i = 0; i < hit_poly_dim.HitNum; i++) {
-            if(dot(cast(hit_poly_dim.Dim[i].Normal), float3(0, 1, 0)).x > 0.5f)
+        bvh.overlapCapsule(pos1, pos2, col1->GetRadius() * scale, contacts);
+        float3 vh = 0;
+        for(auto& contact : contacts) {
+            if(dot(contact.normal_, float3(0, 1, 0)).x > 0.5f)
                 continue;
 
-            SEGMENT_TRIANGLE_RESULT result{};
-
-            VECTOR v1 = cast(pos1);
-            VECTOR v2 = cast(pos2);
-            Segment_Triangle_Analyse(&v1,
-                                     &v2,
-                                     &hit_poly_dim.Dim[i].Position[0],
-                                     &hit_poly_dim.Dim[i].Position[1],
-                                     &hit_poly_dim.Dim[i].Position[2],
-                                     &result);
-
-            float3 add = cast(result.Tri_MinDist_Pos);
+            // 三角形上の最近接点
+            float3 add = contact.position_;
 
             add.y = pos.y;
             //result.Seg_MinDist_Pos.y;
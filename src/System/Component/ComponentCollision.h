@@ -4,6 +4,7 @@
 //---------------------------------------------------------------------------
 #pragma once
 #include <System/Component/Component.h>
+#include <System/Physics/Sweep.h>
 #include <ImGuizmo/ImGuizmo.h>
 #include <DxLib.h>
 
@@ -28,11 +29,22 @@ public:
     //! @brief ヒット情報
     struct HitInfo
     {
-        bool                  hit_           = false;                //!< ヒットしたか
-        ComponentCollisionPtr collision_     = nullptr;              //!< 自分のコリジョン
-        float3                push_          = {0.0f, 0.0f, 0.0f};   //!< めり込み量
-        float3                hit_position_  = {0.0f, 0.0f, 0.0f};   //!< 当たった地点
-        ComponentCollisionPtr hit_collision_ = nullptr;              //!< 当たったコリジョン
+        bool                  hit_            = false;                //!< ヒットしたか
+        ComponentCollisionPtr collision_      = nullptr;              //!< 自分のコリジョン
+        float3                push_           = {0.0f, 0.0f, 0.0f};   //!< めり込み量
+        float3                hit_position_   = {0.0f, 0.0f, 0.0f};   //!< 当たった地点
+        ComponentCollisionPtr hit_collision_  = nullptr;              //!< 当たったコリジョン
+        float                 time_of_impact_ = 1.0f;                 //!< 衝突時刻 (0.0:1フレーム前の位置 ～ 1.0:現在の位置)
+    };
+
+    //! @brief ワールド空間の形状 (線分+半径)
+    //! @details 球は始点と終点が同じ位置になります
+    struct WorldShape
+    {
+        float3 p0_     = {0.0f, 0.0f, 0.0f};   //!< 線分の始点
+        float3 p1_     = {0.0f, 0.0f, 0.0f};   //!< 線分の終点
+        float  radius_ = 0.0f;                 //!< 半径 (スケール適用後)
+        bool   valid_  = false;                //!< 一括判定に使用できるか
     };
 
     ComponentCollision(ObjectPtr owner);
@@ -57,6 +69,37 @@ public:
     //! @details 当たった回数分ここに来ます
     virtual void OnHit(const HitInfo& hitInfo);
 
+    //! @brief ワールド空間の形状を更新します
+    //! @details 当たり判定の前に1フレーム1回呼ばれます。更新前の形状は連続判定に使用します
+    //!          球/カプセル同士の判定はこの形状で行うため、判定中にOnHit()で移動しても同じパス内では更新されません
+    void UpdateWorldShape();
+
+    //! @brief 複数のコリジョンのワールド空間の形状をまとめて更新します
+    //! @param collisions コリジョン
+    //! @details UpdateWorldShape()と同じ結果になります。座標変換はsimd::transformPointPairs()で一括して行います
+    static void UpdateWorldShapes(const std::vector<ComponentCollisionPtr>& collisions);
+
+    //! @brief ワールド空間の形状を取得します
+    //! @return UpdateWorldShape()で更新した形状
+    const WorldShape& GetWorldShape() const { return world_shape_; }
+
+    //! @brief 1フレーム前から現在までの移動を取得します
+    //! @return 移動する形状
+    physics::SweptShape GetSweptShape() const;
+
+    //! @brief 移動経路をリセットします
+    //! @details 瞬間移動した場合に呼ばれ、次の形状更新では移動していないものとして扱います
+    void ResetSweep() { teleported_ = true; }
+
+    //! @brief 連続判定が必要な速さで移動しているか
+    //! @details UseCCDが有効で、1フレームの移動量が半径を超えている場合に連続判定を行います
+    bool IsFastMoving() const;
+
+    //! @brief 1フレーム前の位置から現在までの移動中に当たったかをチェックします
+    //! @param collision 相手コリジョン
+    //! @return 当たりの情報 (time_of_impact_ に衝突時刻が入ります)
+    HitInfo IsSweepHit(ComponentCollisionPtr collision);
+
     //---------------------------------------------------------------------------
     //! コリジョンステータス
     //---------------------------------------------------------------------------
@@ -67,6 +110,7 @@ public:
         ShowInGame,    //!< ゲーム中にも当たりが見える
         IsGround,      //!< グランド上にいる
         UsePhysics,    //!< 移動でPhysicsが有効になります
+        UseCCD,        //!< 高速移動時に連続判定を行う (すり抜け防止)
     };
 
     bool IsCollisionStatus(CollisionBit bit) { return collision_status_.is(bit); }
@@ -270,6 +314,23 @@ protected:
     //----------------------------------------------------------------------------
     //@{
 
+    //! @brief ワールド空間の形状の計算に使う座標
+    struct ShapePoints
+    {
+        float3 points_[2] = {};                   //!< 形状の2点 (CalcWorldShape()ではワールド座標)
+        matrix matrix_    = matrix::identity();   //!< ワールド座標への変換行列
+    };
+
+    //! @brief ワールド空間の形状の計算に使う座標を取得します
+    //! @param points [out] ローカル座標と変換行列
+    //! @return 形状を持つか (球/カプセル以外はfalse)
+    virtual bool GetShapePoints([[maybe_unused]] ShapePoints& points) { return false; }
+
+    //! @brief ワールド空間の形状を計算します
+    //! @param points ワールド座標へ変換済みの座標
+    //! @param shape [out] ワールド空間の形状
+    virtual void CalcWorldShape([[maybe_unused]] const ShapePoints& points, [[maybe_unused]] WorldShape& shape) {}
+
     //! @brief Capsule VS Sphere
     //! @param col1 Capsuleコリジョン
     //! @param col2 Sphere コリジョン
@@ -326,6 +387,19 @@ protected:
     //! 1フレーム前の状態 (WorldTransform)
     matrix old_transform_ = matrix::identity();
 
+    //! ワールド空間の形状 (当たり判定の前に更新)
+    WorldShape world_shape_{};
+
+    //! 1フレーム前のワールド空間の形状 (連続判定用)
+    WorldShape old_world_shape_{};
+
+    //! 前回の形状更新から瞬間移動したか
+    bool teleported_ = false;
+
+    //! @brief 計算したワールド空間の形状を反映します
+    //! @param points ワールド座標へ変換済みの座標 (形状を持たない場合はnullptr)
+    void ApplyWorldShape(const ShapePoints* points);
+
     CollisionType  collision_type_  = CollisionType::NONE;
     CollisionGroup collision_group_ = CollisionGroup::ETC;   //!< 自分のコリジョンタイプ
     u32            collision_hit_   = 0xffffffff;            //!< デフォルトではすべてに当たる
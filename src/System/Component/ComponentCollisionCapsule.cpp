@@ -116,7 +116,7 @@ void ComponentCollisionCapsule::PostUpdate()
     //float half_height = ( height_ - radius_ * 2 ) * 0.5f;
     //own_mat._41_42_43 -= ( own_mat._21_22_23 * ( half_height + radius_ ) );
 
-    GetOwner()->Matrix() = mat;
+    GetOwner()->SetMatrix(mat);
     //mul( own_mat, mat );
 #endif
 }
@@ -295,6 +295,58 @@ ComponentCollisionCapsule::HitInfo ComponentCollisionCapsule::IsHit(ComponentCol
     return info;
 }
 
+//! @brief ワールド空間の形状の計算に使う座標を取得します
+//! @param points [out] ローカル座標と変換行列
+//! @return 形状を持つか
+bool ComponentCollisionCapsule::GetShapePoints(ShapePoints& points)
+{
+    points.points_[0] = GetTranslate();
+    points.points_[1] = normalize(GetVectorAxisY()) * height_ + points.points_[0];
+
+    // モデルアタッチ
+    if(attach_node_ >= 0) {
+        if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
+            points.matrix_ = attach_node_matrix_;
+        }
+    }
+    else {
+        // ComponentTransform(オブジェクト姿勢)
+        if(auto cmp = GetOwner()->GetComponent<ComponentTransform>()) {
+            // 高さに回転とスケールを掛け合わせる
+            points.matrix_ = cmp->GetMatrix();
+        }
+    }
+    return true;
+}
+
+//! @brief ワールド空間の形状を計算します
+//! @param points ワールド座標へ変換済みの座標
+//! @param shape [out] ワールド空間の形状
+void ComponentCollisionCapsule::CalcWorldShape(const ShapePoints& points, WorldShape& shape)
+{
+    float3 pos1  = points.points_[0];
+    float3 pos2  = points.points_[1];
+    float  scale = 1.0f;
+
+    if(attach_node_ >= 0) {
+        // アタッチ先のスケールは高さに反映しない
+        pos2 = normalize(pos2 - pos1) * height_ + pos1;
+    }
+    else {
+        // 半径はXZで平均としておく
+        scale = (length(points.matrix_.axisX()) + length(points.matrix_.axisZ())) / 2;
+    }
+
+    // isHit()と同じく半径分だけ線分を延ばしておく
+    float  radius = radius_ * scale;
+    float3 vec    = normalize(pos1 - pos2);
+
+    shape.p0_     = pos1 - vec * radius;
+    shape.p1_     = pos2 + vec * radius;
+    shape.radius_ = radius;
+    shape.valid_  = true;
+}
+
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentCollisionCapsule::GetWorldMatrix()
@@ -50,6 +50,16 @@ public:
 
     HitInfo IsHit(ComponentCollisionPtr col) override;
 
+    //! @brief ワールド空間の形状の計算に使う座標を取得します
+    //! @param points [out] ローカル座標と変換行列
+    //! @return 形状を持つか
+    bool GetShapePoints(ShapePoints& points) override;
+
+    //! @brief ワールド空間の形状を計算します
+    //! @param points ワールド座標へ変換済みの座標
+    //! @param shape [out] ワールド空間の形状
+    void CalcWorldShape(const ShapePoints& points, WorldShape& shape) override;
+
     //----------------------------------------------------------------------
     //! @name IMatrixインターフェースの利用するための定義
     //----------------------------------------------------------------------
@@ -7,6 +7,9 @@
 #include <System/Component/ComponentCollisionCapsule.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Component/ComponentModel.h>
+#include <System/Graphics/Model.h>
+#include <System/Graphics/ResourceModel.h>
+#include <System/Graphics/ModelCache.h>
 #include <System/Object.h>
 #include <System/Scene.h>
 
@@ -33,31 +36,15 @@ void ComponentCollisionModel::Draw()
 
     __super::Draw();
 
-    auto transform = GetWorldMatrix();
+    auto mdl = GetOwner()->GetComponent<ComponentModel>();
+    if(!mdl || GetTriangleBVH().triangleCount() == 0)
+        return;
 
-    SetUseLighting(FALSE);
+    // BVHと同じモデルキャッシュの三角形を、構築時のワールド行列で描画する
+    // (クラスター単位で視錐台/背面カリングされ、見えている部分のみ描画されます)
     SetLightEnable(FALSE);
-
-    // ポリゴンの数だけ繰り返し
-    for(int i = 0; i < ref_poly_.PolygonNum; i++) {
-        float3 p0 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[0]].Position);
-        float3 p1 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[1]].Position);
-        float3 p2 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[2]].Position);
-
-        VECTOR v0 = cast(mul(float4(p0, 1), transform).xyz);
-        VECTOR v1 = cast(mul(float4(p1, 1), transform).xyz);
-        VECTOR v2 = cast(mul(float4(p2, 1), transform).xyz);
-
-        // ポリゴンを形成する三頂点を使用してワイヤーフレームを描画する
-        DrawLine3D(v0, v1, GetColor(255, 255, 0));
-
-        DrawLine3D(v1, v2, GetColor(255, 255, 0));
-
-        DrawLine3D(v2, v0, GetColor(255, 255, 0));
-    }
-
+    mdl->GetModelClass()->resource()->modelCache()->render(bvh_world_);
     SetLightEnable(TRUE);
-    SetUseLighting(TRUE);
 }
 
 void ComponentCollisionModel::Exit()
@@ -112,15 +99,10 @@ void ComponentCollisionModel::AttachToModel()
         RigidBody() = physics::createRigidBody(shape::Mesh(mdl->GetModelClass().get(), s),   // メッシュ
                                                physics::ObjectLayers::NON_MOVING);           // 静的グループ
 #else
-        // 地形の傾きはDxLibからもらう
-        MV1SetupReferenceMesh(mdl->GetModel(), -1, TRUE);
-        ref_poly_ = MV1GetReferenceMesh(mdl->GetModel(), -1, TRUE);
-
-        // ワールド行列を設定
-        MV1SetMatrix(mdl->GetModel(), cast(mdl->GetWorldMatrix()));
-
-        // モデルが存在すればその当たりを構築する(※Defaultを使用)
-        MV1SetupCollInfo(mdl->GetModel());
+        // 地形の三角形BVHはモデルの読み込みが終わってから構築する
+        // (ここで読み込み完了を待つとメインスレッドが止まり、ストリーミング読み込みの意味がなくなるため)
+        bvh_.clear();
+        bvh_pending_ = true;
 #endif
     }
     else {
@@ -128,6 +110,47 @@ void ComponentCollisionModel::AttachToModel()
     }
 }
 
+//! @brief 地形の三角形BVHを取得
+//! @return ワールド空間で構築された三角形BVH (モデルの読み込みが終わるまでは空)
+const physics::TriangleBVH& ComponentCollisionModel::GetTriangleBVH()
+{
+    if(!bvh_pending_)
+        return bvh_;
+
+    auto mdl = GetOwner()->GetComponent<ComponentModel>();
+    if(!mdl) {
+        bvh_pending_ = false;
+        return bvh_;
+    }
+
+    // 読み込み中は空のBVHを返す (待たない)
+    auto* resource_model = mdl->GetModelClass()->resource();
+    auto* model_cache    = resource_model->modelCache();
+    if(!resource_model->isActive() || !model_cache->isValid())
+        return bvh_;
+
+    // 地形は動かないため、構築時のワールド行列で固定する
+    bvh_world_ = mdl->GetWorldMatrix();
+    BuildTriangleBVH(*model_cache, bvh_world_, bvh_);
+    bvh_pending_ = false;
+    return bvh_;
+}
+
+//! @brief モデルキャッシュの三角形から地形の三角形BVHを構築
+//! @param model_cache 読み込み済みのモデルキャッシュ
+//! @param world ワールド行列
+//! @param bvh 構築先
+void ComponentCollisionModel::BuildTriangleBVH(const ModelCache& model_cache, const matrix& world, physics::TriangleBVH& bvh)
+{
+    // モデルキャッシュの頂点配列から地形の三角形BVHを構築する
+    std::vector<float3> vertices;
+    vertices.reserve(model_cache.vertices().size());
+    for(auto& v : model_cache.vertices()) {
+        vertices.push_back(cast(v));   // DxLib::VECTOR→float3にキャストしながらコピー
+    }
+    bvh.build(vertices, model_cache.indices(), world);
+}
+
 //! @brief 当たっているかを調べる
 //! @param col 相手のコリジョン
 //! @return HitInfoを返す
@@ -185,26 +208,23 @@ const matrix ComponentCollisionModel::GetWorldMatrix()
 //! @return 実際動ける量
 float3 ComponentCollisionModel::checkMovement(float3 pos, float3 vec, float force)
 {
-    MV1_COLL_RESULT_POLY hit_poly{};
-    float3               top = pos + float3(0, 10, 0);
-    float3               btm = pos + float3(0, -1.5, 0);
+    physics::TriangleBVH::RayHit hit{};
+    float3                       top = pos + float3(0, 10, 0);
+    float3                       btm = pos + float3(0, -1.5, 0);
 
     if(length(vec).x <= 0)
         return float3(0, 0, 0);
 
-    if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
-        hit_poly = MV1CollCheck_Line(mdl->GetModel(), -1, cast(top), cast(btm));
-        if(hit_poly.HitFlag) {
-            // 制限あり (dotがマイナスということは山に上る形になっている)
-            float pt = dot(cast(hit_poly.Normal), normalize(vec));
-            if(pt < 0) {
-                pt *= force;
-                if(pt < -1)
-                    pt = -1;
-
-                // 傾きに合わせて、実際の移動量は、vec(最大) ~ 0(最小) となる
-                return vec + vec * pt;
-            }
+    if(GetTriangleBVH().raycast(top, btm, hit)) {
+        // 制限あり (dotがマイナスということは山に上る形になっている)
+        float pt = dot(hit.normal_, normalize(vec));
+        if(pt < 0) {
+            pt *= force;
+            if(pt < -1)
+                pt = -1;
+
+            // 傾きに合わせて、実際の移動量は、vec(最大) ~ 0(最小) となる
+            return vec + vec * pt;
         }
     }
     return vec;
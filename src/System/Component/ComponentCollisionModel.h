@@ -5,11 +5,14 @@
 #pragma once
 #include <System/Component/ComponentCollision.h>
 #include <System/Component/ComponentTransform.h>
+#include <System/Physics/TriangleBVH.h>
 #include <ImGuizmo/ImGuizmo.h>
 #include <DxLib.h>
 
 USING_PTR(ComponentCollisionModel);
 
+class ModelCache;   // 3Dモデルキャッシュ
+
 //! @brief コリジョンコンポーネントクラス
 class ComponentCollisionModel
     : public ComponentCollision
@@ -65,9 +68,21 @@ public:
     //! @return 実際動ける量
     float3 checkMovement(float3 pos, float3 vec, float force = 1.0f);
 
+    //! @brief 地形の三角形BVHを取得
+    //! @return ワールド空間で構築された三角形BVH (モデルの読み込みが終わるまでは空)
+    //! @details AttachToModel()後、モデルの読み込みが終わってから最初に呼ばれたときに構築します
+    const physics::TriangleBVH& GetTriangleBVH();
+
+    //! @brief モデルキャッシュの三角形から地形の三角形BVHを構築
+    //! @param model_cache 読み込み済みのモデルキャッシュ
+    //! @param world ワールド行列
+    //! @param bvh 構築先
+    static void BuildTriangleBVH(const ModelCache& model_cache, const matrix& world, physics::TriangleBVH& bvh);
+
 private:
-    MV1_REF_POLYGONLIST                   ref_poly_{};      //!< ポリゴンデータ
-    std::vector<MV1_COLL_RESULT_POLY_DIM> hit_poly_dims_;   //!< 結果代入用ポリゴン配列
+    physics::TriangleBVH bvh_;                                //!< 地形の三角形BVH (ワールド空間)
+    matrix               bvh_world_   = matrix::identity();   //!< BVHを構築したときのワールド行列 (デバッグ描画用)
+    bool                 bvh_pending_ = false;                //!< BVHの構築待ち (モデルの読み込み完了後に構築)
 
     //--------------------------------------------------------------------
     //! @name Cereal処理
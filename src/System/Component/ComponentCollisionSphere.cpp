@@ -139,6 +139,49 @@ ComponentCollisionSphere::HitInfo ComponentCollisionSphere::IsHit(ComponentColli
     return info;
 }
 
+//! @brief ワールド空間の形状の計算に使う座標を取得します
+//! @param points [out] ローカル座標と変換行列
+//! @return 形状を持つか
+bool ComponentCollisionSphere::GetShapePoints(ShapePoints& points)
+{
+    points.points_[0] = GetTranslate();
+    points.points_[1] = points.points_[0];
+
+    // モデルアタッチ
+    if(attach_node_ >= 0) {
+        if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
+            points.matrix_ = attach_node_matrix_;
+        }
+    }
+    else {
+        if(auto cmp = GetOwner()->GetComponent<ComponentTransform>()) {
+            points.matrix_ = cmp->GetMatrix();
+        }
+    }
+    return true;
+}
+
+//! @brief ワールド空間の形状を計算します
+//! @param points ワールド座標へ変換済みの座標
+//! @param shape [out] ワールド空間の形状
+void ComponentCollisionSphere::CalcWorldShape(const ShapePoints& points, WorldShape& shape)
+{
+    float scale = 1.0f;
+
+    // オブジェクト姿勢のスケールを半径に反映 (アタッチ時は反映しない)
+    if(attach_node_ < 0) {
+        float sx = length(points.matrix_.axisX());
+        float sy = length(points.matrix_.axisY());
+        float sz = length(points.matrix_.axisZ());
+        scale    = (sx + sy + sz) / 3.0f;
+    }
+
+    shape.p0_     = points.points_[0];
+    shape.p1_     = points.points_[0];
+    shape.radius_ = radius_ * scale;
+    shape.valid_  = true;
+}
+
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentCollisionSphere::GetWorldMatrix()
@@ -5,6 +5,7 @@
 #include <System/Component/ComponentModel.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Object.h>
+#include <System/VectorMathBatch.h>
 
 //! @brief モデルロード
 //! @param path ロードするモデル(.MV1/.MQO/.Xなど)
@@ -15,6 +16,9 @@ void ComponentModel::Load(std::string_view path)
 
     path_ = path;
 
+    // 境界球は読み込み完了後に再計算
+    bounds_radius_ = -1.0f;
+
     bool result = model_->load(path_);
     if(!result) {
         // ロードできなかった
@@ -35,17 +39,17 @@ void ComponentModel::Update(float delta)
 {
     // モデルが存在しているならばTransform設定を行う
     if(IsValid()) {
-        // アニメーションがあり再生している?
-        if(animation_ && animation_->isValid() && animation_->isPlaying()) {
-            animation_->update(delta);
-        }
-
         auto mat  = model_transform_;
         auto trns = GetOwner()->GetComponent<ComponentTransform>();
         if(trns) {
             mat = mul(mat, trns->GetMatrix());
         }
 
+        // アニメーションがあり再生している?
+        if(animation_ && animation_->isValid() && animation_->isPlaying()) {
+            UpdateAnimation(delta, mat);
+        }
+
         if(model_) {
             // ワールド行列を設定
             model_->setWorldMatrix(mat);
@@ -56,20 +60,81 @@ void ComponentModel::Update(float delta)
     }
 }
 
+//! @brief アニメーション更新
+//! @param delta 1フレームの秒数
+//! @param mat_world ワールド行列
+void ComponentModel::UpdateAnimation(float delta, const matrix& mat_world)
+{
+    if(animation_->isPaused())
+        return;
+
+    // 境界球 (読み込み完了後にメッシュの範囲から1度だけ計算)
+    if(bounds_radius_ < 0.0f && model_->isActive()) {
+        int    mv1_handle = *model_;
+        float3 aabb_min   = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+        float3 aabb_max   = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for(s32 mesh = 0; mesh < MV1GetMeshNum(mv1_handle); ++mesh) {
+            aabb_min = min(aabb_min, cast(MV1GetMeshMinPosition(mv1_handle, mesh)));
+            aabb_max = max(aabb_max, cast(MV1GetMeshMaxPosition(mv1_handle, mesh)));
+        }
+        if(MV1GetMeshNum(mv1_handle) > 0) {
+            bounds_center_ = (aabb_min + aabb_max) * 0.5f;
+            bounds_radius_ = length(aabb_max - aabb_min).x * 0.5f;
+        }
+    }
+
+    // 境界球が無い場合は毎フレーム更新
+    if(bounds_radius_ < 0.0f) {
+        animation_->update(delta);
+        return;
+    }
+
+    //----------------------------------------------------------
+    // 画面上の大きさから更新レベルを選択
+    //----------------------------------------------------------
+    f32 scale_x   = length(mat_world.axisX()).x;
+    f32 scale_y   = length(mat_world.axisY()).x;
+    f32 scale_z   = length(mat_world.axisZ()).x;
+    f32 scale_max = std::max(scale_x, std::max(scale_y, scale_z));
+
+    float3 center = mul(float4(bounds_center_, 1.0f), mat_world).xyz;
+    auto&  lod    = GetAnimationLod();
+    auto   level  = lod.select(center, bounds_radius_ * scale_max);
+
+    //----------------------------------------------------------
+    // 再生時間は毎フレーム進め、姿勢は更新するフレームのみ反映
+    //----------------------------------------------------------
+    animation_->advance(delta);
+
+    // 再生が終了したフレームは最終姿勢を必ず反映
+    bool finished = !animation_->isPlaying();
+    if(lod.shouldSample(level, animation_phase_, animation_sampled_, animation_priority_) || finished) {
+        animation_->apply();
+    }
+}
+
 //! @brief モデル描画
 void ComponentModel::Draw()
 {
     if(model_ == nullptr)
         return;
 
-    // ワールド行列を設定(コリジョン移動分)
-    model_->setWorldMatrix(GetWorldMatrix());
+    // ワールド行列を設定(コリジョン移動分。一括計算済みならその行列を使用)
+    model_->setWorldMatrix(world_matrix_ready_ ? world_matrix_ : GetWorldMatrix());
+    world_matrix_ready_ = false;
 
     // シェーダーを利用するかどうかを設定
     model_->useShader(UseShader());
 
     // モデル描画
-    model_->render();
+    if(UseRenderQueue()) {
+        // 描画キューへ登録し、Draw処理の最後にステート順でまとめて描画
+        model_->submit(GetRenderQueue());
+    }
+    else {
+        // 描画優先度の順を守るためその場で描画
+        model_->render();
+    }
 }
 
 //! @brief 終了処理
@@ -101,6 +166,18 @@ void ComponentModel::GUI()
                 model_status_.set(ModelBit::UseShader, shader);
             }
 
+            // アニメーター利用設定
+            bool animator = UseAnimator();
+            if(ImGui::Checkbox(u8"UseAnimator", &animator)) {
+                SetUseAnimator(animator);
+            }
+
+            // 描画キュー利用設定
+            bool render_queue = UseRenderQueue();
+            if(ImGui::Checkbox(u8"UseRenderQueue", &render_queue)) {
+                SetUseRenderQueue(render_queue);
+            }
+
             // ロード完了チェックフラグ
             bool loaded = IsValid();
 
@@ -216,6 +293,7 @@ ComponentModelPtr ComponentModel::SetAnimation(const std::vector<Animation::Desc
 
         //  モデルにアニメーションを設定
         model_->bindAnimation(animation_.get());
+        animation_->useAnimator(UseAnimator());
     }
 
     return std::dynamic_pointer_cast<ComponentModel>(shared_from_this());
@@ -269,6 +347,30 @@ const std::string_view ComponentModel::GetPlayAnimationName()
     return "";
 }
 
+ComponentModelPtr ComponentModel::SetAnimationPriority(Priority prio)
+{
+    animation_priority_ = prio;
+
+    return std::dynamic_pointer_cast<ComponentModel>(shared_from_this());
+}
+
+ComponentModelPtr ComponentModel::SetUseAnimator(bool enable)
+{
+    model_status_.set(ModelBit::UseAnimator, enable);
+
+    if(animation_)
+        animation_->useAnimator(enable);
+
+    return std::dynamic_pointer_cast<ComponentModel>(shared_from_this());
+}
+
+ComponentModelPtr ComponentModel::SetUseRenderQueue(bool enable)
+{
+    model_status_.set(ModelBit::UseRenderQueue, enable);
+
+    return std::dynamic_pointer_cast<ComponentModel>(shared_from_this());
+}
+
 std::vector<std::string_view> ComponentModel::GetNodesName()
 {
     //std::vector<std::string_view> view{};
@@ -335,6 +437,27 @@ const matrix ComponentModel::GetWorldMatrix()
     return mul(GetMatrix(), GetOwner()->GetWorldMatrix());
 }
 
+//! @brief 複数のモデルのワールドMatrixをまとめて計算します
+//! @param models モデルコンポーネント
+
+void ComponentModel::UpdateWorldMatrices(const std::vector<ComponentModelPtr>& models)
+{
+    std::vector<matrix> locals(models.size());
+    std::vector<matrix> parents(models.size());
+    for(size_t i = 0; i < models.size(); ++i) {
+        locals[i]  = models[i]->GetMatrix();
+        parents[i] = models[i]->GetOwner()->GetWorldMatrix();
+    }
+
+    // GetWorldMatrix()と同じく mul(ローカル, 親)
+    simd::multiplyMatrices(locals.data(), parents.data(), locals.data(), models.size());
+
+    for(size_t i = 0; i < models.size(); ++i) {
+        models[i]->world_matrix_       = locals[i];
+        models[i]->world_matrix_ready_ = true;
+    }
+}
+
 //! @brief 1フレーム前のワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 
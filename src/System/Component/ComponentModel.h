@@ -7,6 +7,7 @@
 #include <System/Component/Component.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Graphics/Animation.h>
+#include <System/Graphics/AnimationLod.h>
 #include <System/Object.h>
 
 #include <ImGuizmo/ImGuizmo.h>
@@ -84,8 +85,21 @@ public:
     //! @return アニメーション名
     const std::string_view GetPlayAnimationName();
 
+    //! @brief アニメーション更新の優先度
+    //! @param prio 優先度 (Priority::IFPOSSIBLE の場合は更新数の予算内でのみ姿勢を更新)
+    ComponentModelPtr SetAnimationPriority(Priority prio);
+
+    //! @brief 姿勢をエンジン側のアニメーター(animation::Animator)で計算するかどうか
+    //! @param enable true:エンジン側でサンプリング false:DxLibのアタッチで再生(デフォルト)
+    ComponentModelPtr SetUseAnimator(bool enable = true);
+
     //@}
 
+    //! @brief 描画キューでまとめて描画するかどうか
+    //! @param enable true:Draw処理の最後に同じモデルをまとめて描画 false:描画優先度の順にその場で描画(デフォルト)
+    //! @note 描画キューを使うモデルは描画優先度に関係なく、Draw処理の全ての描画の後に描画されます
+    ComponentModelPtr SetUseRenderQueue(bool enable = true);
+
     //! @brief モデル取得
     //! @return モデル
     std::shared_ptr<Model> GetModelClass() { return model_; }
@@ -116,10 +130,14 @@ public:
         Initialized,         //!< 初期化済み
         ErrorFileNotFound,   //!< ファイル読み込みエラー
         UseShader,           //!< シェーダーを使用する
+        UseAnimator,         //!< エンジン側のアニメーターで姿勢を計算する
+        UseRenderQueue,      //!< 描画キューでまとめて描画する
     };
 
-    bool IsValid() const { return model_status_.is(ModelBit::Initialized); }   //!< モデルが読み込まれているか?
-    bool UseShader() const { return model_status_.is(ModelBit::UseShader); }   //!< シェーダーを利用するか?
+    bool IsValid() const { return model_status_.is(ModelBit::Initialized); }             //!< モデルが読み込まれているか?
+    bool UseShader() const { return model_status_.is(ModelBit::UseShader); }             //!< シェーダーを利用するか?
+    bool UseAnimator() const { return model_status_.is(ModelBit::UseAnimator); }         //!< アニメーターを利用するか?
+    bool UseRenderQueue() const { return model_status_.is(ModelBit::UseRenderQueue); }   //!< 描画キューを利用するか?
 
     //---------------------------------------------------------------------------
     //! @name IMatrixインターフェースの利用するための定義
@@ -134,6 +152,11 @@ public:
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetWorldMatrix() override;
 
+    //! @brief 複数のモデルのワールドMatrixをまとめて計算します
+    //! @param models モデルコンポーネント
+    //! @details GetWorldMatrix()と同じ行列をsimd::multiplyMatrices()で一括計算し、次のDraw()で使用します
+    static void UpdateWorldMatrices(const std::vector<ComponentModelPtr>& models);
+
     //! @brief 1フレーム前のワールドMatrixの取得
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetOldWorldMatrix() override;
@@ -148,6 +171,9 @@ private:
     std::string            path_{};         //!< 読み込みモデル名
     std::shared_ptr<Model> model_;          //!< モデルクラス
 
+    matrix world_matrix_       = matrix::identity();   //!< UpdateWorldMatrices()で計算したワールド行列
+    bool   world_matrix_ready_ = false;                //!< world_matrix_を次のDraw()で使用するか
+
     ImGuizmo::OPERATION gizmo_operation_ = ImGuizmo::TRANSLATE;
     ImGuizmo::MODE      gizmo_mode_      = ImGuizmo::LOCAL;
 
@@ -159,6 +185,17 @@ private:
     std::shared_ptr<Animation> animation_;
     std::string                current_animation_name_;
 
+    //! @brief アニメーション更新 (アニメーションLODで更新頻度を間引く)
+    //! @param delta 1フレームの秒数
+    //! @param mat_world ワールド行列
+    void UpdateAnimation(float delta, const matrix& mat_world);
+
+    Priority animation_priority_ = Priority::NORMAL;                 //!< アニメーション更新の優先度
+    u32      animation_phase_    = GetAnimationLod().issuePhase();   //!< 更新フレームを分散させる位相
+    u32      animation_sampled_  = 0;                                //!< 最後に姿勢を更新したフレーム番号 (AnimationLod)
+    float3   bounds_center_      = float3(0.0f, 0.0f, 0.0f);         //!< 境界球の中心 (モデル空間)
+    f32      bounds_radius_      = -1.0f;                            //!< 境界球の半径 (モデル空間, 負なら未計算)
+
 private:
     //--------------------------------------------------------------------
     //! @name Cereal処理
@@ -11,7 +11,7 @@ Component* ComponentTransform::select_component_ = nullptr;
 
 namespace
 {
-void showGizmo(float* matrix, ImGuizmo::OPERATION ope, ImGuizmo::MODE mode)
+bool showGizmo(float* matrix, ImGuizmo::OPERATION ope, ImGuizmo::MODE mode)
 {
     // Gizmoを表示するためのMatrixをDxLibから取得
     auto camera_view = GetCameraViewMatrix();
@@ -42,41 +42,24 @@ void showGizmo(float* matrix, ImGuizmo::OPERATION ope, ImGuizmo::MODE mode)
     static bool  boundSizingSnap = false;
     ImGuizmo::SetID(0);
     ImGuizmo::AllowAxisFlip(false);   //< これがないとGizmoが反転してしまう
-    ImGuizmo::Manipulate((const float*)&camera_view,
-                         (const float*)&camera_proj,
-                         ope,
-                         mode,
-                         (float*)matrix,
-                         NULL,
-                         false ? &snap[0] : NULL,
-                         boundSizing ? bounds : NULL,
-                         boundSizingSnap ? boundsSnap : NULL);
+    return ImGuizmo::Manipulate((const float*)&camera_view,
+                                (const float*)&camera_proj,
+                                ope,
+                                mode,
+                                (float*)matrix,
+                                NULL,
+                                false ? &snap[0] : NULL,
+                                boundSizing ? bounds : NULL,
+                                boundSizingSnap ? boundsSnap : NULL);
 }
+
 }   // namespace
 
 // ImGuizmoのMatrixからEulerに変換する際に全軸に180度変換がかかってしまうため修正
 void DecomposeMatrixToComponents(const float* matx, float* translation, float* rotation, float* scale)
 {
     ImGuizmo::DecomposeMatrixToComponents(matx, translation, rotation, scale);
-    if(abs(rotation[0]) + abs(rotation[1]) + abs(rotation[2]) > 120 + 120) {
-        rotation[0] -= 180.0f;
-        rotation[1] = -180.0f - rotation[1];
-        rotation[2] -= 180.0f;
-    }
-    if(rotation[0] < -180.0f)
-        rotation[0] += 360.0f;
-    if(rotation[0] > 180.0f)
-        rotation[0] -= 360.0f;
-
-    if(rotation[1] < -180.0f)
-        rotation[1] += 360.0f;
-    if(rotation[1] > 180.0f)
-        rotation[1] -= 360.0f;
-
-    if(rotation[2] < -180.0f)
-        rotation[2] += 360.0f;
-    if(rotation[2] > 180.0f)
-        rotation[2] -= 360.0f;
+    FixEulerRotation(rotation);
 }
 
 void ComponentTransform::PostUpdate()
@@ -93,11 +76,15 @@ void ComponentTransform::GUI()
     assert(GetOwner());
     auto obj_name = GetOwner()->GetName();
 
+    // 編集はコピーに対して行い、変更があった場合のみ反映する (TRSを無効化しないため)
+    matrix transform = GetMatrix();
+    bool   changed   = false;
+
     // 自分が選択されていたらGUI処理する
     // 注意: 複数Gizmoを発生させると全部同じ所で処理されてしまう
     if(is_guizmo_) {
         // Gizmo表示
-        showGizmo(GetMatrixFloat(), gizmo_operation_, gizmo_mode_);
+        changed |= showGizmo(transform.f32_128_0, gizmo_operation_, gizmo_mode_);
 
         // キーにより、Manipulateの処理を変更する
         // TODO : 一旦UE4に合わせておくが、のちにEditor.iniで設定できるようにする
@@ -116,10 +103,10 @@ void ComponentTransform::GUI()
         ImGui::Separator();
         is_guizmo_ = false;
         if(ImGui::TreeNode("Transform")) {
-            ImGui::DragFloat4(u8"Ｘ軸", VectorAxisXFloat(), 0.01f, -10000.0f, 10000.0f, "%.2f");
-            ImGui::DragFloat4(u8"Ｙ軸", VectorAxisYFloat(), 0.01f, -10000.0f, 10000.0f, "%.2f");
-            ImGui::DragFloat4(u8"Ｚ軸", VectorAxisZFloat(), 0.01f, -10000.0f, 10000.0f, "%.2f");
-            ImGui::DragFloat4(u8"座標", TranslateFloat(), 0.01f, -10000.0f, 10000.0f, "%.2f");
+            changed |= ImGui::DragFloat4(u8"Ｘ軸", transform.f32_128_0, 0.01f, -10000.0f, 10000.0f, "%.2f");
+            changed |= ImGui::DragFloat4(u8"Ｙ軸", transform.f32_128_1, 0.01f, -10000.0f, 10000.0f, "%.2f");
+            changed |= ImGui::DragFloat4(u8"Ｚ軸", transform.f32_128_2, 0.01f, -10000.0f, 10000.0f, "%.2f");
+            changed |= ImGui::DragFloat4(u8"座標", transform.f32_128_3, 0.01f, -10000.0f, 10000.0f, "%.2f");
             ImGui::Separator();
             ImGui::TreePop();
         }
@@ -152,13 +139,20 @@ void ComponentTransform::GUI()
         }
 
         // TRSにてマトリクスを再度作成する
-        float* mat = GetMatrixFloat();
+        float* mat = transform.f32_128_0;
         float  matrixTranslation[3], matrixRotation[3], matrixScale[3];
         DecomposeMatrixToComponents(mat, matrixTranslation, matrixRotation, matrixScale);
-        ImGui::DragFloat3(u8"座標(T)", matrixTranslation);
-        ImGui::DragFloat3(u8"回転(R)", matrixRotation);
-        ImGui::DragFloat3(u8"サイズ(S)", matrixScale);
-        ImGuizmo::RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, mat);
+        bool trs_changed = false;
+        trs_changed |= ImGui::DragFloat3(u8"座標(T)", matrixTranslation);
+        trs_changed |= ImGui::DragFloat3(u8"回転(R)", matrixRotation);
+        trs_changed |= ImGui::DragFloat3(u8"サイズ(S)", matrixScale);
+        if(trs_changed) {
+            ImGuizmo::RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, mat);
+            changed = true;
+        }
     }
     ImGui::End();
+
+    if(changed)
+        SetMatrix(transform);
 }
@@ -13,6 +13,76 @@
 // ImGuizmoのMatrixからEulerに変換する際に全軸に180度変換がかかってしまうため修正
 extern void DecomposeMatrixToComponents(const float* matx, float* translation, float* rotation, float* scale);
 
+//! 行列とTRSを並べて保持するトランスフォーム
+//! @details TRSを編集した場合は次に行列が必要になったタイミングで合成します。
+//!          行列を書き換えた場合は、次にTRSが必要になったタイミングで分解します。
+//!          読み取りはGetMatrix()/GetTRS()、書き込みはSetMatrix()/EditTRS()を使用してください。
+class MatrixTRS
+{
+public:
+    //! 書き換え可能な行列の取得
+    //! @attention 書き込みの有無を判別できないため、取得するたびにTRSを無効化します。
+    //!            直接の要素書き換えが必要な場合のみ使用してください
+    matrix& Matrix()
+    {
+        compose();
+        trs_valid_ = false;
+        return matrix_;
+    }
+
+    //! 行列の設定 (TRSは次に必要になったタイミングで分解する)
+    void SetMatrix(const matrix& m)
+    {
+        matrix_       = m;
+        matrix_dirty_ = false;
+        trs_valid_    = false;
+    }
+
+    //! 行列の取得 (TRSは無効化しない)
+    const matrix& GetMatrix()
+    {
+        compose();
+        return matrix_;
+    }
+
+    //! TRSの取得
+    const TRS& GetTRS()
+    {
+        decompose();
+        return trs_;
+    }
+
+    //! 書き換え可能なTRSの取得 (行列は遅延して合成される)
+    TRS& EditTRS()
+    {
+        decompose();
+        matrix_dirty_ = true;
+        return trs_;
+    }
+
+private:
+    void compose()
+    {
+        if(matrix_dirty_) {
+            matrix_       = trs_.toMatrix();
+            matrix_dirty_ = false;
+        }
+    }
+
+    void decompose()
+    {
+        if(!trs_valid_) {
+            trs_       = TRS::fromMatrix(matrix_);
+            trs_valid_ = true;
+        }
+    }
+
+    matrix matrix_       = matrix::identity();
+    TRS    trs_          = {};
+    bool   trs_valid_    = true;    //!< trs_がmatrix_と一致している
+    bool   matrix_dirty_ = false;   //!< trs_の変更がmatrix_に未反映
+};
+
 template <class T>
 class IMatrix
 {
@@ -40,15 +110,41 @@ public:
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetOldWorldMatrix() = 0;
 
+    //! @brief TRS表現の取得
+    //! @return TRSを保持している場合はそのキャッシュ。保持していない場合はnullptr
+    virtual MatrixTRS* TRSCache() { return nullptr; }
+
+    //! @brief 瞬間移動したときに呼ばれます
+    //! @details Teleport()で呼ばれます。SetTranslate()/AddTranslate()による移動では呼ばれません
+    virtual void OnTeleport() {}
+
     //! @brief TransformのMatrix情報を取得します
     //! @return Transform の Matrix
     const matrix GetMatrix()
     {
+        if(auto trs = TRSCache())
+            return trs->GetMatrix();
+
         return Matrix();
     }
 
+    //! @brief TRS情報を取得します
+    //! @return Transform の TRS
+    const TRS GetTRS()
+    {
+        if(auto trs = TRSCache())
+            return trs->GetTRS();
+
+        return TRS::fromMatrix(GetMatrix());
+    }
+
     auto SetMatrix(const matrix& mat)
     {
+        if(auto trs = TRSCache()) {
+            trs->SetMatrix(mat);
+            return SharedThis();
+        }
+
         Matrix() = mat;
         return SharedThis();
     }
@@ -70,9 +166,22 @@ public:
     //! @brief 位置をセットします
     //! @param translate 位置
     //! @return 自分のSharedPtr
+    //! @details 毎フレームの移動に使用できます (前フレームからの移動経路で連続判定されます)
     auto SetTranslate(float3 translate)
     {
-        (float4&)Matrix().translateVector() = {translate, 1};
+        writeTranslate(translate);
+
+        return SharedThis();
+    }
+
+    //! @brief 瞬間移動させます
+    //! @param translate 位置
+    //! @return 自分のSharedPtr
+    //! @details 前フレームの位置からの移動経路では連続判定しません (リスポーンやワープ用)
+    auto Teleport(float3 translate)
+    {
+        writeTranslate(translate);
+        OnTeleport();
 
         return SharedThis();
     }
@@ -82,7 +191,7 @@ public:
     //! @return 自分のSharedPtr
     auto AddTranslate(float3 translate)
     {
-        SetTranslate(GetTranslate() + translate);
+        writeTranslate(GetTranslate() + translate);
 
         return SharedThis();
     }
@@ -261,20 +370,32 @@ public:
         return SetVectorAxisZ(vec);
     }
 
+    //! @brief 回転を設定する
+    //! @param rotate 回転クォータニオン
+    //! @return 自分のSharedPtr
+    auto SetRotation(const quaternion& rotate)
+    {
+        return modifyTRS([&](TRS& trs) { trs.rotate_ = normalize(rotate); });
+    }
+
+    //! @brief 現在の回転の後に回転を追加する
+    //! @param rotate 回転クォータニオン
+    //! @return 自分のSharedPtr
+    auto AddRotation(const quaternion& rotate)
+    {
+        return modifyTRS([&](TRS& trs) { trs.rotate_ = normalize(mul(rotate, trs.rotate_)); });
+    }
+
+    //! @brief 回転を取得する
+    //! @return 回転クォータニオン
+    const quaternion GetRotation() { return GetTRS().rotate_; }
+
     //! @brief 軸回転量を設定する
     //! @param xyz 軸に合わせた回転量
     //! @return 自分のSharedPtr
     auto SetRotationAxisXYZ(float3 xyz)
     {
-        float matrixTranslation[3], matrixRotation[3], matrixScale[3];
-        DecomposeMatrixToComponents(GetMatrixFloat(), matrixTranslation, matrixRotation, matrixScale);
-
-        matrixRotation[0] = xyz.x;
-        matrixRotation[1] = xyz.y;
-        matrixRotation[2] = xyz.z;
-
-        ImGuizmo::RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, GetMatrixFloat());
-        return SharedThis();
+        return modifyTRS([&](TRS& trs) { trs.rotate_ = EulerAxisXYZToQuaternion(xyz); });
     }
 
     [[deprecated("古い命名です。SetRotationAxisXYZ()に変更してください")]] auto SetRotationXYZAxis(float3 xyz)
@@ -285,17 +406,11 @@ public:
     //! @brief 軸回転量を現在の状態から追加する
     //! @param xyz 軸に合わせた回転量
     //! @return 自分のSharedPtr
+    //! @note 毎フレーム回転させる場合はオイラー角の変換が不要なAddRotation()の方が高速です
     auto AddRotationAxisXYZ(float3 xyz)
     {
-        float matrixTranslation[3], matrixRotation[3], matrixScale[3];
-        DecomposeMatrixToComponents(GetMatrixFloat(), matrixTranslation, matrixRotation, matrixScale);
-
-        matrixRotation[0] += xyz.x;
-        matrixRotation[1] += xyz.y;
-        matrixRotation[2] += xyz.z;
-
-        ImGuizmo::RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, GetMatrixFloat());
-        return SharedThis();
+        return modifyTRS(
+            [&](TRS& trs) { trs.rotate_ = EulerAxisXYZToQuaternion(QuaternionToEulerAxisXYZ(trs.rotate_) + xyz); });
     }
 
     [[deprecated("古い命名です。AddRotationAxisXYZ()に変更してください")]] auto AddRotationXYZAxis(float3 xyz)
@@ -308,10 +423,7 @@ public:
     //! @return xyzローテート量
     const float3 GetRotationAxisXYZ()
     {
-        float matrixTranslation[3], matrixRotation[3], matrixScale[3];
-        DecomposeMatrixToComponents(GetMatrixFloat(), matrixTranslation, matrixRotation, matrixScale);
-
-        return *(float3*)matrixRotation;
+        return QuaternionToEulerAxisXYZ(GetTRS().rotate_);
     }
 
     [[deprecated("古い命名です。GetRotationAxisXYZ()に変更してください")]] const float GetRotationXYZAxis()
@@ -324,15 +436,7 @@ public:
     //! @return 自分のSharedPtr
     auto SetScaleAxisXYZ(float3 scale)
     {
-        float matrixTranslation[3], matrixRotation[3], matrixScale[3];
-        DecomposeMatrixToComponents(GetMatrixFloat(), matrixTranslation, matrixRotation, matrixScale);
-
-        matrixScale[0] = scale.x;
-        matrixScale[1] = scale.y;
-        matrixScale[2] = scale.z;
-
-        ImGuizmo::RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, GetMatrixFloat());
-        return SharedThis();
+        return modifyTRS([&](TRS& trs) { trs.scale_ = scale; });
     }
 
     [[deprecated("古い命名です。SetScaleAxisXYZ()に変更してください")]] auto SetScaleXYZAxis(float3 vec)
@@ -345,15 +449,7 @@ public:
     //! @return 自分のSharedPtr
     auto MulScaleAxisXYZ(float3 scale)
     {
-        float matrixTranslation[3], matrixRotation[3], matrixScale[3];
-        DecomposeMatrixToComponents(GetMatrixFloat(), matrixTranslation, matrixRotation, matrixScale);
-
-        matrixScale[0] *= scale.x;
-        matrixScale[1] *= scale.y;
-        matrixScale[2] *= scale.z;
-
-        ImGuizmo::RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, GetMatrixFloat());
-        return SharedThis();
+        return modifyTRS([&](TRS& trs) { trs.scale_ *= scale; });
     }
 
     [[deprecated("古い命名です。SetScaleAxisXYZ()に変更してください")]] auto MulScaleXYZAxis(float3 vec)
@@ -366,16 +462,40 @@ public:
     //! @return スケール値
     const float3 GetScaleAxisXYZ()
     {
-        float matrixTranslation[3], matrixRotation[3], matrixScale[3];
-        DecomposeMatrixToComponents(GetMatrixFloat(), matrixTranslation, matrixRotation, matrixScale);
-
-        return *(float3*)matrixScale;
+        return GetTRS().scale_;
     }
 
     [[deprecated("古い命名です。GetScaleAxisXYZ()に変更してください")]] const float3 GetScaleXYZAxis(float3 vec)
     {
         return GetScaleAxisXYZ(vec);
     }
+
+private:
+    //! TRSを編集して行列へ反映する
+    //! @details TRSを保持している場合は行列の合成を必要になるまで遅らせる
+    template <class Func>
+    auto modifyTRS(Func func)
+    {
+        if(auto trs = TRSCache()) {
+            func(trs->EditTRS());
+            return SharedThis();
+        }
+
+        TRS trs = TRS::fromMatrix(GetMatrix());
+        func(trs);
+        return SetMatrix(trs.toMatrix());
+    }
+
+    //! @brief 位置を書き込みます
+    void writeTranslate(const float3& translate)
+    {
+        if(auto trs = TRSCache()) {
+            trs->EditTRS().translate_ = translate;
+            return;
+        }
+
+        (float4&)Matrix().translateVector() = {translate, 1};
+    }
 };
 
 USING_PTR(ComponentTransform);
@@ -391,7 +511,7 @@ public:
     ComponentTransform(ObjectPtr owner)
         : Component(owner)
     {
-        Matrix() = matrix::identity();
+        transform_.SetMatrix(matrix::identity());
     }
 
     virtual void PostUpdate() override;
@@ -402,7 +522,9 @@ public:
     //---------------------------------------------------------------------------
     //@{
 
-    matrix& Matrix() override { return transform_; }   //!< マトリクス取得
+    matrix& Matrix() override { return transform_.Matrix(); }   //!< マトリクス取得
+
+    MatrixTRS* TRSCache() override { return &transform_; }   //!< TRS取得
 
     ComponentTransformPtr SharedThis() override
     {
@@ -419,8 +541,8 @@ public:
     //@}
 
 private:
-    matrix transform_;
-    matrix old_transform_;   //!< 1フレーム前の位置
+    MatrixTRS transform_;       //!< 位置 (行列とTRSを並べて保持)
+    matrix    old_transform_;   //!< 1フレーム前の位置
 
     bool                is_guizmo_       = false;                 //!< ギズモ使用
     ImGuizmo::OPERATION gizmo_operation_ = ImGuizmo::TRANSLATE;   //!< Gizmo処理選択
@@ -434,9 +556,15 @@ private:
     //@{
     CEREAL_SAVELOAD(arc, ver)
     {
+        // 保存時にTRSを無効化しないよう、行列をコピーして読み書きする
+        matrix transform = transform_.GetMatrix();
+
         arc(cereal::make_nvp("owner", owner_));
-        arc(cereal::make_nvp("transform", transform_));
-        arc(cereal::make_nvp("old_transform", transform_));
+        arc(cereal::make_nvp("transform", transform));
+        arc(cereal::make_nvp("old_transform", transform));
+
+        if constexpr(Archive::is_loading::value)
+            transform_.SetMatrix(transform);
     }
 
     CEREAL_LOAD_AND_CONSTRUCT(ComponentTransform, arc, ver)
@@ -446,7 +574,9 @@ private:
         arc(CEREAL_NVP(owner));
         construct(owner);
 
-        arc(cereal::make_nvp("transform", construct->transform_));
+        matrix transform;
+        arc(cereal::make_nvp("transform", transform));
+        construct->transform_.SetMatrix(transform);
     }
     //@}
 };
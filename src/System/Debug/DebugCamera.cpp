@@ -42,11 +42,11 @@ public:
     {
         auto cam = GetComponent<ComponentCamera>();
 
-        auto LR = (GetMouseInput() & (MOUSE_INPUT_LEFT | MOUSE_INPUT_RIGHT)) == (MOUSE_INPUT_LEFT | MOUSE_INPUT_RIGHT);
-        auto M  = (GetMouseInput() & MOUSE_INPUT_MIDDLE);
+        auto LR = (GetMouseButtons() & (MOUSE_INPUT_LEFT | MOUSE_INPUT_RIGHT)) == (MOUSE_INPUT_LEFT | MOUSE_INPUT_RIGHT);
+        auto M  = (GetMouseButtons() & MOUSE_INPUT_MIDDLE);
 
-        [[maybe_unused]] auto L = (GetMouseInput() & MOUSE_INPUT_LEFT);
-        auto                  R = (GetMouseInput() & MOUSE_INPUT_RIGHT);
+        [[maybe_unused]] auto L = (GetMouseButtons() & MOUSE_INPUT_LEFT);
+        auto                  R = (GetMouseButtons() & MOUSE_INPUT_RIGHT);
 
         float2 mouse_now = float2{GetMouseX(), GetMouseY()};
         mouse_vec_       = mouse_now - mouse_xy_;
@@ -61,7 +61,7 @@ public:
             float3 front = -back;
 
             // wheel
-            wheel_val = GetMouseWheelRotVolF();
+            wheel_val = GetMouseWheel();
 
             if(wheel_val != 0) {
                 front *= wheel_val * 10;
@@ -7,246 +7,247 @@
 namespace
 {
 
-//---------------------------------------------------------------------------
-f32 easeInSine(f32 t)
+//===========================================================================
+// 4要素同時の実装 (ease::の各関数と同じ式)
+//===========================================================================
+
+//! 条件選択 (t < edge の要素は a、それ以外は b)
+//! @note ビット選択のため、選ばれない側がNaNでも影響しません
+float4 selectLess(const float4& t, f32 edge, const float4& a, const float4& b)
 {
-    return sinf(PI * 0.5f * t);
+    return float4(_hlslpp_sel_ps(b.vec, a.vec, _hlslpp_cmplt_ps(t.vec, float4(edge).vec)));
 }
 
 //---------------------------------------------------------------------------
-f32 easeOutSine(f32 t)
+float4 inSine(const float4& t)
 {
-    t -= 1.0f;
-    return 1.0f + sinf(PI * 0.5f * t);
+    return sin(t * (PI * 0.5f));
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutSine(f32 t)
+float4 outSine(const float4& t)
 {
-    return 0.5f * (1.0f + sinf(PI * (t - 0.5f)));
+    return 1.0f + sin((t - 1.0f) * (PI * 0.5f));
+}
+
+float4 inOutSine(const float4& t)
+{
+    return 0.5f * (1.0f + sin(PI * (t - 0.5f)));
 }
 
 //---------------------------------------------------------------------------
-f32 easeInQuad(f32 t)
+float4 inQuad(const float4& t)
 {
     return t * t;
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutQuad(f32 t)
+float4 outQuad(const float4& t)
 {
     return t * (2.0f - t);
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutQuad(f32 t)
+float4 inOutQuad(const float4& t)
 {
-    return t < 0.5f ? 2.0f * t * t : t * (4.0f - 2.0f * t) - 1.0f;
+    return selectLess(t, 0.5f, 2.0f * t * t, t * (4.0f - 2.0f * t) - 1.0f);
 }
 
 //---------------------------------------------------------------------------
-f32 easeInCubic(f32 t)
+float4 inCubic(const float4& t)
 {
     return t * t * t;
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutCubic(f32 t)
+float4 outCubic(const float4& t)
 {
-    t -= 1.0f;
-    return 1.0f + t * t * t;
+    float4 u = t - 1.0f;
+    return 1.0f + u * u * u;
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutCubic(f32 t)
+float4 inOutCubic(const float4& t)
 {
-    return t < 0.5f ? 4.0f * t * t * t : 1.0f - powf(-2.0f * t + 2.0f, 3.0f) / 2.0f;
+    float4 u = -2.0f * t + 2.0f;
+    return selectLess(t, 0.5f, 4.0f * t * t * t, 1.0f - u * u * u * 0.5f);
 }
 
 //---------------------------------------------------------------------------
-f32 easeInQuart(f32 t)
+float4 inQuart(const float4& t)
 {
-    t *= t;
-    return t * t;
+    float4 t2 = t * t;
+    return t2 * t2;
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutQuart(f32 t)
+float4 outQuart(const float4& t)
 {
-    t -= 1.0f;
-    t = t * t;
-    return 1 - t * t;
+    float4 u  = t - 1.0f;
+    float4 u2 = u * u;
+    return 1.0f - u2 * u2;
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutQuart(f32 t)
+float4 inOutQuart(const float4& t)
 {
-    if(t < 0.5f) {
-        t *= t;
-        return 8.0f * t * t;
-    }
-    else {
-        t -= 1.0f;
-        t = t * t;
-        return 1.0f - 8.0f * t * t;
-    }
+    float4 t2 = t * t;
+    float4 u  = t - 1.0f;
+    float4 u2 = u * u;
+    return selectLess(t, 0.5f, 8.0f * t2 * t2, 1.0f - 8.0f * u2 * u2);
 }
 
 //---------------------------------------------------------------------------
-f32 easeInQuint(f32 t)
+float4 inQuint(const float4& t)
 {
-    f32 t2 = t * t;
+    float4 t2 = t * t;
     return t * t2 * t2;
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutQuint(f32 t)
+float4 outQuint(const float4& t)
 {
-    t -= 1.0f;
-    f32 t2 = t * t;
-    return 1.0f + t * t2 * t2;
+    float4 u  = t - 1.0f;
+    float4 u2 = u * u;
+    return 1.0f + u * u2 * u2;
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutQuint(f32 t)
+float4 inOutQuint(const float4& t)
 {
-    f32 t2;
-    if(t < 0.5f) {
-        t2 = t * t;
-        return 16.0f * t * t2 * t2;
-    }
-    else {
-        t -= 1.0f;
-        t2 = t * t;
-        return 1.0f + 16.0f * t * t2 * t2;
-    }
+    float4 t2 = t * t;
+    float4 u  = t - 1.0f;
+    float4 u2 = u * u;
+    return selectLess(t, 0.5f, 16.0f * t * t2 * t2, 1.0f + 16.0f * u * u2 * u2);
 }
 
 //---------------------------------------------------------------------------
-f32 easeInExpo(f32 t)
+float4 inExpo(const float4& t)
 {
-    return (powf(2.0f, 8.0f * t) - 1.0f) / 255.0f;
+    return (exp2(8.0f * t) - 1.0f) / 255.0f;
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutExpo(f32 t)
+float4 outExpo(const float4& t)
 {
-    return 1.0f - powf(2.0f, -8.0f * t);
+    return 1.0f - exp2(-8.0f * t);
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutExpo(f32 t)
+float4 inOutExpo(const float4& t)
 {
-    if(t < 0.5f) {
-        return (powf(2.0f, 16.0f * t) - 1.0f) / 510.0f;
-    }
-    else {
-        return 1.0f - 0.5f * powf(2.0f, -16.0f * (t - 0.5f));
-    }
+    return selectLess(t, 0.5f, (exp2(16.0f * t) - 1.0f) / 510.0f, 1.0f - 0.5f * exp2(-16.0f * (t - 0.5f)));
 }
 
 //---------------------------------------------------------------------------
-f32 easeInCirc(f32 t)
+float4 inCirc(const float4& t)
 {
-    return 1.0f - sqrtf(1.0f - t);
+    return 1.0f - sqrt(1.0f - t);
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutCirc(f32 t)
+float4 outCirc(const float4& t)
 {
-    return sqrtf(t);
+    return sqrt(t);
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutCirc(f32 t)
+float4 inOutCirc(const float4& t)
 {
-    if(t < 0.5f) {
-        return (1.0f - sqrtf(1.0f - 2.0f * t)) * 0.5f;
-    }
-    else {
-        return (1.0f + sqrtf(2.0f * t - 1.0f)) * 0.5f;
-    }
+    return selectLess(t, 0.5f, (1.0f - sqrt(1.0f - 2.0f * t)) * 0.5f, (1.0f + sqrt(2.0f * t - 1.0f)) * 0.5f);
 }
 
 //---------------------------------------------------------------------------
-f32 easeInBack(f32 t)
+float4 inBack(const float4& t)
 {
     return t * t * (2.70158f * t - 1.70158f);
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutBack(f32 t)
+float4 outBack(const float4& t)
 {
-    t -= 1.0f;
-    return 1.0f + t * t * (2.70158f * t + 1.70158f);
+    float4 u = t - 1.0f;
+    return 1.0f + u * u * (2.70158f * u + 1.70158f);
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutBack(f32 t)
+float4 inOutBack(const float4& t)
 {
-    if(t < 0.5f) {
-        return t * t * (7.0f * t - 2.5f) * 2.0f;
-    }
-    else {
-        t -= 1.0f;
-        return 1.0f + t * t * 2.0f * (7.0f * t + 2.5f);
-    }
+    float4 u = t - 1.0f;
+    return selectLess(t, 0.5f, t * t * (7.0f * t - 2.5f) * 2.0f, 1.0f + u * u * 2.0f * (7.0f * u + 2.5f));
 }
 
 //---------------------------------------------------------------------------
-f32 easeInElastic(f32 t)
+float4 inElastic(const float4& t)
 {
-    f32 t2 = t * t;
-    return t2 * t2 * sinf(t * PI * 4.5f);
+    float4 t2 = t * t;
+    return t2 * t2 * sin(t * (PI * 4.5f));
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutElastic(f32 t)
+float4 outElastic(const float4& t)
 {
-    f32 t2 = (t - 1.0f) * (t - 1.0f);
-    return 1.0f - t2 * t2 * cosf(t * PI * 4.5f);
+    float4 u2 = (t - 1.0f) * (t - 1.0f);
+    return 1.0f - u2 * u2 * cos(t * (PI * 4.5f));
 }
 
-//---------------------------------------------------------------------------
-f32 easeInOutElastic(f32 t)
+float4 inOutElastic(const float4& t)
 {
-    f32 t2;
-    if(t < 0.45f) {
-        t2 = t * t;
-        return 8.0f * t2 * t2 * sinf(t * PI * 9.0f);
-    }
-    else if(t < 0.55f) {
-        return 0.5f + 0.75f * sinf(t * PI * 4.0f);
-    }
-    else {
-        t2 = (t - 1.0f) * (t - 1.0f);
-        return 1.0f - 8.0f * t2 * t2 * sinf(t * PI * 9.0f);
-    }
+    float4 t2 = t * t;
+    float4 u2 = (t - 1.0f) * (t - 1.0f);
+    float4 s  = sin(t * (PI * 9.0f));
+    return selectLess(t,
+                      0.45f,
+                      8.0f * t2 * t2 * s,
+                      selectLess(t, 0.55f, 0.5f + 0.75f * sin(t * (PI * 4.0f)), 1.0f - 8.0f * u2 * u2 * s));
 }
 
 //---------------------------------------------------------------------------
-f32 easeInBounce(f32 t)
+float4 inBounce(const float4& t)
 {
-    return powf(2.0f, 6.0f * (t - 1.0f)) * fabsf(sinf(t * PI * 3.5f));
+    return exp2(6.0f * (t - 1.0f)) * abs(sin(t * (PI * 3.5f)));
 }
 
-//---------------------------------------------------------------------------
-f32 easeOutBounce(f32 t)
+float4 outBounce(const float4& t)
+{
+    return 1.0f - exp2(-6.0f * t) * abs(cos(t * (PI * 3.5f)));
+}
+
+float4 inOutBounce(const float4& t)
 {
-    return 1.0f - powf(2.0f, -6.0f * t) * fabsf(cosf(t * PI * 3.5f));
+    float4 s = abs(sin(t * (PI * 7.0f)));
+    return selectLess(t, 0.5f, 8.0f * exp2(8.0f * (t - 1.0f)) * s, 1.0f - 8.0f * exp2(-8.0f * t) * s);
 }
 
 //---------------------------------------------------------------------------
-f32 easeInOutBounce(f32 t)
+//! 配列を4要素ずつ評価
+//! @tparam Func    4要素同時の実装 (コンパイル時に選択してインライン展開)
+//---------------------------------------------------------------------------
+template <float4 (*Func)(const float4&)>
+void evaluateBatch(const f32* t, f32* out, size_t count)
 {
-    if(t < 0.5f) {
-        return 8.0f * powf(2, 8.0f * (t - 1.0f)) * fabsf(sinf(t * PI * 7.0f));
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float4 v;
+        load(v, const_cast<f32*>(t + i));
+        store(Func(v), out + i);
     }
-    else {
-        return 1.0f - 8.0f * powf(2.0f, -8.0f * t) * fabsf(sinf(t * PI * 7.0f));
+
+    // 端数は4要素に詰めて評価
+    if(i < count) {
+        f32 values[4] = {};
+        std::copy(t + i, t + count, values);
+
+        float4 v;
+        load(v, values);
+        store(Func(v), values);
+        std::copy(values, values + (count - i), out + i);
     }
 }
 
+//! 一括評価関数テーブル (EaseTypeの順)
+using BatchFunction = void (*)(const f32* t, f32* out, size_t count);
+
+constexpr BatchFunction BATCH_FUNCTIONS[] = {
+    evaluateBatch<inSine>,    evaluateBatch<outSine>,    evaluateBatch<inOutSine>,
+    evaluateBatch<inQuad>,    evaluateBatch<outQuad>,    evaluateBatch<inOutQuad>,
+    evaluateBatch<inCubic>,   evaluateBatch<outCubic>,   evaluateBatch<inOutCubic>,
+    evaluateBatch<inQuart>,   evaluateBatch<outQuart>,   evaluateBatch<inOutQuart>,
+    evaluateBatch<inQuint>,   evaluateBatch<outQuint>,   evaluateBatch<inOutQuint>,
+    evaluateBatch<inExpo>,    evaluateBatch<outExpo>,    evaluateBatch<inOutExpo>,
+    evaluateBatch<inCirc>,    evaluateBatch<outCirc>,    evaluateBatch<inOutCirc>,
+    evaluateBatch<inBack>,    evaluateBatch<outBack>,    evaluateBatch<inOutBack>,
+    evaluateBatch<inElastic>, evaluateBatch<outElastic>, evaluateBatch<inOutElastic>,
+    evaluateBatch<inBounce>,  evaluateBatch<outBounce>,  evaluateBatch<inOutBounce>,
+};
+
+static_assert(std::size(EASE_FUNCTIONS) == static_cast<size_t>(EaseType::InOutBounce) + 1);
+static_assert(std::size(BATCH_FUNCTIONS) == std::size(EASE_FUNCTIONS));
+
 }   // namespace
 
 //---------------------------------------------------------------------------
@@ -260,14 +261,15 @@ size_t GetEaseFunctionMaxCount()
 //---------------------------------------------------------------------------
 //! Easeカーブ関数を取得
 //---------------------------------------------------------------------------
-std::function<f32(f32)> GetEaseFunction(EaseType type)
-{
-    static std::function<f32(f32)> function[] = {
-        easeInSine,    easeOutSine,    easeInOutSine,    easeInQuad,   easeOutQuad,   easeInOutQuad,
-        easeInCubic,   easeOutCubic,   easeInOutCubic,   easeInQuart,  easeOutQuart,  easeInOutQuart,
-        easeInQuint,   easeOutQuint,   easeInOutQuint,   easeInExpo,   easeOutExpo,   easeInOutExpo,
-        easeInCirc,    easeOutCirc,    easeInOutCirc,    easeInBack,   easeOutBack,   easeInOutBack,
-        easeInElastic, easeOutElastic, easeInOutElastic, easeInBounce, easeOutBounce, easeInOutBounce,
-    };
-    return function[static_cast<u32>(type)];
+EaseFunction GetEaseFunction(EaseType type)
+{
+    return EASE_FUNCTIONS[static_cast<u32>(type)];
+}
+
+//---------------------------------------------------------------------------
+//! Easeカーブを一括評価
+//---------------------------------------------------------------------------
+void EaseEvaluate(EaseType type, const f32* t, f32* out, size_t count)
+{
+    BATCH_FUNCTIONS[static_cast<u32>(type)](t, out, count);
 }
@@ -41,10 +41,300 @@ enum class EaseType : u32
     InOutBounce
 };
 
+//! Easeカーブ関数
+using EaseFunction = f32 (*)(f32 t);
+
+//---------------------------------------------------------------------------
+//! Easeカーブ関数の実装 (t = 0.0f～1.0f)
+//---------------------------------------------------------------------------
+namespace ease
+{
+
+//---------------------------------------------------------------------------
+inline f32 inSine(f32 t)
+{
+    return sinf(PI * 0.5f * t);
+}
+
+//---------------------------------------------------------------------------
+inline f32 outSine(f32 t)
+{
+    t -= 1.0f;
+    return 1.0f + sinf(PI * 0.5f * t);
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutSine(f32 t)
+{
+    return 0.5f * (1.0f + sinf(PI * (t - 0.5f)));
+}
+
+//---------------------------------------------------------------------------
+inline f32 inQuad(f32 t)
+{
+    return t * t;
+}
+
+//---------------------------------------------------------------------------
+inline f32 outQuad(f32 t)
+{
+    return t * (2.0f - t);
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutQuad(f32 t)
+{
+    return t < 0.5f ? 2.0f * t * t : t * (4.0f - 2.0f * t) - 1.0f;
+}
+
+//---------------------------------------------------------------------------
+inline f32 inCubic(f32 t)
+{
+    return t * t * t;
+}
+
+//---------------------------------------------------------------------------
+inline f32 outCubic(f32 t)
+{
+    t -= 1.0f;
+    return 1.0f + t * t * t;
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutCubic(f32 t)
+{
+    return t < 0.5f ? 4.0f * t * t * t : 1.0f - powf(-2.0f * t + 2.0f, 3.0f) / 2.0f;
+}
+
+//---------------------------------------------------------------------------
+inline f32 inQuart(f32 t)
+{
+    t *= t;
+    return t * t;
+}
+
+//---------------------------------------------------------------------------
+inline f32 outQuart(f32 t)
+{
+    t -= 1.0f;
+    t = t * t;
+    return 1 - t * t;
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutQuart(f32 t)
+{
+    if(t < 0.5f) {
+        t *= t;
+        return 8.0f * t * t;
+    }
+    else {
+        t -= 1.0f;
+        t = t * t;
+        return 1.0f - 8.0f * t * t;
+    }
+}
+
+//---------------------------------------------------------------------------
+inline f32 inQuint(f32 t)
+{
+    f32 t2 = t * t;
+    return t * t2 * t2;
+}
+
+//---------------------------------------------------------------------------
+inline f32 outQuint(f32 t)
+{
+    t -= 1.0f;
+    f32 t2 = t * t;
+    return 1.0f + t * t2 * t2;
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutQuint(f32 t)
+{
+    f32 t2;
+    if(t < 0.5f) {
+        t2 = t * t;
+        return 16.0f * t * t2 * t2;
+    }
+    else {
+        t -= 1.0f;
+        t2 = t * t;
+        return 1.0f + 16.0f * t * t2 * t2;
+    }
+}
+
+//---------------------------------------------------------------------------
+inline f32 inExpo(f32 t)
+{
+    return (powf(2.0f, 8.0f * t) - 1.0f) / 255.0f;
+}
+
+//---------------------------------------------------------------------------
+inline f32 outExpo(f32 t)
+{
+    return 1.0f - powf(2.0f, -8.0f * t);
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutExpo(f32 t)
+{
+    if(t < 0.5f) {
+        return (powf(2.0f, 16.0f * t) - 1.0f) / 510.0f;
+    }
+    else {
+        return 1.0f - 0.5f * powf(2.0f, -16.0f * (t - 0.5f));
+    }
+}
+
+//---------------------------------------------------------------------------
+inline f32 inCirc(f32 t)
+{
+    return 1.0f - sqrtf(1.0f - t);
+}
+
+//---------------------------------------------------------------------------
+inline f32 outCirc(f32 t)
+{
+    return sqrtf(t);
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutCirc(f32 t)
+{
+    if(t < 0.5f) {
+        return (1.0f - sqrtf(1.0f - 2.0f * t)) * 0.5f;
+    }
+    else {
+        return (1.0f + sqrtf(2.0f * t - 1.0f)) * 0.5f;
+    }
+}
+
+//---------------------------------------------------------------------------
+inline f32 inBack(f32 t)
+{
+    return t * t * (2.70158f * t - 1.70158f);
+}
+
+//---------------------------------------------------------------------------
+inline f32 outBack(f32 t)
+{
+    t -= 1.0f;
+    return 1.0f + t * t * (2.70158f * t + 1.70158f);
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutBack(f32 t)
+{
+    if(t < 0.5f) {
+        return t * t * (7.0f * t - 2.5f) * 2.0f;
+    }
+    else {
+        t -= 1.0f;
+        return 1.0f + t * t * 2.0f * (7.0f * t + 2.5f);
+    }
+}
+
+//---------------------------------------------------------------------------
+inline f32 inElastic(f32 t)
+{
+    f32 t2 = t * t;
+    return t2 * t2 * sinf(t * PI * 4.5f);
+}
+
+//---------------------------------------------------------------------------
+inline f32 outElastic(f32 t)
+{
+    f32 t2 = (t - 1.0f) * (t - 1.0f);
+    return 1.0f - t2 * t2 * cosf(t * PI * 4.5f);
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutElastic(f32 t)
+{
+    f32 t2;
+    if(t < 0.45f) {
+        t2 = t * t;
+        return 8.0f * t2 * t2 * sinf(t * PI * 9.0f);
+    }
+    else if(t < 0.55f) {
+        return 0.5f + 0.75f * sinf(t * PI * 4.0f);
+    }
+    else {
+        t2 = (t - 1.0f) * (t - 1.0f);
+        return 1.0f - 8.0f * t2 * t2 * sinf(t * PI * 9.0f);
+    }
+}
+
+//---------------------------------------------------------------------------
+inline f32 inBounce(f32 t)
+{
+    return powf(2.0f, 6.0f * (t - 1.0f)) * fabsf(sinf(t * PI * 3.5f));
+}
+
+//---------------------------------------------------------------------------
+inline f32 outBounce(f32 t)
+{
+    return 1.0f - powf(2.0f, -6.0f * t) * fabsf(cosf(t * PI * 3.5f));
+}
+
+//---------------------------------------------------------------------------
+inline f32 inOutBounce(f32 t)
+{
+    if(t < 0.5f) {
+        return 8.0f * powf(2, 8.0f * (t - 1.0f)) * fabsf(sinf(t * PI * 7.0f));
+    }
+    else {
+        return 1.0f - 8.0f * powf(2.0f, -8.0f * t) * fabsf(sinf(t * PI * 7.0f));
+    }
+}
+
+}   // namespace ease
+
+//! Easeカーブ関数テーブル (EaseTypeの順)
+inline constexpr EaseFunction EASE_FUNCTIONS[] = {
+    ease::inSine,    ease::outSine,    ease::inOutSine,
+    ease::inQuad,    ease::outQuad,    ease::inOutQuad,
+    ease::inCubic,   ease::outCubic,   ease::inOutCubic,
+    ease::inQuart,   ease::outQuart,   ease::inOutQuart,
+    ease::inQuint,   ease::outQuint,   ease::inOutQuint,
+    ease::inExpo,    ease::outExpo,    ease::inOutExpo,
+    ease::inCirc,    ease::outCirc,    ease::inOutCirc,
+    ease::inBack,    ease::outBack,    ease::inOutBack,
+    ease::inElastic, ease::outElastic, ease::inOutElastic,
+    ease::inBounce,  ease::outBounce,  ease::inOutBounce,
+};
+
+//---------------------------------------------------------------------------
+//! Easeカーブのファンクタ
+//! カーブの種類をテンプレート引数で選択するため、関数呼び出しがインライン展開されます
+//! @code
+//!     Ease<EaseType::InOutCubic> ease;
+//!     f32 ratio = ease(t);
+//! @endcode
+//---------------------------------------------------------------------------
+template <EaseType Type>
+struct Ease
+{
+    static constexpr EaseFunction function = EASE_FUNCTIONS[static_cast<u32>(Type)];   //!< カーブ関数
+
+    f32 operator()(f32 t) const { return function(t); }
+};
+
 //  Easeカーブ関数の種類の最大個数を取得
 size_t GetEaseFunctionMaxCount();
 
 //  Easeカーブ関数を取得
 //! @param  [in]    type    カーブの種類
-//! @return カーブ関数。std::function<f32(f32)>で受け取ります。
-std::function<f32(f32)> GetEaseFunction(EaseType type);
+//! @return カーブ関数 (関数ポインター)
+EaseFunction GetEaseFunction(EaseType type);
+
+//  Easeカーブを一括評価 (SIMD)
+//! @param  [in]    type    カーブの種類
+//! @param  [in]    t       入力値の配列 (0.0f～1.0f)
+//! @param  [out]   out     出力値の配列 (t と同じ配列でもよい)
+//! @param  [in]    count   要素数
+//! @note sin/pow/sqrtをhlslppの多項式近似で4要素ずつ計算します。
+//!       GetEaseFunction()の関数との誤差は2e-6程度です
+void EaseEvaluate(EaseType type, const f32* t, f32* out, size_t count);
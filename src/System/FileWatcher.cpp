@@ -3,136 +3,488 @@
 //! @brief  ファイル変更監視
 //---------------------------------------------------------------------------
 #include "FileWatcher.h"
+
+#include <algorithm>
+#include <chrono>
 #include <locale>
+#include <unordered_map>
 
-//---------------------------------------------------------------------------
-//! 初期化
-//---------------------------------------------------------------------------
-bool FileWatcher::initialize(const wchar_t* path, std::function<void(const wchar_t*)> callback)
+#if defined(_WIN32)
+#include <windows.h>   // テスト(Test)ではDxLib経由で読み込まれないため
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
 {
-    callback_ = callback;
 
-    // フルパスに変換
+#if defined(_WIN32)
+//===========================================================================
+//! [Windows] ReadDirectoryChangesW による監視
+//===========================================================================
+class FileWatcherBackendWin32 final : public FileWatcherBackend
+{
+public:
+    ~FileWatcherBackendWin32() override
     {
-        auto size = GetFullPathNameW(path, 0, nullptr, nullptr);
-        full_path_.resize(size);
-        GetFullPathNameW(path, size, full_path_.data(), nullptr);
+        // 途中終了するなら非同期I/Oも中止
+        // Overlapped構造体をシステムが使わなくなるまで待機する必要がある
+        // (I/Oを発行したのは監視スレッドのため、スレッド指定の無いCancelIoExを使う)
+        if(is_reading_) {
+            CancelIoEx(handle_directory_, &overlapped_);
+            DWORD size = 0;
+            GetOverlappedResult(handle_directory_, &overlapped_, &size, TRUE);
+        }
+
+        // ハンドルの解放
+        if(finish_event_ != nullptr)
+            CloseHandle(finish_event_);
+        if(cancel_event_ != nullptr)
+            CloseHandle(cancel_event_);
+        if(handle_directory_ != INVALID_HANDLE_VALUE)
+            CloseHandle(handle_directory_);
     }
-    // コンソール出力を日本語可能に
-    setlocale(LC_ALL, "");
 
-    // 対象のディレクトリを監視用にオープンする。
-    // 共有ディレクトリ使用可、対象フォルダを削除可
-    // 非同期I/O使用
-    handle_directory_ = CreateFileW(full_path_.c_str(),                                       // [in] 監視先パス
-                                    FILE_LIST_DIRECTORY,                                      // [in] 要求アクセス
-                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,   // [in] 共有モード
-                                    nullptr,         // [in] セキュリティ属性
-                                    OPEN_EXISTING,   // [in] フォルダが存在する場合にのみ成功
-                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,   // [in] ReadDirectoryChangesW用
-                                    nullptr);                                            //
-    if(handle_directory_ == INVALID_HANDLE_VALUE) {
-        return false;
+    bool open(const std::filesystem::path& directory) override
+    {
+        // 対象のディレクトリを監視用にオープンする。
+        // 共有ディレクトリ使用可、対象フォルダを削除可
+        // 非同期I/O使用
+        handle_directory_ = CreateFileW(directory.c_str(),                                        // [in] 監視先パス
+                                        FILE_LIST_DIRECTORY,                                      // [in] 要求アクセス
+                                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,   // [in] 共有モード
+                                        nullptr,         // [in] セキュリティ属性
+                                        OPEN_EXISTING,   // [in] フォルダが存在する場合にのみ成功
+                                        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,   // [in] ReadDirectoryChangesW用
+                                        nullptr);                                            //
+        if(handle_directory_ == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        // 変更されたファイルのリストを記録するためのバッファ
+        // 最初のReadDirectoryChangesWの通知から次のReadDirectoryChangesWまでの
+        // 間に変更されたファイルの情報を格納できるだけのサイズが必要
+        // バッファオーバーとしてもファイルに変更が発生したことは感知できるが、
+        // なにが変更されたかは通知できない。
+        buffer_.resize(64 * 1024);
+
+        // 非同期I/Oの完了待機用 (手動リセットモード)
+        // 変更通知のイベント発行とキャンセル完了のイベント発行の
+        // 2つのイベントソースがあるためイベントの流れが予想できず
+        // 自動リセットイベントにするのは危険。
+        finish_event_ = CreateEvent(nullptr, true, false, nullptr);
+        cancel_event_ = CreateEvent(nullptr, true, false, nullptr);
+        if(finish_event_ == nullptr || cancel_event_ == nullptr) {
+            return false;
+        }
+
+        // 非同期I/O
+        overlapped_.hEvent = finish_event_;
+        return true;
     }
 
-    // 変更されたファイルのリストを記録するためのバッファ
-    // 最初のReadDirectoryChangesWの通知から次のReadDirectoryChangesWまでの
-    // 間に変更されたファイルの情報を格納できるだけのサイズが必要
-    // バッファオーバーとしてもファイルに変更が発生したことは感知できるが、
-    // なにが変更されたかは通知できない。
-    buffer_.resize(64 * 1024);
+    bool wait(u32 timeout_ms, std::vector<Event>& events) override
+    {
+        // 監視を開始 (前回の通知を受け取った後のみ)
+        if(!is_reading_) {
+            ResetEvent(finish_event_);
+            if(!start()) {
+                return false;
+            }
+            is_reading_ = true;
+        }
 
-    // 非同期I/Oの完了待機用 (手動リセットモード)
-    // 変更通知のイベント発行とキャンセル完了のイベント発行の
-    // 2つのイベントソースがあるためイベントの流れが予想できず
-    // 自動リセットイベントにするのは危険。
-    finish_event_ = CreateEvent(nullptr, true, false, nullptr);
-    if(finish_event_ == nullptr) {
-        return false;
+        // 変更通知または中断を待機
+        HANDLE handles[]{finish_event_, cancel_event_};
+        DWORD  result = WaitForMultipleObjects(static_cast<DWORD>(std::size(handles)), handles, FALSE, timeout_ms);
+        if(result == WAIT_TIMEOUT) {
+            return true;
+        }
+        if(result != WAIT_OBJECT_0) {
+            return false;   // 中断
+        }
+
+        // 非同期I/Oの結果を取得する
+        DWORD size  = 0;
+        is_reading_ = false;
+        if(!GetOverlappedResult(handle_directory_, &overlapped_, &size, FALSE)) {
+            // 結果取得に失敗した場合
+            return false;
+        }
+        if(size == 0) {
+            // 返却サイズが0ならばバッファオーバーを示す (変更内容は失われる)
+            OutputDebugStringA("FileWatcher: notification buffer overflow\n");
+            return true;
+        }
+
+        // 最初のエントリに位置付ける
+        auto data = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer_.data());
+
+        // エントリの末尾まで繰り返す
+        for(;;) {
+            Event event;
+            switch(data->Action) {
+            case FILE_ACTION_ADDED:
+                event.action_ = Action::Added;
+                break;
+            case FILE_ACTION_REMOVED:
+            case FILE_ACTION_RENAMED_OLD_NAME:
+                event.action_ = Action::Removed;
+                break;
+            case FILE_ACTION_RENAMED_NEW_NAME:
+                event.action_ = Action::Renamed;
+                break;
+            case FILE_ACTION_MODIFIED:
+            default:
+                event.action_ = Action::Modified;
+                break;
+            }
+
+            // ファイル名はnull終端されていないため長さから終端を付与
+            u32 byte_size = data->FileNameLength;   // 文字数ではなくバイト数
+            event.path_.assign(data->FileName, byte_size / sizeof(wchar_t));
+
+            // バックスラッシュをスラッシュに変換
+            std::replace(event.path_.begin(), event.path_.end(), L'\\', L'/');
+
+            events.emplace_back(std::move(event));
+
+            if(data->NextEntryOffset == 0) {
+                break;
+            }
+            // 次のエントリの位置まで移動する (現在アドレスからの相対バイト数)
+            data = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(reinterpret_cast<std::intptr_t>(data) +
+                                                              data->NextEntryOffset);
+        }
+        return true;
     }
 
-    // イベントの手動リセット
-    ResetEvent(finish_event_);
+    void cancel() override
+    {
+        if(cancel_event_ != nullptr)
+            SetEvent(cancel_event_);
+    }
 
-    // 非同期I/O
-    overlapped_.hEvent = finish_event_;
+private:
+    //! ReadDirectoryChangesWを発行
+    bool start()
+    {
+        // 監視条件 (FindFirstChangeNotificationと同じ)
+        constexpr u32 filter = FILE_NOTIFY_CHANGE_FILE_NAME |    // ファイル名の変更
+                               FILE_NOTIFY_CHANGE_DIR_NAME |     // ディレクトリ名の変更
+                               FILE_NOTIFY_CHANGE_ATTRIBUTES |   // 属性の変更
+                               FILE_NOTIFY_CHANGE_SIZE |         // サイズの変更
+                               FILE_NOTIFY_CHANGE_LAST_WRITE;    // 最終書き込み日時の変更
 
-    // 監視を開始
-    start();
+        // 変更を監視する
+        // 初回呼び出し時にシステムが指定サイズでバッファを確保し、そこに変更を記録する
+        // 完了通知後もシステムは変更を追跡しており、後続のReadDirectoryChangeWの
+        // 呼び出しで、前回通知後からの変更をまとめて受け取ることができる
+        // バッファがあふれた場合はサイズ0で応答が返される
+        return ReadDirectoryChangesW(handle_directory_,                    // 対象ディレクトリ
+                                     buffer_.data(),                       // 通知を格納するバッファ
+                                     static_cast<DWORD>(buffer_.size()),   // バッファサイズ
+                                     true,           // サブディレクトリを対象にするかどうか
+                                     filter,         // 変更通知を受け取るフィルタ
+                                     nullptr,        // (結果サイズ, 非同期なので未使用)
+                                     &overlapped_,   // 非同期I/Oバッファ
+                                     nullptr         // (完了ルーチン, 未使用)
+                                     ) != FALSE;
+    }
 
-    return true;
-}
+private:
+    HANDLE          finish_event_     = nullptr;                //!< 非同期IO完了通知イベント
+    HANDLE          cancel_event_     = nullptr;                //!< 待機中断イベント
+    HANDLE          handle_directory_ = INVALID_HANDLE_VALUE;   //!< 監視先ディレクトリハンドル
+    std::vector<u8> buffer_;                                    //!< ファイルリスト受信用バッファ
+    OVERLAPPED      overlapped_ = {};                           //!< 非同期IO
+    bool            is_reading_ = false;                        //!< 非同期IO発行中
+};
 
-//---------------------------------------------------------------------------
-//! 更新
-//---------------------------------------------------------------------------
-void FileWatcher::update()
+#elif defined(__linux__)
+//===========================================================================
+//! [Linux] inotify による監視
+//! @note inotifyはサブディレクトリを監視しないため、ディレクトリごとに監視を追加する
+//===========================================================================
+class FileWatcherBackendInotify final : public FileWatcherBackend
 {
-    // 変更通知チェック
-    u32 result = WaitForSingleObject(finish_event_, 0);
-    if(result == WAIT_TIMEOUT) {
-        return;
+public:
+    ~FileWatcherBackendInotify() override
+    {
+        if(inotify_fd_ != -1)
+            close(inotify_fd_);
+        if(wake_fd_ != -1)
+            close(wake_fd_);
     }
 
-    // 非同期I/Oの結果を取得する
-    DWORD size = 0;
-    if(!GetOverlappedResult(handle_directory_, &overlapped_, &size, FALSE)) {
-        // 結果取得に失敗した場合
-        return;
+    bool open(const std::filesystem::path& directory) override
+    {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wake_fd_    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(inotify_fd_ == -1 || wake_fd_ == -1) {
+            return false;
+        }
+
+        root_ = directory;
+        return addWatch(std::filesystem::path());
     }
-    if(size == 0) {
-        // 返却サイズが0ならばバッファオーバーを示す
-        assert(false);
-        return;
+
+    bool wait(u32 timeout_ms, std::vector<Event>& events) override
+    {
+        pollfd fds[2]{
+            {inotify_fd_, POLLIN, 0},
+            {    wake_fd_, POLLIN, 0},
+        };
+        int result = poll(fds, 2, static_cast<int>(timeout_ms));
+        if(result < 0) {
+            return errno == EINTR;
+        }
+        if(fds[1].revents & POLLIN) {
+            return false;   // 中断
+        }
+        if(!(fds[0].revents & POLLIN)) {
+            return true;   // タイムアウト
+        }
+
+        alignas(inotify_event) char buffer[64 * 1024];
+        for(;;) {
+            ssize_t size = read(inotify_fd_, buffer, sizeof(buffer));
+            if(size <= 0) {
+                break;   // 読み切った (EAGAIN)
+            }
+
+            for(char* p = buffer; p < buffer + size;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                if(event->mask & IN_IGNORED) {
+                    directories_.erase(event->wd);   // 監視ディレクトリが削除された
+                    continue;
+                }
+
+                auto it = directories_.find(event->wd);
+                if(it == directories_.end() || event->len == 0) {
+                    continue;
+                }
+                auto path = it->second / event->name;
+
+                // ディレクトリ自体は通知しない
+                if(event->mask & IN_ISDIR) {
+                    if(event->mask & IN_MOVED_FROM) {
+                        // 移動先(IN_MOVED_TO)と同じcookieで対応付ける
+                        moved_directories_[event->cookie] = path;
+                    }
+                    else if(event->mask & IN_MOVED_TO) {
+                        // 監視中のディレクトリの移動は、配下の監視ディスクリプタのパスを付け替える
+                        // (付け替えないと移動後の変更が移動前のパスで通知される)
+                        auto moved = moved_directories_.find(event->cookie);
+                        if(moved != moved_directories_.end()) {
+                            renameWatches(moved->second, path);
+                            moved_directories_.erase(moved);
+                        }
+                        addWatch(path);
+                    }
+                    else if(event->mask & IN_CREATE) {
+                        addWatch(path);
+                    }
+                    continue;
+                }
+
+                Event e;
+                e.path_ = path.generic_wstring();
+                if(event->mask & IN_CREATE)
+                    e.action_ = Action::Added;
+                else if(event->mask & (IN_DELETE | IN_MOVED_FROM))
+                    e.action_ = Action::Removed;
+                else if(event->mask & IN_MOVED_TO)
+                    e.action_ = Action::Renamed;
+                else
+                    e.action_ = Action::Modified;
+
+                events.emplace_back(std::move(e));
+            }
+        }
+
+        // 監視ルートの外へ移動したディレクトリは監視をやめる
+        for(auto& [cookie, path] : moved_directories_) {
+            removeWatches(path);
+        }
+        moved_directories_.clear();
+        return true;
     }
 
-    // 最初のエントリに位置付ける
-    auto data = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer_.data());
+    void cancel() override
+    {
+        u64 value = 1;
+        [[maybe_unused]] auto result = write(wake_fd_, &value, sizeof(value));
+    }
 
-    // エントリの末尾まで繰り返す
-    for(;;) {
-        // アクションタイプによって処理。現時点では特殊な処理は無し。
-        switch(data->Action) {
-        case FILE_ACTION_ADDED:
-            break;
-        case FILE_ACTION_REMOVED:
-            break;
-        case FILE_ACTION_MODIFIED:
-            break;
-        case FILE_ACTION_RENAMED_OLD_NAME:
-            break;
-        case FILE_ACTION_RENAMED_NEW_NAME:
-            break;
-        default:
-            break;
+private:
+    //! ディレクトリとそのサブディレクトリに監視を追加
+    //! @param  [in]    relative_path   監視ルートからの相対パス
+    bool addWatch(const std::filesystem::path& relative_path)
+    {
+        constexpr u32 mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM |
+                             IN_MOVED_TO | IN_ONLYDIR;
+
+        int wd = inotify_add_watch(inotify_fd_, (root_ / relative_path).c_str(), mask);
+        if(wd == -1) {
+            return false;
         }
+        directories_[wd] = relative_path;
+
+        std::error_code error_code;
+        for(auto& entry : std::filesystem::directory_iterator(root_ / relative_path, error_code)) {
+            if(entry.is_directory(error_code) && !entry.is_symlink(error_code))
+                addWatch(relative_path / entry.path().filename());
+        }
+        return true;
+    }
 
-        // ファイル名はnull終端されていないため長さから終端を付与
-        u32          byte_size = data->FileNameLength;   // 文字数ではなくバイト数
-        std::wstring file_name;
-        file_name.resize(byte_size / sizeof(wchar_t));
+    //! ディレクトリ配下かどうか
+    //! @param  [in]    path        調べるパス
+    //! @param  [in]    directory   ディレクトリ
+    //! @param  [out]   relative    ディレクトリからの相対パス (ディレクトリ自身の場合は空)
+    static bool isUnder(const std::filesystem::path& path, const std::filesystem::path& directory, std::filesystem::path& relative)
+    {
+        auto mismatch = std::mismatch(path.begin(), path.end(), directory.begin(), directory.end());
+        if(mismatch.second != directory.end()) {
+            return false;
+        }
 
-        memcpy(file_name.data(), data->FileName, byte_size);
+        relative.clear();
+        for(auto it = mismatch.first; it != path.end(); ++it) {
+            relative /= *it;
+        }
+        return true;
+    }
 
-        // バックスラッシュをスラッシュに変換
-        for(auto& c : file_name) {
-            if(c == L'\\') {
-                c = L'/';
+    //! 移動したディレクトリ配下の監視のパスを付け替え
+    //! @param  [in]    from    移動前の相対パス
+    //! @param  [in]    to      移動後の相対パス
+    void renameWatches(const std::filesystem::path& from, const std::filesystem::path& to)
+    {
+        std::filesystem::path relative;
+        for(auto& [wd, path] : directories_) {
+            if(isUnder(path, from, relative))
+                path = relative.empty() ? to : to / relative;
+        }
+    }
+
+    //! ディレクトリ配下の監視を解除
+    //! @param  [in]    directory   監視ルートからの相対パス
+    void removeWatches(const std::filesystem::path& directory)
+    {
+        std::filesystem::path relative;
+        for(auto it = directories_.begin(); it != directories_.end();) {
+            if(isUnder(it->second, directory, relative)) {
+                inotify_rm_watch(inotify_fd_, it->first);
+                it = directories_.erase(it);
+                continue;
             }
+            ++it;
         }
+    }
 
-        // アクションと対象ファイルを処理
-        callback_(file_name.data());
+private:
+    int                                            inotify_fd_ = -1;     //!< inotifyディスクリプタ
+    int                                            wake_fd_    = -1;     //!< 待機中断用eventfd
+    std::filesystem::path                          root_;                //!< 監視ルート
+    std::unordered_map<int, std::filesystem::path> directories_;         //!< 監視ディスクリプタ → 相対パス
+    std::unordered_map<u32, std::filesystem::path> moved_directories_;   //!< 移動中のディレクトリ (cookie → 移動前の相対パス)
+};
+#endif
 
-        if(data->NextEntryOffset == 0) {
-            start();   // 監視を再開
+}   // namespace
 
-            break;
+//---------------------------------------------------------------------------
+//! 実行環境に合わせたバックエンドを作成
+//---------------------------------------------------------------------------
+std::unique_ptr<FileWatcherBackend> FileWatcherBackend::create()
+{
+#if defined(_WIN32)
+    return std::make_unique<FileWatcherBackendWin32>();
+#elif defined(__linux__)
+    return std::make_unique<FileWatcherBackendInotify>();
+#else
+    return nullptr;
+#endif
+}
+
+//---------------------------------------------------------------------------
+//! 初期化
+//---------------------------------------------------------------------------
+bool FileWatcher::initialize(const wchar_t*                      path,
+                             std::function<void(const wchar_t*)> callback,
+                             std::unique_ptr<FileWatcherBackend> backend)
+{
+    finalize();
+
+    callback_ = std::move(callback);
+    backend_  = backend ? std::move(backend) : FileWatcherBackend::create();
+
+    // コンソール出力を日本語可能に
+    setlocale(LC_ALL, "");
+
+    // フルパスに変換
+    std::error_code error_code;
+    auto            full_path = std::filesystem::absolute(path, error_code);
+
+    if(!backend_ || !backend_->open(full_path)) {
+        backend_.reset();
+        return false;
+    }
+
+    // 監視スレッドを開始
+    running_ = true;
+    thread_  = std::thread([this]() { threadMain(); });
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 解放
+//---------------------------------------------------------------------------
+void FileWatcher::finalize()
+{
+    if(thread_.joinable()) {
+        running_ = false;
+        backend_->cancel();
+        thread_.join();
+    }
+    backend_.reset();
+
+    std::lock_guard lock(mutex_);
+    batches_.clear();
+}
+
+//---------------------------------------------------------------------------
+//! 更新
+//---------------------------------------------------------------------------
+size_t FileWatcher::update()
+{
+    // キューを一括で取り出す (コールバック中にロックを保持しない)
+    std::vector<Batch> batches;
+    {
+        std::lock_guard lock(mutex_);
+        batches.swap(batches_);
+    }
+
+    size_t count = 0;
+    for(auto& batch : batches) {
+        for(auto& path : batch) {
+            // アクションと対象ファイルを処理
+            callback_(path.c_str());
+            ++count;
         }
-        // 次のエントリの位置まで移動する (現在アドレスからの相対バイト数)
-        data = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(reinterpret_cast<std::intptr_t>(data) +
-                                                          data->NextEntryOffset);
     }
+    return count;
 }
 
 //---------------------------------------------------------------------------
@@ -140,46 +492,76 @@ void FileWatcher::update()
 //---------------------------------------------------------------------------
 FileWatcher::~FileWatcher()
 {
-    // 途中終了するなら非同期I/Oも中止
-    // Overlapped構造体をシステムが使わなくなるまで待機する必要がある
-    CancelIo(handle_directory_);
-    if(finish_event_ != INVALID_HANDLE_VALUE) {
-        WaitForSingleObject(finish_event_, INFINITE);
-    }
-
-    // ハンドルの解放
-    CloseHandle(finish_event_);
-    CloseHandle(handle_directory_);
+    finalize();
 }
 
 //---------------------------------------------------------------------------
-//! ファイル監視を開始
+//! 監視スレッド
 //---------------------------------------------------------------------------
-bool FileWatcher::start()
+void FileWatcher::threadMain()
 {
-    // 監視条件 (FindFirstChangeNotificationと同じ)
-    constexpr u32 filter = FILE_NOTIFY_CHANGE_FILE_NAME |    // ファイル名の変更
-                           FILE_NOTIFY_CHANGE_DIR_NAME |     // ディレクトリ名の変更
-                           FILE_NOTIFY_CHANGE_ATTRIBUTES |   // 属性の変更
-                           FILE_NOTIFY_CHANGE_SIZE |         // サイズの変更
-                           FILE_NOTIFY_CHANGE_LAST_WRITE;    // 最終書き込み日時の変更
-
-    // 変更を監視する
-    // 初回呼び出し時にシステムが指定サイズでバッファを確保し、そこに変更を記録する
-    // 完了通知後もシステムは変更を追跡しており、後続のReadDirectoryChangeWの
-    // 呼び出しで、前回通知後からの変更をまとめて受け取ることができる
-    // バッファがあふれた場合はサイズ0で応答が返される
-    if(!ReadDirectoryChangesW(handle_directory_,                    // 対象ディレクトリ
-                              buffer_.data(),                       // 通知を格納するバッファ
-                              static_cast<DWORD>(buffer_.size()),   // バッファサイズ
-                              true,           // サブディレクトリを対象にするかどうか
-                              filter,         // 変更通知を受け取るフィルタ
-                              nullptr,        // (結果サイズ, 非同期なので未使用)
-                              &overlapped_,   // 非同期I/Oバッファ
-                              nullptr         // (完了ルーチン, 未使用)
-                              )) {
-        // 開始できなかった場合のエラー
-        return false;
+    using clock = std::chrono::steady_clock;
+
+    //! まとめ中のパス
+    struct Pending
+    {
+        FileWatcherBackend::Action action_ = FileWatcherBackend::Action::Modified;   //!< 最後の変更の種類
+        clock::time_point          last_;                                             //!< 最後に変更を受け取った時刻
+        u64                        order_ = 0;                                        //!< 最初に受け取った順番
+    };
+
+    std::unordered_map<std::wstring, Pending> pending;
+    std::vector<FileWatcherBackend::Event>    events;
+    u64                                       order = 0;
+
+    const auto debounce = std::chrono::milliseconds(DEBOUNCE_MS);
+
+    while(running_) {
+        // まとめ中のパスがあれば途切れたかどうかを確認するため短い間隔で起きる
+        u32 timeout_ms = pending.empty() ? 500 : DEBOUNCE_MS / 2;
+
+        events.clear();
+        if(!backend_->wait(timeout_ms, events)) {
+            break;
+        }
+
+        auto now = clock::now();
+        for(auto& event : events) {
+            auto [it, inserted] = pending.try_emplace(event.path_);
+            if(inserted)
+                it->second.order_ = order++;
+            it->second.action_ = event.action_;
+            it->second.last_   = now;
+        }
+
+        //----------------------------------------------------------
+        // DEBOUNCE_MSの間変更が無かったパスを1回分にまとめる
+        //----------------------------------------------------------
+        std::vector<std::pair<u64, std::wstring>> ready;
+        for(auto it = pending.begin(); it != pending.end();) {
+            if(now - it->second.last_ < debounce) {
+                ++it;
+                continue;
+            }
+            // 最終的に削除されたファイル(一時ファイルなど)は通知しない
+            if(it->second.action_ != FileWatcherBackend::Action::Removed)
+                ready.emplace_back(it->second.order_, it->first);
+            it = pending.erase(it);
+        }
+        if(ready.empty()) {
+            continue;
+        }
+
+        // 最初に変更を受け取った順に並べる
+        std::sort(ready.begin(), ready.end());
+
+        Batch batch;
+        batch.reserve(ready.size());
+        for(auto& [_, path] : ready) {
+            batch.emplace_back(std::move(path));
+        }
+
+        std::lock_guard lock(mutex_);
+        batches_.emplace_back(std::move(batch));
     }
-    return true;
 }
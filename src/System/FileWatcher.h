@@ -4,20 +4,91 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//===========================================================================
+//! ファイル変更監視バックエンド (OS依存部分)
+//! @details Windows は ReadDirectoryChangesW、Linux は inotify で実装しています。
+//!          バックグラウンドスレッドから呼び出されます。
+//===========================================================================
+class FileWatcherBackend
+{
+public:
+    //! 変更の種類
+    enum class Action : u32
+    {
+        Added,      //!< 作成
+        Removed,    //!< 削除 (名前変更前の名前を含む)
+        Modified,   //!< 内容/属性の変更
+        Renamed,    //!< 名前変更後の名前
+    };
+
+    //! 変更イベント
+    struct Event
+    {
+        std::wstring path_;                          //!< 監視ディレクトリからの相対パス ('/'区切り)
+        Action       action_ = Action::Modified;   //!< 変更の種類
+    };
+
+    //! デストラクタ
+    virtual ~FileWatcherBackend() = default;
+
+    //  監視を開始
+    //! @param  [in]    directory   監視対象のディレクトリ (サブディレクトリも対象)
+    virtual bool open(const std::filesystem::path& directory) = 0;
+
+    //  変更を待機
+    //! @param  [in]    timeout_ms  最大待機時間(単位:ミリ秒)
+    //! @param  [out]   events      受け取ったイベント (末尾に追加)
+    //! @retval false   監視を継続できない (cancel() またはエラー)
+    virtual bool wait(u32 timeout_ms, std::vector<Event>& events) = 0;
+
+    //  待機を中断 (別スレッドから呼び出し可能)
+    virtual void cancel() = 0;
+
+    //  実行環境に合わせたバックエンドを作成
+    static std::unique_ptr<FileWatcherBackend> create();
+};
+
 //===========================================================================
 //! ファイル変更監視
+//! @details バックグラウンドスレッドで変更を受け取り、パスごとに DEBOUNCE_MS の間
+//!          変更が途切れるまで待ってから1回分にまとめます。
+//!          一時ファイル経由の保存で発生する連続した通知は1回の通知になり、
+//!          最終的に削除されたファイル(一時ファイルなど)は通知しません。
+//!          まとめた変更はキューに積まれ、メインループの update() でコールバックへ渡されます。
 //===========================================================================
 class FileWatcher
 {
 public:
+    //! 変更をまとめる待機時間(単位:ミリ秒)
+    static constexpr u32 DEBOUNCE_MS = 100;
+
+    //! まとめて通知する変更されたファイル (監視ディレクトリからの相対パス)
+    using Batch = std::vector<std::wstring>;
+
     // 初期化
-    //! @param  [in]    path    監視対象のディレクトリパス
-    //! @param  [in]    callback    ファイル変更通知のコールバック関数
-    bool initialize(const wchar_t* path, std::function<void(const wchar_t*)> callback);
+    //! @param  [in]    path        監視対象のディレクトリパス
+    //! @param  [in]    callback    ファイル変更通知のコールバック関数 (update()を呼んだスレッドで実行)
+    //! @param  [in]    backend     バックエンド (nullptrの場合は実行環境に合わせて作成)
+    bool initialize(const wchar_t*                      path,
+                    std::function<void(const wchar_t*)> callback,
+                    std::unique_ptr<FileWatcherBackend> backend = nullptr);
+
+    // 解放 (バックグラウンドスレッドを停止)
+    void finalize();
 
     // 更新
-    //! @note メインループで呼ぶ必要がある
-    void update();
+    //! @note メインループで呼ぶ必要がある。溜まった変更をすべてコールバックへ渡します
+    //! @return 通知したファイル数
+    size_t update();
 
     // コンストラクタ
     FileWatcher() = default;
@@ -26,14 +97,17 @@ public:
     virtual ~FileWatcher();
 
 private:
-    // ファイル監視を開始
-    bool start();
+    FileWatcher(const FileWatcher&)            = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // 監視スレッド
+    void threadMain();
 
 private:
-    HANDLE          finish_event_     = INVALID_HANDLE_VALUE;   //!< 非同期IO完了通知イベント
-    HANDLE          handle_directory_ = INVALID_HANDLE_VALUE;   //!< 監視先ディレクトリハンドル
-    std::vector<u8> buffer_;                                    //!< ファイルリスト受信用バッファ
-    OVERLAPPED      overlapped_ = {};                           //!< 非同期IO
-    std::function<void(const wchar_t*)> callback_;              //!< ファイル変更時のコールバック関数
-    std::wstring                        full_path_;             //!< 監視中のフルパス
+    std::unique_ptr<FileWatcherBackend> backend_;           //!< バックエンド
+    std::function<void(const wchar_t*)> callback_;          //!< ファイル変更時のコールバック関数
+    std::thread                         thread_;            //!< 監視スレッド
+    std::atomic<bool>                   running_ = false;   //!< 監視スレッド実行中
+    std::mutex                          mutex_;             //!< batches_ の排他制御
+    std::vector<Batch>                  batches_;           //!< 通知待ちの変更 (監視スレッド → メインスレッド)
 };
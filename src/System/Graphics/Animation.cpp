@@ -3,7 +3,12 @@
 //! @brief  アニメーション
 //---------------------------------------------------------------------------
 #include "Animation.h"
+#include "ResourceModel.h"
 #include "System/EaseCurve.h"
+#include "System/Animation/Animator.h"
+#include "MeshCook.h"
+
+#include <filesystem>
 
 namespace
 {
@@ -11,6 +16,45 @@ namespace
 //! アニメーションリソースプール
 std::unordered_map<std::string, std::shared_ptr<ResourceAnimation>> resource_pool;
 
+//! クリップ集合プール (定義内容のキー → 使用中のクリップ集合)
+std::unordered_map<std::string, std::weak_ptr<const AnimationClipSet>> clip_set_pool;
+
+//! evaluateAnimators()の評価待ち (Animation::apply()で登録)
+std::vector<Animation*> queued_animations;
+
+//! evaluateAnimators()でまとめて評価するアニメーター (毎フレームの確保を避けるため使い回す)
+std::vector<animation::Animator*> queued_animators;
+
+//---------------------------------------------------------------------------
+//! 定義オプション配列からクリップ集合プールのキーを作成
+//---------------------------------------------------------------------------
+std::string clipSetKey(const Animation::Desc* desc, size_t desc_count)
+{
+    std::string key;
+    for(size_t i = 0; i < desc_count; ++i) {
+        const auto& x = desc[i];
+
+        key += x.name_;
+        key += '\t';
+        key += x.file_path_;
+        key += '\t';
+        key += std::to_string(x.animation_index_);
+        key += '\t';
+        key += std::to_string(x.animation_speed_);
+        key += '\n';
+    }
+    return key;
+}
+
+//---------------------------------------------------------------------------
+//! エンジン側のクリップのキャッシュファイルパスを取得
+//! @note   モデルキャッシュと同じく data/ からの相対パスで cooked/ 以下へ置きます
+//---------------------------------------------------------------------------
+std::string clipCachePath(std::string_view file_path, u32 animation_index)
+{
+    return mesh_cook::cookedPath(file_path, "." + std::to_string(animation_index) + ".clip");
+}
+
 }   // namespace
 
 //---------------------------------------------------------------------------
@@ -30,15 +74,6 @@ Animation::~Animation()
     if(model_) {
         model_->bindAnimation(nullptr);
     }
-
-    // アニメーションMV1を解放
-    for(auto& x : mv1_handles_) {
-        if(x == -1)
-            continue;
-
-        MV1DeleteModel(x);
-        x = -1;
-    }
 }
 
 //---------------------------------------------------------------------------
@@ -46,44 +81,33 @@ Animation::~Animation()
 //---------------------------------------------------------------------------
 bool Animation::load(const Animation::Desc* desc, size_t desc_count)
 {
-    is_valid_ = true;   // 先に一旦trueにする
-
-    // パラメーター初期化
-    for(u32 i = 0; i < desc_count; ++i) {
-        const auto& x = desc[i];
+    // クリップ集合を共有 (インスタンスごとのMV1複製は行わない)
+    // 読み込み待ちのリソースは失敗がまだ確定していないため、結果は完了後にisValid()で確認する
+    clips_ = AnimationClipSet::acquire(desc, desc_count);
 
-        //------------------------------------------------------
-        // アニメーションリソース作成
-        // 既に同名ファイルがある場合は共有
-        //------------------------------------------------------
-        const std::string& resource_path = x.file_path_;
+    // クリップ集合が変わったためエンジン側のクリップを準備し直す
+    requestEngineClips();
 
-        auto it = resource_pool.find(resource_path);
-        if(it == resource_pool.end()) {   // 新規登録
-            resource_pool[resource_path] = std::make_shared<ResourceAnimation>(resource_path);
-        }
-
-        // 共有
-        std::shared_ptr<ResourceAnimation>& resource = resource_pool[resource_path];
-
-        descs_.push_back(x);
-        mv1_handles_.push_back(MV1DuplicateModel(*resource));
-
-        if(resource->isValid() == false) {
-            is_valid_ = false;   // 一度でもエラーの場合はfalse
-        }
-
-        // 名前逆引きテーブルに登録
-        name_table_[desc[i].name_] = i;
-    }
-
-    return is_valid_;
+    return clips_->isValid();
 }
 
 //---------------------------------------------------------------------------
 //! 更新
 //---------------------------------------------------------------------------
 void Animation::update(f32 dt)
+{
+    // 再生していない場合・ポーズ中の場合
+    if(isPlaying() == false || is_paused_)
+        return;
+
+    advance(dt);
+    apply();
+}
+
+//---------------------------------------------------------------------------
+//! 再生時間とブレンド比のみ進める
+//---------------------------------------------------------------------------
+void Animation::advance(f32 dt)
 {
     assert(model_ && "アニメーションにモデルが設定されていません");
 
@@ -107,10 +131,14 @@ void Animation::update(f32 dt)
         if(c.is_playing_ == false)
             continue;
 
-        auto& desc = descs_[c.animation_index_];
+        // エンジン側のクリップの準備が完了するまでは進めない (総再生時間が未確定のため)
+        if(use_animator_ && !c.clip_)
+            continue;
+
+        auto& clip = (*clips_)[c.animation_index_];
 
-        // アニメーション再生時間を進める
-        c.play_time_ += dt * 30.0f * desc.animation_speed_;
+        // アニメーション再生時間を進める (DxLibの時間単位)
+        c.play_time_ += dt * animation::DXLIB_TIME_SCALE * clip.animation_speed_;
 
         if(c.is_loop_) {
             // アニメーション再生時間がアニメーションの総時間を越えていたらループさせる
@@ -125,9 +153,6 @@ void Animation::update(f32 dt)
                 c.is_playing_ = false;
             }
         }
-
-        // 新しいアニメーション再生時間をセット
-        MV1SetAttachAnimTime(model_handle_, c.animation_attach_index_, c.play_time_);
     }
 
     //----------------------------------------------------------
@@ -137,18 +162,181 @@ void Animation::update(f32 dt)
     // ブレンドを進める
     blend_ratio_ = std::max(0.0f, blend_ratio_ - 1.0f / blend_time_ * dt);
 
+    // 補間完了後は補間元のアニメーションを停止 (割り当ての解除は姿勢を反映する apply() で行う)
+    if(blend_ratio_ == 0.0f) {   // float値の==判定は0.0fのみ正確に判定できる
+        contexts_[1].is_playing_ = false;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 現在の再生時間とブレンド比を姿勢へ反映
+//---------------------------------------------------------------------------
+void Animation::apply()
+{
+    // 補間が完了した補間元のアニメーションを解除
+    // 姿勢を反映しないフレームで解除すると、次に反映するまでの間だけ補間元の重みが抜けた姿勢になるためここで行う
+    auto& last = contexts_[1];
+    if(blend_ratio_ == 0.0f && (last.animation_attach_index_ != -1 || last.clip_)) {
+        detachAnimation(1);
+    }
+
     // 線形で等速補間すると硬い動きになるためEaseカーブ補間
-    auto ease  = GetEaseFunction(EaseType::InOutCubic);   // 加減速
-    f32  ratio = ease(blend_ratio_);
+    Ease<EaseType::InOutCubic> ease;   // 加減速
+    f32                        ratio = ease(blend_ratio_);
+
+    // エンジン側で姿勢を計算 (クリップの準備が完了するまではモデルの姿勢のまま)
+    if(use_animator_) {
+        if(contexts_[0].clip_) {
+            applyAnimator(ratio);
+        }
+        return;
+    }
+
+    // 新しいアニメーション再生時間をセット
+    for(u32 i = 0; i < 2; ++i) {
+        auto& c = contexts_[i];
+
+        if(c.animation_attach_index_ == -1)
+            continue;
+
+        MV1SetAttachAnimTime(model_handle_, c.animation_attach_index_, c.play_time_);
+    }
 
     // ブレンド比率を設定
     MV1SetAttachAnimBlendRate(model_handle_, contexts_[0].animation_attach_index_, 1.0f - ratio);
     MV1SetAttachAnimBlendRate(model_handle_, contexts_[1].animation_attach_index_, ratio);
+}
 
-    // 補間完了後は補間元のアニメーションを停止
-    if(blend_ratio_ == 0.0f) {   // float値の==判定は0.0fのみ正確に判定できる
-        detachAnimation(1);
-        contexts_[1].is_playing_ = false;
+//---------------------------------------------------------------------------
+//! 評価待ちのアニメーターをまとめて評価して姿勢へ反映
+//---------------------------------------------------------------------------
+void Animation::evaluateAnimators()
+{
+    if(queued_animations.empty())
+        return;
+
+    // 姿勢の計算はモデル間で独立しているため並列に評価
+    // 再生時間は各Animationで進めているため、アニメーター側の時間は進めない
+    queued_animators.clear();
+    for(auto* animation : queued_animations) {
+        queued_animators.push_back(animation->animator_.get());
+    }
+    animation::update(queued_animators.data(), queued_animators.size(), 0.0f);
+
+    // [DxLib] MV1関数はメインスレッドから呼ぶ
+    for(auto* animation : queued_animations) {
+        animation->animator_->apply(animation->model_handle_);
+        animation->is_queued_ = false;
+    }
+    queued_animations.clear();
+}
+
+//---------------------------------------------------------------------------
+//! エンジン側で計算する姿勢の入力を設定して評価待ちに登録
+//---------------------------------------------------------------------------
+void Animation::applyAnimator(f32 ratio)
+{
+    // 関節階層はモデルの読み込み後に確定するため初回に作成
+    if(!animator_) {
+        auto skeleton = std::make_shared<const animation::Skeleton>(animation::Skeleton::fromModel(model_handle_));
+        animator_     = std::make_unique<animation::Animator>(std::move(skeleton));
+    }
+
+    // [0] = 現在のアニメーション
+    // [1] = 以前のアニメーション
+    // 再生時間とループはこのクラスで進めるため、アニメーター側では進めない
+    auto& inputs = animator_->layer(0).inputs_;
+    inputs.resize(2);
+    for(u32 i = 0; i < 2; ++i) {
+        const auto& c     = contexts_[i];
+        auto&       input = inputs[i];
+
+        input.clip_   = c.clip_;
+        input.time_   = c.play_time_ / animation::DXLIB_TIME_SCALE;
+        input.speed_  = 0.0f;
+        input.weight_ = (i == 0) ? 1.0f - ratio : ratio;
+        input.loop_   = false;
+    }
+
+    // 評価と反映は evaluateAnimators() で全モデルまとめて行う
+    if(!is_queued_) {
+        queued_animations.push_back(this);
+        is_queued_ = true;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! エンジン側の姿勢計算を解除
+//---------------------------------------------------------------------------
+void Animation::releaseAnimator()
+{
+    if(is_queued_) {
+        queued_animations.erase(std::find(queued_animations.begin(), queued_animations.end(), this));
+        is_queued_ = false;
+    }
+
+    // エンジン側で設定したフレームの行列を戻す
+    if(animator_) {
+        animator_->restore(model_handle_);
+        animator_.reset();
+    }
+}
+
+//---------------------------------------------------------------------------
+//! エンジン側のクリップの準備をストリーミングに要求
+//---------------------------------------------------------------------------
+void Animation::requestEngineClips()
+{
+    GetStreamingManager().cancel(clip_request_);
+    clip_request_ = 0;
+
+    if(!use_animator_ || !model_ || !clips_ || clips_->size() == 0)
+        return;
+
+    StreamingManager::Request request;
+    request.name_ = (*clips_)[0].file_path_;
+
+    // モデルと全てのアニメーションの読み込み完了を待つ
+    request.poll_ = [this]() {
+        auto* resource = model_->resource();
+        if(!resource->isValid() || !clips_->isValid())
+            return StreamingManager::Poll::Failed;
+
+        bool active = resource->isActive();
+        for(size_t i = 0; i < clips_->size(); ++i) {
+            active = active && (*clips_)[i].resource_->isActive();
+        }
+        return active ? StreamingManager::Poll::Done : StreamingManager::Poll::Pending;
+    };
+    request.wait_ = [this]() {
+        GetStreamingManager().wait(model_->resource()->request());
+        for(size_t i = 0; i < clips_->size(); ++i) {
+            GetStreamingManager().wait((*clips_)[i].resource_->request());
+        }
+    };
+
+    // [DxLib] クリップのサンプリングはMV1関数を使うためメインスレッドの仕上げで行う
+    request.finalize_ = [this]() {
+        clips_->prepareEngineClips(model_handle_);
+        resolveEngineClips();
+        return true;
+    };
+
+    clip_request_ = GetStreamingManager().request(std::move(request));
+}
+
+//---------------------------------------------------------------------------
+//! 準備済みのエンジン側のクリップを再生中のコンテキストへ設定
+//---------------------------------------------------------------------------
+void Animation::resolveEngineClips()
+{
+    for(u32 i = 0; i < 2; ++i) {
+        const auto& c = contexts_[i];
+
+        if(c.animation_index_ == -1 || c.clip_ || c.is_playing_ == false)
+            continue;
+
+        attachAnimation(i);
     }
 }
 
@@ -167,6 +355,9 @@ void Animation::bindModel(Model* model)
         detachAnimation(0);
         detachAnimation(1);
 
+        // エンジン側の姿勢計算を解除 (関節階層はモデルごとに作り直す)
+        releaseAnimator();
+
         model_        = nullptr;
         model_handle_ = -1;
 
@@ -179,6 +370,9 @@ void Animation::bindModel(Model* model)
         model_handle_ = *model_;
         model_->bindAnimation(this);
     }
+
+    // 新しいモデルの関節階層でエンジン側のクリップを準備する (解除した場合は取り消しのみ)
+    requestEngineClips();
 }
 
 //---------------------------------------------------------------------------
@@ -205,17 +399,16 @@ bool Animation::play(std::string_view name, bool is_loop, f32 blend_time, f32 st
     //----------------------------------------------------------
     {
         // 名前からアニメーションを検索
-        std::string name_string(name);
-        auto        it = name_table_.find(name_string);
+        s32 index = clips_ ? clips_->find(name) : -1;
 
-        if(it == name_table_.end()) {
+        if(index == -1) {
             return false;   // 見つからなかった場合
         }
 
         auto& c = contexts_[0];
 
         // アニメーション番号
-        c.animation_index_ = it->second;
+        c.animation_index_ = index;
         // 現在の時間
         c.play_time_ = start_time;   // 開始位置は start_time から
 
@@ -249,6 +442,32 @@ void Animation::pause(bool active)
     is_paused_ = active;
 }
 
+//---------------------------------------------------------------------------
+//! 姿勢の計算をエンジン側で行うかどうかを設定
+//---------------------------------------------------------------------------
+void Animation::useAnimator(bool enable)
+{
+    if(enable == use_animator_)
+        return;
+
+    // 再生中のアニメーションを一旦解除
+    if(model_) {
+        detachAnimation(0);
+        detachAnimation(1);
+    }
+    releaseAnimator();
+
+    use_animator_ = enable;
+    requestEngineClips();
+
+    // 切り替え後の方式で割り当て直して姿勢を反映
+    if(model_ && isPlaying()) {
+        attachAnimation(0);
+        attachAnimation(1);
+        apply();
+    }
+}
+
 //---------------------------------------------------------------------------
 //!  再生中かどうかを取得
 //---------------------------------------------------------------------------
@@ -270,7 +489,8 @@ bool Animation::isPaused() const
 //---------------------------------------------------------------------------
 bool Animation::isValid() const
 {
-    return is_valid_;
+    // 読み込みが後から失敗することがあるため毎回確認する
+    return clips_ && clips_->isValid();
 }
 
 //---------------------------------------------------------------------------
@@ -291,11 +511,20 @@ bool Animation::attachAnimation(s32 context_index)
     if(c.animation_index_ == -1)
         return false;
 
-    auto& desc = descs_[c.animation_index_];
+    // エンジン側で姿勢を計算する場合はアタッチせずにクリップのみ参照
+    // 準備前の場合は requestEngineClips() の仕上げで改めて設定する
+    if(use_animator_) {
+        c.clip_                 = clips_->engineClip(c.animation_index_);
+        c.animation_total_time_ = c.clip_ ? c.clip_->duration() * animation::DXLIB_TIME_SCALE : 0.0f;
+        return c.clip_ != nullptr;
+    }
+
+    auto& clip = (*clips_)[c.animation_index_];
 
     // モデルにアニメーションを設定
-    auto animation_index = desc.animation_index_;              // アニメーション番号
-    auto mv1_handle      = mv1_handles_[c.animation_index_];   // [DxLib] アニメーションのMV1
+    // アニメーションMV1は全インスタンスで共有 (アタッチ元として参照するのみ)
+    auto animation_index = clip.animation_index_;               // アニメーション番号
+    auto mv1_handle      = static_cast<int>(*clip.resource_);   // [DxLib] アニメーションのMV1
 
     c.animation_attach_index_ = MV1AttachAnim(model_handle_, animation_index, mv1_handle, true);
 
@@ -315,6 +544,169 @@ void Animation::detachAnimation(s32 context_index)
 {
     MV1DetachAnim(model_handle_, contexts_[context_index].animation_attach_index_);
     contexts_[context_index].animation_attach_index_ = -1;
+    contexts_[context_index].clip_.reset();
+}
+
+//===========================================================================
+//  AnimationClipSet
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! クリップ集合を取得
+//---------------------------------------------------------------------------
+std::shared_ptr<const AnimationClipSet> AnimationClipSet::acquire(const Animation::Desc* desc, size_t desc_count)
+{
+    std::string key = clipSetKey(desc, desc_count);
+
+    // 使用中なら共有
+    if(auto it = clip_set_pool.find(key); it != clip_set_pool.end()) {
+        if(auto clip_set = it->second.lock()) {
+            // 読み込み途中なら先行読み込み中のシーンの進捗にも含める
+            for(auto& clip : clip_set->clips_)
+                GetStreamingManager().join(clip.resource_->request());
+            return clip_set;
+        }
+    }
+
+    // 解放済みのエントリはこの機会に削除
+    for(auto it = clip_set_pool.begin(); it != clip_set_pool.end();) {
+        it = it->second.expired() ? clip_set_pool.erase(it) : std::next(it);
+    }
+
+    // 新規作成
+    auto clip_set      = std::make_shared<const AnimationClipSet>(desc, desc_count);
+    clip_set_pool[key] = clip_set;
+    return clip_set;
+}
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+AnimationClipSet::AnimationClipSet(const Animation::Desc* desc, size_t desc_count)
+{
+    clips_.reserve(desc_count);
+
+    for(u32 i = 0; i < desc_count; ++i) {
+        const auto& x = desc[i];
+
+        //------------------------------------------------------
+        // アニメーションリソース作成
+        // 既に同名ファイルがある場合は共有
+        //------------------------------------------------------
+        const std::string& resource_path = x.file_path_;
+
+        auto it = resource_pool.find(resource_path);
+        if(it == resource_pool.end()) {   // 新規登録
+            resource_pool[resource_path] = std::make_shared<ResourceAnimation>(resource_path);
+        }
+
+        // 共有
+        std::shared_ptr<ResourceAnimation>& resource = resource_pool[resource_path];
+        GetStreamingManager().join(resource->request());
+
+        clips_.push_back({x.name_, resource, x.file_path_, x.animation_index_, x.animation_speed_});
+
+        // 名前逆引きテーブルに登録
+        name_table_[x.name_] = i;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 初期化が正しく成功しているかどうかを取得
+//---------------------------------------------------------------------------
+bool AnimationClipSet::isValid() const
+{
+    // 1つでも読み込みに失敗したリソースがあればfalse
+    for(const auto& clip : clips_) {
+        if(clip.resource_->isValid() == false)
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 名前からクリップ番号を検索
+//---------------------------------------------------------------------------
+s32 AnimationClipSet::find(std::string_view name) const
+{
+    auto it = name_table_.find(std::string(name));
+    if(it == name_table_.end())
+        return -1;
+
+    return static_cast<s32>(it->second);
+}
+
+//---------------------------------------------------------------------------
+//! エンジン側で評価するクリップを準備
+//---------------------------------------------------------------------------
+void AnimationClipSet::prepareEngineClips(int mv1_model) const
+{
+    namespace fs = std::filesystem;
+
+    engine_clips_.resize(clips_.size());
+
+    u32 joint_count = static_cast<u32>(std::max(MV1GetFrameNum(mv1_model), 0));
+    for(size_t index = 0; index < clips_.size(); ++index) {
+        // 作成済みなら共有
+        auto& engine_clip = engine_clips_[index];
+        if(engine_clip && engine_clip->jointCount() == joint_count)
+            continue;
+        engine_clip.reset();
+
+        const auto& clip = clips_[index];
+        if(clip.resource_->isValid() == false)
+            continue;
+
+        //------------------------------------------------------
+        // 元のMV1より新しいキャッシュファイルがあれば読み込み
+        //------------------------------------------------------
+        std::string     cache_path = clipCachePath(clip.file_path_, clip.animation_index_);
+        std::error_code source_error;
+        std::error_code cache_error;
+        auto            source_time = fs::last_write_time(clip.file_path_, source_error);
+        auto            cache_time  = fs::last_write_time(cache_path, cache_error);
+        bool            is_fresh    = !cache_error && (source_error || source_time <= cache_time);
+
+        auto result = std::make_shared<animation::Clip>();
+        if(is_fresh == false || result->load(cache_path) == false || result->jointCount() != joint_count) {
+            //--------------------------------------------------
+            // MV1からサンプリングしてキャッシュファイルへ保存
+            //--------------------------------------------------
+            *result = animation::Clip::extract(mv1_model, *clip.resource_, clip.animation_index_);
+            if(result->frameCount() == 0)
+                continue;
+
+            std::error_code error_code;
+            fs::create_directories(fs::path(cache_path).parent_path(), error_code);
+            result->save(cache_path);
+        }
+
+        engine_clip = std::move(result);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 準備済みのエンジン側のクリップを取得
+//---------------------------------------------------------------------------
+std::shared_ptr<const animation::Clip> AnimationClipSet::engineClip(size_t index) const
+{
+    if(index >= engine_clips_.size())
+        return nullptr;
+
+    return engine_clips_[index];
+}
+
+//---------------------------------------------------------------------------
+//! 使用中のクリップ集合の数を取得
+//---------------------------------------------------------------------------
+size_t AnimationClipSet::sharedCount()
+{
+    size_t count = 0;
+    for(auto& [key, clip_set] : clip_set_pool) {
+        if(!clip_set.expired())
+            count++;
+    }
+    return count;
 }
 
 //===========================================================================
@@ -334,27 +726,35 @@ ResourceAnimation::ResourceAnimation(std::string_view path)
     // パスの保存
     path_ = convertTo(resource_path);
 
-    // アニメーションが含まれるモデルデータを読み込み
-    mv1_handle_ = MV1LoadModel(resource_path.c_str());
+    //----------------------------------------------------------
+    // ストリーミングに読み込みを要求
+    //----------------------------------------------------------
+    StreamingManager::Request request;
+    request.name_ = resource_path;
 
-    // ハンドルの非同期読み込み処理が完了したら呼ばれる関数
-    auto finish_callback = []([[maybe_unused]] int mv1_handle, void* data) {
-        auto* resource = reinterpret_cast<ResourceAnimation*>(data);
+    // 非同期読み込み開始
+    request.start_ = [this, resource_path]() {
+        SetUseASyncLoadFlag(true);
+        mv1_handle_ = MV1LoadModel(resource_path.c_str());
+        SetUseASyncLoadFlag(false);
 
-        // アクティブフラグを設定
-        resource->active_ = true;
+        failed_ = mv1_handle_ == -1;
+        return !failed_;
+    };
+    request.poll_ = [this]() {
+        auto poll = StreamingManager::toPoll(CheckHandleASyncLoad(mv1_handle_));
+        failed_   = poll == StreamingManager::Poll::Failed;
+        return poll;
     };
+    request.wait_ = [this]() { WaitHandleASyncLoad(mv1_handle_); };
 
-    //----------------------------------------------------------
-    // 非同期読み込み
-    //----------------------------------------------------------
-    SetUseASyncLoadFlag(true);
-    {
-        // モデルの読み込み
-        mv1_handle_ = MV1LoadModel(resource_path.c_str());
-        SetASyncLoadFinishCallback(mv1_handle_, (void (*)(int, void*))finish_callback, this);
-    }
-    SetUseASyncLoadFlag(false);
+    // アクティブフラグを設定
+    request.finalize_ = [this]() {
+        active_ = true;
+        return true;
+    };
+
+    request_ = GetStreamingManager().request(std::move(request));
 }
 
 //---------------------------------------------------------------------------
@@ -362,6 +762,9 @@ ResourceAnimation::ResourceAnimation(std::string_view path)
 //---------------------------------------------------------------------------
 ResourceAnimation::~ResourceAnimation()
 {
+    // 読み込み中の場合は取り消す
+    GetStreamingManager().cancel(request_);
+
     // アニメーションを解放
     if(mv1_handle_ != -1) {
         MV1DeleteModel(mv1_handle_);
@@ -373,7 +776,7 @@ ResourceAnimation::~ResourceAnimation()
 //---------------------------------------------------------------------------
 bool ResourceAnimation::isValid() const
 {
-    return mv1_handle_ != -1;
+    return !failed_;
 }
 
 //---------------------------------------------------------------------------
@@ -389,5 +792,8 @@ bool ResourceAnimation::isActive() const
 //---------------------------------------------------------------------------
 ResourceAnimation::operator int() const
 {
+    // 読み込み開始前の場合はすぐに開始する (以降のMV1関数は読み込み完了までブロッキングされます)
+    GetStreamingManager().expedite(request_);
+
     return mv1_handle_;
 }
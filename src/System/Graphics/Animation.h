@@ -5,6 +5,13 @@
 #pragma once
 
 class ResourceAnimation;
+class AnimationClipSet;
+
+namespace animation
+{
+class Clip;
+class Animator;
+}   // namespace animation
 
 //===========================================================================
 //! アニメーションクラス
@@ -42,6 +49,7 @@ public:
     //! @param [in] desc_count  定義オプション配列の個数
     //! @retval true    成功(正常終了)
     //! @retval false   失敗(エラー終了)
+    //! @note   読み込み待ちの場合は失敗が確定していないため、完了後の結果はisValid()で確認してください
     bool load(const Animation::Desc* desc, size_t desc_count);
 
     //@}
@@ -50,10 +58,24 @@ public:
     //----------------------------------------------------------
     //@{
 
-    //  更新
+    //  更新 (再生時間を進めて姿勢へ反映)
     //! @param  [in]    dt  経過時間(単位:秒)
     void update(f32 dt);
 
+    //  再生時間とブレンド比のみ進める (姿勢へは反映しない)
+    //! @param  [in]    dt  経過時間(単位:秒)
+    //! @note   画面外や更新頻度を落としたモデルで使用します。反映は apply() で行います
+    void advance(f32 dt);
+
+    //  現在の再生時間とブレンド比を姿勢へ反映
+    //! @note   useAnimator()の場合は評価待ちに登録し、evaluateAnimators()でまとめて反映します
+    void apply();
+
+    //  評価待ちのアニメーターをまとめて評価して姿勢へ反映
+    //! @details useAnimator()のモデルを1回の animation::update() で並列に評価します。
+    //!          メインスレッドから1フレームに1回 (Scene::Update()の最後) 呼び出してください
+    static void evaluateAnimators();
+
     //@}
     //----------------------------------------------------------
     //! @name   設定
@@ -77,6 +99,12 @@ public:
     //! @param  [in]    active  停止フラグ(true:停止 false:再開)
     void pause(bool active = true);
 
+    //  姿勢の計算をエンジン側(animation::Animator)で行うかどうかを設定
+    //! @param  [in]    enable  true:エンジン側でサンプリング false:DxLibのアタッチで再生
+    //! @note   クリップはモデルとアニメーションの読み込み完了後にストリーミングの仕上げで準備します。
+    //!         初回はMV1からサンプリングし、cooked/以下のキャッシュファイルを次回から使用します
+    void useAnimator(bool enable = true);
+
     //@}
     //----------------------------------------------------------
     //! @name   取得
@@ -90,12 +118,16 @@ public:
     bool isPaused() const;
 
     // 初期化が正しく成功しているかどうかを取得
+    //! @note   読み込みが後から失敗した場合もfalseになります
     bool isValid() const;
 
     // 利用可能な状態かどうか取得
     //! @note   利用可能になっていない状態でDxLibアニメーション関数を呼ぶと非同期ロードがブロッキングされます
     bool isActive() const;
 
+    //! 共有しているクリップ集合を取得
+    const std::shared_ptr<const AnimationClipSet>& clipSet() const { return clips_; }
+
     //@}
     //----------------------------------------------------------
     //! @name   copy/move禁止
@@ -119,16 +151,32 @@ private:
     //! @param  [in]    context_index   コンテキスト番号
     void detachAnimation(s32 context_index);
 
+    //  エンジン側で計算する姿勢の入力を設定して評価待ちに登録
+    //! @param  [in]    ratio   補間元のアニメーションの比率
+    void applyAnimator(f32 ratio);
+
+    //  エンジン側の姿勢計算を解除 (評価待ちから外してフレームの行列を戻す)
+    void releaseAnimator();
+
+    //  エンジン側のクリップの準備をストリーミングに要求
+    void requestEngineClips();
+
+    //  準備済みのエンジン側のクリップを再生中のコンテキストへ設定
+    void resolveEngineClips();
+
     std::wstring path_;                     //!< ファイルパス
-    bool         is_valid_     = false;     //!< 初期化が正しく成功しているかどうか
     Model*       model_        = nullptr;   //!< 関連付けられているモデル
     int          model_handle_ = -1;        //!< [DxLib] 関連付けられているモデルのハンドル
+    bool         use_animator_ = false;     //!< エンジン側で姿勢を計算するかどうか
+    bool         is_queued_    = false;     //!< evaluateAnimators()の評価待ちかどうか
+
+    StreamingManager::RequestId clip_request_ = 0;   //!< エンジン側のクリップの準備要求 (use_animator_の場合のみ)
 
-    std::vector<Animation::Desc> descs_;         //!< アニメーション定義情報
-    std::vector<int>             mv1_handles_;   //!< [DxLib] アニメーションMV1ハンドル
+    //! エンジン側の姿勢計算 (use_animator_の場合のみ。モデルの関節階層から作成)
+    std::unique_ptr<animation::Animator> animator_;
 
-    //! 名前逆引きテーブル (名前からアニメーション番号を取得)
-    std::unordered_map<std::string, u32> name_table_;
+    //! クリップ集合 (同じ定義のインスタンス間で共有する不変データ)
+    std::shared_ptr<const AnimationClipSet> clips_;
 
     //----------------------------------------------------------
     //! @name   再生中の情報
@@ -140,12 +188,13 @@ private:
     //! 再生中の情報構造体
     struct Context
     {
-        bool is_playing_             = false;   //!< 再生中かどうか
-        bool is_loop_                = false;   //!< ループ再生かどうか
-        s32  animation_index_        = -1;     //!< 現在再生中の番号(Animation::Descのインデックス番号)
-        int  animation_attach_index_ = -1;     //!< [DxLib] アタッチされたスロット番号
-        f32  animation_total_time_   = 0.0f;   //!< 総再生時間
-        f32  play_time_              = 0.0f;   //!< 現在再生中の時間
+        bool                                   is_playing_             = false;   //!< 再生中かどうか
+        bool                                   is_loop_                = false;   //!< ループ再生かどうか
+        s32                                    animation_index_        = -1;     //!< 現在再生中の番号(Animation::Descのインデックス番号)
+        int                                    animation_attach_index_ = -1;     //!< [DxLib] アタッチされたスロット番号
+        f32                                    animation_total_time_   = 0.0f;   //!< 総再生時間
+        f32                                    play_time_              = 0.0f;   //!< 現在再生中の時間
+        std::shared_ptr<const animation::Clip> clip_;                             //!< エンジン側のクリップ (use_animator_の場合のみ)
     };
 
     Context contexts_[2];          //!< 構造体はアニメーションブレンドのため2系統を持つ
@@ -155,6 +204,73 @@ private:
     //@}
 };
 
+//===========================================================================
+//! アニメーションクリップ集合
+//! @details Animation::Descの配列から作る不変データです。同じ定義の組は複数のAnimationで共有し、
+//!          アニメーションMV1もファイルパスごとに1つだけ読み込みます。
+//!          インスタンスごとに異なるのは再生時間/ブレンド比/アタッチ番号のみです。
+//===========================================================================
+class AnimationClipSet final
+{
+public:
+    //! クリップ
+    struct Clip
+    {
+        std::string                        name_;                     //!< アニメーション名
+        std::shared_ptr<ResourceAnimation> resource_;                 //!< アニメーションを含むMV1
+        std::string                        file_path_;                //!< アニメーションを含むMV1のファイルパス
+        u32                                animation_index_ = 0;      //!< ファイル内のアニメーション番号
+        f32                                animation_speed_ = 1.0f;   //!< アニメーションの再生速度
+    };
+
+    //  クリップ集合を取得 (同じ定義の組が使用中なら共有)
+    //! @param [in] desc        定義オプション配列の先頭アドレス
+    //! @param [in] desc_count  定義オプション配列の個数
+    static std::shared_ptr<const AnimationClipSet> acquire(const Animation::Desc* desc, size_t desc_count);
+
+    //  コンストラクタ
+    //! @param [in] desc        定義オプション配列の先頭アドレス
+    //! @param [in] desc_count  定義オプション配列の個数
+    AnimationClipSet(const Animation::Desc* desc, size_t desc_count);
+
+    //  名前からクリップ番号を検索
+    //! @param  [in]    name    アニメーション名
+    //! @return クリップ番号 (見つからない場合は-1)
+    s32 find(std::string_view name) const;
+
+    //  エンジン側で評価するクリップを準備 (Animation::useAnimator()用)
+    //! @param  [in]    mv1_model   関節の並びの基準となるモデル
+    //! @details キャッシュファイルから読み込み、無いか古い場合はMV1からサンプリングして保存します。
+    //!          MV1関数を使用するため、モデルとアニメーションの読み込み完了後にメインスレッドから呼び出してください。
+    //!          クリップ集合を共有するモデルは同じ関節階層であることを前提に、結果も共有します。
+    void prepareEngineClips(int mv1_model) const;
+
+    //  準備済みのエンジン側のクリップを取得
+    //! @param  [in]    index       クリップ番号
+    //! @return クリップ (準備前または読み込みに失敗した場合はnullptr)
+    std::shared_ptr<const animation::Clip> engineClip(size_t index) const;
+
+    //! クリップを取得
+    const Clip& operator[](size_t index) const { return clips_[index]; }
+
+    //! クリップ数を取得
+    size_t size() const { return clips_.size(); }
+
+    //  初期化が正しく成功しているかどうかを取得
+    //! @note   読み込み中のリソースは失敗が確定していないためtrueを返します
+    bool isValid() const;
+
+    //  使用中のクリップ集合の数を取得
+    static size_t sharedCount();
+
+private:
+    std::vector<Clip>                    clips_;        //!< クリップ (定義順)
+    std::unordered_map<std::string, u32> name_table_;   //!< 名前逆引きテーブル (名前からクリップ番号を取得)
+
+    //! エンジン側のクリップ (クリップ番号ごと。prepareEngineClips()で作成)
+    mutable std::vector<std::shared_ptr<const animation::Clip>> engine_clips_;
+};
+
 //===========================================================================
 //! アニメーション情報
 //===========================================================================
@@ -181,6 +297,9 @@ public:
     // [DxLib] MV1ハンドルを取得
     operator int() const;
 
+    //! ストリーミングの要求IDを取得
+    StreamingManager::RequestId request() const { return request_; }
+
     //----------------------------------------------------------
     //! @name   copy/move禁止
     //----------------------------------------------------------
@@ -195,7 +314,9 @@ private:
     //@}
 
 private:
-    std::wstring      path_;                 //!< モデルファイルへのパス
-    int               mv1_handle_ = -1;      //!< [DxLib] MV1モデルハンドル (アニメーション用途)
-    std::atomic<bool> active_     = false;   //!< アクティブ状態 true:利用可能 false:ロード未完了
+    std::wstring                path_;                 //!< モデルファイルへのパス
+    int                         mv1_handle_ = -1;      //!< [DxLib] MV1モデルハンドル (アニメーション用途)
+    std::atomic<bool>           active_     = false;   //!< アクティブ状態 true:利用可能 false:ロード未完了
+    std::atomic<bool>           failed_     = false;   //!< 読み込みに失敗したかどうか
+    StreamingManager::RequestId request_    = 0;       //!< ストリーミングの要求ID
 };
@@ -0,0 +1,126 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AnimationLod.cpp
+//! @brief  アニメーションLOD (画面上の大きさによる更新頻度の間引き)
+//---------------------------------------------------------------------------
+#include "AnimationLod.h"
+
+//---------------------------------------------------------------------------
+//! フレームの開始
+//---------------------------------------------------------------------------
+void AnimationLod::beginFrame(const Frustum& frustum)
+{
+    frustum_          = frustum;
+    projection_scale_ = static_cast<f32>(frustum.matProj().axisY().y);
+
+    // 前フレームで予算を要求したモデルの経過フレーム数の分布から、予算に収まる下限を決める
+    // 更新されなかったモデルは経過フレーム数が増えるため、次のフレームでは先に予算を割り当てられる
+    age_threshold_ = 0;
+    u32 count      = 0;
+    for(u32 age = AGE_BUCKETS; age-- > 0;) {
+        count += age_histogram_[age];
+        if(count >= settings_.ifpossible_budget_) {
+            age_threshold_ = age;
+            break;
+        }
+    }
+    std::fill(std::begin(age_histogram_), std::end(age_histogram_), 0);
+
+    // 集計結果を確定
+    last_stats_       = stats_;
+    stats_            = {};
+    ifpossible_count_ = 0;
+    frame_++;
+}
+
+//---------------------------------------------------------------------------
+//! 更新レベルを選択
+//---------------------------------------------------------------------------
+AnimationLod::Level AnimationLod::select(const float3& center, f32 radius)
+{
+    Level level = Level::Full;
+
+    // 間引かない場合は常に毎フレーム更新
+    if(settings_.enabled_) {
+        if(!frustum_.isVisible(center, radius)) {
+            level = Level::Hidden;   // 画面外
+        }
+        else {
+            f32 ratio = screenRatio(center, radius);
+            if(ratio < settings_.quarter_screen_ratio_)
+                level = Level::Quarter;
+            else if(ratio < settings_.half_screen_ratio_)
+                level = Level::Half;
+        }
+    }
+
+    stats_.counts_[static_cast<u32>(level)]++;
+    return level;
+}
+
+//---------------------------------------------------------------------------
+//! 今フレームで姿勢を更新するかどうか
+//---------------------------------------------------------------------------
+bool AnimationLod::shouldSample(Level level, u32 phase, u32& sampled_frame, Priority priority)
+{
+    u32 frames = interval(level);
+    if(frames == 0 || (frame_ + phase) % frames != 0)
+        return false;
+
+    // 処理時間が無ければ処理しない
+    // 呼び出し順で予算を使い切ると同じモデルばかり間引かれるため、最後に更新してから長いモデルを優先
+    if(settings_.enabled_ && PRIORITY(priority) >= PRIORITY(Priority::IFPOSSIBLE)) {
+        u32 age = std::min(frame_ - sampled_frame, AGE_BUCKETS - 1);
+        age_histogram_[age]++;
+
+        if(ifpossible_count_ >= settings_.ifpossible_budget_ || age < age_threshold_) {
+            stats_.throttled_++;
+            return false;
+        }
+        ifpossible_count_++;
+    }
+
+    sampled_frame = frame_;
+    stats_.sampled_++;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 画面の高さに対する大きさを取得
+//---------------------------------------------------------------------------
+f32 AnimationLod::screenRatio(const float3& center, f32 radius) const
+{
+    f32 distance = length(center - frustum_.position()).x;
+
+    // カメラが境界球の内側にある場合は画面全体
+    if(distance <= radius)
+        return 1.0f;
+
+    // 距離dでの画面の高さは 2・d・tan(fovy / 2)
+    return radius * projection_scale_ / distance;
+}
+
+//---------------------------------------------------------------------------
+//! 更新間隔を取得
+//---------------------------------------------------------------------------
+u32 AnimationLod::interval(Level level)
+{
+    switch(level) {
+    case Level::Full:
+        return 1;
+    case Level::Half:
+        return 2;
+    case Level::Quarter:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! アニメーションLODを取得
+//---------------------------------------------------------------------------
+AnimationLod& GetAnimationLod()
+{
+    static AnimationLod lod;
+    return lod;
+}
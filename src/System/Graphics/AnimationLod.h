@@ -0,0 +1,118 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AnimationLod.h
+//! @brief  アニメーションLOD (画面上の大きさによる更新頻度の間引き)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <System/Graphics/Frustum.h>
+#include <System/Priority.h>
+
+//===========================================================================
+//! アニメーションLOD
+//! @details カメラからの距離と画面上の大きさからアニメーションの更新頻度を決めます。
+//!          遠くのキャラクターは数フレームに1回だけ姿勢を更新し、画面外のキャラクターは再生時間のみ進めます。
+//!          再生時間は毎フレーム進めるため、姿勢を更新したフレームでは常に正しい時刻の姿勢になります。
+//!          Priority::IFPOSSIBLE のモデルは1フレームあたりの更新数の予算を超えると1段階粗く更新します。
+//!          予算は最後に更新してからのフレーム数が多いモデルから割り当てるため、巡回順で後ろのモデルも更新されます。
+//===========================================================================
+class AnimationLod
+{
+public:
+    //! 更新レベル
+    enum class Level : u32
+    {
+        Full,      //!< 毎フレーム更新
+        Half,      //!< 2フレームに1回更新
+        Quarter,   //!< 4フレームに1回更新
+        Hidden,    //!< 画面外 (再生時間のみ進める)
+
+        NUM,
+    };
+
+    //! 設定
+    struct Settings
+    {
+        f32  half_screen_ratio_    = 0.25f;   //!< 画面の高さに対する大きさがこれ未満なら Half
+        f32  quarter_screen_ratio_ = 0.08f;   //!< 画面の高さに対する大きさがこれ未満なら Quarter
+        u32  ifpossible_budget_    = 16;      //!< Priority::IFPOSSIBLE のモデルを1フレームで更新できる数
+        bool enabled_              = true;    //!< false:間引かずに全モデルを毎フレーム更新 (比較用)
+    };
+
+    //! 統計情報 (直前のフレーム)
+    struct Stats
+    {
+        u32 counts_[static_cast<u32>(Level::NUM)] = {};   //!< レベルごとのモデル数
+        u32 sampled_                              = 0;    //!< 姿勢を更新したモデル数
+        u32 throttled_                            = 0;    //!< 予算超過で粗くしたモデル数
+    };
+
+    //----------------------------------------------------------
+    //! @name   フレーム制御
+    //----------------------------------------------------------
+    //@{
+
+    //  フレームの開始
+    //! @param  [in]    frustum カメラの視錐台
+    void beginFrame(const Frustum& frustum);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   判定
+    //----------------------------------------------------------
+    //@{
+
+    //  更新レベルを選択 (統計に記録されます)
+    //! @param  [in]    center  境界球の中心 (ワールド空間)
+    //! @param  [in]    radius  境界球の半径
+    Level select(const float3& center, f32 radius);
+
+    //  今フレームで姿勢を更新するかどうか (統計に記録されます)
+    //! @param  [in]    level           更新レベル
+    //! @param  [in]    phase           モデルごとの位相 (更新するフレームを分散させるため)
+    //! @param  [inout] sampled_frame   モデルごとの最後に更新したフレーム番号 (更新した場合は今フレームの番号を設定)
+    //! @param  [in]    priority        優先度 (Priority::IFPOSSIBLE 以下は予算内のみ更新)
+    bool shouldSample(Level level, u32 phase, u32& sampled_frame, Priority priority = Priority::NORMAL);
+
+    //  画面の高さに対する大きさを取得
+    //! @param  [in]    center  境界球の中心 (ワールド空間)
+    //! @param  [in]    radius  境界球の半径
+    f32 screenRatio(const float3& center, f32 radius) const;
+
+    //! モデルごとの位相を発行
+    u32 issuePhase() { return next_phase_++; }
+
+    //! 更新間隔を取得 (単位:フレーム, Hiddenは0)
+    static u32 interval(Level level);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   設定/参照
+    //----------------------------------------------------------
+    //@{
+
+    //! 設定を取得
+    Settings& settings() { return settings_; }
+
+    //! 統計情報を取得 (直前のフレーム)
+    const Stats& stats() const { return last_stats_; }
+
+    //@}
+
+private:
+    //! 経過フレーム数の分布の段階数 (これ以上は最後の段階にまとめる)
+    static constexpr u32 AGE_BUCKETS = 64;
+
+    Settings settings_;                             //!< 設定
+    Frustum  frustum_;                              //!< カメラの視錐台
+    f32      projection_scale_           = 1.0f;   //!< 投影行列の縦方向のスケール (1 / tan(fovy / 2))
+    u32      frame_                      = 0;      //!< フレーム番号
+    u32      next_phase_                 = 0;      //!< 次に発行する位相
+    u32      ifpossible_count_           = 0;      //!< 今フレームで更新した Priority::IFPOSSIBLE のモデル数
+    u32      age_threshold_              = 0;      //!< Priority::IFPOSSIBLE のモデルを更新する経過フレーム数の下限
+    u32      age_histogram_[AGE_BUCKETS] = {};     //!< 予算を要求したモデルの経過フレーム数の分布 (集計中)
+    Stats    stats_;                                //!< 統計情報 (集計中)
+    Stats    last_stats_;                           //!< 統計情報 (直前のフレーム)
+};
+
+//  アニメーションLODを取得
+AnimationLod& GetAnimationLod();
@@ -12,6 +12,12 @@ Frustum::Frustum(const matrix& mat_view, const matrix& mat_proj, Frustum::DepthM
     , mat_view_(mat_view)
     , mat_proj_(mat_proj)
 {
+    mat_view_proj_    = mul(mat_view_, mat_proj_);
+    mat_camera_world_ = inverse(mat_view_);
+    position_         = mat_camera_world_.translate();
+
+    updatePlanes();
+
     // 各パラメーターを行列から抽出
 
     // float3            position_        = float3(0.0f, 5.0f, -15.0f);   //!< 位置
@@ -54,6 +60,40 @@ void Frustum::update()
 
     // 合成
     mat_view_proj_ = mul(mat_view_, mat_proj_);
+
+    updatePlanes();
+}
+
+//---------------------------------------------------------------------------
+//! ビュー ✕ 投影行列からクリップ面を抽出
+//---------------------------------------------------------------------------
+void Frustum::updatePlanes()
+{
+    // 行ベクトル形式 (clip = v * M) のため、行列の列がそれぞれ clip.x/y/z/w を与える
+    // クリップ空間の内側 -w <= x,y <= w, 0 <= z <= w から平面を作成する
+    float4x4 m  = transpose(mat_view_proj_);
+    float4   c0 = m._11_12_13_14;
+    float4   c1 = m._21_22_23_24;
+    float4   c2 = m._31_32_33_34;
+    float4   c3 = m._41_42_43_44;
+
+    planes_[0] = c3 + c0;   // 左
+    planes_[1] = c3 - c0;   // 右
+    planes_[2] = c3 + c1;   // 下
+    planes_[3] = c3 - c1;   // 上
+    planes_[4] = c2;        // 近 (反転Zでは遠)
+    planes_[5] = c3 - c2;   // 遠 (反転Zでは近)
+
+    for(auto& plane : planes_) {
+        f32 length = hlslpp::length(plane.xyz).x;
+
+        // 無限遠の遠クリップ面は法線が求まらないため判定から除外する (常に内側)
+        if(length < FLT_EPSILON) {
+            plane = float4(0.0f, 0.0f, 0.0f, 1.0f);
+            continue;
+        }
+        plane /= length;
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -213,7 +253,7 @@ Frustum& Frustum::setNearZ(f32 z_near)
 //---------------------------------------------------------------------------
 Frustum& Frustum::setFarZ(f32 z_far)
 {
-    z_far = z_far;
+    z_far_ = z_far;
     return *this;
 }
 
@@ -362,3 +402,26 @@ const matrix& Frustum::matViewProj() const
 {
     return mat_view_proj_;
 }
+
+//---------------------------------------------------------------------------
+//! クリップ面を取得
+//---------------------------------------------------------------------------
+const std::array<float4, 6>& Frustum::planes() const
+{
+    return planes_;
+}
+
+//---------------------------------------------------------------------------
+//! 球が視錐台と交差しているかどうか
+//---------------------------------------------------------------------------
+bool Frustum::isVisible(const float3& center, f32 radius) const
+{
+    for(const auto& plane : planes_) {
+        // 平面の外側に半径以上離れていたら不可視
+        f32 distance = dot(plane.xyz, center).x + plane.w;
+        if(distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
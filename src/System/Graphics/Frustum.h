@@ -4,6 +4,8 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <array>
+
 //===========================================================================
 //! カメラ
 //===========================================================================
@@ -136,19 +138,40 @@ public:
     //  ビュー ✕ 投影行列を取得
     [[nodiscard]] const matrix& matViewProj() const;
 
+    //  クリップ面を取得
+    //! @return 正規化済みの平面 (xyz:内向きの法線 w:原点からの距離) 左/右/下/上/近/遠の順
+    [[nodiscard]] const std::array<float4, 6>& planes() const;
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   可視判定
+    //----------------------------------------------------------
+    //@{
+
+    //  球が視錐台と交差しているかどうか
+    //! @param  [in]    center  中心座標 (ワールド空間)
+    //! @param  [in]    radius  半径
+    //! @retval true    交差している (一部でも視錐台の内側にある)
+    [[nodiscard]] bool isVisible(const float3& center, f32 radius) const;
+
     //@}
 
 private:
-    float3             position_         = float3(0.0f, 5.0f, -15.0f);    //!< 位置
-    float3             look_at_          = float3(0.0f, 0.0f, 0.0f);      //!< 注視点
-    float3             world_up_         = float3(0.0f, 1.0f, 0.0f);      //!< 世界の上方向のベクトル
-    f32                fovy_             = 60.0f * DegToRad;              //!< 画角(単位:radian)
-    f32                aspect_ratio_     = 16.0f / 9.0f;                  //!< アスペクト比
-    f32                z_near_           = 0.01f;                         //!< 近クリップ面までの距離
-    f32                z_far_            = 1000.0f;                       //!< 遠クリップ面までの距離
-    Frustum::DepthMode depth_mode_       = Frustum::DepthMode::Default;   //!< デプス動作モード
-    matrix             mat_camera_world_ = matrix::identity();            //!< カメラのワールド行列
-    matrix             mat_view_         = matrix::identity();            //!< ビュー行列
-    matrix             mat_proj_         = matrix::identity();            //!< 投影行列
-    matrix             mat_view_proj_    = matrix::identity();            //!< ビュー ✕ 投影行列
+    //  ビュー ✕ 投影行列からクリップ面を抽出
+    void updatePlanes();
+
+private:
+    float3                position_         = float3(0.0f, 5.0f, -15.0f);    //!< 位置
+    float3                look_at_          = float3(0.0f, 0.0f, 0.0f);      //!< 注視点
+    float3                world_up_         = float3(0.0f, 1.0f, 0.0f);      //!< 世界の上方向のベクトル
+    f32                   fovy_             = 60.0f * DegToRad;              //!< 画角(単位:radian)
+    f32                   aspect_ratio_     = 16.0f / 9.0f;                  //!< アスペクト比
+    f32                   z_near_           = 0.01f;                         //!< 近クリップ面までの距離
+    f32                   z_far_            = 1000.0f;                       //!< 遠クリップ面までの距離
+    Frustum::DepthMode    depth_mode_       = Frustum::DepthMode::Default;   //!< デプス動作モード
+    matrix                mat_camera_world_ = matrix::identity();            //!< カメラのワールド行列
+    matrix                mat_view_         = matrix::identity();            //!< ビュー行列
+    matrix                mat_proj_         = matrix::identity();            //!< 投影行列
+    matrix                mat_view_proj_    = matrix::identity();            //!< ビュー ✕ 投影行列
+    std::array<float4, 6> planes_{};                                         //!< クリップ面 (左/右/下/上/近/遠)
 };
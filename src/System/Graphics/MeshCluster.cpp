@@ -0,0 +1,136 @@
+﻿//---------------------------------------------------------------------------
+//! @file   MeshCluster.cpp
+//! @brief  メッシュクラスター (三角形の塊ごとの視錐台/背面カリング)
+//---------------------------------------------------------------------------
+#include "MeshCluster.h"
+#include "Frustum.h"
+
+namespace
+{
+
+//! ワールド行列のスケールを取得
+//! @param  [in]    mat_world   ワールド行列
+//! @param  [out]   scale_max   最大スケール (境界球の半径はこの値で拡大する)
+//! @param  [out]   use_cone    法線コーンで背面カリングできるかどうか
+void worldScale(const matrix& mat_world, f32& scale_max, bool& use_cone)
+{
+    f32 scale_x   = length(mat_world.axisX()).x;
+    f32 scale_y   = length(mat_world.axisY()).x;
+    f32 scale_z   = length(mat_world.axisZ()).x;
+    scale_max     = std::max(scale_x, std::max(scale_y, scale_z));
+    f32 scale_min = std::min(scale_x, std::min(scale_y, scale_z));
+
+    // 不均一スケールでは法線コーンの角度が保存されないため、背面カリングを行わない
+    use_cone = scale_min > FLT_EPSILON && (scale_max - scale_min) <= scale_max * 1e-3f;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 構築
+//---------------------------------------------------------------------------
+void MeshCluster::build(const f32* positions, size_t vertex_count, size_t stride, std::vector<u32>& indices)
+{
+    clusters_ = mesh_cook::buildClusters(positions, vertex_count, stride, indices);
+}
+
+//---------------------------------------------------------------------------
+//! 構築済みのクラスターを設定
+//---------------------------------------------------------------------------
+bool MeshCluster::assign(std::vector<Cluster>&& clusters, size_t index_count)
+{
+    for(const auto& cluster : clusters) {
+        if(cluster.index_count_ % 3 != 0 ||
+           static_cast<size_t>(cluster.index_offset_) + cluster.index_count_ > index_count) {
+            clusters_.clear();
+            return false;
+        }
+    }
+
+    clusters_ = std::move(clusters);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 解放
+//---------------------------------------------------------------------------
+void MeshCluster::clear()
+{
+    clusters_.clear();
+}
+
+//---------------------------------------------------------------------------
+//! 視錐台と法線コーンで可視判定
+//---------------------------------------------------------------------------
+u32 MeshCluster::cull(const Frustum& frustum, const matrix& mat_world, std::vector<Range>& ranges) const
+{
+    ranges.clear();
+
+    f32  scale_max;
+    bool use_cone;
+    worldScale(mat_world, scale_max, use_cone);
+
+    u32 visible_count = 0;
+    for(const auto& cluster : clusters_) {
+        if(!isVisible(cluster, frustum, mat_world, scale_max, use_cone)) {
+            continue;
+        }
+
+        //------------------------------------------------------
+        // 可視範囲へ追加 (直前の範囲と連続していれば結合)
+        //------------------------------------------------------
+        if(!ranges.empty() && ranges.back().index_offset_ + ranges.back().index_count_ == cluster.index_offset_) {
+            ranges.back().index_count_ += cluster.index_count_;
+        }
+        else {
+            ranges.push_back({cluster.index_offset_, cluster.index_count_});
+        }
+        ++visible_count;
+    }
+
+    return visible_count;
+}
+
+//---------------------------------------------------------------------------
+//! 1つの境界の可視判定
+//---------------------------------------------------------------------------
+bool MeshCluster::isVisible(const Cluster& cluster, const Frustum& frustum, const matrix& mat_world)
+{
+    f32  scale_max;
+    bool use_cone;
+    worldScale(mat_world, scale_max, use_cone);
+
+    return isVisible(cluster, frustum, mat_world, scale_max, use_cone);
+}
+
+//---------------------------------------------------------------------------
+//! ワールド行列のスケールを適用済みの可視判定
+//---------------------------------------------------------------------------
+bool MeshCluster::isVisible(const Cluster& cluster, const Frustum& frustum, const matrix& mat_world, f32 scale_max, bool use_cone)
+{
+    //------------------------------------------------------
+    // 視錐台カリング (境界球)
+    //------------------------------------------------------
+    float3 center = mul(float4(cluster.center_[0], cluster.center_[1], cluster.center_[2], 1.0f), mat_world).xyz;
+    if(!frustum.isVisible(center, cluster.radius_ * scale_max)) {
+        return false;
+    }
+
+    //------------------------------------------------------
+    // 背面カリング (法線コーン)
+    // コーン内のすべての三角形がカメラに背を向けていれば不可視
+    //------------------------------------------------------
+    if(use_cone && cluster.cone_cutoff_ < 1.0f) {
+        float3 apex =
+            mul(float4(cluster.cone_apex_[0], cluster.cone_apex_[1], cluster.cone_apex_[2], 1.0f), mat_world).xyz;
+        float3 axis =
+            mul(float4(cluster.cone_axis_[0], cluster.cone_axis_[1], cluster.cone_axis_[2], 0.0f), mat_world).xyz;
+
+        float3 view = apex - frustum.position();
+        if(dot(view, view).x > FLT_EPSILON && dot(normalize(view), normalize(axis)).x >= cluster.cone_cutoff_) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,101 @@
+﻿//---------------------------------------------------------------------------
+//! @file   MeshCluster.h
+//! @brief  メッシュクラスター (三角形の塊ごとの視錐台/背面カリング)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+
+#include "MeshCook.h"
+
+class Frustum;
+
+//===========================================================================
+//! メッシュクラスター
+//! @details 静的メッシュを最大 MAX_VERTICES 頂点 / MAX_TRIANGLES 三角形の塊(メッシュレット)に分割し、
+//!          塊ごとの境界球と法線コーンを使って、描画前にCPUで見えない塊を除外します。
+//!          GPUを使わずに判定できるため、ヘッドレス環境でも同じ結果が得られます。
+//===========================================================================
+class MeshCluster
+{
+public:
+    static constexpr u32 MAX_VERTICES  = mesh_cook::CLUSTER_MAX_VERTICES;    //!< 1クラスターの最大頂点数
+    static constexpr u32 MAX_TRIANGLES = mesh_cook::CLUSTER_MAX_TRIANGLES;   //!< 1クラスターの最大三角形数 (4の倍数)
+    static constexpr f32 CONE_WEIGHT   = mesh_cook::CLUSTER_CONE_WEIGHT;     //!< 分割時に法線コーンの狭さを優先する度合い (0.0～1.0)
+
+    //! クラスター (キャッシュファイルへそのまま保存するため固定レイアウト)
+    using Cluster = mesh_cook::Cluster;
+
+    //! 描画するインデックス範囲 (隣接する可視クラスターは結合されます)
+    struct Range
+    {
+        u32 index_offset_;   //!< インデックス配列内の開始位置
+        u32 index_count_;    //!< インデックス数
+    };
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //! デフォルトコンストラクタ
+    MeshCluster() = default;
+
+    //  構築
+    //! @param  [in]    positions       頂点座標 (各頂点の先頭12byteがxyz)
+    //! @param  [in]    vertex_count    頂点数
+    //! @param  [in]    stride          頂点のサイズ
+    //! @param  [inout] indices         インデックス配列 (クラスターごとに連続するよう並べ替えられます)
+    void build(const f32* positions, size_t vertex_count, size_t stride, std::vector<u32>& indices);
+
+    //  構築済みのクラスターを設定 (キャッシュファイルからの読み込み用)
+    //! @param  [in]    clusters        クラスター配列
+    //! @param  [in]    index_count     インデックス数 (範囲外を参照していないか検証します)
+    //! @retval false   範囲外のインデックスを参照している
+    bool assign(std::vector<Cluster>&& clusters, size_t index_count);
+
+    //  解放
+    void clear();
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   カリング
+    //----------------------------------------------------------
+    //@{
+
+    //  視錐台と法線コーンで可視判定
+    //! @param  [in]    frustum     視錐台 (カメラ位置とクリップ面を参照)
+    //! @param  [in]    mat_world   ワールド行列
+    //! @param  [out]   ranges      可視クラスターのインデックス範囲
+    //! @return 可視クラスター数
+    u32 cull(const Frustum& frustum, const matrix& mat_world, std::vector<Range>& ranges) const;
+
+    //  1つの境界 (クラスターまたはメッシュ全体) の可視判定
+    //! @param  [in]    cluster     境界球と法線コーン (cone_cutoff_ が1.0の場合は背面カリングしない)
+    //! @param  [in]    frustum     視錐台
+    //! @param  [in]    mat_world   ワールド行列
+    static bool isVisible(const Cluster& cluster, const Frustum& frustum, const matrix& mat_world);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //! クラスター配列を取得
+    const std::vector<Cluster>& clusters() const { return clusters_; }
+
+    //! 構築済みかどうか
+    bool isValid() const { return !clusters_.empty(); }
+
+    //@}
+
+private:
+    //  ワールド行列のスケールを適用済みの可視判定
+    //! @param  [in]    scale_max   ワールド行列の最大スケール
+    //! @param  [in]    use_cone    法線コーンで背面カリングするかどうか
+    static bool isVisible(const Cluster& cluster, const Frustum& frustum, const matrix& mat_world, f32 scale_max, bool use_cone);
+
+private:
+    std::vector<Cluster> clusters_;   //!< クラスター配列 (インデックス順)
+};
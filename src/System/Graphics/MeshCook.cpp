@@ -0,0 +1,319 @@
+﻿//---------------------------------------------------------------------------
+//! @file   MeshCook.cpp
+//! @brief  メッシュのクック処理 (最適化/クラスター分割/キャッシュ形式での書き出し)
+//---------------------------------------------------------------------------
+#include "MeshCook.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+#include <meshoptimizer/src/meshoptimizer.h>
+
+//---------------------------------------------------------------------------
+// [モデルキャッシュのファイル形式]
+//     u32 バージョン / u32 格納形式(Codec) / u32 頂点数 / u32 インデックス数
+//     Raw     : f32x3[頂点数] / u32[インデックス数]
+//     Meshopt : u32 頂点データサイズ / u32 インデックスデータサイズ / 頂点データ / インデックスデータ
+//               頂点は座標をmeshopt_encodeFilterExpで量子化してからmeshopt_encodeVertexBufferで圧縮
+//     共通    : u32 クラスター数 / Cluster[クラスター数]
+//---------------------------------------------------------------------------
+
+namespace mesh_cook
+{
+
+namespace
+{
+
+constexpr size_t POSITION_STRIDE     = sizeof(f32) * 3;   //!< 1頂点のサイズ
+constexpr f32    DEGENERATE_RATIO_SQ = 1e-12f;            //!< 縮退とみなす (高さ/最長辺)² (高さが最長辺の1e-6倍以下)
+
+//---------------------------------------------------------------------------
+//! 値を書き出し
+//---------------------------------------------------------------------------
+template <class T>
+void write(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//---------------------------------------------------------------------------
+//! 三角形の最長辺の長さの2乗
+//---------------------------------------------------------------------------
+f32 longestEdgeSq(const f32* p0, const f32* p1, const f32* p2)
+{
+    auto length_sq = [](const f32* a, const f32* b) {
+        f32 d[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        return d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+    };
+    return std::max(std::max(length_sq(p0, p1), length_sq(p1, p2)), length_sq(p2, p0));
+}
+
+//---------------------------------------------------------------------------
+//! 外積の長さの2乗から縮退しているかどうかを判定
+//! @details 外積の長さ(面積の2倍) = 最長辺 × 高さ のため、三角形自身の大きさに対する比率で判定します。
+//!          絶対値で判定すると、小さいが正しい形の三角形(細かい当たり判定用の形状など)まで除去されてしまいます。
+//---------------------------------------------------------------------------
+bool isDegenerate(f32 cross_length_sq, f32 longest_edge_sq)
+{
+    return cross_length_sq <= DEGENERATE_RATIO_SQ * longest_edge_sq * longest_edge_sq;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 縮退三角形かどうか
+//---------------------------------------------------------------------------
+bool isDegenerate(const f32* p0, const f32* p1, const f32* p2)
+{
+    f32 a[3] = {p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2]};
+    f32 b[3] = {p0[0] - p1[0], p0[1] - p1[1], p0[2] - p1[2]};
+    f32 c[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+
+    return isDegenerate(c[0] * c[0] + c[1] * c[1] + c[2] * c[2], longestEdgeSq(p0, p1, p2));
+}
+
+//---------------------------------------------------------------------------
+//! 縮退三角形を除去
+//---------------------------------------------------------------------------
+void removeDegenerateTriangles(Mesh& mesh)
+{
+    const f32* p      = mesh.positions_.data();
+    auto&      iarray = mesh.indices_;
+
+    size_t count = 0;
+    for(size_t i = 0; i + 2 < iarray.size(); i += 3) {
+        u32 i0 = iarray[i + 0];
+        u32 i1 = iarray[i + 1];
+        u32 i2 = iarray[i + 2];
+        if(isDegenerate(p + i0 * 3, p + i1 * 3, p + i2 * 3)) {
+            continue;
+        }
+        iarray[count++] = i0;
+        iarray[count++] = i1;
+        iarray[count++] = i2;
+    }
+    iarray.resize(count);
+}
+
+void removeDegenerateTriangles(Mesh& mesh, const f32* cross_length_sq)
+{
+    const f32* p      = mesh.positions_.data();
+    auto&      iarray = mesh.indices_;
+
+    size_t count = 0;
+    for(size_t i = 0; i + 2 < iarray.size(); i += 3) {
+        f32 longest_edge_sq = longestEdgeSq(p + iarray[i + 0] * 3, p + iarray[i + 1] * 3, p + iarray[i + 2] * 3);
+        if(isDegenerate(cross_length_sq[i / 3], longest_edge_sq)) {
+            continue;
+        }
+        iarray[count++] = iarray[i + 0];
+        iarray[count++] = iarray[i + 1];
+        iarray[count++] = iarray[i + 2];
+    }
+    iarray.resize(count);
+}
+
+//---------------------------------------------------------------------------
+//! 重複頂点を結合して未使用の頂点を除去
+//---------------------------------------------------------------------------
+void weldVertices(Mesh& mesh)
+{
+    auto& varray = mesh.positions_;
+    auto& iarray = mesh.indices_;
+
+    if(iarray.empty()) {
+        varray.clear();
+        return;
+    }
+
+    std::vector<u32> remap(mesh.vertexCount());
+
+    // [meshoptimizer] 重複頂点を結合
+    size_t total_vertex_count = meshopt_generateVertexRemap(
+        remap.data(), iarray.data(), iarray.size(), varray.data(), mesh.vertexCount(), POSITION_STRIDE);
+
+    // [meshoptimizer] インデックスバッファを結合後の頂点でつけ直す
+    meshopt_remapIndexBuffer(iarray.data(), iarray.data(), iarray.size(), remap.data());
+
+    // [meshoptimizer] 使用している頂点のみで詰め直す
+    meshopt_remapVertexBuffer(varray.data(), varray.data(), mesh.vertexCount(), POSITION_STRIDE, remap.data());
+    varray.resize(total_vertex_count * 3);
+}
+
+//---------------------------------------------------------------------------
+//! 頂点キャッシュ/オーバードロー/頂点フェッチの最適化
+//---------------------------------------------------------------------------
+void optimize(Mesh& mesh)
+{
+    auto& varray = mesh.positions_;
+    auto& iarray = mesh.indices_;
+
+    if(iarray.empty()) {
+        return;
+    }
+
+    // [meshoptimizer] 頂点キャッシュ最適化
+    meshopt_optimizeVertexCache(iarray.data(), iarray.data(), iarray.size(), mesh.vertexCount());
+
+    // [meshoptimizer] オーバードロー最適化
+    meshopt_optimizeOverdraw(
+        iarray.data(), iarray.data(), iarray.size(), varray.data(), mesh.vertexCount(), POSITION_STRIDE, 1.0f);
+
+    // [meshoptimizer] 頂点フェッチ最適化 (未使用の頂点は末尾に残らず除去される)
+    size_t vertex_count = meshopt_optimizeVertexFetch(
+        varray.data(), iarray.data(), iarray.size(), varray.data(), mesh.vertexCount(), POSITION_STRIDE);
+    varray.resize(vertex_count * 3);
+
+#if !defined(NDEBUG)
+    // 縮退三角形の存在チェック
+    for(size_t i = 0; i + 2 < iarray.size(); i += 3) {
+        const f32* p = varray.data();
+        assert(!isDegenerate(p + iarray[i + 0] * 3, p + iarray[i + 1] * 3, p + iarray[i + 2] * 3) &&
+               "縮退ポリゴンが検出されました.");
+    }
+#endif
+}
+
+//---------------------------------------------------------------------------
+//! クラスター分割
+//---------------------------------------------------------------------------
+std::vector<Cluster> buildClusters(const f32* positions, size_t vertex_count, size_t stride, std::vector<u32>& indices)
+{
+    std::vector<Cluster> clusters;
+
+    if(indices.empty()) {
+        return clusters;
+    }
+
+    //----------------------------------------------------------
+    // [meshoptimizer] メッシュレットに分割
+    //----------------------------------------------------------
+    size_t max_meshlets = meshopt_buildMeshletsBound(indices.size(), CLUSTER_MAX_VERTICES, CLUSTER_MAX_TRIANGLES);
+
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<u32>             meshlet_vertices(max_meshlets * CLUSTER_MAX_VERTICES);
+    std::vector<u8>              meshlet_triangles(max_meshlets * CLUSTER_MAX_TRIANGLES * 3);
+
+    size_t meshlet_count = meshopt_buildMeshlets(meshlets.data(),
+                                                 meshlet_vertices.data(),
+                                                 meshlet_triangles.data(),
+                                                 indices.data(),
+                                                 indices.size(),
+                                                 positions,
+                                                 vertex_count,
+                                                 stride,
+                                                 CLUSTER_MAX_VERTICES,
+                                                 CLUSTER_MAX_TRIANGLES,
+                                                 CLUSTER_CONE_WEIGHT);
+    meshlets.resize(meshlet_count);
+
+    //----------------------------------------------------------
+    // クラスターごとに境界を計算し、インデックスを連続に並べ替え
+    //----------------------------------------------------------
+    std::vector<u32> reordered;
+    reordered.reserve(indices.size());
+    clusters.reserve(meshlet_count);
+
+    for(const auto& meshlet : meshlets) {
+        const u32* local_vertices  = &meshlet_vertices[meshlet.vertex_offset];
+        const u8*  local_triangles = &meshlet_triangles[meshlet.triangle_offset];
+
+        // [meshoptimizer] 境界球と法線コーン
+        meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+            local_vertices, local_triangles, meshlet.triangle_count, positions, vertex_count, stride);
+
+        Cluster cluster{};
+        for(u32 i = 0; i < 3; ++i) {
+            cluster.center_[i]    = bounds.center[i];
+            cluster.cone_apex_[i] = bounds.cone_apex[i];
+            cluster.cone_axis_[i] = bounds.cone_axis[i];
+        }
+        cluster.radius_       = bounds.radius;
+        cluster.cone_cutoff_  = bounds.cone_cutoff;
+        cluster.index_offset_ = static_cast<u32>(reordered.size());
+        cluster.index_count_  = meshlet.triangle_count * 3;
+
+        // メッシュレット内の頂点番号を元の頂点番号へ戻す
+        for(u32 i = 0; i < meshlet.triangle_count * 3; ++i) {
+            reordered.push_back(local_vertices[local_triangles[i]]);
+        }
+
+        clusters.push_back(cluster);
+    }
+
+    indices.swap(reordered);
+    return clusters;
+}
+
+//---------------------------------------------------------------------------
+//! モデルキャッシュ形式で書き出し
+//---------------------------------------------------------------------------
+bool writeModelCache(std::ostream& stream, const Mesh& mesh, const std::vector<Cluster>& clusters, Codec codec)
+{
+    const auto& varray = mesh.positions_;
+    const auto& iarray = mesh.indices_;
+
+    u32 vertex_count = static_cast<u32>(mesh.vertexCount());   // 頂点数
+    u32 index_count  = static_cast<u32>(iarray.size());        // インデックス数
+
+    write(stream, MODEL_CACHE_VERSION);   // ファイルバージョン
+    write(stream, codec);                 // 格納形式
+    write(stream, vertex_count);
+    write(stream, index_count);
+
+    if(codec == Codec::Meshopt) {
+        // [meshoptimizer] 座標を頂点ごとに指数部を共有した固定小数に量子化
+        // 下位ビットが揃うため、頂点コーデックの圧縮率が上がる
+        std::vector<f32> filtered(varray.size());
+        meshopt_encodeFilterExp(filtered.data(), vertex_count, POSITION_STRIDE, POSITION_BITS, varray.data());
+
+        // [meshoptimizer] 頂点圧縮
+        std::vector<u8> vertex_data(meshopt_encodeVertexBufferBound(vertex_count, POSITION_STRIDE));
+        vertex_data.resize(meshopt_encodeVertexBuffer(
+            vertex_data.data(), vertex_data.size(), filtered.data(), vertex_count, POSITION_STRIDE));
+
+        // [meshoptimizer] インデックス圧縮 (頂点キャッシュ最適化済みのため効果が高い)
+        meshopt_encodeIndexVersion(1);
+        std::vector<u8> index_data(meshopt_encodeIndexBufferBound(iarray.size(), vertex_count));
+        index_data.resize(meshopt_encodeIndexBuffer(index_data.data(), index_data.size(), iarray.data(), iarray.size()));
+
+        if(vertex_data.empty() || index_data.empty()) {
+            return false;
+        }
+
+        write(stream, static_cast<u32>(vertex_data.size()));
+        write(stream, static_cast<u32>(index_data.size()));
+        stream.write(reinterpret_cast<const char*>(vertex_data.data()), vertex_data.size());
+        stream.write(reinterpret_cast<const char*>(index_data.data()), index_data.size());
+    }
+    else {
+        // 頂点配列
+        stream.write(reinterpret_cast<const char*>(varray.data()), vertex_count * POSITION_STRIDE);
+
+        // インデックス配列
+        stream.write(reinterpret_cast<const char*>(iarray.data()), index_count * sizeof(u32));
+    }
+
+    // クラスター
+    u32 cluster_count = static_cast<u32>(clusters.size());
+    write(stream, cluster_count);
+    stream.write(reinterpret_cast<const char*>(clusters.data()), cluster_count * sizeof(Cluster));
+
+    return stream.good();
+}
+
+//---------------------------------------------------------------------------
+//! クック済みファイルのパスを取得
+//---------------------------------------------------------------------------
+std::string cookedPath(std::string_view data_path, std::string_view extension)
+{
+    constexpr std::string_view DATA_DIR = "data/";
+    if(data_path.substr(0, DATA_DIR.size()) == DATA_DIR)
+        data_path.remove_prefix(DATA_DIR.size());
+
+    return std::string(COOKED_DIR) + std::string(data_path) + std::string(extension);
+}
+
+}   // namespace mesh_cook
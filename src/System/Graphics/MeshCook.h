@@ -0,0 +1,115 @@
+﻿//---------------------------------------------------------------------------
+//! @file   MeshCook.h
+//! @brief  メッシュのクック処理 (最適化/クラスター分割/キャッシュ形式での書き出し)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//===========================================================================
+//! メッシュのクック処理
+//! @details モデルキャッシュ作成(ModelCache::save)のうち、DxLibに依存しない処理とファイル形式をまとめています。
+//===========================================================================
+namespace mesh_cook
+{
+
+//! モデルキャッシュのバージョン
+constexpr u32 MODEL_CACHE_VERSION = 5;
+
+//! クック済みファイルの出力フォルダ (data/ 以下と同じ階層で出力します)
+constexpr std::string_view COOKED_DIR = "cooked/";
+
+//! 圧縮時の座標の仮数部ビット数 (指数部は頂点ごとに共有)
+constexpr s32 POSITION_BITS = 20;
+
+//! 頂点/インデックスの格納形式
+enum class Codec : u32
+{
+    Raw,       //!< 非圧縮 (f32x3配列 / 32bitインデックス)
+    Meshopt,   //!< 圧縮 (meshoptimizerの頂点/インデックスコーデック + 座標の量子化)
+};
+
+//! クラスター分割の設定
+constexpr u32 CLUSTER_MAX_VERTICES  = 64;      //!< 1クラスターの最大頂点数
+constexpr u32 CLUSTER_MAX_TRIANGLES = 124;     //!< 1クラスターの最大三角形数 (4の倍数)
+constexpr f32 CLUSTER_CONE_WEIGHT   = 0.25f;   //!< 分割時に法線コーンの狭さを優先する度合い (0.0～1.0)
+
+//! クラスター (キャッシュファイルへそのまま保存するため固定レイアウト)
+struct Cluster
+{
+    f32 center_[3];      //!< 境界球の中心 (モデル空間)
+    f32 radius_;         //!< 境界球の半径
+    f32 cone_apex_[3];   //!< 法線コーンの頂点
+    f32 cone_cutoff_;    //!< 法線コーンの開き cos(角度/2) (1.0の場合は背面カリングしない)
+    f32 cone_axis_[3];   //!< 法線コーンの軸
+    u32 index_offset_;   //!< インデックス配列内の開始位置
+    u32 index_count_;    //!< インデックス数
+};
+static_assert(sizeof(Cluster) == 52, "キャッシュファイルの形式が変わるためサイズを変更しないでください");
+
+//! メッシュ (座標のみの三角形リスト)
+struct Mesh
+{
+    std::vector<f32> positions_;   //!< 頂点座標 (xyzの順に3つで1頂点。DxLib::VECTOR配列と同じ並び)
+    std::vector<u32> indices_;     //!< インデックス配列 (3つで1三角形)
+
+    //! 頂点数を取得
+    size_t vertexCount() const { return positions_.size() / 3; }
+};
+
+//----------------------------------------------------------
+//! @name   変換
+//----------------------------------------------------------
+//@{
+
+//  縮退三角形かどうか (高さが最長辺に対して極端に小さい三角形。大きさには依存しません)
+//! @param  [in]    p0  頂点座標0
+//! @param  [in]    p1  頂点座標1
+//! @param  [in]    p2  頂点座標2
+bool isDegenerate(const f32* p0, const f32* p1, const f32* p2);
+
+//  縮退三角形を除去
+void removeDegenerateTriangles(Mesh& mesh);
+
+//  縮退三角形を除去 (外積の長さの2乗を一括計算済みの場合。simd::triangleCrossLengthsSq()など)
+//! @param  [in]    cross_length_sq     三角形ごとの |(p2-p1)×(p0-p1)|² (三角形数分)
+void removeDegenerateTriangles(Mesh& mesh, const f32* cross_length_sq);
+
+//  重複頂点を結合して未使用の頂点を除去
+void weldVertices(Mesh& mesh);
+
+//  頂点キャッシュ/オーバードロー/頂点フェッチの最適化
+void optimize(Mesh& mesh);
+
+//  クラスター分割
+//! @param  [in]    positions       頂点座標 (各頂点の先頭12byteがxyz)
+//! @param  [in]    vertex_count    頂点数
+//! @param  [in]    stride          頂点のサイズ
+//! @param  [inout] indices         インデックス配列 (クラスターごとに連続するよう並べ替えられます)
+std::vector<Cluster> buildClusters(const f32* positions, size_t vertex_count, size_t stride, std::vector<u32>& indices);
+
+//@}
+//----------------------------------------------------------
+//! @name   書き出し
+//----------------------------------------------------------
+//@{
+
+//  モデルキャッシュ形式で書き出し
+//! @param  [in]    stream      出力先
+//! @param  [in]    mesh        最適化とクラスター分割が済んだメッシュ
+//! @param  [in]    clusters    クラスター配列
+//! @param  [in]    codec       格納形式
+bool writeModelCache(std::ostream& stream, const Mesh& mesh, const std::vector<Cluster>& clusters, Codec codec);
+
+//  クック済みファイルのパスを取得
+//! @param  [in]    data_path   元ファイルのパス ("data/Sample/a.mv1" → "cooked/Sample/a.mv1" + extension)
+//! @param  [in]    extension   付加する拡張子 (".cache" など)
+//! @details ランタイムが作成するキャッシュ(モデルキャッシュ/アニメーションクリップ)はすべてこの階層を使用します
+std::string cookedPath(std::string_view data_path, std::string_view extension);
+
+//@}
+
+}   // namespace mesh_cook
@@ -7,6 +7,10 @@
 #include "ModelCache.h"
 #include "Shader.h"
 #include "Animation.h"
+#include "Frustum.h"
+
+#include <map>
+#include <tuple>
 
 namespace
 {
@@ -14,8 +18,52 @@ namespace
 //! モデルリソースプール
 std::unordered_map<std::string, std::shared_ptr<ResourceModel>> resource_model_pool;
 
+//! 即時描画用の描画キュー (render()/renderByMesh()の作業領域)
+RenderQueue immediate_queue;
+
+//! シェーダーを使わないパケットのシェーダーステート値
+constexpr u64 NO_SHADER = ~0ull;
+
+//! ロード中に代わりに描画するモデルキャッシュのパケットのメッシュ番号
+constexpr s32 PROXY_MESH = -1;
+
+//! マテリアルステート値の登録表 (モデルリソース/マテリアル番号/上書きテクスチャが同じなら同じ値)
+//! @note   解放済みのアドレスが残り続けないよう Model::clearMaterialStates() でフレームごとに破棄します
+std::map<std::tuple<const void*, s32, const Texture*, const Texture*, const Texture*>, u64> material_states;
+
+//! インスタンスキーを作成
+//! @param  [in]    resource    モデルリソース
+//! @param  [in]    sub_mesh    メッシュ番号またはトライアングルリスト番号
+u64 makeInstanceKey(const ResourceModel* resource, s32 sub_mesh)
+{
+    return reinterpret_cast<uintptr_t>(resource) ^ (static_cast<u64>(static_cast<u32>(sub_mesh)) << 48);
+}
+
 }   // namespace
 
+//===========================================================================
+//! 描画キューの実行器 (DxLib)
+//===========================================================================
+class Model::Executor final : public RenderQueue::Executor
+{
+public:
+    void begin() override;
+    void bindShader(const RenderQueue::Packet& packet) override;
+    void bindMaterial(const RenderQueue::Packet& packet) override;
+    void draw(const RenderQueue::Packet& packet, bool object_changed) override;
+    void drawInstanced(const RenderQueue::Packet* const* packets, u32 count) override;
+    void end() override;
+
+private:
+    //  メッシュが視錐台内にあるかどうか
+    bool isVisible(const RenderQueue::Packet& packet) const;
+
+private:
+    Frustum             frustum_;                  //!< 実行開始時のカメラの視錐台
+    bool                matrix_pending_ = false;   //!< ワールド行列の設定を次の描画まで遅らせているかどうか
+    std::vector<matrix> mat_worlds_;               //!< モデルキャッシュをまとめて描画するワールド行列 (作業領域)
+};
+
 //---------------------------------------------------------------------------
 //! 読み込み
 //---------------------------------------------------------------------------
@@ -32,8 +80,9 @@ bool Model::load(std::string_view path)
             resource_model_pool[resource_path] = std::make_shared<ResourceModel>(path);
         }
 
-        // 共有
+        // 共有 (読み込み途中なら先行読み込み中のシーンの進捗にも含める)
         resource_model_ = resource_model_pool[resource_path];
+        GetStreamingManager().join(resource_model_->request());
     }
 
     // 初回のみ読み込み
@@ -51,9 +100,9 @@ bool Model::load(std::string_view path)
         //----------------------------------------------------------
         // デフォルトテクスチャを読み込み
         //----------------------------------------------------------
-        tex_null_white_  = std::make_shared<Texture>("data/System/null_white.dds");
-        tex_null_black_  = std::make_shared<Texture>("data/System/null_black.dds");
-        tex_null_normal_ = std::make_shared<Texture>("data/System/null_normal.dds");
+        tex_null_white_  = LoadTexture("data/System/null_white.dds");
+        tex_null_black_  = LoadTexture("data/System/null_black.dds");
+        tex_null_normal_ = LoadTexture("data/System/null_normal.dds");
     }
     ref_counter_++;
 
@@ -72,117 +121,322 @@ void Model::update([[maybe_unused]] f32 dt)
 //---------------------------------------------------------------------------
 void Model::render(ShaderVs* override_vs, ShaderPs* override_ps)
 {
-    if(!resource_model_->isActive()) {
-        // ロードが終わっていない間は軽量モデルキャッシュ側を描画
-        auto* model_cache = resource_model_->modelCache();
-        model_cache->render(mat_world_);
+    // モデル内のトライアングルリストをステート順に並べ替えて描画
+    immediate_queue.clear();
+    submit(immediate_queue, override_vs, override_ps);
+    immediate_queue.execute(executor());
+}
+
+//---------------------------------------------------------------------------
+//! メッシュ番号指定で描画
+//---------------------------------------------------------------------------
+void Model::renderByMesh(s32 mesh, ShaderVs* override_vs, ShaderPs* override_ps)
+{
+    if(!resource_model_->isActive())
+        return;
 
+    // メッシュ番号が有効範囲外
+    if(MV1GetMeshNum(renderHandle()) <= mesh) {
         return;
     }
 
-    // ロード終了していたらハンドルを複製
-    on_initialize();
+    ShaderVs* vs = override_vs ? override_vs : shader_vs_.get();
+    ShaderPs* ps = override_ps ? override_ps : shader_ps_.get();
 
-    for(s32 mesh = 0; mesh < MV1GetMeshNum(mv1_handle_); ++mesh) {   // モデルに含まれるメッシュの数
-        renderByMesh(mesh, override_vs, override_ps);
-    }
+    immediate_queue.clear();
+    submitMesh(immediate_queue, mesh, 0.0f, vs, ps);
+    immediate_queue.execute(executor());
 }
 
 //---------------------------------------------------------------------------
-//! メッシュ番号指定で描画
+//! 描画キューへ登録
 //---------------------------------------------------------------------------
-void Model::renderByMesh(s32 mesh, ShaderVs* override_vs, ShaderPs* override_ps)
+void Model::submit(RenderQueue& queue, ShaderVs* override_vs, ShaderPs* override_ps)
 {
-    if(!resource_model_->isActive())
-        return;
+    // カメラからの距離 (同じステート内では手前から描画)
+    f32 depth = length(mat_world_.translate() - cast(GetCameraPosition())).x;
 
-    // ロード終了していたらハンドルを複製
-    on_initialize();
+    if(!resource_model_->isActive()) {
+        // 描画しようとしたモデルを優先して読み込む
+        GetStreamingManager().touch(resource_model_->request(), depth);
+
+        // ロードが終わっていない間は軽量モデルキャッシュ側を描画 (同じモデルキャッシュはまとめて描画)
+        RenderQueue::Packet packet;
+        packet.object_         = this;
+        packet.mesh_           = PROXY_MESH;
+        packet.depth_          = depth;
+        packet.world_          = mat_world_;
+        packet.shader_state_   = NO_SHADER;
+        packet.material_state_ = 0;
+        packet.instance_key_   = reinterpret_cast<uintptr_t>(resource_model_->modelCache());
+        queue.submit(packet);
 
-    // メッシュ番号が有効範囲外
-    if(MV1GetMeshNum(mv1_handle_) <= mesh) {
         return;
     }
 
-    // ワールド行列を設定
-    MV1SetMatrix(mv1_handle_, mat_world_);
+    ShaderVs* vs = override_vs ? override_vs : shader_vs_.get();
+    ShaderPs* ps = override_ps ? override_ps : shader_ps_.get();
 
-    // シェーダーを使わない場合はDxLib関数を直接実行
+    for(s32 mesh = 0; mesh < MV1GetMeshNum(renderHandle()); ++mesh) {   // モデルに含まれるメッシュの数
+        submitMesh(queue, mesh, depth, vs, ps);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! メッシュを描画キューへ登録
+//---------------------------------------------------------------------------
+void Model::submitMesh(RenderQueue& queue, s32 mesh, f32 depth, ShaderVs* vs, ShaderPs* ps)
+{
+    RenderQueue::Packet packet;
+    packet.object_ = this;
+    packet.mesh_   = mesh;
+    packet.depth_  = depth;
+    packet.world_  = mat_world_;
+
+    // 個別のハンドルを持たないモデルは共有ハンドルで描画するため、同じモデルリソースの同じ部分をまとめられる
+    int  handle    = renderHandle();
+    bool instanced = mv1_handle_ == -1;
+
+    // シェーダーを使わない場合はDxLib関数でメッシュ単位に描画
     if(!use_shader_) {
-        MV1DrawMesh(mv1_handle_, mesh);
+        packet.shader_state_   = NO_SHADER;
+        packet.material_state_ = 0;
+        packet.instance_key_   = instanced ? makeInstanceKey(resource_model_.get(), mesh) : 0;
+        queue.submit(packet);
         return;
     }
 
+    const auto* diffuse  = overridedTextures_[static_cast<s32>(Model::TextureType::Diffuse)].get();
+    const auto* normal   = overridedTextures_[static_cast<s32>(Model::TextureType::Normal)].get();
+    const auto* specular = overridedTextures_[static_cast<s32>(Model::TextureType::Specular)].get();
+
+    for(s32 t = 0; t < MV1GetMeshTListNum(handle, mesh); ++t) {   // メッシュに含まれるトライアングルリストの数
+
+        // トライアングルリスト番号
+        auto tlist = MV1GetMeshTList(handle, mesh, t);
+
+        // トライアングルリストが使用しているマテリアルのインデックスを取得する
+        auto material_index = MV1GetTriangleListUseMaterial(handle, tlist);
+
+        //--------------------------------------------------
+        // シェーダーバリエーションを選択
+        //--------------------------------------------------
+        // 頂点データタイプ(DX_MV1_VERTEX_TYPE_1FRAME 等)
+        auto vertex_type = MV1GetTriangleListVertexType(handle, tlist);
+
+        u32 variant_vs = vertex_type;   // DXライブラリの頂点タイプをそのままバリエーション番号に
+
+        int handle_vs = vs->variant(variant_vs);
+        int handle_ps = *ps;
+
+        //--------------------------------------------------
+        // トライアングルリストを登録
+        //--------------------------------------------------
+        packet.sub_mesh_       = tlist;
+        packet.material_       = material_index;
+        packet.shader_state_   = (static_cast<u64>(static_cast<u32>(handle_vs)) << 32) | static_cast<u32>(handle_ps);
+        packet.instance_key_   = instanced ? makeInstanceKey(resource_model_.get(), tlist) : 0;
+
+        // テクスチャの上書きが同じモデル同士はマテリアルを共有できる
+        auto material_key      = std::make_tuple(static_cast<const void*>(resource_model_.get()), material_index, diffuse, normal, specular);
+        packet.material_state_ = material_states.try_emplace(material_key, material_states.size() + 1).first->second;
+
+        queue.submit(packet);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 描画キューの実行器を取得
+//---------------------------------------------------------------------------
+RenderQueue::Executor& Model::executor()
+{
+    static Model::Executor executor;
+    return executor;
+}
+
+//---------------------------------------------------------------------------
+//! マテリアルのステート値を破棄
+//---------------------------------------------------------------------------
+void Model::clearMaterialStates()
+{
+    material_states.clear();
+}
+
+//===========================================================================
+//  Model::Executor
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 実行開始
+//---------------------------------------------------------------------------
+void Model::Executor::begin()
+{
+    // 現在のカメラ行列から視錐台を作成 (全パケットで共有)
+    frustum_        = Frustum(cast(GetCameraViewMatrix()), cast(GetCameraProjectionMatrix()));
+    matrix_pending_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! メッシュが視錐台内にあるかどうか
+//---------------------------------------------------------------------------
+bool Model::Executor::isVisible(const RenderQueue::Packet& packet) const
+{
+    auto* model = static_cast<const Model*>(packet.object_);
+
+    // アニメーションで変形するモデルは読み込み時の境界球を使えないためカリングしない
+    if(model->animation_)
+        return true;
+
+    const auto& bounds = model->resource_model_->meshBounds();
+    if(packet.mesh_ < 0 || static_cast<size_t>(packet.mesh_) >= bounds.size())
+        return true;
+
+    return MeshCluster::isVisible(bounds[packet.mesh_], frustum_, packet.world_);
+}
+
+//---------------------------------------------------------------------------
+//! シェーダーを設定
+//---------------------------------------------------------------------------
+void Model::Executor::bindShader(const RenderQueue::Packet& packet)
+{
+    int handle_vs = static_cast<int>(static_cast<u32>(packet.shader_state_ >> 32));
+    int handle_ps = static_cast<int>(static_cast<u32>(packet.shader_state_));
+
+    // シェーダーがない場合はオリジナルシェーダー利用を無効化
+    bool shaderEnable = (handle_vs != -1) && (handle_ps != -1);
+    MV1SetUseOrigShader(shaderEnable);
+
+    // 頂点シェーダー
+    SetUseVertexShader(handle_vs);
+
+    // ピクセルシェーダー
+    SetUsePixelShader(handle_ps);
+}
+
+//---------------------------------------------------------------------------
+//! マテリアルを設定
+//---------------------------------------------------------------------------
+void Model::Executor::bindMaterial(const RenderQueue::Packet& packet)
+{
+    auto* model = static_cast<const Model*>(packet.object_);
+
+    // 前のマテリアルの設定を解除
+    SetUseTextureToShader(0, -1);
+    SetUseTextureToShader(1, -1);
+    SetUseTextureToShader(2, -1);
+
+    if(packet.sub_mesh_ == -1)
+        return;   // シェーダーを使わないメッシュ
+
     //--------------------------------------------------
     // テクスチャ設定の上書き
     //--------------------------------------------------
-    bool override_normalmap = false;
+    const auto& textures           = model->overridedTextures_;
+    bool        override_normalmap = false;
 
-    if(overridedTextures_[static_cast<s32>(Model::TextureType::Diffuse)]) {
-        SetUseTextureToShader(0, *overridedTextures_[static_cast<s32>(Model::TextureType::Diffuse)]);
+    if(textures[static_cast<s32>(Model::TextureType::Diffuse)]) {
+        SetUseTextureToShader(0, *textures[static_cast<s32>(Model::TextureType::Diffuse)]);
     }
-    if(overridedTextures_[static_cast<s32>(Model::TextureType::Normal)]) {
-        SetUseTextureToShader(1, *overridedTextures_[static_cast<s32>(Model::TextureType::Normal)]);
+    if(textures[static_cast<s32>(Model::TextureType::Normal)]) {
+        SetUseTextureToShader(1, *textures[static_cast<s32>(Model::TextureType::Normal)]);
         override_normalmap = true;   // 法線マップを使用
     }
-    if(overridedTextures_[static_cast<s32>(Model::TextureType::Specular)]) {
-        SetUseTextureToShader(2, *overridedTextures_[static_cast<s32>(Model::TextureType::Specular)]);
+    if(textures[static_cast<s32>(Model::TextureType::Specular)]) {
+        SetUseTextureToShader(2, *textures[static_cast<s32>(Model::TextureType::Specular)]);
     }
 
-    //--------------------------------------------------
-    // シェーダーで描画
-    //--------------------------------------------------
+    // 法線マップを使用しているかどうか
+    bool use_normalmap = MV1GetMaterialNormalMapTexture(model->renderHandle(), packet.material_) != -1;
 
-    ShaderVs* vs = override_vs ? override_vs : shader_vs_.get();
-    ShaderPs* ps = override_ps ? override_ps : shader_ps_.get();
+    // 法線マップを使用しない場合はNull法線を登録しておく
+    if(!use_normalmap && !override_normalmap) {
+        SetUseTextureToShader(1, *tex_null_normal_);
+    }
+}
 
-    // オリジナルシェーダーを使用をONにする
-    MV1SetUseOrigShader(true);
+//---------------------------------------------------------------------------
+//! 描画
+//---------------------------------------------------------------------------
+void Model::Executor::draw(const RenderQueue::Packet& packet, bool object_changed)
+{
+    auto* model = static_cast<const Model*>(packet.object_);
 
-    for(s32 t = 0; t < MV1GetMeshTListNum(mv1_handle_, mesh); ++t) {   // メッシュに含まれるトライアングルリストの数
+    // ロード中はモデルキャッシュを描画 (ロード中のハンドルに触れるとブロッキングになるため先に判定)
+    if(packet.mesh_ == PROXY_MESH) {
+        model->resource_model_->modelCache()->render(packet.world_);
+        return;
+    }
 
-        // トライアングルリスト番号
-        auto tlist = MV1GetMeshTList(mv1_handle_, mesh, t);
+    // 視錐台外のメッシュは描画しない (ワールド行列の設定は次に描画するメッシュまで遅らせる)
+    matrix_pending_ |= object_changed;
+    if(!isVisible(packet)) {
+        return;
+    }
 
-        // トライアングルリストが使用しているマテリアルのインデックスを取得する
-        auto material_index = MV1GetTriangleListUseMaterial(mv1_handle_, tlist);
+    int handle = model->renderHandle();
 
-        // 法線マップを使用しているかどうか
-        bool use_normalmap = MV1GetMaterialNormalMapTexture(mv1_handle_, material_index) != -1;
+    // ワールド行列を設定
+    if(matrix_pending_) {
+        MV1SetMatrix(handle, cast(packet.world_));
+        matrix_pending_ = false;
+    }
 
-        // 法線マップを使用しない場合はNull法線を登録しておく
-        if(!use_normalmap && !override_normalmap) {
-            SetUseTextureToShader(1, *tex_null_normal_);
-        }
+    // シェーダーを使わない場合はDxLib関数を直接実行
+    if(packet.sub_mesh_ == -1) {
+        MV1DrawMesh(handle, packet.mesh_);
+        return;
+    }
 
-        //--------------------------------------------------
-        // シェーダーバリエーションを選択
-        //--------------------------------------------------
-        // 頂点データタイプ(DX_MV1_VERTEX_TYPE_1FRAME 等)
-        auto vertex_type = MV1GetTriangleListVertexType(mv1_handle_, tlist);
+    // 描画
+    MV1DrawTriangleList(handle, packet.sub_mesh_);
+}
 
-        u32 variant_vs = vertex_type;   // DXライブラリの頂点タイプをそのままバリエーション番号に
+//---------------------------------------------------------------------------
+//! インスタンス描画
+//---------------------------------------------------------------------------
+void Model::Executor::drawInstanced(const RenderQueue::Packet* const* packets, u32 count)
+{
+    auto* model = static_cast<const Model*>(packets[0]->object_);
 
-        //--------------------------------------------------
-        // トライアングルリストを描画
-        //--------------------------------------------------
-        int handle_vs = vs->variant(variant_vs);
-        int handle_ps = *ps;
+    // 共有ハンドルの行列を差し替えるため(視錐台外で1つも設定しなかった場合も含めて)、次の draw() では設定し直す
+    matrix_pending_ = true;
 
-        // シェーダーがない場合はオリジナルシェーダー利用を無効化
-        bool shaderEnable = (handle_vs != -1) && (handle_ps != -1);
-        MV1SetUseOrigShader(shaderEnable);
+    // ロード中のモデルキャッシュは同じキャッシュの全インスタンスを1回で描画
+    if(packets[0]->mesh_ == PROXY_MESH) {
+        mat_worlds_.clear();
+        for(u32 i = 0; i < count; ++i) {
+            mat_worlds_.push_back(packets[i]->world_);
+        }
+        model->resource_model_->modelCache()->render(mat_worlds_.data(), mat_worlds_.size());
+        return;
+    }
 
-        // 頂点シェーダー
-        SetUseVertexShader(handle_vs);
+    // DxLibにはMV1のインスタンス描画がないため、ステートを設定したまま共有ハンドルの行列だけを差し替えて描画する
+    int handle = model->renderHandle();
 
-        // ピクセルシェーダー
-        SetUsePixelShader(handle_ps);
+    for(u32 i = 0; i < count; ++i) {
+        const auto& packet = *packets[i];
+
+        if(!isVisible(packet)) {
+            continue;
+        }
 
-        // 描画
-        MV1DrawTriangleList(mv1_handle_, tlist);
+        MV1SetMatrix(handle, cast(packet.world_));
+
+        if(packet.sub_mesh_ == -1) {
+            MV1DrawMesh(handle, packet.mesh_);
+        }
+        else {
+            MV1DrawTriangleList(handle, packet.sub_mesh_);
+        }
     }
+}
 
+//---------------------------------------------------------------------------
+//! 実行終了
+//---------------------------------------------------------------------------
+void Model::Executor::end()
+{
     // オリジナルシェーダー使用をOFFにする
     MV1SetUseOrigShader(false);
 
@@ -216,6 +470,17 @@ Model::~Model()
         MV1DeleteModel(mv1_handle_);
     }
 
+    // 読み込み中のモデルリソースを他に誰も使っていない場合はプールから外して読み込みを取り消す
+    // (読み込み済みのリソースはプールに残して再利用する)
+    if(resource_model_ && !resource_model_->isActive() && resource_model_.use_count() == 2) {
+        for(auto it = resource_model_pool.begin(); it != resource_model_pool.end(); ++it) {
+            if(it->second == resource_model_) {
+                resource_model_pool.erase(it);
+                break;
+            }
+        }
+    }
+
     // 一番最後のオブジェクトが解放を担当
     ref_counter_--;
     if(ref_counter_ == 0) {
@@ -274,6 +539,7 @@ matrix Model::worldMatrix() const
 Model::operator int()
 {
     // 強制的にハンドルを複製 (ブロッキングロードに切り替わる)
+    // 以降はこのモデル専用のハンドルで描画するため、インスタンス描画の対象外になる
     on_initialize();
 
     return mv1_handle_;
@@ -321,7 +587,17 @@ void Model::on_initialize()
 
     if(mv1_handle_ == -1) {
         mv1_handle_ = MV1DuplicateModel(*resource_model_);   // ハンドルを複製
+        MV1SetMatrix(mv1_handle_, cast(mat_world_));
     }
 
     need_initialize_ = false;
 }
+
+//---------------------------------------------------------------------------
+//! 描画に使用するMV1ハンドルを取得
+//---------------------------------------------------------------------------
+int Model::renderHandle() const
+{
+    // 複製していない場合はモデルリソースのハンドルを共有する
+    return mv1_handle_ != -1 ? mv1_handle_ : static_cast<int>(*resource_model_);
+}
@@ -76,6 +76,21 @@ public:
     //! @param  [in]    override_ps  上書きするピクセルシェーダー (nullptrで無効化)
     void renderByMesh(s32 mesh_index, ShaderVs* override_vs = nullptr, ShaderPs* override_ps = nullptr);
 
+    //  描画キューへ登録 (描画は RenderQueue::execute() で行われます)
+    //! @param  [in]    queue        描画キュー
+    //! @param  [in]    override_vs  上書きする頂点シェーダー (nullptrで無効化)
+    //! @param  [in]    override_ps  上書きするピクセルシェーダー (nullptrで無効化)
+    //! @note   読み込みが終わっていない間は軽量モデルキャッシュをその場で描画します
+    void submit(RenderQueue& queue, ShaderVs* override_vs = nullptr, ShaderPs* override_ps = nullptr);
+
+    //  描画キューの実行器を取得 (Model::submit() で登録したパケットを描画します)
+    static RenderQueue::Executor& executor();
+
+    //  マテリアルのステート値を破棄 (フレームごとに振り直します)
+    //! @note   ステート値は登録表のアドレスをキーにしているため、Model::submit() で登録したパケットが
+    //!         どの描画キューにも残っていない時点(フレームの描画キューの実行後)に呼び出してください
+    static void clearMaterialStates();
+
     //@}
     //----------------------------------------------------------
     //! @name   設定
@@ -86,7 +101,9 @@ public:
     void setWorldMatrix(const matrix& mat_world)
     {
         mat_world_ = mat_world;
-        MV1SetMatrix(mv1_handle_, cast(mat_world));
+        if(mv1_handle_ != -1) {
+            MV1SetMatrix(mv1_handle_, cast(mat_world));
+        }
     }
 
     //! シェーダーを使うかどうかを設定
@@ -141,12 +158,26 @@ private:
     //@}
 
 private:
+    //! 描画キューの実行器 (DxLib)
+    class Executor;
+
     // 遅延初期化
     void on_initialize();
 
+    // 描画に使用するMV1ハンドルを取得 (複製していない場合は共有ハンドル)
+    int renderHandle() const;
+
+    //  メッシュを描画キューへ登録
+    //! @param  [in]    queue   描画キュー
+    //! @param  [in]    mesh    メッシュ番号
+    //! @param  [in]    depth   カメラからの距離
+    //! @param  [in]    vs      頂点シェーダー
+    //! @param  [in]    ps      ピクセルシェーダー
+    void submitMesh(RenderQueue& queue, s32 mesh, f32 depth, ShaderVs* vs, ShaderPs* ps);
+
 private:
     std::shared_ptr<ResourceModel> resource_model_;                    //!< モデルリソース
-    int                            mv1_handle_ = -1;                   //!< [DxLib] MV1モデルハンドル
+    int                            mv1_handle_ = -1;                   //!< [DxLib] MV1モデルハンドル (複製するまでは-1で共有ハンドルを使用)
     std::wstring                   path_;                              //!< ファイルパス
     bool                           use_shader_ = true;                 //!< シェーダーを使うかどうか
     matrix                         mat_world_  = matrix::identity();   //!< ワールド行列
@@ -4,10 +4,90 @@
 //---------------------------------------------------------------------------
 #include "Model.h"
 #include "ModelCache.h"
+#include "Frustum.h"
+#include <System/VectorMathBatch.h>
 #include <filesystem>
 
 #include <meshoptimizer/src/meshoptimizer.h>
 
+//---------------------------------------------------------------------------
+// [ファイル形式]
+//     MeshCook.cpp を参照してください
+//---------------------------------------------------------------------------
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+//! 範囲ごとに重複しない辺を抽出してラインリストを作成
+//! @param  [in]    indices     インデックス配列 (3つで1三角形)
+//! @param  [in]    ranges      三角形の範囲 (クラスターごとの開始位置と終了位置)
+//! @param  [out]   lines       ラインリストのインデックス配列
+//! @param  [out]   offsets     範囲ごとのラインリストの開始位置 (末尾は総数)
+//! @details 複数の範囲が共有する辺はそれぞれの範囲に格納します。
+//!          範囲は個別にカリングされるため、片方の範囲だけが見えている場合も境界の辺が欠けません
+//---------------------------------------------------------------------------
+void buildUniqueEdges(const std::vector<u32>&                       indices,
+                      const std::vector<std::pair<size_t, size_t>>& ranges,
+                      std::vector<u32>&                             lines,
+                      std::vector<u32>&                             offsets)
+{
+    //! 辺と所属する範囲
+    struct Edge
+    {
+        u64 key_;     //!< (小さい頂点番号, 大きい頂点番号) の64bit値
+        u32 range_;   //!< 範囲の番号
+    };
+
+    std::vector<Edge> edges;
+    for(u32 r = 0; r < ranges.size(); ++r) {
+        for(size_t i = ranges[r].first; i + 2 < ranges[r].second; i += 3) {
+            for(u32 e = 0; e < 3; ++e) {
+                u32 a = indices[i + e];
+                u32 b = indices[i + (e + 1) % 3];
+                edges.push_back({a < b ? (static_cast<u64>(a) << 32) | b : (static_cast<u64>(b) << 32) | a, r});
+            }
+        }
+    }
+
+    // 範囲ごとに並べて、範囲の中で同じ辺を1本にする
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.range_ != b.range_ ? a.range_ < b.range_ : a.key_ < b.key_;
+    });
+    edges.erase(std::unique(edges.begin(),
+                            edges.end(),
+                            [](const Edge& a, const Edge& b) { return a.range_ == b.range_ && a.key_ == b.key_; }),
+                edges.end());
+
+    lines.clear();
+    offsets.clear();
+    lines.reserve(edges.size() * 2);
+    size_t e = 0;
+    for(u32 r = 0; r < ranges.size(); ++r) {
+        offsets.push_back(static_cast<u32>(lines.size()));
+        for(; e < edges.size() && edges[e].range_ == r; ++e) {
+            lines.push_back(static_cast<u32>(edges[e].key_ >> 32));
+            lines.push_back(static_cast<u32>(edges[e].key_));
+        }
+    }
+    offsets.push_back(static_cast<u32>(lines.size()));
+}
+
+//---------------------------------------------------------------------------
+//! ワイヤーフレーム描画用の頂点を作成
+//! @param  [in]    position    座標
+//---------------------------------------------------------------------------
+VERTEX3D makeWireVertex(const VECTOR& position)
+{
+    VERTEX3D v{};
+
+    v.pos = position;
+    v.dif = GetColorU8(255, 255, 0, 255);
+    return v;
+}
+
+}   // namespace
+
 //---------------------------------------------------------------------------
 //! コンストラクタ
 //---------------------------------------------------------------------------
@@ -16,12 +96,8 @@ ModelCache::ModelCache(std::string_view path)
     model_path_ = path;
 
     //　対応するキャッシュファイルのパスを取得
-    {
-        std::array<char, 1024> temporary_path;
-        GetTempPath(static_cast<DWORD>(sizeof(temporary_path)), temporary_path.data());
-
-        model_cache_path_ = std::string(temporary_path.data()) + "BaseProject/" + std::string(path) + ".cache";
-    }
+    //  data/ と同じ階層の cooked/ 以下に置きます (アニメーションクリップのキャッシュと共通)
+    model_cache_path_ = mesh_cook::cookedPath(path, ".cache");
 }
 
 //---------------------------------------------------------------------------
@@ -38,15 +114,22 @@ ModelCache::~ModelCache()
     if(handle_ib_ != -1) {
         DeleteIndexBuffer(handle_ib_);
     }
+
+    // まとめて描画するための頂点バッファとインデックスバッファ
+    if(handle_batch_vb_ != -1) {
+        DeleteVertexBuffer(handle_batch_vb_);
+    }
+    if(handle_batch_ib_ != -1) {
+        DeleteIndexBuffer(handle_batch_ib_);
+    }
 }
 
 //---------------------------------------------------------------------------
 //! モデルキャッシュを保存
 //---------------------------------------------------------------------------
-bool ModelCache::save(int mv1_handle) const
+bool ModelCache::save(int mv1_handle, Codec codec) const
 {
-    std::vector<VECTOR> varray;   // 頂点配列
-    std::vector<u32>    iarray;   // インデックス配列
+    mesh_cook::Mesh mesh;
 
     // 指定のパスにモデルを保存する
     //  MV1SaveModelToMV1FileWithStrLen(handle_, path.data(), path.size(), MV1_SAVETYPE_NORMAL);
@@ -59,134 +142,43 @@ bool ModelCache::save(int mv1_handle) const
         MV1SetupReferenceMesh(mv1_handle, -1, is_transform, true);   // 参照用メッシュのセットアップ
         auto poly_list = MV1GetReferenceMesh(mv1_handle, -1, is_transform, true);   // 参照用メッシュを取得する
 
-        // 頂点インデックス配列を抽出
-        varray.resize(0);
+        // 頂点配列を抽出
+        mesh.positions_.reserve(poly_list.VertexNum * 3);
         for(s32 i = 0; i < poly_list.VertexNum; ++i) {
-            auto vertex = poly_list.Vertexs[i];
+            const auto& position = poly_list.Vertexs[i].Position;
 
-            varray.push_back(vertex.Position);
+            mesh.positions_.push_back(position.x);
+            mesh.positions_.push_back(position.y);
+            mesh.positions_.push_back(position.z);
         }
 
         // インデックス配列を抽出
-        iarray.resize(0);
+        mesh.indices_.reserve(poly_list.PolygonNum * 3);
         for(s32 i = 0; i < poly_list.PolygonNum; ++i) {
-            auto polygon = poly_list.Polygons[i];
-
-            // 縮退三角形を検出したら破棄
-            u32 i0 = polygon.VIndex[0];
-            u32 i1 = polygon.VIndex[1];
-            u32 i2 = polygon.VIndex[2];
-
-            auto v0 = cast(varray[i0]);
-            auto v1 = cast(varray[i1]);
-            auto v2 = cast(varray[i2]);
-            auto c  = cross(v2 - v1, v0 - v1);
-            if(dot(c, c).x < 0.00001f) {
-                continue;
-            }
+            const auto& polygon = poly_list.Polygons[i];
 
-            // 登録
-            iarray.push_back(i0);
-            iarray.push_back(i1);
-            iarray.push_back(i2);
+            mesh.indices_.push_back(polygon.VIndex[0]);
+            mesh.indices_.push_back(polygon.VIndex[1]);
+            mesh.indices_.push_back(polygon.VIndex[2]);
         }
 
         MV1TerminateReferenceMesh(mv1_handle, -1, false, true);   // 参照用メッシュの後始末
     }
 
     //----------------------------------------------------------
-    // 頂点データーをインデックス化
-    //----------------------------------------------------------
-    if constexpr(false) {
-        std::vector<u32> remap(iarray.size());
-
-        // [meshoptimizer] 重複頂点を結合
-        size_t total_vertex_count = meshopt_generateVertexRemap(remap.data(),
-                                                                nullptr,
-                                                                iarray.size(),
-                                                                varray.data(),
-                                                                varray.size(),
-                                                                sizeof(VECTOR));
-
-        // [meshoptimizer] インデックスバッファを結合後の頂点でつけ直す
-        meshopt_remapIndexBuffer(iarray.data(), nullptr, iarray.size(), remap.data());
-
-        // [meshoptimizer] 使用している頂点のみで詰め直す
-        meshopt_remapVertexBuffer(varray.data(), varray.data(), varray.size(), sizeof(VECTOR), remap.data());
-        varray.resize(total_vertex_count);
-    }
-
-    //----------------------------------------------------------
-    // LOD生成
+    // 縮退三角形を破棄して頂点を最適化 (縮退判定の外積は一括計算)
+    // LODは描画で使用していないため作成しない
     //----------------------------------------------------------
-    constexpr u32    LOD_COUNT = 8;
-    std::vector<u32> lods[LOD_COUNT];
-
-    lods[0] = iarray;
-
-    for(size_t i = 1; i < LOD_COUNT; ++i) {
-        auto& lod = lods[i];
-
-        f64    threshold          = pow(0.7, static_cast<f32>(i));
-        size_t target_index_count = static_cast<size_t>(iarray.size() * threshold) / 3 * 3;
-        f32    target_error       = 1e-2f;
-
-        auto& source = lods[0];
-
-        if(source.size() < target_index_count)
-            target_index_count = source.size();
-
-        lod.resize(source.size());
-
-        size_t result_size = meshopt_simplify(lod.data(),
-                                              source.data(),
-                                              source.size(),
-                                              reinterpret_cast<const float*>(varray.data()),
-                                              varray.size(),
-                                              sizeof(VECTOR),
-                                              target_index_count,
-                                              target_error);
-
-        lod.resize(result_size);
-    }
-    // iarray = lods[6];   // LOD6を採用
+    std::vector<f32> cross_length_sq(mesh.indices_.size() / 3);
+    simd::triangleCrossLengthsSq(
+        mesh.positions_.data(), mesh.indices_.data(), cross_length_sq.data(), cross_length_sq.size());
+    mesh_cook::removeDegenerateTriangles(mesh, cross_length_sq.data());
+    mesh_cook::optimize(mesh);
 
     //----------------------------------------------------------
-    // 頂点の最適化
+    // クラスター分割 (インデックスをクラスターごとに連続に並べ替え)
     //----------------------------------------------------------
-    // [meshoptimizer] 頂点キャッシュ最適化
-    meshopt_optimizeVertexCache(iarray.data(), iarray.data(), iarray.size(), varray.size());
-
-    // [meshoptimizer] オーバードロー最適化
-    meshopt_optimizeOverdraw(iarray.data(),
-                             iarray.data(),
-                             iarray.size(),
-                             &varray[0].x,
-                             varray.size(),
-                             sizeof(VECTOR),
-                             1.0f);
-
-    // [meshoptimizer] 頂点フェッチ最適化
-    meshopt_optimizeVertexFetch(varray.data(),
-                                iarray.data(),
-                                iarray.size(),
-                                varray.data(),
-                                varray.size(),
-                                sizeof(VECTOR));
-
-    //----------------------------------------------------------
-    // 縮退三角形の存在チェック
-    //----------------------------------------------------------
-    for(u32 i = 0; i < iarray.size(); i += 3) {
-        auto i0 = iarray[i + 0];
-        auto i1 = iarray[i + 1];
-        auto i2 = iarray[i + 2];
-        auto v0 = cast(varray[i0]);
-        auto v1 = cast(varray[i1]);
-        auto v2 = cast(varray[i2]);
-        auto c  = cross(v2 - v1, v0 - v1);
-        assert(dot(c, c).x > 0.00001f && "縮退ポリゴンが検出されました.");
-    }
+    auto clusters = mesh_cook::buildClusters(mesh.positions_.data(), mesh.vertexCount(), sizeof(f32) * 3, mesh.indices_);
 
     //----------------------------------------------------------
     // ディレクトリを作成
@@ -209,122 +201,229 @@ bool ModelCache::save(int mv1_handle) const
         return false;
     }
 
-    // ファイルバージョン
-    u32 file_version = ModelCache::VERSION;
-    stream.write(reinterpret_cast<char*>(&file_version), sizeof(file_version));
-
-    u32 vertex_count = static_cast<u32>(varray.size());   // 頂点数
-    u32 index_count  = static_cast<u32>(iarray.size());   // インデックス数
-    stream.write(reinterpret_cast<char*>(&vertex_count), sizeof(vertex_count));
-    stream.write(reinterpret_cast<char*>(&index_count), sizeof(index_count));
-
-    // 頂点配列
-    stream.write(reinterpret_cast<char*>(varray.data()), vertex_count * sizeof(VECTOR));
-
-    // インデックス配列
-    stream.write(reinterpret_cast<char*>(iarray.data()), index_count * sizeof(u32));
-
-    return true;
+    return mesh_cook::writeModelCache(stream, mesh, clusters, codec);
 }
 
 //---------------------------------------------------------------------------
 //! モデルキャッシュを読み込み
 //---------------------------------------------------------------------------
 bool ModelCache::load()
+{
+    return read() && upload();
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルを読み込んで展開
+//---------------------------------------------------------------------------
+bool ModelCache::read()
 {
     // ロードされたバイナリー
     std::vector<std::byte> binary;
 
     //----------------------------------------------------------
-    // キャッシュファイルを読み込み
+    // 元のモデルより古いキャッシュは使わない (アーカイブ内などで更新日時が取れない場合は使用)
     //----------------------------------------------------------
     {
-        auto handle = FileRead_fullyLoad_WithStrLen(model_cache_path_.data(), model_cache_path_.size());
-        if(handle == -1) {
+        std::error_code source_error;
+        std::error_code cache_error;
+        auto            source_time = std::filesystem::last_write_time(model_path_, source_error);
+        auto            cache_time  = std::filesystem::last_write_time(model_cache_path_, cache_error);
+        if(cache_error || (!source_error && cache_time < source_time)) {
             return false;
         }
-        auto* p    = FileRead_fullyLoad_getImage(handle);
-        auto  size = FileRead_fullyLoad_getSize(handle);
-
-        binary.resize(size);
-        memcpy(binary.data(), p, size);
+    }
 
-        // 一時領域を解放
-        FileRead_fullyLoad_delete(handle);
+    //----------------------------------------------------------
+    // キャッシュファイルを読み込み
+    // ワーカースレッドから呼ばれるため、DxLibのファイル関数は使わない (キャッシュは cooked/ にありアーカイブ外)
+    //----------------------------------------------------------
+    {
+        std::ifstream stream(model_cache_path_, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+        if(!stream.is_open()) {
+            return false;
+        }
+        binary.resize(static_cast<size_t>(stream.tellg()));
+        stream.seekg(0);
+        if(!stream.read(reinterpret_cast<char*>(binary.data()), binary.size())) {
+            return false;
+        }
     }
 
     //----------------------------------------------------------
     // メモリ領域から取り出し
     //----------------------------------------------------------
     {
-        uintptr_t p = reinterpret_cast<uintptr_t>(binary.data());
-
-        // ファイルバージョン
-        u32 version = *reinterpret_cast<u32*>(p);
-        p += sizeof(u32);
+        const u8* p   = reinterpret_cast<const u8*>(binary.data());
+        const u8* end = p + binary.size();
+
+        // 残りサイズを確認しながら取り出す
+        auto read = [&](void* data, size_t size) {
+            if(static_cast<size_t>(end - p) < size)
+                return false;
+            memcpy(data, p, size);
+            p += size;
+            return true;
+        };
+
+        // キャッシュファイルを破棄
+        auto discard = [&]() {
+            vertices_.clear();
+            indices_.clear();
+            clusters_.clear();
+            edge_offsets_.clear();
+            edge_indices_.clear();
+            edge_index_count_ = 0;
 
-        // ファイルバージョンが異なっていた場合はキャッシュクリア
-        if(version != ModelCache::VERSION) {
             // エラーコードを受け取ると例外を送出しない
             std::error_code error_code;
             std::filesystem::remove(model_cache_path_, error_code);
             return false;
+        };
+
+        // ファイルバージョンが異なっていた場合はキャッシュクリア
+        u32 version = 0;
+        if(!read(&version, sizeof(version)) || version != ModelCache::VERSION) {
+            return discard();
+        }
+
+        Codec codec        = Codec::Raw;
+        u32   vertex_count = 0;
+        u32   index_count  = 0;
+        if(!read(&codec, sizeof(codec)) || !read(&vertex_count, sizeof(vertex_count)) ||
+           !read(&index_count, sizeof(index_count))) {
+            return discard();
+        }
+
+        // 壊れたファイルで巨大な領域を確保しないよう、個数がファイルサイズに収まるかを先に確認する
+        if(index_count % 3 != 0) {
+            return discard();
+        }
+
+        if(codec == Codec::Meshopt) {
+            u32 vertex_data_size = 0;
+            u32 index_data_size  = 0;
+            if(!read(&vertex_data_size, sizeof(vertex_data_size)) || !read(&index_data_size, sizeof(index_data_size)) ||
+               static_cast<size_t>(end - p) < static_cast<size_t>(vertex_data_size) + index_data_size) {
+                return discard();
+            }
+
+            // [meshoptimizer] 頂点は16byteごとに最低2bit、インデックスは1三角形ごとに最低1byteに圧縮される
+            if(static_cast<u64>(vertex_count) * sizeof(VECTOR) > static_cast<u64>(vertex_data_size) * 64 ||
+               index_count / 3 > index_data_size) {
+                return discard();
+            }
+
+            vertices_.resize(vertex_count);
+            indices_.resize(index_count);
+
+            // [meshoptimizer] 頂点を展開して量子化を戻す
+            if(meshopt_decodeVertexBuffer(vertices_.data(), vertex_count, sizeof(VECTOR), p, vertex_data_size) != 0) {
+                return discard();
+            }
+            meshopt_decodeFilterExp(vertices_.data(), vertex_count, sizeof(VECTOR));
+            p += vertex_data_size;
+
+            // [meshoptimizer] インデックスを展開
+            if(meshopt_decodeIndexBuffer(indices_.data(), index_count, sizeof(u32), p, index_data_size) != 0) {
+                return discard();
+            }
+            p += index_data_size;
         }
+        else if(codec == Codec::Raw) {
+            if(static_cast<u64>(end - p) < static_cast<u64>(vertex_count) * sizeof(VECTOR) + static_cast<u64>(index_count) * sizeof(u32)) {
+                return discard();
+            }
 
-        u32 vertex_count = *reinterpret_cast<u32*>(p);
-        u32 index_count  = *reinterpret_cast<u32*>(p + sizeof(u32));
-        p += sizeof(u32) * 2;
+            vertices_.resize(vertex_count);
+            indices_.resize(index_count);
 
-        // 頂点配列
-        vertices_.resize(vertex_count);
-        memcpy(vertices_.data(), reinterpret_cast<void*>(p), sizeof(VECTOR) * vertex_count);
-        p += sizeof(VECTOR) * vertex_count;
+            // 頂点配列
+            if(!read(vertices_.data(), sizeof(VECTOR) * vertex_count)) {
+                return discard();
+            }
 
-        // インデックス配列
-        indices_.resize(index_count);
-        memcpy(indices_.data(), reinterpret_cast<void*>(p), sizeof(u32) * index_count);
-        p += sizeof(u32) * index_count;
+            // インデックス配列
+            if(!read(indices_.data(), sizeof(u32) * index_count)) {
+                return discard();
+            }
+        }
+        else {
+            // 未知の格納形式
+            return discard();
+        }
+
+        // 範囲外の頂点を参照するインデックス
+        for(u32 index : indices_) {
+            if(index >= vertex_count)
+                return discard();
+        }
+
+        // クラスター
+        u32 cluster_count = 0;
+        if(!read(&cluster_count, sizeof(cluster_count)) ||
+           static_cast<size_t>(end - p) < static_cast<size_t>(cluster_count) * sizeof(MeshCluster::Cluster)) {
+            return discard();
+        }
+        std::vector<MeshCluster::Cluster> clusters(cluster_count);
+        read(clusters.data(), cluster_count * sizeof(MeshCluster::Cluster));
+
+        if(!clusters_.assign(std::move(clusters), index_count)) {
+            return discard();
+        }
     }
 
     //----------------------------------------------------------
-    // 頂点バッファとインデックスバッファを作成
+    // ワイヤーフレーム描画用に重複しない辺のみのラインリストを作成する (クラスターの中で1つの辺は1本)
+    // クラスターをまたぐ辺は、どちらのクラスターだけが見えていても描画できるよう両方に格納する
     //----------------------------------------------------------
     {
-        // DXライブラリ形式の頂点データーを一時的に作成
-        std::vector<VERTEX3D> varray;
-        std::vector<u32>      iarray;
-
-        for(DxLib::VECTOR& position : vertices_) {
-            VERTEX3D v{};
-
-            v.pos = position;
-            v.dif = GetColorU8(255, 255, 0, 255);
-
-            varray.emplace_back(std::move(v));
+        std::vector<std::pair<size_t, size_t>> ranges;
+        if(clusters_.isValid()) {
+            for(const auto& cluster : clusters_.clusters()) {
+                ranges.emplace_back(cluster.index_offset_, cluster.index_offset_ + cluster.index_count_);
+            }
         }
-        for(u32 i = 0; i < indices_.size(); i += 3) {
-            u32 a = indices_[i + 0];
-            u32 b = indices_[i + 1];
-            u32 c = indices_[i + 2];
-
-            // ワイヤーフレーム描画にするために三角形abcインデックスを a-b, b-c, c-a という順に接続する
-            iarray.push_back(a);
-            iarray.push_back(b);
-            iarray.push_back(b);
-            iarray.push_back(c);
-            iarray.push_back(c);
-            iarray.push_back(a);
+        else {
+            ranges.emplace_back(0, indices_.size());
         }
+        buildUniqueEdges(indices_, ranges, edge_indices_, edge_offsets_);
+        edge_index_count_ = static_cast<u32>(edge_indices_.size());
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 頂点バッファとインデックスバッファを作成
+//---------------------------------------------------------------------------
+bool ModelCache::upload()
+{
+    if(vertices_.empty() || edge_indices_.empty()) {
+        return false;
+    }
 
-        // 頂点バッファとインデックスバッファを作成
-        handle_vb_ = CreateVertexBuffer(static_cast<s32>(varray.size()), DX_VERTEX_TYPE_NORMAL_3D);
-        handle_ib_ = CreateIndexBuffer(static_cast<s32>(iarray.size()), DX_INDEX_TYPE_32BIT);
+    // 読み込みなおした場合は前のバッファを解放
+    if(handle_vb_ != -1) {
+        DeleteVertexBuffer(handle_vb_);
+    }
+    if(handle_ib_ != -1) {
+        DeleteIndexBuffer(handle_ib_);
+    }
+
+    // DXライブラリ形式の頂点データーを一時的に作成
+    std::vector<VERTEX3D> varray;
 
-        // バッファにデーターを転送
-        SetVertexBufferData(0, varray.data(), static_cast<s32>(varray.size()), handle_vb_);
-        SetIndexBufferData(0, iarray.data(), static_cast<s32>(iarray.size()), handle_ib_);
+    for(DxLib::VECTOR& position : vertices_) {
+        varray.emplace_back(makeWireVertex(position));
     }
 
+    // 頂点バッファとインデックスバッファを作成
+    handle_vb_ = CreateVertexBuffer(static_cast<s32>(varray.size()), DX_VERTEX_TYPE_NORMAL_3D);
+    handle_ib_ = CreateIndexBuffer(static_cast<s32>(edge_indices_.size()), DX_INDEX_TYPE_32BIT);
+
+    // バッファにデーターを転送
+    SetVertexBufferData(0, varray.data(), static_cast<s32>(varray.size()), handle_vb_);
+    SetIndexBufferData(0, edge_indices_.data(), static_cast<s32>(edge_indices_.size()), handle_ib_);
+
     is_valid_ = true;
     return true;
 }
@@ -358,6 +457,14 @@ bool ModelCache::isValid() const
 //---------------------------------------------------------------------------
 void ModelCache::render(const matrix& mat_world) const
 {
+    if(handle_ib_ == -1)
+        return;
+
+    // 現在のカメラ行列から視錐台を作成
+    Frustum frustum(cast(GetCameraViewMatrix()), cast(GetCameraProjectionMatrix()));
+
+    SetUseLighting(false);   // 照明OFF
+
     // ワールド行列を設定
     MATRIX matrix = cast(mat_world);
     SetTransformToWorld(&matrix);
@@ -368,26 +475,187 @@ void ModelCache::render(const matrix& mat_world) const
     //----------------------------------------------------------
     if constexpr(false) {   // デバッグ描画を利用した描画
 
-        for(size_t i = 0; i < indices_.size(); i += 3) {
-            auto i0 = indices_[i + 0];
-            auto i1 = indices_[i + 1];
-            auto i2 = indices_[i + 2];
+        for(size_t t = 0; t < indices_.size(); t += 3) {
+            auto i0 = indices_[t + 0];
+            auto i1 = indices_[t + 1];
+            auto i2 = indices_[t + 2];
 
             DrawTriangle3D(vertices_[i0], vertices_[i1], vertices_[i2], GetColor(255, 255, 0), false);
         }
     }
-    else {   // 頂点バッファを利用した描画
+    else if(!clusters_.isValid()) {   // 頂点バッファを利用した描画
 
-        SetUseLighting(false);   // 照明OFF
         DrawPrimitiveIndexed3D_UseVertexBuffer(handle_vb_, handle_ib_, DX_PRIMTYPE_LINELIST, DX_NONE_GRAPH, false);
-        SetUseLighting(true);
     }
+    else {   // 可視クラスターのみ頂点バッファで描画
+
+        clusters_.cull(frustum, mat_world, visible_ranges_);
+
+        for(const auto& range : visible_ranges_) {
+            auto edges = edgeRange(range);
+            DrawPrimitiveIndexed3D_UseVertexBuffer2(handle_vb_,
+                                                    handle_ib_,
+                                                    DX_PRIMTYPE_LINELIST,
+                                                    0,
+                                                    0,
+                                                    static_cast<s32>(vertices_.size()),
+                                                    static_cast<s32>(edges.index_offset_),
+                                                    static_cast<s32>(edges.index_count_),
+                                                    DX_NONE_GRAPH,
+                                                    false);
+        }
+    }
+
+    SetUseLighting(true);
 
     // 単位行列を設定して元に戻す
     MATRIX mat_identity = MGetIdent();
     SetTransformToWorld(&mat_identity);
 }
 
+//---------------------------------------------------------------------------
+//! 複数のインスタンスをまとめて描画
+//---------------------------------------------------------------------------
+void ModelCache::render(const matrix* mat_worlds, size_t count) const
+{
+    if(count == 0 || handle_ib_ == -1)
+        return;
+
+    // 1インスタンスは頂点バッファのままGPUで変換する
+    if(count == 1) {
+        render(mat_worlds[0]);
+        return;
+    }
+
+    // 現在のカメラ行列から視錐台を作成 (全インスタンスで共有)
+    Frustum frustum(cast(GetCameraViewMatrix()), cast(GetCameraProjectionMatrix()));
+
+    //----------------------------------------------------------
+    // 可視範囲の辺が参照する頂点だけをワールド座標へ変換して1つの頂点配列にまとめる
+    // DxLibにはインスタンス描画がないため、CPUで変換して1回の描画にする
+    //----------------------------------------------------------
+    batch_positions_.clear();
+    batch_indices_.clear();
+
+    // 頂点の変換先の番号 (スタンプが今のインスタンスと同じ頂点のみ有効)
+    if(batch_stamps_.size() != vertices_.size()) {
+        batch_stamps_.assign(vertices_.size(), 0);
+        batch_remap_.resize(vertices_.size());
+        batch_stamp_ = 0;
+    }
+
+    // 辺インデックスの範囲を変換先の番号で追加
+    auto append = [this](u32 offset, u32 count) {
+        for(u32 e = offset; e < offset + count; ++e) {
+            u32 index = edge_indices_[e];
+            if(batch_stamps_[index] != batch_stamp_) {
+                batch_stamps_[index] = batch_stamp_;
+                batch_remap_[index]  = static_cast<u32>(batch_positions_.size());
+                batch_positions_.push_back(vertices_[index]);
+            }
+            batch_indices_.push_back(batch_remap_[index]);
+        }
+    };
+
+    for(size_t i = 0; i < count; ++i) {
+        // スタンプが一周したら全頂点を未使用に戻す
+        if(++batch_stamp_ == 0) {
+            std::fill(batch_stamps_.begin(), batch_stamps_.end(), 0);
+            batch_stamp_ = 1;
+        }
+
+        size_t first = batch_positions_.size();
+        if(clusters_.isValid()) {
+            clusters_.cull(frustum, mat_worlds[i], visible_ranges_);
+            for(const auto& range : visible_ranges_) {
+                auto edges = edgeRange(range);
+                append(edges.index_offset_, edges.index_count_);
+            }
+        }
+        else {
+            append(0, static_cast<u32>(edge_indices_.size()));
+        }
+
+        // このインスタンスで追加した頂点のみ変換 (見えないインスタンスは追加されない)
+        simd::transformPoints(mat_worlds[i],
+                              reinterpret_cast<const f32*>(batch_positions_.data() + first),
+                              reinterpret_cast<f32*>(batch_positions_.data() + first),
+                              batch_positions_.size() - first);
+    }
+
+    if(batch_indices_.empty())
+        return;
+
+    batch_vertices_.clear();
+    for(const auto& position : batch_positions_) {
+        batch_vertices_.emplace_back(makeWireVertex(position));
+    }
+
+    //----------------------------------------------------------
+    // まとめた頂点とインデックスを転送 (足りない場合のみバッファを作り直す)
+    //----------------------------------------------------------
+    if(batch_vertices_.size() > batch_vertex_capacity_) {
+        if(handle_batch_vb_ != -1) {
+            DeleteVertexBuffer(handle_batch_vb_);
+        }
+        batch_vertex_capacity_ = std::max<size_t>(batch_vertices_.size(), batch_vertex_capacity_ * 2);
+        handle_batch_vb_       = CreateVertexBuffer(static_cast<s32>(batch_vertex_capacity_), DX_VERTEX_TYPE_NORMAL_3D);
+    }
+    if(batch_indices_.size() > batch_index_capacity_) {
+        if(handle_batch_ib_ != -1) {
+            DeleteIndexBuffer(handle_batch_ib_);
+        }
+        batch_index_capacity_ = std::max<size_t>(batch_indices_.size(), batch_index_capacity_ * 2);
+        handle_batch_ib_      = CreateIndexBuffer(static_cast<s32>(batch_index_capacity_), DX_INDEX_TYPE_32BIT);
+    }
+    if(handle_batch_vb_ == -1 || handle_batch_ib_ == -1) {
+        batch_vertex_capacity_ = 0;
+        batch_index_capacity_  = 0;
+        return;
+    }
+
+    SetVertexBufferData(0, batch_vertices_.data(), static_cast<s32>(batch_vertices_.size()), handle_batch_vb_);
+    SetIndexBufferData(0, batch_indices_.data(), static_cast<s32>(batch_indices_.size()), handle_batch_ib_);
+
+    //----------------------------------------------------------
+    // 全インスタンスを1回で描画
+    //----------------------------------------------------------
+    SetUseLighting(false);   // 照明OFF
+
+    MATRIX mat_identity = MGetIdent();
+    SetTransformToWorld(&mat_identity);
+
+    DrawPrimitiveIndexed3D_UseVertexBuffer2(handle_batch_vb_,
+                                            handle_batch_ib_,
+                                            DX_PRIMTYPE_LINELIST,
+                                            0,
+                                            0,
+                                            static_cast<s32>(batch_vertices_.size()),
+                                            0,
+                                            static_cast<s32>(batch_indices_.size()),
+                                            DX_NONE_GRAPH,
+                                            false);
+
+    SetUseLighting(true);
+}
+
+//---------------------------------------------------------------------------
+//! 可視範囲を辺インデックスの範囲に変換
+//---------------------------------------------------------------------------
+MeshCluster::Range ModelCache::edgeRange(const MeshCluster::Range& range) const
+{
+    // 結合された範囲の先頭と終端のクラスターを探す (クラスターはインデックス順に並んでいる)
+    const auto& clusters  = clusters_.clusters();
+    auto        by_offset = [](const MeshCluster::Cluster& cluster, u32 offset) { return cluster.index_offset_ < offset; };
+
+    auto first = std::lower_bound(clusters.begin(), clusters.end(), range.index_offset_, by_offset);
+    auto last  = std::lower_bound(first, clusters.end(), range.index_offset_ + range.index_count_, by_offset);
+    u32  begin = edge_offsets_[first - clusters.begin()];
+    u32  end   = edge_offsets_[last - clusters.begin()];
+
+    return {begin, end - begin};
+}
+
 //---------------------------------------------------------------------------
 //!  キャッシュファイルが存在するかチェック
 //---------------------------------------------------------------------------
@@ -4,6 +4,8 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include "MeshCluster.h"
+
 //===========================================================================
 //! 3Dモデルキャッシュ
 //===========================================================================
@@ -11,7 +13,13 @@ class ModelCache
 {
 public:
     //! モデルキャッシュのバージョン
-    static constexpr u32 VERSION = 2;
+    static constexpr u32 VERSION = mesh_cook::MODEL_CACHE_VERSION;
+
+    //! 頂点/インデックスの格納形式
+    using Codec = mesh_cook::Codec;
+
+    //! 圧縮時の座標の仮数部ビット数 (指数部は頂点ごとに共有)
+    static constexpr s32 POSITION_BITS = mesh_cook::POSITION_BITS;
 
     //----------------------------------------------------------
     //! @name   初期化
@@ -26,17 +34,29 @@ public:
     virtual ~ModelCache();
 
     //  モデルキャッシュを保存
-    bool save(int mv1_handle) const;
+    //! @param  [in]    mv1_handle  [DxLib] MV1モデルハンドル
+    //! @param  [in]    codec       格納形式
+    bool save(int mv1_handle, Codec codec = Codec::Meshopt) const;
 
-    //  モデルキャッシュへ読み込み
+    //  モデルキャッシュへ読み込み (read() + upload())
     bool load();
 
+    //  キャッシュファイルを読み込んで展開 (ワーカースレッドから呼び出せます)
+    bool read();
+
+    //  頂点バッファとインデックスバッファを作成 (メインスレッド)
+    //! @note read()が成功している必要があります
+    bool upload();
+
     //! 頂点配列を取得
     const std::vector<VECTOR>& vertices() const;
 
-    //! インデックス配列を取得
+    //! インデックス配列を取得 (クラスターごとに連続した並び)
     const std::vector<u32>& indices() const;
 
+    //! クラスターを取得
+    const MeshCluster& clusters() const { return clusters_; }
+
     // 初期化が正しく成功しているかどうか
     bool isValid() const;
 
@@ -48,20 +68,54 @@ public:
 
     //  描画
     //! @param  [in]    mat_world   ワールド行列
+    //! @note 現在のDxLibのカメラ行列で視錐台/背面カリングし、可視クラスターのみ描画します
     void render(const matrix& mat_world) const;
 
+    //  複数のインスタンスをまとめて描画
+    //! @param  [in]    mat_worlds  ワールド行列の配列
+    //! @param  [in]    count       インスタンス数
+    //! @note 可視クラスターの辺が参照する頂点のみCPUでワールド座標へ変換し、1つの頂点バッファにまとめて1回で描画します
+    void render(const matrix* mat_worlds, size_t count) const;
+
     //  キャッシュファイルが存在するかチェック
     //! @param  [in]    model_path    モデルファイルパス
     bool isExist() const;
 
+    //! キャッシュファイルのパスを取得
+    const std::string& cachePath() const { return model_cache_path_; }
+
+    //! ワイヤーフレーム描画用の辺インデックス数を取得 (クラスターごとに重複しない辺の合計×2)
+    u32 edgeIndexCount() const { return edge_index_count_; }
+
     //@}
 
 private:
-    bool                is_valid_ = false;   //!< 初期化が正しく成功しているかどうか
-    std::string         model_path_;         //!< モデルのファイルパス
-    std::string         model_cache_path_;   //!< モデルキャッシュのファイルパス
-    std::vector<VECTOR> vertices_;           //!< 頂点配列
-    std::vector<u32>    indices_;            //!< インデックス配列
-    int                 handle_vb_ = -1;     //!< [DxLib] 頂点バッファハンドル
-    int                 handle_ib_ = -1;     //!< [DxLib] インデックスバッファハンドル
+    //  可視範囲を辺インデックスの範囲に変換
+    //! @param  [in]    range   三角形インデックスの範囲 (クラスター境界で区切られていること)
+    MeshCluster::Range edgeRange(const MeshCluster::Range& range) const;
+
+private:
+    bool                                    is_valid_ = false;       //!< 初期化が正しく成功しているかどうか
+    std::string                             model_path_;             //!< モデルのファイルパス
+    std::string                             model_cache_path_;       //!< モデルキャッシュのファイルパス
+    std::vector<VECTOR>                     vertices_;               //!< 頂点配列
+    std::vector<u32>                        indices_;                //!< インデックス配列
+    MeshCluster                             clusters_;               //!< クラスター (カリング単位)
+    mutable std::vector<MeshCluster::Range> visible_ranges_;         //!< 描画する可視範囲 (作業領域)
+    std::vector<u32>                        edge_offsets_;           //!< クラスターごとの辺インデックスの開始位置 (末尾は総数)
+    std::vector<u32>                        edge_indices_;           //!< 辺インデックス配列 (まとめて描画する際にも参照)
+    u32                                     edge_index_count_ = 0;   //!< 辺インデックス数
+    int                                     handle_vb_ = -1;         //!< [DxLib] 頂点バッファハンドル
+    int                                     handle_ib_ = -1;         //!< [DxLib] インデックスバッファハンドル
+
+    mutable std::vector<VECTOR>   batch_positions_;             //!< まとめて描画する際の変換後の座標 (作業領域)
+    mutable std::vector<VERTEX3D> batch_vertices_;              //!< まとめて描画する頂点配列 (作業領域)
+    mutable std::vector<u32>      batch_indices_;               //!< まとめて描画する辺インデックス配列 (作業領域)
+    mutable std::vector<u32>      batch_remap_;                 //!< 頂点番号ごとのまとめた頂点配列での番号 (作業領域)
+    mutable std::vector<u32>      batch_stamps_;                //!< 頂点番号ごとのbatch_remap_を設定したスタンプ (作業領域)
+    mutable u32                   batch_stamp_           = 0;   //!< 現在のインスタンスのスタンプ
+    mutable size_t                batch_vertex_capacity_ = 0;   //!< まとめて描画する頂点バッファの容量
+    mutable size_t                batch_index_capacity_  = 0;   //!< まとめて描画するインデックスバッファの容量
+    mutable int                   handle_batch_vb_       = -1;  //!< [DxLib] まとめて描画する頂点バッファハンドル
+    mutable int                   handle_batch_ib_       = -1;  //!< [DxLib] まとめて描画するインデックスバッファハンドル
 };
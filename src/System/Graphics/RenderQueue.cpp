@@ -0,0 +1,208 @@
+﻿//---------------------------------------------------------------------------
+//! @file   RenderQueue.cpp
+//! @brief  描画キュー (ステート順の並べ替え)
+//---------------------------------------------------------------------------
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+//---------------------------------------------------------------------------
+//! パケットを登録
+//---------------------------------------------------------------------------
+void RenderQueue::submit(const Packet& packet)
+{
+    u32 shader   = stateId(shader_ids_, packet.shader_state_);
+    u32 material = stateId(material_ids_, packet.material_state_);
+
+    items_.push_back({makeKey(packet.layer_, shader, material, packet.depth_), static_cast<u32>(packets_.size())});
+    packets_.push_back(packet);
+    is_sorted_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! ソートキー順に並べ替え
+//---------------------------------------------------------------------------
+void RenderQueue::sort()
+{
+    if(is_sorted_)
+        return;
+
+    radixSort(items_, work_);
+    is_sorted_ = true;
+}
+
+//---------------------------------------------------------------------------
+//! 並べ替えて実行
+//---------------------------------------------------------------------------
+RenderQueue::Stats RenderQueue::execute(Executor& executor)
+{
+    Stats stats;
+    if(packets_.empty())
+        return stats;
+
+    sort();
+
+    executor.begin();
+
+    const Packet* last = nullptr;
+    for(size_t begin = 0; begin < items_.size();) {
+        const Packet& head = packets_[items_[begin].index_];
+
+        // ステートが変化したときのみ設定
+        if(!last || last->shader_state_ != head.shader_state_) {
+            executor.bindShader(head);
+            stats.shader_changes_++;
+        }
+        if(!last || last->material_state_ != head.material_state_) {
+            executor.bindMaterial(head);
+            stats.material_changes_++;
+        }
+
+        //----------------------------------------------------------
+        // 同じステートの範囲をインスタンスキー順に並べる (キーの無いパケットは並び順のまま先頭へ)
+        //----------------------------------------------------------
+        batch_.clear();
+        size_t end = begin;
+        for(; end < items_.size(); ++end) {
+            const Packet& packet = packets_[items_[end].index_];
+            if(packet.shader_state_ != head.shader_state_ || packet.material_state_ != head.material_state_)
+                break;
+            batch_.push_back(&packet);
+        }
+
+        auto by_instance = [](const Packet* a, const Packet* b) { return a->instance_key_ < b->instance_key_; };
+        if(!std::is_sorted(batch_.begin(), batch_.end(), by_instance))
+            std::stable_sort(batch_.begin(), batch_.end(), by_instance);
+
+        //----------------------------------------------------------
+        // 描画
+        //----------------------------------------------------------
+        for(size_t i = 0; i < batch_.size();) {
+            // 同じインスタンスキーの範囲
+            size_t count = 1;
+            if(batch_[i]->instance_key_ != 0) {
+                while(i + count < batch_.size() && batch_[i + count]->instance_key_ == batch_[i]->instance_key_)
+                    count++;
+            }
+
+            bool object_changed = !last || last->object_ != batch_[i]->object_;
+            for(size_t n = i; n < i + count; ++n) {
+                if(!last || last->object_ != batch_[n]->object_)
+                    stats.object_changes_++;
+                last = batch_[n];
+            }
+
+            if(count >= 2) {
+                executor.drawInstanced(&batch_[i], static_cast<u32>(count));
+                stats.instance_batches_++;
+                stats.instances_ += static_cast<u32>(count);
+            }
+            else {
+                executor.draw(*batch_[i], object_changed);
+            }
+            i += count;
+        }
+        begin = end;
+    }
+    stats.packets_ = static_cast<u32>(items_.size());
+
+    executor.end();
+
+    return stats;
+}
+
+//---------------------------------------------------------------------------
+//! パケットを全て破棄
+//---------------------------------------------------------------------------
+void RenderQueue::clear()
+{
+    packets_.clear();
+    items_.clear();
+    shader_ids_.clear();
+    material_ids_.clear();
+    is_sorted_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! ソートキーを作成
+//---------------------------------------------------------------------------
+u64 RenderQueue::makeKey(u32 layer, u32 shader, u32 material, f32 depth)
+{
+    // 正の浮動小数点数はビット列のまま比較しても大小関係が保たれるため、上位ビットを深度として使う
+    u32 depth_bits = 0;
+    if(depth > 0.0f) {
+        std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+        depth_bits >>= 31 - DEPTH_BITS;
+    }
+
+    // 番号がビット数を超えた場合は同じ番号にまとまるだけで、描画結果には影響しない
+    u64 key = static_cast<u64>(layer & ((1u << LAYER_BITS) - 1));
+    key     = (key << SHADER_BITS) | (shader & ((1u << SHADER_BITS) - 1));
+    key     = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+    key     = (key << DEPTH_BITS) | (depth_bits & ((1u << DEPTH_BITS) - 1));
+    return key;
+}
+
+//---------------------------------------------------------------------------
+//! 基数ソート
+//---------------------------------------------------------------------------
+void RenderQueue::radixSort(std::vector<SortItem>& items, std::vector<SortItem>& work)
+{
+    constexpr u32 DIGIT_BITS  = 8;
+    constexpr u32 DIGIT_COUNT = 64 / DIGIT_BITS;
+    constexpr u32 BUCKETS     = 1 << DIGIT_BITS;
+
+    if(items.size() <= 1)
+        return;
+
+    //----------------------------------------------------------
+    // 全桁のヒストグラムを1回の走査で作成
+    //----------------------------------------------------------
+    std::vector<u32> histograms(DIGIT_COUNT * BUCKETS, 0);
+    for(const auto& item : items) {
+        for(u32 digit = 0; digit < DIGIT_COUNT; ++digit)
+            histograms[digit * BUCKETS + ((item.key_ >> (digit * DIGIT_BITS)) & (BUCKETS - 1))]++;
+    }
+
+    //----------------------------------------------------------
+    // 下位の桁から安定な分配 (全要素が同じ値の桁は省略)
+    //----------------------------------------------------------
+    work.resize(items.size());
+    for(u32 digit = 0; digit < DIGIT_COUNT; ++digit) {
+        u32  shift     = digit * DIGIT_BITS;
+        u32* histogram = &histograms[digit * BUCKETS];
+
+        if(histogram[(items[0].key_ >> shift) & (BUCKETS - 1)] == items.size())
+            continue;
+
+        // 各値の書き込み開始位置
+        u32 offset = 0;
+        for(u32 i = 0; i < BUCKETS; ++i)
+            offset += std::exchange(histogram[i], offset);
+
+        for(const auto& item : items)
+            work[histogram[(item.key_ >> shift) & (BUCKETS - 1)]++] = item;
+
+        items.swap(work);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! ステート値から番号を取得
+//---------------------------------------------------------------------------
+u32 RenderQueue::stateId(std::unordered_map<u64, u32>& ids, u64 state)
+{
+    auto [it, inserted] = ids.try_emplace(state, static_cast<u32>(ids.size()));
+    return it->second;
+}
+
+//---------------------------------------------------------------------------
+//! フレームの描画キューを取得
+//---------------------------------------------------------------------------
+RenderQueue& GetRenderQueue()
+{
+    static RenderQueue queue;
+    return queue;
+}
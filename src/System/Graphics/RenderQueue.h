@@ -0,0 +1,165 @@
+﻿//---------------------------------------------------------------------------
+//! @file   RenderQueue.h
+//! @brief  描画キュー (ステート順の並べ替え)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+//===========================================================================
+//! 描画キュー
+//! @details 描画要求(パケット)を64bitのソートキーで基数ソートし、シェーダー/マテリアルの切り替えが
+//!          少なくなる順に実行します。パケットのステートは描画APIに依存しない値で持ち、
+//!          実際の描画は実行器(Executor)が行うため、DxLib無しでも並べ替えと実行順を確認できます。
+//!          同じステート内でインスタンスキーが等しいパケットはまとめて実行器へ渡します。
+//!          まとめたパケットを1回の描画にできるかどうかは実行器次第です(Model::Executor は1インスタンスずつ描画します)。
+//!
+//! [ソートキー] (上位から)
+//!     描画レイヤー     :  2bit (小さい順)
+//!     シェーダー番号   : 16bit (登録順に割り当て)
+//!     マテリアル番号   : 24bit (登録順に割り当て)
+//!     深度             : 22bit (手前から奥)
+//===========================================================================
+class RenderQueue
+{
+public:
+    static constexpr u32 LAYER_BITS    = 2;    //!< 描画レイヤーのビット数
+    static constexpr u32 SHADER_BITS   = 16;   //!< シェーダー番号のビット数
+    static constexpr u32 MATERIAL_BITS = 24;   //!< マテリアル番号のビット数
+    static constexpr u32 DEPTH_BITS    = 22;   //!< 深度のビット数
+
+    //! 描画パケット
+    struct Packet
+    {
+        const void* object_         = nullptr;              //!< 描画するオブジェクト (実行器が解釈)
+        s32         mesh_           = -1;                   //!< メッシュ番号
+        s32         sub_mesh_       = -1;                   //!< サブメッシュ番号 (トライアングルリストなど, -1:メッシュ全体)
+        s32         material_       = -1;                   //!< オブジェクト内のマテリアル番号
+        u64         shader_state_   = 0;                    //!< シェーダーのステート値 (同じ値は同じステート)
+        u64         material_state_ = 0;                    //!< マテリアルのステート値 (同じ値は同じステート)
+        u64         instance_key_   = 0;                    //!< インスタンスキー (同じ値はまとめて描画, 0:まとめない)
+        u32         layer_          = 0;                    //!< 描画レイヤー (0～3, 小さい順に描画)
+        f32         depth_          = 0.0f;                 //!< カメラからの距離
+        matrix      world_          = matrix::identity();   //!< ワールド行列
+    };
+
+    //! 実行結果
+    struct Stats
+    {
+        u32 packets_          = 0;   //!< 実行したパケット数
+        u32 shader_changes_   = 0;   //!< シェーダーの切り替え回数
+        u32 material_changes_ = 0;   //!< マテリアルの切り替え回数
+        u32 object_changes_   = 0;   //!< オブジェクトの切り替え回数
+        u32 instance_batches_ = 0;   //!< まとめて描画したグループ数
+        u32 instances_        = 0;   //!< まとめて描画したパケット数
+    };
+
+    //! ソート要素
+    struct SortItem
+    {
+        u64 key_;     //!< ソートキー
+        u32 index_;   //!< パケット番号
+    };
+
+    //===========================================================================
+    //! 実行器
+    //! @details ステートが変化したときのみ bind が呼ばれます
+    //===========================================================================
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+
+        //! 実行開始
+        virtual void begin() {}
+
+        //! シェーダーを設定
+        virtual void bindShader(const Packet& packet) = 0;
+
+        //! マテリアルを設定
+        virtual void bindMaterial(const Packet& packet) = 0;
+
+        //! 描画
+        //! @param  [in]    packet          パケット
+        //! @param  [in]    object_changed  直前のパケットとオブジェクトが異なるかどうか
+        virtual void draw(const Packet& packet, bool object_changed) = 0;
+
+        //! まとめ描画 (インスタンスキーとステートが等しい2つ以上のパケット)
+        //! @param  [in]    packets パケットの配列
+        //! @param  [in]    count   パケット数
+        //! @note   既定では1つずつ draw() を呼びます。描画呼び出しを減らせる実行器のみオーバーライドします
+        virtual void drawInstanced(const Packet* const* packets, u32 count)
+        {
+            for(u32 i = 0; i < count; ++i)
+                draw(*packets[i], i == 0 || packets[i]->object_ != packets[i - 1]->object_);
+        }
+
+        //! 実行終了
+        virtual void end() {}
+    };
+
+    //----------------------------------------------------------
+    //! @name   登録/実行
+    //----------------------------------------------------------
+    //@{
+
+    //  パケットを登録
+    void submit(const Packet& packet);
+
+    //  ソートキー順に並べ替え
+    void sort();
+
+    //  並べ替えて実行 (登録済みのパケットは保持されます)
+    //! @param  [in]    executor    実行器
+    Stats execute(Executor& executor);
+
+    //  パケットを全て破棄
+    void clear();
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //! パケット数を取得
+    size_t size() const { return packets_.size(); }
+
+    //! 並べ替え後の順でパケットを取得 (sort()後に有効)
+    const Packet& sorted(size_t index) const { return packets_[items_[index].index_]; }
+
+    //! 並べ替え後の順でソートキーを取得 (sort()後に有効)
+    u64 sortedKey(size_t index) const { return items_[index].key_; }
+
+    //  ソートキーを作成
+    //! @param  [in]    layer       描画レイヤー
+    //! @param  [in]    shader      シェーダー番号
+    //! @param  [in]    material    マテリアル番号
+    //! @param  [in]    depth       カメラからの距離
+    static u64 makeKey(u32 layer, u32 shader, u32 material, f32 depth);
+
+    //  基数ソート (キーが同じ要素は登録順を保持)
+    //! @param  [inout] items   ソート要素
+    //! @param  [in]    work    作業領域
+    static void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& work);
+
+    //@}
+
+private:
+    //! ステート値から番号を取得 (初出なら割り当て)
+    static u32 stateId(std::unordered_map<u64, u32>& ids, u64 state);
+
+private:
+    std::vector<Packet>          packets_;             //!< 登録順のパケット
+    std::vector<SortItem>        items_;               //!< ソート要素
+    std::vector<SortItem>        work_;                //!< ソート作業領域
+    std::vector<const Packet*>   batch_;               //!< 同じステートのパケット (作業領域)
+    std::unordered_map<u64, u32> shader_ids_;          //!< シェーダーのステート値→番号
+    std::unordered_map<u64, u32> material_ids_;        //!< マテリアルのステート値→番号
+    bool                         is_sorted_ = false;   //!< 並べ替え済みかどうか
+};
+
+//  フレームの描画キューを取得 (Drawで登録し、Draw処理の最後に実行されます)
+//! @note   登録したモデルは描画優先度に関係なくDraw処理の最後に描画されます
+RenderQueue& GetRenderQueue();
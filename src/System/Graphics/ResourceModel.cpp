@@ -5,6 +5,49 @@
 #include "ResourceModel.h"
 #include "ModelCache.h"
 
+namespace
+{
+
+//! MV1モデルのメッシュごとの境界球を作成
+//! @param  [in]    mv1_handle  [DxLib] MV1モデルハンドル (読み込み直後の単位行列の姿勢)
+std::vector<MeshCluster::Cluster> buildMeshBounds(int mv1_handle)
+{
+    std::vector<MeshCluster::Cluster> bounds(MV1GetMeshNum(mv1_handle));
+
+    for(s32 frame = 0; frame < MV1GetFrameNum(mv1_handle); ++frame) {
+        // メッシュの座標はフレームのローカル座標のため、AABBの8頂点をモデル空間へ変換する
+        matrix mat_frame = cast(MV1GetFrameLocalWorldMatrix(mv1_handle, frame));
+
+        for(s32 i = 0; i < MV1GetFrameMeshNum(mv1_handle, frame); ++i) {
+            s32    mesh     = MV1GetFrameMesh(mv1_handle, frame, i);
+            float3 mesh_min = cast(MV1GetMeshMinPosition(mv1_handle, mesh));
+            float3 mesh_max = cast(MV1GetMeshMaxPosition(mv1_handle, mesh));
+            float3 box_min  = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+            float3 box_max  = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for(u32 corner = 0; corner < 8; ++corner) {
+                float3 p = float3(corner & 1 ? mesh_max.x : mesh_min.x,
+                                  corner & 2 ? mesh_max.y : mesh_min.y,
+                                  corner & 4 ? mesh_max.z : mesh_min.z);
+                p        = mul(float4(p, 1.0f), mat_frame).xyz;
+                box_min  = min(box_min, p);
+                box_max  = max(box_max, p);
+            }
+
+            // 法線コーンは使用しない (メッシュ全体が同じ方向を向くことはほぼないため)
+            float3 center        = (box_min + box_max) * 0.5f;
+            auto&  cluster       = bounds[mesh];
+            cluster.center_[0]   = center.x;
+            cluster.center_[1]   = center.y;
+            cluster.center_[2]   = center.z;
+            cluster.radius_      = length(box_max - center).x;
+            cluster.cone_cutoff_ = 1.0f;
+        }
+    }
+    return bounds;
+}
+
+}   // namespace
+
 //---------------------------------------------------------------------------
 //! コンストラクタ
 //---------------------------------------------------------------------------
@@ -17,40 +60,71 @@ ResourceModel::ResourceModel(std::string_view path)
     // パスの保存
     path_ = convertTo(model_path);
 
-    // ハンドルの非同期読み込み処理が完了したら呼ばれる関数
-    auto finish_callback = [](int mv1_handle, void* data) {
-        auto* resource = reinterpret_cast<ResourceModel*>(data);
+    // キャッシュにはリダクションされたワイヤーフレーム表示用の頂点データーが入っています
+    model_cache_ = std::make_unique<ModelCache>(model_path);
+
+    //----------------------------------------------------------
+    // ストリーミングに読み込みを要求
+    //----------------------------------------------------------
+    StreamingManager::Request request;
+    request.name_ = model_path;
+
+    // 読み込み開始
+    request.start_ = [this, model_path]() {
+        // キャッシュファイルはワーカースレッドで展開
+        auto* model_cache = model_cache_.get();
+        cache_read_       = std::async(std::launch::async, [model_cache]() { return model_cache->read(); });
 
+        // モデルの非同期読み込み
+        SetUseASyncLoadFlag(true);
+        mv1_handle_ = MV1LoadModel(model_path.c_str());
+        SetUseASyncLoadFlag(false);
+
+        failed_ = mv1_handle_ == -1;
+        return !failed_;
+    };
+
+    // 読み込み状況
+    request.poll_ = [this]() {
+        // キャッシュの展開が終わったら先に頂点バッファを作成 (ロード中のワイヤーフレーム表示用)
+        if(cache_read_.valid()) {
+            if(cache_read_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return StreamingManager::Poll::Pending;
+            if(cache_read_.get())
+                model_cache_->upload();
+        }
+
+        auto poll = StreamingManager::toPoll(CheckHandleASyncLoad(mv1_handle_));
+        failed_   = poll == StreamingManager::Poll::Failed;
+        return poll;
+    };
+
+    // 読み込み完了まで待つ
+    request.wait_ = [this]() {
+        if(cache_read_.valid() && cache_read_.get())
+            model_cache_->upload();
+        WaitHandleASyncLoad(mv1_handle_);
+    };
+
+    // 仕上げ
+    request.finalize_ = [this]() {
         // ジオメトリのキャッシュファイルが無かったら作成する
-        auto* model_cache = resource->model_cache_.get();
-        if(!model_cache->isExist()) {
-            model_cache->save(mv1_handle);
+        if(!model_cache_->isValid()) {
+            model_cache_->save(mv1_handle_);
 
             // 読み込みなおす
-            model_cache->load();
+            model_cache_->load();
         }
 
+        // メッシュ単位のカリングに使用する境界球
+        mesh_bounds_ = buildMeshBounds(mv1_handle_);
+
         // アクティブフラグを設定
-        resource->active_ = true;
+        active_ = true;
+        return true;
     };
 
-    //----------------------------------------------------------
-    // キャッシュファイルの読み込み
-    // キャッシュにはリダクションされたワイヤーフレーム表示用の頂点データーが入っています
-    //----------------------------------------------------------
-    model_cache_      = std::make_unique<ModelCache>(model_path);
-    bool cache_result = model_cache_->load();
-
-    //----------------------------------------------------------
-    // 非同期読み込み
-    //----------------------------------------------------------
-    SetUseASyncLoadFlag(cache_result);   // キャッシュファイルが無かった場合はブロッキングロードにする
-    {
-        // モデルの読み込み
-        mv1_handle_ = MV1LoadModel(model_path.c_str());
-        SetASyncLoadFinishCallback(mv1_handle_, (void (*)(int, void*))finish_callback, this);
-    }
-    SetUseASyncLoadFlag(false);
+    request_ = GetStreamingManager().request(std::move(request));
 };
 
 //---------------------------------------------------------------------------
@@ -58,7 +132,15 @@ ResourceModel::ResourceModel(std::string_view path)
 //---------------------------------------------------------------------------
 ResourceModel::~ResourceModel()
 {
-    MV1DeleteModel(mv1_handle_);
+    // 読み込み中の場合は取り消す
+    GetStreamingManager().cancel(request_);
+
+    if(cache_read_.valid()) {
+        cache_read_.wait();
+    }
+    if(mv1_handle_ != -1) {
+        MV1DeleteModel(mv1_handle_);
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -67,7 +149,7 @@ ResourceModel::~ResourceModel()
 void ResourceModel::waitForReadFinish()
 {
     if(isActive() == false) {
-        WaitHandleASyncLoad(mv1_handle_);
+        GetStreamingManager().wait(request_);
     }
 }
 
@@ -76,6 +158,9 @@ void ResourceModel::waitForReadFinish()
 //---------------------------------------------------------------------------
 ResourceModel::operator int() const
 {
+    // 読み込み開始前の場合はすぐに開始する (以降のMV1関数は読み込み完了までブロッキングされます)
+    GetStreamingManager().expedite(request_);
+
     return mv1_handle_;
 }
 
@@ -100,7 +185,7 @@ const std::wstring& ResourceModel::path() const
 //---------------------------------------------------------------------------
 bool ResourceModel::isValid() const
 {
-    return mv1_handle_ != -1;
+    return !failed_;
 }
 
 //---------------------------------------------------------------------------
@@ -4,6 +4,10 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <future>
+
+#include "MeshCluster.h"
+
 class ModelCache;   // 3Dモデルキャッシュ
 
 //===========================================================================
@@ -27,6 +31,10 @@ public:
     //! モデルキャッシュを取得
     ModelCache* modelCache() const;
 
+    //! メッシュごとの境界球を取得 (メッシュ番号順 / モデル空間 / 読み込み完了まで空)
+    //! @note   スキニングによる変形は含まないため、アニメーションするモデルのカリングには使えません
+    const std::vector<MeshCluster::Cluster>& meshBounds() const { return mesh_bounds_; }
+
     // ファイルパスを取得
     const std::wstring& path() const;
 
@@ -37,6 +45,9 @@ public:
     //! @note   描画可能になっていない状態でMV1関数を呼ぶとブロッキングされます
     bool isActive() const;
 
+    //! ストリーミングの要求IDを取得
+    StreamingManager::RequestId request() const { return request_; }
+
 private:
     //----------------------------------------------------------
     //! @name   copy/move禁止
@@ -51,8 +62,12 @@ private:
     //@}
 
 private:
-    int                         mv1_handle_ = -1;   //!< [DxLib] MV1モデルハンドル
-    std::wstring                path_;              //!< モデルファイルへのパス
-    std::atomic<bool>           active_ = false;   //!< アクティブ状態 true:利用可能 false:ロード未完了
-    std::unique_ptr<ModelCache> model_cache_;      //!< 3Dモデルキャッシュ
+    int                               mv1_handle_ = -1;   //!< [DxLib] MV1モデルハンドル (読み込み開始まで-1)
+    std::wstring                      path_;              //!< モデルファイルへのパス
+    std::atomic<bool>                 active_ = false;    //!< アクティブ状態 true:利用可能 false:ロード未完了
+    std::atomic<bool>                 failed_ = false;    //!< 読み込みに失敗したかどうか
+    std::unique_ptr<ModelCache>       model_cache_;       //!< 3Dモデルキャッシュ
+    std::vector<MeshCluster::Cluster> mesh_bounds_;       //!< メッシュごとの境界球 (カリング用)
+    std::future<bool>                 cache_read_;        //!< キャッシュファイルの展開 (ワーカースレッド)
+    StreamingManager::RequestId       request_ = 0;       //!< ストリーミングの要求ID
 };
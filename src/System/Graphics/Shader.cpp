@@ -9,6 +9,7 @@
 
 #include "System/FileWatcher.h"
 #include "Shader.h"
+#include "ShaderCache.h"
 
 // DirectX関連のリンク
 #pragma comment(lib, "d3d11.lib")
@@ -26,6 +27,32 @@ std::once_flag once_initialize_;   //!< 初回実行用フラグ
 //! @note 個数が足りなくなった場合は適宜増やす
 std::array<ShaderBase*, 1024> shaders_;
 u32                           shader_count_;   // シェーダー個数
+
+//---------------------------------------------------------------------------
+//! シェーダーバイトコードキャッシュ
+//! @note 静的初期化中のシェーダー作成から呼ばれるため、初回使用時に作成する
+//---------------------------------------------------------------------------
+ShaderCache& shaderCache()
+{
+    static ShaderCache cache([]() {
+        std::array<char, 1024> temporary_path;
+        GetTempPath(static_cast<DWORD>(sizeof(temporary_path)), temporary_path.data());
+
+        return std::filesystem::path(temporary_path.data()) / "BaseProject" / "Shader";
+    }());
+    return cache;
+}
+
+//---------------------------------------------------------------------------
+//! ファイルパスを比較用に正規化 (区切り文字と大文字小文字の差異をなくす)
+//---------------------------------------------------------------------------
+std::wstring normalizePath(const std::filesystem::path& path)
+{
+    auto result = path.lexically_normal().generic_wstring();
+    std::transform(result.begin(), result.end(), result.begin(), reinterpret_cast<wchar_t (*)(wchar_t)>(::tolower));
+    return result;
+}
+
 }   // namespace
 
 //---------------------------------------------------------------------------
@@ -53,35 +80,15 @@ ShaderBase::ShaderBase(std::string_view path, u32 type, u32 variant_count)
     //-----------------------------------------------------------------------
     // ファイル変更時のコールバック関数
     auto file_modified_callback = [](const wchar_t* path) {
-        // ファイルパスの要素を分解
-        wchar_t drive[MAX_PATH];
-        wchar_t dir[MAX_PATH];
-        wchar_t name[MAX_PATH];
-        wchar_t ext[MAX_PATH];
-
-        _wsplitpath_s(path, drive, dir, name, ext);
-
-        // シェーダーソースコードだった場合
-        if(lstrcmpiW(ext, L".fx") == 0) {
-            for(u32 i = 0; i < shader_count_; ++i) {
-                auto& shader        = shaders_[i];
-                auto  shader_path   = shader->path() + L".fx";
-                auto  notified_path = std::wstring(path);
-
-                // 小文字に統一することで大文字小文字の差異をなくす
-                std::transform(shader_path.begin(),
-                               shader_path.end(),
-                               shader_path.begin(),
-                               reinterpret_cast<wchar_t (*)(wchar_t)>(::tolower));
-                std::transform(notified_path.begin(),
-                               notified_path.end(),
-                               notified_path.begin(),
-                               reinterpret_cast<wchar_t (*)(wchar_t)>(::tolower));
-
-                if(shader_path == notified_path) {
-                    // 該当するシェーダーが見つかったら再コンパイル
-                    shader->compile();
-                }
+        auto notified_path = normalizePath(path);
+
+        // 変更されたファイルをソースまたはインクルードしているシェーダーを再コンパイル
+        for(u32 i = 0; i < shader_count_; ++i) {
+            auto& shader       = shaders_[i];
+            auto& dependencies = shader->dependencies();
+
+            if(std::find(dependencies.begin(), dependencies.end(), notified_path) != dependencies.end()) {
+                shader->compile();
             }
         }
     };
@@ -150,21 +157,10 @@ bool ShaderBase::compile()
     //---------------------------------------------------------------------
     // ファイルからソースファイルを読み込み
     //---------------------------------------------------------------------
-    std::vector<std::byte> source;
-    {
-        // ファイルから読み込み
-        std::ifstream file(source_path.c_str(),
-                           std::ios::in | std::ios::binary |
-                               std::ios::ate);   // ateを指定すると最初からファイルポインタが末尾に移動
-        if(!file.is_open()) {
-            return false;
-        }
-        auto size = file.tellg();
-        source.resize(static_cast<size_t>(size));
-
-        file.seekg(0, std::ios::beg);
-        file.read(reinterpret_cast<char*>(source.data()), size);
-        file.close();
+    ShaderCache::Request request;
+    request.source_path_ = source_path;
+    if(!ShaderCache::readFile(request.source_path_, request.source_)) {
+        return false;
     }
 
     //----------------------------------------------------------
@@ -188,56 +184,92 @@ bool ShaderBase::compile()
         "hs_5_0",   // DX_SHADERTYPE_HULL     // ハルシェーダー
     };
 
-    auto compile_shader_variant = [&](u32 index) -> int {
-        // #define SHADER_VARIANT  index の形式でプリプロセッサ定義
-        auto number_string = std::to_string(index);
+    request.target_ = target_names[type_];
+    request.flags_  = compile_flags;
+
+    // キャッシュに無いバリエーションは複数スレッドから同時に呼ばれる
+    // D3DCompileはスレッドセーフだが、DxLibの呼び出しやメッセージ表示はここでは行わない
+    auto compile_shader_variant =
+        [](const ShaderCache::Request& variant_request, u32 index, ShaderCache::Bytes& bytecode, std::string& errors) {
+            // #define SHADER_VARIANT  index の形式でプリプロセッサ定義
+            auto number_string = std::to_string(index);
 
-        const D3D_SHADER_MACRO defines[]{
-            {"SHADER_VARIANT", number_string.c_str()},
-            {         nullptr,               nullptr},
+            std::vector<D3D_SHADER_MACRO> defines;
+            for(auto& [name, value] : variant_request.defines_) {
+                defines.push_back({name.c_str(), value.c_str()});
+            }
+            defines.push_back({"SHADER_VARIANT", number_string.c_str()});
+            defines.push_back({nullptr, nullptr});
+
+            Microsoft::WRL::ComPtr<ID3DBlob> byte_code = nullptr;
+            Microsoft::WRL::ComPtr<ID3DBlob> error_blob;
+
+            auto source_name = variant_request.source_path_.string();
+
+            auto hr = D3DCompile(variant_request.source_.data(),      // [in]  ソースコードのメモリ上のアドレス
+                                 variant_request.source_.size(),      // [in]  ソースコードサイズ
+                                 source_name.c_str(),                 // [in]  ソースコードのファイルパス(使用しない場合はnullptr)
+                                 defines.data(),                      // [in]  プリプロセッサマクロ定義
+                                 D3D_COMPILE_STANDARD_FILE_INCLUDE,   // [in]  カスタムインクルード処理
+                                 variant_request.entry_.c_str(),      // [in]  関数名
+                                 variant_request.target_.c_str(),     // [in]  シェーダーモデル名
+                                 variant_request.flags_,              // [in]  コンパイラフラグ  (D3DCOMPILE_xxxx)
+                                 0,                                   // [in]  コンパイラフラグ2 (D3DCOMPILE_FLAGS2_xxxx)
+                                 &byte_code,                          // [out] コンパイルされたバイトコード
+                                 &error_blob);                        // [out] エラーメッセージ
+
+            if(error_blob != nullptr) {
+                errors = static_cast<const char*>(error_blob->GetBufferPointer());
+            }
+
+            if(FAILED(hr)) {
+                return false;
+            }
+
+            auto* p = static_cast<const std::byte*>(byte_code->GetBufferPointer());
+            bytecode.assign(p, p + byte_code->GetBufferSize());
+            return true;
         };
 
-        Microsoft::WRL::ComPtr<ID3DBlob> byte_code = nullptr;
-        Microsoft::WRL::ComPtr<ID3DBlob> errors;
-
-        auto hr =
-            D3DCompile(source.data(),   // [in]  ソースコードのメモリ上のアドレス
-                       source.size(),   // [in]  ソースコードサイズ
-                       convertTo(source_path).c_str(),   // [in]  ソースコードのファイルパス(使用しない場合はnullptr)
-                       defines,                          // [in]  プリプロセッサマクロ定義
-                       D3D_COMPILE_STANDARD_FILE_INCLUDE,   // [in]  カスタムインクルード処理
-                       "main",                              // [in]  関数名
-                       target_names[type_],                 // [in]  シェーダーモデル名
-                       compile_flags,                       // [in]  コンパイラフラグ  (D3DCOMPILE_xxxx)
-                       0,                                   // [in]  コンパイラフラグ2 (D3DCOMPILE_FLAGS2_xxxx)
-                       &byte_code,                          // [out] コンパイルされたバイトコード
-                       &errors);                            // [out] エラーメッセージ
+    // キャッシュから取得 (キャッシュに無いバリエーションは並列コンパイル)
+    // 依存ファイルはキャッシュキーの計算で収集したものを受け取る
+    std::vector<std::filesystem::path> dependencies;
+    auto results = shaderCache().compile(request, static_cast<u32>(handles_.size()), compile_shader_variant, &dependencies);
+
+    // ホットリロード用にインクルードファイルを記録
+    dependencies_.clear();
+    for(auto& path : dependencies) {
+        dependencies_.push_back(normalizePath(path));
+    }
+
+    //----------------------------------------------------------
+    // シェーダーバリエーションを作成 (メインスレッド)
+    //----------------------------------------------------------
+    for(u32 i = 0; i < handles_.size(); i++) {
+        auto& result = results[i];
 
         // エラー警告出力
-        if(errors != nullptr) {
+        if(!result.errors_.empty()) {
             // 「出力」ウィンドウに表示
             OutputDebugStringA("--------------------\n");
-            OutputDebugStringA((char*)errors->GetBufferPointer());
+            OutputDebugStringA(result.errors_.c_str());
             OutputDebugStringA("--------------------\n");
 
             // メッセージボックス
             auto file_name = convertTo(source_path);
-            MessageBox(DxLib::GetMainWindowHandle(),
-                       static_cast<char*>(errors->GetBufferPointer()),
-                       file_name.c_str(),
-                       MB_ICONWARNING | MB_OK);
+            MessageBox(DxLib::GetMainWindowHandle(), result.errors_.c_str(), file_name.c_str(), MB_ICONWARNING | MB_OK);
         }
 
-        if(FAILED(hr)) {
-            return -1;
+        if(!result.succeeded_) {
+            return false;
         }
 
         //------------------------------------------------------
         // [DxLib] シェーダーを作成
         //------------------------------------------------------
-        const void* shader_ptr = byte_code->GetBufferPointer();   // シェーダーバイナリの先頭アドレス
-        auto shader_size = static_cast<int>(byte_code->GetBufferSize());   // シェーダーバイナリのサイズ
-        int  handle      = -1;
+        const void* shader_ptr  = result.bytecode_.data();                      // シェーダーバイナリの先頭アドレス
+        auto        shader_size = static_cast<int>(result.bytecode_.size());   // シェーダーバイナリのサイズ
+        int         handle      = -1;
 
         switch(type_) {
         case DX_SHADERTYPE_VERTEX:   // 頂点シェーダー
@@ -253,16 +285,6 @@ bool ShaderBase::compile()
             break;
         }
 
-        return handle;
-    };
-
-    //----------------------------------------------------------
-    // シェーダーバリエーションコンパイル
-    //----------------------------------------------------------
-    for(u32 i = 0; i < handles_.size(); i++) {
-        // コンパイル
-        auto handle = compile_shader_variant(i);
-
         // シェーダー作成が成功したら旧シェーダーを解放して置換
         if(handle == -1) {
             return false;
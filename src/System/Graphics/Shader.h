@@ -23,6 +23,7 @@ public:
     ShaderBase(std::string_view path, u32 type, u32 variant_count = 0);
 
     // コンパイル実行
+    //! @note バイトコードキャッシュを利用し、キャッシュに無いバリエーションのみ並列コンパイルします
     bool compile();
 
     //! [DxLib] シェーダーハンドルを取得
@@ -34,13 +35,17 @@ public:
     //! ファイルパスを取得
     const std::wstring& path() const { return path_; }
 
+    //! 依存ファイル一覧を取得 (ソースとインクルードファイル。正規化済みの小文字パス)
+    const std::vector<std::wstring>& dependencies() const { return dependencies_; }
+
     // ファイル監視を更新
     static void updateFileWatcher();
 
 private:
-    std::wstring     path_;        //!< ファイルパス
-    std::vector<int> handles_;     //!< [DxLib] シェーダーハンドル
-    int              type_ = -1;   //!< [DxLib] シェーダーの種類(DX_SHADERTYPE_VERTEXなど)
+    std::wstring              path_;           //!< ファイルパス
+    std::vector<int>          handles_;        //!< [DxLib] シェーダーハンドル
+    std::vector<std::wstring> dependencies_;   //!< 依存ファイル (ホットリロード判定用)
+    int                       type_ = -1;      //!< [DxLib] シェーダーの種類(DX_SHADERTYPE_VERTEXなど)
 };
 
 //===========================================================================
@@ -0,0 +1,419 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ShaderCache.cpp
+//! @brief  シェーダーバイトコードキャッシュ
+//!
+//! [キャッシュファイル形式] (<識別キー16桁>_<キー16桁>.cso)
+//!     u32 バージョン / u64 キー / u32 バイトコードサイズ / バイトコード
+//---------------------------------------------------------------------------
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <execution>
+#include <fstream>
+#include <set>
+
+namespace
+{
+
+//--------------------------------------------------------------
+//! FNV-1a 64bit ハッシュ
+//--------------------------------------------------------------
+class Hash
+{
+public:
+    void add(const void* data, size_t size)
+    {
+        auto* p = static_cast<const u8*>(data);
+        for(size_t i = 0; i < size; ++i) {
+            value_ ^= p[i];
+            value_ *= 0x100000001b3ull;
+        }
+    }
+
+    template <class T>
+    void add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        add(&value, sizeof(T));
+    }
+
+    //! 文字列 (長さを含めて区切りを明確にする)
+    void add(std::string_view string)
+    {
+        add(static_cast<u64>(string.size()));
+        add(string.data(), string.size());
+    }
+
+    u64 value() const { return value_; }
+
+private:
+    u64 value_ = 0xcbf29ce484222325ull;
+};
+
+//--------------------------------------------------------------
+//! バリエーションごとのキーを作成
+//--------------------------------------------------------------
+u64 variantKey(u64 common_key, u32 variant)
+{
+    Hash hash;
+    hash.add(common_key);
+    hash.add(variant);
+    return hash.value();
+}
+
+//--------------------------------------------------------------
+//! #include のファイル名を抽出
+//! @note 行頭の "#include" のみ対象。コメント内の記述も依存に含まれるが、再コンパイルが増えるだけで害はない
+//--------------------------------------------------------------
+std::vector<std::string> findIncludes(const ShaderCache::Bytes& source)
+{
+    std::vector<std::string> result;
+
+    std::string_view text(reinterpret_cast<const char*>(source.data()), source.size());
+
+    size_t line_start = 0;
+    while(line_start < text.size()) {
+        size_t line_end = text.find('\n', line_start);
+        if(line_end == std::string_view::npos)
+            line_end = text.size();
+
+        std::string_view line = text.substr(line_start, line_end - line_start);
+        line_start            = line_end + 1;
+
+        // 空白を読み飛ばす
+        auto skip_space = [&]() {
+            size_t n = line.find_first_not_of(" \t");
+            line.remove_prefix(n == std::string_view::npos ? line.size() : n);
+        };
+
+        skip_space();
+        if(line.empty() || line.front() != '#')
+            continue;
+        line.remove_prefix(1);
+        skip_space();
+
+        constexpr std::string_view INCLUDE = "include";
+        if(line.substr(0, INCLUDE.size()) != INCLUDE)
+            continue;
+        line.remove_prefix(INCLUDE.size());
+        skip_space();
+
+        // "file" または <file>
+        if(line.empty() || (line.front() != '"' && line.front() != '<'))
+            continue;
+        char   close = line.front() == '"' ? '"' : '>';
+        size_t end   = line.find(close, 1);
+        if(end == std::string_view::npos)
+            continue;
+
+        result.emplace_back(line.substr(1, end - 1));
+    }
+    return result;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+ShaderCache::ShaderCache(std::filesystem::path directory, ReadFunc read)
+    : directory_(std::move(directory))
+    , read_(std::move(read))
+{
+}
+
+//---------------------------------------------------------------------------
+//! 全バリエーションのバイトコードを取得
+//---------------------------------------------------------------------------
+std::vector<ShaderCache::Result> ShaderCache::compile(const Request&                      request,
+                                                     u32                                 variant_count,
+                                                     const CompileFunc&                  compiler,
+                                                     std::vector<std::filesystem::path>* dependencies) const
+{
+    std::vector<Result> results(variant_count);
+
+    // 依存ファイルはキーの計算と呼び出し元への返却で共有する
+    auto files = collectDependencies(request.source_path_, request.source_);
+    if(dependencies) {
+        dependencies->clear();
+        for(auto& file : files) {
+            dependencies->push_back(file.path_);
+        }
+    }
+
+    //----------------------------------------------------------
+    // キャッシュから読み込み
+    //----------------------------------------------------------
+    u64              identity = identityKey(request);
+    u64              common   = commonKey(identity, request, files);
+    std::vector<u32> misses;
+    for(u32 i = 0; i < variant_count; ++i) {
+        auto& result = results[i];
+        result.key_  = variantKey(common, i);
+        if(loadCache(identity, result.key_, result.bytecode_)) {
+            result.succeeded_ = true;
+            result.cache_hit_ = true;
+        }
+        else {
+            misses.push_back(i);
+        }
+    }
+
+    if(misses.empty()) {
+        return results;
+    }
+
+    //----------------------------------------------------------
+    // キャッシュに無いバリエーションを並列コンパイル
+    //----------------------------------------------------------
+    {
+        // 保存先を作成 (エラーコードを受け取ると例外を送出しない)
+        std::error_code error_code;
+        std::filesystem::create_directories(directory_, error_code);
+    }
+
+    std::for_each(std::execution::par, misses.begin(), misses.end(), [&](u32 variant) {
+        auto& result      = results[variant];
+        result.succeeded_ = compiler(request, variant, result.bytecode_, result.errors_);
+
+        if(result.succeeded_) {
+            saveCache(identity, result.key_, result.bytecode_);
+        }
+    });
+
+    // ソースが変わって再コンパイルした場合は、以前のソースのバイトコードが残らないよう削除する
+    // (すべてキャッシュから読み込めた場合はディレクトリを走査しない)
+    prune(identity, results);
+
+    return results;
+}
+
+//---------------------------------------------------------------------------
+//! 依存ファイルを収集
+//---------------------------------------------------------------------------
+std::vector<std::filesystem::path> ShaderCache::dependencies(const std::filesystem::path& source_path,
+                                                             const Bytes&                 source) const
+{
+    std::vector<std::filesystem::path> result;
+    for(auto& file : collectDependencies(source_path, source)) {
+        result.push_back(std::move(file.path_));
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------
+//! 依存ファイルを内容と一緒に収集
+//---------------------------------------------------------------------------
+std::vector<ShaderCache::Dependency> ShaderCache::collectDependencies(const std::filesystem::path& source_path,
+                                                                     const Bytes&                 source) const
+{
+    std::vector<Dependency>         result;
+    std::set<std::filesystem::path> visited;
+
+    // 深さ優先でたどる (同じファイルは1回のみ)
+    std::function<void(const std::filesystem::path&, const Bytes&)> visit = [&](const std::filesystem::path& path,
+                                                                                 const Bytes&                 data) {
+        for(auto& name : findIncludes(data)) {
+            // インクルードしたファイルからの相対パス (D3D_COMPILE_STANDARD_FILE_INCLUDEと同じ解決方法)
+            auto include_path = (path.parent_path() / name).lexically_normal();
+            if(!visited.insert(include_path).second)
+                continue;
+
+            Dependency dependency;
+            dependency.path_   = include_path;
+            dependency.exists_ = read_(include_path, dependency.data_);
+            result.push_back(std::move(dependency));
+
+            // 再帰中に配列が再確保されても参照が切れないよう、内容は取り出してからたどる
+            if(result.back().exists_) {
+                Bytes include_data = result.back().data_;
+                visit(include_path, include_data);
+            }
+        }
+    };
+
+    auto normalized = source_path.lexically_normal();
+    visited.insert(normalized);
+    result.push_back({normalized, {}, true});   // ソース自身の内容はRequestに含まれる
+    visit(normalized, source);
+
+    return result;
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュキーを計算
+//---------------------------------------------------------------------------
+u64 ShaderCache::key(const Request& request, u32 variant) const
+{
+    u64 identity = identityKey(request);
+    return variantKey(commonKey(identity, request, collectDependencies(request.source_path_, request.source_)), variant);
+}
+
+//---------------------------------------------------------------------------
+//! シェーダーの識別キーを計算
+//---------------------------------------------------------------------------
+u64 ShaderCache::identityKey(const Request& request) const
+{
+    Hash hash;
+    hash.add(std::string_view(request.source_path_.lexically_normal().generic_string()));   // デバッグ情報に含まれる
+    hash.add(std::string_view(request.entry_));
+    hash.add(std::string_view(request.target_));
+    hash.add(request.flags_);
+
+    hash.add(static_cast<u64>(request.defines_.size()));
+    for(auto& [name, value] : request.defines_) {
+        hash.add(std::string_view(name));
+        hash.add(std::string_view(value));
+    }
+    return hash.value();
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルのパスを取得
+//---------------------------------------------------------------------------
+std::filesystem::path ShaderCache::cachePath(u64 identity, u64 key) const
+{
+    char name[48];
+    std::snprintf(name,
+                  sizeof(name),
+                  "%016llx_%016llx.cso",
+                  static_cast<unsigned long long>(identity),
+                  static_cast<unsigned long long>(key));
+    return directory_ / name;
+}
+
+//---------------------------------------------------------------------------
+//! ファイルを読み込み
+//---------------------------------------------------------------------------
+bool ShaderCache::readFile(const std::filesystem::path& path, Bytes& data)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!file.is_open()) {
+        return false;
+    }
+    auto size = file.tellg();
+    data.resize(static_cast<size_t>(size));
+
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(data.data()), size);
+    return file.good();
+}
+
+//---------------------------------------------------------------------------
+//! バリエーション共通部分のハッシュ
+//---------------------------------------------------------------------------
+u64 ShaderCache::commonKey(u64 identity, const Request& request, const std::vector<Dependency>& files) const
+{
+    Hash hash;
+    hash.add(VERSION);
+    hash.add(identity);
+
+    // ソースコード
+    hash.add(static_cast<u64>(request.source_.size()));
+    hash.add(request.source_.data(), request.source_.size());
+
+    // インクルードファイル (パスと内容。見つからないファイルはパスのみ)
+    for(size_t i = 1; i < files.size(); ++i) {
+        hash.add(std::string_view(files[i].path_.generic_string()));
+        hash.add(files[i].exists_);
+        hash.add(static_cast<u64>(files[i].data_.size()));
+        hash.add(files[i].data_.data(), files[i].data_.size());
+    }
+
+    return hash.value();
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルを読み込み
+//---------------------------------------------------------------------------
+bool ShaderCache::loadCache(u64 identity, u64 key, Bytes& bytecode) const
+{
+    std::ifstream file(cachePath(identity, key), std::ios::in | std::ios::binary);
+    if(!file.is_open()) {
+        return false;
+    }
+
+    u32 version  = 0;
+    u64 file_key = 0;
+    u32 size     = 0;
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&file_key), sizeof(file_key));
+    file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if(!file || version != VERSION || file_key != key || size == 0) {
+        return false;
+    }
+
+    bytecode.resize(size);
+    file.read(reinterpret_cast<char*>(bytecode.data()), size);
+    if(!file) {
+        bytecode.clear();
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルを保存
+//---------------------------------------------------------------------------
+bool ShaderCache::saveCache(u64 identity, u64 key, const Bytes& bytecode) const
+{
+    // 書き込み途中のファイルを読まないよう、一時ファイルに書いてから置き換える
+    auto path      = cachePath(identity, key);
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!file.is_open()) {
+            return false;
+        }
+
+        u32 version = VERSION;
+        u32 size    = static_cast<u32>(bytecode.size());
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(bytecode.data()), size);
+        if(!file.good()) {
+            return false;
+        }
+    }
+
+    std::error_code error_code;
+    std::filesystem::rename(temporary, path, error_code);
+    if(error_code) {
+        std::filesystem::remove(temporary, error_code);
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 同じシェーダーの古いキャッシュファイルを削除
+//---------------------------------------------------------------------------
+void ShaderCache::prune(u64 identity, const std::vector<Result>& results) const
+{
+    // 残すファイル名
+    std::set<std::filesystem::path> current;
+    for(auto& result : results) {
+        current.insert(cachePath(identity, result.key_).filename());
+    }
+
+    // 同じ識別キーで始まるファイル (書き込み途中で残った .tmp を含む) のうち現在のキー以外と、旧形式のファイルを削除
+    auto prefix = cachePath(identity, 0).filename().string().substr(0, 17);   // "<識別キー16桁>_"
+
+    std::error_code error_code;
+    for(auto it = std::filesystem::directory_iterator(directory_, error_code);
+        !error_code && it != std::filesystem::directory_iterator();
+        it.increment(error_code)) {
+        auto name      = it->path().filename();
+        auto file_name = name.string();
+        bool legacy    = file_name.size() == 20 && file_name.find('_') == std::string::npos;   // VERSION 1 の "<キー16桁>.cso"
+        bool stale     = file_name.compare(0, prefix.size(), prefix) == 0 && !current.count(name);
+        if(!legacy && !stale)
+            continue;
+
+        std::error_code remove_error;
+        std::filesystem::remove(it->path(), remove_error);
+    }
+}
@@ -0,0 +1,148 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ShaderCache.h
+//! @brief  シェーダーバイトコードキャッシュ
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+//===========================================================================
+//! シェーダーバイトコードキャッシュ
+//! @details ソースコード・インクルードファイル・マクロ定義・コンパイラフラグの内容から
+//!          ハッシュキーを作り、バリエーションごとのバイトコードをディスクへ保存します。
+//!          キャッシュに無いバリエーションのみ複数スレッドで並列にコンパイルします。
+//!          キャッシュファイル名の先頭にはシェーダーの識別キー (ソースパス・関数名・モデル名・フラグ・マクロ定義)
+//!          を付け、再コンパイルしたときに同じシェーダーの古いバイトコードを削除します。
+//!          コンパイラとファイル読み込みは関数で受け取るため、D3DCompiler無しでも動作します。
+//===========================================================================
+class ShaderCache
+{
+public:
+    //! キャッシュファイルのバージョン (形式を変えたら更新)
+    static constexpr u32 VERSION = 2;
+
+    //! バイト列
+    using Bytes = std::vector<std::byte>;
+
+    //! ファイル読み込み関数
+    //! @param  [in]    path    ファイルパス
+    //! @param  [out]   data    ファイルの内容
+    //! @retval false   ファイルが存在しない
+    using ReadFunc = std::function<bool(const std::filesystem::path& path, Bytes& data)>;
+
+    //! コンパイル要求
+    struct Request
+    {
+        std::filesystem::path                            source_path_;      //!< ソースファイルパス
+        Bytes                                            source_;           //!< ソースコード
+        std::string                                      entry_ = "main";   //!< 関数名
+        std::string                                      target_;           //!< シェーダーモデル名 ("vs_5_0"など)
+        u32                                              flags_ = 0;        //!< コンパイラフラグ
+        std::vector<std::pair<std::string, std::string>> defines_;          //!< 共通のマクロ定義 (名前, 値)
+    };
+
+    //! コンパイル関数
+    //! @param  [in]    request     コンパイル要求
+    //! @param  [in]    variant     バリエーション番号 (SHADER_VARIANT として定義する値)
+    //! @param  [out]   bytecode    バイトコード
+    //! @param  [out]   errors      エラー/警告メッセージ
+    //! @retval true    成功
+    //! @attention 複数スレッドから同時に呼び出されます
+    using CompileFunc =
+        std::function<bool(const Request& request, u32 variant, Bytes& bytecode, std::string& errors)>;
+
+    //! バリエーションごとの結果
+    struct Result
+    {
+        Bytes       bytecode_;            //!< バイトコード
+        std::string errors_;              //!< エラー/警告メッセージ (キャッシュ利用時は空)
+        u64         key_       = 0;       //!< キャッシュキー
+        bool        succeeded_ = false;   //!< 成功したかどうか
+        bool        cache_hit_ = false;   //!< キャッシュから読み込んだかどうか
+    };
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //  コンストラクタ
+    //! @param  [in]    directory   キャッシュファイルの保存先ディレクトリ
+    //! @param  [in]    read        ファイル読み込み関数 (ソースとインクルードファイルの読み込みに使用)
+    ShaderCache(std::filesystem::path directory, ReadFunc read = &ShaderCache::readFile);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   操作
+    //----------------------------------------------------------
+    //@{
+
+    //  全バリエーションのバイトコードを取得 (キャッシュに無いものは並列コンパイル)
+    //! @param  [in]    request         コンパイル要求
+    //! @param  [in]    variant_count   バリエーション数
+    //! @param  [in]    compiler        コンパイル関数
+    //! @param  [out]   dependencies    依存ファイル (nullptrの場合は返さない。dependencies() と同じ内容)
+    //! @return バリエーション番号順の結果
+    std::vector<Result> compile(const Request&                      request,
+                                u32                                 variant_count,
+                                const CompileFunc&                  compiler,
+                                std::vector<std::filesystem::path>* dependencies = nullptr) const;
+
+    //  依存ファイルを収集 (ソースファイル自身と #include を再帰的にたどったファイル)
+    //! @param  [in]    source_path ソースファイルパス
+    //! @param  [in]    source      ソースコード
+    //! @return 正規化したファイルパス (先頭がソースファイル、見つからないファイルも含む)
+    std::vector<std::filesystem::path> dependencies(const std::filesystem::path& source_path, const Bytes& source) const;
+
+    //  キャッシュキーを計算
+    //! @param  [in]    request     コンパイル要求
+    //! @param  [in]    variant     バリエーション番号
+    u64 key(const Request& request, u32 variant) const;
+
+    //  シェーダーの識別キーを計算 (ソースの内容を含まない。古いキャッシュファイルの判別に使用)
+    //! @param  [in]    request     コンパイル要求
+    u64 identityKey(const Request& request) const;
+
+    //  キャッシュファイルのパスを取得
+    //! @param  [in]    identity    シェーダーの識別キー
+    //! @param  [in]    key         キャッシュキー
+    std::filesystem::path cachePath(u64 identity, u64 key) const;
+
+    //  ファイルを読み込み (既定の読み込み関数)
+    static bool readFile(const std::filesystem::path& path, Bytes& data);
+
+    //@}
+
+private:
+    //! 依存ファイル
+    struct Dependency
+    {
+        std::filesystem::path path_;             //!< 正規化したファイルパス
+        Bytes                 data_;             //!< ファイルの内容
+        bool                  exists_ = false;   //!< ファイルが存在したかどうか
+    };
+
+    //! 依存ファイルを内容と一緒に収集 (各ファイルの読み込みは1回のみ)
+    std::vector<Dependency> collectDependencies(const std::filesystem::path& source_path, const Bytes& source) const;
+
+    //! バリエーション共通部分のハッシュ
+    u64 commonKey(u64 identity, const Request& request, const std::vector<Dependency>& files) const;
+
+    //! キャッシュファイルを読み込み
+    bool loadCache(u64 identity, u64 key, Bytes& bytecode) const;
+
+    //! キャッシュファイルを保存
+    bool saveCache(u64 identity, u64 key, const Bytes& bytecode) const;
+
+    //! 同じシェーダーの古いキャッシュファイルを削除
+    //! @param  [in]    identity    シェーダーの識別キー
+    //! @param  [in]    results     現在のバリエーションの結果 (このキーのファイルは残す)
+    void prune(u64 identity, const std::vector<Result>& results) const;
+
+private:
+    std::filesystem::path directory_;   //!< キャッシュファイルの保存先ディレクトリ
+    ReadFunc              read_;        //!< ファイル読み込み関数
+};
@@ -0,0 +1,419 @@
+﻿//---------------------------------------------------------------------------
+//! @file   StreamingManager.cpp
+//! @brief  アセットの非同期ストリーミング
+//---------------------------------------------------------------------------
+#include "StreamingManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+thread_local u32 StreamingManager::scope_group_ = 0;
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+StreamingManager::StreamingManager(ClockFunc clock)
+    : clock_(std::move(clock))
+{
+}
+
+//---------------------------------------------------------------------------
+//! 読み込みを要求
+//---------------------------------------------------------------------------
+StreamingManager::RequestId StreamingManager::request(Request&& request)
+{
+    std::lock_guard lock(mutex_);
+
+    auto entry       = std::make_shared<Entry>();
+    entry->id_       = next_id_++;
+    entry->distance_ = request.distance_;
+    entry->request_  = std::move(request);
+
+    total_.requested_++;
+    addGroup(*entry, entry->request_.group_ ? entry->request_.group_ : scope_group_);
+
+    entries_[entry->id_] = entry;
+    return entry->id_;
+}
+
+//---------------------------------------------------------------------------
+//! 取り消し
+//---------------------------------------------------------------------------
+bool StreamingManager::cancel(RequestId id)
+{
+    EntryPtr entry;
+    {
+        std::lock_guard lock(mutex_);
+
+        auto it = entries_.find(id);
+        if(it == entries_.end())
+            return false;
+        entry = it->second;
+    }
+
+    // 開始済みの場合は読み込み途中のデータを後始末
+    if(entry->state_ != State::Queued && entry->request_.cancel_)
+        entry->request_.cancel_();
+
+    retire(entry, &Progress::cancelled_);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! このフレームで使用されたことを通知
+//---------------------------------------------------------------------------
+void StreamingManager::touch(RequestId id, f32 distance)
+{
+    std::lock_guard lock(mutex_);
+
+    auto it = entries_.find(id);
+    if(it == entries_.end())
+        return;
+
+    auto& entry           = *it->second;
+    entry.touched_        = true;
+    entry.touch_distance_ = std::min(entry.touch_distance_, distance);
+}
+
+//---------------------------------------------------------------------------
+//! 完了していない要求を現在のGroupScopeのグループでも集計
+//---------------------------------------------------------------------------
+void StreamingManager::join(RequestId id)
+{
+    std::lock_guard lock(mutex_);
+
+    auto it = entries_.find(id);
+    if(it == entries_.end())
+        return;   // 完了済み (または無効なID)
+
+    addGroup(*it->second, scope_group_);
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み完了まで待つ
+//---------------------------------------------------------------------------
+void StreamingManager::wait(RequestId id)
+{
+    expedite(id);
+
+    EntryPtr entry;
+    {
+        std::lock_guard lock(mutex_);
+
+        auto it = entries_.find(id);
+        if(it == entries_.end())
+            return;
+        entry = it->second;
+    }
+
+    if(entry->state_ == State::Loading) {
+        if(entry->request_.wait_) {
+            entry->request_.wait_();
+        }
+        else {
+            while(entry->request_.poll_() == Poll::Pending)
+                std::this_thread::yield();
+        }
+
+        if(entry->request_.poll_() == Poll::Failed) {
+            retire(entry, &Progress::failed_);
+            return;
+        }
+        setState(entry, State::Ready);
+    }
+    if(entry->state_ == State::Ready)
+        finalize(entry);
+}
+
+//---------------------------------------------------------------------------
+//! 開始待ちの場合はすぐに開始
+//---------------------------------------------------------------------------
+void StreamingManager::expedite(RequestId id)
+{
+    EntryPtr entry;
+    {
+        std::lock_guard lock(mutex_);
+
+        auto it = entries_.find(id);
+        if(it == entries_.end() || it->second->state_ != State::Queued)
+            return;
+        entry = it->second;
+    }
+    start(entry);
+}
+
+//---------------------------------------------------------------------------
+//! 更新
+//---------------------------------------------------------------------------
+void StreamingManager::update()
+{
+    stats_ = {};
+
+    // 直前のフレームで使用された要求を優先する
+    {
+        std::lock_guard lock(mutex_);
+
+        for(auto& [id, entry] : entries_) {
+            entry->visible_ = entry->touched_;
+            if(entry->touched_)
+                entry->distance_ = entry->touch_distance_;
+            entry->touched_        = false;
+            entry->touch_distance_ = FLT_MAX;
+        }
+    }
+
+    //----------------------------------------------------------
+    // I/Oの確認
+    //----------------------------------------------------------
+    collect(State::Loading, work_);
+    for(auto& entry : work_) {
+        if(entry->state_ != State::Loading)
+            continue;   // 他の要求の処理中に取り消された
+
+        Poll poll = entry->request_.poll_ ? entry->request_.poll_() : Poll::Done;
+        if(poll == Poll::Done)
+            setState(entry, State::Ready);
+        else if(poll == Poll::Failed)
+            retire(entry, &Progress::failed_);
+    }
+
+    //----------------------------------------------------------
+    // 仕上げ処理 (時間予算内, 最低1件)
+    //----------------------------------------------------------
+    collect(State::Ready, work_);
+    f64 begin = clock_();
+    for(auto& entry : work_) {
+        if(stats_.finalized_ > 0 && clock_() - begin >= settings_.finalize_budget_ms_)
+            break;
+        if(entry->state_ != State::Ready)
+            continue;
+
+        finalize(entry);
+        stats_.finalized_++;
+    }
+    stats_.finalize_ms_ = static_cast<f32>(clock_() - begin);
+
+    //----------------------------------------------------------
+    // 読み込み開始 (同時読み込み数の上限まで)
+    //----------------------------------------------------------
+    u32 in_flight = 0;
+    {
+        std::lock_guard lock(mutex_);
+        for(auto& [id, entry] : entries_) {
+            if(entry->state_ != State::Queued)
+                in_flight++;
+        }
+    }
+
+    collect(State::Queued, work_);
+    for(auto& entry : work_) {
+        if(in_flight >= settings_.max_in_flight_)
+            break;
+        if(entry->state_ != State::Queued)
+            continue;
+
+        start(entry);
+        stats_.started_++;
+        if(entry->state_ != State::None)
+            in_flight++;   // 開始に失敗した要求は数えない
+    }
+
+    // 残りの数
+    std::lock_guard lock(mutex_);
+    for(auto& [id, entry] : entries_) {
+        switch(entry->state_) {
+        case State::Queued:
+            stats_.queued_++;
+            break;
+        case State::Loading:
+            stats_.loading_++;
+            break;
+        case State::Ready:
+            stats_.ready_++;
+            break;
+        default:
+            break;
+        }
+    }
+    work_.clear();
+}
+
+//---------------------------------------------------------------------------
+//! 要求の状態を取得
+//---------------------------------------------------------------------------
+StreamingManager::State StreamingManager::state(RequestId id) const
+{
+    std::lock_guard lock(mutex_);
+
+    auto it = entries_.find(id);
+    return it != entries_.end() ? it->second->state_ : State::None;
+}
+
+//---------------------------------------------------------------------------
+//! 進捗を取得
+//---------------------------------------------------------------------------
+StreamingManager::Progress StreamingManager::progress(u32 group) const
+{
+    std::lock_guard lock(mutex_);
+
+    if(group == 0)
+        return total_;
+
+    auto it = groups_.find(group);
+    return it != groups_.end() ? it->second : Progress{};
+}
+
+//---------------------------------------------------------------------------
+//! 進捗を集計するグループを作成
+//---------------------------------------------------------------------------
+u32 StreamingManager::createGroup()
+{
+    std::lock_guard lock(mutex_);
+
+    u32 group      = next_group_++;
+    groups_[group] = {};
+    return group;
+}
+
+//---------------------------------------------------------------------------
+//! グループの集計を破棄
+//---------------------------------------------------------------------------
+void StreamingManager::releaseGroup(u32 group)
+{
+    std::lock_guard lock(mutex_);
+
+    groups_.erase(group);
+}
+
+//---------------------------------------------------------------------------
+//! 現在時刻を取得 (ミリ秒)
+//---------------------------------------------------------------------------
+f64 StreamingManager::now()
+{
+    using namespace std::chrono;
+    return duration<f64, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+//---------------------------------------------------------------------------
+//! [DxLib] 非同期読み込みハンドルの状況をI/Oの状況に変換
+//---------------------------------------------------------------------------
+StreamingManager::Poll StreamingManager::toPoll(int async_state)
+{
+    switch(async_state) {
+    case 1:   // TRUE
+        return Poll::Pending;
+    case 0:   // FALSE
+        return Poll::Done;
+    default:
+        return Poll::Failed;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 優先度の比較
+//---------------------------------------------------------------------------
+bool StreamingManager::higherPriority(const EntryPtr& a, const EntryPtr& b)
+{
+    // 画面に映っているもの → カメラに近いもの → 要求順
+    if(a->visible_ != b->visible_)
+        return a->visible_;
+    if(a->distance_ != b->distance_)
+        return a->distance_ < b->distance_;
+    return a->id_ < b->id_;
+}
+
+//---------------------------------------------------------------------------
+//! 指定の状態の要求を優先度順に列挙
+//---------------------------------------------------------------------------
+void StreamingManager::collect(State state, std::vector<EntryPtr>& out) const
+{
+    out.clear();
+    {
+        std::lock_guard lock(mutex_);
+
+        for(auto& [id, entry] : entries_) {
+            if(entry->state_ == state)
+                out.push_back(entry);
+        }
+    }
+    std::sort(out.begin(), out.end(), &StreamingManager::higherPriority);
+}
+
+//---------------------------------------------------------------------------
+//! 要求を開始
+//---------------------------------------------------------------------------
+void StreamingManager::start(const EntryPtr& entry)
+{
+    // コールバック内で取り消されても参照が残るよう、呼び出し中はロックしない
+    if(entry->request_.start_ && !entry->request_.start_()) {
+        retire(entry, &Progress::failed_);
+        return;
+    }
+    setState(entry, entry->request_.poll_ ? State::Loading : State::Ready);
+}
+
+//---------------------------------------------------------------------------
+//! 仕上げ処理を実行して完了させる
+//---------------------------------------------------------------------------
+void StreamingManager::finalize(const EntryPtr& entry)
+{
+    bool ok = !entry->request_.finalize_ || entry->request_.finalize_();
+    retire(entry, ok ? &Progress::completed_ : &Progress::failed_);
+}
+
+//---------------------------------------------------------------------------
+//! 進捗を集計するグループに追加
+//---------------------------------------------------------------------------
+void StreamingManager::addGroup(Entry& entry, u32 group)
+{
+    auto it = groups_.find(group);
+    if(it == groups_.end())
+        return;
+    if(std::find(entry.groups_.begin(), entry.groups_.end(), group) != entry.groups_.end())
+        return;   // 同じグループで二重に数えない
+
+    entry.groups_.push_back(group);
+    it->second.requested_++;
+}
+
+//---------------------------------------------------------------------------
+//! 状態を変更
+//---------------------------------------------------------------------------
+void StreamingManager::setState(const EntryPtr& entry, State state)
+{
+    std::lock_guard lock(mutex_);
+
+    // 取り消し済みの要求はそのまま
+    if(entry->state_ != State::None)
+        entry->state_ = state;
+}
+
+//---------------------------------------------------------------------------
+//! 要求を終了してリストから外す
+//---------------------------------------------------------------------------
+void StreamingManager::retire(const EntryPtr& entry, u32 Progress::*counter)
+{
+    std::lock_guard lock(mutex_);
+
+    // 既に外れている (コールバック内で取り消された)
+    if(entries_.erase(entry->id_) == 0)
+        return;
+
+    entry->state_ = State::None;
+    total_.*counter += 1;
+    for(u32 group : entry->groups_) {
+        if(auto it = groups_.find(group); it != groups_.end())
+            it->second.*counter += 1;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 共有ストリーミングを取得
+//---------------------------------------------------------------------------
+StreamingManager& GetStreamingManager()
+{
+    // 終了時に解放されるリソースのデストラクタから取り消されるため、あえて解放しない
+    static StreamingManager* manager = new StreamingManager();
+    return *manager;
+}
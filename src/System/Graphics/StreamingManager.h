@@ -0,0 +1,264 @@
+﻿//---------------------------------------------------------------------------
+//! @file   StreamingManager.h
+//! @brief  アセットの非同期ストリーミング
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//===========================================================================
+//! アセットの非同期ストリーミング
+//! @details 読み込み要求を1か所に集め、優先度順(画面に映っているもの → カメラに近いもの → 要求順)に
+//!          同時読み込み数の上限まで開始します。I/Oが終わった要求は、メインスレッドでの仕上げ処理
+//!          (ハンドルの後処理やキャッシュ作成)を1フレームあたりの時間予算内で実行します。
+//!          読み込みの各段階は関数で差し替えられるため、DxLib無しでも方針を確認できます。
+//!
+//!          [状態遷移] Queued → Loading → Ready → (完了してリストから外れる)
+//!                     どの段階でも cancel() で取り消せます
+//!
+//!          request()/touch()/progress() はどのスレッドからも呼び出せます。
+//!          update()/cancel()/wait() はメインスレッドから呼び出してください。
+//===========================================================================
+class StreamingManager
+{
+public:
+    //! 要求ID (0は無効)
+    using RequestId = u64;
+
+    //! I/Oの状況
+    enum class Poll
+    {
+        Pending,   //!< 読み込み中
+        Done,      //!< 完了
+        Failed,    //!< 失敗
+    };
+
+    //! 要求の状態
+    enum class State
+    {
+        None,      //!< 管理外 (完了/失敗/取り消し済み、または無効なID)
+        Queued,    //!< 開始待ち
+        Loading,   //!< 読み込み中
+        Ready,     //!< 仕上げ待ち
+    };
+
+    //! 読み込み要求
+    struct Request
+    {
+        std::string           name_;                 //!< 名前 (ファイルパスなど)
+        std::function<bool()> start_;                //!< 読み込み開始 (false:失敗)
+        std::function<Poll()> poll_;                 //!< I/Oの状況 (未設定なら開始直後に完了)
+        std::function<void()> wait_;                 //!< I/Oの完了まで待つ (未設定ならpoll_を繰り返す)
+        std::function<bool()> finalize_;             //!< メインスレッドでの仕上げ (false:失敗)
+        std::function<void()> cancel_;               //!< 開始後に取り消された場合の後始末
+        f32                   distance_ = FLT_MAX;   //!< カメラからの距離の初期値 (touch()されるまで使用)
+        u32                   group_    = 0;         //!< 進捗を集計するグループ (0:GroupScopeのグループ)
+    };
+
+    //! 設定
+    struct Settings
+    {
+        u32 max_in_flight_      = 8;      //!< 同時に読み込む要求数の上限 (仕上げ待ちを含む)
+        f32 finalize_budget_ms_ = 2.0f;   //!< 1フレームあたりの仕上げ処理の時間予算 (最低1件は実行)
+    };
+
+    //! 進捗
+    struct Progress
+    {
+        u32 requested_ = 0;   //!< 要求数
+        u32 completed_ = 0;   //!< 完了数
+        u32 failed_    = 0;   //!< 失敗数
+        u32 cancelled_ = 0;   //!< 取り消し数
+
+        //! 終了した要求の割合 (0.0～1.0)
+        f32 ratio() const
+        {
+            return requested_ ? static_cast<f32>(completed_ + failed_ + cancelled_) / requested_ : 1.0f;
+        }
+
+        //! 全ての要求が終了したかどうか
+        bool isDone() const { return completed_ + failed_ + cancelled_ == requested_; }
+    };
+
+    //! 統計情報 (直前のフレーム)
+    struct Stats
+    {
+        u32 queued_      = 0;      //!< 開始待ちの数
+        u32 loading_     = 0;      //!< 読み込み中の数
+        u32 ready_       = 0;      //!< 仕上げ待ちの数
+        u32 started_     = 0;      //!< 開始した数
+        u32 finalized_   = 0;      //!< 仕上げた数
+        f32 finalize_ms_ = 0.0f;   //!< 仕上げ処理にかかった時間 (ミリ秒)
+    };
+
+    //! 時刻取得関数 (ミリ秒)
+    using ClockFunc = std::function<f64()>;
+
+    //! スコープ内で要求/共有した読み込みを指定のグループで集計する (シーンの先行読み込み用)
+    class GroupScope
+    {
+    public:
+        //! @param  [in]    group   グループ
+        GroupScope(u32 group)
+            : previous_(scope_group_)
+        {
+            scope_group_ = group;
+        }
+
+        ~GroupScope() { scope_group_ = previous_; }
+
+    private:
+        u32 previous_;   //!< 直前のグループ
+    };
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //  コンストラクタ
+    //! @param  [in]    clock   時刻取得関数
+    StreamingManager(ClockFunc clock = &StreamingManager::now);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   要求
+    //----------------------------------------------------------
+    //@{
+
+    //  読み込みを要求
+    //! @param  [in]    request 読み込み要求
+    //! @return 要求ID
+    RequestId request(Request&& request);
+
+    //  取り消し (開始済みの場合は Request::cancel_ を呼び出します)
+    //! @param  [in]    id      要求ID
+    //! @retval true    取り消した (既に完了していた場合はfalse)
+    bool cancel(RequestId id);
+
+    //  このフレームで使用されたことを通知 (次のupdate()で画面に映っているものとして優先されます)
+    //! @param  [in]    id          要求ID
+    //! @param  [in]    distance    カメラからの距離
+    void touch(RequestId id, f32 distance);
+
+    //  完了していない要求を、現在のGroupScopeのグループでも集計 (共有リソースを再利用した場合に呼び出します)
+    //! @param  [in]    id      要求ID
+    void join(RequestId id);
+
+    //  読み込み完了まで待つ (開始待ちの場合は上限を無視して開始し、仕上げまで実行します)
+    //! @param  [in]    id      要求ID
+    void wait(RequestId id);
+
+    //  開始待ちの場合は上限を無視してすぐに開始
+    //! @param  [in]    id      要求ID
+    void expedite(RequestId id);
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   更新
+    //----------------------------------------------------------
+    //@{
+
+    //  I/Oの確認、仕上げ処理、読み込み開始 (毎フレーム呼び出し)
+    void update();
+
+    //  設定を変更
+    void setSettings(const Settings& settings) { settings_ = settings; }
+
+    //! 設定を取得
+    const Settings& settings() const { return settings_; }
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //  要求の状態を取得
+    //! @param  [in]    id      要求ID
+    State state(RequestId id) const;
+
+    //  進捗を取得
+    //! @param  [in]    group   グループ (0:全体)
+    Progress progress(u32 group = 0) const;
+
+    //  進捗を集計するグループを作成
+    u32 createGroup();
+
+    //  グループの集計を破棄
+    //! @param  [in]    group   グループ
+    void releaseGroup(u32 group);
+
+    //! 統計情報を取得
+    const Stats& stats() const { return stats_; }
+
+    //  現在時刻を取得 (ミリ秒)
+    static f64 now();
+
+    //  [DxLib] 非同期読み込みハンドルの状況をI/Oの状況に変換
+    //! @param  [in]    async_state CheckHandleASyncLoad() の戻り値 (TRUE:読み込み中 FALSE:完了 -1:エラー)
+    //! @note   DxLibに依存しないよう、ハンドルの確認は呼び出し側で行います
+    static Poll toPoll(int async_state);
+
+    //@}
+
+private:
+    //! 管理中の要求
+    struct Entry
+    {
+        RequestId        id_             = 0;               //!< 要求ID
+        Request          request_;                          //!< 読み込み要求
+        State            state_          = State::Queued;   //!< 状態
+        bool             visible_        = false;           //!< 直前のフレームで使用されたかどうか
+        f32              distance_       = FLT_MAX;         //!< カメラからの距離
+        bool             touched_        = false;           //!< このフレームで使用されたかどうか
+        f32              touch_distance_ = FLT_MAX;         //!< このフレームで使用されたときの最短距離
+        std::vector<u32> groups_;                           //!< 進捗を集計するグループ
+    };
+    using EntryPtr = std::shared_ptr<Entry>;
+
+    //! 優先度の比較 (先に処理するものが前)
+    static bool higherPriority(const EntryPtr& a, const EntryPtr& b);
+
+    //! 指定の状態の要求を優先度順に列挙
+    void collect(State state, std::vector<EntryPtr>& out) const;
+
+    //! 要求を開始 (メインスレッド)
+    void start(const EntryPtr& entry);
+
+    //! 仕上げ処理を実行して完了させる (メインスレッド)
+    void finalize(const EntryPtr& entry);
+
+    //! 進捗を集計するグループに追加 (ロック中に呼び出し)
+    void addGroup(Entry& entry, u32 group);
+
+    //! 状態を変更 (取り消し済みの場合は変更しない)
+    void setState(const EntryPtr& entry, State state);
+
+    //! 要求を終了してリストから外す
+    //! @param  [in]    entry   要求
+    //! @param  [in]    counter 進捗の加算先 (Progress::completed_ など)
+    void retire(const EntryPtr& entry, u32 Progress::*counter);
+
+private:
+    ClockFunc                               clock_;            //!< 時刻取得関数
+    Settings                                settings_;         //!< 設定
+    Stats                                   stats_;            //!< 統計情報
+    std::unordered_map<RequestId, EntryPtr> entries_;          //!< 管理中の要求
+    std::unordered_map<u32, Progress>       groups_;           //!< グループごとの進捗
+    Progress                                total_;            //!< 全体の進捗
+    RequestId                               next_id_    = 1;   //!< 次の要求ID
+    u32                                     next_group_ = 1;   //!< 次のグループ番号
+    std::vector<EntryPtr>                   work_;             //!< 作業領域
+    mutable std::mutex                      mutex_;            //!< 排他制御
+
+    static thread_local u32 scope_group_;   //!< GroupScopeで指定されたグループ (0:なし)
+};
+
+//  共有ストリーミングを取得
+StreamingManager& GetStreamingManager();
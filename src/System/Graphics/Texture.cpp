@@ -4,6 +4,62 @@
 //---------------------------------------------------------------------------
 #include "Texture.h"
 
+namespace
+{
+
+//---------------------------------------------------------------------------
+//! ピクセルフォーマットの1ピクセルあたりのビット数
+//! @note   ブロック圧縮形式は4x4ブロックを1ピクセルあたりに換算した値
+//---------------------------------------------------------------------------
+u32 bitsPerPixel(DXGI_FORMAT format)
+{
+    switch(format) {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return 4;
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+        case DXGI_FORMAT_R8_TYPELESS:
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_A8_UNORM:
+            return 8;
+        case DXGI_FORMAT_R16_TYPELESS:
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_R8G8_UNORM:
+            return 16;
+        case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R32G32_FLOAT:
+            return 64;
+        case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            return 128;
+        default:
+            return 32;   // RGBA8/R32など
+    }
+}
+
+}   // namespace
+
 //---------------------------------------------------------------------------
 //! デストラクタ
 //---------------------------------------------------------------------------
@@ -17,6 +73,12 @@ Texture::~Texture()
 //---------------------------------------------------------------------------
 void Texture::clear()
 {
+    // 読み込み中の場合は取り消す
+    if(request_) {
+        GetStreamingManager().cancel(request_);
+        request_ = 0;
+    }
+
     if(handle_ != -1) {
         SetASyncLoadFinishDeleteFlag(handle_);
         handle_ = -1;
@@ -50,6 +112,7 @@ Texture::Texture(int grHandle)
     GetGraphSize(handle_, &w, &h);
     width_  = static_cast<u32>(w);
     height_ = static_cast<u32>(h);
+    bytes_  = static_cast<u64>(width_) * height_ * 4;
 
     //----------------------------------------------------------
     // D3Dリソース初期化
@@ -72,20 +135,34 @@ Texture::Texture(std::string_view path)
     // パスの保存
     path_ = convertTo(texture_path);
 
-    // ハンドルの非同期読み込み処理が完了したら呼ばれる関数
-    auto finish_callback = []([[maybe_unused]] int handle, void* data) {
-        Texture* texture = reinterpret_cast<Texture*>(data);
+    //----------------------------------------------------------
+    // ストリーミングに読み込みを要求
+    //----------------------------------------------------------
+    StreamingManager::Request request;
+    request.name_ = texture_path;
+
+    // 非同期ロード開始
+    request.start_ = [this, texture_path]() {
+        SetUseASyncLoadFlag(true);
+        handle_ = LoadGraph(texture_path.c_str());
+        SetUseASyncLoadFlag(false);
+        return handle_ != -1;
+    };
+    request.poll_ = [this]() { return StreamingManager::toPoll(CheckHandleASyncLoad(handle_)); };
+    request.wait_ = [this]() { WaitHandleASyncLoad(handle_); };
+
+    // 仕上げ (D3Dリソースの初期化)
+    request.finalize_ = [this]() {
+        need_initialize_ = true;
+        on_initialize();
 
         // アクティブフラグを設定
-        texture->need_initialize_ = true;
-        texture->active_          = true;
+        active_  = true;
+        request_ = 0;
+        return true;
     };
 
-    // 非同期ロード
-    SetUseASyncLoadFlag(true);
-    handle_ = LoadGraph(texture_path.c_str());
-    SetASyncLoadFinishCallback(handle_, (void (*)(int, void*))finish_callback, this);
-    SetUseASyncLoadFlag(false);
+    request_ = GetStreamingManager().request(std::move(request));
 }
 
 //---------------------------------------------------------------------------
@@ -161,6 +238,15 @@ bool Texture::initialize(ID3D11Resource* d3d_resource)
         width_  = desc.Width;    // 幅
         height_ = desc.Height;   // 高さ
 
+        // メモリ使用量 (ミップマップは1段ごとに1/4)
+        bytes_ = 0;
+        for(u32 mip = 0; mip < std::max(desc.MipLevels, 1u); ++mip) {
+            u64 w = std::max(desc.Width >> mip, 1u);
+            u64 h = std::max(desc.Height >> mip, 1u);
+            bytes_ += w * h * bitsPerPixel(desc.Format) / 8;
+        }
+        bytes_ *= desc.ArraySize;
+
         if(desc.BindFlags & D3D11_BIND_SHADER_RESOURCE) {
             if(desc.Format == DXGI_FORMAT_R32_TYPELESS) {   // デプスバッファ用の場合はR32_FLOATとして利用
                 D3D11_SHADER_RESOURCE_VIEW_DESC view_desc{};
@@ -234,6 +320,14 @@ u32 Texture::height() const
     return height_;
 }
 
+//---------------------------------------------------------------------------
+//!  メモリ使用量を取得
+//---------------------------------------------------------------------------
+u64 Texture::byteSize() const
+{
+    return bytes_;
+}
+
 //---------------------------------------------------------------------------
 //! D3Dリソースを取得
 //---------------------------------------------------------------------------
@@ -290,12 +384,29 @@ const std::wstring& Texture::path() const
     return path_;
 }
 
+//---------------------------------------------------------------------------
+//! ストリーミングの要求IDを取得
+//---------------------------------------------------------------------------
+StreamingManager::RequestId Texture::request() const
+{
+    return request_;
+}
+
 //---------------------------------------------------------------------------
 //! 初期化が正しく成功しているかどうか
 //---------------------------------------------------------------------------
 bool Texture::is_valid() const
 {
-    return d3d_resource_ || handle_ != -1;
+    return d3d_resource_ || handle_ != -1 || GetStreamingManager().state(request_) != StreamingManager::State::None;
+}
+
+//---------------------------------------------------------------------------
+//! 非同期読み込みに失敗したかどうか
+//---------------------------------------------------------------------------
+bool Texture::is_failed() const
+{
+    // 仕上げが成功すると要求IDは0に戻る。要求IDを持ったまま管理外になった場合は失敗
+    return request_ != 0 && GetStreamingManager().state(request_) == StreamingManager::State::None;
 }
 
 //---------------------------------------------------------------------------
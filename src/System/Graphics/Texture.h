@@ -48,6 +48,9 @@ public:
     // 高さを取得
     u32 height() const;
 
+    // メモリ使用量を取得 (単位:byte 読み込み完了前は0)
+    u64 byteSize() const;
+
     // D3Dリソースを取得
     ID3D11Resource* d3dResource() const;
 
@@ -66,9 +69,15 @@ public:
     // ファイルパスを取得
     const std::wstring& path() const;
 
+    // ストリーミングの要求IDを取得 (読み込み完了後は0)
+    StreamingManager::RequestId request() const;
+
     // 初期化が正しく成功しているかどうか
     bool is_valid() const;
 
+    // 非同期読み込みに失敗したかどうか
+    bool is_failed() const;
+
     // 描画可能な状態かどうか取得
     //! @note   描画可能になっていない状態でMV1関数を呼ぶとブロッキングされます
     bool is_active() const;
@@ -85,10 +94,12 @@ protected:
 protected:
     u32               width_  = 0;       //!< 幅
     u32               height_ = 0;       //!< 高さ
+    u64               bytes_  = 0;       //!< メモリ使用量 (単位:byte ミップマップ/配列を含む)
     int               handle_ = -1;      //!< [DxLib] Graphicハンドル
     std::wstring      path_;             //!< ファイルパス
     std::atomic<bool> active_ = false;   //!< アクティブ状態 true:利用可能 false:ロード未完了
     std::atomic<bool> need_initialize_ = false;   //!< 初期化要求フラグ true:初期化が必要 false:初期化済または完了で不要
+    StreamingManager::RequestId request_ = 0;     //!< ストリーミングの要求ID (ファイルから作成した場合)
 
     Microsoft::WRL::ComPtr<ID3D11Resource>           d3d_resource_;   //!< D3Dリソース(Texture2D/3D)
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> d3d_srv_;        //!< D3D ShaderResource View
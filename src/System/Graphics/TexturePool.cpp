@@ -0,0 +1,250 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TexturePool.cpp
+//! @brief  テクスチャリソースプール
+//---------------------------------------------------------------------------
+#include "TexturePool.h"
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+TexturePool::TexturePool(LoadFunc load, SizeFunc size, StatusFunc status, StreamingManager* streaming)
+    : load_(std::move(load))
+    , size_(std::move(size))
+    , status_(std::move(status))
+    , streaming_(streaming)
+{
+}
+
+//---------------------------------------------------------------------------
+//! 全テクスチャをプールから外す
+//---------------------------------------------------------------------------
+void TexturePool::clear()
+{
+    std::lock_guard lock(mutex_);
+
+    map_.clear();
+    entries_.clear();
+    resident_bytes_ = 0;
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャを取得
+//---------------------------------------------------------------------------
+std::shared_ptr<Texture> TexturePool::acquire(std::string_view path)
+{
+    std::lock_guard lock(mutex_);
+
+    // 共有 (最近使った順の先頭へ移動)
+    if(auto it = map_.find(path); it != map_.end()) {
+        auto entry = it->second;
+        if(!resolve(*entry)) {
+            entries_.splice(entries_.begin(), entries_, entry);
+            counters_.hits_++;
+
+            // 読み込み途中なら先行読み込み中のシーンの進捗にも含める
+            if(streaming_)
+                streaming_->join(entry->texture_->request());
+            return entry->texture_;
+        }
+
+        // 読み込みに失敗していた場合は外して読み込み直す
+        drop(entry);
+    }
+
+    // 新規読み込み
+    counters_.misses_++;
+
+    Entry entry;
+    entry.path_    = std::string(path);
+    entry.texture_ = load_(entry.path_);
+    if(!entry.texture_)
+        return nullptr;
+
+    // 読み込み済みのテクスチャはサイズを確定
+    if(resolve(entry)) {
+        counters_.failures_++;
+        return nullptr;
+    }
+
+    // 予算を超えていても読み込んだテクスチャは解放されないよう、参照を持ってから整理する
+    auto texture = entry.texture_;
+
+    entries_.push_front(std::move(entry));
+    map_[entries_.front().path_] = entries_.begin();
+
+    // 未参照のテクスチャを解放して予算に収める
+    evict();
+
+    return texture;
+}
+
+//---------------------------------------------------------------------------
+//! サイズを確定し、失敗したテクスチャと予算を超えた未参照のテクスチャを外す
+//---------------------------------------------------------------------------
+void TexturePool::update()
+{
+    std::lock_guard lock(mutex_);
+
+    // 非同期読み込みが終わったテクスチャのサイズを確定 (確定済みのテクスチャは問い合わせない)
+    for(auto it = entries_.begin(); it != entries_.end();) {
+        if(resolve(*it))
+            it = drop(it);
+        else
+            ++it;
+    }
+
+    evict();
+}
+
+//---------------------------------------------------------------------------
+//! 予算を設定
+//---------------------------------------------------------------------------
+void TexturePool::setBudget(u64 bytes)
+{
+    std::lock_guard lock(mutex_);
+
+    budget_ = bytes;
+    evict();
+}
+
+//---------------------------------------------------------------------------
+//! プールに存在するかどうか
+//---------------------------------------------------------------------------
+bool TexturePool::contains(std::string_view path) const
+{
+    std::lock_guard lock(mutex_);
+
+    return map_.find(path) != map_.end();
+}
+
+//---------------------------------------------------------------------------
+//! 統計情報を取得
+//---------------------------------------------------------------------------
+TexturePool::Stats TexturePool::stats() const
+{
+    std::lock_guard lock(mutex_);
+
+    Stats stats           = counters_;
+    stats.resident_bytes_ = resident_bytes_;
+    stats.count_          = static_cast<u32>(entries_.size());
+    for(auto& entry : entries_) {
+        // プール以外からも参照されているか
+        if(entry.texture_.use_count() > 1) {
+            stats.referenced_bytes_ += entry.bytes_;
+            stats.referenced_++;
+        }
+    }
+    return stats;
+}
+
+//---------------------------------------------------------------------------
+//! 共有/読み込み/解放の回数をリセット
+//---------------------------------------------------------------------------
+void TexturePool::resetStats()
+{
+    std::lock_guard lock(mutex_);
+
+    counters_ = {};
+}
+
+//---------------------------------------------------------------------------
+//! ファイルから非同期読み込み
+//---------------------------------------------------------------------------
+std::shared_ptr<Texture> TexturePool::loadFile(const std::string& path)
+{
+    return std::make_shared<Texture>(path);
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャのメモリ使用量を取得
+//---------------------------------------------------------------------------
+u64 TexturePool::textureSize(const Texture& texture)
+{
+    return texture.byteSize();
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャの読み込み状況を取得
+//---------------------------------------------------------------------------
+TexturePool::Status TexturePool::textureStatus(const Texture& texture)
+{
+    if(texture.is_failed())
+        return Status::Failed;
+    return texture.is_active() ? Status::Loaded : Status::Loading;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み状況を確認し、完了していればサイズを確定
+//---------------------------------------------------------------------------
+bool TexturePool::resolve(Entry& entry)
+{
+    if(entry.resolved_)
+        return false;
+
+    switch(status_(*entry.texture_)) {
+    case Status::Loading:
+        return false;
+    case Status::Failed:
+        return true;
+    case Status::Loaded:
+        break;
+    }
+
+    entry.bytes_    = size_(*entry.texture_);
+    entry.resolved_ = true;
+    resident_bytes_ += entry.bytes_;
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込みに失敗したエントリを外す
+//---------------------------------------------------------------------------
+TexturePool::Entries::iterator TexturePool::drop(Entries::iterator it)
+{
+    // サイズは確定していないため合計サイズは変わらない
+    map_.erase(it->path_);
+    counters_.failures_++;
+    return entries_.erase(it);
+}
+
+//---------------------------------------------------------------------------
+//! 予算を超えた分を古い順に解放
+//---------------------------------------------------------------------------
+void TexturePool::evict()
+{
+    // 予算0の場合はサイズ未確定のものも含めて未参照のテクスチャをすべて解放
+    auto over_budget = [&]() { return resident_bytes_ > budget_ || budget_ == 0; };
+
+    // 末尾(最後に使われた時刻が古い)から未参照のテクスチャを探す
+    auto it = entries_.end();
+    while(over_budget() && it != entries_.begin()) {
+        --it;
+        if(it->texture_.use_count() > 1)   // 参照中
+            continue;
+
+        resident_bytes_ -= it->bytes_;
+        map_.erase(it->path_);
+        it = entries_.erase(it);
+        counters_.evictions_++;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 共有テクスチャプールを取得
+//---------------------------------------------------------------------------
+TexturePool& GetTexturePool()
+{
+    static TexturePool pool(&TexturePool::loadFile,
+                            &TexturePool::textureSize,
+                            &TexturePool::textureStatus,
+                            &GetStreamingManager());
+    return pool;
+}
+
+//---------------------------------------------------------------------------
+//! 共有テクスチャプールからテクスチャを取得
+//---------------------------------------------------------------------------
+std::shared_ptr<Texture> LoadTexture(std::string_view path)
+{
+    return GetTexturePool().acquire(path);
+}
@@ -0,0 +1,173 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TexturePool.h
+//! @brief  テクスチャリソースプール
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+//===========================================================================
+//! テクスチャリソースプール
+//! @details ファイルパスをキーにテクスチャを共有し、同じファイルを重複して読み込まないようにします。
+//!          どこからも参照されなくなったテクスチャもキャッシュとして残し、合計サイズが予算(VRAM使用量)を
+//!          超えたときに最後に使われた時刻が古い順(LRU)に解放します。参照中のテクスチャは解放しません。
+//!          非同期読み込みに失敗したテクスチャはプールから外し、次回の取得で読み込み直します。
+//!          読み込み関数/サイズ取得関数/状況取得関数は差し替えられるため、DxLib無しでも方針を確認できます。
+//===========================================================================
+class TexturePool
+{
+public:
+    //! 既定の予算 (byte)
+    static constexpr u64 DEFAULT_BUDGET = 256ull * 1024 * 1024;
+
+    //! 読み込み関数
+    //! @param  [in]    path    ファイルパス
+    //! @return 読み込みを開始したテクスチャ (失敗時はnullptr)
+    using LoadFunc = std::function<std::shared_ptr<Texture>(const std::string& path)>;
+
+    //! サイズ取得関数 (読み込み完了後に1度だけ呼び出します)
+    //! @return テクスチャのメモリ使用量 (byte)
+    using SizeFunc = std::function<u64(const Texture& texture)>;
+
+    //! 読み込み状況
+    enum class Status
+    {
+        Loading,   //!< 読み込み中
+        Loaded,    //!< 完了
+        Failed,    //!< 失敗
+    };
+
+    //! 読み込み状況の取得関数
+    using StatusFunc = std::function<Status(const Texture& texture)>;
+
+    //! 統計情報
+    struct Stats
+    {
+        u64 resident_bytes_   = 0;   //!< プール内のテクスチャの合計サイズ (byte)
+        u64 referenced_bytes_ = 0;   //!< そのうち参照中のテクスチャの合計サイズ (byte)
+        u32 count_            = 0;   //!< プール内のテクスチャ数
+        u32 referenced_       = 0;   //!< そのうち参照中のテクスチャ数
+        u64 hits_             = 0;   //!< 共有できた回数
+        u64 misses_           = 0;   //!< 新規に読み込んだ回数
+        u64 evictions_        = 0;   //!< 予算超過で解放した回数
+        u64 failures_         = 0;   //!< 読み込みに失敗して外した回数
+    };
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //  コンストラクタ
+    //! @param  [in]    load        読み込み関数
+    //! @param  [in]    size        サイズ取得関数
+    //! @param  [in]    status      読み込み状況の取得関数
+    //! @param  [in]    streaming   共有した読み込み途中の要求を集計するストリーミング (nullptrなら集計しない)
+    TexturePool(LoadFunc          load      = &TexturePool::loadFile,
+                SizeFunc          size      = &TexturePool::textureSize,
+                StatusFunc        status    = &TexturePool::textureStatus,
+                StreamingManager* streaming = nullptr);
+
+    //  全テクスチャをプールから外す (参照中のテクスチャは参照元で保持され続けます)
+    void clear();
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   操作
+    //----------------------------------------------------------
+    //@{
+
+    //  テクスチャを取得 (プールに無ければ読み込み)
+    //! @param  [in]    path    ファイルパス
+    std::shared_ptr<Texture> acquire(std::string_view path);
+
+    //  読み込みが終わったテクスチャのサイズを確定し、失敗したテクスチャと予算を超えた未参照のテクスチャを外す (毎フレーム呼び出し)
+    void update();
+
+    //  予算を設定
+    //! @param  [in]    bytes   合計サイズの上限 (0:未参照になったら即解放)
+    void setBudget(u64 bytes);
+
+    //! 予算を取得
+    u64 budget() const { return budget_; }
+
+    //  プールに存在するかどうか
+    //! @param  [in]    path    ファイルパス
+    bool contains(std::string_view path) const;
+
+    //  統計情報を取得
+    Stats stats() const;
+
+    //  共有/読み込み/解放の回数をリセット
+    void resetStats();
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   既定の関数
+    //----------------------------------------------------------
+    //@{
+
+    //  ファイルから非同期読み込み
+    static std::shared_ptr<Texture> loadFile(const std::string& path);
+
+    //  テクスチャのメモリ使用量を取得
+    static u64 textureSize(const Texture& texture);
+
+    //  テクスチャの読み込み状況を取得
+    static Status textureStatus(const Texture& texture);
+
+    //@}
+
+private:
+    //! プール内のテクスチャ
+    struct Entry
+    {
+        std::string              path_;               //!< ファイルパス
+        std::shared_ptr<Texture> texture_;            //!< テクスチャ
+        u64                      bytes_    = 0;       //!< メモリ使用量 (読み込み完了後に確定)
+        bool                     resolved_ = false;   //!< 読み込みが完了してサイズを確定したか
+    };
+
+    using Entries = std::list<Entry>;
+    using Map     = std::unordered_map<std::string_view, Entries::iterator>;
+
+    //! 読み込み状況を確認し、完了していればサイズを確定
+    //! @return 読み込みに失敗したか
+    bool resolve(Entry& entry);
+
+    //! 読み込みに失敗したエントリを外す
+    //! @return 次のエントリ
+    Entries::iterator drop(Entries::iterator it);
+
+    //! 予算を超えた分を古い順に解放
+    void evict();
+
+private:
+    LoadFunc           load_;                              //!< 読み込み関数
+    SizeFunc           size_;                              //!< サイズ取得関数
+    StatusFunc         status_;                            //!< 読み込み状況の取得関数
+    StreamingManager*  streaming_      = nullptr;          //!< 進捗を集計するストリーミング
+    u64                budget_         = DEFAULT_BUDGET;   //!< 予算 (byte)
+    u64                resident_bytes_ = 0;                //!< 合計サイズ (byte)
+    Entries            entries_;                           //!< 最近使った順 (先頭が最新)
+    Map                map_;                               //!< パス→エントリ (キーはEntry::path_を参照)
+    Stats              counters_;                          //!< 共有/読み込み/解放の回数
+    mutable std::mutex mutex_;                             //!< 排他制御
+};
+
+//--------------------------------------------------------------
+//! @name   共有プール
+//--------------------------------------------------------------
+//@{
+
+//  共有テクスチャプールを取得
+TexturePool& GetTexturePool();
+
+//  共有テクスチャプールからテクスチャを取得
+//! @param  [in]    path    ファイルパス
+std::shared_ptr<Texture> LoadTexture(std::string_view path);
+
+//@}
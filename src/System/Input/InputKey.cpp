@@ -3,6 +3,7 @@
 //! @brief  キー入力管理
 //---------------------------------------------------------------------------
 #include "InputKey.h"
+#include "InputRecorder.h"
 
 namespace
 {
@@ -37,6 +38,7 @@ int InputKeyUpdate()
 {
     char tmp_key[MAX_KEY_NUM];
     GetHitKeyStateAll(tmp_key);
+    InputRecorderSyncKeys(tmp_key);   // 記録/再生
 
     for(int i = 0; i < MAX_KEY_NUM; ++i) {
         if(tmp_key[i] != 0) {
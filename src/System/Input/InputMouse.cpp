@@ -3,6 +3,7 @@
 //! @brief	マウス入力管理
 //---------------------------------------------------------------------------
 #include "InputMouse.h"
+#include "InputRecorder.h"
 
 namespace
 {
@@ -10,6 +11,8 @@ constexpr int MAX_MOUSE_BUTTON = 8;
 
 int mouseX_;
 int mouseY_;
+int mouseInput_;
+f32 mouseWheel_;
 
 int mouseButtons_[MAX_MOUSE_BUTTON];
 
@@ -25,8 +28,10 @@ bool IsOverMouseNum(int mouseID)
 //---------------------------------------------------------------------------
 void InputMouseInit()
 {
-    mouseX_ = 0;
-    mouseY_ = 0;
+    mouseX_     = 0;
+    mouseY_     = 0;
+    mouseInput_ = 0;
+    mouseWheel_ = 0.0f;
 
     for(int i = 0; i < MAX_MOUSE_BUTTON; ++i) {
         mouseButtons_[i] = 0;
@@ -39,6 +44,10 @@ void InputMouseInit()
 void InputMouseUpdate()
 {
     GetMousePoint(&mouseX_, &mouseY_);
+    int buttons = GetMouseInput();
+    mouseWheel_ = GetMouseWheelRotVolF();   // 前回の呼び出しからの回転量のため、取得はここでのみ行う
+    InputRecorderSyncMouse(mouseX_, mouseY_, buttons, mouseWheel_);   // 記録/再生
+    mouseInput_ = buttons;
 
     static constexpr int MOUSE_BUTTONS[MAX_MOUSE_BUTTON] = {
         MOUSE_INPUT_LEFT,
@@ -56,7 +65,7 @@ void InputMouseUpdate()
 
     for(int i = 0; i < MAX_MOUSE_BUTTON; ++i) {
         // 各マウスボタンとの押下状態を取得する
-        if(GetMouseInput() & MOUSE_BUTTONS[i]) {
+        if(buttons & MOUSE_BUTTONS[i]) {
             ++mouseButtons_[i];
             if(mouseButtons_[i] >= INT_MAX)
                 mouseButtons_[i] = INT_MAX;
@@ -123,3 +132,19 @@ int GetMouseY()
 {
     return mouseY_;
 }
+
+//---------------------------------------------------------------------------
+// マウスのボタン入力状態 取得
+//---------------------------------------------------------------------------
+int GetMouseButtons()
+{
+    return mouseInput_;
+}
+
+//---------------------------------------------------------------------------
+// マウスホイールの回転量 取得
+//---------------------------------------------------------------------------
+f32 GetMouseWheel()
+{
+    return mouseWheel_;
+}
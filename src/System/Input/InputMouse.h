@@ -51,5 +51,11 @@ int GetMouseX();
 //! マウスのY座標 取得
 //! @return マウスのY座標
 int GetMouseY();
+//! マウスのボタン入力状態 取得
+//! @return GetMouseInput()と同じビットフラグ (MOUSE_INPUT_LEFTなど)
+int GetMouseButtons();
+//! マウスホイールの回転量 取得
+//! @return 前フレームからの回転量 (GetMouseWheelRotVolF()と同じ値)
+f32 GetMouseWheel();
 
 //@}
@@ -3,6 +3,7 @@
 //! @brief	パッド入力管理
 //---------------------------------------------------------------------------
 #include "InputPad.h"
+#include "InputRecorder.h"
 
 namespace
 {
@@ -47,6 +48,8 @@ void InputPadUpdate()
 {
     for(int j = 0; j < MAX_PAD_TYPE; ++j) {
         int tmp_pad = GetJoypadInputState(PAD_TYPES[j]);
+        InputRecorderSyncPad(j, tmp_pad);   // 記録/再生
+
         for(int i = 0; i < MAX_PAD_NUM; ++i) {
             if(tmp_pad & PAD_BUTTONS[i]) {
                 ++pads_[j][i];
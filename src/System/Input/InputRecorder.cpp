@@ -0,0 +1,303 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	InputRecorder.cpp
+//! @brief	入力と経過時間の記録/再生
+//!
+//! [ファイル形式] (リトルエンディアン)
+//!     ヘッダー   : "BPIR" / u32 バージョン / u32 乱数シード
+//!     フレーム   : f32 ⊿t / u8 変化フラグ / (変化したブロックのみ)
+//!                  キー   : u8[32]  256キーのビットセット
+//!                  パッド : s32[4]  GetJoypadInputState()
+//!                  マウス : s32 X / s32 Y / s32 GetMouseInput() / f32 GetMouseWheelRotVolF()
+//---------------------------------------------------------------------------
+#include "InputRecorder.h"
+
+#include <array>
+#include <cstring>
+
+namespace
+{
+constexpr char MAGIC[4] = {'B', 'P', 'I', 'R'};   //!< ファイル識別子
+constexpr u32  VERSION  = 2;                      //!< ファイルバージョン (2:マウスホイールを追加)
+constexpr u32  KEY_NUM  = 256;                    //!< キー数
+constexpr u32  PAD_NUM  = 4;                      //!< パッド数
+
+//! フレーム内で変化したブロック
+enum FrameFlag : u8
+{
+    KEY_CHANGED   = 1 << 0,
+    PAD_CHANGED   = 1 << 1,
+    MOUSE_CHANGED = 1 << 2,
+};
+
+//--------------------------------------------------------------
+//! 1フレーム分の入力
+//--------------------------------------------------------------
+struct Frame
+{
+    f32                         delta_ = 0.0f;   //!< 経過時間
+    std::array<u8, KEY_NUM / 8> keys_{};         //!< キーのビットセット
+    std::array<s32, PAD_NUM>    pads_{};         //!< パッド
+    std::array<s32, 3>          mouse_{};        //!< マウス X/Y/ボタン
+    f32                         wheel_ = 0.0f;   //!< マウスホイールの回転量
+};
+
+enum class Mode
+{
+    None,     //!< 通常実行
+    Record,   //!< 記録中
+    Replay,   //!< 再生中
+};
+
+Mode          mode = Mode::None;   //!< 動作モード
+std::ofstream record_file;         //!< 記録ファイル
+std::ifstream replay_file;         //!< 再生ファイル
+Frame         current_;            //!< 現在のフレーム
+Frame         previous_;           //!< 1フレーム前 (差分判定用)
+u64           frame_count_ = 0;    //!< 処理したフレーム数
+
+//---------------------------------------------------------------------------
+//! バイナリ書き込み/読み込み
+//---------------------------------------------------------------------------
+template <class T>
+void write(const T& value)
+{
+    record_file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool read(T& value)
+{
+    replay_file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return replay_file.good();
+}
+
+//---------------------------------------------------------------------------
+//! コマンドライン引数からオプションの値を取得
+//! @param  [in]    command_line    コマンドライン引数
+//! @param  [in]    option          オプション名 ("-record"など)
+//! @return オプションの次のトークン (見つからない場合は空文字列)
+//---------------------------------------------------------------------------
+std::string findOption(std::string_view command_line, std::string_view option)
+{
+    size_t pos = command_line.find(option);
+    if(pos == std::string_view::npos)
+        return {};
+
+    pos = command_line.find_first_not_of(' ', pos + option.size());
+    if(pos == std::string_view::npos)
+        return {};
+
+    // ダブルクォーテーションで囲まれたパス
+    if(command_line[pos] == '"') {
+        size_t end = command_line.find('"', pos + 1);
+        return std::string(command_line.substr(pos + 1, end - (pos + 1)));
+    }
+
+    size_t end = command_line.find(' ', pos);
+    return std::string(command_line.substr(pos, end - pos));
+}
+
+//---------------------------------------------------------------------------
+//! 再生終了
+//---------------------------------------------------------------------------
+void stopReplay()
+{
+    // 同フレーム内でclsDx()されるため、デバッガ出力へ通知する
+    char message[64];
+    sprintf_s(message, "InputRecorder: replay finished (%llu frames)\n", frame_count_);
+    OutputDebugStringA(message);
+
+    replay_file.close();
+    mode = Mode::None;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+// 初期化
+//---------------------------------------------------------------------------
+void InputRecorderInit(std::string_view command_line, u32& seed)
+{
+    mode         = Mode::None;
+    current_     = {};
+    previous_    = {};
+    frame_count_ = 0;
+
+    if(auto path = findOption(command_line, "-replay"); !path.empty()) {
+        replay_file.open(path, std::ios::in | std::ios::binary);
+
+        char magic[4] = {};
+        u32  version  = 0;
+        replay_file.read(magic, sizeof(magic));
+        if(replay_file && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && read(version) && version == VERSION &&
+           read(seed)) {
+            // 記録時の乱数シードで実行する
+            mode = Mode::Replay;
+            return;
+        }
+        replay_file.close();
+        return;
+    }
+
+    if(auto path = findOption(command_line, "-record"); !path.empty()) {
+        record_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(record_file) {
+            // ヘッダーを書き出し
+            record_file.write(MAGIC, sizeof(MAGIC));
+            write(VERSION);
+            write(seed);
+            mode = Mode::Record;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+// 終了
+//---------------------------------------------------------------------------
+void InputRecorderExit()
+{
+    if(record_file.is_open())
+        record_file.close();
+    if(replay_file.is_open())
+        replay_file.close();
+
+    mode = Mode::None;
+}
+
+//---------------------------------------------------------------------------
+// フレームの開始
+//---------------------------------------------------------------------------
+void InputRecorderBeginFrame()
+{
+    if(mode != Mode::Replay)
+        return;
+
+    // 変化したブロックのみ記録されているため、前フレームの値に上書きする
+    u8 flags = 0;
+    if(!read(current_.delta_) || !read(flags)) {
+        stopReplay();
+        return;
+    }
+
+    bool ok = true;
+    if(flags & KEY_CHANGED)
+        ok = ok && read(current_.keys_);
+    if(flags & PAD_CHANGED)
+        ok = ok && read(current_.pads_);
+    if(flags & MOUSE_CHANGED)
+        ok = ok && read(current_.mouse_) && read(current_.wheel_);
+
+    if(!ok) {
+        stopReplay();
+        return;
+    }
+    ++frame_count_;
+}
+
+//---------------------------------------------------------------------------
+// フレームの終了
+//---------------------------------------------------------------------------
+void InputRecorderEndFrame()
+{
+    if(mode != Mode::Record)
+        return;
+
+    u8 flags = 0;
+    if(current_.keys_ != previous_.keys_)
+        flags |= KEY_CHANGED;
+    if(current_.pads_ != previous_.pads_)
+        flags |= PAD_CHANGED;
+    if(current_.mouse_ != previous_.mouse_ || current_.wheel_ != previous_.wheel_)
+        flags |= MOUSE_CHANGED;
+
+    write(current_.delta_);
+    write(flags);
+    if(flags & KEY_CHANGED)
+        write(current_.keys_);
+    if(flags & PAD_CHANGED)
+        write(current_.pads_);
+    if(flags & MOUSE_CHANGED) {
+        write(current_.mouse_);
+        write(current_.wheel_);
+    }
+
+    previous_ = current_;
+    ++frame_count_;
+}
+
+//---------------------------------------------------------------------------
+// キー状態を同期
+//---------------------------------------------------------------------------
+void InputRecorderSyncKeys(char (&keys)[256])
+{
+    if(mode == Mode::Record) {
+        current_.keys_.fill(0);
+        for(u32 i = 0; i < KEY_NUM; ++i) {
+            if(keys[i])
+                current_.keys_[i >> 3] |= static_cast<u8>(1 << (i & 7));
+        }
+    }
+    else if(mode == Mode::Replay) {
+        for(u32 i = 0; i < KEY_NUM; ++i) {
+            keys[i] = (current_.keys_[i >> 3] >> (i & 7)) & 1;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+// パッド状態を同期
+//---------------------------------------------------------------------------
+void InputRecorderSyncPad(u32 pad_index, int& state)
+{
+    if(pad_index >= PAD_NUM)
+        return;
+
+    if(mode == Mode::Record)
+        current_.pads_[pad_index] = state;
+    else if(mode == Mode::Replay)
+        state = current_.pads_[pad_index];
+}
+
+//---------------------------------------------------------------------------
+// マウス状態を同期
+//---------------------------------------------------------------------------
+void InputRecorderSyncMouse(int& x, int& y, int& buttons, f32& wheel)
+{
+    if(mode == Mode::Record) {
+        current_.mouse_ = {x, y, buttons};
+        current_.wheel_ = wheel;
+    }
+    else if(mode == Mode::Replay) {
+        x       = current_.mouse_[0];
+        y       = current_.mouse_[1];
+        buttons = current_.mouse_[2];
+        wheel   = current_.wheel_;
+    }
+}
+
+//---------------------------------------------------------------------------
+// 経過時間を同期
+//---------------------------------------------------------------------------
+void InputRecorderSyncDelta(f32& delta)
+{
+    if(mode == Mode::Record)
+        current_.delta_ = delta;
+    else if(mode == Mode::Replay)
+        delta = current_.delta_;
+}
+
+//---------------------------------------------------------------------------
+// 記録中かどうか
+//---------------------------------------------------------------------------
+bool IsInputRecording()
+{
+    return mode == Mode::Record;
+}
+
+//---------------------------------------------------------------------------
+// 再生中かどうか
+//---------------------------------------------------------------------------
+bool IsInputReplaying()
+{
+    return mode == Mode::Replay;
+}
@@ -0,0 +1,76 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	InputRecorder.h
+//! @brief	入力と経過時間の記録/再生
+//!
+//! 起動時のコマンドライン引数で動作を指定します
+//! @code
+//!     BaseProject.exe -record input.rec   // 記録
+//!     BaseProject.exe -replay input.rec   // 再生
+//! @endcode
+//! 再生中はキー/パッド/マウスの入力状態と1フレームの経過時間⊿tを記録ファイルの値で置き換えるため、
+//! 同じフレームを何度でも再現できます。
+//! @note ImGuiへの入力(メニュー操作など)は記録対象外です
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <string_view>
+
+//===========================================================================
+//!	@name	システム関数
+//===========================================================================
+//@{
+
+//! 初期化
+//! @param	[in]	command_line	コマンドライン引数 ("-record <file>" または "-replay <file>")
+//! @param	[inout]	seed			乱数シード (記録時はファイルへ保存し、再生時は記録時のシードに置き換えます)
+void InputRecorderInit(std::string_view command_line, u32& seed);
+
+//! 終了
+void InputRecorderExit();
+
+//! フレームの開始 (再生時は次のフレームを読み込みます)
+void InputRecorderBeginFrame();
+
+//! フレームの終了 (記録時はフレームを書き出します)
+void InputRecorderEndFrame();
+
+//@}
+//===========================================================================
+//!	@name	入力の同期
+//!	記録中は値を記録し、再生中は記録された値で上書きします
+//===========================================================================
+//@{
+
+//! キー状態を同期
+//! @param	[inout]	keys	GetHitKeyStateAll()の取得結果
+void InputRecorderSyncKeys(char (&keys)[256]);
+
+//! パッド状態を同期
+//! @param	[in]	pad_index	パッド番号(0～3)
+//! @param	[inout]	state		GetJoypadInputState()の取得結果
+void InputRecorderSyncPad(u32 pad_index, int& state);
+
+//! マウス状態を同期
+//! @param	[inout]	x		マウスX座標
+//! @param	[inout]	y		マウスY座標
+//! @param	[inout]	buttons	GetMouseInput()の取得結果
+//! @param	[inout]	wheel	GetMouseWheelRotVolF()の取得結果
+void InputRecorderSyncMouse(int& x, int& y, int& buttons, f32& wheel);
+
+//! 経過時間を同期
+//! @param	[inout]	delta	1フレームの経過時間(単位:秒)
+void InputRecorderSyncDelta(f32& delta);
+
+//@}
+//===========================================================================
+//!	@name	参照
+//===========================================================================
+//@{
+
+//! 記録中かどうか
+bool IsInputRecording();
+
+//! 再生中かどうか
+bool IsInputReplaying();
+
+//@}
@@ -4,6 +4,7 @@
 //---------------------------------------------------------------------------
 #include "Object.h"
 #include <System/Component/ComponentTransform.h>
+#include <System/Component/ComponentCollision.h>
 #include <System/Scene.h>
 
 #include <unordered_map>
@@ -179,7 +180,7 @@ void Object::PrePhysics()
 #else
     if(GetComponent<ComponentTransform>()) {
         float3 g = gravity_;
-        Matrix()._41_42_43 += gravity_;
+        AddTranslate(gravity_);
         gravity_ = 0.0f;
     }
 #endif
@@ -322,6 +323,14 @@ void Object::ClearObjectNames()
     obj_names_count.clear();
 }
 
+//! @brief   使用している名前リストを入れ替える
+//! @details 先行構築するシーンのオブジェクト名が、現在のシーンの名前と重複しないようにする
+void Object::SwapObjectNames(NameTable& names)
+{
+    obj_names_id.swap(names.id_);
+    obj_names_count.swap(names.count_);
+}
+
 //@}
 //----------------------------------------------------------------------
 //! @name ComponentTransform関係
@@ -339,6 +348,25 @@ matrix& Object::Matrix()
     return cmp->Matrix();
 }
 
+//! @brief TransformのTRS情報を取得します
+//! @return ComponentTransform の TRS
+MatrixTRS* Object::TRSCache()
+{
+    auto cmp = GetComponent<ComponentTransform>();
+
+    assert(cmp && "このオブジェクトは、ComponentTransformが存在していません。位置移動はできません");
+
+    return cmp->TRSCache();
+}
+
+//! @brief 瞬間移動したときに呼ばれます
+void Object::OnTeleport()
+{
+    // 瞬間移動した経路で連続判定しないようにする
+    for(auto& col : GetComponents<ComponentCollision>())
+        col->ResetSweep();
+}
+
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix Object::GetOldWorldMatrix()
@@ -14,6 +14,7 @@
 
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 //---------------------------------------------------------------------------
 // ポインター宣言
@@ -283,6 +284,14 @@ public:
     //! @return ComponentTransform の Matrix
     matrix& Matrix();
 
+    //! @brief TransformのTRS情報を取得します
+    //! @return ComponentTransform の TRS
+    MatrixTRS* TRSCache() override;
+
+    //! @brief 位置を直接指定したときに呼ばれます
+    //! @details コリジョンの移動経路 (連続判定) をリセットします
+    void OnTeleport() override;
+
     ObjectPtr SharedThis()
     {
         return shared_from_this();
@@ -320,6 +329,17 @@ public:
     //! ステージ移行などでオブジェクトが消去されたときに呼ぶ
     static void ClearObjectNames();
 
+    //! 名前リスト (シーンの先行構築中に切り替えるために使用)
+    struct NameTable
+    {
+        std::unordered_map<std::string, u64> id_;      //!< 存在するオブジェクト名
+        std::unordered_map<std::string, u64> count_;   //!< 存在するオブジェクト名の数
+    };
+
+    //! 使用している名前リストを入れ替える
+    //! @param names 入れ替える名前リスト
+    static void SwapObjectNames(NameTable& names);
+
     //@}
 
     void SetGravity(float3 g)
@@ -0,0 +1,163 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	CollisionBatch.cpp
+//! @brief	球/カプセルの一括当たり判定 (SIMD)
+//---------------------------------------------------------------------------
+#include "CollisionBatch.h"
+
+namespace physics
+{
+namespace
+{
+constexpr f32 EPSILON = 1e-6f;   //!< 長さ0とみなす値
+
+//! 条件選択 (mask は比較結果の 1.0 / 0.0)
+float4 select(const float4& mask, const float4& a, const float4& b)
+{
+    return lerp(b, a, mask);
+}
+
+//! 内積 (xyz成分を別々のfloat4で持つSoA)
+float4 dot3(const float4 (&a)[3], const float4 (&b)[3])
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+//! SoA配列の読み込み
+void load3(float4 (&v)[3], const f32 (&src)[3][CollisionBatch::LANE_COUNT])
+{
+    for(u32 i = 0; i < 3; ++i)
+        load(v[i], const_cast<f32*>(src[i]));
+}
+
+//! SoA配列へ書き込み
+void store3(f32 (&dst)[3][CollisionBatch::LANE_COUNT], u32 lane, const float3& v)
+{
+    f32 xyz[3];
+    store(v, xyz);
+    for(u32 i = 0; i < 3; ++i)
+        dst[i][lane] = xyz[i];
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+// ペアを追加
+//---------------------------------------------------------------------------
+bool CollisionBatch::add(const float3& a0, const float3& a1, f32 ra, const float3& b0, const float3& b1, f32 rb)
+{
+    assert(count_ < LANE_COUNT);
+
+    u32 lane = count_++;
+    store3(a0_, lane, a0);
+    store3(a1_, lane, a1);
+    store3(b0_, lane, b0);
+    store3(b1_, lane, b1);
+    ra_[lane] = ra;
+    rb_[lane] = rb;
+
+    return count_ == LANE_COUNT;
+}
+
+//---------------------------------------------------------------------------
+// 判定
+//! 線分同士の最近接点 (Real-Time Collision Detection 5.1.9) を分岐なしで求めます
+//---------------------------------------------------------------------------
+u32 CollisionBatch::test(Result (&results)[LANE_COUNT]) const
+{
+    if(count_ == 0)
+        return 0;
+
+    float4 p1[3], q1[3], p2[3], q2[3];
+    load3(p1, a0_);
+    load3(q1, a1_);
+    load3(p2, b0_);
+    load3(q2, b1_);
+
+    float4 ra, rb;
+    load(ra, const_cast<f32*>(ra_));
+    load(rb, const_cast<f32*>(rb_));
+
+    float4 d1[3], d2[3], r[3];
+    for(u32 i = 0; i < 3; ++i) {
+        d1[i] = q1[i] - p1[i];
+        d2[i] = q2[i] - p2[i];
+        r[i]  = p1[i] - p2[i];
+    }
+
+    const float4 zero(0.0f);
+    const float4 eps(EPSILON);
+
+    float4 a = dot3(d1, d1);
+    float4 e = dot3(d2, d2);
+    float4 f = dot3(d2, r);
+    float4 c = dot3(d1, r);
+    float4 b = dot3(d1, d2);
+
+    // 0除算を避けるため、使われない側の分母も有効な値にしておく
+    float4 a_safe = max(a, eps);
+    float4 e_safe = max(e, eps);
+    float4 denom  = a * e - b * b;
+
+    // 一般の場合 (平行なら s = 0)
+    float4 not_parallel = denom > a * e * float4(EPSILON);
+    float4 s            = select(not_parallel, saturate((b * f - c * e) / max(denom, eps * eps)), zero);
+    float4 t            = (b * s + f) / e_safe;
+
+    // tが範囲外ならクランプしてsを求め直す
+    float4 s_t0 = saturate(-c / a_safe);
+    float4 s_t1 = saturate((b - c) / a_safe);
+    s           = select(t < zero, s_t0, select(t > float4(1.0f), s_t1, s));
+    t           = saturate(t);
+
+    // Bが点
+    float4 b_point = e <= eps;
+    s              = select(b_point, s_t0, s);
+    t              = select(b_point, zero, t);
+
+    // Aが点
+    float4 a_point = a <= eps;
+    s              = select(a_point, zero, s);
+    t              = select(a_point, select(b_point, zero, saturate(f / e_safe)), t);
+
+    // 最近接点
+    float4 c0[3], e0[3], diff[3];
+    for(u32 i = 0; i < 3; ++i) {
+        c0[i]   = p1[i] + d1[i] * s;
+        e0[i]   = p2[i] + d2[i] * t;
+        diff[i] = c0[i] - e0[i];
+    }
+
+    float4 dist2  = dot3(diff, diff);
+    float4 radius = ra + rb;
+    float4 hit    = dist2 < radius * radius;
+
+    // 押し戻し量
+    // 最近接点が重なっている場合はisHit()と同じくz方向へ押し出す (Aがカプセルなら-z、球なら+z)
+    float4 len       = sqrt(dist2);
+    float4 overlap   = len <= eps;
+    float4 scale     = (radius - len) / max(len, eps);
+    float4 overlap_z = select(a_point, radius, -radius);
+
+    alignas(16) f32 push[3][LANE_COUNT];
+    alignas(16) f32 position[3][LANE_COUNT];
+    alignas(16) f32 hits[LANE_COUNT];
+    for(u32 i = 0; i < 3; ++i) {
+        float4 overlap_push = (i == 2) ? overlap_z : zero;
+        store(select(overlap, overlap_push, diff[i] * scale), push[i]);
+        store((c0[i] + e0[i]) * float4(0.5f), position[i]);
+    }
+    store(hit, hits);
+
+    u32 mask = 0;
+    for(u32 lane = 0; lane < count_; ++lane) {
+        if(hits[lane] == 0.0f)
+            continue;
+
+        mask |= 1 << lane;
+        results[lane].push_         = float3(push[0][lane], push[1][lane], push[2][lane]);
+        results[lane].hit_position_ = float3(position[0][lane], position[1][lane], position[2][lane]);
+    }
+    return mask;
+}
+
+}   // namespace physics
@@ -0,0 +1,61 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	CollisionBatch.h
+//! @brief	球/カプセルの一括当たり判定 (SIMD)
+//---------------------------------------------------------------------------
+#pragma once
+
+namespace physics
+{
+
+//===========================================================================
+//! 球/カプセルの一括当たり判定
+//! @details 球は長さ0の線分として扱い、「線分+半径」同士の判定を4ペアずつfloat4で同時に行います。
+//!          ペアの形状はSoA(要素ごとの配列)で保持します。
+//===========================================================================
+class CollisionBatch
+{
+public:
+    static constexpr u32 LANE_COUNT = 4;   //!< 同時に判定するペア数
+
+    //! 判定結果
+    struct Result
+    {
+        float3 push_         = float3(0.0f, 0.0f, 0.0f);   //!< Aの押し戻し量 (A側100%)
+        float3 hit_position_ = float3(0.0f, 0.0f, 0.0f);   //!< 当たった地点 (最近接点の中間)
+    };
+
+    //! デフォルトコンストラクタ
+    CollisionBatch() = default;
+
+    //  ペアを追加
+    //! @param  [in]    a0  Aの線分始点 (球は中心)
+    //! @param  [in]    a1  Aの線分終点 (球は中心)
+    //! @param  [in]    ra  Aの半径
+    //! @param  [in]    b0  Bの線分始点 (球は中心)
+    //! @param  [in]    b1  Bの線分終点 (球は中心)
+    //! @param  [in]    rb  Bの半径
+    //! @retval true    バッチが満杯になった (test()してclear()してください)
+    bool add(const float3& a0, const float3& a1, f32 ra, const float3& b0, const float3& b1, f32 rb);
+
+    //  判定
+    //! @param  [out]   results 判定結果 (ヒットしたペアのみ有効)
+    //! @return ヒットしたペアのビットマスク (bit0 = 最初に追加したペア)
+    u32 test(Result (&results)[LANE_COUNT]) const;
+
+    //! 追加済みのペア数
+    u32 size() const { return count_; }
+
+    //! 空にする
+    void clear() { count_ = 0; }
+
+private:
+    alignas(16) f32 a0_[3][LANE_COUNT] = {};   //!< Aの線分始点 [xyz][ペア]
+    alignas(16) f32 a1_[3][LANE_COUNT] = {};   //!< Aの線分終点 [xyz][ペア]
+    alignas(16) f32 b0_[3][LANE_COUNT] = {};   //!< Bの線分始点 [xyz][ペア]
+    alignas(16) f32 b1_[3][LANE_COUNT] = {};   //!< Bの線分終点 [xyz][ペア]
+    alignas(16) f32 ra_[LANE_COUNT]    = {};   //!< Aの半径
+    alignas(16) f32 rb_[LANE_COUNT]    = {};   //!< Bの半径
+    u32             count_             = 0;    //!< 追加済みのペア数
+};
+
+}   // namespace physics
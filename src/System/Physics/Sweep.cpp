@@ -0,0 +1,101 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	Sweep.cpp
+//! @brief	連続的な当たり判定 (移動する球/カプセルの衝突時刻)
+//---------------------------------------------------------------------------
+#include "Sweep.h"
+
+#include <algorithm>
+
+namespace physics
+{
+namespace
+{
+//! 内積 (スカラー)
+f32 dot3(const float3& a, const float3& b)
+{
+    return dot(a, b).x;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 線分上の点が1フレームで移動する最大距離
+//! @details 両端を線形補間するため、線分上のどの点も両端の移動量の大きい方を超えません
+//---------------------------------------------------------------------------
+f32 SweptShape::maxMotion() const
+{
+    float3 d0 = to_p0_ - from_p0_;
+    float3 d1 = to_p1_ - from_p1_;
+    return std::sqrt(std::max(dot3(d0, d0), dot3(d1, d1)));
+}
+
+//---------------------------------------------------------------------------
+//! 線分同士の最近接点
+//! @see Real-Time Collision Detection 5.1.9
+//---------------------------------------------------------------------------
+f32 closestPointsSegmentSegment(
+    const float3& p1, const float3& q1, const float3& p2, const float3& q2, float3& c1, float3& c2)
+{
+    float3 d1 = q1 - p1;
+    float3 d2 = q2 - p2;
+    float3 r  = p1 - p2;
+    f32    a  = dot3(d1, d1);
+    f32    e  = dot3(d2, d2);
+    f32    f  = dot3(d2, r);
+    f32    s  = 0.0f;
+    f32    t  = 0.0f;
+
+    if(a <= FLT_EPSILON && e <= FLT_EPSILON) {
+        c1 = p1;
+        c2 = p2;
+        return dot3(c1 - c2, c1 - c2);
+    }
+    if(a <= FLT_EPSILON) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    }
+    else {
+        f32 c = dot3(d1, r);
+        if(e <= FLT_EPSILON) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else {
+            f32 b     = dot3(d1, d2);
+            f32 denom = a * e - b * b;
+            if(denom != 0.0f)
+                s = std::clamp((b * f - c * e) / denom, 0.0f, 1.0f);
+
+            t = (b * s + f) / e;
+            if(t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else if(t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+    return dot3(c1 - c2, c1 - c2);
+}
+
+//---------------------------------------------------------------------------
+//! 移動する形状同士の衝突時刻
+//---------------------------------------------------------------------------
+bool sweep(const SweptShape& a, const SweptShape& b, SweepHit& hit)
+{
+    // 相対的な接近速度は両方の移動量の和を超えない
+    f32 max_motion = a.maxMotion() + b.maxMotion();
+
+    return conservativeAdvance(
+        a.radius_ + b.radius_,
+        max_motion,
+        [&](f32 t, float3& on_a, float3& on_b) {
+            return std::sqrt(closestPointsSegmentSegment(a.p0(t), a.p1(t), b.p0(t), b.p1(t), on_a, on_b));
+        },
+        hit);
+}
+
+}   // namespace physics
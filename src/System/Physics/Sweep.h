@@ -0,0 +1,115 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	Sweep.h
+//! @brief	連続的な当たり判定 (移動する球/カプセルの衝突時刻)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+
+namespace physics
+{
+
+//! 移動する形状 (線分+半径)
+//! @details 球は始点と終点が同じ位置になります。線分の両端を前フレームから現在まで線形補間します
+struct SweptShape
+{
+    float3 from_p0_ = float3(0.0f, 0.0f, 0.0f);   //!< 前フレームの線分始点
+    float3 from_p1_ = float3(0.0f, 0.0f, 0.0f);   //!< 前フレームの線分終点
+    float3 to_p0_   = float3(0.0f, 0.0f, 0.0f);   //!< 現在の線分始点
+    float3 to_p1_   = float3(0.0f, 0.0f, 0.0f);   //!< 現在の線分終点
+    f32    radius_  = 0.0f;                       //!< 半径
+
+    //! 時刻tでの線分始点 (0.0:前フレーム ～ 1.0:現在)
+    float3 p0(f32 t) const { return from_p0_ + (to_p0_ - from_p0_) * t; }
+
+    //! 時刻tでの線分終点 (0.0:前フレーム ～ 1.0:現在)
+    float3 p1(f32 t) const { return from_p1_ + (to_p1_ - from_p1_) * t; }
+
+    //! 線分上の点が1フレームで移動する最大距離
+    f32 maxMotion() const;
+};
+
+//! 衝突結果
+struct SweepHit
+{
+    f32    time_     = 1.0f;                       //!< 衝突時刻 (0.0:前フレーム ～ 1.0:現在)
+    float3 position_ = float3(0.0f, 0.0f, 0.0f);   //!< 衝突位置 (最近接点の中間)
+    float3 normal_   = float3(0.0f, 1.0f, 0.0f);   //!< 衝突面の法線 (相手から自分への方向)
+};
+
+//  線分同士の最近接点
+//! @param  [in]    p1  線分1の始点
+//! @param  [in]    q1  線分1の終点
+//! @param  [in]    p2  線分2の始点
+//! @param  [in]    q2  線分2の終点
+//! @param  [out]   c1  線分1上の最近接点
+//! @param  [out]   c2  線分2上の最近接点
+//! @return 最近接点間の距離の2乗
+f32 closestPointsSegmentSegment(
+    const float3& p1, const float3& q1, const float3& p2, const float3& q2, float3& c1, float3& c2);
+
+//  移動する形状同士の衝突時刻
+//! @param  [in]    a   形状A
+//! @param  [in]    b   形状B
+//! @param  [out]   hit 衝突結果 (法線はBからAへの方向)
+//! @retval true    移動中に接触した
+//! @retval false   接触しない、または前フレームの時点ですでに重なっている
+bool sweep(const SweptShape& a, const SweptShape& b, SweepHit& hit);
+
+//  保守的前進法 (Conservative Advancement) による衝突時刻の算出
+//! @param  [in]    radius      接触とみなす距離 (半径の和)
+//! @param  [in]    max_motion  1フレームで形状間の距離が縮む最大量
+//! @param  [in]    distance    時刻tでの芯(線分/三角形)同士の距離 distance(t, 自分側の点, 相手側の点)
+//! @param  [inout] hit         衝突結果 (芯同士が接している場合、法線は元の値のままです)
+//! @retval true    移動中に接触した
+//! @retval false   接触しない、時刻0ですでに重なっている、または反復回数の上限までに収束しなかった
+//! @note   収束しなかった場合は接触を判定できていないため、呼び出し側は通常の判定に任せてください
+template <class Func>
+bool conservativeAdvance(f32 radius, f32 max_motion, Func&& distance, SweepHit& hit)
+{
+    constexpr u32 MAX_ITERATION = 32;      //!< 最大反復回数
+    constexpr f32 TOLERANCE     = 1e-3f;   //!< 接触とみなす隙間 (最小値)
+
+    if(max_motion <= 0.0f)
+        return false;
+
+    // かすめるような接近は収束が遅いため、半径の1%までの隙間は接触とみなす
+    f32 tolerance = std::max(TOLERANCE, radius * 0.01f);
+
+    // 時刻tで接触したとして結果を設定
+    auto set_hit = [&hit](f32 t, const float3& on_a, const float3& on_b) {
+        float3 vec = on_a - on_b;
+        f32    len = length(vec);
+
+        hit.time_     = t;
+        hit.position_ = (on_a + on_b) * 0.5f;
+        if(len > 1e-6f)
+            hit.normal_ = vec / len;
+    };
+
+    f32    t = 0.0f;
+    float3 on_a;
+    float3 on_b;
+    for(u32 i = 0; i < MAX_ITERATION; ++i) {
+        f32 gap = distance(t, on_a, on_b) - radius;
+        if(gap <= tolerance) {
+            // 移動前から重なっている場合は通常の判定に任せる
+            if(i == 0)
+                return false;
+
+            set_hit(t, on_a, on_b);
+            return true;
+        }
+
+        // 距離はmax_motion以上の速さでは縮まないため、隙間の分だけ安全に進められる
+        t += gap / max_motion;
+        if(t > 1.0f)
+            return false;
+    }
+
+    // 収束しなかった (かすめるように接近している)
+    // 隙間が残っている可能性があるため接触とはみなさず、通常の判定に任せる
+    return false;
+}
+
+}   // namespace physics
@@ -0,0 +1,585 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	TriangleBVH.cpp
+//! @brief	三角形BVH (静的メッシュの当たり判定)
+//---------------------------------------------------------------------------
+#include "TriangleBVH.h"
+#include "Sweep.h"
+
+#include <System/VectorMathBatch.h>
+
+#include <algorithm>
+
+namespace physics
+{
+namespace
+{
+constexpr u32 LEAF_TRIANGLES = 4;    //!< 葉に格納する最大三角形数
+constexpr u32 BIN_COUNT      = 8;    //!< SAH分割の候補数 (1軸あたり)
+constexpr u32 MAX_DEPTH      = 48;   //!< 最大の深さ (探索スタックの大きさに合わせる)
+constexpr u32 STACK_SIZE     = 64;   //!< 探索スタックの大きさ
+
+//! 内積 (スカラー)
+f32 dot3(const float3& a, const float3& b)
+{
+    return dot(a, b).x;
+}
+
+//! AABBの表面積 (の半分)
+f32 halfArea(const f32 (&aabb_min)[3], const f32 (&aabb_max)[3])
+{
+    f32 x = aabb_max[0] - aabb_min[0];
+    f32 y = aabb_max[1] - aabb_min[1];
+    f32 z = aabb_max[2] - aabb_min[2];
+    return x * y + y * z + z * x;
+}
+
+//! AABBを空にする
+void resetAABB(f32 (&aabb_min)[3], f32 (&aabb_max)[3])
+{
+    for(u32 i = 0; i < 3; ++i) {
+        aabb_min[i] = +FLT_MAX;
+        aabb_max[i] = -FLT_MAX;
+    }
+}
+
+//! AABBを拡張する
+void growAABB(f32 (&aabb_min)[3], f32 (&aabb_max)[3], const f32 (&add_min)[3], const f32 (&add_max)[3])
+{
+    for(u32 i = 0; i < 3; ++i) {
+        aabb_min[i] = std::min(aabb_min[i], add_min[i]);
+        aabb_max[i] = std::max(aabb_max[i], add_max[i]);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 三角形上の最近接点
+//! @see Real-Time Collision Detection 5.1.5
+//---------------------------------------------------------------------------
+float3 closestPointOnTriangle(const float3& p, const float3& a, const float3& b, const float3& c)
+{
+    float3 ab = b - a;
+    float3 ac = c - a;
+    float3 ap = p - a;
+    f32    d1 = dot3(ab, ap);
+    f32    d2 = dot3(ac, ap);
+    if(d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    float3 bp = p - b;
+    f32    d3 = dot3(ab, bp);
+    f32    d4 = dot3(ac, bp);
+    if(d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    f32 vc = d1 * d4 - d3 * d2;
+    if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+
+    float3 cp = p - c;
+    f32    d5 = dot3(ab, cp);
+    f32    d6 = dot3(ac, cp);
+    if(d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    f32 vb = d5 * d2 - d1 * d6;
+    if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+
+    f32 va = d3 * d6 - d5 * d4;
+    if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    f32 denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//---------------------------------------------------------------------------
+//! 線分と三角形の交差 (両面)
+//! @param  [out]   t   交差した線分上の位置 (0.0～1.0)
+//---------------------------------------------------------------------------
+bool intersectSegmentTriangle(
+    const float3& from, const float3& dir, const float3& a, const float3& b, const float3& c, f32& t)
+{
+    float3 e1  = b - a;
+    float3 e2  = c - a;
+    float3 p   = cross(dir, e2);
+    f32    det = dot3(e1, p);
+    if(std::abs(det) < 1e-12f)
+        return false;
+
+    f32    inv_det = 1.0f / det;
+    float3 s       = from - a;
+    f32    u       = dot3(s, p) * inv_det;
+    if(u < 0.0f || u > 1.0f)
+        return false;
+
+    float3 q = cross(s, e1);
+    f32    v = dot3(dir, q) * inv_det;
+    if(v < 0.0f || u + v > 1.0f)
+        return false;
+
+    t = dot3(e2, q) * inv_det;
+    return t >= 0.0f && t <= 1.0f;
+}
+
+//---------------------------------------------------------------------------
+//! 線分と三角形の最近接点
+//! @param  [out]   on_segment  線分上の最近接点
+//! @param  [out]   on_triangle 三角形上の最近接点
+//! @return 最近接点間の距離の2乗
+//---------------------------------------------------------------------------
+f32 closestPointsSegmentTriangle(const float3& p0,
+                                 const float3& p1,
+                                 const float3& a,
+                                 const float3& b,
+                                 const float3& c,
+                                 float3&       on_segment,
+                                 float3&       on_triangle)
+{
+    // 線分が三角形を貫通している
+    f32 t = 0.0f;
+    if(intersectSegmentTriangle(p0, p1 - p0, a, b, c, t)) {
+        on_segment  = p0 + (p1 - p0) * t;
+        on_triangle = on_segment;
+        return 0.0f;
+    }
+
+    // 端点と三角形
+    float3 q0    = closestPointOnTriangle(p0, a, b, c);
+    float3 q1    = closestPointOnTriangle(p1, a, b, c);
+    f32    best0 = dot3(p0 - q0, p0 - q0);
+    f32    best1 = dot3(p1 - q1, p1 - q1);
+    f32    best  = best0;
+    on_segment   = p0;
+    on_triangle  = q0;
+    if(best1 < best) {
+        best        = best1;
+        on_segment  = p1;
+        on_triangle = q1;
+    }
+
+    // 線分と三角形の辺
+    const float3* edges[3][2] = {{&a, &b}, {&b, &c}, {&c, &a}};
+    for(auto& edge : edges) {
+        float3 c1;
+        float3 c2;
+        f32    d = closestPointsSegmentSegment(p0, p1, *edge[0], *edge[1], c1, c2);
+        if(d < best) {
+            best        = d;
+            on_segment  = c1;
+            on_triangle = c2;
+        }
+    }
+    return best;
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+//! 構築
+//---------------------------------------------------------------------------
+void TriangleBVH::build(const std::vector<float3>& vertices, const std::vector<u32>& indices, const matrix& transform)
+{
+    clear();
+
+    u32 triangle_count = static_cast<u32>(indices.size() / 3);
+    if(triangle_count == 0)
+        return;
+
+    // 頂点をワールド空間へ変換
+    std::vector<float3> world(vertices.size());
+    simd::transformPoints(transform, vertices.data(), world.data(), vertices.size());
+
+    std::vector<BuildItem> items(triangle_count);
+    for(u32 i = 0; i < triangle_count; ++i) {
+        auto& item     = items[i];
+        item.triangle_ = i;
+        resetAABB(item.aabb_min_, item.aabb_max_);
+        for(u32 v = 0; v < 3; ++v) {
+            f32 p[3];
+            store(world[indices[i * 3 + v]], p);
+            growAABB(item.aabb_min_, item.aabb_max_, p, p);
+        }
+        for(u32 axis = 0; axis < 3; ++axis)
+            item.center_[axis] = (item.aabb_min_[axis] + item.aabb_max_[axis]) * 0.5f;
+    }
+
+    nodes_.reserve(triangle_count * 2 / LEAF_TRIANGLES + 1);
+    buildNode(items, 0, triangle_count, 0);
+
+    // 葉の並び順に三角形を詰め直す (探索時に連続したメモリを参照する)
+    positions_.resize(triangle_count * 3);
+    normals_.resize(triangle_count);
+    triangle_ids_.resize(triangle_count);
+    for(u32 i = 0; i < triangle_count; ++i) {
+        u32 id           = items[i].triangle_;
+        triangle_ids_[i] = id;
+
+        const float3& a = world[indices[id * 3 + 0]];
+        const float3& b = world[indices[id * 3 + 1]];
+        const float3& c = world[indices[id * 3 + 2]];
+
+        positions_[i * 3 + 0] = a;
+        positions_[i * 3 + 1] = b;
+        positions_[i * 3 + 2] = c;
+
+        float3 n   = cross(b - a, c - a);
+        f32    len = length(n).x;
+        normals_[i] = (len > 0.0f) ? n / len : float3(0.0f, 1.0f, 0.0f);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 解放
+//---------------------------------------------------------------------------
+void TriangleBVH::clear()
+{
+    nodes_.clear();
+    positions_.clear();
+    normals_.clear();
+    triangle_ids_.clear();
+}
+
+//---------------------------------------------------------------------------
+//! ノードを再帰的に分割
+//---------------------------------------------------------------------------
+u32 TriangleBVH::buildNode(std::vector<BuildItem>& items, u32 begin, u32 end, u32 depth)
+{
+    u32 node_index = static_cast<u32>(nodes_.size());
+    nodes_.emplace_back();
+
+    Node node{};
+    f32  center_min[3];
+    f32  center_max[3];
+    resetAABB(node.aabb_min_, node.aabb_max_);
+    resetAABB(center_min, center_max);
+    for(u32 i = begin; i < end; ++i) {
+        growAABB(node.aabb_min_, node.aabb_max_, items[i].aabb_min_, items[i].aabb_max_);
+        growAABB(center_min, center_max, items[i].center_, items[i].center_);
+    }
+
+    u32 count = end - begin;
+    if(count <= LEAF_TRIANGLES || depth >= MAX_DEPTH) {
+        node.offset_       = begin;
+        node.count_        = count;
+        nodes_[node_index] = node;
+        return node_index;
+    }
+
+    //----------------------------------------------------------
+    // SAH (Surface Area Heuristic) で分割位置を選択
+    //----------------------------------------------------------
+    u32 best_axis = 0;
+    u32 best_bin  = 0;
+    f32 best_cost = FLT_MAX;
+    for(u32 axis = 0; axis < 3; ++axis) {
+        f32 extent = center_max[axis] - center_min[axis];
+        if(extent <= 0.0f)
+            continue;
+
+        struct Bin
+        {
+            f32 aabb_min_[3];
+            f32 aabb_max_[3];
+            u32 count_ = 0;
+        } bins[BIN_COUNT];
+        for(auto& bin : bins)
+            resetAABB(bin.aabb_min_, bin.aabb_max_);
+
+        f32 scale = BIN_COUNT / extent;
+        for(u32 i = begin; i < end; ++i) {
+            u32 b = std::min(static_cast<u32>((items[i].center_[axis] - center_min[axis]) * scale), BIN_COUNT - 1);
+            growAABB(bins[b].aabb_min_, bins[b].aabb_max_, items[i].aabb_min_, items[i].aabb_max_);
+            bins[b].count_++;
+        }
+
+        // 左右から累積した面積×個数
+        f32 left_cost[BIN_COUNT - 1];
+        f32 aabb_min[3];
+        f32 aabb_max[3];
+        u32 sum = 0;
+        resetAABB(aabb_min, aabb_max);
+        for(u32 b = 0; b < BIN_COUNT - 1; ++b) {
+            sum += bins[b].count_;
+            if(bins[b].count_)
+                growAABB(aabb_min, aabb_max, bins[b].aabb_min_, bins[b].aabb_max_);
+            left_cost[b] = sum ? halfArea(aabb_min, aabb_max) * sum : 0.0f;
+        }
+
+        sum = 0;
+        resetAABB(aabb_min, aabb_max);
+        for(u32 b = BIN_COUNT - 1; b > 0; --b) {
+            sum += bins[b].count_;
+            if(bins[b].count_)
+                growAABB(aabb_min, aabb_max, bins[b].aabb_min_, bins[b].aabb_max_);
+
+            f32 cost = left_cost[b - 1] + (sum ? halfArea(aabb_min, aabb_max) * sum : 0.0f);
+            if(cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin  = b;
+            }
+        }
+    }
+
+    u32 middle = begin;
+    if(best_cost < FLT_MAX) {
+        f32  scale = BIN_COUNT / (center_max[best_axis] - center_min[best_axis]);
+        auto itr   = std::partition(items.begin() + begin, items.begin() + end, [&](const BuildItem& item) {
+            u32 b = std::min(static_cast<u32>((item.center_[best_axis] - center_min[best_axis]) * scale), BIN_COUNT - 1);
+            return b < best_bin;
+        });
+        middle = static_cast<u32>(itr - items.begin());
+    }
+
+    // 分割できない場合は中央で分ける
+    if(middle == begin || middle == end) {
+        middle = begin + count / 2;
+    }
+
+    buildNode(items, begin, middle, depth + 1);
+    node.offset_       = buildNode(items, middle, end, depth + 1);
+    node.count_        = 0;
+    nodes_[node_index] = node;
+    return node_index;
+}
+
+//---------------------------------------------------------------------------
+//! AABBと交差するノードの葉をたどる
+//---------------------------------------------------------------------------
+template <class Func>
+void TriangleBVH::traverse(const f32 (&aabb_min)[3], const f32 (&aabb_max)[3], Func&& func) const
+{
+    if(nodes_.empty())
+        return;
+
+    u32 stack[STACK_SIZE];
+    u32 sp      = 0;
+    stack[sp++] = 0;
+
+    while(sp) {
+        const Node& node = nodes_[stack[--sp]];
+
+        if(node.aabb_min_[0] > aabb_max[0] || node.aabb_max_[0] < aabb_min[0] || node.aabb_min_[1] > aabb_max[1] ||
+           node.aabb_max_[1] < aabb_min[1] || node.aabb_min_[2] > aabb_max[2] || node.aabb_max_[2] < aabb_min[2])
+            continue;
+
+        if(node.count_) {
+            for(u32 i = 0; i < node.count_; ++i)
+                func(node.offset_ + i);
+            continue;
+        }
+
+        u32 left    = static_cast<u32>(&node - nodes_.data()) + 1;
+        stack[sp++] = node.offset_;
+        stack[sp++] = left;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 線分との交差判定
+//---------------------------------------------------------------------------
+bool TriangleBVH::raycast(const float3& from, const float3& to, RayHit& hit) const
+{
+    if(nodes_.empty())
+        return false;
+
+    float3 dir = to - from;
+
+    f32 origin[3];
+    f32 inv_dir[3];
+    store(from, origin);
+    store(dir, inv_dir);
+    for(u32 i = 0; i < 3; ++i)
+        inv_dir[i] = (inv_dir[i] != 0.0f) ? 1.0f / inv_dir[i] : FLT_MAX;
+
+    f32 best     = FLT_MAX;
+    u32 best_tri = 0;
+
+    // スラブ法でAABBとの交差区間の入口を求める (交差しない場合はFLT_MAX)
+    auto intersectNode = [&](const Node& node) {
+        f32 t_min = 0.0f;
+        f32 t_max = std::min(best, 1.0f);
+        for(u32 i = 0; i < 3; ++i) {
+            f32 t0 = (node.aabb_min_[i] - origin[i]) * inv_dir[i];
+            f32 t1 = (node.aabb_max_[i] - origin[i]) * inv_dir[i];
+            if(t0 > t1)
+                std::swap(t0, t1);
+            t_min = std::max(t_min, t0);
+            t_max = std::min(t_max, t1);
+        }
+        return (t_min <= t_max) ? t_min : FLT_MAX;
+    };
+
+    u32 stack[STACK_SIZE];
+    u32 sp = 0;
+    if(intersectNode(nodes_[0]) != FLT_MAX)
+        stack[sp++] = 0;
+
+    while(sp) {
+        const Node& node = nodes_[stack[--sp]];
+
+        if(node.count_) {
+            for(u32 i = node.offset_; i < node.offset_ + node.count_; ++i) {
+                f32 t = 0.0f;
+                if(intersectSegmentTriangle(from, dir, positions_[i * 3 + 0], positions_[i * 3 + 1], positions_[i * 3 + 2], t) &&
+                   t < best) {
+                    best     = t;
+                    best_tri = i;
+                }
+            }
+            continue;
+        }
+
+        // 始点に近い子を先に探索する
+        u32 left    = static_cast<u32>(&node - nodes_.data()) + 1;
+        u32 right   = node.offset_;
+        f32 t_left  = intersectNode(nodes_[left]);
+        f32 t_right = intersectNode(nodes_[right]);
+        if(t_left > t_right) {
+            std::swap(left, right);
+            std::swap(t_left, t_right);
+        }
+        if(t_right != FLT_MAX)
+            stack[sp++] = right;
+        if(t_left != FLT_MAX)
+            stack[sp++] = left;
+    }
+
+    if(best == FLT_MAX)
+        return false;
+
+    hit.fraction_ = best;
+    hit.position_ = from + dir * best;
+    hit.normal_   = normals_[best_tri];
+    hit.triangle_ = triangle_ids_[best_tri];
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 接触点を作成
+//---------------------------------------------------------------------------
+void TriangleBVH::addContact(
+    size_t index, const float3& point, const float3& closest, f32 radius, Contacts& contacts) const
+{
+    float3 vec      = point - closest;
+    f32    distance = length(vec).x;
+
+    Contact contact;
+    contact.position_    = closest;
+    contact.normal_      = normals_[index];
+    contact.penetration_ = radius - distance;
+    contact.triangle_    = triangle_ids_[index];
+
+    // 中心が面上にある場合は法線方向へ押し出す
+    contact.direction_ = (distance > 1e-6f) ? vec / distance : normals_[index];
+
+    contacts.emplace_back(contact);
+}
+
+//---------------------------------------------------------------------------
+//! 球との接触判定
+//---------------------------------------------------------------------------
+size_t TriangleBVH::overlapSphere(const float3& center, f32 radius, Contacts& contacts) const
+{
+    size_t count = contacts.size();
+
+    f32 c[3];
+    store(center, c);
+    f32 aabb_min[3] = {c[0] - radius, c[1] - radius, c[2] - radius};
+    f32 aabb_max[3] = {c[0] + radius, c[1] + radius, c[2] + radius};
+
+    f32 radius_sq = radius * radius;
+    traverse(aabb_min, aabb_max, [&](u32 i) {
+        float3 closest = closestPointOnTriangle(center, positions_[i * 3 + 0], positions_[i * 3 + 1], positions_[i * 3 + 2]);
+        float3 vec     = center - closest;
+        if(dot3(vec, vec) <= radius_sq)
+            addContact(i, center, closest, radius, contacts);
+    });
+
+    return contacts.size() - count;
+}
+
+//---------------------------------------------------------------------------
+//! カプセルとの接触判定
+//---------------------------------------------------------------------------
+size_t TriangleBVH::overlapCapsule(const float3& p0, const float3& p1, f32 radius, Contacts& contacts) const
+{
+    size_t count = contacts.size();
+
+    f32 a[3];
+    f32 b[3];
+    store(p0, a);
+    store(p1, b);
+    f32 aabb_min[3];
+    f32 aabb_max[3];
+    for(u32 i = 0; i < 3; ++i) {
+        aabb_min[i] = std::min(a[i], b[i]) - radius;
+        aabb_max[i] = std::max(a[i], b[i]) + radius;
+    }
+
+    f32 radius_sq = radius * radius;
+    traverse(aabb_min, aabb_max, [&](u32 i) {
+        float3 on_segment;
+        float3 on_triangle;
+        f32    d = closestPointsSegmentTriangle(p0,
+                                             p1,
+                                             positions_[i * 3 + 0],
+                                             positions_[i * 3 + 1],
+                                             positions_[i * 3 + 2],
+                                             on_segment,
+                                             on_triangle);
+        if(d <= radius_sq)
+            addContact(i, on_segment, on_triangle, radius, contacts);
+    });
+
+    return contacts.size() - count;
+}
+
+//---------------------------------------------------------------------------
+//! 移動する形状との衝突時刻
+//---------------------------------------------------------------------------
+bool TriangleBVH::sweep(const SweptShape& shape, SweepHit& hit) const
+{
+    // 移動範囲全体を囲むAABB
+    f32 points[4][3];
+    store(shape.from_p0_, points[0]);
+    store(shape.from_p1_, points[1]);
+    store(shape.to_p0_, points[2]);
+    store(shape.to_p1_, points[3]);
+    f32 aabb_min[3];
+    f32 aabb_max[3];
+    for(u32 i = 0; i < 3; ++i) {
+        aabb_min[i] = std::min({points[0][i], points[1][i], points[2][i], points[3][i]}) - shape.radius_;
+        aabb_max[i] = std::max({points[0][i], points[1][i], points[2][i], points[3][i]}) + shape.radius_;
+    }
+
+    f32  max_motion = shape.maxMotion();
+    bool found      = false;
+    traverse(aabb_min, aabb_max, [&](u32 i) {
+        const float3& a = positions_[i * 3 + 0];
+        const float3& b = positions_[i * 3 + 1];
+        const float3& c = positions_[i * 3 + 2];
+
+        // 芯が面上で接触した場合は三角形の法線を使う
+        SweepHit triangle_hit;
+        triangle_hit.normal_ = normals_[i];
+
+        bool contact = conservativeAdvance(
+            shape.radius_,
+            max_motion,
+            [&](f32 t, float3& on_shape, float3& on_triangle) {
+                return std::sqrt(closestPointsSegmentTriangle(shape.p0(t), shape.p1(t), a, b, c, on_shape, on_triangle));
+            },
+            triangle_hit);
+
+        // 最も早く接触した三角形を返す
+        if(contact && (!found || triangle_hit.time_ < hit.time_)) {
+            hit   = triangle_hit;
+            found = true;
+        }
+    });
+    return found;
+}
+
+}   // namespace physics
@@ -0,0 +1,158 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	TriangleBVH.h
+//! @brief	三角形BVH (静的メッシュの当たり判定)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+
+#include "Sweep.h"
+
+namespace physics
+{
+
+//===========================================================================
+//! 三角形BVH
+//! @details 静的メッシュの三角形をAABB階層で分割し、線分/球/カプセルとの判定を高速化します。
+//!          構築後は読み取りのみのため、複数スレッドから同時に問い合わせできます。
+//===========================================================================
+class TriangleBVH
+{
+public:
+    //! 線分の交差結果
+    struct RayHit
+    {
+        float3 position_ = float3(0.0f, 0.0f, 0.0f);   //!< 交差位置
+        float3 normal_   = float3(0.0f, 1.0f, 0.0f);   //!< 三角形の法線
+        f32    fraction_ = 1.0f;                       //!< 線分上の位置 (0.0:始点 ～ 1.0:終点)
+        u32    triangle_ = 0;                          //!< 三角形番号 (構築時のインデックス順)
+    };
+
+    //! 接触点 (球/カプセルと三角形の最近接点)
+    struct Contact
+    {
+        float3 position_    = float3(0.0f, 0.0f, 0.0f);   //!< 三角形上の最近接点
+        float3 normal_      = float3(0.0f, 1.0f, 0.0f);   //!< 三角形の法線
+        float3 direction_   = float3(0.0f, 1.0f, 0.0f);   //!< 三角形から形状中心への押し出し方向
+        f32    penetration_ = 0.0f;                       //!< めり込み量
+        u32    triangle_    = 0;                          //!< 三角形番号 (構築時のインデックス順)
+    };
+
+    //! 接触点の一覧 (コンタクトマニフォールド)
+    using Contacts = std::vector<Contact>;
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //! デフォルトコンストラクタ
+    TriangleBVH() = default;
+
+    //  構築
+    //! @param  [in]    vertices    頂点配列
+    //! @param  [in]    indices     インデックス配列 (3つで1三角形)
+    //! @param  [in]    transform   頂点に適用する行列 (ワールド行列)
+    void build(const std::vector<float3>& vertices,
+               const std::vector<u32>&    indices,
+               const matrix&              transform = matrix::identity());
+
+    //  解放
+    void clear();
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   判定 (スレッドセーフ)
+    //----------------------------------------------------------
+    //@{
+
+    //  線分との交差判定 (始点に最も近い交差点を返します)
+    //! @param  [in]    from    始点
+    //! @param  [in]    to      終点
+    //! @param  [out]   hit     交差結果
+    //! @retval true    交差あり
+    bool raycast(const float3& from, const float3& to, RayHit& hit) const;
+
+    //  球との接触判定
+    //! @param  [in]    center      中心座標
+    //! @param  [in]    radius      半径
+    //! @param  [out]   contacts    接触点 (末尾に追加されます)
+    //! @return 追加した接触点の数
+    size_t overlapSphere(const float3& center, f32 radius, Contacts& contacts) const;
+
+    //  カプセルとの接触判定
+    //! @param  [in]    p0          線分の始点
+    //! @param  [in]    p1          線分の終点
+    //! @param  [in]    radius      半径
+    //! @param  [out]   contacts    接触点 (末尾に追加されます)
+    //! @return 追加した接触点の数
+    size_t overlapCapsule(const float3& p0, const float3& p1, f32 radius, Contacts& contacts) const;
+
+    //  移動する球/カプセルとの衝突時刻
+    //! @param  [in]    shape   移動する形状
+    //! @param  [out]   hit     最も早く接触した三角形との衝突結果
+    //! @retval true    移動中に接触した (移動前から接触している三角形は対象外)
+    bool sweep(const SweptShape& shape, SweepHit& hit) const;
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //! 構築済みかどうか
+    bool isValid() const { return !nodes_.empty(); }
+
+    //! 三角形数を取得
+    size_t triangleCount() const { return triangle_ids_.size(); }
+
+    //! ノード数を取得
+    size_t nodeCount() const { return nodes_.size(); }
+
+    //! 三角形の頂点を取得 (BVH内の並び順)
+    //! @param  [in]    index   BVH内の三角形番号
+    //! @param  [in]    vertex  頂点番号 (0～2)
+    const float3& vertex(size_t index, u32 vertex) const { return positions_[index * 3 + vertex]; }
+
+    //@}
+
+private:
+    //! ノード (32byte)
+    struct Node
+    {
+        f32 aabb_min_[3];   //!< AABB最小値
+        u32 offset_;        //!< 葉:最初の三角形番号 / 節:右の子ノード番号 (左の子は直後)
+        f32 aabb_max_[3];   //!< AABB最大値
+        u32 count_;         //!< 葉:三角形数 / 節:0
+    };
+
+    //! 構築用の三角形情報
+    struct BuildItem
+    {
+        f32 aabb_min_[3];   //!< AABB最小値
+        f32 aabb_max_[3];   //!< AABB最大値
+        f32 center_[3];     //!< AABB中心
+        u32 triangle_;      //!< 三角形番号
+    };
+
+    //! ノードを再帰的に分割
+    u32 buildNode(std::vector<BuildItem>& items, u32 begin, u32 end, u32 depth);
+
+    //! AABBと交差するノードの葉をたどる
+    //! @param  [in]    aabb_min    判定AABB最小値
+    //! @param  [in]    aabb_max    判定AABB最大値
+    //! @param  [in]    func        葉の三角形ごとの処理 func(BVH内の三角形番号)
+    template <class Func>
+    void traverse(const f32 (&aabb_min)[3], const f32 (&aabb_max)[3], Func&& func) const;
+
+    //! 接触点を作成
+    void addContact(size_t index, const float3& point, const float3& closest, f32 radius, Contacts& contacts) const;
+
+private:
+    std::vector<Node>   nodes_;          //!< ノード (深さ優先順)
+    std::vector<float3> positions_;      //!< 三角形の頂点 (葉の並び順で3頂点ずつ)
+    std::vector<float3> normals_;        //!< 三角形の法線
+    std::vector<u32>    triangle_ids_;   //!< 構築時の三角形番号
+};
+
+}   // namespace physics
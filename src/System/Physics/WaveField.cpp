@@ -0,0 +1,139 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	WaveField.cpp
+//! @brief	ハイトフィールドの波動シミュレーション
+//---------------------------------------------------------------------------
+#include "WaveField.h"
+
+#include <execution>
+
+namespace physics
+{
+
+//---------------------------------------------------------------------------
+// コンストラクタ
+//---------------------------------------------------------------------------
+WaveField::WaveField(u32 width, u32 height)
+{
+    resize(width, height);
+}
+
+//---------------------------------------------------------------------------
+// 格子サイズを変更
+//---------------------------------------------------------------------------
+void WaveField::resize(u32 width, u32 height)
+{
+    assert(width >= 3 && height >= 3);
+
+    width_  = width;
+    height_ = height;
+    current_.assign(width_ * height_, 0.0f);
+    previous_.assign(width_ * height_, 0.0f);
+
+    // 外周を除いた行を帯に分割
+    bands_.clear();
+    for(u32 y = 1; y < height_ - 1; y += BAND_ROWS)
+        bands_.push_back(y);
+
+    time_ = 0.0f;
+}
+
+//---------------------------------------------------------------------------
+// 波をリセット
+//---------------------------------------------------------------------------
+void WaveField::reset()
+{
+    std::fill(current_.begin(), current_.end(), 0.0f);
+    std::fill(previous_.begin(), previous_.end(), 0.0f);
+}
+
+//---------------------------------------------------------------------------
+// 経過時間分だけ固定ステップで進める
+//---------------------------------------------------------------------------
+u32 WaveField::update(f32 delta)
+{
+    time_ += delta;
+
+    u32 steps = 0;
+    while(time_ >= STEP_TIME && steps < MAX_STEPS) {
+        step();
+        time_ -= STEP_TIME;
+        ++steps;
+    }
+
+    // 処理が追いつかない分は捨てる (遅延が蓄積しないように)
+    if(steps == MAX_STEPS)
+        time_ = std::min(time_, STEP_TIME);
+    return steps;
+}
+
+//---------------------------------------------------------------------------
+// 1ステップ進める
+//---------------------------------------------------------------------------
+void WaveField::step()
+{
+    // 現在の高さは読み取りのみ、出力は各格子の1ステップ前の位置のみのため帯ごとに独立して計算できる
+    auto band = [&](u32 begin) { stepRows(begin, std::min(begin + BAND_ROWS, height_ - 1)); };
+    if(parallel_)
+        std::for_each(std::execution::par, bands_.begin(), bands_.end(), band);
+    else
+        std::for_each(bands_.begin(), bands_.end(), band);
+
+    // 計算結果が現在の高さになり、現在の高さが1ステップ前になる
+    std::swap(current_, previous_);
+}
+
+//---------------------------------------------------------------------------
+// 行の範囲を1ステップ進める
+//---------------------------------------------------------------------------
+void WaveField::stepRows(u32 begin, u32 end)
+{
+    // 波動方程式 有限差分法
+    // 波の高さの変化の加速度に定数を掛けたもの = 現在の波の高さに「ラプラシアンフィルタ」を掛けたものと等価
+    // +---+---+---+
+    // | 0 | 1 | 0 |
+    // +---+---+---+
+    // | 1 |-4 | 1 |
+    // +---+---+---+
+    // | 0 | 1 | 0 |
+    // +---+---+---+
+    //
+    // 次の高さ = 減衰 × (2 × 現在 - 減衰 × 1ステップ前 + 速度の2乗 × ラプラシアン)
+    // 1ステップ前の高さは減衰前の値で保持し、読み込み時に減衰を掛ける
+    const f32 center_scale = 2.0f - 4.0f * velocity2_;
+    const f32 v2           = velocity2_;
+    const f32 att          = attenuation_;
+
+    const float4 center_scale4(center_scale);
+    const float4 v2_4(v2);
+    const float4 att4(att);
+
+    for(u32 y = begin; y < end; ++y) {
+        f32*       out  = previous_.data() + y * width_;   // 1ステップ前の高さを読みながら上書きする
+        const f32* row  = current_.data() + y * width_;
+        const f32* up   = row - width_;
+        const f32* down = row + width_;
+
+        // 4格子ずつ計算
+        u32 x = 1;
+        for(; x + 4 <= width_ - 1; x += 4) {
+            float4 center, left, right, top, bottom, prev;
+            load(center, const_cast<f32*>(row + x));
+            load(left, const_cast<f32*>(row + x - 1));
+            load(right, const_cast<f32*>(row + x + 1));
+            load(top, const_cast<f32*>(up + x));
+            load(bottom, const_cast<f32*>(down + x));
+            load(prev, out + x);
+
+            float4 neighbor = (left + right) + (top + bottom);
+            store(att4 * (center_scale4 * center + v2_4 * neighbor - att4 * prev), out + x);
+        }
+
+        // 端数
+        for(; x < width_ - 1; ++x) {
+            f32 neighbor = (row[x - 1] + row[x + 1]) + (up[x] + down[x]);
+            out[x]       = att * (center_scale * row[x] + v2 * neighbor - att * out[x]);
+        }
+    }
+}
+
+}   // namespace physics
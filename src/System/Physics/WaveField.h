@@ -0,0 +1,108 @@
+﻿//---------------------------------------------------------------------------
+//!	@file	WaveField.h
+//! @brief	ハイトフィールドの波動シミュレーション
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+
+namespace physics
+{
+
+//===========================================================================
+//! ハイトフィールドの波動シミュレーション
+//! @details 2次元格子の高さを波動方程式(5点ラプラシアンの有限差分法)で更新します。
+//!          固定時間刻みで進め、行を帯に分けて並列に計算します。外周の格子は高さ0で固定です。
+//===========================================================================
+class WaveField
+{
+public:
+    static constexpr f32 STEP_TIME = 1.0f / 60.0f;   //!< 1ステップの時間 (固定)
+    static constexpr u32 MAX_STEPS = 4;              //!< 1回の更新で進める最大ステップ数
+    static constexpr u32 BAND_ROWS = 16;             //!< 並列計算の単位 (行数)
+
+    //----------------------------------------------------------
+    //! @name   初期化
+    //----------------------------------------------------------
+    //@{
+
+    //! デフォルトコンストラクタ
+    WaveField() = default;
+
+    //  コンストラクタ
+    //! @param  [in]    width   格子の幅
+    //! @param  [in]    height  格子の高さ
+    WaveField(u32 width, u32 height);
+
+    //  格子サイズを変更 (波はリセットされます)
+    //! @param  [in]    width   格子の幅 (3以上)
+    //! @param  [in]    height  格子の高さ (3以上)
+    void resize(u32 width, u32 height);
+
+    //  波をリセット
+    void reset();
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   更新
+    //----------------------------------------------------------
+    //@{
+
+    //  経過時間分だけ固定ステップで進める
+    //! @param  [in]    delta   経過時間
+    //! @return 実行したステップ数
+    //! @note MAX_STEPSを超える分は切り捨てます
+    u32 update(f32 delta);
+
+    //  1ステップ進める
+    void step();
+
+    //! 波の速さを設定 (速度の2乗 0.0f～0.5f)
+    void setVelocity2(f32 velocity2) { velocity2_ = std::clamp(velocity2, 0.0f, 0.5f); }
+
+    //! 減衰係数を設定 (1ステップごとに掛ける値)
+    void setAttenuation(f32 attenuation) { attenuation_ = attenuation; }
+
+    //! 並列計算するかどうかを設定
+    void setParallel(bool parallel) { parallel_ = parallel; }
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   参照
+    //----------------------------------------------------------
+    //@{
+
+    //! 高さを参照
+    f32& at(u32 x, u32 y) { return current_[y * width_ + x]; }
+
+    //! 高さを取得
+    f32 at(u32 x, u32 y) const { return current_[y * width_ + x]; }
+
+    //! 高さ配列を取得 (width × height)
+    const f32* heights() const { return current_.data(); }
+
+    //! 格子の幅を取得
+    u32 width() const { return width_; }
+
+    //! 格子の高さを取得
+    u32 height() const { return height_; }
+
+    //@}
+
+private:
+    //! 行の範囲を1ステップ進める
+    void stepRows(u32 begin, u32 end);
+
+private:
+    u32              width_       = 0;        //!< 格子の幅
+    u32              height_      = 0;        //!< 格子の高さ
+    f32              velocity2_   = 0.125f;   //!< 速度の2乗
+    f32              attenuation_ = 0.994f;   //!< 減衰係数
+    f32              time_        = 0.0f;     //!< 未処理の経過時間
+    bool             parallel_    = true;     //!< 並列計算するかどうか
+    std::vector<f32> current_;                //!< 現在の高さ
+    std::vector<f32> previous_;               //!< 1ステップ前の高さ (減衰前。次のステップの出力先)
+    std::vector<u32> bands_;                  //!< 帯の先頭行
+};
+
+}   // namespace physics
@@ -0,0 +1,445 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Profiler.cpp
+//! @brief  CPUプロファイラー (階層スコープ計測)
+//---------------------------------------------------------------------------
+#include "Profiler.h"
+
+#if defined(USE_PROFILER)
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(JPH_EXTERNAL_PROFILE)
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Profiler.h>
+#endif
+
+namespace profiler
+{
+namespace
+{
+
+constexpr size_t FRAME_HISTORY   = 300;        //!< 記録するフレーム数
+constexpr u32    THREAD_CAPACITY = 1u << 15;   //!< スレッドごとに1フレームで記録できる区間数 (2のべき乗)
+
+//--------------------------------------------------------------
+//! 1フレーム分の計測結果
+//--------------------------------------------------------------
+struct Frame
+{
+    u64               begin_ = 0;   //!< フレーム開始時間 (単位:ns)
+    u64               end_   = 0;   //!< フレーム終了時間 (単位:ns)
+    std::vector<Zone> zones_;       //!< 全スレッドの計測区間
+};
+
+//--------------------------------------------------------------
+//! スレッドごとの計測バッファ
+//! @details 書き込みは所有スレッドのみ、読み出しはendFrame()のみが行うリングバッファです。
+//!          区間の記録ごとにロックを取らないため、計測のオーバーヘッドが小さくなります。
+//--------------------------------------------------------------
+struct ThreadBuffer
+{
+    std::unique_ptr<Zone[]> zones_;        //!< フレーム内で終了した区間 (容量を超えた区間は破棄)
+    std::atomic<u32>        head_{0};      //!< 書き込み位置 (所有スレッドが更新)
+    std::atomic<u32>        tail_{0};      //!< 読み出し位置 (endFrame()が更新)
+    u32                     thread_ = 0;   //!< スレッド番号
+    u32                     depth_  = 0;   //!< 現在の階層の深さ
+
+    ThreadBuffer();
+    ~ThreadBuffer();
+};
+
+const std::thread::id main_thread_id = std::this_thread::get_id();   //!< 静的初期化はメインスレッドで行われる
+
+std::mutex                 threads_mutex;         //!< threads の排他
+std::vector<ThreadBuffer*> threads;               //!< 計測中の全スレッド
+std::atomic<u32>           thread_counter{0};     //!< ワーカースレッド番号の採番
+std::atomic<bool>          is_pause{false};       //!< 計測一時停止中
+u64                        frame_begin = 0;       //!< 現在フレームの開始時間
+std::array<Frame, FRAME_HISTORY> frames;          //!< フレームのリングバッファ
+size_t                     frame_head   = 0;      //!< 次に書き込む位置
+size_t                     frame_filled = 0;      //!< 記録済みフレーム数
+
+std::mutex                      names_mutex;   //!< names の排他
+std::unordered_set<std::string> names;         //!< 永続化した区間名
+
+thread_local ThreadBuffer thread_buffer;
+
+ThreadBuffer::ThreadBuffer()
+    : zones_(std::make_unique<Zone[]>(THREAD_CAPACITY))
+{
+    thread_ = (std::this_thread::get_id() == main_thread_id) ? 0 : ++thread_counter;
+
+    std::lock_guard lock(threads_mutex);
+    threads.push_back(this);
+}
+
+ThreadBuffer::~ThreadBuffer()
+{
+    std::lock_guard lock(threads_mutex);
+    threads.erase(std::remove(threads.begin(), threads.end(), this), threads.end());
+}
+
+//---------------------------------------------------------------------------
+//! 現在時間を取得 (単位:ns)
+//---------------------------------------------------------------------------
+u64 now()
+{
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+}
+
+//---------------------------------------------------------------------------
+//! 記録済みフレームを取得
+//! @param  [in]    index   0:最新フレーム 1:1フレーム前 ...
+//---------------------------------------------------------------------------
+const Frame& frame(size_t index)
+{
+    return frames[(frame_head + FRAME_HISTORY - 1 - index) % FRAME_HISTORY];
+}
+
+//---------------------------------------------------------------------------
+//! JSON文字列のエスケープ
+//---------------------------------------------------------------------------
+void writeJsonString(std::ofstream& file, const char* str)
+{
+    file << '"';
+    for(const char* p = str; *p; ++p) {
+        char c = *p;
+        if(c == '"' || c == '\\')
+            file << '\\' << c;
+        else if(static_cast<u8>(c) < 0x20)
+            file << ' ';
+        else
+            file << c;
+    }
+    file << '"';
+}
+
+//--------------------------------------------------------------
+//! 区間名ごとの集計結果
+//--------------------------------------------------------------
+struct ZoneStat
+{
+    const char* name_  = nullptr;   //!< 区間名
+    u32         count_ = 0;         //!< 呼び出し回数
+    u64         total_ = 0;         //!< 合計時間 (単位:ns)
+    u64         max_   = 0;         //!< 最大時間 (単位:ns)
+};
+
+}   // namespace
+
+//===========================================================================
+//  スコープ計測
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+ScopedZone::ScopedZone(const char* name)
+{
+    if(is_pause.load(std::memory_order_relaxed))
+        return;
+
+    name_  = name;
+    begin_ = now();
+    thread_buffer.depth_++;
+}
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+ScopedZone::~ScopedZone()
+{
+    if(name_ == nullptr)
+        return;
+
+    auto& buffer = thread_buffer;
+    buffer.depth_--;
+
+    u32 head = buffer.head_.load(std::memory_order_relaxed);
+    if(head - buffer.tail_.load(std::memory_order_acquire) >= THREAD_CAPACITY)
+        return;
+
+    buffer.zones_[head & (THREAD_CAPACITY - 1)] = Zone{name_, begin_, now(), buffer.thread_, buffer.depth_};
+    buffer.head_.store(head + 1, std::memory_order_release);
+}
+
+//===========================================================================
+//  フレーム制御
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! フレームの開始
+//---------------------------------------------------------------------------
+void beginFrame()
+{
+    frame_begin = now();
+}
+
+//---------------------------------------------------------------------------
+//! フレームの終了
+//---------------------------------------------------------------------------
+void endFrame()
+{
+    if(is_pause)
+        return;
+
+    Frame& f = frames[frame_head];
+    f.begin_ = frame_begin;
+    f.end_   = now();
+    f.zones_.clear();
+
+    {
+        // スレッドの登録/解除とのみ排他する。区間の記録とはロックを共有しない
+        std::lock_guard lock(threads_mutex);
+        for(auto* buffer : threads) {
+            u32 head = buffer->head_.load(std::memory_order_acquire);
+            u32 tail = buffer->tail_.load(std::memory_order_relaxed);
+            for(; tail != head; ++tail)
+                f.zones_.push_back(buffer->zones_[tail & (THREAD_CAPACITY - 1)]);
+            buffer->tail_.store(head, std::memory_order_release);
+        }
+    }
+
+    // スレッド順→開始時間順に並べる(親区間が子区間より前になる)
+    std::sort(f.zones_.begin(), f.zones_.end(), [](const Zone& a, const Zone& b) {
+        if(a.thread_ != b.thread_)
+            return a.thread_ < b.thread_;
+        if(a.begin_ != b.begin_)
+            return a.begin_ < b.begin_;
+        return a.depth_ < b.depth_;
+    });
+
+    frame_head   = (frame_head + 1) % FRAME_HISTORY;
+    frame_filled = std::min(frame_filled + 1, FRAME_HISTORY);
+}
+
+//---------------------------------------------------------------------------
+//! 計測の一時停止/再開
+//---------------------------------------------------------------------------
+void setPause(bool pause)
+{
+    is_pause = pause;
+}
+
+//===========================================================================
+//  参照
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 区間名を永続化
+//---------------------------------------------------------------------------
+const char* intern(std::string_view name)
+{
+    std::lock_guard lock(names_mutex);
+    return names.emplace(name).first->c_str();
+}
+
+//---------------------------------------------------------------------------
+//! 記録済みのフレーム数を取得
+//---------------------------------------------------------------------------
+size_t frameCount()
+{
+    return frame_filled;
+}
+
+//---------------------------------------------------------------------------
+//! 記録済みフレームの区間を取得
+//---------------------------------------------------------------------------
+const std::vector<Zone>& frameZones(size_t index)
+{
+    return frame(index).zones_;
+}
+
+//===========================================================================
+//  出力
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! Chromeトレース形式(JSON)で出力
+//---------------------------------------------------------------------------
+bool exportChromeTrace(std::string_view path, size_t frame_count)
+{
+    frame_count = std::min(frame_count, frame_filled);
+    if(frame_count == 0)
+        return false;
+
+    std::ofstream file(std::string(path), std::ios::out | std::ios::trunc);
+    if(!file)
+        return false;
+
+    u64  base  = frame(frame_count - 1).begin_;
+    auto to_us = [base](u64 ns) { return static_cast<f64>(ns - base) / 1000.0; };
+
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Main\"}}";
+
+    // 古いフレームから順に出力
+    for(size_t i = frame_count; i-- > 0;) {
+        const Frame& f = frame(i);
+
+        file << ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << to_us(f.begin_)
+             << ",\"dur\":" << to_us(f.end_) - to_us(f.begin_) << "}";
+
+        for(auto& zone : f.zones_) {
+            // 前フレームから継続していた区間は先頭を切り詰める
+            u64 begin = std::max(zone.begin_, base);
+
+            file << ",\n{\"name\":";
+            writeJsonString(file, zone.name_);
+            file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << zone.thread_ << ",\"ts\":" << to_us(begin)
+                 << ",\"dur\":" << to_us(zone.end_) - to_us(begin) << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+//---------------------------------------------------------------------------
+//! GUI表示
+//---------------------------------------------------------------------------
+void showGUI(bool* open)
+{
+    static int  select_frame = 0;    // 表示するフレーム (0:最新)
+    static int  top_count    = 20;   // 上位表示数
+    static bool pause        = false;
+
+    if(!ImGui::Begin(u8"プロファイラー", open)) {
+        ImGui::End();
+        return;
+    }
+
+    if(ImGui::Checkbox(u8"一時停止", &pause))
+        setPause(pause);
+    ImGui::SameLine();
+    if(ImGui::Button(u8"Chromeトレース出力"))
+        exportChromeTrace("profile.json", frame_filled);
+
+    if(frame_filled == 0) {
+        ImGui::End();
+        return;
+    }
+
+    //----------------------------------------------------------
+    // フレーム時間グラフ (古い順)
+    //----------------------------------------------------------
+    std::array<f32, FRAME_HISTORY> frame_ms{};
+    for(size_t i = 0; i < frame_filled; ++i) {
+        auto& f                         = frame(i);
+        frame_ms[frame_filled - 1 - i] = static_cast<f32>(f.end_ - f.begin_) / (1000.0f * 1000.0f);
+    }
+
+    if(ImPlot::BeginPlot(u8"フレーム時間(ms)", ImVec2(-1.0f, 96.0f), ImPlotFlags_NoInputs | ImPlotFlags_NoLegend)) {
+        ImPlot::SetupAxes(nullptr, nullptr, ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisLimits(ImAxis_X1, 0, static_cast<f64>(FRAME_HISTORY), ImGuiCond_Always);
+        ImPlot::PlotBars("frame", frame_ms.data(), static_cast<s32>(frame_filled));
+        ImPlot::EndPlot();
+    }
+
+    ImGui::SliderInt(u8"フレーム(0:最新)", &select_frame, 0, static_cast<s32>(frame_filled) - 1);
+    select_frame = std::clamp(select_frame, 0, static_cast<s32>(frame_filled) - 1);
+
+    const Frame& f = frame(select_frame);
+    ImGui::Text(u8"フレーム時間 : %.3f ms  区間数 : %d",
+                static_cast<f32>(f.end_ - f.begin_) / (1000.0f * 1000.0f),
+                static_cast<s32>(f.zones_.size()));
+
+    //----------------------------------------------------------
+    // 処理時間上位 (区間名ごとに集計)
+    //----------------------------------------------------------
+    ImGui::SliderInt(u8"上位表示数", &top_count, 1, 100);
+
+    std::unordered_map<const char*, ZoneStat> stat_map;
+    for(auto& zone : f.zones_) {
+        auto& stat = stat_map[zone.name_];
+        u64   time = zone.end_ - zone.begin_;
+        stat.name_ = zone.name_;
+        stat.count_++;
+        stat.total_ += time;
+        stat.max_ = std::max(stat.max_, time);
+    }
+
+    std::vector<ZoneStat> stats;
+    stats.reserve(stat_map.size());
+    for(auto& it : stat_map)
+        stats.push_back(it.second);
+
+    size_t top = std::min(static_cast<size_t>(top_count), stats.size());
+    std::partial_sort(stats.begin(), stats.begin() + top, stats.end(), [](const ZoneStat& a, const ZoneStat& b) {
+        return a.total_ > b.total_;
+    });
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+    if(ImGui::BeginTable("top", 4, table_flags, ImVec2(0.0f, 240.0f))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn(u8"区間名", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn(u8"回数");
+        ImGui::TableSetupColumn(u8"合計(ms)");
+        ImGui::TableSetupColumn(u8"最大(ms)");
+        ImGui::TableHeadersRow();
+
+        for(size_t i = 0; i < top; ++i) {
+            auto& stat = stats[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stat.name_);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stat.count_);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<f32>(stat.total_) / (1000.0f * 1000.0f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<f32>(stat.max_) / (1000.0f * 1000.0f));
+        }
+        ImGui::EndTable();
+    }
+
+    //----------------------------------------------------------
+    // 階層表示 (メインスレッド)
+    //----------------------------------------------------------
+    if(ImGui::TreeNode(u8"階層表示(メインスレッド)")) {
+        for(auto& zone : f.zones_) {
+            if(zone.thread_ != 0)
+                break;
+
+            ImGui::Indent(static_cast<f32>(zone.depth_) * 12.0f + 1.0f);
+            ImGui::Text("%s  %.3f ms", zone.name_, static_cast<f32>(zone.end_ - zone.begin_) / (1000.0f * 1000.0f));
+            ImGui::Unindent(static_cast<f32>(zone.depth_) * 12.0f + 1.0f);
+        }
+        ImGui::TreePop();
+    }
+
+    ImGui::End();
+}
+
+}   // namespace profiler
+
+//===========================================================================
+//  JoltPhysicsの計測区間を同じタイムラインへ統合
+//  JPH_EXTERNAL_PROFILE 定義時、JPH_PROFILE() はこのクラスを生成します
+//===========================================================================
+#if defined(JPH_EXTERNAL_PROFILE)
+
+static_assert(sizeof(profiler::ScopedZone) <= sizeof(JPH::uint8[64]), "mUserDataに収まりません");
+
+JPH::ExternalProfileMeasurement::ExternalProfileMeasurement(const char* inName, [[maybe_unused]] uint32 inColor)
+{
+    new(mUserData) profiler::ScopedZone(inName);
+}
+
+JPH::ExternalProfileMeasurement::~ExternalProfileMeasurement()
+{
+    reinterpret_cast<profiler::ScopedZone*>(mUserData)->~ScopedZone();
+}
+
+#endif   // JPH_EXTERNAL_PROFILE
+
+#endif   // USE_PROFILER
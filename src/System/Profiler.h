@@ -0,0 +1,122 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Profiler.h
+//! @brief  CPUプロファイラー (階層スコープ計測)
+//---------------------------------------------------------------------------
+#pragma once
+
+//---------------------------------------------------------------------------
+//! USE_PROFILER が定義されていない場合は全ての計測がコンパイル時に除去されます
+//! (premake5.lua にて Debug/Release(PROFILE) 構成のみ定義。出荷用のReleaseLTCGでは除去)
+//! 区間の記録はスレッドごとのバッファへロックなしで行います
+//---------------------------------------------------------------------------
+#if defined(USE_PROFILER)
+
+#include <string_view>
+#include <vector>
+
+namespace profiler
+{
+
+//--------------------------------------------------------------
+//! 計測区間 (1スコープ分)
+//--------------------------------------------------------------
+struct Zone
+{
+    const char* name_;     //!< 区間名 (intern()済みまたは静的文字列)
+    u64         begin_;    //!< 開始時間 (単位:ns)
+    u64         end_;      //!< 終了時間 (単位:ns)
+    u32         thread_;   //!< スレッド番号 (0:メインスレッド)
+    u32         depth_;    //!< 階層の深さ
+};
+
+//===========================================================================
+//! スコープ計測
+//! @details コンストラクタで計測を開始し、デストラクタで終了します
+//===========================================================================
+class ScopedZone
+{
+public:
+    // コンストラクタ
+    //! @param  [in]    name    区間名 (計測終了まで有効な文字列であること)
+    explicit ScopedZone(const char* name);
+
+    // デストラクタ
+    ~ScopedZone();
+
+    ScopedZone(const ScopedZone&)            = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    const char* name_  = nullptr;   //!< 区間名
+    u64         begin_ = 0;         //!< 開始時間 (単位:ns)
+};
+
+//--------------------------------------------------------------
+//! @name   フレーム制御
+//--------------------------------------------------------------
+//@{
+
+// フレームの開始
+void beginFrame();
+
+// フレームの終了
+//! @details 全スレッドの計測結果をリングバッファへ記録します
+void endFrame();
+
+// 計測の一時停止/再開
+void setPause(bool pause);
+
+//@}
+//--------------------------------------------------------------
+//! @name   参照
+//--------------------------------------------------------------
+//@{
+
+// 区間名を永続化
+//! @details 動的に生成した名前(型名など)を区間名として使う場合に使用します
+//!          登録した名前は解放されないため、生成ごとに変わる名前(オブジェクト名など)は使わないでください
+//! @return アプリケーション終了まで有効な文字列
+const char* intern(std::string_view name);
+
+// 記録済みのフレーム数を取得
+size_t frameCount();
+
+// 記録済みフレームの区間を取得
+//! @param  [in]    index   0:最新フレーム 1:1フレーム前 ...
+const std::vector<Zone>& frameZones(size_t index);
+
+//@}
+//--------------------------------------------------------------
+//! @name   出力
+//--------------------------------------------------------------
+//@{
+
+// Chromeトレース形式(JSON)で出力
+//! @param  [in]    path        出力ファイルパス
+//! @param  [in]    frame_count 出力するフレーム数 (最新フレームから)
+//! @note chrome://tracing または https://ui.perfetto.dev で表示できます
+bool exportChromeTrace(std::string_view path, size_t frame_count);
+
+// GUI表示 (フレーム時間グラフと処理時間上位の一覧)
+void showGUI(bool* open);
+
+//@}
+
+}   // namespace profiler
+
+#define PROFILE_TAG2(line) profile_zone_##line
+#define PROFILE_TAG(line)  PROFILE_TAG2(line)
+
+//! スコープ計測
+//! @param  [in]    name    区間名
+#define PROFILE_SCOPE(name) profiler::ScopedZone PROFILE_TAG(__LINE__)(name)
+
+//! 関数計測
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+
+#endif
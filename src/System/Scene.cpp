@@ -6,8 +6,11 @@
 #include <System/Component/ComponentCollision.h>
 #include <System/Debug/DebugCamera.h>
 #include <System/SystemMain.h>   // ResetDeltaTime
+#include <System/Profiler.h>
+#include <System/Physics/CollisionBatch.h>
 
 #include <algorithm>
+#include <array>
 
 //=============================================================
 // シーン ローカル変数
@@ -119,13 +122,41 @@ auto BindComponentProc(ProcTiming proc, ComponentPtr cmp)
 }
 #endif
 
+//! @brief 処理をプロファイラーの計測区間で包む
+//! @param name 計測区間名
+//! @param proc 処理
+//! @tparam T 処理の引数型 (Update/LateUpdateはfloat、それ以外はvoid)
+template <class T, class Func>
+Func ProfileProc([[maybe_unused]] const std::string& name, const Func& proc)
+{
+#if defined(USE_PROFILER)
+    const char* zone = profiler::intern(name);
+    if constexpr(std::is_same<T, float>{}) {
+        return [zone, proc](float delta) {
+            PROFILE_SCOPE(zone);
+            proc(delta);
+        };
+    }
+    else {
+        return [zone, proc]() {
+            PROFILE_SCOPE(zone);
+            proc();
+        };
+    }
+#else
+    return proc;
+#endif
+}
+
 ObjectWeakPtrVec leak_objs;
 
 }   // namespace
 
 Scene::BasePtr                 Scene::current_scene_ = nullptr;   //!< 現在のシーン
 Scene::BasePtr                 Scene::next_scene_    = nullptr;   //!< 変更シーン
+Scene::BasePtr                 Scene::preload_scene_ = nullptr;   //!< 先行読み込み中のシーン
 Scene::BasePtrMap              Scene::scenes_        = {};        //!< 存在する全シーン
+SceneCommandQueue              Scene::command_queue_;             //!< オブジェクト操作要求
 Status<Scene::EditorStatusBit> Scene::editor_status_;             //!< シーン状態
 float2                         Scene::inspector_size{300, 300};
 float2                         Scene::object_detail_size{300, 452};
@@ -337,6 +368,32 @@ void Scene::Base::UnregisterAll()
     signals_hdr_.disconnect_all();
 }
 
+//! 先行読み込みするモデルを登録します
+void Scene::Base::PreloadModel(std::string_view path)
+{
+    // モデルを保持している間はリソースが共有されるため、Init()での読み込みは待たずに済む
+    preload_assets_.push_back(std::make_shared<Model>(path));
+}
+
+//! 先行読み込みするテクスチャを登録します
+void Scene::Base::PreloadTexture(std::string_view path)
+{
+    if(auto texture = LoadTexture(path))
+        preload_assets_.push_back(texture);
+}
+
+//! 先行読み込みの進捗を取得します
+f32 Scene::Base::GetLoadProgress() const
+{
+    return preload_group_ ? GetStreamingManager().progress(preload_group_).ratio() : 1.0f;
+}
+
+//! 先行読み込みしたアセットが全て読み込み済みか?
+bool Scene::Base::IsLoaded() const
+{
+    return preload_group_ == 0 || GetStreamingManager().progress(preload_group_).isDone();
+}
+
 //! 同じシーンタイプがいないかチェックする
 bool Scene::Base::IsSceneExist(const BasePtr& scene)
 {
@@ -385,16 +442,20 @@ void Scene::Base::setProc(ObjectPtr obj, SlotProc<T> slot)
     assert(((slot.GetTiming() != ProcTiming::Update && slot.GetTiming() != ProcTiming::LateUpdate) && !is_float) ||
            ((slot.GetTiming() == ProcTiming::Update || slot.GetTiming() == ProcTiming::LateUpdate) && is_float));
 
+    // プロファイラーの計測区間名 (オブジェクト型::処理名)
+    // オブジェクト名は生成ごとに _N で一意化されるため、区間名に含めると intern() の登録が増え続けます
+    std::string zone = std::string(typeid(*obj).name()) + "::" + slot.GetName();
+
     // 設定したい優先に設定する
     if constexpr(std::is_same<T, float>{}) {
         auto& proc = obj->GetProc<T>(slot.GetName(), slot.GetTiming());
         proc.SetProc(slot.GetName(), slot.GetTiming(), slot.GetPriority(), slot.GetProc());
-        proc.connect_ = current_scene_->GetUpdateSignals(slot.GetTiming()).connect(proc.proc_);
+        proc.connect_ = current_scene_->GetUpdateSignals(slot.GetTiming()).connect(ProfileProc<T>(zone, proc.proc_));
     }
     else {
         auto& proc = obj->GetProc<T>(slot.GetName(), slot.GetTiming());
         proc.SetProc(slot.GetName(), slot.GetTiming(), slot.GetPriority(), slot.GetProc());
-        proc.connect_ = current_scene_->GetSignals(slot.GetTiming()).connect(proc.proc_);
+        proc.connect_ = current_scene_->GetSignals(slot.GetTiming()).connect(ProfileProc<T>(zone, proc.proc_));
     }
 }
 
@@ -442,12 +503,18 @@ void Scene::Base::setProc(ComponentPtr component, SlotProc<T> slot)
 
     proc.SetProc(slot.GetName(), slot.GetTiming(), slot.GetPriority(), slot.GetProc());
 
+    // プロファイラーの計測区間名 (コンポーネント型::処理名)
+    // 型と処理名の組み合わせのみのため、オブジェクトの生成/破棄を繰り返しても intern() の登録は増えません
+    std::string zone = std::string(typeid(*component).name()) + "::" + slot.GetName();
+
     // 設定したい優先に設定する
     if constexpr(std::is_same<T, float>{}) {
-        proc.connect_ = current_scene_->GetUpdateSignals(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
+        proc.connect_ = current_scene_->GetUpdateSignals(slot.GetTiming())
+                            .connect(ProfileProc<T>(zone, proc.proc_), (int)proc.priority_);
     }
     else {
-        proc.connect_ = current_scene_->GetSignals(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
+        proc.connect_ =
+            current_scene_->GetSignals(slot.GetTiming()).connect(ProfileProc<T>(zone, proc.proc_), (int)proc.priority_);
     }
 }
 
@@ -603,6 +670,81 @@ void Scene::ReleaseObject(ObjectPtr obj)
         obj->SetStatus(Object::StatusBit::Alive, false);
 }
 
+//=============================================================
+// スレッドセーフなオブジェクト操作
+//=============================================================
+void Scene::ReleaseObjectDeferred(ObjectWeakPtr obj)
+{
+    auto* command    = command_queue_.Allocate();
+    command->type_   = SceneCommand::Type::Release;
+    command->object_ = std::move(obj);
+    command_queue_.Push(command);
+}
+
+void Scene::SetStatusDeferred(ObjectWeakPtr obj, Object::StatusBit b, bool on)
+{
+    auto* command    = command_queue_.Allocate();
+    command->type_   = SceneCommand::Type::SetStatus;
+    command->object_ = std::move(obj);
+    command->status_ = b;
+    command->on_     = on;
+    command_queue_.Push(command);
+}
+
+void Scene::SetPriorityDeferred(ObjectWeakPtr obj, ProcTiming timing, Priority priority)
+{
+    auto* command      = command_queue_.Allocate();
+    command->type_     = SceneCommand::Type::SetPriority;
+    command->object_   = std::move(obj);
+    command->timing_   = timing;
+    command->priority_ = priority;
+    command_queue_.Push(command);
+}
+
+void Scene::SetMatrixDeferred(ObjectWeakPtr obj, const matrix& mat)
+{
+    auto* command    = command_queue_.Allocate();
+    command->type_   = SceneCommand::Type::SetMatrix;
+    command->object_ = std::move(obj);
+    command->matrix_ = mat;
+    command_queue_.Push(command);
+}
+
+void Scene::executeCommands()
+{
+    PROFILE_SCOPE("Scene::Commands");
+
+    command_queue_.Drain([](SceneCommand& command) {
+        if(command.type_ == SceneCommand::Type::Create) {
+            if(command.create_)
+                command.create_(command, true);
+            return;
+        }
+
+        // 反映前に削除されたオブジェクトは無視する
+        auto obj = command.object_.lock();
+        if(!obj)
+            return;
+
+        switch(command.type_) {
+        case SceneCommand::Type::Release:
+            ReleaseObject(obj);
+            break;
+        case SceneCommand::Type::SetStatus:
+            obj->SetStatus(command.status_, command.on_);
+            break;
+        case SceneCommand::Type::SetPriority:
+            current_scene_->SetPriority(obj, command.timing_, command.priority_);
+            break;
+        case SceneCommand::Type::SetMatrix:
+            obj->SetMatrix(command.matrix_);
+            break;
+        default:
+            break;
+        }
+    });
+}
+
 //! 次のシーンをセットする
 void Scene::SetNextScene(BasePtr scene)
 {
@@ -670,6 +812,22 @@ void Scene::ChangeNextScene()
         }
     }
 
+    // 先行して作成したシーンは作成時の名前リストを引き継ぎ、カメラが無くなっていれば切り替える
+    if(current_scene_ && current_scene_->preload_constructed_) {
+        Object::SwapObjectNames(current_scene_->preload_names_);
+        current_scene_->preload_names_       = {};
+        current_scene_->preload_constructed_ = false;
+
+        if(ComponentCamera::GetCurrentCamera().expired()) {
+            for(auto& obj : current_scene_->pre_objects_) {
+                if(auto camera = obj->GetComponent<ComponentCamera>()) {
+                    camera->SetCurrentCamera();
+                    break;
+                }
+            }
+        }
+    }
+
     next_scene_       = nullptr;
     scene_change_next = false;
 
@@ -693,6 +851,17 @@ void Scene::Init()
 
 void Scene::Change(BasePtr scene)
 {
+    // 先行読み込み中のシーンは全て読み込み済みになってから切り替える (PreUpdate()で切り替え)
+    if(scene && preload_scene_ && scene->Name() == preload_scene_->Name()) {
+        if(!preload_scene_->IsLoaded()) {
+            preload_scene_->preload_change_ = true;
+            return;
+        }
+        scene = preload_scene_;
+        endPreload(*scene);
+        preload_scene_ = nullptr;
+    }
+
     // すでに存在している?
     if(scene && Base::IsSceneExist(scene)) {
         // とらえているシーンに切り替える
@@ -703,14 +872,109 @@ void Scene::Change(BasePtr scene)
     SetNextScene(scene);
 }
 
+//! シーンの先行読み込みを開始します
+void Scene::Preload(BasePtr scene, bool construct)
+{
+    if(!scene)
+        return;
+
+    // すでに存在している場合はそのシーンを読み込む
+    if(Base::IsSceneExist(scene))
+        scene = scenes_[scene->Name()];
+
+    if(scene == current_scene_ || scene == preload_scene_)
+        return;
+
+    // 先行読み込みは1シーンのみ
+    CancelPreload();
+
+    preload_scene_        = scene;
+    scene->preload_group_ = GetStreamingManager().createGroup();
+
+    // ここで要求/共有された読み込みをシーンの進捗として集計する
+    StreamingManager::GroupScope scope(scene->preload_group_);
+    scene->Preload();
+
+    if(construct && !scene->GetStatus(Base::StatusBit::Initialized)) {
+        // Init()で作成されたオブジェクトは仮登録のまま保持し、切り替え時に本登録する
+        auto current   = current_scene_;
+        current_scene_ = scene;
+        Object::SwapObjectNames(scene->preload_names_);
+
+        bool initialized = scene->Init();
+        scene->SetStatus(Base::StatusBit::Initialized, initialized);
+        scene->preload_constructed_ = true;
+
+        Object::SwapObjectNames(scene->preload_names_);
+        current_scene_ = current;
+    }
+}
+
+//! 先行読み込みを取り消します
+void Scene::CancelPreload()
+{
+    if(!preload_scene_)
+        return;
+
+    auto scene     = preload_scene_;
+    preload_scene_ = nullptr;
+    endPreload(*scene);
+
+    // 他で参照されていない読み込み途中のモデルは読み込みも取り消される
+    scene->preload_assets_.clear();
+
+    if(scene->preload_constructed_) {
+        // 先行して作成したオブジェクトを破棄し、次回はInit()からやり直す
+        auto current   = current_scene_;
+        current_scene_ = scene;
+        Object::SwapObjectNames(scene->preload_names_);
+
+        for(auto& obj : scene->pre_objects_) {
+            obj->Exit();
+            obj->RemoveAllComponents();
+            obj->ModifyComponents();
+            obj->RemoveAllProcesses();
+        }
+        scene->pre_objects_.clear();
+        scene->Exit();
+        scene->SetStatus(Base::StatusBit::Initialized, false);
+        scene->preload_constructed_ = false;
+
+        Object::SwapObjectNames(scene->preload_names_);
+        scene->preload_names_ = {};
+        current_scene_        = current;
+    }
+}
+
+//! 先行読み込み中のシーンを取得します
+Scene::Base* Scene::GetPreloadScene()
+{
+    return preload_scene_.get();
+}
+
+void Scene::endPreload(Base& scene)
+{
+    if(scene.preload_group_)
+        GetStreamingManager().releaseGroup(scene.preload_group_);
+
+    scene.preload_group_  = 0;
+    scene.preload_change_ = false;
+}
+
 void Scene::PreUpdate()
 {
+    PROFILE_SCOPE("Scene::PreUpdate");
+
     if(IsKeyOn(KEY_INPUT_F1))
         scene_pause = !scene_pause;
 
     if(IsKeyOn(KEY_INPUT_F2))
         scene_step = true;
 
+    // 先行読み込みが完了したシーンへ切り替え (読み込み中は現在のシーンを続ける)
+    if(preload_scene_ && preload_scene_->preload_change_ && preload_scene_->IsLoaded())
+        Change(preload_scene_);
+
     if(next_scene_ != nullptr || scene_change_next) {
         // シーン切り替え
         current_scene_->Exit();
@@ -735,6 +999,12 @@ void Scene::PreUpdate()
         if(!current_scene_->GetStatus(Scene::Base::StatusBit::Initialized))
             return;
 
+        // 先行読み込みしたアセットはInit()で共有されたため手放す
+        current_scene_->preload_assets_.clear();
+
+        // 他スレッドから要求されたオブジェクト操作を反映 (作成されたものは以下で本登録される)
+        executeCommands();
+
         // オブジェクト仮登録しているものを本登録に変更
         for(auto obj : current_scene_->pre_objects_) {
             auto& proc_update = obj->GetProc<float>(GetProcTimingName(ProcTiming::Update), ProcTiming::Update);
@@ -888,6 +1158,7 @@ void Scene::PreUpdate()
             }
 #endif
         }
+        PROFILE_SCOPE("PreUpdate");
         current_scene_->GetSignals(ProcTiming::PreUpdate)();
     }
 }
@@ -895,35 +1166,58 @@ void Scene::PreUpdate()
 //! 更新処理
 void Scene::Update(float delta)
 {
+    PROFILE_SCOPE("Scene::Update");
+
     if(current_scene_) {
         if(!scene_pause || scene_step) {
             current_scene_->Update(delta);
             scene_time += delta;
         }
 
-        current_scene_->GetUpdateSignals(ProcTiming::Update)(delta);
-        current_scene_->GetUpdateSignals(ProcTiming::LateUpdate)(delta);
+        {
+            PROFILE_SCOPE("Update");
+            current_scene_->GetUpdateSignals(ProcTiming::Update)(delta);
+        }
+        {
+            PROFILE_SCOPE("LateUpdate");
+            current_scene_->GetUpdateSignals(ProcTiming::LateUpdate)(delta);
+        }
+        {
+            // ComponentModel::Update()で評価待ちになったアニメーターを並列にまとめて評価 (Animation::useAnimator())
+            PROFILE_SCOPE("Animator");
+            Animation::evaluateAnimators();
+        }
     }
 }
 
 void Scene::PrePhysics()
 {
+    PROFILE_SCOPE("Scene::PrePhysics");
+
     if(current_scene_) {
-        current_scene_->GetSignals(ProcTiming::PrePhysics)();
+        {
+            PROFILE_SCOPE("PrePhysics");
+            current_scene_->GetSignals(ProcTiming::PrePhysics)();
+        }
 
         // Physics
+        PROFILE_SCOPE("CheckComponentCollisions");
         CheckComponentCollisions();
     }
 }
 
 void Scene::PostUpdate()
 {
+    PROFILE_SCOPE("Scene::PostUpdate");
+
     if(current_scene_)
         current_scene_->GetSignals(ProcTiming::PostUpdate)();
 }
 
 void Scene::Draw()
 {
+    PROFILE_SCOPE("Scene::Draw");
+
     // シーンが無ければ何もしない
     if(!current_scene_)
         return;
@@ -933,16 +1227,70 @@ void Scene::Draw()
     scene_step = false;
 
     // プロセスシグナルの実行
-    current_scene_->GetSignals(ProcTiming::PreDraw)();
+    {
+        PROFILE_SCOPE("PreDraw");
+        current_scene_->GetSignals(ProcTiming::PreDraw)();
+    }
 
-    current_scene_->GetSignals(ProcTiming::Shadow)();
-    current_scene_->GetSignals(ProcTiming::Gbuffer)();
-    current_scene_->GetSignals(ProcTiming::Light)();
-    current_scene_->GetSignals(ProcTiming::HDR)();
+    {
+        PROFILE_SCOPE("Shadow");
+        current_scene_->GetSignals(ProcTiming::Shadow)();
+    }
+    {
+        PROFILE_SCOPE("Gbuffer");
+        current_scene_->GetSignals(ProcTiming::Gbuffer)();
+    }
+    {
+        PROFILE_SCOPE("Light");
+        current_scene_->GetSignals(ProcTiming::Light)();
+    }
+    {
+        PROFILE_SCOPE("HDR");
+        current_scene_->GetSignals(ProcTiming::HDR)();
+    }
 
-    current_scene_->GetSignals(ProcTiming::Draw)();
-    current_scene_->GetSignals(ProcTiming::LateDraw)();
-    current_scene_->GetSignals(ProcTiming::PostDraw)();
+    {
+        // 描画するモデルのワールド行列を一括計算 (ComponentModel::Draw()で使用)
+        PROFILE_SCOPE("ModelWorldMatrix");
+        std::vector<ComponentModelPtr> models;
+        for(auto& obj : current_scene_->GetObjectPtrVec()) {
+            if(auto model = obj->GetComponent<ComponentModel>())
+                models.emplace_back(std::move(model));
+        }
+        ComponentModel::UpdateWorldMatrices(models);
+    }
+    {
+        PROFILE_SCOPE("Draw");
+        current_scene_->GetSignals(ProcTiming::Draw)();
+    }
+    {
+        // Drawで描画キューへ登録されたモデルをステート順に描画 (ComponentModel::SetUseRenderQueue())
+        PROFILE_SCOPE("RenderQueue");
+        GetRenderQueue().execute(Model::executor());
+        GetRenderQueue().clear();
+        Model::clearMaterialStates();
+    }
+    {
+        PROFILE_SCOPE("LateDraw");
+        current_scene_->GetSignals(ProcTiming::LateDraw)();
+    }
+    {
+        PROFILE_SCOPE("PostDraw");
+        current_scene_->GetSignals(ProcTiming::PostDraw)();
+    }
+
+    // 未使用コンポーネントの削除と終了オブジェクトの登録解除
+    Cleanup();
+
+    // PauseSystem::DrawPause();
+}
+
+void Scene::Cleanup()
+{
+    PROFILE_SCOPE("Scene::Cleanup");
+
+    if(!current_scene_)
+        return;
 
     // 未使用のコンポーネントを削除
     for(auto obj : current_scene_->GetObjectPtrVec()) {
@@ -961,8 +1309,6 @@ void Scene::Draw()
             continue;
         }
     }
-
-    // PauseSystem::DrawPause();
 }
 
 void Scene::Exit()
@@ -1155,58 +1501,113 @@ const bool Scene::IsEdit()
 }
 
 //! @brief ComponentCollisionの当たり判定を行う
+//! @details 球/カプセル同士のペアは4ペアずつまとめてSIMDで判定します。
+//!          UseCCDが有効で高速移動しているコリジョンは、先に移動経路の連続判定を行います
+//! @note    球/カプセル同士の判定には判定開始時に求めたワールド形状を使うため、
+//!          OnHit()で押し戻した位置は同じパスの後続のペアには反映されません (次フレームで反映)。
+//!          モデルとのペアはIsHit()で現在の行列から判定します。
+//!          OnHit()はペアの列挙順に呼ばれます (まとめて判定中のペアは、他のペアの通知前に確定させます)
 void Scene::CheckComponentCollisions()
 {
-    // オブジェの数を取得
-    int obj_num = (int)current_scene_->GetObjectPtrVec().size();
-    for(int obj_index = 0; obj_index < obj_num; obj_index++) {
-        // 調べるオブジェクト
-        auto obj = current_scene_->GetObjectPtrVec()[obj_index];
-
-        // コンポーネントコリジョン群の取得
-        auto cols = obj->GetComponents<ComponentCollision>();
-        {
-            // コリジョンの検査
-            for(auto col_1 : cols) {
-                // 相手オブジェクトの取得
-                for(int other_index = obj_index + 1; other_index < obj_num; other_index++) {
-                    std::vector<ComponentCollision::HitInfo> hitInfos;
-
-                    // 相手オブジェクト
-                    auto obj2 = current_scene_->GetObjectPtrVec()[other_index];
-
-                    auto cols2 = obj2->GetComponents<ComponentCollision>();
-
-                    // 相手コリジョンの検査
-                    for(auto col_2 : cols2) {
-                        if(!col_1->IsGroupHit(col_2))
+    // ヒットしたペアへ通知する
+    auto on_hit = [](const ComponentCollisionPtr& col_1,
+                     const ComponentCollisionPtr& col_2,
+                     ComponentCollision::HitInfo  hitInfo) {
+        // 押し戻し量再計算
+        float3 push{hitInfo.push_ * 0.5f};
+        float3 other_push{-hitInfo.push_ * 0.5f};
+        col_1->CalcPush(col_2, hitInfo.push_, &push, &other_push);
+
+        hitInfo.collision_     = col_1;
+        hitInfo.hit_collision_ = col_2;
+        hitInfo.push_          = push;
+        col_1->OnHit(hitInfo);
+
+        hitInfo.collision_     = col_2;
+        hitInfo.hit_collision_ = col_1;
+        hitInfo.push_          = other_push;
+        col_2->OnHit(hitInfo);
+    };
+
+    // オブジェクトとコンポーネントコリジョン群を一度だけ取得し、ワールド形状を更新しておく
+    auto objects = current_scene_->GetObjectPtrVec();
+
+    std::vector<std::vector<ComponentCollisionPtr>> collisions;
+    std::vector<ComponentCollisionPtr>              all_collisions;
+    collisions.reserve(objects.size());
+    for(auto& obj : objects) {
+        auto& cols = collisions.emplace_back(obj->GetComponents<ComponentCollision>());
+        all_collisions.insert(all_collisions.end(), cols.begin(), cols.end());
+    }
+    ComponentCollision::UpdateWorldShapes(all_collisions);
+
+    // 球/カプセル同士の一括判定
+    physics::CollisionBatch batch;
+    std::array<std::pair<ComponentCollisionPtr, ComponentCollisionPtr>, physics::CollisionBatch::LANE_COUNT> batch_pairs;
+
+    auto flush = [&]() {
+        physics::CollisionBatch::Result results[physics::CollisionBatch::LANE_COUNT];
+        u32                             mask = batch.test(results);
+
+        for(u32 lane = 0; lane < batch.size(); ++lane) {
+            auto& [col_1, col_2] = batch_pairs[lane];
+            if(mask & (1 << lane)) {
+                ComponentCollision::HitInfo hitInfo;
+                hitInfo.hit_          = true;
+                hitInfo.push_         = results[lane].push_;
+                hitInfo.hit_position_ = results[lane].hit_position_;
+                on_hit(col_1, col_2, hitInfo);
+            }
+            col_1.reset();
+            col_2.reset();
+        }
+        batch.clear();
+    };
+
+    size_t obj_num = objects.size();
+    for(size_t obj_index = 0; obj_index < obj_num; obj_index++) {
+        // コリジョンの検査
+        for(auto& col_1 : collisions[obj_index]) {
+            // 相手オブジェクトの取得
+            for(size_t other_index = obj_index + 1; other_index < obj_num; other_index++) {
+                // 相手コリジョンの検査
+                for(auto& col_2 : collisions[other_index]) {
+                    if(!col_1->IsGroupHit(col_2))
+                        continue;
+
+                    // 高速移動しているコリジョンは移動経路を連続判定する
+                    if(col_1->IsFastMoving() || col_2->IsFastMoving()) {
+                        ComponentCollision::HitInfo hitInfo = col_1->IsSweepHit(col_2);
+                        if(hitInfo.hit_) {
+                            flush();   // 先に列挙したペアの通知を先に行う
+                            on_hit(col_1, col_2, hitInfo);
                             continue;
+                        }
+                    }
 
-                        //! @todo オブジェクトの当たりをチェックする
-                        ComponentCollision::HitInfo hitInfo;
-                        hitInfo = col_1->IsHit(col_2);
+                    auto& shape_1 = col_1->GetWorldShape();
+                    auto& shape_2 = col_2->GetWorldShape();
+                    if(shape_1.valid_ && shape_2.valid_) {
+                        batch_pairs[batch.size()] = {col_1, col_2};
+                        if(batch.add(shape_1.p0_, shape_1.p1_, shape_1.radius_, shape_2.p0_, shape_2.p1_, shape_2.radius_))
+                            flush();
+                        continue;
+                    }
 
-                        if(hitInfo.hit_) {
-                            // 押し戻し量再計算
-                            float3 push{hitInfo.push_ * 0.5f};
-                            float3 other_push{-hitInfo.push_ * 0.5f};
-                            col_1->CalcPush(col_2, hitInfo.push_, &push, &other_push);
-
-                            hitInfo.collision_     = col_1;
-                            hitInfo.hit_collision_ = col_2;
-                            hitInfo.push_          = push;
-                            col_1->OnHit(hitInfo);
-
-                            hitInfo.collision_     = col_2;
-                            hitInfo.hit_collision_ = col_1;
-                            hitInfo.push_          = other_push;
-                            col_2->OnHit(hitInfo);
-                        }
+                    ComponentCollision::HitInfo hitInfo;
+                    hitInfo = col_1->IsHit(col_2);
+
+                    if(hitInfo.hit_) {
+                        flush();   // 先に列挙したペアの通知を先に行う
+                        on_hit(col_1, col_2, hitInfo);
                     }
                 }
             }
         }
     }
+
+    // 残りのペアを判定
+    flush();
 }
 
 //! セレクトしているオブジェクトかをチェックする
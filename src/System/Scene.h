@@ -5,6 +5,7 @@
 #pragma once
 
 #include <System/Object.h>
+#include <System/SceneCommand.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Component/ComponentCamera.h>
 #include <System/Utils/HelperLib.h>
@@ -94,6 +95,9 @@ public:
 
         virtual void InitSerialize(){};
 
+        //! 先行読み込みするアセットの登録 (Scene::Preload()から呼ばれます。PreloadModel()などで登録します)
+        virtual void Preload(){};
+
         //@}
 
         //----------------------------------------------------------------------
@@ -190,6 +194,32 @@ public:
         //! 別のシーンで生存するように設定されているか?
         bool IsAliveInAnotherScene() { return GetStatus(StatusBit::AliveInAnotherScene); }
 
+        //@}
+        //----------------------------------------------------------------------
+        //! @name 先行読み込み
+        //----------------------------------------------------------------------
+        //@{
+
+        //! @brief 先行読み込みするモデルを登録します
+        //! @param path モデルファイルパス
+        //! @details Preload()内で呼び出します。切り替えてInit()が終わるまで読み込んだモデルを保持します
+        void PreloadModel(std::string_view path);
+
+        //! @brief 先行読み込みするテクスチャを登録します
+        //! @param path テクスチャファイルパス
+        //! @details Preload()内で呼び出します。切り替えてInit()が終わるまで読み込んだテクスチャを保持します
+        void PreloadTexture(std::string_view path);
+
+        //! 先行読み込みの進捗を取得します
+        //! @return 0.0～1.0 (先行読み込みしていない場合は1.0)
+        f32 GetLoadProgress() const;
+
+        //! 先行読み込みしたアセットが全て読み込み済みか?
+        bool IsLoaded() const;
+
+        //! 先行読み込み中か?
+        bool IsPreloading() const { return preload_group_ != 0; }
+
         //@}
         //----------------------------------------------------------------------
         //! @name シグナル
@@ -357,6 +387,12 @@ public:
         float over_lap_ = 0.0f;    //!< シーン切り替えオーバーラップ
 
         bool change_next_ = false;   //!< 次のシーンへ移行する
+
+        u32                                preload_group_       = 0;       //!< 先行読み込みの進捗グループ (0:先行読み込みしていない)
+        bool                               preload_change_      = false;   //!< 先行読み込みの完了後に切り替える
+        bool                               preload_constructed_ = false;   //!< オブジェクトを先行して作成した
+        std::vector<std::shared_ptr<void>> preload_assets_;                //!< 先行読み込み中のアセット
+        Object::NameTable                  preload_names_;                 //!< 先行して作成したオブジェクトの名前リスト
     };
 
     //----------------------------------------------------------------
@@ -409,6 +445,19 @@ public:
     //! 次のシーンに切り替える
     static void ChangeNextScene();
 
+    //! @brief シーンの先行読み込みを開始します
+    //! @param scene 先行読み込みするシーン
+    //! @param construct オブジェクトも先行して作成する (true = シーンのInit()をここで実行する)
+    //! @details 読み込み中も現在のシーンは動作し続けます。
+    //!          読み込み中のシーンへ Change() した場合は、全て読み込み済みになってから切り替えます
+    static void Preload(BasePtr scene, bool construct = false);
+
+    //! 先行読み込みを取り消します
+    static void CancelPreload();
+
+    //! 先行読み込み中のシーンを取得します
+    static Scene::Base* GetPreloadScene();
+
     //  現在アクティブなシーンを取得します
     static Scene::Base* GetCurrentScene();
 
@@ -458,6 +507,59 @@ public:
 
     static void ReleaseObject(ObjectPtr obj);
 
+    //@}
+    //----------------------------------------------------------------
+    //! @name スレッドセーフなオブジェクト操作 関係
+    //! 任意のスレッドから呼び出せます。要求はキューに積まれ、次の PreUpdate() の先頭でまとめて反映されます
+    //----------------------------------------------------------------
+    //@{
+
+    //! オブジェクトの作成を要求
+    //! @param created 作成後に呼ばれる処理 (メインスレッドで呼ばれます)
+    //! @param no_transform ComponentTransformを作らない (true = 作らない)
+    //! @param update 処理優先
+    //! @param draw 描画優先
+    template <class T>
+    static void CreateObjectDeferred(std::function<void(std::shared_ptr<T>)> created      = nullptr,
+                                     bool                                    no_transform = false,
+                                     Priority                                update       = Priority::NORMAL,
+                                     Priority                                draw         = Priority::NORMAL)
+    {
+        using Created = std::function<void(std::shared_ptr<T>)>;
+        static_assert(sizeof(Created) <= sizeof(SceneCommand::created_) &&
+                      alignof(Created) <= alignof(SceneCommand::CreatedStorage));
+
+        auto* command          = command_queue_.Allocate();
+        command->type_         = SceneCommand::Type::Create;
+        command->no_transform_ = no_transform;
+        command->update_       = update;
+        command->draw_         = draw;
+        new(command->created_) Created(std::move(created));
+        command->create_ = [](SceneCommand& c, bool run) {
+            auto& created = *std::launder(reinterpret_cast<Created*>(c.created_));
+            if(run) {
+                auto obj = CreateObject<T>(c.no_transform_, c.update_, c.draw_);
+                if(created && obj)
+                    created(obj);
+            }
+            created.~Created();
+            c.create_ = nullptr;
+        };
+        command_queue_.Push(command);
+    }
+
+    //! オブジェクトの削除を要求
+    static void ReleaseObjectDeferred(ObjectWeakPtr obj);
+
+    //! オブジェクトのステータス変更を要求
+    static void SetStatusDeferred(ObjectWeakPtr obj, Object::StatusBit b, bool on);
+
+    //! オブジェクトの処理優先変更を要求
+    static void SetPriorityDeferred(ObjectWeakPtr obj, ProcTiming timing, Priority priority);
+
+    //! オブジェクトの行列変更を要求
+    static void SetMatrixDeferred(ObjectWeakPtr obj, const matrix& mat);
+
     //@}
     //----------------------------------------------------------------
     //! @name シーン処理 関係
@@ -486,6 +588,10 @@ public:
     //! シーン描画
     static void Draw();
 
+    //! @brief 未使用コンポーネントの削除と終了オブジェクトの登録解除
+    //! @detail Draw()の最後に処理されます。描画を行わないヘッドレス実行では直接呼び出します
+    static void Cleanup();
+
     //! シーン終了
     static void Exit();
 
@@ -682,10 +788,20 @@ private:
 
     static void checkNextAlive();
 
+    //! @brief 要求されたオブジェクト操作を反映する
+    //! @detail PreUpdate() の先頭 (オブジェクト本登録の前) で処理します
+    static void executeCommands();
+
+    //! @brief 先行読み込みの進捗の集計を終了する
+    static void endPreload(Base& scene);
+
     static BasePtr current_scene_;   //!< 現在のシーン
     static BasePtr next_scene_;      //!< 変更シーン
+    static BasePtr preload_scene_;   //!< 先行読み込み中のシーン
 
     static BasePtrMap scenes_;   //!< 存在する全シーン
+
+    static SceneCommandQueue command_queue_;   //!< オブジェクト操作要求
 };
 
 //! @brief オブジェクト取得
@@ -0,0 +1,15 @@
+﻿//---------------------------------------------------------------------------
+//! @file   SceneCommand.cpp
+//! @brief  シーン操作コマンドキュー (ワーカースレッドからのシーン変更要求)
+//---------------------------------------------------------------------------
+#include "SceneCommand.h"
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+SceneCommand::~SceneCommand()
+{
+    // 実行されなかった作成要求の作成後処理を破棄
+    if(create_)
+        create_(*this, false);
+}
@@ -0,0 +1,65 @@
+﻿//---------------------------------------------------------------------------
+//! @file   SceneCommand.h
+//! @brief  シーン操作コマンドキュー (ワーカースレッドからのシーン変更要求)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <System/Object.h>
+#include <System/CommandQueue.h>
+
+#include <cstddef>
+#include <functional>
+
+//===========================================================================
+//! シーン操作コマンド
+//! @details オブジェクトの作成/削除/ステータス/優先/行列の変更を1件分保持します
+//===========================================================================
+struct SceneCommand
+{
+    //! コマンド種別
+    enum struct Type : u8
+    {
+        Create,        //!< オブジェクト作成
+        Release,       //!< オブジェクト削除
+        SetStatus,     //!< ステータス変更
+        SetPriority,   //!< 処理優先変更
+        SetMatrix,     //!< 行列変更
+    };
+
+    //! 作成処理 (作成するクラスごとに実体化されます)
+    //! @param [in] command コマンド
+    //! @param [in] run     false の場合は作成せずに created_ の破棄のみ行う
+    using CreateFunc = void (*)(SceneCommand& command, bool run);
+
+    //! 作成後の処理 std::function<void(std::shared_ptr<T>)> の格納領域 (Tによらず同じサイズ)
+    using CreatedStorage = std::function<void(ObjectPtr)>;
+
+    SceneCommand() = default;
+    ~SceneCommand();
+
+    Type              type_         = Type::Create;               //!< 種別
+    ObjectWeakPtr     object_;                                    //!< 対象オブジェクト (Create以外)
+    CreateFunc        create_       = nullptr;                    //!< 作成処理 (Create)
+    bool              no_transform_ = false;                      //!< ComponentTransformを作らない (Create)
+    Priority          update_       = Priority::NORMAL;           //!< 処理優先 (Create)
+    Priority          draw_         = Priority::NORMAL;           //!< 描画優先 (Create)
+    Object::StatusBit status_       = Object::StatusBit::Alive;   //!< ステータス (SetStatus)
+    bool              on_           = false;                      //!< ステータス値 (SetStatus)
+    ProcTiming        timing_       = ProcTiming::Update;         //!< 処理タイミング (SetPriority)
+    Priority          priority_     = Priority::NORMAL;           //!< 処理優先 (SetPriority)
+    matrix            matrix_       = matrix::identity();         //!< 行列 (SetMatrix)
+
+    //! 作成後の処理 (Create)
+    //! std::functionをラムダで包み直すとヒープ確保が発生するため、受け取ったものをそのまま格納する
+    alignas(CreatedStorage) std::byte created_[sizeof(CreatedStorage)];
+
+private:
+    SceneCommand(const SceneCommand&)            = delete;
+    SceneCommand& operator=(const SceneCommand&) = delete;
+};
+
+//! シーン操作コマンドキュー
+//! @details 複数スレッドから Push() し、メインスレッドのみが Drain() します。
+//!          コマンドは Allocate() で再利用ノードから確保するため、要求ごとのヒープ確保は発生しません
+using SceneCommandQueue = CommandQueue<SceneCommand>;
+
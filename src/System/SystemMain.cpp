@@ -3,7 +3,10 @@
 //! @brief	システムメイン
 //---------------------------------------------------------------------------
 #include <System/Debug/DebugCamera.h>
+#include <System/Graphics/AnimationLod.h>
 #include <System/Physics/PhysicsEngine.h>
+#include <System/Profiler.h>
+#include <System/Input/InputRecorder.h>
 
 //----------------------------------------------------------------
 // シーンオブジェクト
@@ -21,6 +24,10 @@ bool show_fps     = true;    //!< FPSの表示
 bool debug_camera = false;   //!< デバッグカメラ
 bool show_debug   = true;
 
+#if defined(USE_PROFILER)
+bool show_profiler = false;   //!< プロファイラーの表示
+#endif
+
 u64 current_time_ = 0;      //!< 現在の時間 (単位:μsec)
 f32 delta_time_   = 0.0f;   //!< 1フレームの経過時間（CPUとGPU, ScreenFlip()更新待ちすべて含む）
 
@@ -78,6 +85,9 @@ void UpdateDeltaTime()
     u64 last_time = current_time_;
     current_time_ = GetPerformanceCounterMicroSec();
     delta_time_   = static_cast<f32>(current_time_ - last_time) * (1.0f / 1000.0f / 1000.0f);
+
+    // 再生中は記録時の⊿tで実行する
+    InputRecorderSyncDelta(delta_time_);
 }
 
 //---------------------------------------------------------------------------------
@@ -236,6 +246,44 @@ void ShowFps(f32 delta)
     ImGui::Text(u8"FPS    : %3.2f fps (max:%3d fps)", frame_rate, refresh_rate);
     ImGui::Text(u8"CPU負荷 : %3.2f ms", static_cast<f32>(cpu_profile_time) / 1000.0f);
 
+    // テクスチャプールの使用量
+    {
+        constexpr f32 MB    = 1.0f / (1024.0f * 1024.0f);
+        auto          stats = GetTexturePool().stats();
+        ImGui::Text(u8"テクスチャ: %3.1f / %3.1f MB (%u枚 共有:%llu 読込:%llu 失敗:%llu)",
+                    static_cast<f32>(stats.resident_bytes_) * MB,
+                    static_cast<f32>(GetTexturePool().budget()) * MB,
+                    stats.count_,
+                    stats.hits_,
+                    stats.misses_,
+                    stats.failures_);
+    }
+
+    // ストリーミングの状況
+    {
+        const auto& stats    = GetStreamingManager().stats();
+        auto        progress = GetStreamingManager().progress();
+        ImGui::Text(u8"読込    : 待機:%u 読込中:%u 仕上げ待ち:%u (%u / %u 完了 仕上げ:%3.2f ms)",
+                    stats.queued_,
+                    stats.loading_,
+                    stats.ready_,
+                    progress.completed_,
+                    progress.requested_,
+                    stats.finalize_ms_);
+    }
+
+    // アニメーションLODごとのモデル数
+    {
+        const auto& stats = GetAnimationLod().stats();
+        ImGui::Text(u8"アニメ  : 毎:%u 1/2:%u 1/4:%u 画面外:%u (更新:%u 予算超過:%u)",
+                    stats.counts_[static_cast<u32>(AnimationLod::Level::Full)],
+                    stats.counts_[static_cast<u32>(AnimationLod::Level::Half)],
+                    stats.counts_[static_cast<u32>(AnimationLod::Level::Quarter)],
+                    stats.counts_[static_cast<u32>(AnimationLod::Level::Hidden)],
+                    stats.sampled_,
+                    stats.throttled_);
+    }
+
     // オーバーレイウィンドウ終了
     ImGui::End();
     ImGui::PopStyleVar();   // 角を丸める設定を元に戻す
@@ -351,6 +399,9 @@ void SystemUpdate()
                 menu_select = true;
                 ImGui::Checkbox(u8"グリッド表示", &show_grid);
                 ImGui::Checkbox(u8"FPS表示", &show_fps);
+#if defined(USE_PROFILER)
+                ImGui::Checkbox(u8"プロファイラー表示", &show_profiler);
+#endif
                 ImGui::Separator();
                 ImGui::Checkbox(u8"デバッグ表示(F5)", &show_debug);
                 ImGui::Separator();
@@ -383,6 +434,16 @@ void SystemUpdate()
         }
     }
 
+#if defined(USE_PROFILER)
+    if(show_profiler)
+        profiler::showGUI(&show_profiler);
+#endif
+
+    //----------------------------------------------------------
+    // アニメーションLODのフレーム開始 (直前に設定されたカメラで判定)
+    //----------------------------------------------------------
+    GetAnimationLod().beginFrame(Frustum(cast(GetCameraViewMatrix()), cast(GetCameraProjectionMatrix())));
+
     //----------------------------------------------------------
     // シーンの更新前処理
     //----------------------------------------------------------
@@ -407,12 +468,28 @@ void SystemUpdate()
     //----------------------------------------------------------
     // 物理シミュレーションを更新
     //----------------------------------------------------------
-    physicsEngine_->update(delta_time_);
+    {
+        PROFILE_SCOPE("Physics");
+        physicsEngine_->update(delta_time_);
+    }
 
     //----------------------------------------------------------
     // シーンの更新後処理
     //----------------------------------------------------------
     Scene::PostUpdate();
+
+    //----------------------------------------------------------
+    // 予算を超えた未参照のテクスチャを解放
+    //----------------------------------------------------------
+    GetTexturePool().update();
+
+    //----------------------------------------------------------
+    // アセットのストリーミング (直前のフレームで描画しようとしたモデルを優先)
+    //----------------------------------------------------------
+    {
+        PROFILE_SCOPE("Streaming");
+        GetStreamingManager().update();
+    }
 }
 
 //---------------------------------------------------------------------------------
@@ -463,6 +540,11 @@ void SystemExit()
     // 物理シミュレーションを解放
     //----------------------------------------------------------
     physicsEngine_.reset();
+
+    //----------------------------------------------------------
+    // テクスチャプールを解放
+    //----------------------------------------------------------
+    GetTexturePool().clear();
 }
 
 //---------------------------------------------------------------------------------
@@ -472,6 +554,10 @@ void SystemBeginFrame()
 {
     // CPU計測開始
     cpu_start_counter_ = GetPerformanceCounterMicroSec();
+
+#if defined(USE_PROFILER)
+    profiler::beginFrame();
+#endif
 }
 
 //---------------------------------------------------------------------------------
@@ -482,6 +568,10 @@ void SystemEndFrame()
     // CPU計測終了
     u64 cpu_end_counter   = GetPerformanceCounterMicroSec();
     cpu_profile_duration_ = cpu_end_counter - cpu_start_counter_;
+
+#if defined(USE_PROFILER)
+    profiler::endFrame();
+#endif
 }
 
 bool IsShowMenu()
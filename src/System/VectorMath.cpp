@@ -66,8 +66,8 @@ matrix matrix::scale(f32 s)
 //---------------------------------------------------------------------------
 matrix matrix::rotateX(f32 radian)
 {
-    f32 s = std::sinf(radian);
-    f32 c = std::cosf(radian);
+    f32 s = std::sin(radian);
+    f32 c = std::cos(radian);
 
     float4 m[4]{
         {1.0f, 0.0f, 0.0f, 0.0f},
@@ -83,8 +83,8 @@ matrix matrix::rotateX(f32 radian)
 //---------------------------------------------------------------------------
 matrix matrix::rotateY(f32 radian)
 {
-    f32 s = std::sinf(radian);
-    f32 c = std::cosf(radian);
+    f32 s = std::sin(radian);
+    f32 c = std::cos(radian);
 
     float4 m[4]{
         {   c, 0.0f,   -s, 0.0f},
@@ -100,8 +100,8 @@ matrix matrix::rotateY(f32 radian)
 //---------------------------------------------------------------------------
 matrix matrix::rotateZ(f32 radian)
 {
-    f32 s = std::sinf(radian);
-    f32 c = std::cosf(radian);
+    f32 s = std::sin(radian);
+    f32 c = std::cos(radian);
 
     float4 m[4]{
         {   c,    s, 0.0f, 0.0f},
@@ -117,8 +117,8 @@ matrix matrix::rotateZ(f32 radian)
 //---------------------------------------------------------------------------
 matrix matrix::rotateAxis(const float3& axis, f32 radian)
 {
-    f32 s    = std::sinf(radian);
-    f32 c    = std::cosf(radian);
+    f32 s    = std::sin(radian);
+    f32 c    = std::cos(radian);
     f32 invc = 1.0f - c;
 
     float3 v = normalize(axis);
@@ -162,8 +162,8 @@ matrix matrix::lookAtLH(const float3& eye, const float3& lookAt, const float3& w
 //---------------------------------------------------------------------------
 matrix matrix::perspectiveFovLH(f32 fovy, f32 aspect_ratio, f32 near_z, f32 far_z)
 {
-    f32 s = std::sinf(fovy * 0.5f);
-    f32 c = std::cosf(fovy * 0.5f);
+    f32 s = std::sin(fovy * 0.5f);
+    f32 c = std::cos(fovy * 0.5f);
 
     f32 height = c / s;
     f32 width  = height / aspect_ratio;
@@ -183,8 +183,8 @@ matrix matrix::perspectiveFovLH(f32 fovy, f32 aspect_ratio, f32 near_z, f32 far_
 //---------------------------------------------------------------------------
 matrix matrix::perspectiveFovInfiniteFarPlaneLH(f32 fovy, f32 aspect_ratio, f32 near_z)
 {
-    f32 s = std::sinf(fovy * 0.5f);
-    f32 c = std::cosf(fovy * 0.5f);
+    f32 s = std::sin(fovy * 0.5f);
+    f32 c = std::cos(fovy * 0.5f);
 
     f32 height = c / s;
     f32 width  = height / aspect_ratio;
@@ -251,3 +251,120 @@ float3 matrix::translate() const
 {
     return _41_42_43;
 }
+
+//===========================================================================
+//  TRS表現
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 行列からTRSへ分解
+//---------------------------------------------------------------------------
+TRS TRS::fromMatrix(const matrix& m)
+{
+    float3 axis_x = m.axisX();
+    float3 axis_y = m.axisY();
+    float3 axis_z = m.axisZ();
+
+    f32 sx = length(axis_x);
+    f32 sy = length(axis_y);
+    f32 sz = length(axis_z);
+
+    // 鏡像行列の場合はX軸を反転して回転行列として扱う
+    if((f32)dot(cross(axis_x, axis_y), axis_z) < 0.0f)
+        sx = -sx;
+
+    TRS trs;
+    trs.translate_ = m.translate();
+    trs.scale_     = float3(sx, sy, sz);
+
+    // スケールが0の軸は回転が求まらないため、残りの軸から補完する
+    bool valid_x = std::abs(sx) > FLT_EPSILON;
+    bool valid_y = std::abs(sy) > FLT_EPSILON;
+    bool valid_z = std::abs(sz) > FLT_EPSILON;
+    if(valid_x + valid_y + valid_z < 2)
+        return trs;
+
+    if(valid_x)
+        axis_x /= sx;
+    if(valid_y)
+        axis_y /= sy;
+    if(valid_z)
+        axis_z /= sz;
+
+    if(!valid_x)
+        axis_x = normalize(cross(axis_y, axis_z));
+    if(!valid_y)
+        axis_y = normalize(cross(axis_z, axis_x));
+    if(!valid_z)
+        axis_z = normalize(cross(axis_x, axis_y));
+
+    trs.rotate_ = normalize(quaternion(float3x3(axis_x, axis_y, axis_z)));
+    return trs;
+}
+
+//---------------------------------------------------------------------------
+//! TRSから行列を合成
+//---------------------------------------------------------------------------
+matrix TRS::toMatrix() const
+{
+    float3x3 rot(rotate_);
+
+    return matrix(float4(float3(rot.vec0) * scale_.x, 0.0f),
+                  float4(float3(rot.vec1) * scale_.y, 0.0f),
+                  float4(float3(rot.vec2) * scale_.z, 0.0f),
+                  float4(translate_, 1.0f));
+}
+
+//===========================================================================
+//  オイラー角
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! オイラー角からクォータニオンへ変換
+//! ImGuizmoは X→Y→Z の順に回転させるため、クォータニオンは Z*Y*X の順に合成する
+//---------------------------------------------------------------------------
+quaternion EulerAxisXYZToQuaternion(const float3& xyz)
+{
+    quaternion qx = quaternion::rotation_x(D2R(xyz.x));
+    quaternion qy = quaternion::rotation_y(D2R(xyz.y));
+    quaternion qz = quaternion::rotation_z(D2R(xyz.z));
+
+    return mul(mul(qz, qy), qx);
+}
+
+//---------------------------------------------------------------------------
+//! クォータニオンからオイラー角へ変換
+//! 回転行列は正規直交のため、ImGuizmoのような正規化処理は不要
+//---------------------------------------------------------------------------
+float3 QuaternionToEulerAxisXYZ(const quaternion& q)
+{
+    float    m[3][3];
+    float3x3 rot(q);
+    store(rot, &m[0][0]);
+
+    float rotation[3];
+    rotation[0] = R2D(std::atan2(m[1][2], m[2][2]));
+    rotation[1] = R2D(std::atan2(-m[0][2], std::sqrt(m[1][2] * m[1][2] + m[2][2] * m[2][2])));
+    rotation[2] = R2D(std::atan2(m[0][1], m[0][0]));
+    FixEulerRotation(rotation);
+
+    return float3(rotation[0], rotation[1], rotation[2]);
+}
+
+//---------------------------------------------------------------------------
+//! ImGuizmoの分解結果で全軸に180度の変換がかかる場合の補正と -180～180度への正規化
+//---------------------------------------------------------------------------
+void FixEulerRotation(f32* rotation)
+{
+    if(std::abs(rotation[0]) + std::abs(rotation[1]) + std::abs(rotation[2]) > 120 + 120) {
+        rotation[0] -= 180.0f;
+        rotation[1] = -180.0f - rotation[1];
+        rotation[2] -= 180.0f;
+    }
+    for(u32 i = 0; i < 3; ++i) {
+        if(rotation[i] < -180.0f)
+            rotation[i] += 360.0f;
+        if(rotation[i] > 180.0f)
+            rotation[i] -= 360.0f;
+    }
+}
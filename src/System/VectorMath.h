@@ -4,37 +4,66 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+//===========================================================================
+//! @name   数学定数
+//===========================================================================
+//@{
+
+static constexpr f32 PI       = 3.141592653589793f;   //!< 円周率 π
+static constexpr f32 TAU      = 2.0f * PI;            //!< 円周率の2倍 τ
+static constexpr f32 RadToDeg = 57.29577951f;         //!< Radian→Degree 変換係数
+static constexpr f32 DegToRad = 0.017453293f;         //!< Degree→Radian 変換係数
+
+//! Radian→Degree 単位変換
+//! @param  [in]    radian  ラジアン値 (弧度法)
+//! @return degree値 (度数法)
+inline f32 R2D(f32 radian)
+{
+    return radian * RadToDeg;
+}
+
+//! Degree→Radian 単位変換
+//! @param  [in]    degree  角度 (度数法)
+//! @return radian値 (弧度法)
+inline f32 D2R(f32 degree)
+{
+    return degree * DegToRad;
+}
+
+//@}
 //===========================================================================
 //! @name   DxLib相互キャスト処理
 //===========================================================================
 //@{
 
+#if defined(DX_LIB_H)
+
 //! DxLib::FLOAT2へキャスト
-inline [[nodiscard]] DxLib::FLOAT2 cast(const float2& v)
+[[nodiscard]] inline DxLib::FLOAT2 cast(const float2& v)
 {
     return {v.x, v.y};
 }
 
 //! DxLib::VECTOR/FLOAT3へキャスト
-inline [[nodiscard]] DxLib::FLOAT3 cast(const float3& v)
+[[nodiscard]] inline DxLib::FLOAT3 cast(const float3& v)
 {
     return {v.x, v.y, v.z};
 }
 
 //! DxLib::FLOAT4へキャスト
-inline [[nodiscard]] DxLib::FLOAT4 cast(const float4& v)
+[[nodiscard]] inline DxLib::FLOAT4 cast(const float4& v)
 {
     return {v.x, v.y, v.z, v.w};
 }
 
 //! DxLib::INT4へキャスト
-inline [[nodiscard]] DxLib::INT4 cast(const int4& v)
+[[nodiscard]] inline DxLib::INT4 cast(const int4& v)
 {
     return {v.x, v.y, v.z, v.w};
 }
 
 //! DxLib::MATRIXへキャスト
-inline [[nodiscard]] DxLib::MATRIX cast(const float4x4& m)
+[[nodiscard]] inline DxLib::MATRIX cast(const float4x4& m)
 {
     DxLib::MATRIX result;
     store(m, reinterpret_cast<f32*>(&result));
@@ -42,37 +71,39 @@ inline [[nodiscard]] DxLib::MATRIX cast(const float4x4& m)
 }
 
 //! float2へキャスト
-inline [[nodiscard]] float2 cast(const DxLib::FLOAT2& v)
+[[nodiscard]] inline float2 cast(const DxLib::FLOAT2& v)
 {
     return {v.u, v.v};
 }
 
 //! float3へキャスト
-inline [[nodiscard]] float3 cast(const DxLib::FLOAT3& v)
+[[nodiscard]] inline float3 cast(const DxLib::FLOAT3& v)
 {
     return {v.x, v.y, v.z};
 }
 
 //! float4へキャスト
-inline [[nodiscard]] float4 cast(const DxLib::FLOAT4& v)
+[[nodiscard]] inline float4 cast(const DxLib::FLOAT4& v)
 {
     return {v.x, v.y, v.z, v.w};
 }
 
 //! int4へキャスト
-inline [[nodiscard]] int4 cast(const DxLib::INT4& v)
+[[nodiscard]] inline int4 cast(const DxLib::INT4& v)
 {
     return {v.x, v.y, v.z, v.w};
 }
 
 //! float4x4へキャスト
-inline [[nodiscard]] float4x4 cast(const DxLib::MATRIX& m)
+[[nodiscard]] inline float4x4 cast(const DxLib::MATRIX& m)
 {
     float4x4 result;
     load(result, reinterpret_cast<f32*>(const_cast<DxLib::MATRIX*>(&m)));
     return result;
 }
 
+#endif
+
 //@}
 //===========================================================================
 //! @name   hlslppの追加関数
@@ -80,7 +111,7 @@ inline [[nodiscard]] float4x4 cast(const DxLib::MATRIX& m)
 //@{
 
 //! 3x4行列 ✕ float4
-hlslpp_inline [[nodiscard]] float3 mul(const float3x4& m1, const float4& v)
+[[nodiscard]] hlslpp_inline float3 mul(const float3x4& m1, const float4& v)
 {
     return float3(_hlslpp_mul_3x4_4x1_ps(m1.vec0, m1.vec1, m1.vec2, v.vec));
 }
@@ -107,42 +138,42 @@ public:
     //@{
 
     //! 単位行列
-    static [[nodiscard]] matrix identity();
+    [[nodiscard]] static matrix identity();
 
     // 平行移動行列
     //! @param  [in]    v   移動ベクトル
-    static [[nodiscard]] matrix translate(const float3& v);
-    static [[nodiscard]] matrix translate(f32 x, f32 y, f32 z);
+    [[nodiscard]] static matrix translate(const float3& v);
+    [[nodiscard]] static matrix translate(f32 x, f32 y, f32 z);
 
     // スケール行列
     //! @param  [in]    s   スケール値
-    static [[nodiscard]] matrix scale(const float3& s);
-    static [[nodiscard]] matrix scale(f32 sx, f32 sy, f32 sz);
-    static [[nodiscard]] matrix scale(f32 s);
+    [[nodiscard]] static matrix scale(const float3& s);
+    [[nodiscard]] static matrix scale(f32 sx, f32 sy, f32 sz);
+    [[nodiscard]] static matrix scale(f32 s);
 
     // X軸中心の回転行列
     //! @param  [in]    radian  回転角度
     //! @see https://ja.wikipedia.org/wiki/%E5%9B%9E%E8%BB%A2%E8%A1%8C%E5%88%97
-    static [[nodiscard]] matrix rotateX(f32 radian);
+    [[nodiscard]] static matrix rotateX(f32 radian);
 
     // Y軸中心の回転行列
     //! @param  [in]    radian  回転角度
-    static [[nodiscard]] matrix rotateY(f32 radian);
+    [[nodiscard]] static matrix rotateY(f32 radian);
 
     // Z軸中心の回転行列
     //! @param  [in]    radian  回転角度
-    static [[nodiscard]] matrix rotateZ(f32 radian);
+    [[nodiscard]] static matrix rotateZ(f32 radian);
 
     // 任意軸中心の回転行列
     //! @param  [in]    axis    回転の中心軸
     //! @param  [in]    radian  回転角度
-    static [[nodiscard]] matrix rotateAxis(const float3& axis, f32 radian);
+    [[nodiscard]] static matrix rotateAxis(const float3& axis, f32 radian);
 
     // [左手座標系] ビュー行列
     //! @param  [in]    eye         視点座標
     //! @param  [in]    look_at     注視点
     //! @param  [in]    world_up    世界の上方向のベクトル(default:(0.0f, 1.0f, 0.0f))
-    static [[nodiscard]] matrix
+    [[nodiscard]] static matrix
     lookAtLH(const float3& eye, const float3& look_at, const float3& world_up = float3(0.0f, 1.0f, 0.0f));
 
     // [左手座標系] 投影行列
@@ -151,7 +182,7 @@ public:
     //! @param  [in]    near_z          近クリップZ値
     //! @param  [in]    far_z           遠クリップZ値
     //! @note InverseZにしたい場合はnearZの値とfarZの値を交換して指定。
-    static [[nodiscard]] matrix perspectiveFovLH(f32 fovy, f32 aspect_ratio, f32 near_z, f32 far_z);
+    [[nodiscard]] static matrix perspectiveFovLH(f32 fovy, f32 aspect_ratio, f32 near_z, f32 far_z);
 
     // [左手座標系] 無限遠投影行列
     //!
@@ -164,7 +195,7 @@ public:
     //!
     //! @see GDC'07 「Projection Matrix Tricks」
     //! @attention InverseZ前提の投影にになるため注意。
-    static [[nodiscard]] matrix perspectiveFovInfiniteFarPlaneLH(f32 fovy, f32 aspect_ratio, f32 near_z);
+    [[nodiscard]] static matrix perspectiveFovInfiniteFarPlaneLH(f32 fovy, f32 aspect_ratio, f32 near_z);
 
     // [左手座標系] 平行投影行列
     //! @param  [in]    left        左側の幅
@@ -174,7 +205,7 @@ public:
     //! @param  [in]    near_z      近クリップZ値
     //! @param  [in]    far_z       遠クリップZ値
     //! @note InverseZにしたい場合はnearZの値とfarZの値を交換して指定。
-    static [[nodiscard]] matrix
+    [[nodiscard]] static matrix
     orthographicOffCenterLH(f32 left, f32 right, f32 bottom, f32 top, f32 near_z, f32 far_z);
 
     //@}
@@ -215,6 +246,7 @@ public:
     auto& translateVector() { return _41_42_43_44; }
 
     //@}
+#if defined(DX_LIB_H)
     //----------------------------------------------------------
     //! @name   DxLib関連
     //----------------------------------------------------------
@@ -227,4 +259,41 @@ public:
     operator DxLib::MATRIX const() { return cast(*this); }
 
     //@}
+#endif
+};
+
+//===========================================================================
+//! TRS表現 (平行移動・回転・スケール)
+//! 回転をクォータニオンで保持するため、行列との相互変換に三角関数を使用しません
+//===========================================================================
+struct TRS
+{
+    float3     translate_ = float3(0.0f, 0.0f, 0.0f);   //!< 平行移動
+    quaternion rotate_    = quaternion::identity();     //!< 回転
+    float3     scale_     = float3(1.0f, 1.0f, 1.0f);   //!< スケール
+
+    // 行列からTRSへ分解
+    //! @param  [in]    m   分解する行列 (せん断を含まないこと)
+    [[nodiscard]] static TRS fromMatrix(const matrix& m);
+
+    // TRSから行列を合成
+    [[nodiscard]] matrix toMatrix() const;
 };
+
+//===========================================================================
+//! @name   オイラー角 (単位:度)
+//! ImGuizmo::RecomposeMatrixFromComponents と同じく X→Y→Z の順に回転します。
+//! 行列では mul(mul(rotateX(x), rotateY(y)), rotateZ(z)) に一致します
+//===========================================================================
+//@{
+
+// オイラー角からクォータニオンへ変換
+[[nodiscard]] quaternion EulerAxisXYZToQuaternion(const float3& xyz);
+
+// クォータニオンからオイラー角へ変換 (各軸 -180～180度)
+[[nodiscard]] float3 QuaternionToEulerAxisXYZ(const quaternion& q);
+
+// ImGuizmoの分解結果で全軸に180度の変換がかかる場合の補正と -180～180度への正規化
+void FixEulerRotation(f32* rotation);
+
+//@}
@@ -0,0 +1,892 @@
+﻿//---------------------------------------------------------------------------
+//! @file   VectorMathBatch.cpp
+//! @brief  ベクトル算術演算 (配列の一括処理)
+//!
+//! 各処理は スカラー / SSE(float4) / AVX(__m256) の実装を持ち、activeIsa()で切り替えます。
+//! AVXは実行時にCPUIDで対応を確認して使用します。
+//! SIMD幅で割り切れない端数は1段下の命令セットで処理します。
+//---------------------------------------------------------------------------
+#include "VectorMathBatch.h"
+#include <atomic>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//! AVX命令を使う関数 (MSVCは/arch指定なしでもAVXの組み込み関数を使用可能)
+#if defined(_MSC_VER) && !defined(__clang__)
+#define AVX_FUNCTION
+#else
+#define AVX_FUNCTION __attribute__((target("avx")))
+#endif
+
+namespace simd
+{
+namespace
+{
+//! CPUとOSがAVXに対応しているかどうか
+bool cpuSupportsAvx()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    // OSがYMMレジスタを保存するか (XCR0のbit1:XMM / bit2:YMM)
+    return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+
+//! 利用可能な最上位の命令セット
+Isa bestIsa()
+{
+    static const Isa isa = cpuSupportsAvx() ? Isa::AVX : Isa::SSE;
+    return isa;
+}
+
+//! 使用中の命令セット
+//! @details ワーカースレッドからも参照されるためatomicで保持します
+std::atomic<Isa>& activeIsaRef()
+{
+    static std::atomic<Isa> isa = bestIsa();
+    return isa;
+}
+
+//===========================================================================
+// 共通処理
+//===========================================================================
+
+//! 行ベクトルを取得 (hlslppの内部配置 float4×4 / float8×2 に依存しない)
+void getRows(const float4x4& m, float4 (&rows)[4])
+{
+    rows[0] = m._11_12_13_14;
+    rows[1] = m._21_22_23_24;
+    rows[2] = m._31_32_33_34;
+    rows[3] = m._41_42_43_44;
+}
+
+//! 4要素の並びを転置 (AoS⇔SoA)
+void transpose4(const float4& v0, const float4& v1, const float4& v2, const float4& v3, float4 (&out)[4])
+{
+    getRows(transpose(float4x4(v0, v1, v2, v3)), out);
+}
+
+//! クォータニオンから回転行列の9要素を計算 (SoA。float4/float8共通)
+//! @details TRS::toMatrix()で使用されるhlslppの変換と同じ式です
+template <class V>
+void rotationSoA(const V& x, const V& y, const V& z, const V& w, V (&r)[9])
+{
+    V one(1.0f);
+    V two(2.0f);
+
+    V xx = x * x;
+    V yy = y * y;
+    V zz = z * z;
+    V xy = x * y;
+    V xz = x * z;
+    V yz = y * z;
+    V xw = x * w;
+    V yw = y * w;
+    V zw = z * w;
+
+    r[0] = one - two * (yy + zz);
+    r[1] = two * (xy + zw);
+    r[2] = two * (xz - yw);
+    r[3] = two * (xy - zw);
+    r[4] = one - two * (xx + zz);
+    r[5] = two * (yz + xw);
+    r[6] = two * (xz + yw);
+    r[7] = two * (yz - xw);
+    r[8] = one - two * (xx + yy);
+}
+
+//! @name   行列作成の入力要素 (クォータニオン/TRS共通)
+//@{
+quaternion rotationOf(const quaternion& q) { return q; }
+quaternion rotationOf(const TRS& trs) { return trs.rotate_; }
+float3     scaleOf(const quaternion&) { return float3(1.0f, 1.0f, 1.0f); }
+float3     scaleOf(const TRS& trs) { return trs.scale_; }
+float3     translateOf(const quaternion&) { return float3(0.0f, 0.0f, 0.0f); }
+float3     translateOf(const TRS& trs) { return trs.translate_; }
+//@}
+
+//===========================================================================
+// スカラー (検証用の基準実装)
+//===========================================================================
+
+//! 座標変換 (out は p と同じでもよい)
+void transformScalar(const f32 (&e)[16], const f32* p, f32* out)
+{
+    f32 x = p[0];
+    f32 y = p[1];
+    f32 z = p[2];
+    for(u32 c = 0; c < 3; ++c)
+        out[c] = x * e[c] + y * e[4 + c] + z * e[8 + c] + e[12 + c];
+}
+
+void transformPointsScalar(const matrix& m, const float3* in, float3* out, size_t count)
+{
+    f32 e[16];
+    store(m, e);
+    for(size_t i = 0; i < count; ++i) {
+        f32 p[3];
+        transformScalar(e, in[i].f32, p);
+        out[i] = float3(p[0], p[1], p[2]);
+    }
+}
+
+void transformPointsScalar(const matrix& m, const f32* in, f32* out, size_t count)
+{
+    f32 e[16];
+    store(m, e);
+    for(size_t i = 0; i < count; ++i)
+        transformScalar(e, in + i * 3, out + i * 3);
+}
+
+void transformPointPairsScalar(const matrix* m, const float3* in, float3* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+        transformPointsScalar(m[i], in + i * 2, out + i * 2, 2);
+}
+
+void transformAABBsScalar(const matrix& m, const AABB* in, AABB* out, size_t count)
+{
+    f32 e[16];
+    store(m, e);
+    for(size_t i = 0; i < count; ++i) {
+        // 中心を変換し、半径は行列の絶対値で広げる
+        f32 center[3];
+        f32 extent[3];
+        for(u32 c = 0; c < 3; ++c) {
+            center[c] = (in[i].min_.f32[c] + in[i].max_.f32[c]) * 0.5f;
+            extent[c] = (in[i].max_.f32[c] - in[i].min_.f32[c]) * 0.5f;
+        }
+
+        f32 world_center[3];
+        f32 world_extent[3];
+        transformScalar(e, center, world_center);
+        for(u32 c = 0; c < 3; ++c) {
+            world_extent[c] = extent[0] * std::abs(e[c]) + extent[1] * std::abs(e[4 + c]) +
+                              extent[2] * std::abs(e[8 + c]);
+        }
+
+        out[i].min_ = float3(world_center[0] - world_extent[0],
+                             world_center[1] - world_extent[1],
+                             world_center[2] - world_extent[2]);
+        out[i].max_ = float3(world_center[0] + world_extent[0],
+                             world_center[1] + world_extent[1],
+                             world_center[2] + world_extent[2]);
+    }
+}
+
+//! 行列の積 (out は a/b と同じでもよい)
+void multiplyScalar(const f32 (&a)[16], const f32 (&b)[16], matrix& out)
+{
+    f32 result[16];
+    for(u32 r = 0; r < 4; ++r) {
+        for(u32 c = 0; c < 4; ++c) {
+            result[r * 4 + c] =
+                a[r * 4 + 0] * b[c] + a[r * 4 + 1] * b[4 + c] + a[r * 4 + 2] * b[8 + c] + a[r * 4 + 3] * b[12 + c];
+        }
+    }
+    load(out, result);
+}
+
+void multiplyMatricesScalar(const matrix* a, const matrix* b, matrix* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        f32 ea[16];
+        f32 eb[16];
+        store(a[i], ea);
+        store(b[i], eb);
+        multiplyScalar(ea, eb, out[i]);
+    }
+}
+
+void multiplyMatricesScalar(const matrix* a, const matrix& b, matrix* out, size_t count)
+{
+    // out が b を指していても結果が変わらないよう先に取り出しておく
+    f32 eb[16];
+    store(b, eb);
+    for(size_t i = 0; i < count; ++i) {
+        f32 ea[16];
+        store(a[i], ea);
+        multiplyScalar(ea, eb, out[i]);
+    }
+}
+
+void triangleCrossLengthsSqScalar(const f32* positions, const u32* indices, f32* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        const f32* p0 = positions + indices[i * 3 + 0] * 3;
+        const f32* p1 = positions + indices[i * 3 + 1] * 3;
+        const f32* p2 = positions + indices[i * 3 + 2] * 3;
+
+        f32 a[3] = {p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2]};
+        f32 b[3] = {p0[0] - p1[0], p0[1] - p1[1], p0[2] - p1[2]};
+        f32 c[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+
+        out[i] = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+    }
+}
+
+template <class T>
+void toMatricesScalar(const T* in, matrix* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        quaternion q = rotationOf(in[i]);
+        float3     s = scaleOf(in[i]);
+        float3     t = translateOf(in[i]);
+
+        f32 x = q.f32[0];
+        f32 y = q.f32[1];
+        f32 z = q.f32[2];
+        f32 w = q.f32[3];
+
+        f32 e[16]{
+            (1.0f - 2.0f * (y * y + z * z)) * s.f32[0],
+            (2.0f * (x * y + z * w)) * s.f32[0],
+            (2.0f * (x * z - y * w)) * s.f32[0],
+            0.0f,
+            (2.0f * (x * y - z * w)) * s.f32[1],
+            (1.0f - 2.0f * (x * x + z * z)) * s.f32[1],
+            (2.0f * (y * z + x * w)) * s.f32[1],
+            0.0f,
+            (2.0f * (x * z + y * w)) * s.f32[2],
+            (2.0f * (y * z - x * w)) * s.f32[2],
+            (1.0f - 2.0f * (x * x + y * y)) * s.f32[2],
+            0.0f,
+            t.f32[0],
+            t.f32[1],
+            t.f32[2],
+            1.0f,
+        };
+        load(out[i], e);
+    }
+}
+
+//===========================================================================
+// SSE (float4)
+//===========================================================================
+
+//! 座標変換
+float3 transformPoint(const float3& p, const float3 (&rows)[4])
+{
+    return p.xxx * rows[0] + p.yyy * rows[1] + p.zzz * rows[2] + rows[3];
+}
+
+//! 行列の1行分の積
+float4 multiplyRow(const float4& a, const float4 (&b)[4])
+{
+    return a.xxxx * b[0] + a.yyyy * b[1] + a.zzzz * b[2] + a.wwww * b[3];
+}
+
+//! 座標変換用の行ベクトル
+void getPointRows(const matrix& m, float3 (&rows)[4])
+{
+    float4 m_rows[4];
+    getRows(m, m_rows);
+    for(u32 r = 0; r < 4; ++r)
+        rows[r] = m_rows[r].xyz;
+}
+
+void transformPointsSSE(const matrix& m, const float3* in, float3* out, size_t count)
+{
+    float3 rows[4];
+    getPointRows(m, rows);
+    for(size_t i = 0; i < count; ++i)
+        out[i] = transformPoint(in[i], rows);
+}
+
+void transformPointsSSE(const matrix& m, const f32* in, f32* out, size_t count)
+{
+    float3 rows[4];
+    getPointRows(m, rows);
+
+    // 16byte単位で読み込むため次の座標のxまで読む (最後の1つは12byteのみ読み込む)
+    size_t i = 0;
+    for(; i + 1 < count; ++i) {
+        float4 p;
+        load(p, const_cast<f32*>(in + i * 3));
+        store(transformPoint(p.xyz, rows), out + i * 3);
+    }
+    if(i < count) {
+        float3 p;
+        load(p, const_cast<f32*>(in + i * 3));
+        store(transformPoint(p, rows), out + i * 3);
+    }
+}
+
+void transformPointPairsSSE(const matrix* m, const float3* in, float3* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+        transformPointsSSE(m[i], in + i * 2, out + i * 2, 2);
+}
+
+void transformAABBsSSE(const matrix& m, const AABB* in, AABB* out, size_t count)
+{
+    float3 rows[4];
+    getPointRows(m, rows);
+    float3 abs_rows[3] = {abs(rows[0]), abs(rows[1]), abs(rows[2])};
+
+    for(size_t i = 0; i < count; ++i) {
+        float3 center = (in[i].min_ + in[i].max_) * 0.5f;
+        float3 extent = (in[i].max_ - in[i].min_) * 0.5f;
+
+        float3 world_center = transformPoint(center, rows);
+        float3 world_extent = extent.xxx * abs_rows[0] + extent.yyy * abs_rows[1] + extent.zzz * abs_rows[2];
+
+        out[i].min_ = world_center - world_extent;
+        out[i].max_ = world_center + world_extent;
+    }
+}
+
+void multiplyMatricesSSE(const matrix* a, const matrix* b, matrix* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        float4 a_rows[4];
+        float4 b_rows[4];
+        getRows(a[i], a_rows);
+        getRows(b[i], b_rows);
+        out[i] = matrix(multiplyRow(a_rows[0], b_rows),
+                        multiplyRow(a_rows[1], b_rows),
+                        multiplyRow(a_rows[2], b_rows),
+                        multiplyRow(a_rows[3], b_rows));
+    }
+}
+
+void multiplyMatricesSSE(const matrix* a, const matrix& b, matrix* out, size_t count)
+{
+    float4 b_rows[4];
+    getRows(b, b_rows);
+    for(size_t i = 0; i < count; ++i) {
+        float4 a_rows[4];
+        getRows(a[i], a_rows);
+        out[i] = matrix(multiplyRow(a_rows[0], b_rows),
+                        multiplyRow(a_rows[1], b_rows),
+                        multiplyRow(a_rows[2], b_rows),
+                        multiplyRow(a_rows[3], b_rows));
+    }
+}
+
+//! 頂点座標を読み込み (12byteのみ読み込む)
+float3 loadPosition(const f32* positions, u32 index)
+{
+    float3 p;
+    load(p, const_cast<f32*>(positions + index * 3));
+    return p;
+}
+
+void triangleCrossLengthsSqSSE(const f32* positions, const u32* indices, f32* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        float3 p0 = loadPosition(positions, indices[i * 3 + 0]);
+        float3 p1 = loadPosition(positions, indices[i * 3 + 1]);
+        float3 p2 = loadPosition(positions, indices[i * 3 + 2]);
+
+        float3 c = cross(p2 - p1, p0 - p1);
+        out[i]   = static_cast<f32>(dot(c, c));
+    }
+}
+
+//! 4つずつSoAに並べ替えて計算
+template <class T>
+void toMatricesSSE(const T* in, matrix* out, size_t count)
+{
+    const float4 zero(0.0f);
+
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float4 q[4];   // x/y/z/w
+        float4 s[4];   // x/y/z/-
+        transpose4(float4(rotationOf(in[i + 0]).vec),
+                   float4(rotationOf(in[i + 1]).vec),
+                   float4(rotationOf(in[i + 2]).vec),
+                   float4(rotationOf(in[i + 3]).vec),
+                   q);
+        transpose4(float4(scaleOf(in[i + 0]), 0.0f),
+                   float4(scaleOf(in[i + 1]), 0.0f),
+                   float4(scaleOf(in[i + 2]), 0.0f),
+                   float4(scaleOf(in[i + 3]), 0.0f),
+                   s);
+
+        float4 r[9];
+        rotationSoA(q[0], q[1], q[2], q[3], r);
+
+        // 行ごとにAoSへ戻す
+        float4 rows[3][4];
+        for(u32 row = 0; row < 3; ++row)
+            transpose4(r[row * 3 + 0] * s[row], r[row * 3 + 1] * s[row], r[row * 3 + 2] * s[row], zero, rows[row]);
+
+        for(u32 n = 0; n < 4; ++n)
+            out[i + n] = matrix(rows[0][n], rows[1][n], rows[2][n], float4(translateOf(in[i + n]), 1.0f));
+    }
+    toMatricesScalar(in + i, out + i, count - i);
+}
+
+//===========================================================================
+// AVX (__m256。2座標/2行ずつ計算)
+//! @details AVXでビルドしなくても使えるよう、AVX命令を使う関数のみ個別に有効化します。
+//!          呼び出し前にcpuSupportsAvx()で実行環境が対応していることを確認します
+//===========================================================================
+
+//! 上位/下位の128bitを連結
+AVX_FUNCTION __m256 pack(__m128 lo, __m128 hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+//! 下位/上位の128bitを取り出し
+AVX_FUNCTION __m128 low(__m256 v)
+{
+    return _mm256_castps256_ps128(v);
+}
+AVX_FUNCTION __m128 high(__m256 v)
+{
+    return _mm256_extractf128_ps(v, 1);
+}
+
+//! 128bitごとにN番目の要素を複製
+template <int N>
+AVX_FUNCTION __m256 splat(__m256 v)
+{
+    return _mm256_permute_ps(v, _MM_SHUFFLE(N, N, N, N));
+}
+
+//! 2座標同時の座標変換
+AVX_FUNCTION __m256 transformPoint2(__m256 p, const __m256 (&rows)[4])
+{
+    __m256 r = _mm256_add_ps(_mm256_mul_ps(splat<0>(p), rows[0]), rows[3]);
+    r        = _mm256_add_ps(_mm256_mul_ps(splat<1>(p), rows[1]), r);
+    return _mm256_add_ps(_mm256_mul_ps(splat<2>(p), rows[2]), r);
+}
+
+//! 行列の2行分の積
+AVX_FUNCTION __m256 multiplyRow2(__m256 a, const __m256 (&b)[4])
+{
+    __m256 r = _mm256_mul_ps(splat<0>(a), b[0]);
+    r        = _mm256_add_ps(_mm256_mul_ps(splat<1>(a), b[1]), r);
+    r        = _mm256_add_ps(_mm256_mul_ps(splat<2>(a), b[2]), r);
+    return _mm256_add_ps(_mm256_mul_ps(splat<3>(a), b[3]), r);
+}
+
+//! 行ベクトルを上位/下位に複製して取得
+AVX_FUNCTION void getRows2(const matrix& m, __m256 (&rows)[4])
+{
+    float4 m_rows[4];
+    getRows(m, m_rows);
+    for(u32 r = 0; r < 4; ++r)
+        rows[r] = pack(m_rows[r].vec, m_rows[r].vec);
+}
+
+//! 行列の積 (2行ずつ計算。out は a と同じでもよい)
+AVX_FUNCTION void multiplyMatrix2(const matrix& a, const __m256 (&b)[4], matrix& out)
+{
+    float4 a_rows[4];
+    getRows(a, a_rows);
+    __m256 r01 = multiplyRow2(pack(a_rows[0].vec, a_rows[1].vec), b);
+    __m256 r23 = multiplyRow2(pack(a_rows[2].vec, a_rows[3].vec), b);
+    out        = matrix(float4(low(r01)), float4(high(r01)), float4(low(r23)), float4(high(r23)));
+}
+
+AVX_FUNCTION void transformPointsAVX(const matrix& m, const float3* in, float3* out, size_t count)
+{
+    __m256 rows[4];
+    getRows2(m, rows);
+
+    size_t i = 0;
+    for(; i + 2 <= count; i += 2) {
+        __m256 p   = transformPoint2(pack(in[i].vec, in[i + 1].vec), rows);
+        out[i + 0] = float3(low(p));
+        out[i + 1] = float3(high(p));
+    }
+    transformPointsSSE(m, in + i, out + i, count - i);
+}
+
+AVX_FUNCTION void transformPointsAVX(const matrix& m, const f32* in, f32* out, size_t count)
+{
+    __m256 rows[4];
+    getRows2(m, rows);
+
+    // 2座標(24byte)を16byteずつ読み込むため、3つ目の座標のxまで読む
+    size_t i = 0;
+    for(; i + 3 <= count; i += 2) {
+        __m256 p = transformPoint2(pack(_mm_loadu_ps(in + i * 3), _mm_loadu_ps(in + i * 3 + 3)), rows);
+        store(float3(low(p)), out + i * 3);
+        store(float3(high(p)), out + i * 3 + 3);
+    }
+    transformPointsSSE(m, in + i * 3, out + i * 3, count - i);
+}
+
+AVX_FUNCTION void transformPointPairsAVX(const matrix* m, const float3* in, float3* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        __m256 rows[4];
+        getRows2(m[i], rows);
+
+        __m256 p       = transformPoint2(pack(in[i * 2].vec, in[i * 2 + 1].vec), rows);
+        out[i * 2 + 0] = float3(low(p));
+        out[i * 2 + 1] = float3(high(p));
+    }
+}
+
+AVX_FUNCTION void transformAABBsAVX(const matrix& m, const AABB* in, AABB* out, size_t count)
+{
+    __m256 rows[4];
+    getRows2(m, rows);
+
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    __m256       abs_rows[4]{
+        _mm256_andnot_ps(sign, rows[0]),
+        _mm256_andnot_ps(sign, rows[1]),
+        _mm256_andnot_ps(sign, rows[2]),
+        _mm256_setzero_ps(),
+    };
+
+    size_t i = 0;
+    for(; i + 2 <= count; i += 2) {
+        __m256 aabb_min = pack(in[i].min_.vec, in[i + 1].min_.vec);
+        __m256 aabb_max = pack(in[i].max_.vec, in[i + 1].max_.vec);
+        __m256 center   = _mm256_mul_ps(_mm256_add_ps(aabb_min, aabb_max), half);
+        __m256 extent   = _mm256_mul_ps(_mm256_sub_ps(aabb_max, aabb_min), half);
+
+        __m256 world_center = transformPoint2(center, rows);
+        __m256 world_extent = transformPoint2(extent, abs_rows);
+        __m256 world_min    = _mm256_sub_ps(world_center, world_extent);
+        __m256 world_max    = _mm256_add_ps(world_center, world_extent);
+
+        out[i + 0].min_ = float3(low(world_min));
+        out[i + 0].max_ = float3(low(world_max));
+        out[i + 1].min_ = float3(high(world_min));
+        out[i + 1].max_ = float3(high(world_max));
+    }
+    transformAABBsSSE(m, in + i, out + i, count - i);
+}
+
+AVX_FUNCTION void multiplyMatricesAVX(const matrix* a, const matrix* b, matrix* out, size_t count)
+{
+    for(size_t i = 0; i < count; ++i) {
+        __m256 b_rows[4];
+        getRows2(b[i], b_rows);
+        multiplyMatrix2(a[i], b_rows, out[i]);
+    }
+}
+
+AVX_FUNCTION void multiplyMatricesAVX(const matrix* a, const matrix& b, matrix* out, size_t count)
+{
+    __m256 b_rows[4];
+    getRows2(b, b_rows);
+    for(size_t i = 0; i < count; ++i)
+        multiplyMatrix2(a[i], b_rows, out[i]);
+}
+
+//! 2三角形同時の外積の長さの2乗 (各128bitの先頭に格納)
+AVX_FUNCTION __m256 crossLengthSq2(__m256 p0, __m256 p1, __m256 p2)
+{
+    __m256 a = _mm256_sub_ps(p2, p1);
+    __m256 b = _mm256_sub_ps(p0, p1);
+
+    // a.yzx * b.zxy - a.zxy * b.yzx
+    __m256 c = _mm256_sub_ps(
+        _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(3, 0, 2, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(3, 1, 0, 2))),
+        _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(3, 1, 0, 2)), _mm256_permute_ps(b, _MM_SHUFFLE(3, 0, 2, 1))));
+
+    __m256 c2 = _mm256_mul_ps(c, c);
+    return _mm256_add_ps(_mm256_add_ps(c2, splat<1>(c2)), splat<2>(c2));
+}
+
+AVX_FUNCTION void triangleCrossLengthsSqAVX(const f32* positions, const u32* indices, f32* out, size_t count)
+{
+    size_t i = 0;
+    for(; i + 2 <= count; i += 2) {
+        const u32* t = indices + i * 3;
+
+        __m256 p0 = pack(loadPosition(positions, t[0]).vec, loadPosition(positions, t[3]).vec);
+        __m256 p1 = pack(loadPosition(positions, t[1]).vec, loadPosition(positions, t[4]).vec);
+        __m256 p2 = pack(loadPosition(positions, t[2]).vec, loadPosition(positions, t[5]).vec);
+
+        __m256 length_sq = crossLengthSq2(p0, p1, p2);
+        out[i + 0]       = _mm_cvtss_f32(low(length_sq));
+        out[i + 1]       = _mm_cvtss_f32(high(length_sq));
+    }
+    triangleCrossLengthsSqSSE(positions, indices + i * 3, out + i, count - i);
+}
+
+//! クォータニオンから回転行列の9要素を計算 (8つ同時。rotationSoA()と同じ式)
+AVX_FUNCTION void rotationSoA8(__m256 x, __m256 y, __m256 z, __m256 w, __m256 (&r)[9])
+{
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    __m256 xx = _mm256_mul_ps(x, x);
+    __m256 yy = _mm256_mul_ps(y, y);
+    __m256 zz = _mm256_mul_ps(z, z);
+    __m256 xy = _mm256_mul_ps(x, y);
+    __m256 xz = _mm256_mul_ps(x, z);
+    __m256 yz = _mm256_mul_ps(y, z);
+    __m256 xw = _mm256_mul_ps(x, w);
+    __m256 yw = _mm256_mul_ps(y, w);
+    __m256 zw = _mm256_mul_ps(z, w);
+
+    r[0] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz)));
+    r[1] = _mm256_mul_ps(two, _mm256_add_ps(xy, zw));
+    r[2] = _mm256_mul_ps(two, _mm256_sub_ps(xz, yw));
+    r[3] = _mm256_mul_ps(two, _mm256_sub_ps(xy, zw));
+    r[4] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz)));
+    r[5] = _mm256_mul_ps(two, _mm256_add_ps(yz, xw));
+    r[6] = _mm256_mul_ps(two, _mm256_add_ps(xz, yw));
+    r[7] = _mm256_mul_ps(two, _mm256_sub_ps(yz, xw));
+    r[8] = _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy)));
+}
+
+//! 8つずつSoAに並べ替えて計算
+template <class T>
+AVX_FUNCTION void toMatricesAVX(const T* in, matrix* out, size_t count)
+{
+    const float4 zero(0.0f);
+
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8) {
+        float4 q[2][4];
+        float4 s[2][4];
+        for(u32 half = 0; half < 2; ++half) {
+            const T* src = in + i + half * 4;
+            transpose4(float4(rotationOf(src[0]).vec),
+                       float4(rotationOf(src[1]).vec),
+                       float4(rotationOf(src[2]).vec),
+                       float4(rotationOf(src[3]).vec),
+                       q[half]);
+            transpose4(float4(scaleOf(src[0]), 0.0f),
+                       float4(scaleOf(src[1]), 0.0f),
+                       float4(scaleOf(src[2]), 0.0f),
+                       float4(scaleOf(src[3]), 0.0f),
+                       s[half]);
+        }
+
+        __m256 r[9];
+        rotationSoA8(pack(q[0][0].vec, q[1][0].vec),
+                     pack(q[0][1].vec, q[1][1].vec),
+                     pack(q[0][2].vec, q[1][2].vec),
+                     pack(q[0][3].vec, q[1][3].vec),
+                     r);
+
+        // 行ごとにAoSへ戻す
+        float4 rows[2][3][4];
+        for(u32 row = 0; row < 3; ++row) {
+            __m256 scale = pack(s[0][row].vec, s[1][row].vec);
+            __m256 c0    = _mm256_mul_ps(r[row * 3 + 0], scale);
+            __m256 c1    = _mm256_mul_ps(r[row * 3 + 1], scale);
+            __m256 c2    = _mm256_mul_ps(r[row * 3 + 2], scale);
+            transpose4(float4(low(c0)), float4(low(c1)), float4(low(c2)), zero, rows[0][row]);
+            transpose4(float4(high(c0)), float4(high(c1)), float4(high(c2)), zero, rows[1][row]);
+        }
+
+        for(u32 n = 0; n < 8; ++n) {
+            auto& m    = rows[n / 4];
+            out[i + n] = matrix(m[0][n % 4], m[1][n % 4], m[2][n % 4], float4(translateOf(in[i + n]), 1.0f));
+        }
+    }
+    toMatricesSSE(in + i, out + i, count - i);
+}
+
+}   // namespace
+
+//---------------------------------------------------------------------------
+// 命令セットが利用可能かどうか
+//---------------------------------------------------------------------------
+bool isSupported(Isa isa)
+{
+    return static_cast<u32>(isa) <= static_cast<u32>(bestIsa());
+}
+
+//---------------------------------------------------------------------------
+// 使用する命令セットを設定
+//---------------------------------------------------------------------------
+Isa setIsa(Isa isa)
+{
+    Isa result = isSupported(isa) ? isa : bestIsa();
+    activeIsaRef().store(result, std::memory_order_relaxed);
+    return result;
+}
+
+//---------------------------------------------------------------------------
+// 使用中の命令セットを取得
+//---------------------------------------------------------------------------
+Isa activeIsa()
+{
+    return activeIsaRef().load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------
+// 命令セットの名前を取得
+//---------------------------------------------------------------------------
+const char* isaName(Isa isa)
+{
+    switch(isa) {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::SSE:
+        return "sse";
+    case Isa::AVX:
+        return "avx";
+    }
+    return "unknown";
+}
+
+//---------------------------------------------------------------------------
+// 座標を一括変換
+//---------------------------------------------------------------------------
+void transformPoints(const matrix& m, const float3* in, float3* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        transformPointsAVX(m, in, out, count);
+        return;
+    case Isa::SSE:
+        transformPointsSSE(m, in, out, count);
+        return;
+    default:
+        transformPointsScalar(m, in, out, count);
+        return;
+    }
+}
+
+void transformPoints(const matrix& m, const f32* in, f32* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        transformPointsAVX(m, in, out, count);
+        return;
+    case Isa::SSE:
+        transformPointsSSE(m, in, out, count);
+        return;
+    default:
+        transformPointsScalar(m, in, out, count);
+        return;
+    }
+}
+
+//---------------------------------------------------------------------------
+// 座標を2つずつ別々の行列で一括変換
+//---------------------------------------------------------------------------
+void transformPointPairs(const matrix* m, const float3* in, float3* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        transformPointPairsAVX(m, in, out, count);
+        return;
+    case Isa::SSE:
+        transformPointPairsSSE(m, in, out, count);
+        return;
+    default:
+        transformPointPairsScalar(m, in, out, count);
+        return;
+    }
+}
+
+//---------------------------------------------------------------------------
+// AABBを一括変換
+//---------------------------------------------------------------------------
+void transformAABBs(const matrix& m, const AABB* in, AABB* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        transformAABBsAVX(m, in, out, count);
+        return;
+    case Isa::SSE:
+        transformAABBsSSE(m, in, out, count);
+        return;
+    default:
+        transformAABBsScalar(m, in, out, count);
+        return;
+    }
+}
+
+//---------------------------------------------------------------------------
+// 行列の積を一括計算
+//---------------------------------------------------------------------------
+void multiplyMatrices(const matrix* a, const matrix* b, matrix* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        multiplyMatricesAVX(a, b, out, count);
+        return;
+    case Isa::SSE:
+        multiplyMatricesSSE(a, b, out, count);
+        return;
+    default:
+        multiplyMatricesScalar(a, b, out, count);
+        return;
+    }
+}
+
+void multiplyMatrices(const matrix* a, const matrix& b, matrix* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        multiplyMatricesAVX(a, b, out, count);
+        return;
+    case Isa::SSE:
+        multiplyMatricesSSE(a, b, out, count);
+        return;
+    default:
+        multiplyMatricesScalar(a, b, out, count);
+        return;
+    }
+}
+
+//---------------------------------------------------------------------------
+// クォータニオン/TRSから行列を一括作成
+//---------------------------------------------------------------------------
+void toMatrices(const quaternion* in, matrix* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        toMatricesAVX(in, out, count);
+        return;
+    case Isa::SSE:
+        toMatricesSSE(in, out, count);
+        return;
+    default:
+        toMatricesScalar(in, out, count);
+        return;
+    }
+}
+
+void toMatrices(const TRS* in, matrix* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        toMatricesAVX(in, out, count);
+        return;
+    case Isa::SSE:
+        toMatricesSSE(in, out, count);
+        return;
+    default:
+        toMatricesScalar(in, out, count);
+        return;
+    }
+}
+
+//---------------------------------------------------------------------------
+// 三角形の外積の長さの2乗を一括計算
+//---------------------------------------------------------------------------
+void triangleCrossLengthsSq(const f32* positions, const u32* indices, f32* out, size_t count)
+{
+    switch(activeIsa()) {
+    case Isa::AVX:
+        triangleCrossLengthsSqAVX(positions, indices, out, count);
+        return;
+    case Isa::SSE:
+        triangleCrossLengthsSqSSE(positions, indices, out, count);
+        return;
+    default:
+        triangleCrossLengthsSqScalar(positions, indices, out, count);
+        return;
+    }
+}
+
+}   // namespace simd
@@ -0,0 +1,122 @@
+﻿//---------------------------------------------------------------------------
+//! @file   VectorMathBatch.h
+//! @brief  ベクトル算術演算 (配列の一括処理)
+//---------------------------------------------------------------------------
+#pragma once
+
+namespace simd
+{
+
+//! 命令セット
+enum class Isa : u32
+{
+    Scalar,   //!< スカラー演算 (検証用の基準実装)
+    SSE,      //!< SSE (hlslppのfloat4)
+    AVX,      //!< AVX (CPUが対応している場合のみ利用可能)
+};
+
+//! 軸平行境界ボックス
+struct AABB
+{
+    float3 min_ = float3(0.0f, 0.0f, 0.0f);   //!< 最小値
+    float3 max_ = float3(0.0f, 0.0f, 0.0f);   //!< 最大値
+};
+
+//===========================================================================
+//! @name   命令セットの切り替え
+//! 既定では利用可能な最上位の命令セットを使用します (どのスレッドから切り替えてもよい)
+//===========================================================================
+//@{
+
+//  命令セットが利用可能かどうか
+//! @param  [in]    isa     命令セット
+bool isSupported(Isa isa);
+
+//  使用する命令セットを設定
+//! @param  [in]    isa     命令セット (利用できない場合は利用可能な最上位に制限)
+//! @return 設定された命令セット
+Isa setIsa(Isa isa);
+
+//! 使用中の命令セットを取得
+Isa activeIsa();
+
+//! 命令セットの名前を取得
+const char* isaName(Isa isa);
+
+//@}
+//===========================================================================
+//! @name   一括変換 (行ベクトル p' = p × M)
+//! 出力に入力と同じ配列を指定できます
+//===========================================================================
+//@{
+
+//  座標を一括変換
+//! @param  [in]    m       変換行列
+//! @param  [in]    in      入力座標
+//! @param  [out]   out     出力座標
+//! @param  [in]    count   座標数
+void transformPoints(const matrix& m, const float3* in, float3* out, size_t count);
+
+//  座標を一括変換 (xyzを詰めて並べた配列。DxLib::VECTORの配列など)
+//! @param  [in]    m       変換行列
+//! @param  [in]    in      入力座標 (count×3要素)
+//! @param  [out]   out     出力座標 (count×3要素)
+//! @param  [in]    count   座標数
+void transformPoints(const matrix& m, const f32* in, f32* out, size_t count);
+
+//  座標を2つずつ別々の行列で一括変換 (out[i×2+n] = in[i×2+n] × m[i])
+//! @param  [in]    m       変換行列 (count個)
+//! @param  [in]    in      入力座標 (count×2個)
+//! @param  [out]   out     出力座標 (count×2個)
+//! @param  [in]    count   行列数
+void transformPointPairs(const matrix* m, const float3* in, float3* out, size_t count);
+
+//  AABBを一括変換 (変換後のボックスを包むAABB)
+//! @param  [in]    m       変換行列
+//! @param  [in]    in      入力AABB
+//! @param  [out]   out     出力AABB
+//! @param  [in]    count   AABB数
+void transformAABBs(const matrix& m, const AABB* in, AABB* out, size_t count);
+
+//  行列の積を一括計算 (out[i] = a[i] × b[i])
+//! @param  [in]    a       左辺の行列
+//! @param  [in]    b       右辺の行列
+//! @param  [out]   out     出力行列
+//! @param  [in]    count   行列数
+void multiplyMatrices(const matrix* a, const matrix* b, matrix* out, size_t count);
+
+//  行列の積を一括計算 (out[i] = a[i] × b)
+//! @param  [in]    a       左辺の行列
+//! @param  [in]    b       右辺の行列 (共通)
+//! @param  [out]   out     出力行列
+//! @param  [in]    count   行列数
+void multiplyMatrices(const matrix* a, const matrix& b, matrix* out, size_t count);
+
+//  クォータニオンから回転行列を一括作成
+//! @param  [in]    in      入力クォータニオン (正規化済)
+//! @param  [out]   out     出力行列
+//! @param  [in]    count   クォータニオン数
+void toMatrices(const quaternion* in, matrix* out, size_t count);
+
+//  TRSから行列を一括作成 (TRS::toMatrix()と同じ結果)
+//! @param  [in]    in      入力TRS
+//! @param  [out]   out     出力行列
+//! @param  [in]    count   TRS数
+void toMatrices(const TRS* in, matrix* out, size_t count);
+
+//@}
+//===========================================================================
+//! @name   三角形
+//===========================================================================
+//@{
+
+//  三角形の外積の長さの2乗を一括計算 (|(p2-p1)×(p0-p1)|²。面積の2倍の2乗)
+//! @param  [in]    positions   頂点座標 (xyzを詰めて並べた配列)
+//! @param  [in]    indices     インデックス (count×3要素)
+//! @param  [out]   out         出力 (count要素)
+//! @param  [in]    count       三角形数
+void triangleCrossLengthsSq(const f32* positions, const u32* indices, f32* out, size_t count);
+
+//@}
+
+}   // namespace simd
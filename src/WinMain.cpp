@@ -1,13 +1,14 @@
 ﻿#include "WinMain.h"
 #include "Game/GameMain.h"
 #include <System/SystemMain.h>
+#include <System/Input/InputRecorder.h>
 
 //---------------------------------------------------------------------------
 //! アプリケーションエントリーポイント
 //---------------------------------------------------------------------------
 int WINAPI WinMain(_In_ [[maybe_unused]] HINSTANCE     hInstance,
                    _In_opt_ [[maybe_unused]] HINSTANCE hPrevInstance,
-                   _In_ [[maybe_unused]] LPSTR         lpCmdLine,
+                   _In_ LPSTR                          lpCmdLine,
                    _In_ [[maybe_unused]] int           nShowCmd)
 {
     // 高DPI対応
@@ -48,8 +49,12 @@ int WINAPI WinMain(_In_ [[maybe_unused]] HINSTANCE     hInstance,
 
     SetDrawScreen(DX_SCREEN_BACK);
     SetTransColor(255, 0, 255);
-    srand(GetNowCount() % RAND_MAX);
-    SRand(GetNowCount() % RAND_MAX);
+
+    // 入力の記録/再生 (再生時は記録時の乱数シードを使用)
+    u32 seed = GetNowCount() % RAND_MAX;
+    InputRecorderInit(lpCmdLine, seed);
+    srand(seed);
+    SRand(seed);
 
     SetCameraNearFar(1.0f, 150.0f);
     SetupCamera_Perspective(D2R(45.0f));
@@ -81,6 +86,7 @@ int WINAPI WinMain(_In_ [[maybe_unused]] HINSTANCE     hInstance,
 
         clsDx();
 
+        InputRecorderBeginFrame();   // 記録/再生のフレーム開始
         InputKeyUpdate();
         InputPadUpdate();
         InputMouseUpdate();
@@ -107,6 +113,7 @@ int WINAPI WinMain(_In_ [[maybe_unused]] HINSTANCE     hInstance,
 
         // 1フレームの終了
         SystemEndFrame();
+        InputRecorderEndFrame();   // 記録/再生のフレーム終了
 
         // ---------------
         // 画面更新
@@ -121,6 +128,7 @@ int WINAPI WinMain(_In_ [[maybe_unused]] HINSTANCE     hInstance,
     InputKeyExit();
     InputPadExit();
     InputMouseExit();
+    InputRecorderExit();
     GameExit();
     SystemExit();
     RenderExit();   // Render終了